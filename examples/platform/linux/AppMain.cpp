@@ -399,6 +399,10 @@ int ChipLinuxAppInit(int argc, char * const argv[], OptionSet * customOptions,
     err = DeviceLayer::PlatformMgr().InitChipStack();
     SuccessOrExit(err);
 
+    // Start the workers that take CASE signature checks off the Matter thread.
+    err = DeviceLayer::PlatformMgr().StartBackgroundEventLoopTask();
+    SuccessOrExit(err);
+
     // Init the commissionable data provider based on command line options
     // to handle custom verifiers, discriminators, etc.
     err = chip::examples::InitCommissionableDataProvider(gCommissionableDataProvider, LinuxDeviceOptions::GetInstance());
@@ -605,6 +609,8 @@ void ChipLinuxAppMainLoop(AppMainLoopImplementation * impl)
 
     ApplicationShutdown();
 
+    DeviceLayer::PlatformMgr().StopBackgroundEventLoopTask();
+
 #if CHIP_DEVICE_CONFIG_ENABLE_BOTH_COMMISSIONER_AND_COMMISSIONEE
     ShutdownCommissioner();
 #endif // CHIP_DEVICE_CONFIG_ENABLE_BOTH_COMMISSIONER_AND_COMMISSIONEE
@@ -494,6 +494,12 @@ public:
      */
     bool MatchesEndpoint(EndpointId aEndpointId) const { return mEndpointId.HasValue() && mEndpointId.Value() == aEndpointId; }
 
+    /**
+     * The endpoint this AttributeAccessInterface is for, or Missing if it is for all endpoints.
+     */
+    const Optional<EndpointId> & GetEndpointId() const { return mEndpointId; }
+    ClusterId GetClusterId() const { return mClusterId; }
+
     /**
      * Check whether another AttributeAccessInterface wants to handle the same set of
      * attributes as we do.
@@ -42,9 +42,20 @@ void BufferedReadCallback::OnReportEnd()
         mCallback.OnError(err);
     }
 
+    mReportBuffer = nullptr;
     mCallback.OnReportEnd();
 }
 
+void BufferedReadCallback::OnReportBuffer(const System::PacketBufferHandle & aBuffer)
+{
+    if (mRetainReportBuffers)
+    {
+        mReportBuffer = aBuffer.Retain();
+    }
+
+    mCallback.OnReportBuffer(aBuffer);
+}
+
 CHIP_ERROR BufferedReadCallback::GenerateListTLV(TLV::ScopedBufferTLVReader & aReader)
 {
     TLV::TLVType outerType;
@@ -65,9 +76,9 @@ CHIP_ERROR BufferedReadCallback::GenerateListTLV(TLV::ScopedBufferTLVReader & aR
     // To avoid that, a single contiguous buffer is the best likely approach for now.
     //
     uint32_t totalBufSize = 0;
-    for (const auto & packetBuffer : mBufferedList)
+    for (const auto & item : mBufferedList)
     {
-        totalBufSize += packetBuffer->TotalLength();
+        totalBufSize += static_cast<uint32_t>(item.mElement.size());
     }
 
     //
@@ -81,11 +92,14 @@ CHIP_ERROR BufferedReadCallback::GenerateListTLV(TLV::ScopedBufferTLVReader & aR
     TLV::ScopedBufferTLVWriter writer(std::move(backingBuffer), totalBufSize);
     ReturnErrorOnFailure(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Array, outerType));
 
-    for (auto & bufHandle : mBufferedList)
+    for (auto & item : mBufferedList)
     {
-        System::PacketBufferTLVReader reader;
+        TLV::TLVReader reader;
 
-        reader.Init(std::move(bufHandle));
+        //
+        // Items referred to in a report buffer keep the tag they had there.
+        //
+        reader.Init(item.mElement, TLV::kTLVType_UnknownContainer);
 
         ReturnErrorOnFailure(reader.Next());
         ReturnErrorOnFailure(writer.CopyElement(TLV::AnonymousTag(), reader));
@@ -104,6 +118,21 @@ CHIP_ERROR BufferedReadCallback::BufferListItem(TLV::TLVReader & reader)
 {
     System::PacketBufferTLVWriter writer;
     System::PacketBufferHandle handle;
+    ByteSpan element;
+
+    //
+    // When retaining report buffers, refer to the item where it is if it lies in the report buffer, without
+    // any allocation or copy.
+    //
+    if (!mReportBuffer.IsNull() && reader.GetElementEncoding(element) == CHIP_NO_ERROR)
+    {
+        const uint8_t * bufferStart = mReportBuffer->Start();
+        if (element.data() >= bufferStart && element.data() + element.size() <= bufferStart + mReportBuffer->DataLength())
+        {
+            mBufferedList.push_back(BufferedListItem{ mReportBuffer.Retain(), element });
+            return CHIP_NO_ERROR;
+        }
+    }
 
     //
     // We conservatively allocate a packet buffer as big as an IPv6 MTU (since we're buffering
@@ -129,7 +158,8 @@ CHIP_ERROR BufferedReadCallback::BufferListItem(TLV::TLVReader & reader)
     //
     handle.RightSize();
 
-    mBufferedList.push_back(std::move(handle));
+    element = ByteSpan(handle->Start(), handle->DataLength());
+    mBufferedList.push_back(BufferedListItem{ std::move(handle), element });
 
     return CHIP_NO_ERROR;
 }
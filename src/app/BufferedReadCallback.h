@@ -42,7 +42,24 @@ class BufferedReadCallback : public ReadClient::Callback
 public:
     BufferedReadCallback(Callback & callback) : mCallback(callback) {}
 
+    /*
+     * Sets whether list items are buffered up by referring to them in the report buffers they came in, retaining those
+     * buffers until the list is dispatched, instead of copying each item into a packet buffer of its own. See
+     * ReadClient::Callback::OnReportBuffer for the trade-off.
+     */
+    void SetRetainReportBuffers(bool retainReportBuffers) { mRetainReportBuffers = retainReportBuffers; }
+
 private:
+    /*
+     * A buffered list item: the TLV element of the item, and the packet buffer holding it, which is either a copy
+     * of the item or a retained report buffer.
+     */
+    struct BufferedListItem
+    {
+        System::PacketBufferHandle mBuffer;
+        ByteSpan mElement;
+    };
+
     /*
      * Generates the reconsistuted TLV array from the stored individual list elements
      */
@@ -70,10 +87,12 @@ private:
     //
     void OnReportBegin() override;
     void OnReportEnd() override;
+    void OnReportBuffer(const System::PacketBufferHandle & aBuffer) override;
     void OnAttributeData(const ConcreteDataAttributePath & aPath, TLV::TLVReader * apData, const StatusIB & aStatus) override;
     void OnError(CHIP_ERROR aError) override
     {
         mBufferedList.clear();
+        mReportBuffer = nullptr;
         return mCallback.OnError(aError);
     }
 
@@ -122,15 +141,18 @@ private:
 
     /*
      * Given a reader positioned at a list element, allocate a packet buffer, copy the list item where
-     * the reader is positioned into that buffer and add it to our buffered list for tracking.
+     * the reader is positioned into that buffer and add it to our buffered list for tracking. When retaining
+     * report buffers, the item is instead referred to in the report buffer it came in, if it lies in there.
      *
      * This should be called in list index order starting from the lowest index that needs to be buffered.
      *
      */
     CHIP_ERROR BufferListItem(TLV::TLVReader & reader);
     ConcreteDataAttributePath mBufferedPath;
-    std::vector<System::PacketBufferHandle> mBufferedList;
+    std::vector<BufferedListItem> mBufferedList;
+    System::PacketBufferHandle mReportBuffer; // Buffer of the report message being processed, when retaining them.
     Callback & mCallback;
+    bool mRetainReportBuffers = false;
 };
 
 } // namespace app
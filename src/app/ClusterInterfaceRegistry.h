@@ -0,0 +1,203 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines a hashed registry of per-cluster interfaces, such as AttributeAccessInterface and
+ *      CommandHandlerInterface, keyed by the (endpoint, cluster) they handle.
+ */
+
+#pragma once
+
+#include <lib/core/CHIPConfig.h>
+#include <lib/core/DataModelTypes.h>
+#include <lib/core/Optional.h>
+#include <lib/support/IdHash.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace chip {
+namespace app {
+
+/**
+ * Registry of interfaces that each handle one cluster, either on one endpoint or on all endpoints. Registered interfaces never
+ * overlap, so at most one of them handles any concrete (endpoint, cluster), and Find() returns it after looking at two short
+ * hash chains: the one for (endpoint, cluster) and the one for (any endpoint, cluster).
+ *
+ * The chains are linked through the interfaces themselves, so T must provide SetNext()/GetNext(), GetEndpointId(),
+ * GetClusterId(), Matches(EndpointId, ClusterId) and Matches(const T &), as AttributeAccessInterface and
+ * CommandHandlerInterface do. Registering an interface never allocates.
+ */
+template <typename T, size_t kBucketCount = CHIP_IM_SERVER_INTERFACE_REGISTRY_BUCKETS>
+class ClusterInterfaceRegistry
+{
+public:
+    static_assert(kBucketCount > 0 && (kBucketCount & (kBucketCount - 1)) == 0, "Bucket count must be a power of two");
+
+    ClusterInterfaceRegistry() = default;
+
+    ClusterInterfaceRegistry(const ClusterInterfaceRegistry &)             = delete;
+    ClusterInterfaceRegistry & operator=(const ClusterInterfaceRegistry &) = delete;
+
+    /**
+     * Register aInterface. Returns false, leaving the registry unchanged, if an interface that handles some of the same
+     * (endpoint, cluster) pairs is already registered.
+     */
+    bool Register(T & aInterface)
+    {
+        const Optional<EndpointId> endpointId = aInterface.GetEndpointId();
+        if (endpointId.HasValue())
+        {
+            if (Find(endpointId.Value(), aInterface.GetClusterId()) != nullptr)
+            {
+                return false;
+            }
+        }
+        else
+        {
+            // A wildcard registration overlaps every registration for the cluster: look at all of them.
+            for (T * head : mBuckets)
+            {
+                for (T * cur = head; cur != nullptr; cur = cur->GetNext())
+                {
+                    if (cur->Matches(aInterface))
+                    {
+                        return false;
+                    }
+                }
+            }
+        }
+
+        T *& bucket = mBuckets[BucketOf(aInterface)];
+        aInterface.SetNext(bucket);
+        bucket = &aInterface;
+        mCount++;
+        return true;
+    }
+
+    /**
+     * Unregister every interface for which aPredicate(T * interface) returns true. Returns the number of interfaces removed.
+     */
+    template <typename Predicate>
+    size_t UnregisterMatching(Predicate && aPredicate)
+    {
+        size_t removed = 0;
+        for (T *& head : mBuckets)
+        {
+            T * prev = nullptr;
+            T * cur  = head;
+            while (cur != nullptr)
+            {
+                T * next = cur->GetNext();
+                if (aPredicate(cur))
+                {
+                    Unlink(head, prev, *cur);
+                    removed++;
+                }
+                else
+                {
+                    prev = cur;
+                }
+                cur = next;
+            }
+        }
+        return removed;
+    }
+
+    /**
+     * Unregister aInterface. Returns whether it was registered.
+     */
+    bool Unregister(T & aInterface)
+    {
+        T *& head = mBuckets[BucketOf(aInterface)];
+        T * prev  = nullptr;
+        for (T * cur = head; cur != nullptr; prev = cur, cur = cur->GetNext())
+        {
+            if (cur == &aInterface)
+            {
+                Unlink(head, prev, aInterface);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Returns the interface that handles aClusterId on aEndpointId, if any.
+     */
+    T * Find(EndpointId aEndpointId, ClusterId aClusterId) const
+    {
+        for (T * cur = mBuckets[BucketOf(aEndpointId, aClusterId)]; cur != nullptr; cur = cur->GetNext())
+        {
+            if (cur->Matches(aEndpointId, aClusterId))
+            {
+                return cur;
+            }
+        }
+        for (T * cur = mBuckets[BucketOf(kInvalidEndpointId, aClusterId)]; cur != nullptr; cur = cur->GetNext())
+        {
+            if (cur->Matches(aEndpointId, aClusterId))
+            {
+                return cur;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * Unregister every interface.
+     */
+    void Clear()
+    {
+        UnregisterMatching([](T *) { return true; });
+    }
+
+    size_t Count() const { return mCount; }
+
+private:
+    static size_t BucketOf(EndpointId aEndpointId, ClusterId aClusterId)
+    {
+        return BucketOfIdPair<kBucketCount>(aClusterId, aEndpointId);
+    }
+
+    static size_t BucketOf(const T & aInterface)
+    {
+        // Interfaces for all endpoints are filed under an endpoint id that no concrete path uses.
+        return BucketOf(aInterface.GetEndpointId().ValueOr(kInvalidEndpointId), aInterface.GetClusterId());
+    }
+
+    void Unlink(T *& aHead, T * aPrev, T & aInterface)
+    {
+        if (aPrev == nullptr)
+        {
+            aHead = aInterface.GetNext();
+        }
+        else
+        {
+            aPrev->SetNext(aInterface.GetNext());
+        }
+        aInterface.SetNext(nullptr);
+        mCount--;
+    }
+
+    T * mBuckets[kBucketCount] = {};
+    size_t mCount              = 0;
+};
+
+} // namespace app
+} // namespace chip
@@ -19,6 +19,7 @@
 #include "system/SystemPacketBuffer.h"
 #include <app/ClusterStateCache.h>
 #include <app/InteractionModelEngine.h>
+#include <lib/support/SafeInt.h>
 #include <tuple>
 
 namespace chip {
@@ -49,7 +50,8 @@ size_t SizeOfStatusIB(const StatusIB & aStatus)
 
 } // anonymous namespace
 
-CHIP_ERROR ClusterStateCache::GetElementTLVSize(TLV::TLVReader * apData, size_t & aSize)
+template <bool UseFlatStorage>
+CHIP_ERROR ClusterStateCacheT<UseFlatStorage>::GetElementTLVSize(TLV::TLVReader * apData, size_t & aSize)
 {
     Platform::ScopedMemoryBufferWithSize<uint8_t> backingBuffer;
     TLV::TLVReader reader;
@@ -64,8 +66,217 @@ CHIP_ERROR ClusterStateCache::GetElementTLVSize(TLV::TLVReader * apData, size_t
     return CHIP_NO_ERROR;
 }
 
-CHIP_ERROR ClusterStateCache::UpdateCache(const ConcreteDataAttributePath & aPath, TLV::TLVReader * apData,
-                                          const StatusIB & aStatus)
+template <bool UseFlatStorage>
+bool ClusterStateCacheT<UseFlatStorage>::ReferToReportBuffer(const TLV::TLVReader & aData, AttributeData & aStored)
+{
+    if constexpr (UseFlatStorage)
+    {
+        ByteSpan element;
+        VerifyOrReturnValue(!mReportBuffer.IsNull() && aData.GetElementEncoding(element) == CHIP_NO_ERROR, false);
+
+        const uint8_t * bufferStart = mReportBuffer->Start();
+        VerifyOrReturnValue(element.data() >= bufferStart &&
+                                element.data() + element.size() <= bufferStart + mReportBuffer->DataLength(),
+                            false);
+
+        if (mReportBufferIndex == 0)
+        {
+            VerifyOrReturnValue(mReportBuffers.size() < DataSlice::kMaxReportBuffers, false);
+            mReportBuffers.push_back(ReportBuffer{ mReportBuffer.Retain() });
+            mReportBufferIndex = static_cast<uint8_t>(mReportBuffers.size());
+        }
+
+        aStored.mOffset = static_cast<uint32_t>(element.data() - bufferStart);
+        aStored.mSize   = static_cast<uint16_t>(element.size()); // Within a packet buffer.
+        aStored.mBuffer = mReportBufferIndex;
+        mReportBuffers[mReportBufferIndex - 1].mReferencedBytes += aStored.mSize;
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+template <bool UseFlatStorage>
+CHIP_ERROR ClusterStateCacheT<UseFlatStorage>::StoreAttributeData(TLV::TLVReader & aData, AttributeData & aStored, size_t & aSize)
+{
+    if constexpr (UseFlatStorage)
+    {
+        if (ReferToReportBuffer(aData, aStored))
+        {
+            aSize = aStored.mSize;
+            return CHIP_NO_ERROR;
+        }
+
+        // Copy straight into the arena, with room for anything the reader holds, then give back what was not used.
+        size_t offset   = mArena.size();
+        size_t capacity = aData.GetTotalLength();
+        VerifyOrReturnError(CanCastTo<uint32_t>(offset + capacity), CHIP_ERROR_NO_MEMORY);
+        mArena.resize(offset + capacity);
+
+        TLV::TLVWriter writer;
+        writer.Init(mArena.data() + offset, capacity);
+        CHIP_ERROR err = writer.CopyElement(TLV::AnonymousTag(), aData);
+        if (err == CHIP_NO_ERROR)
+        {
+            err = writer.Finalize();
+        }
+        if (err == CHIP_NO_ERROR && writer.GetLengthWritten() > DataSlice::kMaxSize)
+        {
+            err = CHIP_ERROR_NO_MEMORY;
+        }
+        aSize = (err == CHIP_NO_ERROR) ? writer.GetLengthWritten() : 0;
+        mArena.resize(offset + aSize);
+        ReturnErrorOnFailure(err);
+
+        aStored.mOffset = static_cast<uint32_t>(offset);
+        aStored.mSize   = static_cast<uint32_t>(aSize) & DataSlice::kMaxSize;
+        aStored.mBuffer = 0;
+        return CHIP_NO_ERROR;
+    }
+    else
+    {
+        ReturnErrorOnFailure(GetElementTLVSize(&aData, aSize));
+
+        Platform::ScopedMemoryBufferWithSize<uint8_t> backingBuffer;
+        backingBuffer.Calloc(aSize);
+        VerifyOrReturnError(backingBuffer.Get() != nullptr, CHIP_ERROR_NO_MEMORY);
+        TLV::ScopedBufferTLVWriter writer(std::move(backingBuffer), aSize);
+        ReturnErrorOnFailure(writer.CopyElement(TLV::AnonymousTag(), aData));
+        ReturnErrorOnFailure(writer.Finalize(backingBuffer));
+
+        aStored = std::move(backingBuffer);
+        return CHIP_NO_ERROR;
+    }
+}
+
+template <bool UseFlatStorage>
+void ClusterStateCacheT<UseFlatStorage>::InitAttributeReader(TLV::TLVReader & reader, const AttributeData & data) const
+{
+    if constexpr (UseFlatStorage)
+    {
+        // Values referred to in a report buffer keep the context tag they have in their AttributeDataIB.
+        const uint8_t * start =
+            (data.mBuffer == 0) ? mArena.data() : mReportBuffers[data.mBuffer - 1].mBuffer->Start();
+        reader.Init(ByteSpan(start + data.mOffset, data.mSize), TLV::kTLVType_UnknownContainer);
+    }
+    else
+    {
+        reader.Init(data.Get(), data.AllocatedSize());
+    }
+}
+
+template <bool UseFlatStorage>
+void ClusterStateCacheT<UseFlatStorage>::ReleaseAttributeData(const AttributeState & aState)
+{
+    if constexpr (UseFlatStorage)
+    {
+        if (aState.template Is<AttributeData>())
+        {
+            auto & data = aState.template Get<AttributeData>();
+            if (data.mBuffer == 0)
+            {
+                mArenaGarbage += data.mSize;
+            }
+            else
+            {
+                mReportBuffers[data.mBuffer - 1].mReleasedBytes += data.mSize;
+            }
+        }
+    }
+}
+
+template <bool UseFlatStorage>
+void ClusterStateCacheT<UseFlatStorage>::CompactStorage()
+{
+    if constexpr (UseFlatStorage)
+    {
+        // Report buffers are released once most of the values referred to in them were replaced, the values left being
+        // copied to the arena. The arena is repacked once values replaced make up half of it.
+        std::vector<uint8_t> newBufferIndex(mReportBuffers.size());
+        bool releaseBuffers = false;
+        uint8_t keptBuffers = 0;
+        for (size_t i = 0; i < mReportBuffers.size(); i++)
+        {
+            if (mReportBuffers[i].mReleasedBytes * 2 >= mReportBuffers[i].mReferencedBytes)
+            {
+                releaseBuffers = true;
+            }
+            else
+            {
+                newBufferIndex[i] = ++keptBuffers;
+            }
+        }
+
+        bool compactArena = mArenaGarbage > 0 && mArenaGarbage >= mArena.size() / 2;
+        VerifyOrReturn(releaseBuffers || compactArena);
+
+        std::vector<uint8_t> arena;
+        if (compactArena)
+        {
+            arena.reserve(mArena.size() - mArenaGarbage);
+        }
+        auto & targetArena = compactArena ? arena : mArena;
+
+        for (auto & endpointIter : mCache)
+        {
+            for (auto & clusterIter : endpointIter.second)
+            {
+                for (auto & attributeIter : clusterIter.second.mAttributes)
+                {
+                    if (!attributeIter.second.template Is<AttributeData>())
+                    {
+                        continue;
+                    }
+
+                    auto & data = attributeIter.second.template Get<AttributeData>();
+                    const uint8_t * from;
+                    if (data.mBuffer == 0)
+                    {
+                        if (!compactArena)
+                        {
+                            continue;
+                        }
+                        from = mArena.data() + data.mOffset;
+                    }
+                    else if (newBufferIndex[data.mBuffer - 1] != 0)
+                    {
+                        data.mBuffer = newBufferIndex[data.mBuffer - 1];
+                        continue;
+                    }
+                    else
+                    {
+                        from = mReportBuffers[data.mBuffer - 1].mBuffer->Start() + data.mOffset;
+                    }
+
+                    data.mOffset = static_cast<uint32_t>(targetArena.size());
+                    data.mBuffer = 0;
+                    targetArena.insert(targetArena.end(), from, from + data.mSize);
+                }
+            }
+        }
+
+        if (compactArena)
+        {
+            mArena.swap(arena);
+            mArenaGarbage = 0;
+        }
+
+        for (size_t i = 0; i < mReportBuffers.size(); i++)
+        {
+            if (newBufferIndex[i] != 0 && newBufferIndex[i] - 1u != i)
+            {
+                mReportBuffers[newBufferIndex[i] - 1u] = std::move(mReportBuffers[i]);
+            }
+        }
+        mReportBuffers.resize(keptBuffers);
+    }
+}
+
+template <bool UseFlatStorage>
+CHIP_ERROR ClusterStateCacheT<UseFlatStorage>::UpdateCache(const ConcreteDataAttributePath & aPath, TLV::TLVReader * apData,
+                                                           const StatusIB & aStatus)
 {
     AttributeState state;
     bool endpointIsNew = false;
@@ -83,22 +294,17 @@ CHIP_ERROR ClusterStateCache::UpdateCache(const ConcreteDataAttributePath & aPat
     if (apData)
     {
         size_t elementSize = 0;
-        ReturnErrorOnFailure(GetElementTLVSize(apData, elementSize));
 
         if (mCacheData)
         {
-            Platform::ScopedMemoryBufferWithSize<uint8_t> backingBuffer;
-            backingBuffer.Calloc(elementSize);
-            VerifyOrReturnError(backingBuffer.Get() != nullptr, CHIP_ERROR_NO_MEMORY);
-            TLV::ScopedBufferTLVWriter writer(std::move(backingBuffer), elementSize);
-            ReturnErrorOnFailure(writer.CopyElement(TLV::AnonymousTag(), *apData));
-            ReturnErrorOnFailure(writer.Finalize(backingBuffer));
-
-            state.Set<AttributeData>(std::move(backingBuffer));
+            AttributeData data;
+            ReturnErrorOnFailure(StoreAttributeData(*apData, data, elementSize));
+            state.template Set<AttributeData>(std::move(data));
         }
         else
         {
-            state.Set<size_t>(elementSize);
+            ReturnErrorOnFailure(GetElementTLVSize(apData, elementSize));
+            state.template Set<size_t>(elementSize);
         }
         //
         // Clear out the committed data version and only set it again once we have received all data for this cluster.
@@ -134,11 +340,11 @@ CHIP_ERROR ClusterStateCache::UpdateCache(const ConcreteDataAttributePath & aPat
     {
         if (mCacheData)
         {
-            state.Set<StatusIB>(aStatus);
+            state.template Set<StatusIB>(aStatus);
         }
         else
         {
-            state.Set<size_t>(SizeOfStatusIB(aStatus));
+            state.template Set<size_t>(SizeOfStatusIB(aStatus));
         }
     }
 
@@ -151,7 +357,9 @@ CHIP_ERROR ClusterStateCache::UpdateCache(const ConcreteDataAttributePath & aPat
         mAddedEndpoints.push_back(aPath.mEndpointId);
     }
 
-    mCache[aPath.mEndpointId][aPath.mClusterId].mAttributes[aPath.mAttributeId] = std::move(state);
+    auto & attributeState = mCache[aPath.mEndpointId][aPath.mClusterId].mAttributes[aPath.mAttributeId];
+    ReleaseAttributeData(attributeState);
+    attributeState = std::move(state);
 
     if (mCacheData)
     {
@@ -161,7 +369,9 @@ CHIP_ERROR ClusterStateCache::UpdateCache(const ConcreteDataAttributePath & aPat
     return CHIP_NO_ERROR;
 }
 
-CHIP_ERROR ClusterStateCache::UpdateEventCache(const EventHeader & aEventHeader, TLV::TLVReader * apData, const StatusIB * apStatus)
+template <bool UseFlatStorage>
+CHIP_ERROR ClusterStateCacheT<UseFlatStorage>::UpdateEventCache(const EventHeader & aEventHeader, TLV::TLVReader * apData,
+                                                                const StatusIB * apStatus)
 {
     if (apData)
     {
@@ -208,7 +418,8 @@ CHIP_ERROR ClusterStateCache::UpdateEventCache(const EventHeader & aEventHeader,
     return CHIP_NO_ERROR;
 }
 
-void ClusterStateCache::OnReportBegin()
+template <bool UseFlatStorage>
+void ClusterStateCacheT<UseFlatStorage>::OnReportBegin()
 {
     mLastReportDataPath = ConcreteClusterPath(kInvalidEndpointId, kInvalidClusterId);
     mChangedAttributeSet.clear();
@@ -216,7 +427,8 @@ void ClusterStateCache::OnReportBegin()
     mCallback.OnReportBegin();
 }
 
-void ClusterStateCache::CommitPendingDataVersion()
+template <bool UseFlatStorage>
+void ClusterStateCacheT<UseFlatStorage>::CommitPendingDataVersion()
 {
     if (!mLastReportDataPath.IsValidConcreteClusterPath())
     {
@@ -231,12 +443,18 @@ void ClusterStateCache::CommitPendingDataVersion()
     }
 }
 
-void ClusterStateCache::OnReportEnd()
+template <bool UseFlatStorage>
+void ClusterStateCacheT<UseFlatStorage>::OnReportEnd()
 {
     CommitPendingDataVersion();
     mLastReportDataPath = ConcreteClusterPath(kInvalidEndpointId, kInvalidClusterId);
     std::set<std::tuple<EndpointId, ClusterId>> changedClusters;
 
+    // Reclaim the storage of the values replaced by this report, and stop referring to this report's buffer.
+    mReportBuffer      = nullptr;
+    mReportBufferIndex = 0;
+    CompactStorage();
+
     //
     // Add the EndpointId and ClusterId into a set so that we only
     // convey unique combinations in the subsequent OnClusterChanged callback.
@@ -260,26 +478,40 @@ void ClusterStateCache::OnReportEnd()
     mCallback.OnReportEnd();
 }
 
-CHIP_ERROR ClusterStateCache::Get(const ConcreteAttributePath & path, TLV::TLVReader & reader) const
+template <bool UseFlatStorage>
+void ClusterStateCacheT<UseFlatStorage>::OnReportBuffer(const System::PacketBufferHandle & aBuffer)
+{
+    if (UseFlatStorage && mRetainReportBuffers)
+    {
+        mReportBuffer      = aBuffer.Retain();
+        mReportBufferIndex = 0;
+    }
+
+    mCallback.OnReportBuffer(aBuffer);
+}
+
+template <bool UseFlatStorage>
+CHIP_ERROR ClusterStateCacheT<UseFlatStorage>::Get(const ConcreteAttributePath & path, TLV::TLVReader & reader) const
 {
     CHIP_ERROR err;
     auto attributeState = GetAttributeState(path.mEndpointId, path.mClusterId, path.mAttributeId, err);
     ReturnErrorOnFailure(err);
-    if (attributeState->Is<StatusIB>())
+    if (attributeState->template Is<StatusIB>())
     {
         return CHIP_ERROR_IM_STATUS_CODE_RECEIVED;
     }
 
-    if (!attributeState->Is<AttributeData>())
+    if (!attributeState->template Is<AttributeData>())
     {
         return CHIP_ERROR_KEY_NOT_FOUND;
     }
 
-    reader.Init(attributeState->Get<AttributeData>().Get(), attributeState->Get<AttributeData>().AllocatedSize());
+    InitAttributeReader(reader, attributeState->template Get<AttributeData>());
     return reader.Next();
 }
 
-CHIP_ERROR ClusterStateCache::Get(EventNumber eventNumber, TLV::TLVReader & reader) const
+template <bool UseFlatStorage>
+CHIP_ERROR ClusterStateCacheT<UseFlatStorage>::Get(EventNumber eventNumber, TLV::TLVReader & reader) const
 {
     CHIP_ERROR err;
 
@@ -295,7 +527,9 @@ CHIP_ERROR ClusterStateCache::Get(EventNumber eventNumber, TLV::TLVReader & read
     return CHIP_NO_ERROR;
 }
 
-const ClusterStateCache::EndpointState * ClusterStateCache::GetEndpointState(EndpointId endpointId, CHIP_ERROR & err) const
+template <bool UseFlatStorage>
+const typename ClusterStateCacheT<UseFlatStorage>::EndpointState *
+ClusterStateCacheT<UseFlatStorage>::GetEndpointState(EndpointId endpointId, CHIP_ERROR & err) const
 {
     auto endpointIter = mCache.find(endpointId);
     if (endpointIter == mCache.end())
@@ -308,8 +542,9 @@ const ClusterStateCache::EndpointState * ClusterStateCache::GetEndpointState(End
     return &endpointIter->second;
 }
 
-const ClusterStateCache::ClusterState * ClusterStateCache::GetClusterState(EndpointId endpointId, ClusterId clusterId,
-                                                                           CHIP_ERROR & err) const
+template <bool UseFlatStorage>
+const typename ClusterStateCacheT<UseFlatStorage>::ClusterState *
+ClusterStateCacheT<UseFlatStorage>::GetClusterState(EndpointId endpointId, ClusterId clusterId, CHIP_ERROR & err) const
 {
     auto endpointState = GetEndpointState(endpointId, err);
     if (err != CHIP_NO_ERROR)
@@ -328,8 +563,10 @@ const ClusterStateCache::ClusterState * ClusterStateCache::GetClusterState(Endpo
     return &clusterState->second;
 }
 
-const ClusterStateCache::AttributeState * ClusterStateCache::GetAttributeState(EndpointId endpointId, ClusterId clusterId,
-                                                                               AttributeId attributeId, CHIP_ERROR & err) const
+template <bool UseFlatStorage>
+const typename ClusterStateCacheT<UseFlatStorage>::AttributeState *
+ClusterStateCacheT<UseFlatStorage>::GetAttributeState(EndpointId endpointId, ClusterId clusterId, AttributeId attributeId,
+                                                      CHIP_ERROR & err) const
 {
     auto clusterState = GetClusterState(endpointId, clusterId, err);
     if (err != CHIP_NO_ERROR)
@@ -348,7 +585,9 @@ const ClusterStateCache::AttributeState * ClusterStateCache::GetAttributeState(E
     return &attributeState->second;
 }
 
-const ClusterStateCache::EventData * ClusterStateCache::GetEventData(EventNumber eventNumber, CHIP_ERROR & err) const
+template <bool UseFlatStorage>
+const typename ClusterStateCacheT<UseFlatStorage>::EventData *
+ClusterStateCacheT<UseFlatStorage>::GetEventData(EventNumber eventNumber, CHIP_ERROR & err) const
 {
     EventData compareKey;
 
@@ -364,7 +603,9 @@ const ClusterStateCache::EventData * ClusterStateCache::GetEventData(EventNumber
     return &(*eventData);
 }
 
-void ClusterStateCache::OnAttributeData(const ConcreteDataAttributePath & aPath, TLV::TLVReader * apData, const StatusIB & aStatus)
+template <bool UseFlatStorage>
+void ClusterStateCacheT<UseFlatStorage>::OnAttributeData(const ConcreteDataAttributePath & aPath, TLV::TLVReader * apData,
+                                                         const StatusIB & aStatus)
 {
     //
     // Since the cache itself is a ReadClient::Callback, it may be incorrectly passed in directly when registering with the
@@ -394,7 +635,8 @@ void ClusterStateCache::OnAttributeData(const ConcreteDataAttributePath & aPath,
     mCallback.OnAttributeData(aPath, apData ? &dataSnapshot : nullptr, aStatus);
 }
 
-CHIP_ERROR ClusterStateCache::GetVersion(const ConcreteClusterPath & aPath, Optional<DataVersion> & aVersion) const
+template <bool UseFlatStorage>
+CHIP_ERROR ClusterStateCacheT<UseFlatStorage>::GetVersion(const ConcreteClusterPath & aPath, Optional<DataVersion> & aVersion) const
 {
     VerifyOrReturnError(aPath.IsValidConcreteClusterPath(), CHIP_ERROR_INVALID_ARGUMENT);
     CHIP_ERROR err;
@@ -404,7 +646,9 @@ CHIP_ERROR ClusterStateCache::GetVersion(const ConcreteClusterPath & aPath, Opti
     return CHIP_NO_ERROR;
 }
 
-void ClusterStateCache::OnEventData(const EventHeader & aEventHeader, TLV::TLVReader * apData, const StatusIB * apStatus)
+template <bool UseFlatStorage>
+void ClusterStateCacheT<UseFlatStorage>::OnEventData(const EventHeader & aEventHeader, TLV::TLVReader * apData,
+                                                     const StatusIB * apStatus)
 {
     VerifyOrDie(apData != nullptr || apStatus != nullptr);
 
@@ -418,23 +662,25 @@ void ClusterStateCache::OnEventData(const EventHeader & aEventHeader, TLV::TLVRe
     mCallback.OnEventData(aEventHeader, apData ? &dataSnapshot : nullptr, apStatus);
 }
 
-CHIP_ERROR ClusterStateCache::GetStatus(const ConcreteAttributePath & path, StatusIB & status) const
+template <bool UseFlatStorage>
+CHIP_ERROR ClusterStateCacheT<UseFlatStorage>::GetStatus(const ConcreteAttributePath & path, StatusIB & status) const
 {
     CHIP_ERROR err;
 
     auto attributeState = GetAttributeState(path.mEndpointId, path.mClusterId, path.mAttributeId, err);
     ReturnErrorOnFailure(err);
 
-    if (!attributeState->Is<StatusIB>())
+    if (!attributeState->template Is<StatusIB>())
     {
         return CHIP_ERROR_INVALID_ARGUMENT;
     }
 
-    status = attributeState->Get<StatusIB>();
+    status = attributeState->template Get<StatusIB>();
     return CHIP_NO_ERROR;
 }
 
-CHIP_ERROR ClusterStateCache::GetStatus(const ConcreteEventPath & path, StatusIB & status) const
+template <bool UseFlatStorage>
+CHIP_ERROR ClusterStateCacheT<UseFlatStorage>::GetStatus(const ConcreteEventPath & path, StatusIB & status) const
 {
     auto statusIter = mEventStatusCache.find(path);
     if (statusIter == mEventStatusCache.end())
@@ -446,7 +692,8 @@ CHIP_ERROR ClusterStateCache::GetStatus(const ConcreteEventPath & path, StatusIB
     return CHIP_NO_ERROR;
 }
 
-void ClusterStateCache::GetSortedFilters(std::vector<std::pair<DataVersionFilter, size_t>> & aVector) const
+template <bool UseFlatStorage>
+void ClusterStateCacheT<UseFlatStorage>::GetSortedFilters(std::vector<std::pair<DataVersionFilter, size_t>> & aVector) const
 {
     for (auto const & endpointIter : mCache)
     {
@@ -463,20 +710,19 @@ void ClusterStateCache::GetSortedFilters(std::vector<std::pair<DataVersionFilter
 
             for (auto const & attributeIter : clusterIter.second.mAttributes)
             {
-                if (attributeIter.second.Is<StatusIB>())
+                if (attributeIter.second.template Is<StatusIB>())
                 {
-                    clusterSize += SizeOfStatusIB(attributeIter.second.Get<StatusIB>());
+                    clusterSize += SizeOfStatusIB(attributeIter.second.template Get<StatusIB>());
                 }
-                else if (attributeIter.second.Is<size_t>())
+                else if (attributeIter.second.template Is<size_t>())
                 {
-                    clusterSize += attributeIter.second.Get<size_t>();
+                    clusterSize += attributeIter.second.template Get<size_t>();
                 }
                 else
                 {
-                    VerifyOrDie(attributeIter.second.Is<AttributeData>());
+                    VerifyOrDie(attributeIter.second.template Is<AttributeData>());
                     TLV::TLVReader bufReader;
-                    bufReader.Init(attributeIter.second.Get<AttributeData>().Get(),
-                                   attributeIter.second.Get<AttributeData>().AllocatedSize());
+                    InitAttributeReader(bufReader, attributeIter.second.template Get<AttributeData>());
                     ReturnOnFailure(bufReader.Next());
                     // Skip to the end of the element.
                     ReturnOnFailure(bufReader.Skip());
@@ -505,9 +751,11 @@ void ClusterStateCache::GetSortedFilters(std::vector<std::pair<DataVersionFilter
               });
 }
 
-CHIP_ERROR ClusterStateCache::OnUpdateDataVersionFilterList(DataVersionFilterIBs::Builder & aDataVersionFilterIBsBuilder,
-                                                            const Span<AttributePathParams> & aAttributePaths,
-                                                            bool & aEncodedDataVersionList)
+template <bool UseFlatStorage>
+CHIP_ERROR
+ClusterStateCacheT<UseFlatStorage>::OnUpdateDataVersionFilterList(DataVersionFilterIBs::Builder & aDataVersionFilterIBsBuilder,
+                                                                  const Span<AttributePathParams> & aAttributePaths,
+                                                                  bool & aEncodedDataVersionList)
 {
     CHIP_ERROR err = CHIP_NO_ERROR;
     TLV::TLVWriter backup;
@@ -587,7 +835,8 @@ exit:
     return err;
 }
 
-CHIP_ERROR ClusterStateCache::GetLastReportDataPath(ConcreteClusterPath & aPath)
+template <bool UseFlatStorage>
+CHIP_ERROR ClusterStateCacheT<UseFlatStorage>::GetLastReportDataPath(ConcreteClusterPath & aPath)
 {
     if (mLastReportDataPath.IsValidConcreteClusterPath())
     {
@@ -596,5 +845,8 @@ CHIP_ERROR ClusterStateCache::GetLastReportDataPath(ConcreteClusterPath & aPath)
     }
     return CHIP_ERROR_INCORRECT_STATE;
 }
+
+template class ClusterStateCacheT<false>;
+template class ClusterStateCacheT<true>;
 } // namespace app
 } // namespace chip
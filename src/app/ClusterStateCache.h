@@ -27,11 +27,13 @@
 #include <app/ReadClient.h>
 #include <app/data-model/DecodableList.h>
 #include <app/data-model/Decode.h>
+#include <lib/support/FlatMap.h>
 #include <lib/support/Variant.h>
 #include <list>
 #include <map>
 #include <queue>
 #include <set>
+#include <type_traits>
 #include <vector>
 
 #if CHIP_CONFIG_ENABLE_READ_CLIENT
@@ -61,12 +63,27 @@ namespace app {
  * through to a registered callback. In addition, it provides its own enhancements to the base ReadClient::Callback
  * to make it easier to know what has changed in the cache.
  *
+ * The cache comes in two storage flavors, with the same API:
+ *
+ * - ClusterStateCache keeps the state in nested std::map and std::set containers, and every attribute value in its own
+ *   heap buffer.
+ *
+ * - FlatClusterStateCache keeps the state in sorted vectors (see FlatMap), and the attribute values packed in a single
+ *   buffer that is compacted as reports replace values. This takes much less memory and far fewer allocations per
+ *   attribute, which matters when mirroring many nodes. In exchange, updating any attribute value may move the others,
+ *   so readers obtained from Get() are only valid until the cache is next updated.
+ *
+ * With SetRetainReportBuffers(true), FlatClusterStateCache goes further and does not copy attribute values out of the
+ * reports at all: it retains the report buffers and refers to the values where they are in them, releasing a buffer
+ * (after copying out the values still referred to in it) once most of those values were replaced.
+ *
  * **NOTE**
  * 1. This already includes the BufferedReadCallback, so there is no need to add that to the ReadClient callback chain.
  * 2. The same cache cannot be used by multiple subscribe/read interactions at the same time.
  *
  */
-class ClusterStateCache : protected ReadClient::Callback
+template <bool UseFlatStorage>
+class ClusterStateCacheT : protected ReadClient::Callback
 {
 public:
     class Callback : public ReadClient::Callback
@@ -83,17 +100,17 @@ public:
         /*
          * Called anytime an attribute value has changed in the cache
          */
-        virtual void OnAttributeChanged(ClusterStateCache * cache, const ConcreteAttributePath & path){};
+        virtual void OnAttributeChanged(ClusterStateCacheT * cache, const ConcreteAttributePath & path){};
 
         /*
          * Called anytime any attribute in a cluster has changed in the cache
          */
-        virtual void OnClusterChanged(ClusterStateCache * cache, EndpointId endpointId, ClusterId clusterId){};
+        virtual void OnClusterChanged(ClusterStateCacheT * cache, EndpointId endpointId, ClusterId clusterId){};
 
         /*
          * Called anytime an endpoint was added to the cache
          */
-        virtual void OnEndpointAdded(ClusterStateCache * cache, EndpointId endpointId){};
+        virtual void OnEndpointAdded(ClusterStateCacheT * cache, EndpointId endpointId){};
     };
 
     /**
@@ -104,24 +121,38 @@ public:
      * @param [in] cacheData boolean to decide whether this cache would store attribute/event data/status,
      *             the default is true.
      */
-    ClusterStateCache(Callback & callback, Optional<EventNumber> highestReceivedEventNumber = Optional<EventNumber>::Missing(),
-                      bool cacheData = true) :
+    ClusterStateCacheT(Callback & callback, Optional<EventNumber> highestReceivedEventNumber = Optional<EventNumber>::Missing(),
+                       bool cacheData = true) :
         mCallback(callback),
         mBufferedReader(*this), mCacheData(cacheData)
     {
         mHighestReceivedEventNumber = highestReceivedEventNumber;
     }
 
-    ClusterStateCache(const ClusterStateCache &)             = delete;
-    ClusterStateCache(ClusterStateCache &&)                  = delete;
-    ClusterStateCache & operator=(const ClusterStateCache &) = delete;
-    ClusterStateCache & operator=(ClusterStateCache &&)      = delete;
+    ClusterStateCacheT(const ClusterStateCacheT &)             = delete;
+    ClusterStateCacheT(ClusterStateCacheT &&)                  = delete;
+    ClusterStateCacheT & operator=(const ClusterStateCacheT &) = delete;
+    ClusterStateCacheT & operator=(ClusterStateCacheT &&)      = delete;
 
     void SetHighestReceivedEventNumber(EventNumber highestReceivedEventNumber)
     {
         mHighestReceivedEventNumber.SetValue(highestReceivedEventNumber);
     }
 
+    /*
+     * Sets whether to retain the buffers of the reports received, to refer to the data in them instead of copying it
+     * out (see ReadClient::Callback::OnReportBuffer). This is off by default, and should be set before any report is
+     * received.
+     *
+     * Both flavors then buffer up chunked lists by reference, and FlatClusterStateCache also keeps attribute values by
+     * reference, until most of the values in a buffer have been replaced.
+     */
+    void SetRetainReportBuffers(bool retainReportBuffers)
+    {
+        mRetainReportBuffers = retainReportBuffers;
+        mBufferedReader.SetRetainReportBuffers(retainReportBuffers);
+    }
+
     /*
      * When registering as a callback to the ReadClient, the ClusterStateCache cannot not be passed as a callback
      * directly. Instead, utilize this method below to correctly set up the callback chain such that
@@ -135,8 +166,8 @@ public:
      *
      * For some types of attributes, the value for the attribute is directly backed by the underlying TLV buffer
      * and has pointers into that buffer. (e.g octet strings, char strings and lists).  This buffer only remains
-     * valid until the cached value for that path is updated, so it must not be held
-     * across any async call boundaries.
+     * valid until the cached value for that path (or, for FlatClusterStateCache, any path) is updated, so it must
+     * not be held across any async call boundaries.
      *
      * The template parameter AttributeObjectTypeT is generally expected to be a
      * ClusterName::Attributes::AttributeName::DecodableType, but any
@@ -207,8 +238,8 @@ public:
      *
      * For some types of attributes, the value for the attribute is directly backed by the underlying TLV buffer
      * and has pointers into that buffer. (e.g octet strings, char strings and lists).  This buffer only remains
-     * valid until the cached value for that path is updated, so it must not be held
-     * across any async call boundaries.
+     * valid until the cached value for that path (or, for FlatClusterStateCache, any path) is updated, so it must
+     * not be held across any async call boundaries.
      *
      * The template parameter ClusterObjectT is generally expected to be a
      * ClusterName::Attributes::DecodableType, but any
@@ -254,8 +285,8 @@ public:
      * Retrieve the value of an attribute by updating a in-out TLVReader to be positioned
      * right at the attribute value.
      *
-     * The underlying TLV buffer only remains valid until the cached value for that path is updated, so it must
-     * not be held across any async call boundaries.
+     * The underlying TLV buffer only remains valid until the cached value for that path (or, for
+     * FlatClusterStateCache, any path) is updated, so it must not be held across any async call boundaries.
      *
      * Notable return values:
      *      - If neither data nor status for the specified path exist in the cache, CHIP_ERROR_KEY_NOT_FOUND
@@ -526,6 +557,32 @@ public:
     CHIP_ERROR GetLastReportDataPath(ConcreteClusterPath & aPath);
 
 private:
+    template <typename Key, typename Value>
+    using Map = std::conditional_t<UseFlatStorage, FlatMap<Key, Value>, std::map<Key, Value>>;
+    template <typename T, typename Compare = std::less<T>>
+    using Set = std::conditional_t<UseFlatStorage, FlatSet<T, Compare>, std::set<T, Compare>>;
+
+    // Location of an attribute value, for flat storage: in mArena, or in one of mReportBuffers when referred to in the
+    // report it came in.
+    struct DataSlice
+    {
+        static constexpr uint32_t kMaxSize        = (1u << 24) - 1;
+        static constexpr size_t kMaxReportBuffers = UINT8_MAX;
+
+        uint32_t mOffset;
+        uint32_t mSize : 24;
+        uint32_t mBuffer : 8; // 0 for mArena, or 1 + the index in mReportBuffers.
+    };
+
+    // A report buffer retained for the attribute values referred to in it, with how many bytes of values were referred
+    // to in it and how many of them were since replaced.
+    struct ReportBuffer
+    {
+        System::PacketBufferHandle mBuffer;
+        uint32_t mReferencedBytes = 0;
+        uint32_t mReleasedBytes   = 0;
+    };
+
     // An attribute state can be one of three things:
     // * If we got a path-specific error for the attribute, the corresponding
     //   status.
@@ -534,7 +591,7 @@ private:
     // * If we got data for the attribute and we are not storing data
     //   oureselves, the size of the data, so we can still prioritize sending
     //   DataVersions correctly.
-    using AttributeData  = Platform::ScopedMemoryBufferWithSize<uint8_t>;
+    using AttributeData  = std::conditional_t<UseFlatStorage, DataSlice, Platform::ScopedMemoryBufferWithSize<uint8_t>>;
     using AttributeState = Variant<StatusIB, AttributeData, size_t>;
     // mPendingDataVersion represents a tentative data version for a cluster that we have gotten some reports for.
     //
@@ -543,12 +600,12 @@ private:
     // and we must not be in the middle of receiving reports for that cluster.
     struct ClusterState
     {
-        std::map<AttributeId, AttributeState> mAttributes;
+        Map<AttributeId, AttributeState> mAttributes;
         Optional<DataVersion> mPendingDataVersion;
         Optional<DataVersion> mCommittedDataVersion;
     };
-    using EndpointState = std::map<ClusterId, ClusterState>;
-    using NodeState     = std::map<EndpointId, EndpointState>;
+    using EndpointState = Map<ClusterId, ClusterState>;
+    using NodeState     = Map<EndpointId, EndpointState>;
 
     struct Comparator
     {
@@ -591,6 +648,25 @@ private:
 
     const EventData * GetEventData(EventNumber number, CHIP_ERROR & err) const;
 
+    // Initializes reader to read the TLV of attribute data.
+    void InitAttributeReader(TLV::TLVReader & reader, const AttributeData & data) const;
+
+    /*
+     * Copies the TLV element of apData into storage for the value of an attribute. Flat storage refers to it in the
+     * report buffer when it can, or else appends it to mArena. aSize is then set to the size of the element.
+     */
+    CHIP_ERROR StoreAttributeData(TLV::TLVReader & aData, AttributeData & aStored, size_t & aSize);
+
+    // Refers to the TLV element of aData in the buffer of the report being processed, if retained and holding it.
+    bool ReferToReportBuffer(const TLV::TLVReader & aData, AttributeData & aStored);
+
+    // Accounts for an attribute value that is being replaced, for flat storage.
+    void ReleaseAttributeData(const AttributeState & aState);
+
+    // Releases the report buffers holding mostly replaced values, and repacks mArena without the replaced values, for
+    // flat storage.
+    void CompactStorage();
+
     /*
      * Updates the state of an attribute in the cache given a reader. If the reader is null, the state is updated
      * with the provided status.
@@ -611,8 +687,14 @@ private:
     //
     void OnReportBegin() override;
     void OnReportEnd() override;
+    void OnReportBuffer(const System::PacketBufferHandle & aBuffer) override;
     void OnAttributeData(const ConcreteDataAttributePath & aPath, TLV::TLVReader * apData, const StatusIB & aStatus) override;
-    void OnError(CHIP_ERROR aError) override { return mCallback.OnError(aError); }
+    void OnError(CHIP_ERROR aError) override
+    {
+        mReportBuffer      = nullptr;
+        mReportBufferIndex = 0;
+        return mCallback.OnError(aError);
+    }
 
     void OnEventData(const EventHeader & aEventHeader, TLV::TLVReader * apData, const StatusIB * apStatus) override;
 
@@ -663,18 +745,32 @@ private:
 
     Callback & mCallback;
     NodeState mCache;
-    std::set<ConcreteAttributePath> mChangedAttributeSet;
+    Set<ConcreteAttributePath> mChangedAttributeSet;
     std::set<AttributePathParams, Comparator> mRequestPathSet; // wildcard attribute request path only
     std::vector<EndpointId> mAddedEndpoints;
 
-    std::set<EventData, EventDataCompare> mEventDataCache;
+    // Attribute values of flat storage, and how many bytes of it are held by values since replaced.
+    std::vector<uint8_t> mArena;
+    size_t mArenaGarbage = 0;
+
+    // Report buffers retained by flat storage, and the buffer of the report being processed, with its index + 1 in
+    // mReportBuffers once a value is referred to in it.
+    std::vector<ReportBuffer> mReportBuffers;
+    System::PacketBufferHandle mReportBuffer;
+    uint8_t mReportBufferIndex = 0;
+    bool mRetainReportBuffers  = false;
+
+    Set<EventData, EventDataCompare> mEventDataCache;
     Optional<EventNumber> mHighestReceivedEventNumber;
-    std::map<ConcreteEventPath, StatusIB> mEventStatusCache;
+    Map<ConcreteEventPath, StatusIB> mEventStatusCache;
     BufferedReadCallback mBufferedReader;
     ConcreteClusterPath mLastReportDataPath = ConcreteClusterPath(kInvalidEndpointId, kInvalidClusterId);
     const bool mCacheData                   = true;
 };
 
+using ClusterStateCache     = ClusterStateCacheT<false>;
+using FlatClusterStateCache = ClusterStateCacheT<true>;
+
 };     // namespace app
 };     // namespace chip
 #endif // CHIP_CONFIG_ENABLE_READ_CLIENT
@@ -29,6 +29,7 @@
 
 #include <access/AccessControl.h>
 #include <app-common/zap-generated/cluster-objects.h>
+#include <app/InteractionModelHelper.h>
 #include <app/RequiredPrivilege.h>
 #include <app/util/MatterCallbacks.h>
 #include <credentials/GroupDataProvider.h>
@@ -50,10 +51,7 @@ CHIP_ERROR CommandHandler::AllocateBuffer()
     {
         mCommandMessageWriter.Reset();
 
-        System::PacketBufferHandle commandPacket = System::PacketBufferHandle::New(chip::app::kMaxSecureSduLengthBytes);
-        VerifyOrReturnError(!commandPacket.IsNull(), CHIP_ERROR_NO_MEMORY);
-
-        mCommandMessageWriter.Init(std::move(commandPacket));
+        ReturnErrorOnFailure(InitWriterWithSpaceReserved(mCommandMessageWriter, kReservedSizeForTLVEncodingOverhead));
         ReturnErrorOnFailure(mInvokeResponseBuilder.Init(&mCommandMessageWriter));
 
         mInvokeResponseBuilder.SuppressResponse(mSuppressResponse);
@@ -61,7 +59,8 @@ CHIP_ERROR CommandHandler::AllocateBuffer()
 
         mInvokeResponseBuilder.CreateInvokeResponses();
         ReturnErrorOnFailure(mInvokeResponseBuilder.GetError());
-        mBufferAllocated = true;
+        mBufferAllocated     = true;
+        mMessageHasResponses = false;
     }
 
     return CHIP_NO_ERROR;
@@ -117,11 +116,17 @@ Status CommandHandler::ProcessInvokeRequest(System::PacketBufferHandle && payloa
     invokeRequests.GetReader(&invokeRequestsReader);
 
     {
-        // We don't support handling multiple commands but the protocol is ready to support it in the future, reject all of them and
-        // IM Engine will send a status response.
+        // Reject the whole request if it has more commands than we take, or commands we could not tell apart in the responses,
+        // and IM Engine will send a status response.
         size_t commandCount = 0;
-        TLV::Utilities::Count(invokeRequestsReader, commandCount, false /* recurse */);
-        VerifyOrReturnError(commandCount == 1, Status::InvalidAction);
+        VerifyOrReturnError(TLV::Utilities::Count(invokeRequestsReader, commandCount, false /* recurse */) == CHIP_NO_ERROR,
+                            Status::InvalidAction);
+        VerifyOrReturnError(commandCount > 0 && commandCount <= CHIP_CONFIG_MAX_PATHS_PER_INVOKE, Status::InvalidAction);
+        if (!mExchangeCtx->IsGroupExchangeContext())
+        {
+            VerifyOrReturnError(RecordRequestedCommands(invokeRequestsReader, commandCount) == CHIP_NO_ERROR,
+                                Status::InvalidAction);
+        }
     }
 
     while (CHIP_NO_ERROR == (err = invokeRequestsReader.Next()))
@@ -154,14 +159,125 @@ Status CommandHandler::ProcessInvokeRequest(System::PacketBufferHandle && payloa
     return Status::Success;
 }
 
+CHIP_ERROR CommandHandler::RecordRequestedCommands(TLV::TLVReader aInvokeRequestsReader, size_t aCommandCount)
+{
+    CHIP_ERROR err         = CHIP_NO_ERROR;
+    mRequestedCommandCount = 0;
+
+    while (CHIP_NO_ERROR == (err = aInvokeRequestsReader.Next()))
+    {
+        CommandDataIB::Parser commandData;
+        CommandPathIB::Parser commandPath;
+        RequestedCommand & command = mRequestedCommands[mRequestedCommandCount];
+        uint16_t ref               = 0;
+
+        ReturnErrorOnFailure(commandData.Init(aInvokeRequestsReader));
+        ReturnErrorOnFailure(commandData.GetPath(&commandPath));
+        ReturnErrorOnFailure(commandPath.GetConcreteCommandPath(command.mPath));
+
+        err = commandData.GetRef(&ref);
+        if (CHIP_NO_ERROR == err)
+        {
+            command.mRef.SetValue(ref);
+        }
+        else if (CHIP_END_OF_TLV == err && aCommandCount == 1)
+        {
+            // A lone command needs no reference, its responses can only be to it.
+            command.mRef.ClearValue();
+        }
+        else
+        {
+            return CHIP_ERROR_INVALID_ARGUMENT;
+        }
+
+        for (size_t i = 0; i < mRequestedCommandCount; i++)
+        {
+            VerifyOrReturnError(mRequestedCommands[i].mRef != command.mRef, CHIP_ERROR_DUPLICATE_KEY_ID);
+            VerifyOrReturnError(mRequestedCommands[i].mPath != command.mPath, CHIP_ERROR_DUPLICATE_KEY_ID);
+        }
+        mRequestedCommandCount++;
+    }
+
+    return CHIP_END_OF_TLV == err ? CHIP_NO_ERROR : err;
+}
+
+Optional<uint16_t> CommandHandler::GetRefForRequestPath(const ConcreteCommandPath & aRequestCommandPath) const
+{
+    for (size_t i = 0; i < mRequestedCommandCount; i++)
+    {
+        if (mRequestedCommands[i].mPath == aRequestCommandPath)
+        {
+            return mRequestedCommands[i].mRef;
+        }
+    }
+    return NullOptional;
+}
+
+CHIP_ERROR CommandHandler::GetRefForResponsePath(const ConcreteCommandPath & aResponseCommandPath, Optional<uint16_t> & aRef) const
+{
+    bool found = false;
+
+    // Response commands mostly have ids of their own, so fall back to the endpoint and cluster to tell which command a response
+    // answers.
+    aRef = GetRefForRequestPath(aResponseCommandPath);
+    VerifyOrReturnError(!aRef.HasValue(), CHIP_NO_ERROR);
+    for (size_t i = 0; i < mRequestedCommandCount; i++)
+    {
+        const ConcreteCommandPath & requestPath = mRequestedCommands[i].mPath;
+        if (requestPath.mEndpointId == aResponseCommandPath.mEndpointId &&
+            requestPath.mClusterId == aResponseCommandPath.mClusterId)
+        {
+            VerifyOrReturnError(!found, CHIP_ERROR_INCORRECT_STATE);
+            found = true;
+            aRef  = mRequestedCommands[i].mRef;
+        }
+    }
+    return CHIP_NO_ERROR;
+}
+
 CHIP_ERROR CommandHandler::OnMessageReceived(Messaging::ExchangeContext * apExchangeContext, const PayloadHeader & aPayloadHeader,
                                              System::PacketBufferHandle && aPayload)
 {
+    if (mState == State::AwaitingResponse && aPayloadHeader.HasMessageType(Protocols::InteractionModel::MsgType::StatusResponse))
+    {
+        // The requester acknowledged the last chunk, send the next one.
+        CHIP_ERROR statusError = CHIP_NO_ERROR;
+        CHIP_ERROR err         = StatusResponse::ProcessStatusResponse(std::move(aPayload), statusError);
+        if (err == CHIP_NO_ERROR)
+        {
+            err = statusError;
+        }
+        if (err == CHIP_NO_ERROR)
+        {
+            err = SendInvokeResponse(mChunks.PopHead());
+        }
+        if (err != CHIP_NO_ERROR || mState != State::AwaitingResponse)
+        {
+            Close();
+        }
+        return err;
+    }
+
     ChipLogDetail(DataManagement, "CommandHandler: Unexpected message type %d", aPayloadHeader.GetMessageType());
     StatusResponse::Send(Status::InvalidAction, mExchangeCtx.Get(), false /*aExpectResponse*/);
+    if (mState == State::AwaitingResponse)
+    {
+        Close();
+    }
     return CHIP_ERROR_INVALID_MESSAGE_TYPE;
 }
 
+void CommandHandler::OnResponseTimeout(Messaging::ExchangeContext * ec)
+{
+    //
+    // We only expect responses to the chunks of a response but the last one.
+    //
+    VerifyOrDie(mState == State::AwaitingResponse);
+    ChipLogError(DataManagement, "Time out! failed to receive status response from Exchange: " ChipLogFormatExchange,
+                 ChipLogValueExchange(ec));
+    Close();
+}
+
 void CommandHandler::Close()
 {
     mSuppressResponse = false;
@@ -210,6 +326,12 @@ void CommandHandler::DecrementHoldOff()
         }
     }
 
+    // The chunks of the response still to send keep us around.
+    if (mState == State::AwaitingResponse)
+    {
+        return;
+    }
+
     Close();
 }
 
@@ -222,8 +344,24 @@ CHIP_ERROR CommandHandler::SendCommandResponse()
     VerifyOrReturnError(mExchangeCtx, CHIP_ERROR_INCORRECT_STATE);
 
     ReturnErrorOnFailure(Finalize(commandPacket));
-    ReturnErrorOnFailure(
-        mExchangeCtx->SendMessage(Protocols::InteractionModel::MsgType::InvokeCommandResponse, std::move(commandPacket)));
+    return SendInvokeResponse(std::move(commandPacket));
+}
+
+CHIP_ERROR CommandHandler::SendInvokeResponse(System::PacketBufferHandle && commandPacket)
+{
+    using namespace Protocols::InteractionModel;
+
+    if (!mChunks.IsNull())
+    {
+        // More chunks follow, each waits for the status response acknowledging the one before.
+        mExchangeCtx->UseSuggestedResponseTimeout(app::kExpectedIMProcessingTime);
+        ReturnErrorOnFailure(mExchangeCtx->SendMessage(MsgType::InvokeCommandResponse, std::move(commandPacket),
+                                                       Messaging::SendMessageFlags::kExpectResponse));
+        MoveToState(State::AwaitingResponse);
+        return CHIP_NO_ERROR;
+    }
+
+    ReturnErrorOnFailure(mExchangeCtx->SendMessage(MsgType::InvokeCommandResponse, std::move(commandPacket)));
     // The ExchangeContext is automatically freed here, and it makes mpExchangeCtx be temporarily dangling, but in
     // all cases, we are going to call Close immediately after this function, which nulls out mpExchangeCtx.
 
@@ -449,6 +587,20 @@ Status CommandHandler::ProcessGroupCommandDataIB(CommandDataIB::Parser & aComman
 }
 
 CHIP_ERROR CommandHandler::AddStatusInternal(const ConcreteCommandPath & aCommandPath, const StatusIB & aStatus)
+{
+    CHIP_ERROR err = TryAddStatusInternal(aCommandPath, aStatus);
+    if (err != CHIP_NO_ERROR && RollbackResponseForRetry(err))
+    {
+        err = TryAddStatusInternal(aCommandPath, aStatus);
+        if (err != CHIP_NO_ERROR)
+        {
+            RollbackResponse();
+        }
+    }
+    return err;
+}
+
+CHIP_ERROR CommandHandler::TryAddStatusInternal(const ConcreteCommandPath & aCommandPath, const StatusIB & aStatus)
 {
     ReturnErrorOnFailure(PrepareStatus(aCommandPath));
     CommandStatusIB::Builder & commandStatus = mInvokeResponseBuilder.GetInvokeResponses().GetInvokeResponse().GetStatus();
@@ -496,16 +648,25 @@ CHIP_ERROR CommandHandler::AddClusterSpecificFailure(const ConcreteCommandPath &
     return AddStatusInternal(aCommandPath, StatusIB(Status::Failure, aClusterStatus));
 }
 
-CHIP_ERROR CommandHandler::PrepareCommand(const ConcreteCommandPath & aCommandPath, bool aStartDataStruct)
+CHIP_ERROR CommandHandler::PrepareCommand(const ConcreteCommandPath & aResponseCommandPath, bool aStartDataStruct)
+{
+    Optional<uint16_t> ref;
+    ReturnErrorOnFailure(GetRefForResponsePath(aResponseCommandPath, ref));
+    return PrepareCommandWithRef(aResponseCommandPath, ref, aStartDataStruct);
+}
+
+CHIP_ERROR CommandHandler::PrepareCommandWithRef(const ConcreteCommandPath & aCommandPath, const Optional<uint16_t> & aRef,
+                                                 bool aStartDataStruct)
 {
     ReturnErrorOnFailure(AllocateBuffer());
 
     mInvokeResponseBuilder.Checkpoint(mBackupWriter);
     //
-    // We must not be in the middle of preparing a command, or having prepared or sent one.
+    // We must not be in the middle of preparing a command, or having sent one.
     //
-    VerifyOrReturnError(mState == State::Idle, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(mState == State::Idle || mState == State::AddedCommand, CHIP_ERROR_INCORRECT_STATE);
     MoveToState(State::Preparing);
+    mResponseRef = aRef;
     InvokeResponseIBs::Builder & invokeResponses = mInvokeResponseBuilder.GetInvokeResponses();
     InvokeResponseIB::Builder & invokeResponse   = invokeResponses.CreateInvokeResponse();
     ReturnErrorOnFailure(invokeResponses.GetError());
@@ -532,10 +693,13 @@ CHIP_ERROR CommandHandler::FinishCommand(bool aStartDataStruct)
     {
         ReturnErrorOnFailure(commandData.GetWriter()->EndContainer(mDataElementContainerType));
     }
+    if (mResponseRef.HasValue())
+    {
+        ReturnErrorOnFailure(commandData.Ref(mResponseRef.Value()).GetError());
+    }
     ReturnErrorOnFailure(commandData.EndOfCommandDataIB());
     ReturnErrorOnFailure(mInvokeResponseBuilder.GetInvokeResponses().GetInvokeResponse().EndOfInvokeResponseIB());
-    ReturnErrorOnFailure(mInvokeResponseBuilder.GetInvokeResponses().EndOfInvokeResponses());
-    ReturnErrorOnFailure(mInvokeResponseBuilder.EndOfInvokeResponseMessage());
+    mMessageHasResponses = true;
     MoveToState(State::AddedCommand);
     return CHIP_NO_ERROR;
 }
@@ -543,11 +707,14 @@ CHIP_ERROR CommandHandler::FinishCommand(bool aStartDataStruct)
 CHIP_ERROR CommandHandler::PrepareStatus(const ConcreteCommandPath & aCommandPath)
 {
     ReturnErrorOnFailure(AllocateBuffer());
+
+    mInvokeResponseBuilder.Checkpoint(mBackupWriter);
     //
-    // We must not be in the middle of preparing a command, or having prepared or sent one.
+    // We must not be in the middle of preparing a command, or having sent one.
     //
-    VerifyOrReturnError(mState == State::Idle, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(mState == State::Idle || mState == State::AddedCommand, CHIP_ERROR_INCORRECT_STATE);
     MoveToState(State::Preparing);
+    mResponseRef                                 = GetRefForRequestPath(aCommandPath);
     InvokeResponseIBs::Builder & invokeResponses = mInvokeResponseBuilder.GetInvokeResponses();
     InvokeResponseIB::Builder & invokeResponse   = invokeResponses.CreateInvokeResponse();
     ReturnErrorOnFailure(invokeResponses.GetError());
@@ -563,10 +730,14 @@ CHIP_ERROR CommandHandler::PrepareStatus(const ConcreteCommandPath & aCommandPat
 CHIP_ERROR CommandHandler::FinishStatus()
 {
     VerifyOrReturnError(mState == State::AddingCommand, CHIP_ERROR_INCORRECT_STATE);
-    ReturnErrorOnFailure(mInvokeResponseBuilder.GetInvokeResponses().GetInvokeResponse().GetStatus().EndOfCommandStatusIB());
+    CommandStatusIB::Builder & commandStatus = mInvokeResponseBuilder.GetInvokeResponses().GetInvokeResponse().GetStatus();
+    if (mResponseRef.HasValue())
+    {
+        ReturnErrorOnFailure(commandStatus.Ref(mResponseRef.Value()).GetError());
+    }
+    ReturnErrorOnFailure(commandStatus.EndOfCommandStatusIB());
     ReturnErrorOnFailure(mInvokeResponseBuilder.GetInvokeResponses().GetInvokeResponse().EndOfInvokeResponseIB());
-    ReturnErrorOnFailure(mInvokeResponseBuilder.GetInvokeResponses().EndOfInvokeResponses());
-    ReturnErrorOnFailure(mInvokeResponseBuilder.EndOfInvokeResponseMessage());
+    mMessageHasResponses = true;
     MoveToState(State::AddedCommand);
     return CHIP_NO_ERROR;
 }
@@ -575,12 +746,29 @@ CHIP_ERROR CommandHandler::RollbackResponse()
 {
     VerifyOrReturnError(mState == State::Preparing || mState == State::AddingCommand, CHIP_ERROR_INCORRECT_STATE);
     mInvokeResponseBuilder.Rollback(mBackupWriter);
-    // Note: We only support one command per request, so we reset the state to Idle here, need to review the states when adding
-    // supports of having multiple requests in the same transaction.
-    MoveToState(State::Idle);
+    mInvokeResponseBuilder.GetInvokeResponses().ResetError();
+    // Go back to whether responses were added before this one.
+    MoveToState((mMessageHasResponses || !mChunks.IsNull()) ? State::AddedCommand : State::Idle);
     return CHIP_NO_ERROR;
 }
 
+bool CommandHandler::RollbackResponseForRetry(CHIP_ERROR aError)
+{
+    // Nothing to roll back, nor to retry, if we failed before encoding anything.
+    VerifyOrReturnValue(RollbackResponse() == CHIP_NO_ERROR, false);
+    VerifyOrReturnValue(aError == CHIP_ERROR_NO_MEMORY || aError == CHIP_ERROR_BUFFER_TOO_SMALL, false);
+    // A response that does not fit in a message of its own does not fit in any.
+    VerifyOrReturnValue(mMessageHasResponses, false);
+
+    CHIP_ERROR err = StartNewMessage();
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(DataManagement, "Failed to start a new invoke response chunk: %" CHIP_ERROR_FORMAT, err.Format());
+        return false;
+    }
+    return true;
+}
+
 TLV::TLVWriter * CommandHandler::GetCommandDataIBTLVWriter()
 {
     if (mState != State::AddingCommand)
@@ -630,8 +818,35 @@ CommandHandler::Handle::Handle(CommandHandler * handle)
 
 CHIP_ERROR CommandHandler::Finalize(System::PacketBufferHandle & commandPacket)
 {
+    System::PacketBufferHandle packet;
     VerifyOrReturnError(mState == State::AddedCommand, CHIP_ERROR_INCORRECT_STATE);
-    return mCommandMessageWriter.Finalize(&commandPacket);
+    ReturnErrorOnFailure(FinalizeMessage(false /* aHasMoreChunks */, packet));
+    mChunks.AddToEnd(std::move(packet));
+    commandPacket = mChunks.PopHead();
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR CommandHandler::FinalizeMessage(bool aHasMoreChunks, System::PacketBufferHandle & commandPacket)
+{
+    VerifyOrReturnError(mBufferAllocated, CHIP_ERROR_INCORRECT_STATE);
+    ReturnErrorOnFailure(mCommandMessageWriter.UnreserveBuffer(kReservedSizeForTLVEncodingOverhead));
+    ReturnErrorOnFailure(mInvokeResponseBuilder.GetInvokeResponses().EndOfInvokeResponses());
+    if (aHasMoreChunks)
+    {
+        mInvokeResponseBuilder.MoreChunkedMessages(true);
+    }
+    ReturnErrorOnFailure(mInvokeResponseBuilder.EndOfInvokeResponseMessage());
+    ReturnErrorOnFailure(mCommandMessageWriter.Finalize(&commandPacket));
+    mBufferAllocated = false;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR CommandHandler::StartNewMessage()
+{
+    System::PacketBufferHandle packet;
+    ReturnErrorOnFailure(FinalizeMessage(true /* aHasMoreChunks */, packet));
+    mChunks.AddToEnd(std::move(packet));
+    return AllocateBuffer();
 }
 
 const char * CommandHandler::GetStateStr() const
@@ -651,6 +866,9 @@ const char * CommandHandler::GetStateStr() const
     case State::AddedCommand:
         return "AddedCommand";
 
+    case State::AwaitingResponse:
+        return "AwaitingResponse";
+
     case State::CommandSent:
         return "CommandSent";
 
@@ -26,6 +26,10 @@
  *      Allows adding the responses asynchronously.  See the documentation
  *      for the CommandHandler::Handle class below.
  *
+ *      Handles up to CHIP_CONFIG_MAX_PATHS_PER_INVOKE commands per request.
+ *      Responses that do not fit in a single message are sent in chunks,
+ *      each acknowledged by the requester before the next one goes out.
+ *
  */
 
 #pragma once
@@ -33,6 +37,7 @@
 #include <app/ConcreteCommandPath.h>
 #include <app/data-model/Encode.h>
 #include <lib/core/CHIPCore.h>
+#include <lib/core/Optional.h>
 #include <lib/core/TLV.h>
 #include <lib/core/TLVDebug.h>
 #include <lib/support/BitFlags.h>
@@ -190,7 +195,13 @@ public:
     CHIP_ERROR AddClusterSpecificFailure(const ConcreteCommandPath & aCommandPath, ClusterStatus aClusterStatus);
 
     Protocols::InteractionModel::Status ProcessInvokeRequest(System::PacketBufferHandle && payload, bool isTimedInvoke);
-    CHIP_ERROR PrepareCommand(const ConcreteCommandPath & aCommandPath, bool aStartDataStruct = true);
+
+    /**
+     * Starts encoding a response command.  In a batched request, the response is attributed to the requested command with the
+     * same path, or else to the only requested command on the same endpoint and cluster; it fails if there are several such
+     * commands, whose responses should go through AddResponseData.
+     */
+    CHIP_ERROR PrepareCommand(const ConcreteCommandPath & aResponseCommandPath, bool aStartDataStruct = true);
     CHIP_ERROR FinishCommand(bool aEndDataStruct = true);
     CHIP_ERROR PrepareStatus(const ConcreteCommandPath & aCommandPath);
     CHIP_ERROR FinishStatus();
@@ -219,11 +230,13 @@ public:
     {
         // TryAddResponseData will ensure we are in the correct state when calling AddResponseData.
         CHIP_ERROR err = TryAddResponseData(aRequestCommandPath, aData);
-        if (err != CHIP_NO_ERROR)
+        if (err != CHIP_NO_ERROR && RollbackResponseForRetry(err))
         {
-            // The state guarantees that either we can rollback or we don't have to rollback the buffer, so we don't care about the
-            // return value of RollbackResponse.
-            RollbackResponse();
+            err = TryAddResponseData(aRequestCommandPath, aData);
+            if (err != CHIP_NO_ERROR)
+            {
+                RollbackResponse();
+            }
         }
         return err;
     }
@@ -307,13 +320,7 @@ private:
     CHIP_ERROR OnMessageReceived(Messaging::ExchangeContext * ec, const PayloadHeader & payloadHeader,
                                  System::PacketBufferHandle && payload) override;
 
-    void OnResponseTimeout(Messaging::ExchangeContext * ec) override
-    {
-        //
-        // We're not expecting responses to any messages we send out on this EC.
-        //
-        VerifyOrDie(false);
-    }
+    void OnResponseTimeout(Messaging::ExchangeContext * ec) override;
 
     enum class State
     {
@@ -321,6 +328,7 @@ private:
         Preparing,           ///< We are prepaing the command or status header.
         AddingCommand,       ///< In the process of adding a command.
         AddedCommand,        ///< A command has been completely encoded and is awaiting transmission.
+        AwaitingResponse,    ///< Sent a chunk of the response and waiting for the status response acknowledging it.
         CommandSent,         ///< The command has been sent successfully.
         AwaitingDestruction, ///< The object has completed its work and is awaiting destruction by the application.
     };
@@ -333,6 +341,14 @@ private:
      */
     CHIP_ERROR RollbackResponse();
 
+    /**
+     * Rolls back the response that failed with aError.  If it failed for lack of room next to the responses already in the
+     * current message, moves those to a chunk of their own so that the response can be encoded again in a new message.
+     *
+     * @return Whether the response should be encoded again.
+     */
+    bool RollbackResponseForRetry(CHIP_ERROR aError);
+
     /*
      * This forcibly closes the exchange context if a valid one is pointed to. Such a situation does
      * not arise during normal message processing flows that all normally call Close() above. This can only
@@ -363,8 +379,19 @@ private:
      */
     CHIP_ERROR AllocateBuffer();
 
+    /*
+     * Ends the message being encoded and queues it behind the chunks already ended.  commandPacket gets the first message to
+     * send, the others are left in mChunks.
+     */
     CHIP_ERROR Finalize(System::PacketBufferHandle & commandPacket);
 
+    CHIP_ERROR FinalizeMessage(bool aHasMoreChunks, System::PacketBufferHandle & commandPacket);
+
+    /*
+     * Ends the message being encoded as a chunk, to be followed by more, and starts a new one.
+     */
+    CHIP_ERROR StartNewMessage();
+
     /**
      * Called internally to signal the completion of all work on this object, gracefully close the
      * exchange (by calling into the base class) and finally, signal to a registerd callback that it's
@@ -384,7 +411,19 @@ private:
      */
     Protocols::InteractionModel::Status ProcessGroupCommandDataIB(CommandDataIB::Parser & aCommandElement);
     CHIP_ERROR SendCommandResponse();
+    CHIP_ERROR SendInvokeResponse(System::PacketBufferHandle && commandPacket);
     CHIP_ERROR AddStatusInternal(const ConcreteCommandPath & aCommandPath, const StatusIB & aStatus);
+    CHIP_ERROR TryAddStatusInternal(const ConcreteCommandPath & aCommandPath, const StatusIB & aStatus);
+    CHIP_ERROR PrepareCommandWithRef(const ConcreteCommandPath & aResponseCommandPath, const Optional<uint16_t> & aRef,
+                                     bool aStartDataStruct);
+
+    /**
+     * Records the command references of the requested commands, checking that every command of a batch has one and that
+     * neither references nor paths repeat within the request.
+     */
+    CHIP_ERROR RecordRequestedCommands(TLV::TLVReader aInvokeRequestsReader, size_t aCommandCount);
+    Optional<uint16_t> GetRefForRequestPath(const ConcreteCommandPath & aRequestCommandPath) const;
+    CHIP_ERROR GetRefForResponsePath(const ConcreteCommandPath & aResponseCommandPath, Optional<uint16_t> & aRef) const;
 
     /**
      * If this function fails, it may leave our TLV buffer in an inconsistent state.  Callers should snapshot as needed before
@@ -398,7 +437,7 @@ private:
     CHIP_ERROR TryAddResponseData(const ConcreteCommandPath & aRequestCommandPath, const CommandData & aData)
     {
         ConcreteCommandPath path = { aRequestCommandPath.mEndpointId, aRequestCommandPath.mClusterId, CommandData::GetCommandId() };
-        ReturnErrorOnFailure(PrepareCommand(path, false));
+        ReturnErrorOnFailure(PrepareCommandWithRef(path, GetRefForRequestPath(aRequestCommandPath), false));
         TLV::TLVWriter * writer = GetCommandDataIBTLVWriter();
         VerifyOrReturnError(writer != nullptr, CHIP_ERROR_INCORRECT_STATE);
         ReturnErrorOnFailure(DataModel::Encode(*writer, TLV::ContextTag(CommandDataIB::Tag::kFields), aData));
@@ -406,6 +445,17 @@ private:
         return FinishCommand(/* aEndDataStruct = */ false);
     }
 
+    // End of InvokeResponses (end of container), more chunks flag (1 byte for the control tag, 1 byte for the context tag),
+    // InteractionModelRevision (1 byte for the control tag, 1 byte for the context tag, 1 byte for the value) and end of
+    // InvokeResponseMessage (another end of container).
+    static constexpr uint16_t kReservedSizeForTLVEncodingOverhead = 1 + (1 + 1) + (1 + 1 + 1) + 1;
+
+    struct RequestedCommand
+    {
+        ConcreteCommandPath mPath = ConcreteCommandPath(0, 0, 0);
+        Optional<uint16_t> mRef;
+    };
+
     Messaging::ExchangeHolder mExchangeCtx;
     Callback * mpCallback = nullptr;
     InvokeResponseMessage::Builder mInvokeResponseBuilder;
@@ -420,6 +470,16 @@ private:
     chip::System::PacketBufferTLVWriter mCommandMessageWriter;
     TLV::TLVWriter mBackupWriter;
     bool mBufferAllocated = false;
+    // Whether the message being encoded has a response in it yet.
+    bool mMessageHasResponses = false;
+    // Messages ended for lack of room, waiting to be sent in order.
+    System::PacketBufferHandle mChunks;
+
+    // The commands of the request, for the responses to echo their command reference.
+    RequestedCommand mRequestedCommands[CHIP_CONFIG_MAX_PATHS_PER_INVOKE];
+    size_t mRequestedCommandCount = 0;
+    // The command reference of the response being encoded, which goes after its fields or status.
+    Optional<uint16_t> mResponseRef;
     // If mGoneAsync is true, we have finished out initial processing of the
     // incoming invoke.  After this point, our session could go away at any
     // time.
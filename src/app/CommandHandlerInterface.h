@@ -175,6 +175,12 @@ public:
      */
     bool MatchesEndpoint(EndpointId aEndpointId) const { return mEndpointId.HasValue() && mEndpointId.Value() == aEndpointId; }
 
+    /**
+     * The endpoint this CommandHandlerInterface is for, or Missing if it is for all endpoints.
+     */
+    const Optional<EndpointId> & GetEndpointId() const { return mEndpointId; }
+    ClusterId GetClusterId() const { return mClusterId; }
+
     /**
      * Check whether another CommandHandlerInterface wants to handle the same set of
      * commands as we do.
@@ -25,6 +25,7 @@
 #include "CommandSender.h"
 #include "InteractionModelEngine.h"
 #include "StatusResponse.h"
+#include <app/InteractionModelHelper.h>
 #include <app/TimedRequest.h>
 #include <platform/LockTracker.h>
 #include <protocols/Protocols.h>
@@ -52,10 +53,7 @@ CHIP_ERROR CommandSender::AllocateBuffer()
     {
         mCommandMessageWriter.Reset();
 
-        System::PacketBufferHandle commandPacket = System::PacketBufferHandle::New(chip::app::kMaxSecureSduLengthBytes);
-        VerifyOrReturnError(!commandPacket.IsNull(), CHIP_ERROR_NO_MEMORY);
-
-        mCommandMessageWriter.Init(std::move(commandPacket));
+        ReturnErrorOnFailure(InitWriterWithSpaceReserved(mCommandMessageWriter, kReservedSizeForTLVEncodingOverhead));
         ReturnErrorOnFailure(mInvokeRequestBuilder.Init(&mCommandMessageWriter));
 
         mInvokeRequestBuilder.SuppressResponse(mSuppressResponse).TimedRequest(mTimedRequest);
@@ -70,6 +68,14 @@ CHIP_ERROR CommandSender::AllocateBuffer()
     return CHIP_NO_ERROR;
 }
 
+CHIP_ERROR CommandSender::SetRemoteMaxPathsPerInvoke(uint16_t aRemoteMaxPathsPerInvoke)
+{
+    VerifyOrReturnError(mState == State::Idle, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(aRemoteMaxPathsPerInvoke > 0, CHIP_ERROR_INVALID_ARGUMENT);
+    mRemoteMaxPathsPerInvoke = aRemoteMaxPathsPerInvoke;
+    return CHIP_NO_ERROR;
+}
+
 CHIP_ERROR CommandSender::SendCommandRequestInternal(const SessionHandle & session, Optional<System::Clock::Timeout> timeout)
 {
     VerifyOrReturnError(mState == State::AddedCommand, CHIP_ERROR_INCORRECT_STATE);
@@ -185,9 +191,16 @@ CHIP_ERROR CommandSender::OnMessageReceived(Messaging::ExchangeContext * apExcha
 
     if (aPayloadHeader.HasMessageType(MsgType::InvokeCommandResponse))
     {
-        err = ProcessInvokeResponse(std::move(aPayload));
+        bool moreChunkedMessages = false;
+        err                      = ProcessInvokeResponse(std::move(aPayload), moreChunkedMessages);
         SuccessOrExit(err);
         sendStatusResponse = false;
+        if (moreChunkedMessages)
+        {
+            // Acknowledge this chunk so that the server sends the next one.
+            SuccessOrExit(err = StatusResponse::Send(Status::Success, apExchangeContext, true /*aExpectResponse*/));
+            MoveToState(State::CommandSent);
+        }
     }
     else if (aPayloadHeader.HasMessageType(MsgType::StatusResponse))
     {
@@ -219,12 +232,12 @@ exit:
     {
         Close();
     }
-    // Else we got a response to a Timed Request and just sent the invoke.
+    // Else we got a response to a Timed Request and just sent the invoke, or the responses continue in another chunk.
 
     return err;
 }
 
-CHIP_ERROR CommandSender::ProcessInvokeResponse(System::PacketBufferHandle && payload)
+CHIP_ERROR CommandSender::ProcessInvokeResponse(System::PacketBufferHandle && payload, bool & moreChunkedMessages)
 {
     CHIP_ERROR err = CHIP_NO_ERROR;
     System::PacketBufferTLVReader reader;
@@ -242,6 +255,14 @@ CHIP_ERROR CommandSender::ProcessInvokeResponse(System::PacketBufferHandle && pa
 
     ReturnErrorOnFailure(invokeResponseMessage.GetSuppressResponse(&suppressResponse));
     ReturnErrorOnFailure(invokeResponseMessage.GetInvokeResponses(&invokeResponses));
+
+    err = invokeResponseMessage.GetMoreChunkedMessages(&moreChunkedMessages);
+    if (CHIP_END_OF_TLV == err)
+    {
+        moreChunkedMessages = false;
+        err                 = CHIP_NO_ERROR;
+    }
+    ReturnErrorOnFailure(err);
     invokeResponses.GetReader(&invokeResponsesReader);
 
     while (CHIP_NO_ERROR == (err = invokeResponsesReader.Next()))
@@ -294,9 +315,11 @@ CHIP_ERROR CommandSender::ProcessInvokeResponseIB(InvokeResponseIB::Parser & aIn
     EndpointId endpointId;
     // Default to success when an invoke response is received.
     StatusIB statusIB;
+    Optional<uint16_t> commandRef;
 
     {
         bool hasDataResponse = false;
+        uint16_t ref         = 0;
         TLV::TLVReader commandDataReader;
 
         CommandStatusIB::Parser commandStatus;
@@ -312,6 +335,8 @@ CHIP_ERROR CommandSender::ProcessInvokeResponseIB(InvokeResponseIB::Parser & aIn
             StatusIB::Parser status;
             commandStatus.GetErrorStatus(&status);
             ReturnErrorOnFailure(status.DecodeStatusIB(statusIB));
+
+            err = commandStatus.GetRef(&ref);
         }
         else if (CHIP_END_OF_TLV == err)
         {
@@ -323,8 +348,18 @@ CHIP_ERROR CommandSender::ProcessInvokeResponseIB(InvokeResponseIB::Parser & aIn
             ReturnErrorOnFailure(commandPath.GetClusterId(&clusterId));
             ReturnErrorOnFailure(commandPath.GetCommandId(&commandId));
             commandData.GetFields(&commandDataReader);
-            err             = CHIP_NO_ERROR;
             hasDataResponse = true;
+
+            err = commandData.GetRef(&ref);
+        }
+
+        if (CHIP_NO_ERROR == err)
+        {
+            commandRef.SetValue(ref);
+        }
+        else if (CHIP_END_OF_TLV == err)
+        {
+            err = CHIP_NO_ERROR;
         }
 
         if (err != CHIP_NO_ERROR)
@@ -351,7 +386,22 @@ CHIP_ERROR CommandSender::ProcessInvokeResponseIB(InvokeResponseIB::Parser & aIn
         }
         ReturnErrorOnFailure(err);
 
-        if (mpCallback != nullptr)
+        if (IsBatched())
+        {
+            // A response without a command reference can only answer the one command we sent.
+            if (!commandRef.HasValue() && mCommandCount == 1)
+            {
+                commandRef.SetValue(0);
+            }
+            VerifyOrReturnError(commandRef.HasValue() && commandRef.Value() < mCommandCount, CHIP_ERROR_INVALID_ARGUMENT);
+
+            if (mpCallback != nullptr)
+            {
+                mpCallback->OnCommandResponse(this, commandRef.Value(), ConcreteCommandPath(endpointId, clusterId, commandId),
+                                              statusIB, hasDataResponse ? &commandDataReader : nullptr);
+            }
+        }
+        else if (mpCallback != nullptr)
         {
             if (statusIB.IsSuccess())
             {
@@ -372,9 +422,11 @@ CHIP_ERROR CommandSender::PrepareCommand(const CommandPathParams & aCommandPathP
     ReturnErrorOnFailure(AllocateBuffer());
 
     //
-    // We must not be in the middle of preparing a command, or having prepared or sent one.
+    // We must not be in the middle of preparing a command, or having sent one, and there must be room for another command in
+    // the request.
     //
-    VerifyOrReturnError(mState == State::Idle, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(mState == State::Idle || mState == State::AddedCommand, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(mCommandCount < mRemoteMaxPathsPerInvoke, CHIP_ERROR_INCORRECT_STATE);
     InvokeRequests::Builder & invokeRequests = mInvokeRequestBuilder.GetInvokeRequests();
     CommandDataIB::Builder & invokeRequest   = invokeRequests.CreateCommandData();
     ReturnErrorOnFailure(invokeRequests.GetError());
@@ -405,9 +457,13 @@ CHIP_ERROR CommandSender::FinishCommand(bool aEndDataStruct)
         ReturnErrorOnFailure(commandData.GetWriter()->EndContainer(mDataElementContainerType));
     }
 
+    if (IsBatched())
+    {
+        ReturnErrorOnFailure(commandData.Ref(mCommandCount).GetError());
+    }
+
     ReturnErrorOnFailure(commandData.EndOfCommandDataIB());
-    ReturnErrorOnFailure(mInvokeRequestBuilder.GetInvokeRequests().EndOfInvokeRequests());
-    ReturnErrorOnFailure(mInvokeRequestBuilder.EndOfInvokeRequestMessage());
+    mCommandCount++;
 
     MoveToState(State::AddedCommand);
 
@@ -442,6 +498,9 @@ CHIP_ERROR CommandSender::FinishCommand(const Optional<uint16_t> & aTimedInvokeT
 CHIP_ERROR CommandSender::Finalize(System::PacketBufferHandle & commandPacket)
 {
     VerifyOrReturnError(mState == State::AddedCommand, CHIP_ERROR_INCORRECT_STATE);
+    ReturnErrorOnFailure(mCommandMessageWriter.UnreserveBuffer(kReservedSizeForTLVEncodingOverhead));
+    ReturnErrorOnFailure(mInvokeRequestBuilder.GetInvokeRequests().EndOfInvokeRequests());
+    ReturnErrorOnFailure(mInvokeRequestBuilder.EndOfInvokeRequestMessage());
     return mCommandMessageWriter.Finalize(&commandPacket);
 }
 
@@ -97,6 +97,33 @@ public:
          */
         virtual void OnError(const CommandSender * apCommandSender, CHIP_ERROR aError) {}
 
+        /**
+         * OnCommandResponse will be called, in place of OnResponse or OnError, for each response to a command of a batched
+         * invoke request, that is when more than one command may be sent at once (see SetRemoteMaxPathsPerInvoke).
+         *
+         * The default implementation forwards successful responses to OnResponse and failed ones to OnError, which is enough for
+         * callbacks that do not need to know which command a response answers.
+         *
+         * @param[in] apCommandSender The command sender object that initiated the command transaction.
+         * @param[in] aCommandRef     The reference of the command this response answers, which is the index of the command in
+         *                            the order the commands were added.
+         * @param[in] aPath           The command path field in invoke command response.
+         * @param[in] aStatusIB       The status of the command, which is always a generic SUCCESS if apData is not null.
+         * @param[in] apData          The command data, will be nullptr if the server returns a StatusIB.
+         */
+        virtual void OnCommandResponse(CommandSender * apCommandSender, uint16_t aCommandRef, const ConcreteCommandPath & aPath,
+                                       const StatusIB & aStatusIB, TLV::TLVReader * apData)
+        {
+            if (aStatusIB.IsSuccess())
+            {
+                OnResponse(apCommandSender, aPath, aStatusIB, apData);
+            }
+            else
+            {
+                OnError(apCommandSender, aStatusIB.ToChipError());
+            }
+        }
+
         /**
          * OnDone will be called when CommandSender has finished all work and is safe to destroy and free the
          * allocated CommandSender object.
@@ -124,6 +151,21 @@ public:
     CommandSender(Callback * apCallback, Messaging::ExchangeManager * apExchangeMgr, bool aIsTimedRequest = false,
                   bool aSuppressResponse = false);
     ~CommandSender();
+
+    /**
+     * Lets this CommandSender put up to aRemoteMaxPathsPerInvoke commands in its invoke request, as many as the receiver takes
+     * in one, and have the responses correlated to the commands by their command reference. Without a call to this, a single
+     * command may be added.
+     *
+     * This must be called before the first command is added.
+     */
+    CHIP_ERROR SetRemoteMaxPathsPerInvoke(uint16_t aRemoteMaxPathsPerInvoke);
+
+    /**
+     * The number of commands added so far. The reference of the next command to add is this count.
+     */
+    uint16_t GetCommandCount() const { return mCommandCount; }
+
     CHIP_ERROR PrepareCommand(const CommandPathParams & aCommandPathParams, bool aStartDataStruct = true);
     CHIP_ERROR FinishCommand(bool aEndDataStruct = true);
     TLV::TLVWriter * GetCommandDataIBTLVWriter();
@@ -265,9 +307,15 @@ private:
      */
     void Abort();
 
-    CHIP_ERROR ProcessInvokeResponse(System::PacketBufferHandle && payload);
+    // End of InvokeRequests and of InvokeRequestMessage (end of containers) and InteractionModelRevision (1 byte for the control
+    // tag, 1 byte for the context tag, 1 byte for the value), which the request always has room left for.
+    static constexpr uint16_t kReservedSizeForTLVEncodingOverhead = 1 + 1 + (1 + 1 + 1);
+
+    CHIP_ERROR ProcessInvokeResponse(System::PacketBufferHandle && payload, bool & moreChunkedMessages);
     CHIP_ERROR ProcessInvokeResponseIB(InvokeResponseIB::Parser & aInvokeResponse);
 
+    bool IsBatched() const { return mRemoteMaxPathsPerInvoke > 1; }
+
     // Send our queued-up Invoke Request message.  Assumes the exchange is ready
     // and mPendingInvokeData is populated.
     CHIP_ERROR SendInvokeRequest();
@@ -290,6 +338,8 @@ private:
     TLV::TLVType mDataElementContainerType = TLV::kTLVType_NotSpecified;
     bool mSuppressResponse                 = false;
     bool mTimedRequest                     = false;
+    uint16_t mRemoteMaxPathsPerInvoke      = 1;
+    uint16_t mCommandCount                 = 0;
 
     State mState = State::Idle;
     chip::System::PacketBufferTLVWriter mCommandMessageWriter;
@@ -66,6 +66,7 @@ struct ReclaimEventCtx
 {
     CircularEventBuffer * mpEventBuffer = nullptr;
     size_t mSpaceNeededForMovedEvent    = 0;
+    EventNumber mMovedEventNumber       = 0;
 };
 
 /**
@@ -126,7 +127,7 @@ void EventManagement::Init(Messaging::ExchangeManager * apExchangeManager, uint3
     mMonotonicStartupTime = aMonotonicStartupTime;
 }
 
-CHIP_ERROR EventManagement::CopyToNextBuffer(CircularEventBuffer * apEventBuffer)
+CHIP_ERROR EventManagement::CopyToNextBuffer(CircularEventBuffer * apEventBuffer, EventNumber aEventNumber)
 {
     CircularTLVWriter writer;
     CircularTLVReader reader;
@@ -155,6 +156,8 @@ CHIP_ERROR EventManagement::CopyToNextBuffer(CircularEventBuffer * apEventBuffer
     err = writer.Finalize();
     SuccessOrExit(err);
 
+    nextBuffer->OnEventAppended(aEventNumber, writer.GetLengthWritten());
+
     ChipLogDetail(EventLogging, "Copy Event to next buffer with priority %u", static_cast<unsigned>(nextBuffer->GetPriority()));
 exit:
     if (err != CHIP_NO_ERROR)
@@ -217,7 +220,7 @@ CHIP_ERROR EventManagement::EnsureSpaceInCircularBuffer(size_t aRequiredSpace, P
                     // Since we're calling CopyElement and we've checked
                     // that there is space in the next buffer, we don't expect
                     // this to fail.
-                    err = CopyToNextBuffer(eventBuffer);
+                    err = CopyToNextBuffer(eventBuffer, ctx.mMovedEventNumber);
                     SuccessOrExit(err);
                     // success; evict head unconditionally
                     eventBuffer->mProcessEvictedElement = nullptr;
@@ -468,6 +471,7 @@ CHIP_ERROR EventManagement::LogEventPrivate(EventLoggingDelegate * apDelegate, c
     SuccessOrExit(err);
 
     mBytesWritten += writer.GetLengthWritten();
+    mpEventBuffer->OnEventAppended(ctxt.mCurrentEventNumber, writer.GetLengthWritten());
 
 exit:
     if (err != CHIP_NO_ERROR)
@@ -651,16 +655,17 @@ CHIP_ERROR EventManagement::FetchEventsSince(TLVWriter & aWriter, const ObjectLi
 
     context.mSubjectDescriptor     = aSubjectDescriptor;
     context.mpInterestedEventPaths = apEventPathList;
-    err                            = GetEventReader(reader, PriorityLevel::Critical, &bufWrapper);
+    err                            = GetEventReaderSince(reader, aEventMin, &bufWrapper, context.mCurrentEventNumber);
     SuccessOrExit(err);
 
     err = TLV::Utilities::Iterate(reader, CopyEventsSince, &context, recurse);
+
+exit:
     if (err == CHIP_END_OF_TLV)
     {
         err = CHIP_NO_ERROR;
     }
 
-exit:
     if (err == CHIP_ERROR_BUFFER_TOO_SMALL || err == CHIP_ERROR_NO_MEMORY)
     {
         // We failed to fetch the current event because the buffer is too small, we will start from this one the next time.
@@ -747,6 +752,34 @@ CHIP_ERROR EventManagement::GetEventReader(TLVReader & aReader, PriorityLevel aP
     return CHIP_NO_ERROR;
 }
 
+CHIP_ERROR EventManagement::GetEventReaderSince(TLVReader & aReader, EventNumber aEventMin,
+                                                CircularEventBufferWrapper * apBufWrapper, EventNumber & aLastSkippedEventNumber)
+{
+    // Events only move from a buffer to the next, more important one when they are the oldest of their buffer, so each buffer
+    // holds its events in increasing event number order and older events than the buffers before it. Reading starts in the
+    // most important buffer that holds events numbered aEventMin or more.
+    CircularEventBuffer * buffer = GetPriorityBuffer(PriorityLevel::Critical);
+    uint32_t offset              = 0;
+    while (buffer != nullptr && !buffer->FindReadOffset(aEventMin, offset))
+    {
+        if (buffer->DataLength() > 0)
+        {
+            aLastSkippedEventNumber = buffer->GetLastEventNumber();
+        }
+        buffer = buffer->GetPreviousCircularEventBuffer();
+    }
+    VerifyOrReturnError(buffer != nullptr, CHIP_END_OF_TLV);
+
+    apBufWrapper->mpCurrent    = buffer;
+    apBufWrapper->mStartOffset = offset;
+
+    CircularEventReader reader;
+    reader.Init(apBufWrapper);
+    aReader.Init(reader);
+
+    return CHIP_NO_ERROR;
+}
+
 CHIP_ERROR EventManagement::FetchEventParameters(const TLVReader & aReader, size_t, void * apContext)
 {
     EventEnvelopeContext * const envelope = static_cast<EventEnvelopeContext *>(apContext);
@@ -840,6 +873,7 @@ CHIP_ERROR EventManagement::EvictEvent(TLVCircularBuffer & apBuffer, void * apAp
 
     // event is not getting dropped. Note how much space it requires, and return.
     ctx->mSpaceNeededForMovedEvent = aReader.GetLengthRead();
+    ctx->mMovedEventNumber         = context.mEventNumber;
     return CHIP_END_OF_TLV;
 }
 
@@ -856,6 +890,53 @@ void CircularEventBuffer::Init(uint8_t * apBuffer, uint32_t aBufferLength, Circu
     mpPrev    = apPrev;
     mpNext    = apNext;
     mPriority = aPriorityLevel;
+
+    mCheckpointCount = 0;
+    mNextCheckpoint  = 0;
+    mAppendedLength  = 0;
+    mLastEventNumber = 0;
+}
+
+void CircularEventBuffer::OnEventAppended(EventNumber aEventNumber, uint32_t aLength)
+{
+    const uint32_t position = mAppendedLength;
+    mAppendedLength += aLength;
+    mLastEventNumber = aEventNumber;
+
+    // Spread the checkpoints evenly over the buffer, so that they cover all of it.
+    if (mCheckpointCount > 0)
+    {
+        const Checkpoint & newest = mCheckpoints[(mNextCheckpoint + kMaxCheckpoints - 1) % kMaxCheckpoints];
+        VerifyOrReturn(position - newest.mPosition >= GetTotalDataLength() / kMaxCheckpoints);
+    }
+
+    mCheckpoints[mNextCheckpoint] = { aEventNumber, position };
+    mNextCheckpoint               = (mNextCheckpoint + 1) % kMaxCheckpoints;
+    if (mCheckpointCount < kMaxCheckpoints)
+    {
+        mCheckpointCount++;
+    }
+}
+
+bool CircularEventBuffer::FindReadOffset(EventNumber aEventMin, uint32_t & aOffset) const
+{
+    VerifyOrReturnValue(DataLength() > 0 && mLastEventNumber >= aEventMin, false);
+
+    // Start from the newest checkpoint at or before aEventMin, or from the head if there is none left.
+    aOffset = 0;
+    for (size_t i = 1; i <= mCheckpointCount; i++)
+    {
+        const Checkpoint & checkpoint = mCheckpoints[(mNextCheckpoint + kMaxCheckpoints - i) % kMaxCheckpoints];
+        const uint32_t offset         = checkpoint.mPosition - HeadPosition();
+        // The event of this checkpoint was evicted, and so were the ones of the older checkpoints.
+        VerifyOrReturnValue(offset < DataLength(), true);
+        if (checkpoint.mEventNumber <= aEventMin)
+        {
+            aOffset = offset;
+            break;
+        }
+    }
+    return true;
 }
 
 bool CircularEventBuffer::IsFinalDestinationForPriority(PriorityLevel aPriority) const
@@ -881,8 +962,10 @@ void CircularEventReader::Init(CircularEventBufferWrapper * apBufWrapper)
     if (apBufWrapper->mpCurrent == nullptr)
         return;
 
-    TLVReader::Init(*apBufWrapper, apBufWrapper->mpCurrent->DataLength());
-    mMaxLen = apBufWrapper->mpCurrent->DataLength();
+    // Reading the current buffer starts mStartOffset bytes past its head.
+    const uint32_t skippedLength = apBufWrapper->mStartOffset;
+    TLVReader::Init(*apBufWrapper, apBufWrapper->mpCurrent->DataLength() - skippedLength);
+    mMaxLen = apBufWrapper->mpCurrent->DataLength() - skippedLength;
     for (prev = apBufWrapper->mpCurrent->GetPreviousCircularEventBuffer(); prev != nullptr;
          prev = prev->GetPreviousCircularEventBuffer())
     {
@@ -895,6 +978,19 @@ void CircularEventReader::Init(CircularEventBufferWrapper * apBufWrapper)
 CHIP_ERROR CircularEventBufferWrapper::GetNextBuffer(TLVReader & aReader, const uint8_t *& aBufStart, uint32_t & aBufLen)
 {
     CHIP_ERROR err = CHIP_NO_ERROR;
+    if ((aBufStart == nullptr) && (mStartOffset != 0))
+    {
+        // Start reading the current buffer past its head, up to its tail or the end of its storage, whichever comes first;
+        // TLVCircularBuffer::GetNextBuffer takes over from there.
+        const uint32_t headIndex = static_cast<uint32_t>(mpCurrent->QueueHead() - mpCurrent->GetQueue());
+        aBufStart                = mpCurrent->GetQueue() + (headIndex + mStartOffset) % mpCurrent->GetTotalDataLength();
+        const uint8_t * tail     = mpCurrent->QueueTail();
+        aBufLen                  = static_cast<uint32_t>(
+            (tail > aBufStart) ? (tail - aBufStart) : (mpCurrent->GetQueue() + mpCurrent->GetTotalDataLength() - aBufStart));
+        mStartOffset = 0;
+        return CHIP_NO_ERROR;
+    }
+
     mpCurrent->GetNextBuffer(aReader, aBufStart, aBufLen);
     SuccessOrExit(err);
 
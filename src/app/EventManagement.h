@@ -128,9 +128,46 @@ public:
     void SetRequiredSpaceforEvicted(size_t aRequiredSpace) { mRequiredSpaceForEvicted = aRequiredSpace; }
     size_t GetRequiredSpaceforEvicted() const { return mRequiredSpaceForEvicted; }
 
+    /**
+     * @brief
+     *   Record that the event numbered aEventNumber, aLength bytes long, was appended to the buffer.
+     */
+    void OnEventAppended(EventNumber aEventNumber, uint32_t aLength);
+
+    /**
+     * @brief
+     *   Find where to start reading the buffer to get all its events numbered aEventMin or more, relying on the events of
+     *   the buffer being stored in increasing event number order.
+     *
+     * @param[in]  aEventMin  The smallest event number of interest.
+     *
+     * @param[out] aOffset    The offset from the head of the buffer of an event numbered aEventMin or less, if any, such
+     *                        that no event in between is numbered aEventMin or more.
+     *
+     * @retval false if the buffer holds no event numbered aEventMin or more.
+     */
+    bool FindReadOffset(EventNumber aEventMin, uint32_t & aOffset) const;
+
+    /**
+     * @brief
+     *   The number of the last event appended to the buffer, only meaningful while the buffer is not empty.
+     */
+    EventNumber GetLastEventNumber() const { return mLastEventNumber; }
+
     ~CircularEventBuffer() override = default;
 
 private:
+    struct Checkpoint
+    {
+        EventNumber mEventNumber;
+        uint32_t mPosition; ///< Number of bytes appended to the buffer before the event, modulo 2^32
+    };
+
+    static constexpr size_t kMaxCheckpoints = CHIP_CONFIG_EVENT_LOGGING_CHECKPOINTS;
+    static_assert(kMaxCheckpoints > 0, "CHIP_CONFIG_EVENT_LOGGING_CHECKPOINTS must be at least 1");
+
+    uint32_t HeadPosition() const { return mAppendedLength - DataLength(); }
+
     CircularEventBuffer * mpPrev = nullptr; ///< A pointer CircularEventBuffer storing events less important events
     CircularEventBuffer * mpNext = nullptr; ///< A pointer CircularEventBuffer storing events more important events
 
@@ -139,6 +176,12 @@ private:
 
     size_t mRequiredSpaceForEvicted = 0; ///< Required space for previous buffer to evict event to new buffer
 
+    Checkpoint mCheckpoints[kMaxCheckpoints]; ///< Ring of checkpoints, in increasing position order
+    size_t mCheckpointCount      = 0;
+    size_t mNextCheckpoint       = 0; ///< Ring index the next checkpoint goes to
+    uint32_t mAppendedLength     = 0; ///< Number of bytes ever appended to the buffer, modulo 2^32
+    EventNumber mLastEventNumber = 0;
+
     CHIP_ERROR OnInit(TLV::TLVWriter & writer, uint8_t *& bufStart, uint32_t & bufLen) override;
 };
 
@@ -155,6 +198,7 @@ class CircularEventBufferWrapper : public TLV::TLVCircularBuffer
 public:
     CircularEventBufferWrapper() : TLVCircularBuffer(nullptr, 0), mpCurrent(nullptr){};
     CircularEventBuffer * mpCurrent;
+    uint32_t mStartOffset = 0; ///< Offset from the head of mpCurrent at which reading starts
 
 private:
     CHIP_ERROR GetNextBuffer(chip::TLV::TLVReader & aReader, const uint8_t *& aBufStart, uint32_t & aBufLen) override;
@@ -436,9 +480,10 @@ private:
      * @brief copy the event outright to next buffer with higher priority
      *
      * @param[in] apEventBuffer  CircularEventBuffer
+     * @param[in] aEventNumber   The number of the event at the head of apEventBuffer
      *
      */
-    CHIP_ERROR CopyToNextBuffer(CircularEventBuffer * apEventBuffer);
+    CHIP_ERROR CopyToNextBuffer(CircularEventBuffer * apEventBuffer, EventNumber aEventNumber);
 
     /**
      * @brief Ensure that:
@@ -466,6 +511,23 @@ private:
      */
     static CHIP_ERROR FabricRemovedCB(const TLV::TLVReader & aReader, size_t, void * apFabricIndex);
 
+    /**
+     * @brief
+     *   Internal API used to implement #FetchEventsSince
+     *
+     * Get a reader like GetEventReader does for PriorityLevel::Critical,
+     * except that it starts near the oldest event numbered aEventMin or more,
+     * skipping the older events without decoding them.
+     *
+     * @param[out] aLastSkippedEventNumber  The number of the last event in
+     *                                      the buffers skipped as a whole,
+     *                                      left unchanged if there is none.
+     *
+     * @retval #CHIP_END_OF_TLV  There is no event numbered aEventMin or more.
+     */
+    CHIP_ERROR GetEventReaderSince(TLV::TLVReader & aReader, EventNumber aEventMin, CircularEventBufferWrapper * apBufWrapper,
+                                   EventNumber & aLastSkippedEventNumber);
+
     /**
      * @brief
      *   Internal API used to implement #FetchEventsSince
@@ -81,20 +81,10 @@ void InteractionModelEngine::Shutdown()
 {
     mpExchangeMgr->GetSessionManager()->SystemLayer()->CancelTimer(ResumeSubscriptionsTimerCallback, this);
 
-    CommandHandlerInterface * handlerIter = mCommandHandlerList;
-
     //
-    // Walk our list of command handlers and de-register them, before finally
-    // nulling out the list entirely.
+    // De-register all our command handlers.
     //
-    while (handlerIter)
-    {
-        CommandHandlerInterface * nextHandler = handlerIter->GetNext();
-        handlerIter->SetNext(nullptr);
-        handlerIter = nextHandler;
-    }
-
-    mCommandHandlerList = nullptr;
+    mCommandHandlers.Clear();
 
     // Increase magic number to invalidate all Handle-s.
     mMagic++;
@@ -1576,87 +1566,38 @@ CHIP_ERROR InteractionModelEngine::RegisterCommandHandler(CommandHandlerInterfac
 {
     VerifyOrReturnError(handler != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
 
-    for (auto * cur = mCommandHandlerList; cur; cur = cur->GetNext())
+    if (!mCommandHandlers.Register(*handler))
     {
-        if (cur->Matches(*handler))
-        {
-            ChipLogError(InteractionModel, "Duplicate command handler registration failed");
-            return CHIP_ERROR_INCORRECT_STATE;
-        }
+        ChipLogError(InteractionModel, "Duplicate command handler registration failed");
+        return CHIP_ERROR_INCORRECT_STATE;
     }
 
-    handler->SetNext(mCommandHandlerList);
-    mCommandHandlerList = handler;
-
     return CHIP_NO_ERROR;
 }
 
 void InteractionModelEngine::UnregisterCommandHandlers(EndpointId endpointId)
 {
-    CommandHandlerInterface * prev = nullptr;
-
-    for (auto * cur = mCommandHandlerList; cur; cur = cur->GetNext())
-    {
-        if (cur->MatchesEndpoint(endpointId))
-        {
-            if (prev == nullptr)
-            {
-                mCommandHandlerList = cur->GetNext();
-            }
-            else
-            {
-                prev->SetNext(cur->GetNext());
-            }
-
-            cur->SetNext(nullptr);
-        }
-        else
-        {
-            prev = cur;
-        }
-    }
+    mCommandHandlers.UnregisterMatching([endpointId](CommandHandlerInterface * cur) { return cur->MatchesEndpoint(endpointId); });
 }
 
 CHIP_ERROR InteractionModelEngine::UnregisterCommandHandler(CommandHandlerInterface * handler)
 {
     VerifyOrReturnError(handler != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
-    CommandHandlerInterface * prev = nullptr;
 
-    for (auto * cur = mCommandHandlerList; cur; cur = cur->GetNext())
-    {
-        if (cur->Matches(*handler))
-        {
-            if (prev == nullptr)
-            {
-                mCommandHandlerList = cur->GetNext();
-            }
-            else
-            {
-                prev->SetNext(cur->GetNext());
-            }
-
-            cur->SetNext(nullptr);
-
-            return CHIP_NO_ERROR;
-        }
-
-        prev = cur;
-    }
+    // Only unregister the first handler that overlaps with the given one.
+    bool found = false;
+    mCommandHandlers.UnregisterMatching([handler, &found](CommandHandlerInterface * cur) {
+        VerifyOrReturnValue(!found && cur->Matches(*handler), false);
+        found = true;
+        return true;
+    });
 
-    return CHIP_ERROR_KEY_NOT_FOUND;
+    return found ? CHIP_NO_ERROR : CHIP_ERROR_KEY_NOT_FOUND;
 }
 
 CommandHandlerInterface * InteractionModelEngine::FindCommandHandler(EndpointId endpointId, ClusterId clusterId)
 {
-    for (auto * cur = mCommandHandlerList; cur; cur = cur->GetNext())
-    {
-        if (cur->Matches(endpointId, clusterId))
-        {
-            return cur;
-        }
-    }
-
-    return nullptr;
+    return mCommandHandlers.Find(endpointId, clusterId);
 }
 
 void InteractionModelEngine::OnTimedInteractionFailed(TimedHandler * apTimedHandler)
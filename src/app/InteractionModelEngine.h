@@ -42,6 +42,7 @@
 #include <system/SystemPacketBuffer.h>
 
 #include <app/AttributePathParams.h>
+#include <app/ClusterInterfaceRegistry.h>
 #include <app/CommandHandler.h>
 #include <app/CommandHandlerInterface.h>
 #include <app/CommandSender.h>
@@ -570,7 +571,7 @@ private:
 
     Messaging::ExchangeManager * mpExchangeMgr = nullptr;
 
-    CommandHandlerInterface * mCommandHandlerList = nullptr;
+    ClusterInterfaceRegistry<CommandHandlerInterface> mCommandHandlers;
 
     ObjectPool<CommandHandler, CHIP_IM_MAX_NUM_COMMAND_HANDLER> mCommandHandlerObjs;
     ObjectPool<TimedHandler, CHIP_IM_MAX_NUM_TIMED_HANDLER> mTimedHandlers;
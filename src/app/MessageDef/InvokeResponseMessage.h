@@ -33,8 +33,9 @@ namespace app {
 namespace InvokeResponseMessage {
 enum class Tag : uint8_t
 {
-    kSuppressResponse = 0,
-    kInvokeResponses  = 1,
+    kSuppressResponse    = 0,
+    kInvokeResponses     = 1,
+    kMoreChunkedMessages = 2,
 };
 
 class Parser : public MessageParser
@@ -61,6 +62,16 @@ public:
      *          #CHIP_END_OF_TLV if there is no such element
      */
     CHIP_ERROR GetInvokeResponses(InvokeResponseIBs::Parser * const apInvokeResponses) const;
+
+    /**
+     *  @brief Check whether the responses continue in further messages. Next() must be called before accessing them.
+     *
+     *  @param [in] apMoreChunkedMessages   A pointer to apMoreChunkedMessages
+     *
+     *  @return #CHIP_NO_ERROR on success
+     *          #CHIP_END_OF_TLV if there is no such element
+     */
+    CHIP_ERROR GetMoreChunkedMessages(bool * const apMoreChunkedMessages) const;
 };
 
 class Builder : public MessageBuilder
@@ -86,6 +97,13 @@ public:
      */
     InvokeResponseIBs::Builder & GetInvokeResponses() { return mInvokeResponses; }
 
+    /**
+     *  @brief This flag is set to 'true' when the responses continue in further messages.
+     *  @param [in] aMoreChunkedMessages The boolean variable to indicate if there are more chunked messages in a transaction.
+     *  @return A reference to *this
+     */
+    InvokeResponseMessage::Builder & MoreChunkedMessages(const bool aMoreChunkedMessages);
+
     /**
      *  @brief Mark the end of this InvokeResponseMessage
      *
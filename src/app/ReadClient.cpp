@@ -516,6 +516,7 @@ CHIP_ERROR ReadClient::ProcessReportData(System::PacketBufferHandle && aPayload,
     EventReportIBs::Parser eventReportIBs;
     AttributeReportIBs::Parser attributeReportIBs;
     System::PacketBufferTLVReader reader;
+    mpCallback.OnReportBuffer(aPayload);
     reader.Init(std::move(aPayload));
     err = report.Init(reader);
     SuccessOrExit(err);
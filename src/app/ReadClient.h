@@ -103,6 +103,18 @@ public:
          */
         virtual void OnReportEnd() {}
 
+        /**
+         * Used to provide the buffer of each ReportData message received, ahead of the attribute and event data it carries.
+         *
+         * The readers passed to OnAttributeData and OnEventData for that data read from this buffer, unless an adapter
+         * such as BufferedReadCallback rebuilt the data elsewhere. A callback can Retain() the buffer to keep referring to
+         * that data in place after those calls, instead of copying it out. This holds on to the whole message buffer,
+         * which is best avoided on platforms with a small pool of packet buffers.
+         *
+         * @param[in] aBuffer The buffer of the ReportData message about to be processed.
+         */
+        virtual void OnReportBuffer(const System::PacketBufferHandle & aBuffer) {}
+
         /**
          * Used to deliver event data received through the Read and Subscribe interactions
          *
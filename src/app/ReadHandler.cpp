@@ -125,6 +125,12 @@ void ReadHandler::ResumeSubscription(CASESessionManager & caseSessionManager,
         }
     }
 
+    if (InteractionModelEngine::GetInstance()->GetReportingEngine().AddReadHandlerPaths(*this) != CHIP_NO_ERROR)
+    {
+        Close();
+        return;
+    }
+
     // Ask IM engine to start CASE session with subscriber
     ScopedNodeId peerNode = ScopedNodeId(subscriptionInfo.mNodeId, subscriptionInfo.mFabricIndex);
     caseSessionManager.FindOrEstablishSession(peerNode, &mOnConnectedCallback, &mOnConnectionFailureCallback);
@@ -146,6 +152,7 @@ ReadHandler::~ReadHandler()
     {
         InteractionModelEngine::GetInstance()->GetReportingEngine().OnReportConfirm();
     }
+    InteractionModelEngine::GetInstance()->GetReportingEngine().RemoveReadHandlerPaths(*this);
     InteractionModelEngine::GetInstance()->ReleaseAttributePathList(mpAttributePathList);
     InteractionModelEngine::GetInstance()->ReleaseEventPathList(mpEventPathList);
     InteractionModelEngine::GetInstance()->ReleaseDataVersionFilterList(mpDataVersionFilterList);
@@ -484,7 +491,7 @@ CHIP_ERROR ReadHandler::ProcessAttributePaths(AttributePathIBs::Parser & aAttrib
     {
         InteractionModelEngine::GetInstance()->RemoveDuplicateConcreteAttributePath(mpAttributePathList);
         mAttributePathExpandIterator = AttributePathExpandIterator(mpAttributePathList);
-        err                          = CHIP_NO_ERROR;
+        err                          = InteractionModelEngine::GetInstance()->GetReportingEngine().AddReadHandlerPaths(*this);
     }
     return err;
 }
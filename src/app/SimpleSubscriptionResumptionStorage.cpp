@@ -315,6 +315,9 @@ CHIP_ERROR SimpleSubscriptionResumptionStorage::Save(TLV::TLVWriter & writer, Su
 
 CHIP_ERROR SimpleSubscriptionResumptionStorage::Save(SubscriptionInfo & subscriptionInfo)
 {
+    // The removal of a duplicate and the new record are written together.
+    PersistentStorageBatch batch(mStorage);
+
     // Find empty index or duplicate if exists
     uint16_t subscriptionIndex;
     uint16_t firstEmptySubscriptionIndex = CHIP_IM_MAX_NUM_SUBSCRIPTIONS; // initialize to out of bounds as "not set"
@@ -370,11 +373,13 @@ CHIP_ERROR SimpleSubscriptionResumptionStorage::Save(SubscriptionInfo & subscrip
         mStorage->SyncSetKeyValue(DefaultStorageKeyAllocator::SubscriptionResumption(firstEmptySubscriptionIndex).KeyName(),
                                   backingBuffer.Get(), static_cast<uint16_t>(len)));
 
-    return CHIP_NO_ERROR;
+    return batch.Commit();
 }
 
 CHIP_ERROR SimpleSubscriptionResumptionStorage::Delete(NodeId nodeId, FabricIndex fabricIndex, SubscriptionId subscriptionId)
 {
+    PersistentStorageBatch batch(mStorage);
+
     bool subscriptionFound   = false;
     CHIP_ERROR lastDeleteErr = CHIP_NO_ERROR;
 
@@ -410,10 +415,13 @@ CHIP_ERROR SimpleSubscriptionResumptionStorage::Delete(NodeId nodeId, FabricInde
         DeleteMaxCount();
     }
 
+    // Deletion is best effort: what could be deleted stays deleted on error.
+    CHIP_ERROR commitErr = batch.Commit();
     if (lastDeleteErr != CHIP_NO_ERROR)
     {
         return lastDeleteErr;
     }
+    ReturnErrorOnFailure(commitErr);
 
     return subscriptionFound ? CHIP_NO_ERROR : CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND;
 }
@@ -425,6 +433,8 @@ CHIP_ERROR SimpleSubscriptionResumptionStorage::DeleteMaxCount()
 
 CHIP_ERROR SimpleSubscriptionResumptionStorage::DeleteAll(FabricIndex fabricIndex)
 {
+    PersistentStorageBatch batch(mStorage);
+
     CHIP_ERROR deleteErr = CHIP_NO_ERROR;
 
     uint16_t count = 0;
@@ -461,7 +471,8 @@ CHIP_ERROR SimpleSubscriptionResumptionStorage::DeleteAll(FabricIndex fabricInde
         }
     }
 
-    return deleteErr;
+    CHIP_ERROR commitErr = batch.Commit();
+    return (deleteErr != CHIP_NO_ERROR) ? deleteErr : commitErr;
 }
 
 } // namespace app
@@ -0,0 +1,362 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app/reporting/DirtyPathIndex.h>
+
+#include <lib/support/IdHash.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+#include <algorithm>
+
+namespace chip {
+namespace app {
+namespace reporting {
+
+size_t DirtyPathIndex::BucketOf(EndpointId aEndpointId, ClusterId aClusterId)
+{
+    return BucketOfIdPair<kBucketCount>(aClusterId, aEndpointId);
+}
+
+size_t DirtyPathIndex::BucketOf(const ClusterEntry * aEntry, AttributeId aAttributeId)
+{
+    uint32_t hash = static_cast<uint32_t>(BucketOf(aEntry->mEndpointId, aEntry->mClusterId)) ^ (aAttributeId * 0xC2B2AE35u);
+    hash ^= hash >> 15;
+    return hash & (kBucketCount - 1);
+}
+
+DirtyPathIndex::ClusterEntry * DirtyPathIndex::Find(EndpointId aEndpointId, ClusterId aClusterId) const
+{
+    for (ClusterEntry * entry = mBuckets[BucketOf(aEndpointId, aClusterId)]; entry != nullptr; entry = entry->mNextInBucket)
+    {
+        if (entry->mEndpointId == aEndpointId && entry->mClusterId == aClusterId)
+        {
+            return entry;
+        }
+    }
+    return nullptr;
+}
+
+DirtyPathIndex::ClusterEntry * DirtyPathIndex::FindOrCreate(EndpointId aEndpointId, ClusterId aClusterId, uint64_t aGeneration)
+{
+    ClusterEntry * entry = Find(aEndpointId, aClusterId);
+    VerifyOrReturnValue(entry == nullptr, entry);
+
+    entry = mEntries.CreateObject(aEndpointId, aClusterId);
+    if (entry == nullptr)
+    {
+        // The pool is statically allocated and full. Coarsen the set: first by making the new path's endpoint dirty as a whole,
+        // which absorbs the new path, then by merging the endpoint with the most entries to make room.
+        if (MergeEndpoint(aEndpointId, aGeneration))
+        {
+            return nullptr;
+        }
+        if (MergeLargestEndpoint())
+        {
+            entry = mEntries.CreateObject(aEndpointId, aClusterId);
+        }
+        if (entry == nullptr)
+        {
+            ChipLogDetail(DataManagement, "Dirty set pool exhausted, mark all paths dirty.");
+            MarkAllDirty(aGeneration);
+            return nullptr;
+        }
+    }
+
+    ClusterEntry *& bucket = mBuckets[BucketOf(aEndpointId, aClusterId)];
+    entry->mNextInBucket   = bucket;
+    bucket                 = entry;
+    return entry;
+}
+
+void DirtyPathIndex::Release(ClusterEntry * aEntry)
+{
+    for (ClusterEntry ** link = &mBuckets[BucketOf(aEntry->mEndpointId, aEntry->mClusterId)]; *link != nullptr;
+         link                 = &(*link)->mNextInBucket)
+    {
+        if (*link == aEntry)
+        {
+            *link = aEntry->mNextInBucket;
+            break;
+        }
+    }
+    ReleaseAttributes(aEntry);
+    mEntries.ReleaseObject(aEntry);
+}
+
+bool DirtyPathIndex::MergeEndpoint(EndpointId aEndpointId, uint64_t aGeneration)
+{
+    VerifyOrReturnValue(aEndpointId != kInvalidEndpointId, false);
+
+    uint64_t generation = aGeneration;
+    size_t merged       = 0;
+    mEntries.ForEachActiveObject([&](ClusterEntry * entry) {
+        if (entry->mEndpointId == aEndpointId && entry->mClusterId != kInvalidClusterId)
+        {
+            generation = std::max(generation, MaxGeneration(entry));
+            Release(entry);
+            merged++;
+        }
+        return Loop::Continue;
+    });
+
+    ClusterEntry * endpointEntry = Find(aEndpointId, kInvalidClusterId);
+    VerifyOrReturnValue(merged > 0 || endpointEntry != nullptr, false);
+
+    if (endpointEntry == nullptr)
+    {
+        // Merging released at least one entry, so this cannot fail.
+        endpointEntry = FindOrCreate(aEndpointId, kInvalidClusterId, generation);
+        VerifyOrReturnValue(endpointEntry != nullptr, true);
+    }
+    MarkAllAttributesDirty(endpointEntry, std::max(endpointEntry->mClusterGeneration, generation));
+    return true;
+}
+
+bool DirtyPathIndex::MergeLargestEndpoint()
+{
+    // Only used with statically allocated pools, which are small: a quadratic scan is fine here.
+    EndpointId largestEndpoint = kInvalidEndpointId;
+    size_t largestCount        = 1;
+    mEntries.ForEachActiveObject([&](const ClusterEntry * outer) {
+        if (outer->mEndpointId == kInvalidEndpointId || outer->mClusterId == kInvalidClusterId)
+        {
+            return Loop::Continue;
+        }
+        size_t count = 0;
+        mEntries.ForEachActiveObject([&](const ClusterEntry * inner) {
+            if (inner->mEndpointId == outer->mEndpointId && inner->mClusterId != kInvalidClusterId)
+            {
+                count++;
+            }
+            return Loop::Continue;
+        });
+        if (count > largestCount)
+        {
+            largestEndpoint = outer->mEndpointId;
+            largestCount    = count;
+        }
+        return Loop::Continue;
+    });
+
+    return largestEndpoint != kInvalidEndpointId && MergeEndpoint(largestEndpoint, 0);
+}
+
+void DirtyPathIndex::MarkAllDirty(uint64_t aGeneration)
+{
+    uint64_t generation = std::max(mAllGeneration, aGeneration);
+    mEntries.ForEachActiveObject([&generation, this](ClusterEntry * entry) {
+        generation = std::max(generation, MaxGeneration(entry));
+        return Loop::Continue;
+    });
+    Clear();
+    mAllGeneration = generation;
+}
+
+DirtyPathIndex::AttributeEntry * DirtyPathIndex::FindAttribute(const ClusterEntry * aEntry, AttributeId aAttributeId) const
+{
+    VerifyOrReturnValue(aEntry->mAttributeCount != 0, nullptr);
+    for (AttributeEntry * attribute = mAttributeBuckets[BucketOf(aEntry, aAttributeId)]; attribute != nullptr;
+         attribute                  = attribute->mNextInBucket)
+    {
+        if (attribute->mCluster == aEntry && attribute->mAttributeId == aAttributeId)
+        {
+            return attribute;
+        }
+    }
+    return nullptr;
+}
+
+void DirtyPathIndex::InsertAttribute(ClusterEntry * aEntry, AttributeId aAttributeId, uint64_t aGeneration)
+{
+    AttributeEntry * attribute = FindAttribute(aEntry, aAttributeId);
+    if (attribute != nullptr)
+    {
+        attribute->mGeneration = aGeneration;
+        return;
+    }
+
+    attribute = mAttributes.CreateObject(aEntry, aAttributeId, aGeneration);
+    if (attribute == nullptr)
+    {
+        // The pool is statically allocated and full. Make room by marking the cluster with the most dirty attributes dirty as a
+        // whole; if that is the cluster of the new attribute, it absorbs it.
+        VerifyOrReturn(!MergeLargestCluster(aEntry, aGeneration));
+        attribute = mAttributes.CreateObject(aEntry, aAttributeId, aGeneration);
+        if (attribute == nullptr)
+        {
+            MarkAllAttributesDirty(aEntry, std::max(MaxGeneration(aEntry), aGeneration));
+            return;
+        }
+    }
+
+    AttributeEntry *& bucket  = mAttributeBuckets[BucketOf(aEntry, aAttributeId)];
+    attribute->mNextInBucket  = bucket;
+    bucket                    = attribute;
+    attribute->mNextInCluster = aEntry->mAttributes;
+    aEntry->mAttributes       = attribute;
+    aEntry->mAttributeCount++;
+}
+
+bool DirtyPathIndex::MergeLargestCluster(ClusterEntry * aEntry, uint64_t aGeneration)
+{
+    // Only used with statically allocated pools, which are small: a linear scan is fine here. Ties go to aEntry, so the new
+    // attribute is absorbed rather than another cluster coarsened.
+    ClusterEntry * largest = nullptr;
+    size_t largestCount    = aEntry->mAttributeCount;
+    mEntries.ForEachActiveObject([&](ClusterEntry * entry) {
+        if (entry->mAttributeCount > largestCount)
+        {
+            largest      = entry;
+            largestCount = entry->mAttributeCount;
+        }
+        return Loop::Continue;
+    });
+
+    if (largest == nullptr)
+    {
+        MarkAllAttributesDirty(aEntry, std::max(MaxGeneration(aEntry), aGeneration));
+        return true;
+    }
+    MarkAllAttributesDirty(largest, MaxGeneration(largest));
+    return false;
+}
+
+void DirtyPathIndex::MarkAllAttributesDirty(ClusterEntry * aEntry, uint64_t aGeneration)
+{
+    ReleaseAttributes(aEntry);
+    aEntry->mClusterGeneration = aGeneration;
+}
+
+void DirtyPathIndex::ReleaseAttributes(ClusterEntry * aEntry)
+{
+    AttributeEntry * attribute = aEntry->mAttributes;
+    while (attribute != nullptr)
+    {
+        AttributeEntry * next = attribute->mNextInCluster;
+        for (AttributeEntry ** link = &mAttributeBuckets[BucketOf(aEntry, attribute->mAttributeId)]; *link != nullptr;
+             link                   = &(*link)->mNextInBucket)
+        {
+            if (*link == attribute)
+            {
+                *link = attribute->mNextInBucket;
+                break;
+            }
+        }
+        mAttributes.ReleaseObject(attribute);
+        attribute = next;
+    }
+    aEntry->mAttributes     = nullptr;
+    aEntry->mAttributeCount = 0;
+}
+
+uint64_t DirtyPathIndex::GetGeneration(const ClusterEntry * aEntry, AttributeId aAttributeId) const
+{
+    const AttributeEntry * attribute = FindAttribute(aEntry, aAttributeId);
+    return attribute != nullptr ? std::max(aEntry->mClusterGeneration, attribute->mGeneration) : aEntry->mClusterGeneration;
+}
+
+uint64_t DirtyPathIndex::MaxGeneration(const ClusterEntry * aEntry) const
+{
+    uint64_t generation = aEntry->mClusterGeneration;
+    for (const AttributeEntry * attribute = aEntry->mAttributes; attribute != nullptr; attribute = attribute->mNextInCluster)
+    {
+        generation = std::max(generation, attribute->mGeneration);
+    }
+    return generation;
+}
+
+void DirtyPathIndex::Insert(const AttributePathParams & aPath, uint64_t aGeneration)
+{
+    if (aPath.HasWildcardClusterId())
+    {
+        if (aPath.HasWildcardEndpointId())
+        {
+            // Everything tracked so far is older than aGeneration.
+            Clear();
+            mAllGeneration = aGeneration;
+            return;
+        }
+
+        // The clusters of the endpoint marked dirty so far are older than aGeneration, fold them into the endpoint entry.
+        VerifyOrReturn(!MergeEndpoint(aPath.mEndpointId, aGeneration));
+        ClusterEntry * entry = FindOrCreate(aPath.mEndpointId, kInvalidClusterId, aGeneration);
+        VerifyOrReturn(entry != nullptr);
+        MarkAllAttributesDirty(entry, aGeneration);
+        return;
+    }
+
+    ClusterEntry * entry = FindOrCreate(aPath.mEndpointId, aPath.mClusterId, aGeneration);
+    VerifyOrReturn(entry != nullptr);
+    if (aPath.HasWildcardAttributeId())
+    {
+        MarkAllAttributesDirty(entry, aGeneration);
+    }
+    else
+    {
+        InsertAttribute(entry, aPath.mAttributeId, aGeneration);
+    }
+}
+
+uint64_t DirtyPathIndex::GetGeneration(const ConcreteAttributePath & aPath) const
+{
+    uint64_t generation = mAllGeneration;
+    VerifyOrReturnValue(mEntries.Allocated() != 0, generation);
+
+    const ClusterEntry * candidates[] = {
+        Find(aPath.mEndpointId, aPath.mClusterId),
+        Find(kInvalidEndpointId, aPath.mClusterId),
+        Find(aPath.mEndpointId, kInvalidClusterId),
+    };
+    for (const ClusterEntry * entry : candidates)
+    {
+        if (entry != nullptr)
+        {
+            generation = std::max(generation, GetGeneration(entry, aPath.mAttributeId));
+        }
+    }
+    return generation;
+}
+
+size_t DirtyPathIndex::Size() const
+{
+    size_t size = mAttributes.Allocated() + (mAllGeneration != 0 ? 1 : 0);
+    mEntries.ForEachActiveObject([&size](const ClusterEntry * entry) {
+        size += (entry->mClusterGeneration != 0) ? 1 : 0;
+        return Loop::Continue;
+    });
+    return size;
+}
+
+void DirtyPathIndex::Clear()
+{
+    mAttributes.ReleaseAll();
+    mEntries.ReleaseAll();
+    for (ClusterEntry *& bucket : mBuckets)
+    {
+        bucket = nullptr;
+    }
+    for (AttributeEntry *& bucket : mAttributeBuckets)
+    {
+        bucket = nullptr;
+    }
+    mAllGeneration = 0;
+}
+
+} // namespace reporting
+} // namespace app
+} // namespace chip
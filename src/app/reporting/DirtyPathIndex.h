@@ -0,0 +1,173 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines the index of dirty attribute paths used by the reporting engine.
+ */
+
+#pragma once
+
+#include <app/AttributePathParams.h>
+#include <app/ConcreteAttributePath.h>
+#include <lib/core/CHIPConfig.h>
+#include <lib/core/DataModelTypes.h>
+#include <lib/support/Pool.h>
+
+namespace chip {
+namespace app {
+namespace reporting {
+
+/**
+ * The set of attribute paths marked dirty, together with the dirty set generation at which each one was last marked.
+ *
+ * Dirty attributes are grouped per (endpoint, cluster) entry, and both entries and attributes are found through hash indices,
+ * so both marking a path dirty and checking whether a concrete path is dirty take constant time regardless of how many paths
+ * are dirty. The endpoint of an entry may be a wildcard, and an entry with a wildcard cluster marks a whole endpoint dirty.
+ *
+ * Paths are only coarsened when pools are statically allocated and exhausted: when no attribute entry is left, the cluster
+ * with the most dirty attributes is marked dirty as a whole; when no cluster entry is left, entries are merged per endpoint,
+ * and only if every entry is for a different endpoint does the whole set collapse to a single wildcard path.
+ */
+class DirtyPathIndex
+{
+public:
+    DirtyPathIndex() = default;
+    ~DirtyPathIndex() { Clear(); }
+
+    DirtyPathIndex(const DirtyPathIndex &)             = delete;
+    DirtyPathIndex & operator=(const DirtyPathIndex &) = delete;
+
+    /**
+     * Mark a path dirty at the given generation. Any of the endpoint, cluster and attribute may be wildcards; list indices are
+     * ignored, the whole attribute is considered dirty.
+     */
+    void Insert(const AttributePathParams & aPath, uint64_t aGeneration);
+
+    /**
+     * Returns the latest generation at which a path including aPath was marked dirty, or 0 if aPath is not dirty.
+     */
+    uint64_t GetGeneration(const ConcreteAttributePath & aPath) const;
+
+    void Clear();
+    bool IsEmpty() const { return mAllGeneration == 0 && mEntries.Allocated() == 0; }
+
+    /**
+     * Returns the number of dirty paths, as enumerated by ForEachPath().
+     */
+    size_t Size() const;
+
+    /**
+     * Calls aFunction(const AttributePathParams & path, uint64_t generation) for every dirty path in the index, where the path
+     * is as coarse as the index tracks it. Stops early if aFunction returns Loop::Break.
+     */
+    template <typename Function>
+    Loop ForEachPath(Function && aFunction) const
+    {
+        if (mAllGeneration != 0 && aFunction(AttributePathParams(), mAllGeneration) == Loop::Break)
+        {
+            return Loop::Break;
+        }
+        return mEntries.ForEachActiveObject([&](const ClusterEntry * entry) {
+            if (entry->mClusterGeneration != 0 &&
+                aFunction(AttributePathParams(entry->mEndpointId, entry->mClusterId), entry->mClusterGeneration) == Loop::Break)
+            {
+                return Loop::Break;
+            }
+            for (const AttributeEntry * attribute = entry->mAttributes; attribute != nullptr; attribute = attribute->mNextInCluster)
+            {
+                if (aFunction(AttributePathParams(entry->mEndpointId, entry->mClusterId, attribute->mAttributeId),
+                              attribute->mGeneration) == Loop::Break)
+                {
+                    return Loop::Break;
+                }
+            }
+            return Loop::Continue;
+        });
+    }
+
+private:
+    static constexpr size_t kBucketCount = CHIP_IM_SERVER_DIRTY_SET_INDEX_BUCKETS;
+    static_assert(kBucketCount > 0 && (kBucketCount & (kBucketCount - 1)) == 0,
+                  "CHIP_IM_SERVER_DIRTY_SET_INDEX_BUCKETS must be a power of two");
+
+    struct ClusterEntry;
+
+    struct AttributeEntry
+    {
+        AttributeEntry(ClusterEntry * aCluster, AttributeId aAttributeId, uint64_t aGeneration) :
+            mCluster(aCluster), mGeneration(aGeneration), mAttributeId(aAttributeId)
+        {}
+
+        AttributeEntry * mNextInBucket  = nullptr;
+        AttributeEntry * mNextInCluster = nullptr;
+        ClusterEntry * mCluster;
+        uint64_t mGeneration;
+        AttributeId mAttributeId;
+    };
+
+    struct ClusterEntry
+    {
+        ClusterEntry(EndpointId aEndpointId, ClusterId aClusterId) : mClusterId(aClusterId), mEndpointId(aEndpointId) {}
+
+        ClusterEntry * mNextInBucket = nullptr;
+        // The attributes of the cluster marked dirty individually, most recently added first.
+        AttributeEntry * mAttributes = nullptr;
+        // Generation at which every attribute of the cluster (or, for a wildcard cluster, of the endpoint) was last marked dirty.
+        uint64_t mClusterGeneration = 0;
+        size_t mAttributeCount      = 0;
+        ClusterId mClusterId;
+        EndpointId mEndpointId;
+    };
+
+    static size_t BucketOf(EndpointId aEndpointId, ClusterId aClusterId);
+    static size_t BucketOf(const ClusterEntry * aEntry, AttributeId aAttributeId);
+
+    ClusterEntry * Find(EndpointId aEndpointId, ClusterId aClusterId) const;
+    ClusterEntry * FindOrCreate(EndpointId aEndpointId, ClusterId aClusterId, uint64_t aGeneration);
+    void Release(ClusterEntry * aEntry);
+    bool MergeEndpoint(EndpointId aEndpointId, uint64_t aGeneration);
+    bool MergeLargestEndpoint();
+    void MarkAllDirty(uint64_t aGeneration);
+
+    AttributeEntry * FindAttribute(const ClusterEntry * aEntry, AttributeId aAttributeId) const;
+    void InsertAttribute(ClusterEntry * aEntry, AttributeId aAttributeId, uint64_t aGeneration);
+    bool MergeLargestCluster(ClusterEntry * aEntry, uint64_t aGeneration);
+    void MarkAllAttributesDirty(ClusterEntry * aEntry, uint64_t aGeneration);
+    void ReleaseAttributes(ClusterEntry * aEntry);
+    uint64_t GetGeneration(const ClusterEntry * aEntry, AttributeId aAttributeId) const;
+    uint64_t MaxGeneration(const ClusterEntry * aEntry) const;
+
+    ClusterEntry * mBuckets[kBucketCount]            = {};
+    AttributeEntry * mAttributeBuckets[kBucketCount] = {};
+    // Generation at which the whole set was last marked dirty.
+    uint64_t mAllGeneration = 0;
+
+#if CONFIG_BUILD_FOR_HOST_UNIT_TEST
+    // For unit tests, always use inline allocation for code coverage.
+    ObjectPool<ClusterEntry, CHIP_IM_SERVER_MAX_NUM_DIRTY_SET, ObjectPoolMem::kInline> mEntries;
+    ObjectPool<AttributeEntry, CHIP_IM_SERVER_MAX_NUM_DIRTY_SET, ObjectPoolMem::kInline> mAttributes;
+#else
+    ObjectPool<ClusterEntry, CHIP_IM_SERVER_MAX_NUM_DIRTY_SET> mEntries;
+    ObjectPool<AttributeEntry, CHIP_IM_SERVER_MAX_NUM_DIRTY_SET> mAttributes;
+#endif
+};
+
+} // namespace reporting
+} // namespace app
+} // namespace chip
@@ -0,0 +1,94 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app/reporting/ReadHandlerPathIndex.h>
+
+#include <app/ReadHandler.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/IdHash.h>
+
+namespace chip {
+namespace app {
+namespace reporting {
+
+size_t ReadHandlerPathIndex::BucketOf(EndpointId aEndpointId, ClusterId aClusterId)
+{
+    return BucketOfIdPair<kBucketCount>(aClusterId, aEndpointId);
+}
+
+ReadHandlerPathIndex::Entry *& ReadHandlerPathIndex::ListFor(const AttributePathParams & aPath)
+{
+    if (aPath.HasWildcardEndpointId() && aPath.HasWildcardClusterId())
+    {
+        return mWildcardEntries;
+    }
+    return mBuckets[BucketOf(aPath.mEndpointId, aPath.mClusterId)];
+}
+
+CHIP_ERROR ReadHandlerPathIndex::Add(ReadHandler & aHandler)
+{
+    for (auto path = aHandler.GetAttributePathList(); path != nullptr; path = path->mpNext)
+    {
+        Entry * entry = mEntries.CreateObject(&aHandler, path->mValue);
+        if (entry == nullptr)
+        {
+            Remove(aHandler);
+            return CHIP_ERROR_NO_MEMORY;
+        }
+
+        Entry *& list = ListFor(path->mValue);
+        entry->mNext  = list;
+        list          = entry;
+    }
+    return CHIP_NO_ERROR;
+}
+
+void ReadHandlerPathIndex::Remove(ReadHandler & aHandler)
+{
+    for (auto path = aHandler.GetAttributePathList(); path != nullptr; path = path->mpNext)
+    {
+        // Unlink every entry of the handler in this list at once; later paths filed under the same list find nothing left.
+        for (Entry ** link = &ListFor(path->mValue); *link != nullptr;)
+        {
+            Entry * entry = *link;
+            if (entry->mHandler == &aHandler)
+            {
+                *link = entry->mNext;
+                mEntries.ReleaseObject(entry);
+            }
+            else
+            {
+                link = &entry->mNext;
+            }
+        }
+    }
+}
+
+void ReadHandlerPathIndex::Clear()
+{
+    mEntries.ReleaseAll();
+    for (Entry *& bucket : mBuckets)
+    {
+        bucket = nullptr;
+    }
+    mWildcardEntries = nullptr;
+}
+
+} // namespace reporting
+} // namespace app
+} // namespace chip
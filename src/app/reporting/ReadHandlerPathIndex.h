@@ -0,0 +1,136 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines the index from attribute paths to the read handlers interested in them.
+ */
+
+#pragma once
+
+#include <app/AttributePathParams.h>
+#include <lib/core/CHIPConfig.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/DataModelTypes.h>
+#include <lib/support/Pool.h>
+
+namespace chip {
+namespace app {
+
+class ReadHandler;
+
+namespace reporting {
+
+/**
+ * Reverse index of the attribute paths that read handlers have requested, so that marking a path dirty only has to look at
+ * the handlers whose paths may intersect it.
+ *
+ * Every requested path is filed under its (endpoint, cluster), where either may be a wildcard; paths with both a wildcard
+ * endpoint and a wildcard cluster are kept on a separate list. A dirty path with a concrete endpoint and cluster can then only
+ * intersect the paths filed under (endpoint, cluster), (*, cluster), (endpoint, *) and (*, *).
+ *
+ * A handler must be added once its attribute path list is complete, and removed before that list is released.
+ */
+class ReadHandlerPathIndex
+{
+public:
+    ReadHandlerPathIndex() = default;
+    ~ReadHandlerPathIndex() { Clear(); }
+
+    ReadHandlerPathIndex(const ReadHandlerPathIndex &)             = delete;
+    ReadHandlerPathIndex & operator=(const ReadHandlerPathIndex &) = delete;
+
+    /**
+     * Index every attribute path of aHandler. On failure, none of its paths are indexed.
+     */
+    CHIP_ERROR Add(ReadHandler & aHandler);
+
+    /**
+     * Remove every attribute path of aHandler from the index. Does nothing if aHandler was never added.
+     */
+    void Remove(ReadHandler & aHandler);
+
+    void Clear();
+    size_t Size() const { return mEntries.Allocated(); }
+
+    /**
+     * Whether ForEachIntersectingHandler can be used for aPath, i.e. whether its endpoint and cluster are concrete.
+     */
+    static bool CanLookup(const AttributePathParams & aPath)
+    {
+        return !aPath.HasWildcardEndpointId() && !aPath.HasWildcardClusterId();
+    }
+
+    /**
+     * Calls aFunction(ReadHandler * handler) for every indexed path that intersects aPath, which must satisfy CanLookup(). A
+     * handler with several intersecting paths is visited once per path. aFunction must not add or remove handlers.
+     */
+    template <typename Function>
+    void ForEachIntersectingHandler(const AttributePathParams & aPath, Function && aFunction) const
+    {
+        const size_t buckets[] = {
+            BucketOf(aPath.mEndpointId, aPath.mClusterId),
+            BucketOf(kInvalidEndpointId, aPath.mClusterId),
+            BucketOf(aPath.mEndpointId, kInvalidClusterId),
+        };
+        const Entry * const lists[] = {
+            mBuckets[buckets[0]],
+            (buckets[1] != buckets[0]) ? mBuckets[buckets[1]] : nullptr,
+            (buckets[2] != buckets[0] && buckets[2] != buckets[1]) ? mBuckets[buckets[2]] : nullptr,
+            mWildcardEntries,
+        };
+        for (const Entry * list : lists)
+        {
+            for (const Entry * entry = list; entry != nullptr; entry = entry->mNext)
+            {
+                if (entry->mPath.Intersects(aPath))
+                {
+                    aFunction(entry->mHandler);
+                }
+            }
+        }
+    }
+
+private:
+    static constexpr size_t kBucketCount = CHIP_IM_SERVER_READ_HANDLER_INDEX_BUCKETS;
+    static_assert(kBucketCount > 0 && (kBucketCount & (kBucketCount - 1)) == 0,
+                  "CHIP_IM_SERVER_READ_HANDLER_INDEX_BUCKETS must be a power of two");
+
+    struct Entry
+    {
+        Entry(ReadHandler * aHandler, const AttributePathParams & aPath) : mHandler(aHandler), mPath(aPath) {}
+
+        Entry * mNext = nullptr;
+        ReadHandler * mHandler;
+        AttributePathParams mPath;
+    };
+
+    static size_t BucketOf(EndpointId aEndpointId, ClusterId aClusterId);
+
+    Entry *& ListFor(const AttributePathParams & aPath);
+
+    // Buckets may also hold paths filed under other keys that hash to the same bucket; they fail the Intersects() check.
+    Entry * mBuckets[kBucketCount] = {};
+    Entry * mWildcardEntries       = nullptr;
+
+    ObjectPool<Entry, CHIP_IM_SERVER_MAX_NUM_PATH_GROUPS_FOR_READS + CHIP_IM_SERVER_MAX_NUM_PATH_GROUPS_FOR_SUBSCRIPTIONS> mEntries;
+};
+
+} // namespace reporting
+} // namespace app
+} // namespace chip
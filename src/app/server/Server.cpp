@@ -561,8 +561,12 @@ app::DefaultTimerDelegate CommonCaseDeviceServerInitParams::sTimerDelegate;
 app::reporting::ReportSchedulerImpl
     CommonCaseDeviceServerInitParams::sReportScheduler(&CommonCaseDeviceServerInitParams::sTimerDelegate);
 #if CHIP_CONFIG_ENABLE_SESSION_RESUMPTION
+#if CHIP_CONFIG_CASE_SESSION_RESUME_CACHED_STORAGE
+CachedSessionResumptionStorage CommonCaseDeviceServerInitParams::sSessionResumptionStorage;
+#else
 SimpleSessionResumptionStorage CommonCaseDeviceServerInitParams::sSessionResumptionStorage;
 #endif
+#endif
 #if CHIP_CONFIG_PERSIST_SUBSCRIPTIONS
 app::SimpleSubscriptionResumptionStorage CommonCaseDeviceServerInitParams::sSubscriptionResumptionStorage;
 #endif
@@ -53,8 +53,12 @@
 #include <protocols/secure_channel/RendezvousParameters.h>
 #include <protocols/secure_channel/UnsolicitedStatusHandler.h>
 #if CHIP_CONFIG_ENABLE_SESSION_RESUMPTION
+#if CHIP_CONFIG_CASE_SESSION_RESUME_CACHED_STORAGE
+#include <protocols/secure_channel/CachedSessionResumptionStorage.h>
+#else
 #include <protocols/secure_channel/SimpleSessionResumptionStorage.h>
 #endif
+#endif
 #include <protocols/user_directed_commissioning/UserDirectedCommissioning.h>
 #include <system/SystemClock.h>
 #include <transport/SessionManager.h>
@@ -269,8 +273,12 @@ private:
     static app::reporting::ReportSchedulerImpl sReportScheduler;
 
 #if CHIP_CONFIG_ENABLE_SESSION_RESUMPTION
+#if CHIP_CONFIG_CASE_SESSION_RESUME_CACHED_STORAGE
+    static CachedSessionResumptionStorage sSessionResumptionStorage;
+#else
     static SimpleSessionResumptionStorage sSessionResumptionStorage;
 #endif
+#endif
 #if CHIP_CONFIG_PERSIST_SUBSCRIPTIONS
     static app::SimpleSubscriptionResumptionStorage sSubscriptionResumptionStorage;
 #endif
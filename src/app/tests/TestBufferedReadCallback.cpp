@@ -429,6 +429,7 @@ void DataSeriesGenerator::Generate()
                 NL_TEST_ASSERT(gSuite, DataModel::Encode(writer, TLV::AnonymousTag(), value) == CHIP_NO_ERROR);
 
                 writer.Finalize(&handle);
+                callback->OnReportBuffer(handle);
                 reader.Init(std::move(handle));
                 NL_TEST_ASSERT(gSuite, reader.Next() == CHIP_NO_ERROR);
                 callback->OnAttributeData(path, &reader, status);
@@ -452,6 +453,7 @@ void DataSeriesGenerator::Generate()
                 NL_TEST_ASSERT(gSuite, DataModel::Encode(writer, TLV::AnonymousTag(), listItem) == CHIP_NO_ERROR);
 
                 writer.Finalize(&handle);
+                callback->OnReportBuffer(handle);
                 reader.Init(std::move(handle));
                 NL_TEST_ASSERT(gSuite, reader.Next() == CHIP_NO_ERROR);
                 callback->OnAttributeData(path, &reader, status);
@@ -472,6 +474,7 @@ void DataSeriesGenerator::Generate()
                 NL_TEST_ASSERT(gSuite, DataModel::Encode(writer, TLV::AnonymousTag(), value) == CHIP_NO_ERROR);
 
                 writer.Finalize(&handle);
+                callback->OnReportBuffer(handle);
                 reader.Init(std::move(handle));
                 NL_TEST_ASSERT(gSuite, reader.Next() == CHIP_NO_ERROR);
                 callback->OnAttributeData(path, &reader, status);
@@ -491,6 +494,7 @@ void DataSeriesGenerator::Generate()
                 NL_TEST_ASSERT(gSuite, DataModel::Encode(writer, TLV::AnonymousTag(), (uint8_t) (i)) == CHIP_NO_ERROR);
 
                 writer.Finalize(&handle);
+                callback->OnReportBuffer(handle);
                 reader.Init(std::move(handle));
                 NL_TEST_ASSERT(gSuite, reader.Next() == CHIP_NO_ERROR);
                 callback->OnAttributeData(path, &reader, status);
@@ -506,6 +510,7 @@ void DataSeriesGenerator::Generate()
         if (hasData)
         {
             writer.Finalize(&handle);
+            callback->OnReportBuffer(handle);
             reader.Init(std::move(handle));
             NL_TEST_ASSERT(gSuite, reader.Next() == CHIP_NO_ERROR);
             callback->OnAttributeData(path, &reader, status);
@@ -519,12 +524,17 @@ void DataSeriesGenerator::Generate()
 
 void RunAndValidateSequence(std::vector<ValidationInstruction> instructionList)
 {
-    DataSeriesValidator validator(instructionList);
-    BufferedReadCallback bufferedCallback(validator);
-    DataSeriesGenerator generator(bufferedCallback, instructionList);
-    generator.Generate();
+    // List items are buffered up either as copies, or by reference to the report buffers.
+    for (bool retainReportBuffers : { false, true })
+    {
+        DataSeriesValidator validator(instructionList);
+        BufferedReadCallback bufferedCallback(validator);
+        bufferedCallback.SetRetainReportBuffers(retainReportBuffers);
+        DataSeriesGenerator generator(bufferedCallback, instructionList);
+        generator.Generate();
 
-    NL_TEST_ASSERT(gSuite, validator.mCurrentInstruction == instructionList.size());
+        NL_TEST_ASSERT(gSuite, validator.mCurrentInstruction == instructionList.size());
+    }
 }
 
 void TestBufferedSequences(nlTestSuite * apSuite, void * apContext)
@@ -0,0 +1,280 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements unit tests for the ClusterInterfaceRegistry of attribute access and command handler interfaces.
+ */
+
+#include <app/AttributeAccessInterface.h>
+#include <app/ClusterInterfaceRegistry.h>
+#include <app/CommandHandlerInterface.h>
+#include <lib/support/UnitTestRegistration.h>
+#include <system/SystemClock.h>
+
+#include <cinttypes>
+#include <cstdio>
+#include <nlunit-test.h>
+
+using namespace chip;
+using namespace chip::app;
+
+namespace {
+
+class TestAttributeAccess : public AttributeAccessInterface
+{
+public:
+    TestAttributeAccess(Optional<EndpointId> aEndpointId, ClusterId aClusterId) : AttributeAccessInterface(aEndpointId, aClusterId) {}
+
+    CHIP_ERROR Read(const ConcreteReadAttributePath & aPath, AttributeValueEncoder & aEncoder) override { return CHIP_NO_ERROR; }
+};
+
+class TestCommandHandler : public CommandHandlerInterface
+{
+public:
+    TestCommandHandler(Optional<EndpointId> aEndpointId, ClusterId aClusterId) : CommandHandlerInterface(aEndpointId, aClusterId) {}
+
+    void InvokeCommand(HandlerContext & aHandlerContext) override {}
+};
+
+void TestRegisterAndFind(nlTestSuite * apSuite, void * apContext)
+{
+    ClusterInterfaceRegistry<AttributeAccessInterface, 4> registry;
+
+    TestAttributeAccess onOffOnOne(MakeOptional(static_cast<EndpointId>(1)), 6);
+    TestAttributeAccess onOffOnTwo(MakeOptional(static_cast<EndpointId>(2)), 6);
+    TestAttributeAccess onOffEverywhere(NullOptional, 6);
+    TestAttributeAccess levelEverywhere(NullOptional, 8);
+    TestAttributeAccess levelOnOne(MakeOptional(static_cast<EndpointId>(1)), 8);
+    TestAttributeAccess onOffOnOneAgain(MakeOptional(static_cast<EndpointId>(1)), 6);
+
+    NL_TEST_ASSERT(apSuite, registry.Register(onOffOnOne));
+    NL_TEST_ASSERT(apSuite, registry.Register(onOffOnTwo));
+    NL_TEST_ASSERT(apSuite, registry.Register(levelEverywhere));
+    NL_TEST_ASSERT(apSuite, registry.Count() == 3);
+
+    // Overlapping registrations are rejected, whichever of them is a wildcard.
+    NL_TEST_ASSERT(apSuite, !registry.Register(onOffOnOneAgain));
+    NL_TEST_ASSERT(apSuite, !registry.Register(onOffEverywhere));
+    NL_TEST_ASSERT(apSuite, !registry.Register(levelOnOne));
+    NL_TEST_ASSERT(apSuite, registry.Count() == 3);
+
+    NL_TEST_ASSERT(apSuite, registry.Find(1, 6) == &onOffOnOne);
+    NL_TEST_ASSERT(apSuite, registry.Find(2, 6) == &onOffOnTwo);
+    NL_TEST_ASSERT(apSuite, registry.Find(3, 6) == nullptr);
+    NL_TEST_ASSERT(apSuite, registry.Find(1, 8) == &levelEverywhere);
+    NL_TEST_ASSERT(apSuite, registry.Find(7, 8) == &levelEverywhere);
+    NL_TEST_ASSERT(apSuite, registry.Find(1, 29) == nullptr);
+
+    // Once the concrete registrations are gone, the wildcard one fits.
+    NL_TEST_ASSERT(apSuite, registry.Unregister(onOffOnOne));
+    NL_TEST_ASSERT(apSuite, !registry.Unregister(onOffOnOne));
+    NL_TEST_ASSERT(apSuite, onOffOnOne.GetNext() == nullptr);
+    NL_TEST_ASSERT(apSuite, !registry.Register(onOffEverywhere));
+    NL_TEST_ASSERT(apSuite, registry.Unregister(onOffOnTwo));
+    NL_TEST_ASSERT(apSuite, registry.Register(onOffEverywhere));
+    NL_TEST_ASSERT(apSuite, registry.Find(1, 6) == &onOffEverywhere);
+    NL_TEST_ASSERT(apSuite, registry.Count() == 2);
+
+    registry.Clear();
+    NL_TEST_ASSERT(apSuite, registry.Count() == 0);
+    NL_TEST_ASSERT(apSuite, registry.Find(1, 6) == nullptr);
+    NL_TEST_ASSERT(apSuite, registry.Find(1, 8) == nullptr);
+    NL_TEST_ASSERT(apSuite, onOffEverywhere.GetNext() == nullptr && levelEverywhere.GetNext() == nullptr);
+}
+
+void TestUnregisterMatching(nlTestSuite * apSuite, void * apContext)
+{
+    // Few buckets, so that unregistering has to unlink from the head, middle and tail of chains.
+    ClusterInterfaceRegistry<CommandHandlerInterface, 2> registry;
+
+    constexpr EndpointId kEndpointCount = 4;
+    constexpr ClusterId kClusterCount   = 5;
+    TestCommandHandler * handlers[kEndpointCount][kClusterCount];
+    for (EndpointId e = 0; e < kEndpointCount; e++)
+    {
+        for (ClusterId c = 0; c < kClusterCount; c++)
+        {
+            handlers[e][c] = new TestCommandHandler(MakeOptional(e), c);
+            NL_TEST_ASSERT(apSuite, registry.Register(*handlers[e][c]));
+        }
+    }
+    TestCommandHandler everywhere(NullOptional, kClusterCount);
+    NL_TEST_ASSERT(apSuite, registry.Register(everywhere));
+
+    // Removing an endpoint only removes its own handlers.
+    size_t removed = registry.UnregisterMatching([](CommandHandlerInterface * handler) { return handler->MatchesEndpoint(2); });
+    NL_TEST_ASSERT(apSuite, removed == kClusterCount);
+    NL_TEST_ASSERT(apSuite, registry.Count() == (kEndpointCount - 1) * kClusterCount + 1);
+    for (EndpointId e = 0; e < kEndpointCount; e++)
+    {
+        for (ClusterId c = 0; c < kClusterCount; c++)
+        {
+            NL_TEST_ASSERT(apSuite, registry.Find(e, c) == (e == 2 ? nullptr : handlers[e][c]));
+        }
+        NL_TEST_ASSERT(apSuite, registry.Find(e, kClusterCount) == &everywhere);
+    }
+
+    removed = registry.UnregisterMatching([](CommandHandlerInterface * handler) { return handler->GetClusterId() % 2 == 0; });
+    NL_TEST_ASSERT(apSuite, removed == (kEndpointCount - 1) * 3);
+    NL_TEST_ASSERT(apSuite, registry.Find(1, 1) == handlers[1][1]);
+    NL_TEST_ASSERT(apSuite, registry.Find(1, 2) == nullptr);
+    NL_TEST_ASSERT(apSuite, registry.Find(3, 3) == handlers[3][3]);
+    NL_TEST_ASSERT(apSuite, registry.Find(3, kClusterCount) == &everywhere);
+
+    registry.Clear();
+    for (EndpointId e = 0; e < kEndpointCount; e++)
+    {
+        for (ClusterId c = 0; c < kClusterCount; c++)
+        {
+            NL_TEST_ASSERT(apSuite, handlers[e][c]->GetNext() == nullptr);
+            delete handlers[e][c];
+        }
+    }
+}
+
+/**
+ * Measures the interface lookup done for every attribute read, on a bridge where most clusters of the bridged endpoints have
+ * an attribute access interface, against the linked list walk it replaces.
+ */
+void TestReadLookupThroughput(nlTestSuite * apSuite, void * apContext)
+{
+    constexpr size_t kClustersPerEndpoint = 8;
+    constexpr size_t kEndpointCounts[]    = { 4, 16, 64 };
+    constexpr size_t kMaxEndpoints        = 64;
+    constexpr size_t kLookups             = 200000;
+
+    // Descriptor, basic information and diagnostics everywhere; on/off, level, bridged device basic information and occupancy
+    // sensing on each bridged endpoint; identify and groups without an interface.
+    static constexpr ClusterId kWildcardClusters[]  = { 0x001D, 0x0028, 0x0033, 0x0034, 0x0035 };
+    static constexpr ClusterId kEndpointClusters[]  = { 0x0006, 0x0008, 0x0039, 0x0406 };
+    static constexpr ClusterId kUnhandledClusters[] = { 0x0003, 0x0004 };
+    static_assert(ArraySize(kEndpointClusters) + ArraySize(kUnhandledClusters) + 2 == kClustersPerEndpoint, "Cluster mix");
+
+    constexpr size_t kMaxInterfaces = ArraySize(kWildcardClusters) + kMaxEndpoints * ArraySize(kEndpointClusters);
+
+    ClusterInterfaceRegistry<AttributeAccessInterface> registry;
+    // Interfaces in registration order; GetAttributeAccessOverride used to walk them from the most recent one.
+    TestAttributeAccess * interfaces[kMaxInterfaces];
+
+    auto nowMicroseconds = []() { return System::SystemClock().GetMonotonicMicroseconds64().count(); };
+
+    uint32_t seed    = 1;
+    auto nextCluster = [&seed]() {
+        seed       = seed * 1103515245u + 12345u;
+        uint32_t r = (seed >> 8) % kClustersPerEndpoint;
+        if (r < ArraySize(kEndpointClusters))
+        {
+            return kEndpointClusters[r];
+        }
+        r -= static_cast<uint32_t>(ArraySize(kEndpointClusters));
+        if (r < ArraySize(kUnhandledClusters))
+        {
+            return kUnhandledClusters[r];
+        }
+        return kWildcardClusters[(seed >> 16) % ArraySize(kWildcardClusters)];
+    };
+
+    for (size_t endpointCount : kEndpointCounts)
+    {
+        size_t interfaceCount = 0;
+        for (ClusterId cluster : kWildcardClusters)
+        {
+            interfaces[interfaceCount++] = new TestAttributeAccess(NullOptional, cluster);
+        }
+        for (size_t e = 0; e < endpointCount; e++)
+        {
+            for (ClusterId cluster : kEndpointClusters)
+            {
+                interfaces[interfaceCount++] = new TestAttributeAccess(MakeOptional(static_cast<EndpointId>(e + 1)), cluster);
+            }
+        }
+        for (size_t i = 0; i < interfaceCount; i++)
+        {
+            NL_TEST_ASSERT(apSuite, registry.Register(*interfaces[i]));
+        }
+        NL_TEST_ASSERT(apSuite, registry.Count() == interfaceCount);
+
+        const uint32_t lookupsSeed = seed;
+        size_t listFound           = 0;
+        uint64_t start             = nowMicroseconds();
+        for (size_t n = 0; n < kLookups; n++)
+        {
+            const EndpointId endpoint = static_cast<EndpointId>(1 + n % endpointCount);
+            const ClusterId cluster   = nextCluster();
+            for (size_t i = interfaceCount; i > 0; i--)
+            {
+                if (interfaces[i - 1]->Matches(endpoint, cluster))
+                {
+                    listFound++;
+                    break;
+                }
+            }
+        }
+        const uint64_t listTime = nowMicroseconds() - start;
+
+        seed                 = lookupsSeed;
+        size_t registryFound = 0;
+        start                = nowMicroseconds();
+        for (size_t n = 0; n < kLookups; n++)
+        {
+            const EndpointId endpoint = static_cast<EndpointId>(1 + n % endpointCount);
+            registryFound += (registry.Find(endpoint, nextCluster()) != nullptr) ? 1 : 0;
+        }
+        const uint64_t registryTime = nowMicroseconds() - start;
+
+        NL_TEST_ASSERT(apSuite, listFound == registryFound);
+        printf("  %zu interfaces: list %" PRIu64 " ns/read, registry %" PRIu64 " ns/read, %zu handled\n", interfaceCount,
+               listTime * 1000 / kLookups, registryTime * 1000 / kLookups, registryFound);
+
+        registry.Clear();
+        for (size_t i = 0; i < interfaceCount; i++)
+        {
+            delete interfaces[i];
+        }
+    }
+}
+
+} // namespace
+
+// clang-format off
+static const nlTest sTests[] =
+{
+    NL_TEST_DEF("TestRegisterAndFind", TestRegisterAndFind),
+    NL_TEST_DEF("TestUnregisterMatching", TestUnregisterMatching),
+    NL_TEST_DEF("TestReadLookupThroughput", TestReadLookupThroughput),
+    NL_TEST_SENTINEL()
+};
+// clang-format on
+
+int TestClusterInterfaceRegistry()
+{
+    // clang-format off
+    nlTestSuite theSuite =
+    {
+        "ClusterInterfaceRegistry",
+        &sTests[0],
+        nullptr,
+        nullptr
+    };
+    // clang-format on
+
+    nlTestRunner(&theSuite, nullptr);
+    return (nlTestRunnerStats(&theSuite));
+}
+
+CHIP_REGISTER_TEST_SUITE(TestClusterInterfaceRegistry)
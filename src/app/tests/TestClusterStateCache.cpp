@@ -25,6 +25,7 @@
 #include "system/TLVPacketBufferBackingStore.h"
 #include <app-common/zap-generated/cluster-objects.h>
 #include <app/ClusterStateCache.h>
+#include <app/MessageDef/AttributeDataIB.h>
 #include <app/MessageDef/DataVersionFilterIBs.h>
 #include <app/data-model/DecodableList.h>
 #include <app/data-model/Decode.h>
@@ -33,9 +34,17 @@
 #include <lib/support/UnitTestContext.h>
 #include <lib/support/UnitTestRegistration.h>
 #include <nlunit-test.h>
+#include <system/SystemClock.h>
+
+#include <memory>
+#include <stdio.h>
 #include <string.h>
 #include <vector>
 
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
 using TestContext = chip::Test::AppContext;
 using namespace chip::app;
 using namespace chip;
@@ -273,7 +282,8 @@ void DataSeriesGenerator::Generate(ForwardedDataCallbackValidator & dataCallback
     callback->OnReportEnd();
 }
 
-class CacheValidator : public ClusterStateCache::Callback
+template <typename CacheType>
+class CacheValidator : public CacheType::Callback
 {
 public:
     CacheValidator(AttributeInstructionListType & instructionList, ForwardedDataCallbackValidator & dataCallbackValidator);
@@ -304,7 +314,7 @@ private:
         }
     }
 
-    void DecodeAttribute(const AttributeInstruction & instruction, const ConcreteAttributePath & path, ClusterStateCache * cache)
+    void DecodeAttribute(const AttributeInstruction & instruction, const ConcreteAttributePath & path, CacheType * cache)
     {
         CHIP_ERROR err;
         bool gotStatus = false;
@@ -317,7 +327,7 @@ private:
             ChipLogProgress(DataManagement, "\t\t -- Validating A");
 
             Clusters::UnitTesting::Attributes::Int16u::TypeInfo::DecodableType v = 0;
-            err = cache->Get<Clusters::UnitTesting::Attributes::Int16u::TypeInfo>(path, v);
+            err = cache->template Get<Clusters::UnitTesting::Attributes::Int16u::TypeInfo>(path, v);
             if (err == CHIP_ERROR_IM_STATUS_CODE_RECEIVED)
             {
                 gotStatus = true;
@@ -336,7 +346,7 @@ private:
             ChipLogProgress(DataManagement, "\t\t -- Validating B");
 
             Clusters::UnitTesting::Attributes::OctetString::TypeInfo::DecodableType v;
-            err = cache->Get<Clusters::UnitTesting::Attributes::OctetString::TypeInfo>(path, v);
+            err = cache->template Get<Clusters::UnitTesting::Attributes::OctetString::TypeInfo>(path, v);
             if (err == CHIP_ERROR_IM_STATUS_CODE_RECEIVED)
             {
                 gotStatus = true;
@@ -355,7 +365,7 @@ private:
             ChipLogProgress(DataManagement, "\t\t -- Validating C");
 
             Clusters::UnitTesting::Attributes::StructAttr::TypeInfo::DecodableType v;
-            err = cache->Get<Clusters::UnitTesting::Attributes::StructAttr::TypeInfo>(path, v);
+            err = cache->template Get<Clusters::UnitTesting::Attributes::StructAttr::TypeInfo>(path, v);
             if (err == CHIP_ERROR_IM_STATUS_CODE_RECEIVED)
             {
                 gotStatus = true;
@@ -374,7 +384,7 @@ private:
             ChipLogProgress(DataManagement, "\t\t -- Validating D");
 
             Clusters::UnitTesting::Attributes::ListStructOctetString::TypeInfo::DecodableType v;
-            err = cache->Get<Clusters::UnitTesting::Attributes::ListStructOctetString::TypeInfo>(path, v);
+            err = cache->template Get<Clusters::UnitTesting::Attributes::ListStructOctetString::TypeInfo>(path, v);
             if (err == CHIP_ERROR_IM_STATUS_CODE_RECEIVED)
             {
                 gotStatus = true;
@@ -404,10 +414,9 @@ private:
         }
     }
 
-    void DecodeClusterObject(const AttributeInstruction & instruction, const ConcreteAttributePath & path,
-                             ClusterStateCache * cache)
+    void DecodeClusterObject(const AttributeInstruction & instruction, const ConcreteAttributePath & path, CacheType * cache)
     {
-        std::list<ClusterStateCache::AttributeStatus> statusList;
+        std::list<typename CacheType::AttributeStatus> statusList;
         NL_TEST_ASSERT(gSuite, cache->Get(path.mEndpointId, path.mClusterId, clusterValue, statusList) == CHIP_NO_ERROR);
 
         if (instruction.mValueType == AttributeInstruction::kData)
@@ -458,7 +467,7 @@ private:
         }
     }
 
-    void OnAttributeChanged(ClusterStateCache * cache, const ConcreteAttributePath & path) override
+    void OnAttributeChanged(CacheType * cache, const ConcreteAttributePath & path) override
     {
         StatusIB status;
 
@@ -486,14 +495,14 @@ private:
         }
     }
 
-    void OnClusterChanged(ClusterStateCache * cache, EndpointId endpointId, ClusterId clusterId) override
+    void OnClusterChanged(CacheType * cache, EndpointId endpointId, ClusterId clusterId) override
     {
         auto iter = mExpectedClusters.find(std::make_tuple(endpointId, clusterId));
         NL_TEST_ASSERT(gSuite, iter != mExpectedClusters.end());
         mExpectedClusters.erase(iter);
     }
 
-    void OnEndpointAdded(ClusterStateCache * cache, EndpointId endpointId) override
+    void OnEndpointAdded(CacheType * cache, EndpointId endpointId) override
     {
         auto iter = mExpectedEndpoints.find(endpointId);
         NL_TEST_ASSERT(gSuite, iter != mExpectedEndpoints.end());
@@ -519,8 +528,9 @@ private:
     ForwardedDataCallbackValidator & mDataCallbackValidator;
 };
 
-CacheValidator::CacheValidator(AttributeInstructionListType & instructionList,
-                               ForwardedDataCallbackValidator & dataCallbackValidator) :
+template <typename CacheType>
+CacheValidator<CacheType>::CacheValidator(AttributeInstructionListType & instructionList,
+                                          ForwardedDataCallbackValidator & dataCallbackValidator) :
     mDataCallbackValidator(dataCallbackValidator)
 {
     for (auto & instruction : instructionList)
@@ -538,11 +548,12 @@ CacheValidator::CacheValidator(AttributeInstructionListType & instructionList,
     }
 }
 
+template <typename CacheType>
 void RunAndValidateSequence(AttributeInstructionListType list)
 {
     ForwardedDataCallbackValidator dataCallbackValidator;
-    CacheValidator client(list, dataCallbackValidator);
-    ClusterStateCache cache(client);
+    CacheValidator<CacheType> client(list, dataCallbackValidator);
+    CacheType cache(client);
 
     // In order for the cache to track our data versions, we need to claim to it
     // that we are dealing with a wildcard path.  And we need to do that before
@@ -625,7 +636,8 @@ void RunAndValidateSequence(AttributeInstructionListType list)
  * E1:A1 --- Endpoint 1, Attribute A, Version 1
  *
  */
-void TestCache(nlTestSuite * apSuite, void * apContext)
+template <typename CacheType>
+void TestCacheSequences()
 {
     ChipLogProgress(DataManagement, "Validating various sequences of attribute data IBs...");
 
@@ -633,61 +645,388 @@ void TestCache(nlTestSuite * apSuite, void * apContext)
     // Validate a range of types and ensure that they can be successfully decoded.
     //
     ChipLogProgress(DataManagement, "E1:A1 --> E1:A1");
-    RunAndValidateSequence({ AttributeInstruction(
+    RunAndValidateSequence<CacheType>({ AttributeInstruction(
 
         AttributeInstruction::kAttributeA, 1, AttributeInstruction::kData) });
 
     ChipLogProgress(DataManagement, "E1:B1 --> E1:B1");
-    RunAndValidateSequence({ AttributeInstruction(
+    RunAndValidateSequence<CacheType>({ AttributeInstruction(
 
         AttributeInstruction::kAttributeB, 1, AttributeInstruction::kData) });
 
     ChipLogProgress(DataManagement, "E1:C1 --> E1:C1");
-    RunAndValidateSequence({ AttributeInstruction(AttributeInstruction::kAttributeC, 1, AttributeInstruction::kData) });
+    RunAndValidateSequence<CacheType>({ AttributeInstruction(AttributeInstruction::kAttributeC, 1, AttributeInstruction::kData) });
 
     ChipLogProgress(DataManagement, "E1:D1 --> E1:D1");
-    RunAndValidateSequence({ AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kData) });
+    RunAndValidateSequence<CacheType>({ AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kData) });
 
     //
     // Validate that a newer version of a data item over-rides the
     // previous copy.
     //
     ChipLogProgress(DataManagement, "E1:D1 E1:D2 --> E1:D2");
-    RunAndValidateSequence({ AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kData),
+    RunAndValidateSequence<CacheType>({ AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kData),
                              AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kData) });
 
     //
     // Validate that a newer StatusIB over-rides a previous data value.
     //
     ChipLogProgress(DataManagement, "E1:D1 E1:D2s --> E1:D2s");
-    RunAndValidateSequence({ AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kData),
+    RunAndValidateSequence<CacheType>({ AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kData),
                              AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kStatus) });
 
     //
     // Validate that a newer data value over-rides a previous status value.
     //
     ChipLogProgress(DataManagement, "E1:D1s E1:D2 --> E1:D2");
-    RunAndValidateSequence({ AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kStatus),
+    RunAndValidateSequence<CacheType>({ AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kStatus),
                              AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kData) });
 
     //
     // Validate data across different endpoints.
     //
     ChipLogProgress(DataManagement, "E0:D1 E1:D2 --> E0:D1 E1:D2");
-    RunAndValidateSequence({ AttributeInstruction(AttributeInstruction::kAttributeD, 0, AttributeInstruction::kData),
+    RunAndValidateSequence<CacheType>({ AttributeInstruction(AttributeInstruction::kAttributeD, 0, AttributeInstruction::kData),
                              AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kData) });
 
     ChipLogProgress(DataManagement, "E0:A1 E0:B2 E0:A3 E0:B4 --> E0:A3 E0:B4");
-    RunAndValidateSequence({ AttributeInstruction(AttributeInstruction::kAttributeA, 0, AttributeInstruction::kData),
+    RunAndValidateSequence<CacheType>({ AttributeInstruction(AttributeInstruction::kAttributeA, 0, AttributeInstruction::kData),
                              AttributeInstruction(AttributeInstruction::kAttributeB, 0, AttributeInstruction::kData),
                              AttributeInstruction(AttributeInstruction::kAttributeA, 0, AttributeInstruction::kData),
                              AttributeInstruction(AttributeInstruction::kAttributeB, 0, AttributeInstruction::kData) });
 }
 
+void TestCache(nlTestSuite * apSuite, void * apContext)
+{
+    TestCacheSequences<ClusterStateCache>();
+}
+
+void TestFlatCache(nlTestSuite * apSuite, void * apContext)
+{
+    TestCacheSequences<FlatClusterStateCache>();
+}
+
+template <typename CacheType>
+class NullCacheCallback : public CacheType::Callback
+{
+    void OnDone(ReadClient *) override {}
+};
+
+// Reports an octet string attribute value, its bytes all set to fill.
+void ReportOctetString(ReadClient::Callback & callback, const ConcreteAttributePath & attributePath, uint8_t fill, size_t size)
+{
+    uint8_t value[32];
+    uint8_t buf[64];
+    VerifyOrDie(size <= sizeof(value));
+    memset(value, fill, size);
+
+    TLV::TLVWriter writer;
+    writer.Init(buf);
+    NL_TEST_ASSERT(gSuite, writer.Put(TLV::AnonymousTag(), ByteSpan(value, size)) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(gSuite, writer.Finalize() == CHIP_NO_ERROR);
+
+    TLV::TLVReader reader;
+    reader.Init(buf, writer.GetLengthWritten());
+    NL_TEST_ASSERT(gSuite, reader.Next() == CHIP_NO_ERROR);
+
+    ConcreteDataAttributePath path(attributePath.mEndpointId, attributePath.mClusterId, attributePath.mAttributeId);
+    path.mDataVersion.SetValue(fill);
+    callback.OnAttributeData(path, &reader, StatusIB());
+}
+
+/*
+ * Reports octet string attribute values the way ReadClient does: the callback is handed the report buffer first, then
+ * readers into it positioned on the data of each AttributeDataIB. Returns the report buffer.
+ */
+System::PacketBufferHandle ReportOctetStringsInBuffer(ReadClient::Callback & callback,
+                                                      const std::vector<ConcreteAttributePath> & attributePaths, uint8_t fill,
+                                                      size_t size)
+{
+    uint8_t value[32];
+    VerifyOrDie(size <= sizeof(value));
+    memset(value, fill, size);
+
+    System::PacketBufferHandle buffer = System::PacketBufferHandle::New(System::PacketBuffer::kMaxSize);
+    VerifyOrDie(!buffer.IsNull());
+
+    System::PacketBufferTLVWriter writer;
+    TLV::TLVType reportsType;
+    TLV::TLVType dataType;
+    writer.Init(std::move(buffer));
+    NL_TEST_ASSERT(gSuite, writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Array, reportsType) == CHIP_NO_ERROR);
+    for (size_t i = 0; i < attributePaths.size(); i++)
+    {
+        NL_TEST_ASSERT(gSuite, writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, dataType) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(gSuite, writer.Put(TLV::ContextTag(AttributeDataIB::Tag::kData), ByteSpan(value, size)) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(gSuite, writer.EndContainer(dataType) == CHIP_NO_ERROR);
+    }
+    NL_TEST_ASSERT(gSuite, writer.EndContainer(reportsType) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(gSuite, writer.Finalize(&buffer) == CHIP_NO_ERROR);
+
+    callback.OnReportBuffer(buffer);
+
+    System::PacketBufferTLVReader reader;
+    reader.Init(buffer.Retain());
+    NL_TEST_ASSERT(gSuite, reader.Next() == CHIP_NO_ERROR && reader.EnterContainer(reportsType) == CHIP_NO_ERROR);
+    for (auto & attributePath : attributePaths)
+    {
+        NL_TEST_ASSERT(gSuite, reader.Next() == CHIP_NO_ERROR && reader.EnterContainer(dataType) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(gSuite, reader.Next() == CHIP_NO_ERROR);
+
+        TLV::TLVReader dataReader;
+        dataReader.Init(reader);
+        ConcreteDataAttributePath path(attributePath.mEndpointId, attributePath.mClusterId, attributePath.mAttributeId);
+        path.mDataVersion.SetValue(fill);
+        callback.OnAttributeData(path, &dataReader, StatusIB());
+
+        NL_TEST_ASSERT(gSuite, reader.ExitContainer(dataType) == CHIP_NO_ERROR);
+    }
+    return buffer;
+}
+
+template <typename CacheType>
+bool CachedOctetStringIs(const CacheType & cache, const ConcreteAttributePath & path, uint8_t fill, size_t size)
+{
+    TLV::TLVReader reader;
+    ByteSpan value;
+    VerifyOrReturnValue(cache.Get(path, reader) == CHIP_NO_ERROR && reader.Get(value) == CHIP_NO_ERROR, false);
+    VerifyOrReturnValue(value.size() == size, false);
+    for (auto byte : value)
+    {
+        VerifyOrReturnValue(byte == fill, false);
+    }
+    return true;
+}
+
+// Whether the cached value of path is read from within buffer.
+template <typename CacheType>
+bool CachedValueIsIn(const CacheType & cache, const ConcreteAttributePath & path, const System::PacketBufferHandle & buffer)
+{
+    TLV::TLVReader reader;
+    ByteSpan value;
+    VerifyOrReturnValue(cache.Get(path, reader) == CHIP_NO_ERROR && reader.Get(value) == CHIP_NO_ERROR, false);
+    return value.data() >= buffer->Start() && value.data() + value.size() <= buffer->Start() + buffer->DataLength();
+}
+
+/*
+ * Replaces attribute values over many reports, so that the flat storage arena gets compacted, and checks that both the
+ * values replaced and the ones left untouched are intact.
+ */
+void TestFlatCacheCompaction(nlTestSuite * apSuite, void * apContext)
+{
+    NullCacheCallback<FlatClusterStateCache> callback;
+    FlatClusterStateCache cache(callback);
+
+    const ConcreteAttributePath stable(1, Clusters::UnitTesting::Id, 1);
+    const ConcreteAttributePath changing(1, Clusters::UnitTesting::Id, 2);
+    const ConcreteAttributePath growing(2, Clusters::UnitTesting::Id, 1);
+
+    cache.GetBufferedCallback().OnReportBegin();
+    ReportOctetString(cache.GetBufferedCallback(), stable, 0xA5, 20);
+    cache.GetBufferedCallback().OnReportEnd();
+
+    for (uint8_t i = 0; i < 50; i++)
+    {
+        cache.GetBufferedCallback().OnReportBegin();
+        ReportOctetString(cache.GetBufferedCallback(), changing, i, 8);
+        ReportOctetString(cache.GetBufferedCallback(), growing, i, i % 32);
+        cache.GetBufferedCallback().OnReportEnd();
+
+        NL_TEST_ASSERT(apSuite, CachedOctetStringIs(cache, stable, 0xA5, 20));
+        NL_TEST_ASSERT(apSuite, CachedOctetStringIs(cache, changing, i, 8));
+        NL_TEST_ASSERT(apSuite, CachedOctetStringIs(cache, growing, i, i % 32));
+    }
+
+    // A status replaces the value.
+    cache.GetBufferedCallback().OnReportBegin();
+    cache.GetBufferedCallback().OnAttributeData(ConcreteDataAttributePath(changing.mEndpointId, changing.mClusterId,
+                                                                          changing.mAttributeId),
+                                                nullptr, StatusIB(Protocols::InteractionModel::Status::Failure));
+    cache.GetBufferedCallback().OnReportEnd();
+
+    TLV::TLVReader reader;
+    NL_TEST_ASSERT(apSuite, cache.Get(changing, reader) == CHIP_ERROR_IM_STATUS_CODE_RECEIVED);
+    NL_TEST_ASSERT(apSuite, CachedOctetStringIs(cache, stable, 0xA5, 20));
+    NL_TEST_ASSERT(apSuite, CachedOctetStringIs(cache, growing, 49, 49 % 32));
+}
+
+/*
+ * Checks that a FlatClusterStateCache retaining report buffers refers to the values in them, and lets go of a buffer
+ * once most of the values it holds have been replaced.
+ */
+void TestFlatCacheRetainedReports(nlTestSuite * apSuite, void * apContext)
+{
+    NullCacheCallback<FlatClusterStateCache> callback;
+    FlatClusterStateCache cache(callback);
+    ReadClient::Callback & readCallback = cache.GetBufferedCallback();
+    cache.SetRetainReportBuffers(true);
+
+    const ConcreteAttributePath a(1, Clusters::UnitTesting::Id, 1);
+    const ConcreteAttributePath b(1, Clusters::UnitTesting::Id, 2);
+    const ConcreteAttributePath c(1, Clusters::UnitTesting::Id, 3);
+
+    readCallback.OnReportBegin();
+    System::PacketBufferHandle first = ReportOctetStringsInBuffer(readCallback, { a, b, c }, 1, 8);
+    readCallback.OnReportEnd();
+
+    NL_TEST_ASSERT(apSuite, CachedOctetStringIs(cache, a, 1, 8) && CachedValueIsIn(cache, a, first));
+    NL_TEST_ASSERT(apSuite, CachedOctetStringIs(cache, b, 1, 8) && CachedValueIsIn(cache, b, first));
+    NL_TEST_ASSERT(apSuite, CachedOctetStringIs(cache, c, 1, 8) && CachedValueIsIn(cache, c, first));
+    NL_TEST_ASSERT(apSuite, !first.HasSoleOwnership());
+
+    // With one of its three values replaced, the first buffer is kept.
+    readCallback.OnReportBegin();
+    System::PacketBufferHandle second = ReportOctetStringsInBuffer(readCallback, { a }, 2, 8);
+    readCallback.OnReportEnd();
+
+    NL_TEST_ASSERT(apSuite, CachedOctetStringIs(cache, a, 2, 8) && CachedValueIsIn(cache, a, second));
+    NL_TEST_ASSERT(apSuite, CachedOctetStringIs(cache, c, 1, 8) && CachedValueIsIn(cache, c, first));
+    NL_TEST_ASSERT(apSuite, !first.HasSoleOwnership());
+
+    // With two of them replaced, it is released once the value left is copied out.
+    readCallback.OnReportBegin();
+    ReportOctetStringsInBuffer(readCallback, { b }, 3, 8);
+    readCallback.OnReportEnd();
+
+    NL_TEST_ASSERT(apSuite, first.HasSoleOwnership());
+    NL_TEST_ASSERT(apSuite, CachedOctetStringIs(cache, a, 2, 8));
+    NL_TEST_ASSERT(apSuite, CachedOctetStringIs(cache, b, 3, 8));
+    NL_TEST_ASSERT(apSuite, CachedOctetStringIs(cache, c, 1, 8) && !CachedValueIsIn(cache, c, first));
+
+    // A status replacing the only value in a buffer releases it as well.
+    readCallback.OnReportBegin();
+    readCallback.OnAttributeData(ConcreteDataAttributePath(a.mEndpointId, a.mClusterId, a.mAttributeId), nullptr,
+                                 StatusIB(Protocols::InteractionModel::Status::Failure));
+    readCallback.OnReportEnd();
+
+    TLV::TLVReader reader;
+    NL_TEST_ASSERT(apSuite, cache.Get(a, reader) == CHIP_ERROR_IM_STATUS_CODE_RECEIVED);
+    NL_TEST_ASSERT(apSuite, second.HasSoleOwnership());
+    NL_TEST_ASSERT(apSuite, CachedOctetStringIs(cache, b, 3, 8));
+    NL_TEST_ASSERT(apSuite, CachedOctetStringIs(cache, c, 1, 8));
+
+    // ClusterStateCache copies attribute values out all the same.
+    NullCacheCallback<ClusterStateCache> mapCallback;
+    ClusterStateCache mapCache(mapCallback);
+    mapCache.SetRetainReportBuffers(true);
+
+    mapCache.GetBufferedCallback().OnReportBegin();
+    System::PacketBufferHandle mapBuffer = ReportOctetStringsInBuffer(mapCache.GetBufferedCallback(), { a }, 4, 8);
+    mapCache.GetBufferedCallback().OnReportEnd();
+
+    NL_TEST_ASSERT(apSuite, CachedOctetStringIs(mapCache, a, 4, 8) && !CachedValueIsIn(mapCache, a, mapBuffer));
+    NL_TEST_ASSERT(apSuite, mapBuffer.HasSoleOwnership());
+}
+
+constexpr size_t kBenchNodes                = 16;
+constexpr EndpointId kBenchEndpoints        = 8;
+constexpr ClusterId kBenchClusters          = 12;
+constexpr AttributeId kBenchAttrs           = 16;
+constexpr size_t kBenchValueSize            = 12;
+constexpr uint8_t kBenchValueFill           = 0x5A;
+constexpr ClusterId kBenchClustersPerReport = 4;
+constexpr size_t kBenchLookupRounds         = 10;
+
+size_t HeapInUse()
+{
+#if defined(__GLIBC__)
+    return mallinfo2().uordblks;
+#else
+    return 0;
+#endif
+}
+
+/*
+ * Mirrors kBenchNodes nodes, and reports the heap taken by their caches along with the time to look up every
+ * cached attribute value.
+ */
+template <typename CacheType>
+void BenchCache(const char * name, bool retainReportBuffers = false)
+{
+    std::vector<std::unique_ptr<NullCacheCallback<CacheType>>> callbacks;
+    std::vector<std::unique_ptr<CacheType>> caches;
+
+    size_t heapBefore = HeapInUse();
+    uint64_t start    = System::SystemClock().GetMonotonicMicroseconds64().count();
+    for (size_t node = 0; node < kBenchNodes; node++)
+    {
+        callbacks.push_back(std::make_unique<NullCacheCallback<CacheType>>());
+        caches.push_back(std::make_unique<CacheType>(*callbacks.back()));
+        caches.back()->SetRetainReportBuffers(retainReportBuffers);
+        ReadClient::Callback & callback = caches.back()->GetBufferedCallback();
+
+        // Report messages are about full, each carrying the attributes of kBenchClustersPerReport clusters.
+        callback.OnReportBegin();
+        for (EndpointId endpoint = 0; endpoint < kBenchEndpoints; endpoint++)
+        {
+            std::vector<ConcreteAttributePath> paths;
+            for (ClusterId cluster = 0; cluster < kBenchClusters; cluster++)
+            {
+                for (AttributeId attribute = 0; attribute < kBenchAttrs; attribute++)
+                {
+                    paths.push_back(ConcreteAttributePath(endpoint, cluster, attribute));
+                }
+                if ((cluster + 1) % kBenchClustersPerReport == 0 || cluster + 1 == kBenchClusters)
+                {
+                    ReportOctetStringsInBuffer(callback, paths, kBenchValueFill, kBenchValueSize);
+                    paths.clear();
+                }
+            }
+        }
+        callback.OnReportEnd();
+    }
+    uint64_t filled = System::SystemClock().GetMonotonicMicroseconds64().count();
+    size_t heapUsed = HeapInUse() - heapBefore;
+
+    size_t lookups = 0;
+    for (size_t round = 0; round < kBenchLookupRounds; round++)
+    {
+        for (auto & cache : caches)
+        {
+            for (EndpointId endpoint = 0; endpoint < kBenchEndpoints; endpoint++)
+            {
+                for (ClusterId cluster = 0; cluster < kBenchClusters; cluster++)
+                {
+                    for (AttributeId attribute = 0; attribute < kBenchAttrs; attribute++)
+                    {
+                        ConcreteAttributePath path(endpoint, cluster, attribute);
+                        TLV::TLVReader reader;
+                        ByteSpan value;
+                        NL_TEST_ASSERT(gSuite, cache->Get(path, reader) == CHIP_NO_ERROR);
+                        NL_TEST_ASSERT(gSuite, reader.Get(value) == CHIP_NO_ERROR && value.size() == kBenchValueSize);
+                        lookups++;
+                    }
+                }
+            }
+        }
+    }
+    uint64_t end = System::SystemClock().GetMonotonicMicroseconds64().count();
+
+    size_t attributes = kBenchNodes * kBenchEndpoints * kBenchClusters * kBenchAttrs;
+    printf("  %-22s %7zu heap bytes/node, %5.1f bytes/attribute, fill %6.3f us/attribute, lookup %6.3f us\n", name,
+           heapUsed / kBenchNodes, static_cast<double>(heapUsed) / static_cast<double>(attributes),
+           static_cast<double>(filled - start) / static_cast<double>(attributes),
+           static_cast<double>(end - filled) / static_cast<double>(lookups));
+}
+
+void TestBenchmark(nlTestSuite * apSuite, void * apContext)
+{
+    printf("  %zu nodes of %u endpoints x %u clusters x %u attributes, %zu byte values\n", kBenchNodes,
+           static_cast<unsigned>(kBenchEndpoints), static_cast<unsigned>(kBenchClusters), static_cast<unsigned>(kBenchAttrs),
+           kBenchValueSize);
+    BenchCache<ClusterStateCache>("ClusterStateCache");
+    BenchCache<FlatClusterStateCache>("FlatClusterStateCache");
+    BenchCache<FlatClusterStateCache>("  retaining reports", true);
+}
+
 // clang-format off
 const nlTest sTests[] =
 {
     NL_TEST_DEF("TestCache", TestCache),
+    NL_TEST_DEF("TestFlatCache", TestFlatCache),
+    NL_TEST_DEF("TestFlatCacheCompaction", TestFlatCacheCompaction),
+    NL_TEST_DEF("TestFlatCacheRetainedReports", TestFlatCacheRetainedReports),
+    NL_TEST_DEF("TestBenchmark", TestBenchmark),
     NL_TEST_SENTINEL()
 };
 
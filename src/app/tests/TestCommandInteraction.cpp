@@ -245,6 +245,8 @@ public:
 
     static void TestCommandHandlerWithProcessReceivedEmptyDataMsg(nlTestSuite * apSuite, void * apContext);
     static void TestCommandHandlerRejectMultipleCommands(nlTestSuite * apSuite, void * apContext);
+    static void TestCommandSenderBatchedCommands(nlTestSuite * apSuite, void * apContext);
+    static void TestCommandHandlerChunkedResponses(nlTestSuite * apSuite, void * apContext);
 
 #if CONFIG_BUILD_FOR_HOST_UNIT_TEST
     static void TestCommandHandlerReleaseWithExchangeClosed(nlTestSuite * apSuite, void * apContext);
@@ -532,8 +534,10 @@ void TestCommandInteraction::TestCommandSenderWithSendCommand(nlTestSuite * apSu
     ctx.DrainAndServiceIO();
 
     GenerateInvokeResponse(apSuite, apContext, buf, kTestCommandIdWithData);
-    err = commandSender.ProcessInvokeResponse(std::move(buf));
+    bool moreChunkedMessages = true;
+    err                      = commandSender.ProcessInvokeResponse(std::move(buf), moreChunkedMessages);
     NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, !moreChunkedMessages);
 }
 
 void TestCommandInteraction::TestCommandHandlerWithSendEmptyCommand(nlTestSuite * apSuite, void * apContext)
@@ -569,8 +573,10 @@ void TestCommandInteraction::TestCommandSenderWithProcessReceivedMsg(nlTestSuite
     System::PacketBufferHandle buf = System::PacketBufferHandle::New(System::PacketBuffer::kMaxSize);
 
     GenerateInvokeResponse(apSuite, apContext, buf, kTestCommandIdWithData);
-    err = commandSender.ProcessInvokeResponse(std::move(buf));
+    bool moreChunkedMessages = true;
+    err                      = commandSender.ProcessInvokeResponse(std::move(buf), moreChunkedMessages);
     NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, !moreChunkedMessages);
 }
 
 void TestCommandInteraction::ValidateCommandHandlerWithSendCommand(nlTestSuite * apSuite, void * apContext, bool aNeedStatusCode)
@@ -1346,7 +1352,7 @@ void TestCommandInteraction::TestCommandHandlerRejectMultipleCommands(nlTestSuit
 
         commandSender.AllocateBuffer();
 
-        // CommandSender does not support sending multiple commands with public API, so we craft a message manaully.
+        // CommandSender always tags batched commands with a reference, so we craft a message without any manually.
         for (int i = 0; i < 2; i++)
         {
             InvokeRequests::Builder & invokeRequests = commandSender.mInvokeRequestBuilder.GetInvokeRequests();
@@ -1366,9 +1372,6 @@ void TestCommandInteraction::TestCommandHandlerRejectMultipleCommands(nlTestSuit
             NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == invokeRequest.EndOfCommandDataIB());
         }
 
-        NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == commandSender.mInvokeRequestBuilder.GetInvokeRequests().EndOfInvokeRequests());
-        NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == commandSender.mInvokeRequestBuilder.EndOfInvokeRequestMessage());
-
         commandSender.MoveToState(app::CommandSender::State::AddedCommand);
     }
 
@@ -1387,6 +1390,94 @@ void TestCommandInteraction::TestCommandHandlerRejectMultipleCommands(nlTestSuit
     NL_TEST_ASSERT(apSuite, ctx.GetExchangeManager().GetNumActiveExchanges() == 0);
 }
 
+void TestCommandInteraction::TestCommandSenderBatchedCommands(nlTestSuite * apSuite, void * apContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(apContext);
+    CHIP_ERROR err    = CHIP_NO_ERROR;
+
+    mockCommandSenderDelegate.ResetCounter();
+    app::CommandSender commandSender(&mockCommandSenderDelegate, &ctx.GetExchangeManager());
+
+    NL_TEST_ASSERT(apSuite, commandSender.SetRemoteMaxPathsPerInvoke(2) == CHIP_NO_ERROR);
+    AddInvokeRequestData(apSuite, apContext, &commandSender, kTestCommandIdWithData);
+    AddInvokeRequestData(apSuite, apContext, &commandSender, kTestCommandIdCommandSpecificResponse);
+    NL_TEST_ASSERT(apSuite, commandSender.GetCommandCount() == 2);
+
+    // The remote takes no more than two commands at once.
+    NL_TEST_ASSERT(apSuite, commandSender.PrepareCommand(MakeTestCommandPath()) == CHIP_ERROR_INCORRECT_STATE);
+
+    err = commandSender.SendCommandRequest(ctx.GetSessionBobToAlice());
+    NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR);
+
+    ctx.DrainAndServiceIO();
+
+    // A status response for the first command, and a response command for the second.
+    NL_TEST_ASSERT(apSuite,
+                   mockCommandSenderDelegate.onResponseCalledTimes == 2 && mockCommandSenderDelegate.onFinalCalledTimes == 1 &&
+                       mockCommandSenderDelegate.onErrorCalledTimes == 0);
+
+    NL_TEST_ASSERT(apSuite, GetNumActiveHandlerObjects() == 0);
+    NL_TEST_ASSERT(apSuite, ctx.GetExchangeManager().GetNumActiveExchanges() == 0);
+}
+
+void TestCommandInteraction::TestCommandHandlerChunkedResponses(nlTestSuite * apSuite, void * apContext)
+{
+    TestContext & ctx        = *static_cast<TestContext *>(apContext);
+    CHIP_ERROR err           = CHIP_NO_ERROR;
+    ConcreteCommandPath path = { kTestEndpointId, kTestClusterId, kTestCommandIdCommandSpecificResponse };
+    uint8_t payload[400]     = {};
+
+    app::CommandHandler commandHandler(&mockCommandHandlerDelegate);
+    TestExchangeDelegate delegate;
+    auto exchange = ctx.NewExchangeToAlice(&delegate, false);
+    commandHandler.mExchangeCtx.Grab(exchange);
+
+    auto addResponse = [&]() -> CHIP_ERROR {
+        ReturnErrorOnFailure(commandHandler.PrepareCommand(path));
+        ReturnErrorOnFailure(commandHandler.GetCommandDataIBTLVWriter()->Put(TLV::ContextTag(1), ByteSpan(payload)));
+        return commandHandler.FinishCommand();
+    };
+
+    // Add responses until they no longer fit in a single message, then retry the last one in a new chunk.
+    for (int i = 0; i < 10 && commandHandler.mChunks.IsNull(); i++)
+    {
+        err = addResponse();
+        if (err != CHIP_NO_ERROR)
+        {
+            NL_TEST_ASSERT(apSuite, commandHandler.RollbackResponseForRetry(err));
+            NL_TEST_ASSERT(apSuite, addResponse() == CHIP_NO_ERROR);
+        }
+    }
+    NL_TEST_ASSERT(apSuite, !commandHandler.mChunks.IsNull());
+
+    System::PacketBufferHandle commandPacket;
+    err = commandHandler.Finalize(commandPacket);
+    NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, !commandHandler.mChunks.IsNull());
+
+    // Every chunk but the last says more follow.
+    bool moreChunkedMessages = false;
+    System::PacketBufferTLVReader reader;
+    InvokeResponseMessage::Parser invokeResponseMessage;
+    reader.Init(std::move(commandPacket));
+    NL_TEST_ASSERT(apSuite, invokeResponseMessage.Init(reader) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, invokeResponseMessage.GetMoreChunkedMessages(&moreChunkedMessages) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, moreChunkedMessages);
+
+    reader.Init(commandHandler.mChunks.PopHead());
+    NL_TEST_ASSERT(apSuite, invokeResponseMessage.Init(reader) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, invokeResponseMessage.GetMoreChunkedMessages(&moreChunkedMessages) == CHIP_END_OF_TLV);
+    NL_TEST_ASSERT(apSuite, commandHandler.mChunks.IsNull());
+
+    //
+    // Ordinarily, the ExchangeContext will close itself upon sending the final message / error'ing out on a responder exchange
+    // when unwinding back from an OnMessageReceived callback. Since that isn't the case in this artificial setup here
+    // (where we created a responder exchange that's not responding to anything), we need
+    // to explicitly close it out. This is not expected in normal application logic.
+    //
+    exchange->Close();
+}
+
 #if CONFIG_BUILD_FOR_HOST_UNIT_TEST
 //
 // This test needs a special unit-test only API being exposed in ExchangeContext to be able to correctly simulate
@@ -1444,6 +1535,8 @@ const nlTest sTests[] =
     NL_TEST_DEF("TestCommandHandlerWithProcessReceivedNotExistCommand", chip::app::TestCommandInteraction::TestCommandHandlerWithProcessReceivedNotExistCommand),
     NL_TEST_DEF("TestCommandHandlerWithProcessReceivedEmptyDataMsg", chip::app::TestCommandInteraction::TestCommandHandlerWithProcessReceivedEmptyDataMsg),
     NL_TEST_DEF("TestCommandHandlerRejectMultipleCommands", chip::app::TestCommandInteraction::TestCommandHandlerRejectMultipleCommands),
+    NL_TEST_DEF("TestCommandSenderBatchedCommands", chip::app::TestCommandInteraction::TestCommandSenderBatchedCommands),
+    NL_TEST_DEF("TestCommandHandlerChunkedResponses", chip::app::TestCommandInteraction::TestCommandHandlerChunkedResponses),
 
 #if CONFIG_BUILD_FOR_HOST_UNIT_TEST
     NL_TEST_DEF("TestCommandHandlerReleaseWithExchangeClosed", chip::app::TestCommandInteraction::TestCommandHandlerReleaseWithExchangeClosed),
@@ -26,6 +26,7 @@
 #include <app/EventLoggingTypes.h>
 #include <app/EventManagement.h>
 #include <app/InteractionModelEngine.h>
+#include <app/MessageDef/EventReportIB.h>
 #include <app/tests/AppTestContext.h>
 #include <lib/core/CHIPCore.h>
 #include <lib/core/ErrorStr.h>
@@ -35,6 +36,7 @@
 #include <lib/support/CHIPCounter.h>
 #include <lib/support/CodeUtils.h>
 #include <lib/support/EnforceFormat.h>
+#include <lib/support/ScopedBuffer.h>
 #include <lib/support/UnitTestContext.h>
 #include <lib/support/UnitTestRegistration.h>
 #include <lib/support/logging/Constants.h>
@@ -170,7 +172,91 @@ static void CheckLogEventOverFlow(nlTestSuite * apSuite, void * apContext)
     }
 }
 
-const nlTest sTests[] = { NL_TEST_DEF("CheckLogEventOverFlow", CheckLogEventOverFlow), NL_TEST_SENTINEL() };
+struct FetchedEvents
+{
+    static constexpr size_t kMaxEvents = 256;
+
+    chip::EventNumber mEventNumbers[kMaxEvents];
+    size_t mCount = 0;
+};
+
+static CHIP_ERROR CollectEventNumber(const chip::TLV::TLVReader & aReader, size_t aDepth, void * apContext)
+{
+    FetchedEvents * events = static_cast<FetchedEvents *>(apContext);
+    chip::app::EventReportIB::Parser report;
+    chip::app::EventDataIB::Parser data;
+    VerifyOrReturnError(events->mCount < FetchedEvents::kMaxEvents, CHIP_ERROR_NO_MEMORY);
+    ReturnErrorOnFailure(report.Init(aReader));
+    ReturnErrorOnFailure(report.GetEventData(&data));
+    ReturnErrorOnFailure(data.GetEventNumber(&events->mEventNumbers[events->mCount]));
+    events->mCount++;
+    return CHIP_NO_ERROR;
+}
+
+static void FetchEvents(nlTestSuite * apSuite, chip::EventNumber aEventMin, FetchedEvents & aEvents, chip::EventNumber & aNextEventMin)
+{
+    chip::Platform::ScopedMemoryBuffer<uint8_t> backingStore;
+    constexpr size_t kBackingStoreSize = 8192;
+    VerifyOrDie(backingStore.Alloc(kBackingStoreSize));
+
+    chip::TLV::TLVWriter writer;
+    chip::app::ObjectList<chip::app::EventPathParams> wildcardPath;
+    size_t eventCount = 0;
+    writer.Init(backingStore.Get(), kBackingStoreSize);
+    aNextEventMin = aEventMin;
+    NL_TEST_ASSERT(apSuite,
+                   chip::app::EventManagement::GetInstance().FetchEventsSince(writer, &wildcardPath, aNextEventMin, eventCount,
+                                                                              chip::Access::SubjectDescriptor{}) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, writer.Finalize() == CHIP_NO_ERROR);
+
+    chip::TLV::TLVReader reader;
+    reader.Init(backingStore.Get(), writer.GetLengthWritten());
+    aEvents.mCount = 0;
+    CHIP_ERROR err = chip::TLV::Utilities::Iterate(reader, CollectEventNumber, &aEvents, false /* recurse */);
+    NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR || err == CHIP_END_OF_TLV);
+    NL_TEST_ASSERT(apSuite, aEvents.mCount == eventCount);
+}
+
+static void CheckFetchEventsSinceAfterOverFlow(nlTestSuite * apSuite, void * apContext)
+{
+    // The previous test overflowed every buffer: fetching from any event number, which starts reading in the middle of the
+    // buffers, must return the same events as fetching everything and dropping the older ones.
+    FetchedEvents allEvents;
+    chip::EventNumber nextEventMin = 0;
+    FetchEvents(apSuite, 0, allEvents, nextEventMin);
+    NL_TEST_ASSERT(apSuite, allEvents.mCount > 0);
+    VerifyOrReturn(allEvents.mCount > 0);
+
+    const chip::EventNumber lastEventNumber = allEvents.mEventNumbers[allEvents.mCount - 1];
+    NL_TEST_ASSERT(apSuite, nextEventMin == lastEventNumber + 1);
+
+    size_t firstExpected = 0;
+    for (chip::EventNumber eventMin = allEvents.mEventNumbers[0]; eventMin <= lastEventNumber + 1; eventMin++)
+    {
+        while (firstExpected < allEvents.mCount && allEvents.mEventNumbers[firstExpected] < eventMin)
+        {
+            firstExpected++;
+        }
+
+        FetchedEvents events;
+        FetchEvents(apSuite, eventMin, events, nextEventMin);
+        NL_TEST_ASSERT(apSuite, events.mCount == allEvents.mCount - firstExpected);
+        for (size_t i = 0; i < events.mCount && firstExpected + i < allEvents.mCount; i++)
+        {
+            NL_TEST_ASSERT(apSuite, events.mEventNumbers[i] == allEvents.mEventNumbers[firstExpected + i]);
+        }
+        NL_TEST_ASSERT(apSuite, nextEventMin == lastEventNumber + 1);
+    }
+}
+
+// clang-format off
+const nlTest sTests[] =
+{
+    NL_TEST_DEF("CheckLogEventOverFlow", CheckLogEventOverFlow),
+    NL_TEST_DEF("CheckFetchEventsSinceAfterOverFlow", CheckFetchEventsSinceAfterOverFlow),
+    NL_TEST_SENTINEL()
+};
+// clang-format on
 
 // clang-format off
 nlTestSuite sSuite =
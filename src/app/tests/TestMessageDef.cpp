@@ -752,6 +752,9 @@ void BuildCommandDataIB(nlTestSuite * apSuite, CommandDataIB::Builder & aCommand
         NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR);
     }
 
+    aCommandDataIBBuilder.Ref(1);
+    NL_TEST_ASSERT(apSuite, aCommandDataIBBuilder.GetError() == CHIP_NO_ERROR);
+
     aCommandDataIBBuilder.EndOfCommandDataIB();
     NL_TEST_ASSERT(apSuite, aCommandDataIBBuilder.GetError() == CHIP_NO_ERROR);
 }
@@ -783,6 +786,10 @@ void ParseCommandDataIB(nlTestSuite * apSuite, CommandDataIB::Parser & aCommandD
         err = reader.ExitContainer(container);
         NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR);
     }
+
+    uint16_t ref = 0;
+    err          = aCommandDataIBParser.GetRef(&ref);
+    NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR && ref == 1);
 }
 
 void BuildCommandStatusIB(nlTestSuite * apSuite, CommandStatusIB::Builder & aCommandStatusIBBuilder)
@@ -795,6 +802,9 @@ void BuildCommandStatusIB(nlTestSuite * apSuite, CommandStatusIB::Builder & aCom
     NL_TEST_ASSERT(apSuite, statusIBBuilder.GetError() == CHIP_NO_ERROR);
     BuildStatusIB(apSuite, statusIBBuilder);
 
+    aCommandStatusIBBuilder.Ref(1);
+    NL_TEST_ASSERT(apSuite, aCommandStatusIBBuilder.GetError() == CHIP_NO_ERROR);
+
     aCommandStatusIBBuilder.EndOfCommandStatusIB();
     NL_TEST_ASSERT(apSuite, aCommandStatusIBBuilder.GetError() == CHIP_NO_ERROR);
 }
@@ -812,6 +822,10 @@ void ParseCommandStatusIB(nlTestSuite * apSuite, CommandStatusIB::Parser & aComm
 
     err = aCommandStatusIBParser.GetErrorStatus(&statusParser);
     NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR);
+
+    uint16_t ref = 0;
+    err          = aCommandStatusIBParser.GetRef(&ref);
+    NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR && ref == 1);
 }
 
 void BuildWrongInvokeResponseIB(nlTestSuite * apSuite, InvokeResponseIB::Builder & aInvokeResponseIBBuilder)
@@ -954,6 +968,9 @@ void BuildInvokeResponseMessage(nlTestSuite * apSuite, chip::TLV::TLVWriter & aW
 
     BuildInvokeResponses(apSuite, invokeResponsesBuilder);
 
+    invokeResponseMessageBuilder.MoreChunkedMessages(true);
+    NL_TEST_ASSERT(apSuite, invokeResponseMessageBuilder.GetError() == CHIP_NO_ERROR);
+
     invokeResponseMessageBuilder.EndOfInvokeResponseMessage();
     NL_TEST_ASSERT(apSuite, invokeResponseMessageBuilder.GetError() == CHIP_NO_ERROR);
 }
@@ -968,6 +985,10 @@ void ParseInvokeResponseMessage(nlTestSuite * apSuite, chip::TLV::TLVReader & aR
     bool suppressResponse = false;
     invokeResponseMessageParser.GetSuppressResponse(&suppressResponse);
     NL_TEST_ASSERT(apSuite, suppressResponse == true);
+
+    bool moreChunkedMessages = false;
+    invokeResponseMessageParser.GetMoreChunkedMessages(&moreChunkedMessages);
+    NL_TEST_ASSERT(apSuite, moreChunkedMessages == true);
 #if CHIP_CONFIG_IM_PRETTY_PRINT
     invokeResponseMessageParser.PrettyPrint();
 #endif
@@ -38,6 +38,7 @@
 #include <messaging/Flags.h>
 
 #include <cinttypes>
+#include <cstdio>
 #include <nlunit-test.h>
 
 using TestContext = chip::Test::AppContext;
@@ -56,7 +57,9 @@ class TestReportingEngine
 public:
     static void TestBuildAndSendSingleReportData(nlTestSuite * apSuite, void * apContext);
     static void TestMergeOverlappedAttributePath(nlTestSuite * apSuite, void * apContext);
+    static void TestDirtySetLookup(nlTestSuite * apSuite, void * apContext);
     static void TestMergeAttributePathWhenDirtySetPoolExhausted(nlTestSuite * apSuite, void * apContext);
+    static void TestSetDirtyScaling(nlTestSuite * apSuite, void * apContext);
 
 private:
     static bool InsertToDirtySet(const AttributePathParams & aPath);
@@ -73,19 +76,21 @@ private:
         const int size                        = sizeof...(args);
         ExpectedDirtySetContent content[size] = { ExpectedDirtySetContent(args)... };
 
-        if (InteractionModelEngine::GetInstance()->GetReportingEngine().mGlobalDirtySet.ForEachActiveObject([&](auto * path) {
-                for (int i = 0; i < size; i++)
-                {
-                    if (static_cast<AttributePathParams>(content[i]) == static_cast<AttributePathParams>(*path))
+        if (InteractionModelEngine::GetInstance()->GetReportingEngine().mGlobalDirtySet.ForEachPath(
+                [&](const AttributePathParams & path, uint64_t generation) {
+                    for (int i = 0; i < size; i++)
                     {
-                        content[i].verified = true;
-                        return Loop::Continue;
+                        if (static_cast<AttributePathParams>(content[i]) == path)
+                        {
+                            content[i].verified = true;
+                            return Loop::Continue;
+                        }
                     }
-                }
-                ChipLogDetail(DataManagement, "Dirty path Endpoint %x Cluster %" PRIx32 ", Attribute %" PRIx32 " is not expected",
-                              path->mEndpointId, path->mClusterId, path->mAttributeId);
-                return Loop::Break;
-            }) == Loop::Break)
+                    ChipLogDetail(DataManagement,
+                                  "Dirty path Endpoint %x Cluster %" PRIx32 ", Attribute %" PRIx32 " is not expected",
+                                  path.mEndpointId, path.mClusterId, path.mAttributeId);
+                    return Loop::Break;
+                }) == Loop::Break)
         {
             return false;
         }
@@ -176,18 +181,15 @@ void TestReportingEngine::TestMergeOverlappedAttributePath(nlTestSuite * apSuite
                                                                     app::reporting::GetDefaultReportScheduler());
     NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR);
 
-    AttributePathParams * clusterInfo = InteractionModelEngine::GetInstance()->GetReportingEngine().mGlobalDirtySet.CreateObject();
-    clusterInfo->mEndpointId          = 1;
-    clusterInfo->mClusterId           = 1;
-    clusterInfo->mAttributeId         = 1;
+    NL_TEST_ASSERT(apSuite, InsertToDirtySet(AttributePathParams(1, 1, 1)));
 
     {
         AttributePathParams testClusterInfo;
         testClusterInfo.mEndpointId  = 1;
         testClusterInfo.mClusterId   = 1;
         testClusterInfo.mAttributeId = 3;
-        NL_TEST_ASSERT(apSuite,
-                       !InteractionModelEngine::GetInstance()->GetReportingEngine().MergeOverlappedAttributePath(testClusterInfo));
+        NL_TEST_ASSERT(apSuite, InsertToDirtySet(testClusterInfo));
+        NL_TEST_ASSERT(apSuite, VerifyDirtySetContent(AttributePathParams(1, 1, 1), AttributePathParams(1, 1, 3)));
     }
     {
         AttributePathParams testClusterInfo;
@@ -195,8 +197,8 @@ void TestReportingEngine::TestMergeOverlappedAttributePath(nlTestSuite * apSuite
         testClusterInfo.mClusterId   = 1;
         testClusterInfo.mAttributeId = 1;
         testClusterInfo.mListIndex   = 2;
-        NL_TEST_ASSERT(apSuite,
-                       InteractionModelEngine::GetInstance()->GetReportingEngine().MergeOverlappedAttributePath(testClusterInfo));
+        NL_TEST_ASSERT(apSuite, InsertToDirtySet(testClusterInfo));
+        NL_TEST_ASSERT(apSuite, VerifyDirtySetContent(AttributePathParams(1, 1, 1), AttributePathParams(1, 1, 3)));
     }
 
     {
@@ -204,17 +206,17 @@ void TestReportingEngine::TestMergeOverlappedAttributePath(nlTestSuite * apSuite
         testClusterInfo.mEndpointId  = 1;
         testClusterInfo.mClusterId   = 1;
         testClusterInfo.mAttributeId = kInvalidAttributeId;
-        NL_TEST_ASSERT(apSuite,
-                       InteractionModelEngine::GetInstance()->GetReportingEngine().MergeOverlappedAttributePath(testClusterInfo));
+        NL_TEST_ASSERT(apSuite, InsertToDirtySet(testClusterInfo));
+        NL_TEST_ASSERT(apSuite, VerifyDirtySetContent(AttributePathParams(EndpointId(1), ClusterId(1))));
     }
 
     {
         AttributePathParams testClusterInfo;
+        testClusterInfo.mEndpointId  = 1;
         testClusterInfo.mClusterId   = kInvalidClusterId;
         testClusterInfo.mAttributeId = kInvalidAttributeId;
-        NL_TEST_ASSERT(apSuite,
-                       InteractionModelEngine::GetInstance()->GetReportingEngine().MergeOverlappedAttributePath(testClusterInfo));
-        NL_TEST_ASSERT(apSuite, clusterInfo->mClusterId == kInvalidClusterId && clusterInfo->mAttributeId == kInvalidAttributeId);
+        NL_TEST_ASSERT(apSuite, InsertToDirtySet(testClusterInfo));
+        NL_TEST_ASSERT(apSuite, VerifyDirtySetContent(AttributePathParams(EndpointId(1), kInvalidClusterId)));
     }
 
     {
@@ -222,22 +224,91 @@ void TestReportingEngine::TestMergeOverlappedAttributePath(nlTestSuite * apSuite
         testClusterInfo.mEndpointId  = kInvalidEndpointId;
         testClusterInfo.mClusterId   = kInvalidClusterId;
         testClusterInfo.mAttributeId = kInvalidAttributeId;
-        NL_TEST_ASSERT(apSuite,
-                       InteractionModelEngine::GetInstance()->GetReportingEngine().MergeOverlappedAttributePath(testClusterInfo));
-        NL_TEST_ASSERT(apSuite,
-                       clusterInfo->mEndpointId == kInvalidEndpointId && clusterInfo->mClusterId == kInvalidClusterId &&
-                           clusterInfo->mAttributeId == kInvalidAttributeId);
+        NL_TEST_ASSERT(apSuite, InsertToDirtySet(testClusterInfo));
+        NL_TEST_ASSERT(apSuite, VerifyDirtySetContent(AttributePathParams()));
     }
     InteractionModelEngine::GetInstance()->GetReportingEngine().Shutdown();
 }
 
+void TestReportingEngine::TestDirtySetLookup(nlTestSuite * apSuite, void * apContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(apContext);
+    CHIP_ERROR err    = CHIP_NO_ERROR;
+    err               = InteractionModelEngine::GetInstance()->Init(&ctx.GetExchangeManager(), &ctx.GetFabricTable(),
+                                                                    app::reporting::GetDefaultReportScheduler());
+    NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR);
+
+    Engine & engine           = InteractionModelEngine::GetInstance()->GetReportingEngine();
+    DirtyPathIndex & dirtySet = engine.mGlobalDirtySet;
+    dirtySet.Clear();
+
+    engine.BumpDirtySetGeneration();
+    const uint64_t attributeGeneration = engine.GetDirtySetGeneration();
+    NL_TEST_ASSERT(apSuite, InsertToDirtySet(AttributePathParams(1, 1, 1)));
+    NL_TEST_ASSERT(apSuite, dirtySet.GetGeneration(ConcreteAttributePath(1, 1, 1)) == attributeGeneration);
+    NL_TEST_ASSERT(apSuite, dirtySet.GetGeneration(ConcreteAttributePath(1, 1, 3)) == 0);
+    NL_TEST_ASSERT(apSuite, dirtySet.GetGeneration(ConcreteAttributePath(1, 2, 1)) == 0);
+    NL_TEST_ASSERT(apSuite, dirtySet.GetGeneration(ConcreteAttributePath(2, 1, 1)) == 0);
+
+    // A list index does not make the path more specific: the whole attribute is dirty.
+    engine.BumpDirtySetGeneration();
+    const uint64_t listGeneration = engine.GetDirtySetGeneration();
+    NL_TEST_ASSERT(apSuite, InsertToDirtySet(AttributePathParams(1, 1, 1, 2)));
+    NL_TEST_ASSERT(apSuite, dirtySet.GetGeneration(ConcreteAttributePath(1, 1, 1)) == listGeneration);
+    NL_TEST_ASSERT(apSuite, dirtySet.Size() == 1);
+
+    engine.BumpDirtySetGeneration();
+    const uint64_t clusterGeneration = engine.GetDirtySetGeneration();
+    NL_TEST_ASSERT(apSuite, InsertToDirtySet(AttributePathParams(EndpointId(1), ClusterId(1))));
+    NL_TEST_ASSERT(apSuite, dirtySet.GetGeneration(ConcreteAttributePath(1, 1, 1)) == clusterGeneration);
+    NL_TEST_ASSERT(apSuite, dirtySet.GetGeneration(ConcreteAttributePath(1, 1, 3)) == clusterGeneration);
+    NL_TEST_ASSERT(apSuite, dirtySet.GetGeneration(ConcreteAttributePath(1, 2, 1)) == 0);
+    NL_TEST_ASSERT(apSuite, VerifyDirtySetContent(AttributePathParams(EndpointId(1), ClusterId(1))));
+
+    // Attributes marked dirty after their cluster keep their own, newer generation.
+    engine.BumpDirtySetGeneration();
+    const uint64_t wildcardEndpointGeneration = engine.GetDirtySetGeneration();
+    NL_TEST_ASSERT(apSuite, InsertToDirtySet(AttributePathParams(kInvalidEndpointId, 1, 3)));
+    NL_TEST_ASSERT(apSuite, dirtySet.GetGeneration(ConcreteAttributePath(1, 1, 3)) == wildcardEndpointGeneration);
+    NL_TEST_ASSERT(apSuite, dirtySet.GetGeneration(ConcreteAttributePath(7, 1, 3)) == wildcardEndpointGeneration);
+    NL_TEST_ASSERT(apSuite, dirtySet.GetGeneration(ConcreteAttributePath(1, 1, 1)) == clusterGeneration);
+
+    engine.BumpDirtySetGeneration();
+    const uint64_t endpointGeneration = engine.GetDirtySetGeneration();
+    NL_TEST_ASSERT(apSuite, InsertToDirtySet(AttributePathParams(EndpointId(2), kInvalidClusterId)));
+    NL_TEST_ASSERT(apSuite, dirtySet.GetGeneration(ConcreteAttributePath(2, 5, 5)) == endpointGeneration);
+    NL_TEST_ASSERT(apSuite, dirtySet.GetGeneration(ConcreteAttributePath(3, 5, 5)) == 0);
+
+    engine.BumpDirtySetGeneration();
+    const uint64_t allGeneration = engine.GetDirtySetGeneration();
+    NL_TEST_ASSERT(apSuite, InsertToDirtySet(AttributePathParams()));
+    NL_TEST_ASSERT(apSuite, dirtySet.GetGeneration(ConcreteAttributePath(3, 5, 5)) == allGeneration);
+    NL_TEST_ASSERT(apSuite, dirtySet.GetGeneration(ConcreteAttributePath(1, 1, 1)) == allGeneration);
+    NL_TEST_ASSERT(apSuite, VerifyDirtySetContent(AttributePathParams()));
+
+    // Attributes of the same cluster are tracked individually for as long as the pools have room.
+    dirtySet.Clear();
+    engine.BumpDirtySetGeneration();
+    for (AttributeId i = 1; i <= CHIP_IM_SERVER_MAX_NUM_DIRTY_SET; i++)
+    {
+        NL_TEST_ASSERT(apSuite, InsertToDirtySet(AttributePathParams(kTestEndpointId, kTestClusterId, i)));
+    }
+    NL_TEST_ASSERT(apSuite, dirtySet.Size() == CHIP_IM_SERVER_MAX_NUM_DIRTY_SET);
+    for (AttributeId i = 1; i <= CHIP_IM_SERVER_MAX_NUM_DIRTY_SET; i++)
+    {
+        NL_TEST_ASSERT(apSuite,
+                       dirtySet.GetGeneration(ConcreteAttributePath(kTestEndpointId, kTestClusterId, i)) ==
+                           engine.GetDirtySetGeneration());
+    }
+    NL_TEST_ASSERT(apSuite, dirtySet.GetGeneration(ConcreteAttributePath(kTestEndpointId, kTestClusterId, 0)) == 0);
+
+    engine.Shutdown();
+    NL_TEST_ASSERT(apSuite, dirtySet.IsEmpty());
+}
+
 bool TestReportingEngine::InsertToDirtySet(const AttributePathParams & aPath)
 {
-    auto path = InteractionModelEngine::GetInstance()->GetReportingEngine().mGlobalDirtySet.CreateObject();
-    VerifyOrReturnError(path != nullptr, false);
-    *path             = aPath;
-    path->mGeneration = InteractionModelEngine::GetInstance()->GetReportingEngine().GetDirtySetGeneration();
-    return true;
+    return InteractionModelEngine::GetInstance()->GetReportingEngine().InsertPathIntoDirtySet(aPath) == CHIP_NO_ERROR;
 }
 
 void TestReportingEngine::TestMergeAttributePathWhenDirtySetPoolExhausted(nlTestSuite * apSuite, void * apContext)
@@ -248,7 +319,7 @@ void TestReportingEngine::TestMergeAttributePathWhenDirtySetPoolExhausted(nlTest
                                                                     app::reporting::GetDefaultReportScheduler());
     NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR);
 
-    InteractionModelEngine::GetInstance()->GetReportingEngine().mGlobalDirtySet.ReleaseAll();
+    InteractionModelEngine::GetInstance()->GetReportingEngine().mGlobalDirtySet.Clear();
     InteractionModelEngine::GetInstance()->GetReportingEngine().BumpDirtySetGeneration();
 
     // Case 1: All dirty paths including the new one are under the same cluster.
@@ -263,7 +334,7 @@ void TestReportingEngine::TestMergeAttributePathWhenDirtySetPoolExhausted(nlTest
                            AttributePathParams(kTestEndpointId, kTestClusterId, CHIP_IM_SERVER_MAX_NUM_DIRTY_SET + 1)));
     NL_TEST_ASSERT(apSuite, VerifyDirtySetContent(AttributePathParams(kTestEndpointId, kTestClusterId)));
 
-    InteractionModelEngine::GetInstance()->GetReportingEngine().mGlobalDirtySet.ReleaseAll();
+    InteractionModelEngine::GetInstance()->GetReportingEngine().mGlobalDirtySet.Clear();
 
     // Case 2: All dirty paths including the new one are under the same endpoint.
     // -> Expected behavior: The dirty set is replaced by a wildcard cluster path under the same endpoint.
@@ -277,7 +348,7 @@ void TestReportingEngine::TestMergeAttributePathWhenDirtySetPoolExhausted(nlTest
                            AttributePathParams(kTestEndpointId, ClusterId(CHIP_IM_SERVER_MAX_NUM_DIRTY_SET + 1), 1)));
     NL_TEST_ASSERT(apSuite, VerifyDirtySetContent(AttributePathParams(kTestEndpointId, kInvalidClusterId)));
 
-    InteractionModelEngine::GetInstance()->GetReportingEngine().mGlobalDirtySet.ReleaseAll();
+    InteractionModelEngine::GetInstance()->GetReportingEngine().mGlobalDirtySet.Clear();
 
     // Case 3: All dirty paths including the new one are under the different endpoints.
     // -> Expected behavior: The dirty set is replaced by a wildcard endpoint.
@@ -291,7 +362,7 @@ void TestReportingEngine::TestMergeAttributePathWhenDirtySetPoolExhausted(nlTest
                            AttributePathParams(EndpointId(CHIP_IM_SERVER_MAX_NUM_DIRTY_SET + 1), 1, 1)));
     NL_TEST_ASSERT(apSuite, VerifyDirtySetContent(AttributePathParams()));
 
-    InteractionModelEngine::GetInstance()->GetReportingEngine().mGlobalDirtySet.ReleaseAll();
+    InteractionModelEngine::GetInstance()->GetReportingEngine().mGlobalDirtySet.Clear();
 
     // Case 4: All existing dirty paths are under the same cluster, the new path comes from another cluster.
     // -> Expected behavior: The existing paths are merged into one single wildcard attribute path. New path is inserted as-is.
@@ -307,7 +378,7 @@ void TestReportingEngine::TestMergeAttributePathWhenDirtySetPoolExhausted(nlTest
                    VerifyDirtySetContent(AttributePathParams(kTestEndpointId, kTestClusterId),
                                          AttributePathParams(kTestEndpointId + 1, kTestClusterId + 1, 1)));
 
-    InteractionModelEngine::GetInstance()->GetReportingEngine().mGlobalDirtySet.ReleaseAll();
+    InteractionModelEngine::GetInstance()->GetReportingEngine().mGlobalDirtySet.Clear();
 
     // Case 5: All existing dirty paths are under the same endpoint, the new path comes from another endpoint.
     // -> Expected behavior: The existing paths are merged into one single wildcard cluster path. New path is inserted as-is.
@@ -326,6 +397,116 @@ void TestReportingEngine::TestMergeAttributePathWhenDirtySetPoolExhausted(nlTest
     InteractionModelEngine::GetInstance()->GetReportingEngine().Shutdown();
 }
 
+void TestReportingEngine::TestSetDirtyScaling(nlTestSuite * apSuite, void * apContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(apContext);
+    CHIP_ERROR err    = CHIP_NO_ERROR;
+    err               = InteractionModelEngine::GetInstance()->Init(&ctx.GetExchangeManager(), &ctx.GetFabricTable(),
+                                                                    app::reporting::GetDefaultReportScheduler());
+    NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR);
+
+    // Subscribers to a bridge, each watching a few attributes spread over many dynamic endpoints. One subscriber in sixteen
+    // also watches a cluster on every endpoint.
+    constexpr size_t kSubscriberCounts[] = { 16, 64, 256 };
+    constexpr size_t kMaxSubscribers     = 256;
+    constexpr size_t kPathsPerSubscriber = 8;
+    constexpr size_t kChanges            = 20000;
+
+    Engine & engine                          = InteractionModelEngine::GetInstance()->GetReportingEngine();
+    Messaging::ExchangeContext * exchangeCtx = ctx.NewExchangeToAlice(nullptr, false);
+    DummyDelegate dummy;
+    ReadHandler * handlers[kMaxSubscribers] = {};
+
+    uint32_t seed = 1;
+    auto nextPath = [&seed]() {
+        seed       = seed * 1103515245u + 12345u;
+        uint32_t r = seed >> 8;
+        return AttributePathParams(static_cast<EndpointId>(1 + r % 256), static_cast<ClusterId>(6 + (r >> 8) % 4),
+                                   static_cast<AttributeId>((r >> 10) % 8));
+    };
+
+    auto nowMicroseconds = []() { return System::SystemClock().GetMonotonicMicroseconds64().count(); };
+
+    for (size_t count : kSubscriberCounts)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            handlers[i] = Platform::New<ReadHandler>(dummy, exchangeCtx, ReadHandler::InteractionType::Subscribe,
+                                                     app::reporting::GetDefaultReportScheduler());
+            for (size_t p = 0; p < kPathsPerSubscriber; p++)
+            {
+                AttributePathParams path = nextPath();
+                if (p == 0 && i % 16 == 0)
+                {
+                    path.SetWildcardEndpointId();
+                    path.SetWildcardAttributeId();
+                }
+                NL_TEST_ASSERT(apSuite,
+                               InteractionModelEngine::GetInstance()->PushFrontAttributePathList(handlers[i]->mpAttributePathList,
+                                                                                                 path) == CHIP_NO_ERROR);
+            }
+            NL_TEST_ASSERT(apSuite, engine.AddReadHandlerPaths(*handlers[i]) == CHIP_NO_ERROR);
+            handlers[i]->ClearStateFlag(ReadHandler::ReadHandlerFlags::PrimingReports);
+            handlers[i]->MoveToState(ReadHandler::HandlerState::CanStartReporting);
+        }
+        NL_TEST_ASSERT(apSuite, engine.mReadHandlerPathIndex.Size() == count * kPathsPerSubscriber);
+
+        // Find the subscribers interested in each change by checking every path of every subscriber, as SetDirty used to.
+        const uint32_t changesSeed = seed;
+        size_t scanMatches         = 0;
+        uint64_t start             = nowMicroseconds();
+        for (size_t n = 0; n < kChanges; n++)
+        {
+            const AttributePathParams changed = nextPath();
+            for (size_t i = 0; i < count; i++)
+            {
+                for (auto path = handlers[i]->GetAttributePathList(); path != nullptr; path = path->mpNext)
+                {
+                    scanMatches += path->mValue.Intersects(changed) ? 1 : 0;
+                }
+            }
+        }
+        const uint64_t scanTime = nowMicroseconds() - start;
+
+        // Same changes, through the index.
+        seed                = changesSeed;
+        size_t indexMatches = 0;
+        start               = nowMicroseconds();
+        for (size_t n = 0; n < kChanges; n++)
+        {
+            engine.mReadHandlerPathIndex.ForEachIntersectingHandler(nextPath(), [&indexMatches](ReadHandler *) { indexMatches++; });
+        }
+        const uint64_t indexTime = nowMicroseconds() - start;
+
+        NL_TEST_ASSERT(apSuite, scanMatches == indexMatches);
+        printf("  %zu subscribers: scan %" PRIu64 " ns/change, index %" PRIu64 " ns/change, %zu matches\n", count,
+               scanTime * 1000 / kChanges, indexTime * 1000 / kChanges, indexMatches);
+
+        // SetDirty only marks the subscribers with an intersecting path dirty, once each.
+        AttributePathParams changed = handlers[1]->GetAttributePathList()->mValue;
+        NL_TEST_ASSERT(apSuite, engine.SetDirty(changed) == CHIP_NO_ERROR);
+        for (size_t i = 0; i < count; i++)
+        {
+            bool interested = false;
+            for (auto path = handlers[i]->GetAttributePathList(); path != nullptr; path = path->mpNext)
+            {
+                interested = interested || path->mValue.Intersects(changed);
+            }
+            NL_TEST_ASSERT(apSuite, handlers[i]->IsDirty() == interested);
+        }
+
+        for (size_t i = 0; i < count; i++)
+        {
+            Platform::Delete(handlers[i]);
+            handlers[i] = nullptr;
+        }
+        NL_TEST_ASSERT(apSuite, engine.mReadHandlerPathIndex.Size() == 0);
+    }
+
+    exchangeCtx->Close();
+    engine.Shutdown();
+}
+
 } // namespace reporting
 } // namespace app
 } // namespace chip
@@ -336,7 +517,9 @@ const nlTest sTests[] =
 {
     NL_TEST_DEF("CheckBuildAndSendSingleReportData", chip::app::reporting::TestReportingEngine::TestBuildAndSendSingleReportData),
     NL_TEST_DEF("TestMergeOverlappedAttributePath", chip::app::reporting::TestReportingEngine::TestMergeOverlappedAttributePath),
+    NL_TEST_DEF("TestDirtySetLookup", chip::app::reporting::TestReportingEngine::TestDirtySetLookup),
     NL_TEST_DEF("TestMergeAttributePathWhenDirtySetPoolExhausted", chip::app::reporting::TestReportingEngine::TestMergeAttributePathWhenDirtySetPoolExhausted),
+    NL_TEST_DEF("TestSetDirtyScaling", chip::app::reporting::TestReportingEngine::TestSetDirtyScaling),
     NL_TEST_SENTINEL()
 };
 // clang-format on
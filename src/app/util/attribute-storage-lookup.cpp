@@ -0,0 +1,293 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app/util/attribute-storage-lookup.h>
+
+#include <app/att-storage.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+namespace chip {
+namespace app {
+
+namespace {
+
+constexpr uint64_t kEndpointKeyTag  = 1ull << 62;
+constexpr uint64_t kClusterKeyTag   = 2ull << 62;
+constexpr uint64_t kAttributeKeyTag = 3ull << 62;
+
+} // namespace
+
+uint64_t AttributeStorageLookupTable::SeedFor(uint8_t aAttempt)
+{
+    // Odd multipliers, so that the hash keeps every bit of the key.
+    return (0x9E3779B97F4A7C15ull + aAttempt * 0xD1B54A32D192ED03ull) | 1;
+}
+
+uint64_t AttributeStorageLookupTable::EndpointKey(EndpointId aEndpointId)
+{
+    return kEndpointKeyTag | aEndpointId;
+}
+
+uint64_t AttributeStorageLookupTable::ClusterKey(uint16_t aTypeIndex, ClusterId aClusterId)
+{
+    return kClusterKeyTag | (static_cast<uint64_t>(aTypeIndex) << 32) | aClusterId;
+}
+
+uint64_t AttributeStorageLookupTable::AttributeKey(uint16_t aTypeIndex, uint8_t aClusterIndex, AttributeId aAttributeId)
+{
+    return kAttributeKeyTag | (static_cast<uint64_t>(aTypeIndex) << 40) | (static_cast<uint64_t>(aClusterIndex) << 32) |
+        aAttributeId;
+}
+
+size_t AttributeStorageLookupTable::HomeOf(uint64_t aKey) const
+{
+    return static_cast<size_t>((aKey * mSeed) >> 32) & (kSize - 1);
+}
+
+const AttributeStorageLookupTable::Slot * AttributeStorageLookupTable::Find(uint64_t aKey) const
+{
+    // The table always keeps free slots, so the probe sequence ends.
+    for (size_t i = HomeOf(aKey);; i = (i + 1) & (kSize - 1))
+    {
+        if (mSlots[i].mKey == aKey)
+        {
+            return &mSlots[i];
+        }
+        if (mSlots[i].mKey == 0)
+        {
+            return nullptr;
+        }
+    }
+}
+
+AttributeStorageLookupTable::Slot * AttributeStorageLookupTable::Insert(uint64_t aKey, bool & aInserted)
+{
+    aInserted = false;
+    VerifyOrReturnValue(mUsable, nullptr);
+
+    size_t i = HomeOf(aKey);
+    for (; mSlots[i].mKey != 0; i = (i + 1) & (kSize - 1))
+    {
+        if (mSlots[i].mKey == aKey)
+        {
+            return &mSlots[i];
+        }
+    }
+
+    if (mUsed >= kMaxUsed)
+    {
+        ChipLogError(Zcl, "Attribute storage lookup table is full, falling back to linear lookups");
+        mUsable = false;
+        return nullptr;
+    }
+
+    mSlots[i].mKey = aKey;
+    mUsed++;
+    aInserted = true;
+    return &mSlots[i];
+}
+
+void AttributeStorageLookupTable::Clear()
+{
+    for (Slot & slot : mSlots)
+    {
+        slot.mKey = 0;
+    }
+    mUsed   = 0;
+    mUsable = (kSize > 0);
+}
+
+void AttributeStorageLookupTable::Build(const EmberAfDefinedEndpoint * aEndpoints, uint16_t aCount, uint16_t aFixedCount)
+{
+    mCount         = aCount;
+    mFixedDataSize = 0;
+    for (uint16_t i = 0; i < aFixedCount; i++)
+    {
+        mFixedDataSize = static_cast<uint16_t>(mFixedDataSize + aEndpoints[i].endpointType->endpointSize);
+    }
+
+    // Pick a seed under which the fixed endpoints do not collide. Fixed endpoints are inserted before anything else, so they
+    // keep their home slots.
+    for (uint8_t attempt = 0; attempt < kMaxSeedAttempts; attempt++)
+    {
+        Clear();
+        mSeed        = SeedFor(attempt);
+        bool perfect = true;
+        for (uint16_t i = 0; i < aFixedCount && perfect; i++)
+        {
+            bool inserted;
+            uint64_t key = EndpointKey(aEndpoints[i].endpoint);
+            Slot * slot  = Insert(key, inserted);
+            perfect      = (slot == nullptr) || !inserted || (slot == &mSlots[HomeOf(key)]);
+        }
+        if (perfect)
+        {
+            break;
+        }
+    }
+    Clear();
+
+    uint16_t dataOffset = 0;
+    for (uint16_t i = 0; i < aCount; i++)
+    {
+        AddEndpoint(aEndpoints, i, (i < aFixedCount) ? dataOffset : mFixedDataSize);
+        if (i < aFixedCount)
+        {
+            dataOffset = static_cast<uint16_t>(dataOffset + aEndpoints[i].endpointType->endpointSize);
+        }
+    }
+
+    for (uint16_t i = 0; i < aCount; i++)
+    {
+        if (aEndpoints[i].endpoint != kInvalidEndpointId && TypeIndexOf(aEndpoints, i) == i)
+        {
+            AddEndpointType(aEndpoints[i].endpointType, i);
+        }
+    }
+}
+
+void AttributeStorageLookupTable::AddDynamicEndpoint(const EmberAfDefinedEndpoint * aEndpoints, uint16_t aIndex)
+{
+    VerifyOrReturn(mUsable && aIndex < mCount && aEndpoints[aIndex].endpoint != kInvalidEndpointId);
+
+    AddEndpoint(aEndpoints, aIndex, mFixedDataSize);
+    if (TypeIndexOf(aEndpoints, aIndex) == aIndex)
+    {
+        AddEndpointType(aEndpoints[aIndex].endpointType, aIndex);
+    }
+}
+
+uint16_t AttributeStorageLookupTable::TypeIndexOf(const EmberAfDefinedEndpoint * aEndpoints, uint16_t aIndex) const
+{
+    // Endpoints only leave the table through a rebuild, so the first endpoint of a type was already the first one when it was
+    // added, and the entries of the type were filed under it then.
+    for (uint16_t i = 0; i < aIndex; i++)
+    {
+        if (aEndpoints[i].endpoint != kInvalidEndpointId && aEndpoints[i].endpointType == aEndpoints[aIndex].endpointType)
+        {
+            return i;
+        }
+    }
+    return aIndex;
+}
+
+void AttributeStorageLookupTable::AddEndpoint(const EmberAfDefinedEndpoint * aEndpoints, uint16_t aIndex, uint16_t aDataOffset)
+{
+    const EmberAfDefinedEndpoint & endpoint = aEndpoints[aIndex];
+    VerifyOrReturn(endpoint.endpoint != kInvalidEndpointId && endpoint.endpointType != nullptr);
+
+    bool inserted;
+    Slot * slot = Insert(EndpointKey(endpoint.endpoint), inserted);
+    VerifyOrReturn(slot != nullptr);
+    if (!inserted)
+    {
+        // The first definition wins in a linear scan, unless it is disabled: only the caller can tell.
+        if (slot->mValues[0] != aIndex)
+        {
+            slot->mValues[0] = kAmbiguousIndex;
+        }
+        return;
+    }
+    slot->mValues[0] = aIndex;
+    slot->mValues[1] = TypeIndexOf(aEndpoints, aIndex);
+    slot->mValues[2] = aDataOffset;
+}
+
+void AttributeStorageLookupTable::AddEndpointType(const EmberAfEndpointType * aEndpointType, uint16_t aTypeIndex)
+{
+    VerifyOrReturn(aEndpointType != nullptr);
+
+    uint8_t serverIndex        = 0;
+    uint16_t clusterDataOffset = 0;
+    for (uint8_t c = 0; c < aEndpointType->clusterCount; c++)
+    {
+        const EmberAfCluster & cluster = aEndpointType->cluster[c];
+        if (cluster.mask & CLUSTER_MASK_SERVER)
+        {
+            bool inserted;
+            Slot * slot = Insert(ClusterKey(aTypeIndex, cluster.clusterId), inserted);
+            VerifyOrReturn(slot != nullptr);
+            // A cluster listed twice is found at its first position, as in a linear scan.
+            if (inserted)
+            {
+                slot->mValues[0] = c;
+                slot->mValues[1] = serverIndex;
+                slot->mValues[2] = clusterDataOffset;
+
+                uint16_t attributeDataOffset = 0;
+                for (uint16_t a = 0; a < cluster.attributeCount; a++)
+                {
+                    const EmberAfAttributeMetadata & attribute = cluster.attributes[a];
+
+                    Slot * attributeSlot = Insert(AttributeKey(aTypeIndex, c, attribute.attributeId), inserted);
+                    VerifyOrReturn(attributeSlot != nullptr);
+                    if (inserted)
+                    {
+                        attributeSlot->mValues[0] = a;
+                        attributeSlot->mValues[1] = attributeDataOffset;
+                    }
+                    if (!attribute.IsExternal() && !attribute.IsSingleton())
+                    {
+                        attributeDataOffset = static_cast<uint16_t>(attributeDataOffset + attribute.size);
+                    }
+                }
+            }
+            serverIndex++;
+        }
+        clusterDataOffset = static_cast<uint16_t>(clusterDataOffset + cluster.clusterSize);
+    }
+}
+
+AttributeStorageLookupTable::Lookup AttributeStorageLookupTable::FindEndpoint(EndpointId aEndpointId, EndpointInfo & aInfo) const
+{
+    VerifyOrReturnValue(mUsable, Lookup::kUnknown);
+
+    const Slot * slot = Find(EndpointKey(aEndpointId));
+    VerifyOrReturnValue(slot != nullptr, Lookup::kNotFound);
+    VerifyOrReturnValue(slot->mValues[0] != kAmbiguousIndex, Lookup::kUnknown);
+
+    aInfo.mIndex      = slot->mValues[0];
+    aInfo.mTypeIndex  = slot->mValues[1];
+    aInfo.mDataOffset = slot->mValues[2];
+    return Lookup::kFound;
+}
+
+bool AttributeStorageLookupTable::FindServerCluster(uint16_t aTypeIndex, ClusterId aClusterId, ClusterInfo & aInfo) const
+{
+    const Slot * slot = Find(ClusterKey(aTypeIndex, aClusterId));
+    VerifyOrReturnValue(slot != nullptr, false);
+
+    aInfo.mClusterIndex = static_cast<uint8_t>(slot->mValues[0]);
+    aInfo.mServerIndex  = static_cast<uint8_t>(slot->mValues[1]);
+    aInfo.mDataOffset   = slot->mValues[2];
+    return true;
+}
+
+bool AttributeStorageLookupTable::FindAttribute(uint16_t aTypeIndex, uint8_t aClusterIndex, AttributeId aAttributeId,
+                                                AttributeInfo & aInfo) const
+{
+    const Slot * slot = Find(AttributeKey(aTypeIndex, aClusterIndex, aAttributeId));
+    VerifyOrReturnValue(slot != nullptr, false);
+
+    aInfo.mAttributeIndex = slot->mValues[0];
+    aInfo.mDataOffset     = slot->mValues[1];
+    return true;
+}
+
+} // namespace app
+} // namespace chip
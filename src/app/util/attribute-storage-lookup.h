@@ -0,0 +1,153 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <app/util/af-types.h>
+#include <lib/core/CHIPConfig.h>
+#include <lib/core/DataModelTypes.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace chip {
+namespace app {
+
+/**
+ * Hash index over the defined endpoints of attribute storage, which finds an endpoint by id, a server cluster of an endpoint
+ * by id and an attribute of such a cluster by id without scanning.
+ *
+ * All entries live in one open-addressed table with linear probing. Endpoints that share an endpoint type (typically bridged
+ * dynamic endpoints) share the entries of its clusters and attributes: those are filed under the index of the first endpoint
+ * of that type, its "type index". The hash seed is chosen when the table is built so that every fixed endpoint sits in its
+ * home slot, which makes the fixed endpoint lookup a perfect hash.
+ *
+ * Besides positions, entries record the offsets of attributes within the attribute data buffer, following the same layout as
+ * the linear scan in attribute storage does.
+ *
+ * When the table is disabled or full, or an endpoint id is defined more than once, lookups answer kUnknown and the caller must
+ * fall back to scanning.
+ */
+class AttributeStorageLookupTable
+{
+public:
+    enum class Lookup : uint8_t
+    {
+        kFound,
+        kNotFound,
+        kUnknown,
+    };
+
+    struct EndpointInfo
+    {
+        uint16_t mIndex;
+        uint16_t mTypeIndex;
+        // Offset of the endpoint attributes in the attribute data buffer.
+        uint16_t mDataOffset;
+    };
+
+    struct ClusterInfo
+    {
+        // Index of the cluster in the endpoint type.
+        uint8_t mClusterIndex;
+        // Index of the cluster among the server clusters of the endpoint type.
+        uint8_t mServerIndex;
+        // Offset of the cluster attributes from the endpoint ones in the attribute data buffer.
+        uint16_t mDataOffset;
+    };
+
+    struct AttributeInfo
+    {
+        uint16_t mAttributeIndex;
+        // Offset of the attribute from the cluster attributes in the attribute data buffer.
+        uint16_t mDataOffset;
+    };
+
+    /**
+     * Rebuild the table from the first aCount entries of aEndpoints, of which the first aFixedCount are fixed endpoints. Slots
+     * whose endpoint id is kInvalidEndpointId are skipped.
+     */
+    void Build(const EmberAfDefinedEndpoint * aEndpoints, uint16_t aCount, uint16_t aFixedCount);
+
+    /**
+     * Add the dynamic endpoint at aEndpoints[aIndex] to the table built from aEndpoints. Does nothing if it is already there.
+     */
+    void AddDynamicEndpoint(const EmberAfDefinedEndpoint * aEndpoints, uint16_t aIndex);
+
+    /**
+     * Find the endpoint aEndpointId, whether it is enabled or not.
+     */
+    Lookup FindEndpoint(EndpointId aEndpointId, EndpointInfo & aInfo) const;
+
+    /**
+     * Find the server cluster aClusterId of the endpoint type filed under aTypeIndex, as returned by FindEndpoint().
+     */
+    bool FindServerCluster(uint16_t aTypeIndex, ClusterId aClusterId, ClusterInfo & aInfo) const;
+
+    /**
+     * Find the attribute aAttributeId of the cluster at aClusterIndex in the endpoint type filed under aTypeIndex.
+     */
+    bool FindAttribute(uint16_t aTypeIndex, uint8_t aClusterIndex, AttributeId aAttributeId, AttributeInfo & aInfo) const;
+
+    size_t Size() const { return mUsed; }
+    bool IsUsable() const { return mUsable; }
+
+private:
+    friend class TestAttributeStorageLookupTable;
+
+    static constexpr size_t kSize = CHIP_CONFIG_ATTRIBUTE_STORAGE_LOOKUP_TABLE_SIZE;
+    static_assert((kSize & (kSize - 1)) == 0, "CHIP_CONFIG_ATTRIBUTE_STORAGE_LOOKUP_TABLE_SIZE must be zero or a power of two");
+
+    // Keep at least a quarter of the slots free, so that probe sequences stay short.
+    static constexpr size_t kMaxUsed = kSize - kSize / 4;
+
+    // Index stored for endpoint ids that are defined more than once.
+    static constexpr uint16_t kAmbiguousIndex = UINT16_MAX;
+
+    // Number of hash seeds tried to find one that puts every fixed endpoint in its home slot.
+    static constexpr uint8_t kMaxSeedAttempts = 16;
+
+    struct Slot
+    {
+        // Zero for a free slot; see the Key functions for the layout of the others.
+        uint64_t mKey;
+        uint16_t mValues[3];
+    };
+
+    static uint64_t SeedFor(uint8_t aAttempt);
+    static uint64_t EndpointKey(EndpointId aEndpointId);
+    static uint64_t ClusterKey(uint16_t aTypeIndex, ClusterId aClusterId);
+    static uint64_t AttributeKey(uint16_t aTypeIndex, uint8_t aClusterIndex, AttributeId aAttributeId);
+
+    size_t HomeOf(uint64_t aKey) const;
+    const Slot * Find(uint64_t aKey) const;
+    Slot * Insert(uint64_t aKey, bool & aInserted);
+    void Clear();
+    uint16_t TypeIndexOf(const EmberAfDefinedEndpoint * aEndpoints, uint16_t aIndex) const;
+    void AddEndpoint(const EmberAfDefinedEndpoint * aEndpoints, uint16_t aIndex, uint16_t aDataOffset);
+    void AddEndpointType(const EmberAfEndpointType * aEndpointType, uint16_t aTypeIndex);
+
+    Slot mSlots[kSize > 0 ? kSize : 1];
+    uint64_t mSeed          = 0;
+    size_t mUsed            = 0;
+    uint16_t mCount         = 0;
+    uint16_t mFixedDataSize = 0;
+    bool mUsable            = false;
+};
+
+} // namespace app
+} // namespace chip
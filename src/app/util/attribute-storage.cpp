@@ -17,9 +17,11 @@
 
 #include "app/util/common.h"
 #include <app/AttributePersistenceProvider.h>
+#include <app/ClusterInterfaceRegistry.h>
 #include <app/InteractionModelEngine.h>
 #include <app/reporting/reporting.h>
 #include <app/util/af.h>
+#include <app/util/attribute-storage-lookup.h>
 #include <app/util/attribute-storage.h>
 #include <app/util/config.h>
 #include <app/util/generic-callbacks.h>
@@ -67,6 +69,9 @@ uint8_t singletonAttributeData[ACTUAL_SINGLETONS_SIZE];
 
 uint16_t emberEndpointCount = 0;
 
+// Finds endpoints, server clusters and attributes without scanning emAfEndpoints; refreshed whenever an endpoint is defined.
+AttributeStorageLookupTable sLookupTable;
+
 // If we have attributes that are more than 4 bytes, then
 // we need this data block for the defaults
 #if (defined(GENERATED_DEFAULTS) && GENERATED_DEFAULTS_COUNT)
@@ -119,40 +124,14 @@ DataVersion fixedEndpointDataVersions[ZAP_FIXED_ENDPOINT_DATA_VERSION_COUNT];
 #define endpointTypeMacro(x) (&(generatedEmberAfEndpointTypes[fixedEmberAfEndpointTypes[x]]))
 #endif
 
-AttributeAccessInterface * gAttributeAccessOverrides = nullptr;
+ClusterInterfaceRegistry<AttributeAccessInterface> gAttributeAccessOverrides;
 
 // shouldUnregister returns true if the given AttributeAccessInterface should be
 // unregistered.
 template <typename F>
 void UnregisterMatchingAttributeAccessInterfaces(F shouldUnregister)
 {
-    AttributeAccessInterface * prev = nullptr;
-    AttributeAccessInterface * cur  = gAttributeAccessOverrides;
-    while (cur)
-    {
-        AttributeAccessInterface * next = cur->GetNext();
-        if (shouldUnregister(cur))
-        {
-            // Remove it from the list
-            if (prev)
-            {
-                prev->SetNext(next);
-            }
-            else
-            {
-                gAttributeAccessOverrides = next;
-            }
-
-            cur->SetNext(nullptr);
-
-            // Do not change prev in this case.
-        }
-        else
-        {
-            prev = cur;
-        }
-        cur = next;
-    }
+    gAttributeAccessOverrides.UnregisterMatching(shouldUnregister);
 }
 
 } // anonymous namespace
@@ -214,11 +193,18 @@ void emberAfEndpointConfigure()
         }
     }
 #endif
+
+    sLookupTable.Build(emAfEndpoints, emberEndpointCount, FIXED_ENDPOINT_COUNT);
 }
 
 void emberAfSetDynamicEndpointCount(uint16_t dynamicEndpointCount)
 {
-    emberEndpointCount = static_cast<uint16_t>(FIXED_ENDPOINT_COUNT + dynamicEndpointCount);
+    uint16_t endpointCount = static_cast<uint16_t>(FIXED_ENDPOINT_COUNT + dynamicEndpointCount);
+    if (endpointCount != emberEndpointCount)
+    {
+        emberEndpointCount = endpointCount;
+        sLookupTable.Build(emAfEndpoints, emberEndpointCount, FIXED_ENDPOINT_COUNT);
+    }
 }
 
 uint16_t emberAfGetDynamicIndexFromEndpoint(EndpointId id)
@@ -269,6 +255,10 @@ EmberAfStatus emberAfSetDynamicEndpoint(uint16_t index, EndpointId id, const Emb
         }
     }
 
+    // The lookup table can only drop the endpoint this one replaces, if any, by being rebuilt. Growing the endpoint count
+    // rebuilds it as well; otherwise the new endpoint is added in place, and the table is built once either way.
+    bool rebuildLookupTable = (emAfEndpoints[index].endpoint != kInvalidEndpointId) || (emberEndpointCount != MAX_ENDPOINT_COUNT);
+
     emAfEndpoints[index].endpoint       = id;
     emAfEndpoints[index].deviceTypeList = deviceTypeList;
     emAfEndpoints[index].endpointType   = ep;
@@ -277,7 +267,15 @@ EmberAfStatus emberAfSetDynamicEndpoint(uint16_t index, EndpointId id, const Emb
     emAfEndpoints[index].bitmask.Clear(EmberAfEndpointOptions::isEnabled);
     emAfEndpoints[index].parentEndpointId = parentEndpointId;
 
-    emberAfSetDynamicEndpointCount(MAX_ENDPOINT_COUNT - FIXED_ENDPOINT_COUNT);
+    emberEndpointCount = MAX_ENDPOINT_COUNT;
+    if (rebuildLookupTable)
+    {
+        sLookupTable.Build(emAfEndpoints, emberEndpointCount, FIXED_ENDPOINT_COUNT);
+    }
+    else
+    {
+        sLookupTable.AddDynamicEndpoint(emAfEndpoints, index);
+    }
 
     // Initialize the data versions.
     size_t dataSize = sizeof(DataVersion) * serverClusterCount;
@@ -308,6 +306,7 @@ EndpointId emberAfClearDynamicEndpoint(uint16_t index)
         ep = emAfEndpoints[index].endpoint;
         emberAfEndpointEnableDisable(ep, false);
         emAfEndpoints[index].endpoint = kInvalidEndpointId;
+        sLookupTable.Build(emAfEndpoints, emberEndpointCount, FIXED_ENDPOINT_COUNT);
     }
 
     return ep;
@@ -554,25 +553,47 @@ bool emAfMatchAttribute(const EmberAfCluster * cluster, const EmberAfAttributeMe
     return (am->attributeId == attRecord->attributeId);
 }
 
-// When reading non-string attributes, this function returns an error when destination
-// buffer isn't large enough to accommodate the attribute type.  For strings, the
-// function will copy at most readLength bytes.  This means the resulting string
-// may be truncated.  The length byte(s) in the resulting string will reflect
-// any truncation.  If readLength is zero, we are working with backwards-
-// compatibility wrapper functions and we just cross our fingers and hope for
-// the best.
-//
-// When writing attributes, readLength is ignored.  For non-string attributes,
-// this function assumes the source buffer is the same size as the attribute
-// type.  For strings, the function will copy as many bytes as will fit in the
-// attribute.  This means the resulting string may be truncated.  The length
-// byte(s) in the resulting string will reflect any truncated.
-EmberAfStatus emAfReadOrWriteAttribute(EmberAfAttributeSearchRecord * attRecord, const EmberAfAttributeMetadata ** metadata,
-                                       uint8_t * buffer, uint16_t readLength, bool write)
+// Finds the attribute of attRecord on an enabled endpoint, along with the index of that endpoint and the offset of the attribute
+// value in attributeData, which only means something for attributes of fixed endpoints that are neither external nor singletons.
+static EmberAfStatus findAttribute(EmberAfAttributeSearchRecord * attRecord, uint16_t & endpointIndex,
+                                   const EmberAfAttributeMetadata *& attribute, uint16_t & attributeOffsetIndex)
 {
-    assertChipStackLockedByCurrentThread();
+    AttributeStorageLookupTable::EndpointInfo endpointInfo;
+    switch (sLookupTable.FindEndpoint(attRecord->endpoint, endpointInfo))
+    {
+    case AttributeStorageLookupTable::Lookup::kFound: {
+        if (!emberAfEndpointIndexIsEnabled(endpointInfo.mIndex))
+        {
+            return EMBER_ZCL_STATUS_UNSUPPORTED_ENDPOINT;
+        }
+
+        AttributeStorageLookupTable::ClusterInfo clusterInfo;
+        if (!sLookupTable.FindServerCluster(endpointInfo.mTypeIndex, attRecord->clusterId, clusterInfo))
+        {
+            return EMBER_ZCL_STATUS_UNSUPPORTED_CLUSTER;
+        }
+
+        AttributeStorageLookupTable::AttributeInfo attributeInfo;
+        if (!sLookupTable.FindAttribute(endpointInfo.mTypeIndex, clusterInfo.mClusterIndex, attRecord->attributeId, attributeInfo))
+        {
+            return EMBER_ZCL_STATUS_UNSUPPORTED_ATTRIBUTE;
+        }
+
+        const EmberAfCluster * cluster = &(emAfEndpoints[endpointInfo.mIndex].endpointType->cluster[clusterInfo.mClusterIndex]);
+        endpointIndex                  = endpointInfo.mIndex;
+        attribute                      = &(cluster->attributes[attributeInfo.mAttributeIndex]);
+
+        attributeOffsetIndex =
+            static_cast<uint16_t>(endpointInfo.mDataOffset + clusterInfo.mDataOffset + attributeInfo.mDataOffset);
+        return EMBER_ZCL_STATUS_SUCCESS;
+    }
+    case AttributeStorageLookupTable::Lookup::kNotFound:
+        return EMBER_ZCL_STATUS_UNSUPPORTED_ENDPOINT;
+    case AttributeStorageLookupTable::Lookup::kUnknown:
+        break;
+    }
 
-    uint16_t attributeOffsetIndex = 0;
+    attributeOffsetIndex = 0;
 
     for (uint16_t ep = 0; ep < emberAfEndpointCount(); ep++)
     {
@@ -598,68 +619,16 @@ EmberAfStatus emAfReadOrWriteAttribute(EmberAfAttributeSearchRecord * attRecord,
                         const EmberAfAttributeMetadata * am = &(cluster->attributes[attrIndex]);
                         if (emAfMatchAttribute(cluster, am, attRecord))
                         { // Got the attribute
-                            // If passed metadata location is not null, populate
-                            if (metadata != nullptr)
-                            {
-                                *metadata = am;
-                            }
-
-                            {
-                                uint8_t * attributeLocation =
-                                    (am->mask & ATTRIBUTE_MASK_SINGLETON ? singletonAttributeLocation(am)
-                                                                         : attributeData + attributeOffsetIndex);
-                                uint8_t *src, *dst;
-                                if (write)
-                                {
-                                    src = buffer;
-                                    dst = attributeLocation;
-                                    if (!emberAfAttributeWriteAccessCallback(attRecord->endpoint, attRecord->clusterId,
-                                                                             am->attributeId))
-                                    {
-                                        return EMBER_ZCL_STATUS_UNSUPPORTED_ACCESS;
-                                    }
-                                }
-                                else
-                                {
-                                    if (buffer == nullptr)
-                                    {
-                                        return EMBER_ZCL_STATUS_SUCCESS;
-                                    }
-
-                                    src = attributeLocation;
-                                    dst = buffer;
-                                    if (!emberAfAttributeReadAccessCallback(attRecord->endpoint, attRecord->clusterId,
-                                                                            am->attributeId))
-                                    {
-                                        return EMBER_ZCL_STATUS_UNSUPPORTED_ACCESS;
-                                    }
-                                }
-
-                                // Is the attribute externally stored?
-                                if (am->mask & ATTRIBUTE_MASK_EXTERNAL_STORAGE)
-                                {
-                                    return (write ? emberAfExternalAttributeWriteCallback(attRecord->endpoint, attRecord->clusterId,
-                                                                                          am, buffer)
-                                                  : emberAfExternalAttributeReadCallback(attRecord->endpoint, attRecord->clusterId,
-                                                                                         am, buffer, emberAfAttributeSize(am)));
-                                }
-
-                                // Internal storage is only supported for fixed endpoints
-                                if (!isDynamicEndpoint)
-                                {
-                                    return typeSensitiveMemCopy(attRecord->clusterId, dst, src, am, write, readLength);
-                                }
-
-                                return EMBER_ZCL_STATUS_FAILURE;
-                            }
+                            endpointIndex = ep;
+                            attribute     = am;
+                            return EMBER_ZCL_STATUS_SUCCESS;
                         }
-                        else
-                        { // Not the attribute we are looking for
-                            // Increase the index if attribute is not externally stored
-                            if (!(am->mask & ATTRIBUTE_MASK_EXTERNAL_STORAGE) && !(am->mask & ATTRIBUTE_MASK_SINGLETON))
-                            {
-                                attributeOffsetIndex = static_cast<uint16_t>(attributeOffsetIndex + emberAfAttributeSize(am));
-                            }
+
+                        // Not the attribute we are looking for
+                        // Increase the index if attribute is not externally stored
+                        if (!(am->mask & ATTRIBUTE_MASK_EXTERNAL_STORAGE) && !(am->mask & ATTRIBUTE_MASK_SINGLETON))
+                        {
+                            attributeOffsetIndex = static_cast<uint16_t>(attributeOffsetIndex + emberAfAttributeSize(am));
                         }
                     }
 
@@ -685,6 +654,87 @@ EmberAfStatus emAfReadOrWriteAttribute(EmberAfAttributeSearchRecord * attRecord,
     return EMBER_ZCL_STATUS_UNSUPPORTED_ENDPOINT; // Sorry, endpoint was not found.
 }
 
+// When reading non-string attributes, this function returns an error when destination
+// buffer isn't large enough to accommodate the attribute type.  For strings, the
+// function will copy at most readLength bytes.  This means the resulting string
+// may be truncated.  The length byte(s) in the resulting string will reflect
+// any truncation.  If readLength is zero, we are working with backwards-
+// compatibility wrapper functions and we just cross our fingers and hope for
+// the best.
+//
+// When writing attributes, readLength is ignored.  For non-string attributes,
+// this function assumes the source buffer is the same size as the attribute
+// type.  For strings, the function will copy as many bytes as will fit in the
+// attribute.  This means the resulting string may be truncated.  The length
+// byte(s) in the resulting string will reflect any truncated.
+EmberAfStatus emAfReadOrWriteAttribute(EmberAfAttributeSearchRecord * attRecord, const EmberAfAttributeMetadata ** metadata,
+                                       uint8_t * buffer, uint16_t readLength, bool write)
+{
+    assertChipStackLockedByCurrentThread();
+
+    uint16_t ep                         = kEmberInvalidEndpointIndex;
+    const EmberAfAttributeMetadata * am = nullptr;
+    uint16_t attributeOffsetIndex       = 0;
+
+    EmberAfStatus status = findAttribute(attRecord, ep, am, attributeOffsetIndex);
+    if (status != EMBER_ZCL_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    // Is this a dynamic endpoint?
+    bool isDynamicEndpoint = (ep >= emberAfFixedEndpointCount());
+
+    // If passed metadata location is not null, populate
+    if (metadata != nullptr)
+    {
+        *metadata = am;
+    }
+
+    uint8_t * attributeLocation =
+        (am->mask & ATTRIBUTE_MASK_SINGLETON ? singletonAttributeLocation(am) : attributeData + attributeOffsetIndex);
+    uint8_t *src, *dst;
+    if (write)
+    {
+        src = buffer;
+        dst = attributeLocation;
+        if (!emberAfAttributeWriteAccessCallback(attRecord->endpoint, attRecord->clusterId, am->attributeId))
+        {
+            return EMBER_ZCL_STATUS_UNSUPPORTED_ACCESS;
+        }
+    }
+    else
+    {
+        if (buffer == nullptr)
+        {
+            return EMBER_ZCL_STATUS_SUCCESS;
+        }
+
+        src = attributeLocation;
+        dst = buffer;
+        if (!emberAfAttributeReadAccessCallback(attRecord->endpoint, attRecord->clusterId, am->attributeId))
+        {
+            return EMBER_ZCL_STATUS_UNSUPPORTED_ACCESS;
+        }
+    }
+
+    // Is the attribute externally stored?
+    if (am->mask & ATTRIBUTE_MASK_EXTERNAL_STORAGE)
+    {
+        return (write ? emberAfExternalAttributeWriteCallback(attRecord->endpoint, attRecord->clusterId, am, buffer)
+                      : emberAfExternalAttributeReadCallback(attRecord->endpoint, attRecord->clusterId, am, buffer,
+                                                             emberAfAttributeSize(am)));
+    }
+
+    // Internal storage is only supported for fixed endpoints
+    if (!isDynamicEndpoint)
+    {
+        return typeSensitiveMemCopy(attRecord->clusterId, dst, src, am, write, readLength);
+    }
+
+    return EMBER_ZCL_STATUS_FAILURE;
+}
+
 const EmberAfEndpointType * emberAfFindEndpointType(chip::EndpointId endpointId)
 {
     uint16_t ep = emberAfIndexFromEndpoint(endpointId);
@@ -725,8 +775,49 @@ const EmberAfCluster * emberAfFindClusterInType(const EmberAfEndpointType * endp
     return nullptr;
 }
 
+// Finds the server cluster clusterId on the endpoint at index epIndex, and its index among the server clusters of the endpoint.
+static const EmberAfCluster * findServerClusterFromIndex(uint16_t epIndex, ClusterId clusterId, uint8_t * index = nullptr)
+{
+    const EmberAfDefinedEndpoint & definedEndpoint = emAfEndpoints[epIndex];
+
+    AttributeStorageLookupTable::EndpointInfo endpointInfo;
+    if (sLookupTable.FindEndpoint(definedEndpoint.endpoint, endpointInfo) == AttributeStorageLookupTable::Lookup::kFound &&
+        endpointInfo.mIndex == epIndex)
+    {
+        AttributeStorageLookupTable::ClusterInfo clusterInfo;
+        if (!sLookupTable.FindServerCluster(endpointInfo.mTypeIndex, clusterId, clusterInfo))
+        {
+            return nullptr;
+        }
+        if (index)
+        {
+            *index = clusterInfo.mServerIndex;
+        }
+        return &(definedEndpoint.endpointType->cluster[clusterInfo.mClusterIndex]);
+    }
+
+    return emberAfFindClusterInType(definedEndpoint.endpointType, clusterId, CLUSTER_MASK_SERVER, index);
+}
+
 uint8_t emberAfClusterIndex(EndpointId endpoint, ClusterId clusterId, EmberAfClusterMask mask)
 {
+    AttributeStorageLookupTable::EndpointInfo endpointInfo;
+    switch (sLookupTable.FindEndpoint(endpoint, endpointInfo))
+    {
+    case AttributeStorageLookupTable::Lookup::kFound:
+        if (mask == CLUSTER_MASK_SERVER)
+        {
+            uint8_t index = 0xFF;
+            findServerClusterFromIndex(endpointInfo.mIndex, clusterId, &index);
+            return index;
+        }
+        break;
+    case AttributeStorageLookupTable::Lookup::kNotFound:
+        return 0xFF;
+    case AttributeStorageLookupTable::Lookup::kUnknown:
+        break;
+    }
+
     for (uint16_t ep = 0; ep < emberAfEndpointCount(); ep++)
     {
         // Check the endpoint id first, because that way we avoid examining the
@@ -770,7 +861,7 @@ bool emberAfContainsServerFromIndex(uint16_t index, ClusterId clusterId)
         return false;
     }
 
-    return emberAfFindClusterInType(emAfEndpoints[index].endpointType, clusterId, CLUSTER_MASK_SERVER);
+    return findServerClusterFromIndex(index, clusterId);
 }
 
 namespace chip {
@@ -815,7 +906,7 @@ const EmberAfCluster * emberAfFindServerCluster(EndpointId endpoint, ClusterId c
         return nullptr;
     }
 
-    return emberAfFindClusterInType(emAfEndpoints[ep].endpointType, clusterId, CLUSTER_MASK_SERVER);
+    return findServerClusterFromIndex(ep, clusterId);
 }
 
 // Returns cluster within the endpoint; Does not ignore disabled endpoints
@@ -837,6 +928,21 @@ static uint16_t findIndexFromEndpoint(EndpointId endpoint, bool ignoreDisabledEn
         return kEmberInvalidEndpointIndex;
     }
 
+    AttributeStorageLookupTable::EndpointInfo endpointInfo;
+    switch (sLookupTable.FindEndpoint(endpoint, endpointInfo))
+    {
+    case AttributeStorageLookupTable::Lookup::kFound:
+        if (ignoreDisabledEndpoints && !emAfEndpoints[endpointInfo.mIndex].bitmask.Has(EmberAfEndpointOptions::isEnabled))
+        {
+            return kEmberInvalidEndpointIndex;
+        }
+        return endpointInfo.mIndex;
+    case AttributeStorageLookupTable::Lookup::kNotFound:
+        return kEmberInvalidEndpointIndex;
+    case AttributeStorageLookupTable::Lookup::kUnknown:
+        break;
+    }
+
     uint16_t epi;
     for (epi = 0; epi < emberAfEndpointCount(); epi++)
     {
@@ -860,7 +966,7 @@ uint16_t emberAfGetClusterServerEndpointIndex(EndpointId endpoint, ClusterId clu
         return kEmberInvalidEndpointIndex;
     }
 
-    if (emberAfFindClusterInType(emAfEndpoints[epIndex].endpointType, cluster, CLUSTER_MASK_SERVER) == nullptr)
+    if (findServerClusterFromIndex(epIndex, cluster) == nullptr)
     {
         // The provided endpoint does not contain the given cluster server.
         return kEmberInvalidEndpointIndex;
@@ -875,8 +981,7 @@ uint16_t emberAfGetClusterServerEndpointIndex(EndpointId endpoint, ClusterId clu
         {
             // Increase adjustedEndpointIndex for every endpoint containing the cluster server
             // before our endpoint of interest
-            if (emAfEndpoints[i].endpoint != kInvalidEndpointId &&
-                (emberAfFindClusterInType(emAfEndpoints[i].endpointType, cluster, CLUSTER_MASK_SERVER) != nullptr))
+            if (emAfEndpoints[i].endpoint != kInvalidEndpointId && (findServerClusterFromIndex(i, cluster) != nullptr))
             {
                 adjustedEndpointIndex++;
             }
@@ -1413,37 +1518,24 @@ EmberAfGenericClusterFunction emberAfFindClusterFunction(const EmberAfCluster *
 
 bool registerAttributeAccessOverride(AttributeAccessInterface * attrOverride)
 {
-    for (auto * cur = gAttributeAccessOverrides; cur; cur = cur->GetNext())
+    if (!gAttributeAccessOverrides.Register(*attrOverride))
     {
-        if (cur->Matches(*attrOverride))
-        {
-            ChipLogError(Zcl, "Duplicate attribute override registration failed");
-            return false;
-        }
+        ChipLogError(Zcl, "Duplicate attribute override registration failed");
+        return false;
     }
-    attrOverride->SetNext(gAttributeAccessOverrides);
-    gAttributeAccessOverrides = attrOverride;
     return true;
 }
 
 void unregisterAttributeAccessOverride(AttributeAccessInterface * attrOverride)
 {
-    UnregisterMatchingAttributeAccessInterfaces([attrOverride](AttributeAccessInterface * entry) { return entry == attrOverride; });
+    gAttributeAccessOverrides.Unregister(*attrOverride);
 }
 
 namespace chip {
 namespace app {
 app::AttributeAccessInterface * GetAttributeAccessOverride(EndpointId endpointId, ClusterId clusterId)
 {
-    for (app::AttributeAccessInterface * cur = gAttributeAccessOverrides; cur; cur = cur->GetNext())
-    {
-        if (cur->Matches(endpointId, clusterId))
-        {
-            return cur;
-        }
-    }
-
-    return nullptr;
+    return gAttributeAccessOverrides.Find(endpointId, clusterId);
 }
 
 CHIP_ERROR SetParentEndpointForEndpoint(EndpointId childEndpoint, EndpointId parentEndpoint)
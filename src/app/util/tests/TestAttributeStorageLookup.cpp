@@ -0,0 +1,399 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app-common/zap-generated/attribute-type.h>
+#include <app/att-storage.h>
+#include <app/util/attribute-storage-lookup.h>
+#include <app/util/endpoint-config-defines.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/UnitTestRegistration.h>
+
+#include <nlunit-test.h>
+
+using namespace chip;
+using namespace chip::app;
+
+namespace {
+
+using Lookup = AttributeStorageLookupTable::Lookup;
+
+// Data offsets of the attributes below: external and singleton attributes take no room in the cluster data.
+const EmberAfAttributeMetadata kOnOffAttributes[] = {
+    { ZAP_EMPTY_DEFAULT(), 0x0000, 1, ZAP_TYPE(BOOLEAN), 0 },                                   // offset 0
+    { ZAP_EMPTY_DEFAULT(), 0x4000, 2, ZAP_TYPE(INT16U), ZAP_ATTRIBUTE_MASK(EXTERNAL_STORAGE) }, // offset 1
+    { ZAP_EMPTY_DEFAULT(), 0x4001, 4, ZAP_TYPE(INT32U), 0 },                                    // offset 1
+    { ZAP_EMPTY_DEFAULT(), 0x4002, 2, ZAP_TYPE(INT16U), ZAP_ATTRIBUTE_MASK(SINGLETON) },        // offset 5
+    { ZAP_EMPTY_DEFAULT(), 0xFFFD, 2, ZAP_TYPE(INT16U), 0 },                                    // offset 5
+    { ZAP_EMPTY_DEFAULT(), 0x4001, 1, ZAP_TYPE(INT8U), 0 },                                     // duplicate, offset 7
+};
+
+const EmberAfAttributeMetadata kLevelAttributes[] = {
+    { ZAP_EMPTY_DEFAULT(), 0x0000, 1, ZAP_TYPE(INT8U), 0 },
+    { ZAP_EMPTY_DEFAULT(), 0xFFFD, 2, ZAP_TYPE(INT16U), 0 },
+};
+
+// clang-format off
+const EmberAfCluster kLightClusters[] = {
+    { 0x0006, kOnOffAttributes, ArraySize(kOnOffAttributes), 8, CLUSTER_MASK_SERVER, nullptr, nullptr, nullptr, nullptr, 0 },
+    { 0x0008, kLevelAttributes, ArraySize(kLevelAttributes), 3, CLUSTER_MASK_CLIENT, nullptr, nullptr, nullptr, nullptr, 0 },
+    { 0x0008, kLevelAttributes, ArraySize(kLevelAttributes), 3, CLUSTER_MASK_SERVER, nullptr, nullptr, nullptr, nullptr, 0 },
+    { 0x0006, kLevelAttributes, ArraySize(kLevelAttributes), 3, CLUSTER_MASK_SERVER, nullptr, nullptr, nullptr, nullptr, 0 },
+};
+
+const EmberAfCluster kBridgedClusters[] = {
+    { 0x0039, kLevelAttributes, ArraySize(kLevelAttributes), 3, CLUSTER_MASK_SERVER, nullptr, nullptr, nullptr, nullptr, 0 },
+};
+// clang-format on
+
+const EmberAfEndpointType kLightEndpoint   = { kLightClusters, ArraySize(kLightClusters), 17 };
+const EmberAfEndpointType kBridgedEndpoint = { kBridgedClusters, ArraySize(kBridgedClusters), 3 };
+const EmberAfEndpointType kEmptyEndpoint   = { nullptr, 0, 0 };
+
+constexpr uint16_t kMaxEndpoints = 1024;
+EmberAfDefinedEndpoint gEndpoints[kMaxEndpoints];
+AttributeStorageLookupTable gTable;
+
+void SetEndpoint(uint16_t aIndex, EndpointId aEndpointId, const EmberAfEndpointType * aEndpointType)
+{
+    gEndpoints[aIndex]              = EmberAfDefinedEndpoint();
+    gEndpoints[aIndex].endpoint     = aEndpointId;
+    gEndpoints[aIndex].endpointType = aEndpointType;
+}
+
+void ResetEndpoints()
+{
+    for (auto & endpoint : gEndpoints)
+    {
+        endpoint = EmberAfDefinedEndpoint();
+    }
+}
+
+} // namespace
+
+namespace chip {
+namespace app {
+
+class TestAttributeStorageLookupTable
+{
+public:
+    static constexpr bool kEnabled = (AttributeStorageLookupTable::kSize > 0);
+
+    static void TestLookup(nlTestSuite * apSuite, void * apContext);
+    static void TestDuplicates(nlTestSuite * apSuite, void * apContext);
+    static void TestCollisions(nlTestSuite * apSuite, void * apContext);
+    static void TestSeedRetry(nlTestSuite * apSuite, void * apContext);
+    static void TestSeedAttemptsExhausted(nlTestSuite * apSuite, void * apContext);
+    static void TestDynamicEndpoints(nlTestSuite * apSuite, void * apContext);
+    static void TestTableFull(nlTestSuite * apSuite, void * apContext);
+
+private:
+    static bool InHomeSlot(EndpointId aEndpointId)
+    {
+        uint64_t key = AttributeStorageLookupTable::EndpointKey(aEndpointId);
+        return gTable.Find(key) == &gTable.mSlots[gTable.HomeOf(key)];
+    }
+};
+
+void TestAttributeStorageLookupTable::TestLookup(nlTestSuite * apSuite, void * apContext)
+{
+    VerifyOrReturn(kEnabled);
+
+    ResetEndpoints();
+    SetEndpoint(0, 0, &kEmptyEndpoint);
+    SetEndpoint(1, 1, &kLightEndpoint);
+    SetEndpoint(2, 2, &kLightEndpoint);
+    gTable.Build(gEndpoints, 3, 3);
+    NL_TEST_ASSERT(apSuite, gTable.IsUsable());
+
+    AttributeStorageLookupTable::EndpointInfo endpoint;
+    NL_TEST_ASSERT(apSuite, gTable.FindEndpoint(2, endpoint) == Lookup::kFound);
+    NL_TEST_ASSERT(apSuite, endpoint.mIndex == 2);
+    NL_TEST_ASSERT(apSuite, endpoint.mTypeIndex == 1);
+    NL_TEST_ASSERT(apSuite, endpoint.mDataOffset == kLightEndpoint.endpointSize);
+    NL_TEST_ASSERT(apSuite, gTable.FindEndpoint(3, endpoint) == Lookup::kNotFound);
+    NL_TEST_ASSERT(apSuite, gTable.FindEndpoint(kInvalidEndpointId, endpoint) == Lookup::kNotFound);
+
+    // Client clusters are skipped, but their data still counts towards the offsets.
+    AttributeStorageLookupTable::ClusterInfo cluster;
+    NL_TEST_ASSERT(apSuite, gTable.FindServerCluster(1, 0x0008, cluster));
+    NL_TEST_ASSERT(apSuite, cluster.mClusterIndex == 2);
+    NL_TEST_ASSERT(apSuite, cluster.mServerIndex == 1);
+    NL_TEST_ASSERT(apSuite, cluster.mDataOffset == 11);
+    NL_TEST_ASSERT(apSuite, !gTable.FindServerCluster(1, 0x0039, cluster));
+    NL_TEST_ASSERT(apSuite, !gTable.FindServerCluster(2, 0x0008, cluster));
+
+    AttributeStorageLookupTable::AttributeInfo attribute;
+    NL_TEST_ASSERT(apSuite, gTable.FindAttribute(1, 0, 0x4001, attribute));
+    NL_TEST_ASSERT(apSuite, attribute.mAttributeIndex == 2);
+    NL_TEST_ASSERT(apSuite, attribute.mDataOffset == 1);
+    NL_TEST_ASSERT(apSuite, gTable.FindAttribute(1, 0, 0xFFFD, attribute));
+    NL_TEST_ASSERT(apSuite, attribute.mAttributeIndex == 4);
+    NL_TEST_ASSERT(apSuite, attribute.mDataOffset == 5);
+    NL_TEST_ASSERT(apSuite, gTable.FindAttribute(1, 2, 0x0000, attribute));
+    NL_TEST_ASSERT(apSuite, attribute.mAttributeIndex == 0);
+    NL_TEST_ASSERT(apSuite, !gTable.FindAttribute(1, 2, 0x4001, attribute));
+    NL_TEST_ASSERT(apSuite, !gTable.FindAttribute(1, 1, 0x0000, attribute));
+}
+
+void TestAttributeStorageLookupTable::TestDuplicates(nlTestSuite * apSuite, void * apContext)
+{
+    VerifyOrReturn(kEnabled);
+
+    ResetEndpoints();
+    SetEndpoint(0, 1, &kLightEndpoint);
+    SetEndpoint(1, 2, &kBridgedEndpoint);
+    SetEndpoint(2, 1, &kBridgedEndpoint);
+    gTable.Build(gEndpoints, 3, 3);
+
+    // An endpoint id defined twice is left to the linear scan, which knows which of the definitions is enabled.
+    AttributeStorageLookupTable::EndpointInfo endpoint;
+    NL_TEST_ASSERT(apSuite, gTable.FindEndpoint(1, endpoint) == Lookup::kUnknown);
+    NL_TEST_ASSERT(apSuite, gTable.Find(AttributeStorageLookupTable::EndpointKey(1))->mValues[0] ==
+                       AttributeStorageLookupTable::kAmbiguousIndex);
+    NL_TEST_ASSERT(apSuite, gTable.FindEndpoint(2, endpoint) == Lookup::kFound);
+    NL_TEST_ASSERT(apSuite, endpoint.mIndex == 1);
+
+    // Clusters and attributes listed twice are found at their first position, as in a linear scan.
+    AttributeStorageLookupTable::ClusterInfo cluster;
+    NL_TEST_ASSERT(apSuite, gTable.FindServerCluster(0, 0x0006, cluster));
+    NL_TEST_ASSERT(apSuite, cluster.mClusterIndex == 0);
+    NL_TEST_ASSERT(apSuite, cluster.mServerIndex == 0);
+    NL_TEST_ASSERT(apSuite, cluster.mDataOffset == 0);
+
+    AttributeStorageLookupTable::AttributeInfo attribute;
+    NL_TEST_ASSERT(apSuite, gTable.FindAttribute(0, 0, 0x4001, attribute));
+    NL_TEST_ASSERT(apSuite, attribute.mAttributeIndex == 2);
+    NL_TEST_ASSERT(apSuite, attribute.mDataOffset == 1);
+    NL_TEST_ASSERT(apSuite, !gTable.FindAttribute(0, 3, 0x4001, attribute));
+}
+
+void TestAttributeStorageLookupTable::TestCollisions(nlTestSuite * apSuite, void * apContext)
+{
+    VerifyOrReturn(kEnabled);
+
+    // Half as many endpoints as the table may hold: many of them probe past their home slot.
+    constexpr uint16_t kCount = AttributeStorageLookupTable::kMaxUsed / 2;
+    ResetEndpoints();
+    for (uint16_t i = 0; i < kCount; i++)
+    {
+        SetEndpoint(i, static_cast<EndpointId>(i * 7), &kEmptyEndpoint);
+    }
+    gTable.Build(gEndpoints, kCount, 1);
+    NL_TEST_ASSERT(apSuite, gTable.IsUsable());
+    NL_TEST_ASSERT(apSuite, gTable.Size() == kCount);
+
+    size_t displaced = 0;
+    for (uint16_t i = 0; i < kCount; i++)
+    {
+        AttributeStorageLookupTable::EndpointInfo endpoint;
+        NL_TEST_ASSERT(apSuite, gTable.FindEndpoint(static_cast<EndpointId>(i * 7), endpoint) == Lookup::kFound);
+        NL_TEST_ASSERT(apSuite, endpoint.mIndex == i);
+        NL_TEST_ASSERT(apSuite, endpoint.mTypeIndex == 0);
+        displaced += InHomeSlot(static_cast<EndpointId>(i * 7)) ? 0 : 1;
+
+        NL_TEST_ASSERT(apSuite, gTable.FindEndpoint(static_cast<EndpointId>(i * 7 + 1), endpoint) == Lookup::kNotFound);
+    }
+    NL_TEST_ASSERT(apSuite, displaced > 0);
+}
+
+void TestAttributeStorageLookupTable::TestSeedRetry(nlTestSuite * apSuite, void * apContext)
+{
+    VerifyOrReturn(kEnabled);
+
+    // Find an endpoint id that shares the home slot of endpoint 1 under the first seed.
+    gTable.mSeed           = AttributeStorageLookupTable::SeedFor(0);
+    size_t home            = gTable.HomeOf(AttributeStorageLookupTable::EndpointKey(1));
+    EndpointId collidingId = 2;
+    while (gTable.HomeOf(AttributeStorageLookupTable::EndpointKey(collidingId)) != home)
+    {
+        collidingId++;
+    }
+
+    ResetEndpoints();
+    SetEndpoint(0, 1, &kEmptyEndpoint);
+    SetEndpoint(1, collidingId, &kEmptyEndpoint);
+    gTable.Build(gEndpoints, 2, 2);
+
+    // The next seeds spread them, so both fixed endpoints are found without probing.
+    NL_TEST_ASSERT(apSuite, gTable.mSeed != AttributeStorageLookupTable::SeedFor(0));
+    NL_TEST_ASSERT(apSuite, InHomeSlot(1));
+    NL_TEST_ASSERT(apSuite, InHomeSlot(collidingId));
+
+    AttributeStorageLookupTable::EndpointInfo endpoint;
+    NL_TEST_ASSERT(apSuite, gTable.FindEndpoint(collidingId, endpoint) == Lookup::kFound);
+    NL_TEST_ASSERT(apSuite, endpoint.mIndex == 1);
+
+    // Dynamic endpoints do not take part in picking the seed.
+    gTable.Build(gEndpoints, 2, 1);
+    NL_TEST_ASSERT(apSuite, gTable.mSeed == AttributeStorageLookupTable::SeedFor(0));
+    NL_TEST_ASSERT(apSuite, gTable.FindEndpoint(collidingId, endpoint) == Lookup::kFound);
+    NL_TEST_ASSERT(apSuite, endpoint.mIndex == 1);
+}
+
+void TestAttributeStorageLookupTable::TestSeedAttemptsExhausted(nlTestSuite * apSuite, void * apContext)
+{
+    VerifyOrReturn(kEnabled);
+
+    // So many scattered fixed endpoints that no seed puts all of them in their home slots. Consecutive ids would not do, as
+    // the multiplicative hash spreads those evenly.
+    constexpr uint16_t kCount = AttributeStorageLookupTable::kSize / 4;
+    ResetEndpoints();
+    for (uint16_t i = 0; i < kCount; i++)
+    {
+        SetEndpoint(i, static_cast<EndpointId>(i * i), &kEmptyEndpoint);
+    }
+    gTable.Build(gEndpoints, kCount, kCount);
+
+    // The last seed is kept, and lookups still work by probing.
+    NL_TEST_ASSERT(apSuite,
+                   gTable.mSeed == AttributeStorageLookupTable::SeedFor(AttributeStorageLookupTable::kMaxSeedAttempts - 1));
+    NL_TEST_ASSERT(apSuite, gTable.IsUsable());
+    for (uint16_t i = 0; i < kCount; i++)
+    {
+        AttributeStorageLookupTable::EndpointInfo endpoint;
+        NL_TEST_ASSERT(apSuite, gTable.FindEndpoint(static_cast<EndpointId>(i * i), endpoint) == Lookup::kFound);
+        NL_TEST_ASSERT(apSuite, endpoint.mIndex == i);
+    }
+}
+
+void TestAttributeStorageLookupTable::TestDynamicEndpoints(nlTestSuite * apSuite, void * apContext)
+{
+    VerifyOrReturn(kEnabled);
+
+    // One fixed endpoint and three dynamic slots, as emberAfSetDynamicEndpoint() and emberAfClearDynamicEndpoint() update them.
+    ResetEndpoints();
+    SetEndpoint(0, 0, &kLightEndpoint);
+    gTable.Build(gEndpoints, 4, 1);
+
+    AttributeStorageLookupTable::EndpointInfo endpoint;
+    AttributeStorageLookupTable::ClusterInfo cluster;
+    AttributeStorageLookupTable::AttributeInfo attribute;
+    NL_TEST_ASSERT(apSuite, gTable.FindEndpoint(10, endpoint) == Lookup::kNotFound);
+
+    // Adding an endpoint files the entries of its type under it.
+    SetEndpoint(1, 10, &kBridgedEndpoint);
+    gTable.AddDynamicEndpoint(gEndpoints, 1);
+    NL_TEST_ASSERT(apSuite, gTable.FindEndpoint(10, endpoint) == Lookup::kFound);
+    NL_TEST_ASSERT(apSuite, endpoint.mIndex == 1);
+    NL_TEST_ASSERT(apSuite, endpoint.mTypeIndex == 1);
+    NL_TEST_ASSERT(apSuite, endpoint.mDataOffset == kLightEndpoint.endpointSize);
+    NL_TEST_ASSERT(apSuite, gTable.FindServerCluster(1, 0x0039, cluster));
+    NL_TEST_ASSERT(apSuite, gTable.FindAttribute(1, 0, 0xFFFD, attribute));
+    NL_TEST_ASSERT(apSuite, attribute.mDataOffset == 1);
+
+    // A second endpoint of the same type shares those entries.
+    size_t size = gTable.Size();
+    SetEndpoint(2, 11, &kBridgedEndpoint);
+    gTable.AddDynamicEndpoint(gEndpoints, 2);
+    NL_TEST_ASSERT(apSuite, gTable.Size() == size + 1);
+    NL_TEST_ASSERT(apSuite, gTable.FindEndpoint(11, endpoint) == Lookup::kFound);
+    NL_TEST_ASSERT(apSuite, endpoint.mIndex == 2);
+    NL_TEST_ASSERT(apSuite, endpoint.mTypeIndex == 1);
+    NL_TEST_ASSERT(apSuite, !gTable.FindServerCluster(2, 0x0039, cluster));
+
+    // Adding the same endpoint again changes nothing.
+    gTable.AddDynamicEndpoint(gEndpoints, 2);
+    NL_TEST_ASSERT(apSuite, gTable.Size() == size + 1);
+    NL_TEST_ASSERT(apSuite, gTable.FindEndpoint(11, endpoint) == Lookup::kFound);
+
+    // Clearing the first endpoint of the type rebuilds the table, which files the type under the remaining one.
+    gEndpoints[1].endpoint = kInvalidEndpointId;
+    gTable.Build(gEndpoints, 4, 1);
+    NL_TEST_ASSERT(apSuite, gTable.FindEndpoint(10, endpoint) == Lookup::kNotFound);
+    NL_TEST_ASSERT(apSuite, gTable.FindEndpoint(11, endpoint) == Lookup::kFound);
+    NL_TEST_ASSERT(apSuite, endpoint.mTypeIndex == 2);
+    NL_TEST_ASSERT(apSuite, gTable.FindServerCluster(2, 0x0039, cluster));
+    NL_TEST_ASSERT(apSuite, !gTable.FindServerCluster(1, 0x0039, cluster));
+
+    // Replacing an endpoint rebuilds the table as well, so the old id is gone.
+    SetEndpoint(2, 12, &kLightEndpoint);
+    gTable.Build(gEndpoints, 4, 1);
+    NL_TEST_ASSERT(apSuite, gTable.FindEndpoint(11, endpoint) == Lookup::kNotFound);
+    NL_TEST_ASSERT(apSuite, gTable.FindEndpoint(12, endpoint) == Lookup::kFound);
+    NL_TEST_ASSERT(apSuite, endpoint.mTypeIndex == 0);
+    NL_TEST_ASSERT(apSuite, endpoint.mDataOffset == kLightEndpoint.endpointSize);
+
+    // Endpoints past the endpoint count are not added.
+    SetEndpoint(5, 13, &kBridgedEndpoint);
+    gTable.AddDynamicEndpoint(gEndpoints, 5);
+    NL_TEST_ASSERT(apSuite, gTable.FindEndpoint(13, endpoint) == Lookup::kNotFound);
+}
+
+void TestAttributeStorageLookupTable::TestTableFull(nlTestSuite * apSuite, void * apContext)
+{
+    VerifyOrReturn(kEnabled);
+
+    constexpr uint16_t kCount = AttributeStorageLookupTable::kMaxUsed + 1;
+    static_assert(kCount <= kMaxEndpoints, "Not enough endpoints to fill the table");
+    ResetEndpoints();
+    for (uint16_t i = 0; i < kCount; i++)
+    {
+        SetEndpoint(i, i, &kEmptyEndpoint);
+    }
+    gTable.Build(gEndpoints, kCount, 1);
+
+    // Lookups fall back to linear scans rather than answer from a partial table.
+    AttributeStorageLookupTable::EndpointInfo endpoint;
+    NL_TEST_ASSERT(apSuite, !gTable.IsUsable());
+    NL_TEST_ASSERT(apSuite, gTable.FindEndpoint(0, endpoint) == Lookup::kUnknown);
+    NL_TEST_ASSERT(apSuite, gTable.FindEndpoint(kCount, endpoint) == Lookup::kUnknown);
+
+    // Dropping an endpoint makes room again.
+    gTable.Build(gEndpoints, kCount - 1, 1);
+    NL_TEST_ASSERT(apSuite, gTable.IsUsable());
+    NL_TEST_ASSERT(apSuite, gTable.FindEndpoint(0, endpoint) == Lookup::kFound);
+    NL_TEST_ASSERT(apSuite, gTable.FindEndpoint(kCount - 1, endpoint) == Lookup::kNotFound);
+}
+
+} // namespace app
+} // namespace chip
+
+namespace {
+
+// clang-format off
+const nlTest sTests[] =
+{
+    NL_TEST_DEF("TestLookup", chip::app::TestAttributeStorageLookupTable::TestLookup),
+    NL_TEST_DEF("TestDuplicates", chip::app::TestAttributeStorageLookupTable::TestDuplicates),
+    NL_TEST_DEF("TestCollisions", chip::app::TestAttributeStorageLookupTable::TestCollisions),
+    NL_TEST_DEF("TestSeedRetry", chip::app::TestAttributeStorageLookupTable::TestSeedRetry),
+    NL_TEST_DEF("TestSeedAttemptsExhausted", chip::app::TestAttributeStorageLookupTable::TestSeedAttemptsExhausted),
+    NL_TEST_DEF("TestDynamicEndpoints", chip::app::TestAttributeStorageLookupTable::TestDynamicEndpoints),
+    NL_TEST_DEF("TestTableFull", chip::app::TestAttributeStorageLookupTable::TestTableFull),
+    NL_TEST_SENTINEL()
+};
+// clang-format on
+
+} // namespace
+
+int TestAttributeStorageLookup()
+{
+    // clang-format off
+    nlTestSuite theSuite =
+    {
+        "AttributeStorageLookup",
+        &sTests[0],
+        nullptr,
+        nullptr
+    };
+    // clang-format on
+
+    nlTestRunner(&theSuite, nullptr);
+    return (nlTestRunnerStats(&theSuite));
+}
+
+CHIP_REGISTER_TEST_SUITE(TestAttributeStorageLookup)
@@ -279,7 +279,11 @@ CommissioningStage AutoCommissioner::GetNextCommissioningStageInternal(Commissio
     case CommissioningStage::kArmFailsafe:
         return CommissioningStage::kConfigRegulatory;
     case CommissioningStage::kConfigRegulatory:
-        if (mDeviceCommissioningInfo.requiresUTC)
+        if (mDeviceCommissioningInfo.requiresUTC && ShouldBatchTimeConfiguration())
+        {
+            return CommissioningStage::kConfigureTimeBatch;
+        }
+        else if (mDeviceCommissioningInfo.requiresUTC)
         {
             return CommissioningStage::kConfigureUTCTime;
         }
@@ -297,6 +301,7 @@ CommissioningStage AutoCommissioner::GetNextCommissioningStageInternal(Commissio
         {
             return GetNextCommissioningStageInternal(CommissioningStage::kConfigureTimeZone, lastErr);
         }
+    case CommissioningStage::kConfigureTimeBatch:
     case CommissioningStage::kConfigureTimeZone:
         if (mNeedsDST && mParams.GetDSTOffsets().HasValue())
         {
@@ -466,6 +471,12 @@ void AutoCommissioner::SetCASEFailsafeTimerIfNeeded()
     }
 }
 
+bool AutoCommissioner::ShouldBatchTimeConfiguration() const
+{
+    return mParams.GetRemoteMaxPathsPerInvoke() > 1 && mDeviceCommissioningInfo.requiresTimeZone &&
+        mParams.GetTimeZone().HasValue();
+}
+
 EndpointId AutoCommissioner::GetEndpoint(const CommissioningStage & stage) const
 {
     switch (stage)
@@ -697,6 +708,7 @@ CHIP_ERROR AutoCommissioner::CommissioningStepFinished(CHIP_ERROR err, Commissio
             break;
         }
         case CommissioningStage::kConfigureTimeZone:
+        case CommissioningStage::kConfigureTimeBatch:
             mNeedsDST = report.Get<TimeZoneResponseInfo>().requiresDSTOffsets;
             break;
         case CommissioningStage::kSendPAICertificateRequest:
@@ -811,6 +823,7 @@ CHIP_ERROR AutoCommissioner::PerformStep(CommissioningStage nextStage)
     switch (nextStage)
     {
     case CommissioningStage::kConfigureTimeZone:
+    case CommissioningStage::kConfigureTimeBatch:
         if (mParams.GetTimeZone().Value().size() > mDeviceCommissioningInfo.maxTimeZoneSize)
         {
             mParams.SetTimeZone(app::DataModel::List<app::Clusters::TimeSynchronization::Structs::TimeZoneStruct::Type>(
@@ -79,6 +79,10 @@ private:
     // been provided that matches the thread/wifi endpoint of the target.
     CommissioningStage GetNextCommissioningStageNetworkSetup(CommissioningStage currentStage, CHIP_ERROR & lastErr);
 
+    // Whether SetUTCTime and SetTimeZone go to the device in one Invoke (kConfigureTimeBatch), which takes a time zone to
+    // send and a device known to take more than one command per Invoke.
+    bool ShouldBatchTimeConfiguration() const;
+
     // Helper function to determine if a scan attempt should be made given the
     // scan attempt commissioning params and the corresponding network endpoint of
     // the target.
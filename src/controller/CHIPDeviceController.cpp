@@ -41,6 +41,7 @@
 
 #include <app/server/Dnssd.h>
 
+#include <app/CommandSender.h>
 #include <app/InteractionModelEngine.h>
 #include <app/OperationalSessionSetup.h>
 #include <app/util/error-mapping.h>
@@ -2405,6 +2406,121 @@ void DeviceCommissioner::SendCommissioningReadRequest(DeviceProxy * proxy, Optio
     mReadClient     = std::move(readClient);
 }
 
+// Fills in a SetUTCTime request with the current time, if we have one to give.
+static bool MakeSetUTCTimeRequest(TimeSynchronization::Commands::SetUTCTime::Type & request)
+{
+    uint64_t kChipEpochUsSinceUnixEpoch = static_cast<uint64_t>(kChipEpochSecondsSinceUnixEpoch) * chip::kMicrosecondsPerSecond;
+    System::Clock::Microseconds64 utcTime;
+    if (System::SystemClock().GetClock_RealTime(utcTime) != CHIP_NO_ERROR || utcTime.count() <= kChipEpochUsSinceUnixEpoch)
+    {
+        return false;
+    }
+
+    request.UTCTime = utcTime.count() - kChipEpochUsSinceUnixEpoch;
+    // For now, we assume a seconds granularity
+    request.granularity = TimeSynchronization::GranularityEnum::kSecondsGranularity;
+    return true;
+}
+
+namespace {
+
+// Sends SetUTCTime and SetTimeZone in a single Invoke for kConfigureTimeBatch, and completes the stage the way
+// kConfigureUTCTime and kConfigureTimeZone do: the device may turn our time down, and the SetTimeZone response tells whether
+// DST offsets are needed. Deletes itself, along with its CommandSender, once the Invoke is done.
+class TimeConfigurationBatch final : public app::CommandSender::Callback
+{
+public:
+    enum : uint16_t
+    {
+        kSetUTCTimeRef,
+        kSetTimeZoneRef,
+        kCommandCount,
+    };
+
+    TimeConfigurationBatch(DeviceCommissioner * commissioner, Messaging::ExchangeManager * exchangeMgr) :
+        mCommissioner(commissioner), mCommandSender(this, exchangeMgr)
+    {}
+
+    CHIP_ERROR Send(const SessionHandle & session, EndpointId endpoint,
+                    const TimeSynchronization::Commands::SetUTCTime::Type & setUTCTime,
+                    const TimeSynchronization::Commands::SetTimeZone::Type & setTimeZone, Optional<System::Clock::Timeout> timeout)
+    {
+        app::CommandPathParams setUTCTimePath  = { endpoint, 0, TimeSynchronization::Id,
+                                                  TimeSynchronization::Commands::SetUTCTime::Id,
+                                                  app::CommandPathFlags::kEndpointIdValid };
+        app::CommandPathParams setTimeZonePath = { endpoint, 0, TimeSynchronization::Id,
+                                                   TimeSynchronization::Commands::SetTimeZone::Id,
+                                                   app::CommandPathFlags::kEndpointIdValid };
+
+        ReturnErrorOnFailure(mCommandSender.SetRemoteMaxPathsPerInvoke(kCommandCount));
+        ReturnErrorOnFailure(mCommandSender.AddRequestData(setUTCTimePath, setUTCTime));
+        ReturnErrorOnFailure(mCommandSender.AddRequestData(setTimeZonePath, setTimeZone));
+        return mCommandSender.SendCommandRequest(session, timeout);
+    }
+
+private:
+    void OnCommandResponse(app::CommandSender * apCommandSender, uint16_t aCommandRef, const app::ConcreteCommandPath & aPath,
+                           const app::StatusIB & aStatusIB, TLV::TLVReader * apData) override
+    {
+        // For SetUTCTime, we don't actually care if the commissionee didn't want our time, that's its choice.
+        if (aCommandRef != kSetTimeZoneRef || mTimeZoneAnswered)
+        {
+            return;
+        }
+        mTimeZoneAnswered = true;
+
+        if (!aStatusIB.IsSuccess())
+        {
+            mError = aStatusIB.ToChipError();
+            return;
+        }
+        VerifyOrReturn(apData != nullptr && aPath.mClusterId == TimeSynchronization::Id &&
+                           aPath.mCommandId == TimeSynchronization::Commands::SetTimeZoneResponse::Id,
+                       mError = CHIP_ERROR_SCHEMA_MISMATCH);
+
+        TimeSynchronization::Commands::SetTimeZoneResponse::DecodableType response;
+        mError              = app::DataModel::Decode(*apData, response);
+        mRequiresDSTOffsets = response.DSTOffsetRequired;
+    }
+
+    void OnError(const app::CommandSender * apCommandSender, CHIP_ERROR aError) override
+    {
+        if (!mTimeZoneAnswered)
+        {
+            mTimeZoneAnswered = true;
+            mError            = aError;
+        }
+    }
+
+    void OnDone(app::CommandSender * apCommandSender) override
+    {
+        // As with TypedCommandCallback, an unanswered SetTimeZone gets the error we would have gotten if we in fact expected
+        // more responses.
+        OnError(apCommandSender, CHIP_END_OF_TLV);
+
+        CommissioningDelegate::CommissioningReport report;
+        if (mError == CHIP_NO_ERROR)
+        {
+            TimeZoneResponseInfo info;
+            info.requiresDSTOffsets = mRequiresDSTOffsets;
+            report.Set<TimeZoneResponseInfo>(info);
+        }
+
+        DeviceCommissioner * commissioner = mCommissioner;
+        CHIP_ERROR err                    = mError;
+        Platform::Delete(this);
+        commissioner->CommissioningStageComplete(err, report);
+    }
+
+    DeviceCommissioner * mCommissioner;
+    app::CommandSender mCommandSender;
+    bool mTimeZoneAnswered   = false;
+    bool mRequiresDSTOffsets = false;
+    CHIP_ERROR mError        = CHIP_NO_ERROR;
+};
+
+} // namespace
+
 void DeviceCommissioner::PerformCommissioningStep(DeviceProxy * proxy, CommissioningStage step, CommissioningParameters & params,
                                                   CommissioningDelegate * delegate, EndpointId endpoint,
                                                   Optional<System::Clock::Timeout> timeout)
@@ -2506,19 +2622,14 @@ void DeviceCommissioner::PerformCommissioningStep(DeviceProxy * proxy, Commissio
     break;
     case CommissioningStage::kConfigureUTCTime: {
         TimeSynchronization::Commands::SetUTCTime::Type request;
-        uint64_t kChipEpochUsSinceUnixEpoch = static_cast<uint64_t>(kChipEpochSecondsSinceUnixEpoch) * chip::kMicrosecondsPerSecond;
-        System::Clock::Microseconds64 utcTime;
-        if (System::SystemClock().GetClock_RealTime(utcTime) != CHIP_NO_ERROR || utcTime.count() <= kChipEpochUsSinceUnixEpoch)
+        if (!MakeSetUTCTimeRequest(request))
         {
             // We have no time to give, but that's OK, just complete this stage
             CommissioningStageComplete(CHIP_NO_ERROR);
             return;
         }
 
-        request.UTCTime = utcTime.count() - kChipEpochUsSinceUnixEpoch;
-        // For now, we assume a seconds granularity
-        request.granularity = TimeSynchronization::GranularityEnum::kSecondsGranularity;
-        CHIP_ERROR err      = SendCommand(proxy, request, OnBasicSuccess, OnSetUTCError, endpoint, timeout);
+        CHIP_ERROR err = SendCommand(proxy, request, OnBasicSuccess, OnSetUTCError, endpoint, timeout);
         if (err != CHIP_NO_ERROR)
         {
             // We won't get any async callbacks here, so just complete our stage.
@@ -2547,6 +2658,45 @@ void DeviceCommissioner::PerformCommissioningStep(DeviceProxy * proxy, Commissio
         }
         break;
     }
+    case CommissioningStage::kConfigureTimeBatch: {
+        if (!params.GetTimeZone().HasValue())
+        {
+            ChipLogError(Controller, "ConfigureTimeBatch stage called with no time zone data");
+            CommissioningStageComplete(CHIP_ERROR_INVALID_ARGUMENT);
+            return;
+        }
+        TimeSynchronization::Commands::SetTimeZone::Type setTimeZone;
+        setTimeZone.timeZone = params.GetTimeZone().Value();
+
+        TimeSynchronization::Commands::SetUTCTime::Type setUTCTime;
+        CHIP_ERROR err;
+        if (!MakeSetUTCTimeRequest(setUTCTime))
+        {
+            // We have no time to give, so there is only the time zone to send.
+            err = SendCommand(proxy, setTimeZone, OnSetTimeZoneResponse, OnBasicFailure, endpoint, timeout);
+        }
+        else if (auto * batch = Platform::New<TimeConfigurationBatch>(this, proxy->GetExchangeManager()))
+        {
+            err = batch->Send(proxy->GetSecureSession().Value(), endpoint, setUTCTime, setTimeZone, timeout);
+            if (err != CHIP_NO_ERROR)
+            {
+                // OnDone is not called when sending fails.
+                Platform::Delete(batch);
+            }
+        }
+        else
+        {
+            err = CHIP_ERROR_NO_MEMORY;
+        }
+        if (err != CHIP_NO_ERROR)
+        {
+            // We won't get any async callbacks here, so just complete our stage.
+            ChipLogError(Controller, "Failed to send time configuration commands: %" CHIP_ERROR_FORMAT, err.Format());
+            CommissioningStageComplete(err);
+            return;
+        }
+        break;
+    }
     case CommissioningStage::kConfigureDSTOffset: {
         if (!params.GetDSTOffsets().HasValue())
         {
@@ -69,6 +69,10 @@ const char * StageToString(CommissioningStage stage)
         return "ConfigureDefaultNTP";
         break;
 
+    case kConfigureTimeBatch:
+        return "ConfigureTimeBatch";
+        break;
+
     case kSendPAICertificateRequest:
         return "SendPAICertificateRequest";
         break;
@@ -69,6 +69,9 @@ enum CommissioningStage : uint8_t
     /// Call CHIPDeviceController::NetworkCredentialsReady() when CommissioningParameters is populated with
     /// network credentials to use in kWiFiNetworkSetup or kThreadNetworkSetup steps.
     kNeedsNetworkCreds,
+    /// Send SetUTCTime and SetTimeZone in a single Invoke, in place of kConfigureUTCTime and kConfigureTimeZone,
+    /// when the device takes several commands per Invoke (see CommissioningParameters::SetRemoteMaxPathsPerInvoke).
+    kConfigureTimeBatch,
 };
 
 enum ICDRegistrationStrategy : uint8_t
@@ -507,6 +510,16 @@ public:
         return *this;
     }
 
+    // The number of commands the device is known to take in one Invoke. From 2 on, the commissioner batches the
+    // commissioning commands that do not depend on each other; for now that is SetUTCTime with SetTimeZone. SetDSTOffset
+    // stays on its own, since whether it is needed comes from the SetTimeZone response.
+    uint16_t GetRemoteMaxPathsPerInvoke() const { return mRemoteMaxPathsPerInvoke; }
+    CommissioningParameters & SetRemoteMaxPathsPerInvoke(uint16_t remoteMaxPathsPerInvoke)
+    {
+        mRemoteMaxPathsPerInvoke = remoteMaxPathsPerInvoke;
+        return *this;
+    }
+
     // Clear all members that depend on some sort of external buffer.  Can be
     // used to make sure that we are not holding any dangling pointers.
     void ClearExternalBufferDependentValues()
@@ -568,6 +581,7 @@ private:
     Optional<bool> mSkipCommissioningComplete;
     ICDRegistrationStrategy mICDRegistrationStrategy = ICDRegistrationStrategy::kIgnore;
     bool mCheckForMatchingFabric                     = false;
+    uint16_t mRemoteMaxPathsPerInvoke                = 1;
 };
 
 struct RequestedCertificate
@@ -694,6 +708,7 @@ public:
      * kConfigureUTCTime: None
      * kConfigureTimeZone: TimeZoneResponseInfo
      * kConfigureDSTOffset: None
+     * kConfigureTimeBatch: TimeZoneResponseInfo
      * kConfigureDefaultNTP: None
      * kSendPAICertificateRequest: RequestedCertificate
      * kSendDACCertificateRequest: RequestedCertificate
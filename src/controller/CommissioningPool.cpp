@@ -0,0 +1,199 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <controller/CommissioningPool.h>
+
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace chip {
+namespace Controller {
+
+void CommissioningStageLatency::Record(System::Clock::Milliseconds64 latency, CHIP_ERROR error)
+{
+    mCount++;
+    if (error != CHIP_NO_ERROR)
+    {
+        mFailures++;
+    }
+    mTotal += latency;
+    mMax = std::max(mMax, latency);
+
+    size_t bucket = 0;
+    while (bucket + 1 < kBucketCount && latency.count() >= (1ull << bucket))
+    {
+        bucket++;
+    }
+    mBuckets[bucket]++;
+}
+
+System::Clock::Milliseconds64 CommissioningStageLatency::GetBucketUpperBound(size_t bucket)
+{
+    if (bucket + 1 >= kBucketCount)
+    {
+        return System::Clock::Milliseconds64::max();
+    }
+    return System::Clock::Milliseconds64(1ull << bucket);
+}
+
+void CommissioningPool::Slot::OnPairingComplete(CHIP_ERROR error)
+{
+    VerifyOrReturn(mBusy);
+
+    // Commissioning goes on after PASE, unless it failed.
+    mPool.RecordStage(*this, CommissioningStage::kSecurePairing, error);
+    if (error != CHIP_NO_ERROR)
+    {
+        mPool.Finish(*this, error);
+    }
+}
+
+void CommissioningPool::Slot::OnCommissioningStatusUpdate(PeerId peerId, CommissioningStage stageCompleted, CHIP_ERROR error)
+{
+    VerifyOrReturn(mBusy);
+
+    mPool.RecordStage(*this, stageCompleted, error);
+    mPool.mDelegate->OnCommissioningStatusUpdate(mNodeId, stageCompleted, error);
+}
+
+void CommissioningPool::Slot::OnCommissioningComplete(NodeId deviceId, CHIP_ERROR error)
+{
+    VerifyOrReturn(mBusy);
+
+    mPool.Finish(*this, error);
+}
+
+CHIP_ERROR CommissioningPool::Init(const Span<DeviceCommissioner * const> & commissioners, System::Layer * systemLayer,
+                                   Delegate * delegate)
+{
+    VerifyOrReturnError(mSlots.empty(), CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(!commissioners.empty() && systemLayer != nullptr && delegate != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    for (auto * commissioner : commissioners)
+    {
+        VerifyOrReturnError(commissioner != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    }
+
+    mSystemLayer = systemLayer;
+    mDelegate    = delegate;
+    for (auto * commissioner : commissioners)
+    {
+        mSlots.push_back(std::make_unique<Slot>(*this, commissioner));
+        commissioner->RegisterPairingDelegate(mSlots.back().get());
+    }
+    return CHIP_NO_ERROR;
+}
+
+void CommissioningPool::Shutdown()
+{
+    VerifyOrReturn(!mSlots.empty());
+
+    mSystemLayer->CancelTimer(OnStartQueuedTimer, this);
+    for (auto & slot : mSlots)
+    {
+        // Unregister first, so that stopping does not call back into the pool.
+        slot->mCommissioner->RegisterPairingDelegate(nullptr);
+        if (slot->mBusy)
+        {
+            LogErrorOnFailure(StopPairing(*slot->mCommissioner, slot->mNodeId));
+        }
+    }
+    mSlots.clear();
+    mQueue.clear();
+    mSystemLayer = nullptr;
+    mDelegate    = nullptr;
+}
+
+CHIP_ERROR CommissioningPool::Commission(NodeId remoteDeviceId, const char * setUpCode,
+                                         const CommissioningParameters & commissioningParams, DiscoveryType discoveryType)
+{
+    VerifyOrReturnError(!mSlots.empty(), CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(setUpCode != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    mQueue.push_back(Job{ remoteDeviceId, setUpCode, commissioningParams, discoveryType });
+    return mSystemLayer->StartTimer(System::Clock::kZero, OnStartQueuedTimer, this);
+}
+
+size_t CommissioningPool::GetActiveCount() const
+{
+    return static_cast<size_t>(
+        std::count_if(mSlots.begin(), mSlots.end(), [](const std::unique_ptr<Slot> & slot) { return slot->mBusy; }));
+}
+
+void CommissioningPool::RecordStage(Slot & slot, CommissioningStage stage, CHIP_ERROR error)
+{
+    System::Clock::Timestamp now = System::SystemClock().GetMonotonicTimestamp();
+    if (static_cast<size_t>(stage) < kStageCount)
+    {
+        mStageLatencies[stage].Record(now - slot.mStageStartTime, error);
+    }
+    slot.mStageStartTime = now;
+}
+
+void CommissioningPool::Finish(Slot & slot, CHIP_ERROR error)
+{
+    NodeId nodeId = slot.mNodeId;
+
+    mStageLatencies[CommissioningStage::kCleanup].Record(System::SystemClock().GetMonotonicTimestamp() - slot.mStartTime, error);
+    slot.mBusy = false;
+    slot.mSetUpCode.clear();
+
+    // The commissioner is still calling back, so start the next commissioning from the event loop.
+    LogErrorOnFailure(mSystemLayer->StartTimer(System::Clock::kZero, OnStartQueuedTimer, this));
+
+    mDelegate->OnCommissioningComplete(nodeId, error);
+}
+
+void CommissioningPool::StartQueued()
+{
+    for (auto & slot : mSlots)
+    {
+        while (!slot->mBusy && !mQueue.empty())
+        {
+            Job job = std::move(mQueue.front());
+            mQueue.pop_front();
+
+            slot->mBusy           = true;
+            slot->mNodeId         = job.mNodeId;
+            slot->mSetUpCode      = std::move(job.mSetUpCode);
+            slot->mStartTime      = System::SystemClock().GetMonotonicTimestamp();
+            slot->mStageStartTime = slot->mStartTime;
+
+            ChipLogProgress(Controller, "Commissioning " ChipLogFormatX64 ", %u more queued", ChipLogValueX64(job.mNodeId),
+                            static_cast<unsigned>(mQueue.size()));
+            CHIP_ERROR err =
+                PairDevice(*slot->mCommissioner, job.mNodeId, slot->mSetUpCode.c_str(), job.mParams, job.mDiscoveryType);
+            if (err != CHIP_NO_ERROR)
+            {
+                ChipLogError(Controller, "Failed to start commissioning " ChipLogFormatX64 ": %" CHIP_ERROR_FORMAT,
+                             ChipLogValueX64(job.mNodeId), err.Format());
+                Finish(*slot, err);
+            }
+        }
+    }
+}
+
+void CommissioningPool::OnStartQueuedTimer(System::Layer * systemLayer, void * context)
+{
+    static_cast<CommissioningPool *>(context)->StartQueued();
+}
+
+} // namespace Controller
+} // namespace chip
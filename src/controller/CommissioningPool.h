@@ -0,0 +1,177 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <controller/CHIPDeviceController.h>
+#include <controller/CommissioningDelegate.h>
+#include <controller/DevicePairingDelegate.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/NodeId.h>
+#include <lib/support/Span.h>
+#include <system/SystemClock.h>
+#include <system/SystemLayer.h>
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace chip {
+namespace Controller {
+
+/**
+ * Histogram of the latencies of a commissioning stage, in power of two buckets of milliseconds.
+ */
+struct CommissioningStageLatency
+{
+    // Bucket 0 counts latencies under 1ms, bucket i those in [2^(i-1), 2^i) ms, and the last one everything from there on.
+    static constexpr size_t kBucketCount = 20;
+
+    void Record(System::Clock::Milliseconds64 latency, CHIP_ERROR error);
+
+    // Upper bound of the latencies counted in the given bucket, exclusive; the last bucket has none.
+    static System::Clock::Milliseconds64 GetBucketUpperBound(size_t bucket);
+
+    uint32_t mCount                      = 0;
+    uint32_t mFailures                   = 0;
+    System::Clock::Milliseconds64 mTotal = System::Clock::kZero;
+    System::Clock::Milliseconds64 mMax   = System::Clock::kZero;
+    uint32_t mBuckets[kBucketCount]      = {};
+};
+
+/**
+ * Commissions many devices at once, each by a DeviceCommissioner of its own.
+ *
+ * A DeviceCommissioner commissions a single device at a time, one stage after the other. Commissioning a whole batch of
+ * devices through it serializes every round trip of every device. The pool instead takes a set of commissioners, each with
+ * its own AutoCommissioner and commissioning state, and runs as many commissionings as there are commissioners, starting
+ * the queued ones as commissioners free up.
+ *
+ * The commissioners are set up by the application beforehand, for instance through DeviceControllerFactory::SetupCommissioner
+ * with permitMultiControllerFabrics set, so that they share the fabric. The pool registers itself as their pairing delegate
+ * for as long as it is initialized.
+ *
+ * The pool also keeps a histogram of the latency of each commissioning stage, measured from the end of the stage before it.
+ * kSecurePairing covers device discovery and PASE, and kCleanup the whole commissioning of a device.
+ *
+ * Commands of independent stages go in one Invoke when CommissioningParameters::SetRemoteMaxPathsPerInvoke allows it:
+ * SetUTCTime and SetTimeZone are then sent together (kConfigureTimeBatch). SetDSTOffset stays a separate Invoke, since
+ * whether it is needed comes from the SetTimeZone response. The PAI and DAC requests are still sent one after the other.
+ */
+class CommissioningPool
+{
+public:
+    class Delegate
+    {
+    public:
+        virtual ~Delegate() = default;
+
+        /**
+         * Called once the commissioning of a device is over, whether it succeeded, failed or could not start.
+         */
+        virtual void OnCommissioningComplete(NodeId nodeId, CHIP_ERROR error) = 0;
+
+        virtual void OnCommissioningStatusUpdate(NodeId nodeId, CommissioningStage stageCompleted, CHIP_ERROR error) {}
+    };
+
+    CommissioningPool() = default;
+    virtual ~CommissioningPool() { Shutdown(); }
+
+    CommissioningPool(const CommissioningPool &)             = delete;
+    CommissioningPool & operator=(const CommissioningPool &) = delete;
+
+    CHIP_ERROR Init(const Span<DeviceCommissioner * const> & commissioners, System::Layer * systemLayer, Delegate * delegate);
+
+    /**
+     * Stops the commissionings in progress, drops the queued ones and unregisters from the commissioners.
+     */
+    void Shutdown();
+
+    /**
+     * Queues the commissioning of a device, which starts right away if a commissioner is free.
+     *
+     * The buffers that commissioningParams refers to must remain valid until the commissioning is complete.
+     */
+    CHIP_ERROR Commission(NodeId remoteDeviceId, const char * setUpCode, const CommissioningParameters & commissioningParams,
+                          DiscoveryType discoveryType = DiscoveryType::kAll);
+
+    size_t GetActiveCount() const;
+    size_t GetQueuedCount() const { return mQueue.size(); }
+
+    const CommissioningStageLatency & GetStageLatency(CommissioningStage stage) const { return mStageLatencies[stage]; }
+
+protected:
+    // Start and stop the commissioning of a device by one of the commissioners. Tests override these to run the pool without
+    // devices; since Shutdown() calls StopPairing(), such subclasses shut the pool down before it is destroyed.
+    virtual CHIP_ERROR PairDevice(DeviceCommissioner & commissioner, NodeId remoteDeviceId, const char * setUpCode,
+                                  const CommissioningParameters & commissioningParams, DiscoveryType discoveryType)
+    {
+        return commissioner.PairDevice(remoteDeviceId, setUpCode, commissioningParams, discoveryType);
+    }
+
+    virtual CHIP_ERROR StopPairing(DeviceCommissioner & commissioner, NodeId remoteDeviceId)
+    {
+        return commissioner.StopPairing(remoteDeviceId);
+    }
+
+private:
+    static constexpr size_t kStageCount = static_cast<size_t>(CommissioningStage::kConfigureTimeBatch) + 1;
+
+    struct Job
+    {
+        NodeId mNodeId;
+        std::string mSetUpCode;
+        CommissioningParameters mParams;
+        DiscoveryType mDiscoveryType;
+    };
+
+    // A commissioner, and the commissioning it is running if any.
+    class Slot : public DevicePairingDelegate
+    {
+    public:
+        Slot(CommissioningPool & pool, DeviceCommissioner * commissioner) : mPool(pool), mCommissioner(commissioner) {}
+
+        void OnPairingComplete(CHIP_ERROR error) override;
+        void OnCommissioningStatusUpdate(PeerId peerId, CommissioningStage stageCompleted, CHIP_ERROR error) override;
+        void OnCommissioningComplete(NodeId deviceId, CHIP_ERROR error) override;
+
+        CommissioningPool & mPool;
+        DeviceCommissioner * mCommissioner;
+        bool mBusy     = false;
+        NodeId mNodeId = kUndefinedNodeId;
+        // Held for as long as the commissioning runs.
+        std::string mSetUpCode;
+        System::Clock::Timestamp mStartTime;
+        System::Clock::Timestamp mStageStartTime;
+    };
+
+    void RecordStage(Slot & slot, CommissioningStage stage, CHIP_ERROR error);
+    void Finish(Slot & slot, CHIP_ERROR error);
+    void StartQueued();
+    static void OnStartQueuedTimer(System::Layer * systemLayer, void * context);
+
+    System::Layer * mSystemLayer = nullptr;
+    Delegate * mDelegate         = nullptr;
+    std::vector<std::unique_ptr<Slot>> mSlots;
+    std::deque<Job> mQueue;
+    CommissioningStageLatency mStageLatencies[kStageCount];
+};
+
+} // namespace Controller
+} // namespace chip
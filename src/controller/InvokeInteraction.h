@@ -21,6 +21,8 @@
 #include <controller/CommandSenderAllocator.h>
 #include <controller/TypedCommandCallback.h>
 #include <lib/core/Optional.h>
+#include <lib/support/SafeInt.h>
+#include <lib/support/Span.h>
 
 namespace chip {
 namespace Controller {
@@ -93,6 +95,88 @@ InvokeCommandRequest(Messaging::ExchangeManager * aExchangeMgr, const SessionHan
     return CHIP_NO_ERROR;
 }
 
+/*
+ * A command of a batch sent through InvokeCommandRequests: the request and the endpoint it goes to.
+ */
+template <typename RequestObjectT>
+struct CommandRequest
+{
+    chip::EndpointId endpointId;
+    RequestObjectT requestCommandData;
+};
+
+/*
+ * A typed command invocation function that sends a list of commands of the same type at once, in a single batched invoke
+ * request, and calls the provided success or failure callback for each of them with its index in the list.
+ *
+ * The receiver must take at least as many commands per invoke request as there are in the list, and the commands must go to
+ * distinct endpoints, otherwise the whole request gets rejected.
+ */
+template <typename RequestObjectT>
+CHIP_ERROR
+InvokeCommandRequests(Messaging::ExchangeManager * aExchangeMgr, const SessionHandle & sessionHandle,
+                      const Span<const CommandRequest<RequestObjectT>> & requests,
+                      typename TypedBatchCommandCallback<typename RequestObjectT::ResponseType>::OnSuccessCallbackType onSuccessCb,
+                      typename TypedBatchCommandCallback<typename RequestObjectT::ResponseType>::OnErrorCallbackType onErrorCb,
+                      const Optional<uint16_t> & timedInvokeTimeoutMs,
+                      const Optional<System::Clock::Timeout> & responseTimeout = NullOptional)
+{
+    // InvokeCommandRequests expects responses, so cannot happen over a group session.
+    VerifyOrReturnError(!sessionHandle->IsGroupSession(), CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(CanCastTo<uint16_t>(requests.size()), CHIP_ERROR_INVALID_ARGUMENT);
+
+    auto decoder =
+        chip::Platform::MakeUnique<TypedBatchCommandCallback<typename RequestObjectT::ResponseType>>(onSuccessCb, onErrorCb);
+    VerifyOrReturnError(decoder != nullptr, CHIP_ERROR_NO_MEMORY);
+    ReturnErrorOnFailure(decoder->Init(static_cast<uint16_t>(requests.size())));
+
+    //
+    // Upon successful completion of SendCommandRequest below, we're expected to free up the respective allocated objects
+    // in the OnDone callback.
+    //
+    auto onDone = [rawDecoderPtr = decoder.get()](app::CommandSender * commandSender) {
+        chip::Platform::Delete(commandSender);
+        chip::Platform::Delete(rawDecoderPtr);
+    };
+
+    decoder->SetOnDoneCallback(onDone);
+
+    auto commandSender =
+        chip::Platform::MakeUnique<app::CommandSender>(decoder.get(), aExchangeMgr, timedInvokeTimeoutMs.HasValue());
+    VerifyOrReturnError(commandSender != nullptr, CHIP_ERROR_NO_MEMORY);
+
+    ReturnErrorOnFailure(commandSender->SetRemoteMaxPathsPerInvoke(static_cast<uint16_t>(requests.size())));
+    for (const auto & request : requests)
+    {
+        app::CommandPathParams commandPath = { request.endpointId, 0, RequestObjectT::GetClusterId(),
+                                               RequestObjectT::GetCommandId(), (app::CommandPathFlags::kEndpointIdValid) };
+        ReturnErrorOnFailure(commandSender->AddRequestData(commandPath, request.requestCommandData, timedInvokeTimeoutMs));
+    }
+    ReturnErrorOnFailure(commandSender->SendCommandRequest(sessionHandle, responseTimeout));
+
+    //
+    // We've effectively transferred ownership of the above allocated objects to CommandSender, and we need to wait for it to call
+    // us back when processing is completed (through OnDone) to eventually free up resources.
+    //
+    // So signal that by releasing the smart pointer.
+    //
+    decoder.release();
+    commandSender.release();
+
+    return CHIP_NO_ERROR;
+}
+
+template <typename RequestObjectT, typename std::enable_if_t<!RequestObjectT::MustUseTimedInvoke(), int> = 0>
+CHIP_ERROR
+InvokeCommandRequests(Messaging::ExchangeManager * exchangeMgr, const SessionHandle & sessionHandle,
+                      const Span<const CommandRequest<RequestObjectT>> & requests,
+                      typename TypedBatchCommandCallback<typename RequestObjectT::ResponseType>::OnSuccessCallbackType onSuccessCb,
+                      typename TypedBatchCommandCallback<typename RequestObjectT::ResponseType>::OnErrorCallbackType onErrorCb,
+                      const Optional<System::Clock::Timeout> & responseTimeout = NullOptional)
+{
+    return InvokeCommandRequests(exchangeMgr, sessionHandle, requests, onSuccessCb, onErrorCb, NullOptional, responseTimeout);
+}
+
 /*
  * A typed group command invocation function that takes as input a cluster-object representation of a command request.
  *
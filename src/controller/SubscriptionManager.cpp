@@ -0,0 +1,557 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <controller/SubscriptionManager.h>
+
+#include <app/InteractionModelEngine.h>
+#include <crypto/RandUtils.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/FibonacciUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace chip {
+namespace Controller {
+
+using namespace chip::app;
+using System::Clock::Timestamp;
+
+void SubscriptionAttemptPacer::Init(const SubscriptionManagerConfig & config, Timestamp now)
+{
+    mMaxInFlight = config.mMaxInFlightNodes;
+    mBurst       = std::max<uint16_t>(config.mAttemptBurst, 1);
+    mTokens      = mBurst;
+    mInFlight    = 0;
+    mLastRefill  = now;
+    mInterval    = System::Clock::kZero;
+    if (config.mAttemptsPerSecond != 0)
+    {
+        mInterval = System::Clock::Milliseconds64(std::max(1000 / config.mAttemptsPerSecond, 1));
+    }
+}
+
+void SubscriptionAttemptPacer::Refill(Timestamp now)
+{
+    VerifyOrReturn(mInterval != System::Clock::kZero && now >= mLastRefill);
+
+    if (mTokens >= mBurst)
+    {
+        mLastRefill = now;
+        return;
+    }
+
+    uint64_t newTokens = (now - mLastRefill) / mInterval;
+    if (newTokens >= static_cast<uint64_t>(mBurst - mTokens))
+    {
+        mTokens     = mBurst;
+        mLastRefill = now;
+    }
+    else
+    {
+        // Keep the time towards the next token.
+        mTokens     = static_cast<uint16_t>(mTokens + newTokens);
+        mLastRefill = mLastRefill + mInterval * newTokens;
+    }
+}
+
+bool SubscriptionAttemptPacer::TryStartAttempt(Timestamp now)
+{
+    VerifyOrReturnValue(HasInFlightSlot(), false);
+
+    if (mInterval != System::Clock::kZero)
+    {
+        Refill(now);
+        VerifyOrReturnValue(mTokens > 0, false);
+        mTokens--;
+    }
+    mInFlight++;
+    return true;
+}
+
+void SubscriptionAttemptPacer::EndAttempt()
+{
+    VerifyOrDie(mInFlight > 0);
+    mInFlight--;
+}
+
+Timestamp SubscriptionAttemptPacer::GetNextTokenTime() const
+{
+    if (mInterval == System::Clock::kZero || mTokens > 0)
+    {
+        return mLastRefill;
+    }
+    return mLastRefill + mInterval;
+}
+
+SubscriptionManager::Node::Node(SubscriptionManager & manager, NodeId nodeId) :
+    mManager(manager), mNodeId(nodeId), mOnConnected(HandleNodeConnected, this),
+    mOnConnectionFailure(HandleNodeConnectionFailure, this)
+{}
+
+SubscriptionManager::Subscription::Subscription(Node & node, ReadClient::Callback & callback, ReadPrepareParams && params) :
+    mNode(node), mCallback(callback), mParams(std::move(params))
+{
+    // The subscriptions to a node share its session, so none of them may ask the node to drop the others.
+    mParams.mKeepSubscriptions = true;
+    mReadClient = std::make_unique<ReadClient>(InteractionModelEngine::GetInstance(), node.mManager.GetExchangeManager(), *this,
+                                               ReadClient::InteractionType::Subscribe);
+}
+
+SubscriptionManager::Subscription::~Subscription()
+{
+    // Until the first subscribe request, the paths are ours to hand back.
+    if (!mStarted)
+    {
+        mCallback.OnDeallocatePaths(std::move(mParams));
+    }
+}
+
+NodeId SubscriptionManager::Subscription::GetNodeId() const
+{
+    return mNode.mNodeId;
+}
+
+void SubscriptionManager::Subscription::StartSubscribing(const SessionHandle & session)
+{
+    CHIP_ERROR err;
+
+    mState = State::kSubscribing;
+    if (!mStarted)
+    {
+        mStarted = true;
+        mParams.mSessionHolder.Grab(session);
+        err = mReadClient->SendAutoResubscribeRequest(std::move(mParams));
+        if (err != CHIP_NO_ERROR)
+        {
+            // The paths were handed back, so there is no attempting this subscription again.
+            ChipLogError(Controller, "Failed to subscribe to " ChipLogFormatX64 ": %" CHIP_ERROR_FORMAT,
+                         ChipLogValueX64(mNode.mNodeId), err.Format());
+            mCallback.OnError(err);
+            OnDone(mReadClient.get());
+        }
+        return;
+    }
+
+    err = mReadClient->ScheduleResubscription(0, MakeOptional<SessionHandle>(*session->AsSecureSession()), false);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(Controller, "Failed to resubscribe to " ChipLogFormatX64 ": %" CHIP_ERROR_FORMAT,
+                     ChipLogValueX64(mNode.mNodeId), err.Format());
+        BackOff();
+    }
+}
+
+void SubscriptionManager::Subscription::BackOff()
+{
+    ResolveAttempt();
+    mNotBefore = System::SystemClock().GetMonotonicTimestamp() + System::Clock::Milliseconds32(ComputeBackoffMs(mRetries));
+    mRetries++;
+    mState = State::kWaiting;
+    mNode.mManager.RequestScheduling();
+}
+
+void SubscriptionManager::Subscription::ResolveAttempt()
+{
+    VerifyOrReturn(mState == State::kConnecting || mState == State::kSubscribing);
+
+    VerifyOrDie(mNode.mPendingAttempts > 0);
+    mNode.mPendingAttempts--;
+    if (mNode.mPendingAttempts == 0)
+    {
+        mNode.mManager.EndNodeAttempt(mNode);
+    }
+}
+
+void SubscriptionManager::Subscription::OnReportEnd()
+{
+    mLastReport = System::SystemClock().GetMonotonicTimestamp();
+    mCallback.OnReportEnd();
+}
+
+void SubscriptionManager::Subscription::OnSubscriptionEstablished(SubscriptionId aSubscriptionId)
+{
+    ResolveAttempt();
+    mState      = State::kEstablished;
+    mRetries    = 0;
+    mLastReport = System::SystemClock().GetMonotonicTimestamp();
+    mNode.mManager.mTotalEstablishments++;
+
+    mCallback.OnSubscriptionEstablished(aSubscriptionId);
+}
+
+CHIP_ERROR SubscriptionManager::Subscription::OnResubscriptionNeeded(ReadClient * apReadClient, CHIP_ERROR aTerminationCause)
+{
+    if (mState == State::kEstablished)
+    {
+        mNode.mManager.mTotalDrops++;
+    }
+
+    // As in ReadClient::DefaultResubscribePolicy, a timeout calls for a new CASE session.
+    mNeedsNewSession = (aTerminationCause == CHIP_ERROR_TIMEOUT);
+    BackOff();
+
+    ChipLogProgress(Controller,
+                    "Will resubscribe to " ChipLogFormatX64 " at retry index %" PRIu32 " due to error %" CHIP_ERROR_FORMAT,
+                    ChipLogValueX64(mNode.mNodeId), mRetries, aTerminationCause.Format());
+    return CHIP_NO_ERROR;
+}
+
+void SubscriptionManager::Subscription::OnDone(ReadClient * apReadClient)
+{
+    ResolveAttempt();
+    mState = State::kDone;
+    mNode.mManager.RequestScheduling();
+
+    mCallback.OnDone(apReadClient);
+}
+
+void SubscriptionManager::Subscription::OnUnsolicitedMessageFromPublisher(ReadClient * apReadClient)
+{
+    // The publisher is up, so a pending attempt need not wait out its back-off.
+    if (mState == State::kWaiting)
+    {
+        mNotBefore = System::SystemClock().GetMonotonicTimestamp();
+        mNode.mManager.RequestScheduling();
+    }
+
+    mCallback.OnUnsolicitedMessageFromPublisher(apReadClient);
+}
+
+SubscriptionManager::SubscriptionManager(DeviceController * controller, System::Layer * systemLayer,
+                                         const SubscriptionManagerConfig & config) :
+    mController(controller),
+    mSystemLayer(systemLayer), mConfig(config)
+{
+    mPacer.Init(mConfig, System::SystemClock().GetMonotonicTimestamp());
+}
+
+SubscriptionManager::~SubscriptionManager()
+{
+    mSystemLayer->CancelTimer(OnSchedulingTimer, this);
+    mNodes.clear();
+}
+
+CHIP_ERROR SubscriptionManager::Subscribe(NodeId aNodeId, ReadPrepareParams && aReadPrepareParams, ReadClient::Callback & aCallback,
+                                          Subscription ** aSubscription)
+{
+    VerifyOrReturnError(aReadPrepareParams.mAttributePathParamsListSize != 0 || aReadPrepareParams.mEventPathParamsListSize != 0,
+                        CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(GetExchangeManager() != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    Node & node = GetOrCreateNode(aNodeId);
+    node.mSubscriptions.push_back(std::unique_ptr<Subscription>(new Subscription(node, aCallback, std::move(aReadPrepareParams))));
+    Subscription & subscription = *node.mSubscriptions.back();
+
+    uint32_t jitterMs = 0;
+    if (mConfig.mMaxInitialJitterMs != 0)
+    {
+        jitterMs = Crypto::GetRandU32() % mConfig.mMaxInitialJitterMs;
+    }
+    subscription.mNotBefore = System::SystemClock().GetMonotonicTimestamp() + System::Clock::Milliseconds32(jitterMs);
+
+    if (aSubscription != nullptr)
+    {
+        *aSubscription = &subscription;
+    }
+    RequestScheduling();
+    return CHIP_NO_ERROR;
+}
+
+void SubscriptionManager::Unsubscribe(Subscription * aSubscription)
+{
+    Node & node = aSubscription->mNode;
+    aSubscription->ResolveAttempt();
+
+    auto & subscriptions = node.mSubscriptions;
+    subscriptions.erase(std::find_if(subscriptions.begin(), subscriptions.end(),
+                                     [aSubscription](const auto & subscription) { return subscription.get() == aSubscription; }));
+    RequestScheduling();
+}
+
+void SubscriptionManager::TriggerResubscribe(NodeId aNodeId)
+{
+    auto iter = mNodes.find(aNodeId);
+    VerifyOrReturn(iter != mNodes.end());
+
+    Timestamp now = System::SystemClock().GetMonotonicTimestamp();
+    for (auto & subscription : iter->second->mSubscriptions)
+    {
+        if (subscription->mState == Subscription::State::kWaiting)
+        {
+            subscription->mNotBefore = now;
+        }
+    }
+    RequestScheduling();
+}
+
+SubscriptionManagerMetrics SubscriptionManager::GetMetrics() const
+{
+    SubscriptionManagerMetrics metrics;
+    Timestamp now = System::SystemClock().GetMonotonicTimestamp();
+
+    for (auto & entry : mNodes)
+    {
+        for (auto & subscription : entry.second->mSubscriptions)
+        {
+            if (subscription->mState == Subscription::State::kDone)
+            {
+                continue;
+            }
+            metrics.mSubscriptions++;
+            if (subscription->mState == Subscription::State::kWaiting)
+            {
+                metrics.mWaiting++;
+            }
+            else if (subscription->mState == Subscription::State::kEstablished)
+            {
+                metrics.mEstablished++;
+                metrics.mStalestReport = std::max(metrics.mStalestReport, now - subscription->mLastReport);
+            }
+        }
+    }
+    metrics.mNodes                = static_cast<uint32_t>(mNodes.size());
+    metrics.mInFlightNodes        = mPacer.GetInFlight();
+    metrics.mTotalEstablishments  = mTotalEstablishments;
+    metrics.mTotalDrops           = mTotalDrops;
+    metrics.mTotalSessionFailures = mTotalSessionFailures;
+    return metrics;
+}
+
+uint32_t SubscriptionManager::ComputeBackoffMs(uint32_t aRetries)
+{
+    uint32_t maxWaitTimeInMsec = CHIP_RESUBSCRIBE_MAX_RETRY_WAIT_INTERVAL_MS;
+    if (aRetries <= CHIP_RESUBSCRIBE_MAX_FIBONACCI_STEP_INDEX)
+    {
+        maxWaitTimeInMsec = GetFibonacciForIndex(aRetries) * CHIP_RESUBSCRIBE_WAIT_TIME_MULTIPLIER_MS;
+    }
+    VerifyOrReturnValue(maxWaitTimeInMsec != 0, 0);
+
+    uint32_t minWaitTimeInMsec = (CHIP_RESUBSCRIBE_MIN_WAIT_TIME_INTERVAL_PERCENT_PER_STEP * maxWaitTimeInMsec) / 100;
+    return minWaitTimeInMsec + (Crypto::GetRandU32() % (maxWaitTimeInMsec - minWaitTimeInMsec));
+}
+
+SubscriptionManager::Node & SubscriptionManager::GetOrCreateNode(NodeId nodeId)
+{
+    std::unique_ptr<Node> & node = mNodes[nodeId];
+    if (!node)
+    {
+        node = std::make_unique<Node>(*this, nodeId);
+    }
+    return *node;
+}
+
+void SubscriptionManager::StartNodeAttempt(Node & node)
+{
+    bool needsNewSession = false;
+
+    node.mInFlight        = true;
+    node.mPendingAttempts = 0;
+    for (auto & subscription : node.mSubscriptions)
+    {
+        // All the subscriptions waiting on the node go along, whether or not they are due yet.
+        if (subscription->mState == Subscription::State::kWaiting)
+        {
+            subscription->mState = Subscription::State::kConnecting;
+            needsNewSession |= subscription->mNeedsNewSession;
+            subscription->mNeedsNewSession = false;
+            node.mPendingAttempts++;
+        }
+    }
+
+    if (needsNewSession && node.mSession)
+    {
+        // Make sure the session is not picked up again.
+        node.mSession->AsSecureSession()->MarkAsDefunct();
+    }
+    node.mSession.Release();
+
+    CHIP_ERROR err = GetConnectedDevice(node.mNodeId, &node.mOnConnected, &node.mOnConnectionFailure);
+    if (err != CHIP_NO_ERROR)
+    {
+        OnNodeConnectionFailure(node, err);
+    }
+}
+
+void SubscriptionManager::EndNodeAttempt(Node & node)
+{
+    VerifyOrReturn(node.mInFlight);
+
+    node.mInFlight = false;
+    mPacer.EndAttempt();
+    RequestScheduling();
+}
+
+void SubscriptionManager::RemoveFinished()
+{
+    for (auto iter = mNodes.begin(); iter != mNodes.end();)
+    {
+        Node & node          = *iter->second;
+        auto & subscriptions = node.mSubscriptions;
+        subscriptions.erase(std::remove_if(subscriptions.begin(), subscriptions.end(),
+                                           [](const auto & subscription) {
+                                               return subscription->mState == Subscription::State::kDone;
+                                           }),
+                            subscriptions.end());
+
+        if (subscriptions.empty() && !node.mInFlight)
+        {
+            iter = mNodes.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+}
+
+void SubscriptionManager::RequestScheduling()
+{
+    if (mScheduling)
+    {
+        mSchedulingRequested = true;
+        return;
+    }
+
+    CHIP_ERROR err = mSystemLayer->StartTimer(System::Clock::kZero, OnSchedulingTimer, this);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(Controller, "Failed to schedule subscription attempts: %" CHIP_ERROR_FORMAT, err.Format());
+    }
+}
+
+void SubscriptionManager::ScheduleAttempts()
+{
+    mScheduling          = true;
+    mSchedulingRequested = false;
+    RemoveFinished();
+
+    Timestamp now         = System::SystemClock().GetMonotonicTimestamp();
+    Timestamp nextAttempt = Timestamp::max();
+
+    // Nodes with a subscription due for an attempt, along with the time it was due at.
+    std::vector<std::pair<Timestamp, Node *>> dueNodes;
+    for (auto & entry : mNodes)
+    {
+        Node & node = *entry.second;
+        if (node.mInFlight)
+        {
+            continue;
+        }
+
+        Timestamp due = Timestamp::max();
+        for (auto & subscription : node.mSubscriptions)
+        {
+            if (subscription->mState == Subscription::State::kWaiting)
+            {
+                due = std::min(due, subscription->mNotBefore);
+            }
+        }
+
+        if (due <= now)
+        {
+            dueNodes.emplace_back(due, &node);
+        }
+        else
+        {
+            nextAttempt = std::min(nextAttempt, due);
+        }
+    }
+
+    // The nodes that have been waiting the longest go first.
+    std::sort(dueNodes.begin(), dueNodes.end());
+    for (auto & dueNode : dueNodes)
+    {
+        if (!mPacer.TryStartAttempt(now))
+        {
+            // Without an in-flight slot, the end of an attempt runs the scheduler again.
+            if (mPacer.HasInFlightSlot())
+            {
+                nextAttempt = std::min(nextAttempt, mPacer.GetNextTokenTime());
+            }
+            break;
+        }
+        StartNodeAttempt(*dueNode.second);
+    }
+
+    mScheduling = false;
+    if (mSchedulingRequested)
+    {
+        nextAttempt = now;
+    }
+    VerifyOrReturn(nextAttempt != Timestamp::max());
+
+    System::Clock::Milliseconds32 delay = System::Clock::kZero;
+    if (nextAttempt > now)
+    {
+        delay = std::chrono::duration_cast<System::Clock::Milliseconds32>(nextAttempt - now);
+    }
+    CHIP_ERROR err = mSystemLayer->StartTimer(delay, OnSchedulingTimer, this);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(Controller, "Failed to schedule subscription attempts: %" CHIP_ERROR_FORMAT, err.Format());
+    }
+}
+
+void SubscriptionManager::OnSchedulingTimer(System::Layer * systemLayer, void * context)
+{
+    static_cast<SubscriptionManager *>(context)->ScheduleAttempts();
+}
+
+void SubscriptionManager::HandleNodeConnected(void * context, Messaging::ExchangeManager & exchangeMgr,
+                                              const SessionHandle & sessionHandle)
+{
+    Node & node = *static_cast<Node *>(context);
+    node.mSession.Grab(sessionHandle);
+
+    // Subscriptions may be added from the callbacks, so iterate by index.
+    for (size_t i = 0; i < node.mSubscriptions.size(); i++)
+    {
+        Subscription & subscription = *node.mSubscriptions[i];
+        if (subscription.mState == Subscription::State::kConnecting)
+        {
+            subscription.StartSubscribing(sessionHandle);
+        }
+    }
+}
+
+void SubscriptionManager::HandleNodeConnectionFailure(void * context, const ScopedNodeId & peerId, CHIP_ERROR error)
+{
+    Node & node = *static_cast<Node *>(context);
+    node.mManager.OnNodeConnectionFailure(node, error);
+}
+
+void SubscriptionManager::OnNodeConnectionFailure(Node & node, CHIP_ERROR error)
+{
+    ChipLogError(Controller, "Failed to establish CASE with " ChipLogFormatX64 " for subscriptions: %" CHIP_ERROR_FORMAT,
+                 ChipLogValueX64(node.mNodeId), error.Format());
+    mTotalSessionFailures++;
+
+    for (size_t i = 0; i < node.mSubscriptions.size(); i++)
+    {
+        Subscription & subscription = *node.mSubscriptions[i];
+        if (subscription.mState == Subscription::State::kConnecting)
+        {
+            subscription.BackOff();
+        }
+    }
+}
+
+} // namespace Controller
+} // namespace chip
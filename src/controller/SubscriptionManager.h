@@ -0,0 +1,297 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <app/ReadClient.h>
+#include <controller/CHIPDeviceController.h>
+#include <lib/core/CHIPCallback.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/NodeId.h>
+#include <lib/support/FlatMap.h>
+#include <system/SystemClock.h>
+#include <system/SystemLayer.h>
+#include <transport/SessionHolder.h>
+
+#include <memory>
+#include <vector>
+
+namespace chip {
+namespace Controller {
+
+struct SubscriptionManagerConfig
+{
+    // Most nodes that may be setting up CASE or subscribing at the same time.
+    uint16_t mMaxInFlightNodes = 16;
+    // Average rate at which attempts to (re)subscribe to a node may start, or 0 for no limit.
+    uint16_t mAttemptsPerSecond = 8;
+    // Most attempts that may start back to back when none have for a while.
+    uint16_t mAttemptBurst = 16;
+    // Subscriptions are first attempted at a random time up to this far after being added.
+    uint32_t mMaxInitialJitterMs = 2000;
+};
+
+/**
+ * Liveness of the subscriptions of a SubscriptionManager, as returned by SubscriptionManager::GetMetrics.
+ *
+ * The first counts reflect the current state; the totals count events since the manager was created.
+ */
+struct SubscriptionManagerMetrics
+{
+    uint32_t mSubscriptions        = 0;
+    uint32_t mEstablished          = 0;
+    uint32_t mWaiting              = 0;
+    uint32_t mNodes                = 0;
+    uint16_t mInFlightNodes        = 0;
+    uint32_t mTotalEstablishments  = 0;
+    uint32_t mTotalDrops           = 0;
+    uint32_t mTotalSessionFailures = 0;
+    // Longest time since an established subscription last heard from its publisher.
+    System::Clock::Milliseconds64 mStalestReport = System::Clock::kZero;
+};
+
+/**
+ * Token bucket and concurrency cap used by SubscriptionManager to pace its attempts.
+ */
+class SubscriptionAttemptPacer
+{
+public:
+    void Init(const SubscriptionManagerConfig & config, System::Clock::Timestamp now);
+
+    /**
+     * Starts an attempt if both an in-flight slot and a token are available. Returns whether it did.
+     */
+    bool TryStartAttempt(System::Clock::Timestamp now);
+
+    /**
+     * Frees the in-flight slot of an attempt started with TryStartAttempt.
+     */
+    void EndAttempt();
+
+    bool HasInFlightSlot() const { return mInFlight < mMaxInFlight; }
+    uint16_t GetInFlight() const { return mInFlight; }
+
+    /**
+     * Returns when the next token is available, which is at or before now if one is.
+     */
+    System::Clock::Timestamp GetNextTokenTime() const;
+
+private:
+    void Refill(System::Clock::Timestamp now);
+
+    System::Clock::Timestamp mLastRefill    = System::Clock::kZero;
+    System::Clock::Milliseconds64 mInterval = System::Clock::kZero;
+    uint16_t mMaxInFlight                   = 0;
+    uint16_t mBurst                         = 0;
+    uint16_t mTokens                        = 0;
+    uint16_t mInFlight                      = 0;
+};
+
+/**
+ * Keeps many auto-resubscribing subscriptions of a controller alive, pacing their attempts to subscribe.
+ *
+ * Each ReadClient left to itself re-subscribes on its own back-off timer and sets up CASE on its own. After an outage,
+ * thousands of them all come back at about the same time. Instead, the manager owns the ReadClients of the subscriptions
+ * it is given, and runs a single scheduler over them:
+ *  - Subscriptions due for an attempt are handled by node, so that all the subscriptions to a node share a single CASE
+ *    session setup and session.
+ *  - At most SubscriptionManagerConfig::mMaxInFlightNodes nodes are setting up CASE or subscribing at a time, and attempts
+ *    start no faster than SubscriptionManagerConfig::mAttemptsPerSecond.
+ *  - Failed attempts and dropped subscriptions back off following the same randomized fibonacci sequence as
+ *    ReadClient::ComputeTimeTillNextSubscription, and new subscriptions are spread over mMaxInitialJitterMs.
+ *
+ * Subscription callbacks are forwarded to the callback given to Subscribe, except OnResubscriptionNeeded, which the
+ * manager handles. OnDone is called once the subscription is over, including when it could not be started at all; the
+ * Subscription and its ReadClient remain owned by the manager, which destroys them afterwards.
+ */
+class SubscriptionManager
+{
+    struct Node;
+
+public:
+    class Subscription;
+
+    SubscriptionManager(DeviceController * controller, System::Layer * systemLayer,
+                        const SubscriptionManagerConfig & config = SubscriptionManagerConfig());
+    virtual ~SubscriptionManager();
+
+    SubscriptionManager(const SubscriptionManager &)             = delete;
+    SubscriptionManager & operator=(const SubscriptionManager &) = delete;
+
+    /**
+     * Adds a subscription to the given node, to be established when the scheduler gets to it.
+     *
+     * As for ReadClient::SendAutoResubscribeRequest, aReadPrepareParams needs attribute or event paths that remain valid
+     * until they are handed back through aCallback.OnDeallocatePaths. Any session in it is ignored, and
+     * mKeepSubscriptions is forced on so that the subscriptions to a node do not cancel each other. On failure,
+     * aReadPrepareParams is left untouched.
+     *
+     * @param[out] aSubscription Optionally set to the subscription, which stays valid until aCallback.OnDone returns or
+     *                           it is passed to Unsubscribe.
+     */
+    CHIP_ERROR Subscribe(NodeId aNodeId, app::ReadPrepareParams && aReadPrepareParams, app::ReadClient::Callback & aCallback,
+                         Subscription ** aSubscription = nullptr);
+
+    /**
+     * Shuts down a subscription without calling OnDone. This must not be called from within its callbacks.
+     */
+    void Unsubscribe(Subscription * aSubscription);
+
+    /**
+     * Brings forward the next attempt of the subscriptions to the given node that are waiting for one, for example when
+     * the node was just heard from.
+     */
+    void TriggerResubscribe(NodeId aNodeId);
+
+    SubscriptionManagerMetrics GetMetrics() const;
+
+    /**
+     * Computes the back-off before the attempt that follows aRetries failed ones.
+     */
+    static uint32_t ComputeBackoffMs(uint32_t aRetries);
+
+    class Subscription : public app::ReadClient::Callback
+    {
+    public:
+        ~Subscription() override;
+
+        NodeId GetNodeId() const;
+        bool IsEstablished() const { return mState == State::kEstablished; }
+        System::Clock::Timestamp GetLastReportTime() const { return mLastReport; }
+
+    private:
+        friend class SubscriptionManager;
+
+        enum class State : uint8_t
+        {
+            kWaiting,     // For mNotBefore, and then for the scheduler to admit its node.
+            kConnecting,  // For the CASE session to its node.
+            kSubscribing, // For the subscribe request to complete.
+            kEstablished,
+            kDone,
+        };
+
+        Subscription(Node & node, app::ReadClient::Callback & callback, app::ReadPrepareParams && params);
+
+        void StartSubscribing(const SessionHandle & session);
+        void BackOff();
+        void ResolveAttempt();
+
+        // ReadClient::Callback
+        void OnReportBegin() override { mCallback.OnReportBegin(); }
+        void OnReportEnd() override;
+        void OnReportBuffer(const System::PacketBufferHandle & aBuffer) override { mCallback.OnReportBuffer(aBuffer); }
+        void OnEventData(const app::EventHeader & aEventHeader, TLV::TLVReader * apData, const app::StatusIB * apStatus) override
+        {
+            mCallback.OnEventData(aEventHeader, apData, apStatus);
+        }
+        void OnAttributeData(const app::ConcreteDataAttributePath & aPath, TLV::TLVReader * apData,
+                             const app::StatusIB & aStatus) override
+        {
+            mCallback.OnAttributeData(aPath, apData, aStatus);
+        }
+        void OnSubscriptionEstablished(SubscriptionId aSubscriptionId) override;
+        CHIP_ERROR OnResubscriptionNeeded(app::ReadClient * apReadClient, CHIP_ERROR aTerminationCause) override;
+        void OnError(CHIP_ERROR aError) override { mCallback.OnError(aError); }
+        void OnDone(app::ReadClient * apReadClient) override;
+        void OnDeallocatePaths(app::ReadPrepareParams && aReadPrepareParams) override
+        {
+            mCallback.OnDeallocatePaths(std::move(aReadPrepareParams));
+        }
+        CHIP_ERROR OnUpdateDataVersionFilterList(app::DataVersionFilterIBs::Builder & aDataVersionFilterIBsBuilder,
+                                                 const Span<app::AttributePathParams> & aAttributePaths,
+                                                 bool & aEncodedDataVersionList) override
+        {
+            return mCallback.OnUpdateDataVersionFilterList(aDataVersionFilterIBsBuilder, aAttributePaths, aEncodedDataVersionList);
+        }
+        CHIP_ERROR GetHighestReceivedEventNumber(Optional<EventNumber> & aEventNumber) override
+        {
+            return mCallback.GetHighestReceivedEventNumber(aEventNumber);
+        }
+        void OnUnsolicitedMessageFromPublisher(app::ReadClient * apReadClient) override;
+
+        Node & mNode;
+        app::ReadClient::Callback & mCallback;
+        std::unique_ptr<app::ReadClient> mReadClient;
+        // Held until the first subscribe request, which moves it into mReadClient.
+        app::ReadPrepareParams mParams;
+        bool mStarted                        = false;
+        bool mNeedsNewSession                = false;
+        State mState                         = State::kWaiting;
+        uint32_t mRetries                    = 0;
+        System::Clock::Timestamp mNotBefore  = System::Clock::kZero;
+        System::Clock::Timestamp mLastReport = System::Clock::kZero;
+    };
+
+protected:
+    // Where the manager gets its exchange manager and CASE sessions from. Tests override these to run the manager without a
+    // DeviceController.
+    virtual Messaging::ExchangeManager * GetExchangeManager() const { return mController->ExchangeMgr(); }
+
+    virtual CHIP_ERROR GetConnectedDevice(NodeId nodeId, Callback::Callback<OnDeviceConnected> * onConnection,
+                                          Callback::Callback<OnDeviceConnectionFailure> * onFailure)
+    {
+        return mController->GetConnectedDevice(nodeId, onConnection, onFailure);
+    }
+
+private:
+    // The subscriptions to a node, and the CASE session they share.
+    struct Node
+    {
+        Node(SubscriptionManager & manager, NodeId nodeId);
+
+        SubscriptionManager & mManager;
+        NodeId mNodeId;
+        std::vector<std::unique_ptr<Subscription>> mSubscriptions;
+        SessionHolder mSession;
+        Callback::Callback<OnDeviceConnected> mOnConnected;
+        Callback::Callback<OnDeviceConnectionFailure> mOnConnectionFailure;
+        // Subscriptions admitted by the current attempt that are still connecting or subscribing.
+        uint32_t mPendingAttempts = 0;
+        bool mInFlight            = false;
+    };
+
+    Node & GetOrCreateNode(NodeId nodeId);
+    void StartNodeAttempt(Node & node);
+    void EndNodeAttempt(Node & node);
+    void RemoveFinished();
+
+    // Runs the scheduler soon, from the event loop.
+    void RequestScheduling();
+    void ScheduleAttempts();
+    static void OnSchedulingTimer(System::Layer * systemLayer, void * context);
+
+    static void HandleNodeConnected(void * context, Messaging::ExchangeManager & exchangeMgr, const SessionHandle & sessionHandle);
+    static void HandleNodeConnectionFailure(void * context, const ScopedNodeId & peerId, CHIP_ERROR error);
+    void OnNodeConnectionFailure(Node & node, CHIP_ERROR error);
+
+    DeviceController * mController;
+    System::Layer * mSystemLayer;
+    SubscriptionManagerConfig mConfig;
+    SubscriptionAttemptPacer mPacer;
+    FlatMap<NodeId, std::unique_ptr<Node>> mNodes;
+    bool mScheduling          = false;
+    bool mSchedulingRequested = false;
+
+    uint32_t mTotalEstablishments  = 0;
+    uint32_t mTotalDrops           = 0;
+    uint32_t mTotalSessionFailures = 0;
+};
+
+} // namespace Controller
+} // namespace chip
@@ -22,6 +22,7 @@
 #include <app/CommandSender.h>
 #include <app/data-model/Decode.h>
 #include <app/data-model/NullObject.h>
+#include <lib/support/ScopedBuffer.h>
 #include <functional>
 
 namespace chip {
@@ -169,5 +170,124 @@ inline void TypedCommandCallback<app::DataModel::NullObjectType>::OnResponse(app
     mOnSuccess(aCommandPath, aStatus, nullResp);
 }
 
+/*
+ * The counterpart of TypedCommandCallback for a batch of commands sent in one invoke request, all expecting the same type of
+ * response.
+ *
+ * Each command gets either its success or its error callback called once, with the command reference, which is the index of the
+ * command in the batch. Commands left unanswered when the transaction is over get the error callback too.
+ */
+template <typename CommandResponseObjectT>
+class TypedBatchCommandCallback final : public app::CommandSender::Callback
+{
+public:
+    using OnSuccessCallbackType = std::function<void(uint16_t aCommandRef, const app::ConcreteCommandPath &, const app::StatusIB &,
+                                                     const CommandResponseObjectT &)>;
+    using OnErrorCallbackType   = std::function<void(uint16_t aCommandRef, CHIP_ERROR aError)>;
+    using OnDoneCallbackType    = std::function<void(app::CommandSender * commandSender)>;
+
+    TypedBatchCommandCallback(OnSuccessCallbackType aOnSuccess, OnErrorCallbackType aOnError, OnDoneCallbackType aOnDone = {}) :
+        mOnSuccess(aOnSuccess), mOnError(aOnError), mOnDone(aOnDone)
+    {}
+
+    /*
+     * Must be called with the number of commands in the batch before the invoke request is sent.
+     */
+    CHIP_ERROR Init(uint16_t aCommandCount)
+    {
+        VerifyOrReturnError(aCommandCount > 0, CHIP_ERROR_INVALID_ARGUMENT);
+        VerifyOrReturnError(mAnswered.Calloc(aCommandCount), CHIP_ERROR_NO_MEMORY);
+        mCommandCount = aCommandCount;
+        return CHIP_NO_ERROR;
+    }
+
+    void SetOnDoneCallback(OnDoneCallbackType callback) { mOnDone = callback; }
+
+private:
+    // A batch of a single command is sent as a plain invoke request, whose responses do not come with a command reference.
+    void OnResponse(app::CommandSender * apCommandSender, const app::ConcreteCommandPath & aCommandPath,
+                    const app::StatusIB & aStatus, TLV::TLVReader * aReader) override
+    {
+        OnCommandResponse(apCommandSender, 0, aCommandPath, aStatus, aReader);
+    }
+
+    void OnCommandResponse(app::CommandSender * apCommandSender, uint16_t aCommandRef,
+                           const app::ConcreteCommandPath & aCommandPath, const app::StatusIB & aStatus,
+                           TLV::TLVReader * aReader) override
+    {
+        if (aCommandRef >= mCommandCount || mAnswered[aCommandRef])
+        {
+            return;
+        }
+        mAnswered[aCommandRef] = true;
+
+        CommandResponseObjectT response;
+        CHIP_ERROR err = aStatus.IsSuccess() ? DecodeResponse(aCommandPath, aReader, response) : aStatus.ToChipError();
+        if (err != CHIP_NO_ERROR)
+        {
+            mOnError(aCommandRef, err);
+            return;
+        }
+        mOnSuccess(aCommandRef, aCommandPath, aStatus, response);
+    }
+
+    void OnError(const app::CommandSender * apCommandSender, CHIP_ERROR aError) override
+    {
+        // The error is not about any one command, so it is about all of those not answered yet.
+        for (uint16_t i = 0; i < mCommandCount; i++)
+        {
+            if (!mAnswered[i])
+            {
+                mAnswered[i] = true;
+                mOnError(i, aError);
+            }
+        }
+    }
+
+    void OnDone(app::CommandSender * apCommandSender) override
+    {
+        // As with TypedCommandCallback, commands the server did not answer get the error we would have gotten if we in fact
+        // expected more responses.
+        OnError(apCommandSender, CHIP_END_OF_TLV);
+
+        mOnDone(apCommandSender);
+    }
+
+    static CHIP_ERROR DecodeResponse(const app::ConcreteCommandPath & aCommandPath, TLV::TLVReader * aReader,
+                                     CommandResponseObjectT & aResponse);
+
+    OnSuccessCallbackType mOnSuccess;
+    OnErrorCallbackType mOnError;
+    OnDoneCallbackType mOnDone;
+
+    Platform::ScopedMemoryBuffer<bool> mAnswered;
+    uint16_t mCommandCount = 0;
+};
+
+/*
+ * Decodes command responses that have actual data payloads, with the same checks as TypedCommandCallback::OnResponse.
+ */
+template <typename CommandResponseObjectT>
+CHIP_ERROR TypedBatchCommandCallback<CommandResponseObjectT>::DecodeResponse(const app::ConcreteCommandPath & aCommandPath,
+                                                                             TLV::TLVReader * aReader,
+                                                                             CommandResponseObjectT & aResponse)
+{
+    VerifyOrReturnError(aReader != nullptr, CHIP_ERROR_SCHEMA_MISMATCH);
+    VerifyOrReturnError(aCommandPath.mClusterId == CommandResponseObjectT::GetClusterId() &&
+                            aCommandPath.mCommandId == CommandResponseObjectT::GetCommandId(),
+                        CHIP_ERROR_SCHEMA_MISMATCH);
+    return app::DataModel::Decode(*aReader, aResponse);
+}
+
+/*
+ * Command responses that do not have actual data payloads must come with no data at all.
+ */
+template <>
+inline CHIP_ERROR TypedBatchCommandCallback<app::DataModel::NullObjectType>::DecodeResponse(
+    const app::ConcreteCommandPath & aCommandPath, TLV::TLVReader * aReader, app::DataModel::NullObjectType & aResponse)
+{
+    return aReader == nullptr ? CHIP_NO_ERROR : CHIP_ERROR_SCHEMA_MISMATCH;
+}
+
 } // namespace Controller
 } // namespace chip
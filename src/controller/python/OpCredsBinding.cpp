@@ -164,7 +164,8 @@ public:
         {
             mReadCommissioningInfo = report.Get<chip::Controller::ReadCommissioningInfo>();
         }
-        if (report.stageCompleted == chip::Controller::CommissioningStage::kConfigureTimeZone)
+        if (report.stageCompleted == chip::Controller::CommissioningStage::kConfigureTimeZone ||
+            report.stageCompleted == chip::Controller::CommissioningStage::kConfigureTimeBatch)
         {
             mNeedsDST = report.Get<chip::Controller::TimeZoneResponseInfo>().requiresDSTOffsets;
         }
@@ -323,6 +324,9 @@ private:
             return mReadCommissioningInfo.requiresUTC;
         case chip::Controller::CommissioningStage::kConfigureTimeZone:
             return mReadCommissioningInfo.requiresTimeZone && mParams.GetTimeZone().HasValue();
+        case chip::Controller::CommissioningStage::kConfigureTimeBatch:
+            return mReadCommissioningInfo.requiresUTC && mReadCommissioningInfo.requiresTimeZone &&
+                mParams.GetTimeZone().HasValue() && mParams.GetRemoteMaxPathsPerInvoke() > 1;
         case chip::Controller::CommissioningStage::kConfigureTrustedTimeSource:
             return mReadCommissioningInfo.requiresTrustedTimeSource && mParams.GetTrustedTimeSource().HasValue();
         case chip::Controller::CommissioningStage::kConfigureDefaultNTP:
@@ -0,0 +1,423 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <controller/AutoCommissioner.h>
+#include <controller/CommissioningPool.h>
+#include <lib/support/UnitTestContext.h>
+#include <lib/support/UnitTestRegistration.h>
+#include <nlunit-test.h>
+#include <transport/raw/tests/NetworkTestHelpers.h>
+
+#include <utility>
+#include <vector>
+
+using namespace chip;
+using namespace chip::Controller;
+using namespace chip::System::Clock::Literals;
+
+using TestContext = chip::Test::IOContext;
+
+namespace {
+
+constexpr char kSetUpCode[] = "MT:-24J0AFN00KA0648G00";
+
+// Stands in for the devices: commissionings start without error and only end when a test calls the pairing delegates of
+// the commissioners, unless mUseCommissioners is set.
+class TestPool : public CommissioningPool
+{
+public:
+    ~TestPool() override { Shutdown(); }
+
+    bool mUseCommissioners = false;
+    std::vector<std::pair<DeviceCommissioner *, NodeId>> mStarted;
+    std::vector<std::pair<DeviceCommissioner *, NodeId>> mStopped;
+
+protected:
+    CHIP_ERROR PairDevice(DeviceCommissioner & commissioner, NodeId remoteDeviceId, const char * setUpCode,
+                          const CommissioningParameters & commissioningParams, DiscoveryType discoveryType) override
+    {
+        if (mUseCommissioners)
+        {
+            return CommissioningPool::PairDevice(commissioner, remoteDeviceId, setUpCode, commissioningParams, discoveryType);
+        }
+        mStarted.emplace_back(&commissioner, remoteDeviceId);
+        return CHIP_NO_ERROR;
+    }
+
+    CHIP_ERROR StopPairing(DeviceCommissioner & commissioner, NodeId remoteDeviceId) override
+    {
+        mStopped.emplace_back(&commissioner, remoteDeviceId);
+        return CHIP_NO_ERROR;
+    }
+};
+
+class TestDelegate : public CommissioningPool::Delegate
+{
+public:
+    void OnCommissioningComplete(NodeId nodeId, CHIP_ERROR error) override { mCompleted.emplace_back(nodeId, error); }
+
+    void OnCommissioningStatusUpdate(NodeId nodeId, CommissioningStage stageCompleted, CHIP_ERROR error) override
+    {
+        mStatusUpdates.emplace_back(nodeId, stageCompleted);
+    }
+
+    std::vector<std::pair<NodeId, CHIP_ERROR>> mCompleted;
+    std::vector<std::pair<NodeId, CommissioningStage>> mStatusUpdates;
+};
+
+void TestInit(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+    DeviceCommissioner commissioner;
+    DeviceCommissioner * commissionerList[] = { &commissioner };
+    DeviceCommissioner * nullList[]         = { nullptr };
+    Span<DeviceCommissioner * const> commissioners(commissionerList);
+    Span<DeviceCommissioner * const> nullCommissioners(nullList);
+    TestDelegate delegate;
+    TestPool pool;
+
+    NL_TEST_ASSERT(inSuite, pool.Commission(1, kSetUpCode, CommissioningParameters()) == CHIP_ERROR_INCORRECT_STATE);
+    NL_TEST_ASSERT(inSuite,
+                   pool.Init(Span<DeviceCommissioner * const>(), &ctx.GetSystemLayer(), &delegate) == CHIP_ERROR_INVALID_ARGUMENT);
+    NL_TEST_ASSERT(inSuite, pool.Init(nullCommissioners, &ctx.GetSystemLayer(), &delegate) == CHIP_ERROR_INVALID_ARGUMENT);
+    NL_TEST_ASSERT(inSuite, pool.Init(commissioners, &ctx.GetSystemLayer(), nullptr) == CHIP_ERROR_INVALID_ARGUMENT);
+
+    NL_TEST_ASSERT(inSuite, pool.Init(commissioners, &ctx.GetSystemLayer(), &delegate) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, commissioner.GetPairingDelegate() != nullptr);
+    NL_TEST_ASSERT(inSuite, pool.Init(commissioners, &ctx.GetSystemLayer(), &delegate) == CHIP_ERROR_INCORRECT_STATE);
+    NL_TEST_ASSERT(inSuite, pool.Commission(1, nullptr, CommissioningParameters()) == CHIP_ERROR_INVALID_ARGUMENT);
+
+    pool.Shutdown();
+    NL_TEST_ASSERT(inSuite, commissioner.GetPairingDelegate() == nullptr);
+}
+
+void TestCommissionInParallel(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+    DeviceCommissioner commissioner1;
+    DeviceCommissioner commissioner2;
+    DeviceCommissioner * commissionerList[] = { &commissioner1, &commissioner2 };
+    Span<DeviceCommissioner * const> commissioners(commissionerList);
+    TestDelegate delegate;
+    TestPool pool;
+
+    NL_TEST_ASSERT(inSuite, pool.Init(commissioners, &ctx.GetSystemLayer(), &delegate) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, pool.Commission(1, kSetUpCode, CommissioningParameters()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, pool.Commission(2, kSetUpCode, CommissioningParameters()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, pool.Commission(3, kSetUpCode, CommissioningParameters()) == CHIP_NO_ERROR);
+
+    // Commissionings start from the event loop, as many at once as there are commissioners.
+    NL_TEST_ASSERT(inSuite, pool.GetActiveCount() == 0);
+    NL_TEST_ASSERT(inSuite, pool.GetQueuedCount() == 3);
+    ctx.DriveIO();
+    NL_TEST_ASSERT(inSuite, pool.GetActiveCount() == 2);
+    NL_TEST_ASSERT(inSuite, pool.GetQueuedCount() == 1);
+    NL_TEST_ASSERT(inSuite, pool.mStarted.size() == 2);
+    NL_TEST_ASSERT(inSuite, pool.mStarted[0] == std::make_pair(&commissioner1, NodeId(1)));
+    NL_TEST_ASSERT(inSuite, pool.mStarted[1] == std::make_pair(&commissioner2, NodeId(2)));
+
+    // Stage updates are reported with the node of the commissioner.
+    commissioner2.GetPairingDelegate()->OnPairingComplete(CHIP_NO_ERROR);
+    commissioner2.GetPairingDelegate()->OnCommissioningStatusUpdate(PeerId(), CommissioningStage::kSendPAICertificateRequest,
+                                                                    CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, delegate.mStatusUpdates.size() == 1);
+    NL_TEST_ASSERT(inSuite, delegate.mStatusUpdates[0].first == 2);
+    NL_TEST_ASSERT(inSuite, delegate.mStatusUpdates[0].second == CommissioningStage::kSendPAICertificateRequest);
+    NL_TEST_ASSERT(inSuite, pool.GetStageLatency(CommissioningStage::kSecurePairing).mCount == 1);
+    NL_TEST_ASSERT(inSuite, pool.GetStageLatency(CommissioningStage::kSendPAICertificateRequest).mCount == 1);
+
+    // The commissioner that completes first takes the queued commissioning, once back in the event loop.
+    commissioner1.GetPairingDelegate()->OnCommissioningComplete(1, CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, delegate.mCompleted.size() == 1);
+    NL_TEST_ASSERT(inSuite, delegate.mCompleted[0].first == 1);
+    NL_TEST_ASSERT(inSuite, delegate.mCompleted[0].second == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, pool.GetActiveCount() == 1);
+    NL_TEST_ASSERT(inSuite, pool.mStarted.size() == 2);
+    ctx.DriveIO();
+    NL_TEST_ASSERT(inSuite, pool.GetActiveCount() == 2);
+    NL_TEST_ASSERT(inSuite, pool.GetQueuedCount() == 0);
+    NL_TEST_ASSERT(inSuite, pool.mStarted.size() == 3);
+    NL_TEST_ASSERT(inSuite, pool.mStarted[2] == std::make_pair(&commissioner1, NodeId(3)));
+
+    // A failed PASE session ends the commissioning.
+    commissioner2.GetPairingDelegate()->OnCommissioningComplete(2, CHIP_ERROR_TIMEOUT);
+    commissioner1.GetPairingDelegate()->OnPairingComplete(CHIP_ERROR_INVALID_PASE_PARAMETER);
+    NL_TEST_ASSERT(inSuite, delegate.mCompleted.size() == 3);
+    NL_TEST_ASSERT(inSuite, delegate.mCompleted[1].first == 2);
+    NL_TEST_ASSERT(inSuite, delegate.mCompleted[1].second == CHIP_ERROR_TIMEOUT);
+    NL_TEST_ASSERT(inSuite, delegate.mCompleted[2].first == 3);
+    NL_TEST_ASSERT(inSuite, delegate.mCompleted[2].second == CHIP_ERROR_INVALID_PASE_PARAMETER);
+    NL_TEST_ASSERT(inSuite, pool.GetActiveCount() == 0);
+
+    // Idle commissioners calling back, as they do while cleaning up, are ignored.
+    commissioner1.GetPairingDelegate()->OnCommissioningComplete(3, CHIP_ERROR_INTERNAL);
+    NL_TEST_ASSERT(inSuite, delegate.mCompleted.size() == 3);
+
+    const CommissioningStageLatency & total = pool.GetStageLatency(CommissioningStage::kCleanup);
+    NL_TEST_ASSERT(inSuite, total.mCount == 3);
+    NL_TEST_ASSERT(inSuite, total.mFailures == 2);
+    NL_TEST_ASSERT(inSuite, pool.GetStageLatency(CommissioningStage::kSecurePairing).mFailures == 1);
+
+    pool.Shutdown();
+    NL_TEST_ASSERT(inSuite, pool.mStopped.empty());
+}
+
+void TestPairDeviceFailure(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+    // Without a default commissioner, PairDevice fails right away.
+    DeviceCommissioner commissioner;
+    DeviceCommissioner * commissionerList[] = { &commissioner };
+    Span<DeviceCommissioner * const> commissioners(commissionerList);
+    TestDelegate delegate;
+    TestPool pool;
+    pool.mUseCommissioners = true;
+
+    NL_TEST_ASSERT(inSuite, pool.Init(commissioners, &ctx.GetSystemLayer(), &delegate) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, pool.Commission(1, kSetUpCode, CommissioningParameters()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, pool.Commission(2, kSetUpCode, CommissioningParameters()) == CHIP_NO_ERROR);
+    ctx.DriveIO();
+
+    // Each failure frees the commissioner for the next queued commissioning.
+    NL_TEST_ASSERT(inSuite, delegate.mCompleted.size() == 2);
+    NL_TEST_ASSERT(inSuite, delegate.mCompleted[0].first == 1);
+    NL_TEST_ASSERT(inSuite, delegate.mCompleted[0].second == CHIP_ERROR_INCORRECT_STATE);
+    NL_TEST_ASSERT(inSuite, delegate.mCompleted[1].first == 2);
+    NL_TEST_ASSERT(inSuite, delegate.mCompleted[1].second == CHIP_ERROR_INCORRECT_STATE);
+    NL_TEST_ASSERT(inSuite, pool.GetActiveCount() == 0);
+    NL_TEST_ASSERT(inSuite, pool.GetQueuedCount() == 0);
+    NL_TEST_ASSERT(inSuite, pool.GetStageLatency(CommissioningStage::kCleanup).mFailures == 2);
+
+    // The pool keeps working afterwards.
+    pool.mUseCommissioners = false;
+    NL_TEST_ASSERT(inSuite, pool.Commission(3, kSetUpCode, CommissioningParameters()) == CHIP_NO_ERROR);
+    ctx.DriveIO();
+    NL_TEST_ASSERT(inSuite, pool.GetActiveCount() == 1);
+    NL_TEST_ASSERT(inSuite, pool.mStarted.size() == 1);
+    NL_TEST_ASSERT(inSuite, pool.mStarted[0] == std::make_pair(&commissioner, NodeId(3)));
+
+    pool.Shutdown();
+}
+
+void TestShutdownWithBusySlots(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+    DeviceCommissioner commissioner1;
+    DeviceCommissioner commissioner2;
+    DeviceCommissioner * commissionerList[] = { &commissioner1, &commissioner2 };
+    Span<DeviceCommissioner * const> commissioners(commissionerList);
+    TestDelegate delegate;
+    TestPool pool;
+
+    NL_TEST_ASSERT(inSuite, pool.Init(commissioners, &ctx.GetSystemLayer(), &delegate) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, pool.Commission(1, kSetUpCode, CommissioningParameters()) == CHIP_NO_ERROR);
+    ctx.DriveIO();
+    NL_TEST_ASSERT(inSuite, pool.Commission(2, kSetUpCode, CommissioningParameters()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, pool.Commission(3, kSetUpCode, CommissioningParameters()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, pool.GetActiveCount() == 1);
+    NL_TEST_ASSERT(inSuite, pool.GetQueuedCount() == 2);
+
+    // Only the running commissioning is stopped; the queued ones are dropped before they start, even though the timer that
+    // would have started them is pending.
+    pool.Shutdown();
+    NL_TEST_ASSERT(inSuite, pool.mStopped.size() == 1);
+    NL_TEST_ASSERT(inSuite, pool.mStopped[0] == std::make_pair(&commissioner1, NodeId(1)));
+    NL_TEST_ASSERT(inSuite, commissioner1.GetPairingDelegate() == nullptr);
+    NL_TEST_ASSERT(inSuite, commissioner2.GetPairingDelegate() == nullptr);
+    NL_TEST_ASSERT(inSuite, pool.GetActiveCount() == 0);
+    NL_TEST_ASSERT(inSuite, pool.GetQueuedCount() == 0);
+
+    ctx.DriveIO();
+    NL_TEST_ASSERT(inSuite, pool.mStarted.size() == 1);
+    NL_TEST_ASSERT(inSuite, delegate.mCompleted.empty());
+    NL_TEST_ASSERT(inSuite, pool.Commission(4, kSetUpCode, CommissioningParameters()) == CHIP_ERROR_INCORRECT_STATE);
+}
+
+class TestAutoCommissioner : public AutoCommissioner
+{
+public:
+    using AutoCommissioner::GetNextCommissioningStage;
+
+    // There is no device to send commands to, so every step after the report fails to start, but the report is recorded.
+    void ReadCommissioningInfo(bool requiresUTC, bool requiresTimeZone)
+    {
+        CommissioningReport report;
+        Controller::ReadCommissioningInfo info;
+        info.requiresUTC      = requiresUTC;
+        info.requiresTimeZone = requiresTimeZone;
+        report.stageCompleted = CommissioningStage::kReadCommissioningInfo;
+        report.Set<Controller::ReadCommissioningInfo>(info);
+        CommissioningStepFinished(CHIP_NO_ERROR, report);
+    }
+
+    void TimeZoneConfigured(CommissioningStage stage, bool requiresDSTOffsets)
+    {
+        CommissioningReport report;
+        report.stageCompleted = stage;
+        report.Set<TimeZoneResponseInfo>(TimeZoneResponseInfo{ requiresDSTOffsets });
+        CommissioningStepFinished(CHIP_NO_ERROR, report);
+    }
+
+    CommissioningStage NextStage(CommissioningStage stage)
+    {
+        CHIP_ERROR err = CHIP_NO_ERROR;
+        return GetNextCommissioningStage(stage, err);
+    }
+};
+
+void TestTimeConfigurationBatch(nlTestSuite * inSuite, void * inContext)
+{
+    using namespace chip::app::Clusters::TimeSynchronization::Structs;
+
+    TimeZoneStruct::Type timeZone;
+    timeZone.offset  = 3600;
+    timeZone.validAt = 0;
+    DSTOffsetStruct::Type dstOffset;
+    dstOffset.offset        = 3600;
+    dstOffset.validStarting = 0;
+
+    CommissioningParameters params;
+    params.SetTimeZone(app::DataModel::List<TimeZoneStruct::Type>(&timeZone, 1));
+    params.SetDSTOffsets(app::DataModel::List<DSTOffsetStruct::Type>(&dstOffset, 1));
+
+    // By default, the time configuration commands go one per Invoke.
+    {
+        TestAutoCommissioner commissioner;
+        NL_TEST_ASSERT(inSuite, commissioner.SetCommissioningParameters(params) == CHIP_NO_ERROR);
+        commissioner.ReadCommissioningInfo(true, true);
+        NL_TEST_ASSERT(inSuite,
+                       commissioner.NextStage(CommissioningStage::kConfigRegulatory) == CommissioningStage::kConfigureUTCTime);
+        NL_TEST_ASSERT(inSuite,
+                       commissioner.NextStage(CommissioningStage::kConfigureUTCTime) == CommissioningStage::kConfigureTimeZone);
+    }
+
+    params.SetRemoteMaxPathsPerInvoke(2);
+
+    // SetUTCTime and SetTimeZone go together; SetDSTOffset follows if the SetTimeZone response asks for it.
+    {
+        TestAutoCommissioner commissioner;
+        NL_TEST_ASSERT(inSuite, commissioner.SetCommissioningParameters(params) == CHIP_NO_ERROR);
+        commissioner.ReadCommissioningInfo(true, true);
+        NL_TEST_ASSERT(inSuite,
+                       commissioner.NextStage(CommissioningStage::kConfigRegulatory) == CommissioningStage::kConfigureTimeBatch);
+        commissioner.TimeZoneConfigured(CommissioningStage::kConfigureTimeBatch, true);
+        NL_TEST_ASSERT(inSuite,
+                       commissioner.NextStage(CommissioningStage::kConfigureTimeBatch) == CommissioningStage::kConfigureDSTOffset);
+        commissioner.TimeZoneConfigured(CommissioningStage::kConfigureTimeBatch, false);
+        NL_TEST_ASSERT(inSuite,
+                       commissioner.NextStage(CommissioningStage::kConfigureTimeBatch) ==
+                           commissioner.NextStage(CommissioningStage::kConfigureDSTOffset));
+    }
+
+    // With nothing to batch with, SetUTCTime goes alone.
+    {
+        TestAutoCommissioner commissioner;
+        NL_TEST_ASSERT(inSuite, commissioner.SetCommissioningParameters(params) == CHIP_NO_ERROR);
+        commissioner.ReadCommissioningInfo(true, false);
+        NL_TEST_ASSERT(inSuite,
+                       commissioner.NextStage(CommissioningStage::kConfigRegulatory) == CommissioningStage::kConfigureUTCTime);
+    }
+}
+
+void TestStageLatencyBuckets(nlTestSuite * inSuite, void * inContext)
+{
+    CommissioningStageLatency latency;
+
+    latency.Record(0_ms64, CHIP_NO_ERROR);
+    latency.Record(1_ms64, CHIP_NO_ERROR);
+    latency.Record(3_ms64, CHIP_NO_ERROR);
+    latency.Record(4_ms64, CHIP_ERROR_TIMEOUT);
+    latency.Record(1000_ms64, CHIP_NO_ERROR);
+    latency.Record(System::Clock::Milliseconds64(1ull << 40), CHIP_ERROR_TIMEOUT);
+
+    NL_TEST_ASSERT(inSuite, latency.mCount == 6);
+    NL_TEST_ASSERT(inSuite, latency.mFailures == 2);
+    NL_TEST_ASSERT(inSuite, latency.mMax == System::Clock::Milliseconds64(1ull << 40));
+    NL_TEST_ASSERT(inSuite, latency.mTotal == System::Clock::Milliseconds64(1008 + (1ull << 40)));
+
+    NL_TEST_ASSERT(inSuite, latency.mBuckets[0] == 1);
+    NL_TEST_ASSERT(inSuite, latency.mBuckets[1] == 1);
+    NL_TEST_ASSERT(inSuite, latency.mBuckets[2] == 1);
+    NL_TEST_ASSERT(inSuite, latency.mBuckets[3] == 1);
+    NL_TEST_ASSERT(inSuite, latency.mBuckets[10] == 1);
+    NL_TEST_ASSERT(inSuite, latency.mBuckets[CommissioningStageLatency::kBucketCount - 1] == 1);
+}
+
+void TestStageLatencyBucketBounds(nlTestSuite * inSuite, void * inContext)
+{
+    // Every latency lands in the first bucket whose upper bound is above it.
+    for (uint64_t ms = 0; ms < (1ull << (CommissioningStageLatency::kBucketCount + 1)); ms = ms * 3 / 2 + 1)
+    {
+        System::Clock::Milliseconds64 value(ms);
+        CommissioningStageLatency latency;
+        latency.Record(value, CHIP_NO_ERROR);
+
+        size_t bucket = 0;
+        while (latency.mBuckets[bucket] == 0)
+        {
+            bucket++;
+        }
+        NL_TEST_ASSERT(inSuite, value < CommissioningStageLatency::GetBucketUpperBound(bucket));
+        NL_TEST_ASSERT(inSuite, bucket == 0 || value >= CommissioningStageLatency::GetBucketUpperBound(bucket - 1));
+    }
+}
+
+// clang-format off
+const nlTest sTests[] =
+{
+    NL_TEST_DEF("TestStageLatencyBuckets", TestStageLatencyBuckets),
+    NL_TEST_DEF("TestStageLatencyBucketBounds", TestStageLatencyBucketBounds),
+    NL_TEST_DEF("TestInit", TestInit),
+    NL_TEST_DEF("TestCommissionInParallel", TestCommissionInParallel),
+    NL_TEST_DEF("TestPairDeviceFailure", TestPairDeviceFailure),
+    NL_TEST_DEF("TestShutdownWithBusySlots", TestShutdownWithBusySlots),
+    NL_TEST_DEF("TestTimeConfigurationBatch", TestTimeConfigurationBatch),
+    NL_TEST_SENTINEL()
+};
+// clang-format on
+
+int Initialize(void * aContext)
+{
+    CHIP_ERROR err = static_cast<TestContext *>(aContext)->Init();
+    return (err == CHIP_NO_ERROR) ? SUCCESS : FAILURE;
+}
+
+int Finalize(void * aContext)
+{
+    static_cast<TestContext *>(aContext)->Shutdown();
+    return SUCCESS;
+}
+
+// clang-format off
+nlTestSuite sSuite =
+{
+    "CommissioningPool",
+    &sTests[0],
+    Initialize,
+    Finalize
+};
+// clang-format on
+
+} // namespace
+
+int TestCommissioningPool()
+{
+    return chip::ExecuteTestsWithContext<TestContext>(&sSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestCommissioningPool)
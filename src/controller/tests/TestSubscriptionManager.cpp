@@ -0,0 +1,521 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app-common/zap-generated/ids/Clusters.h>
+#include <app/AttributeAccessInterface.h>
+#include <app/InteractionModelEngine.h>
+#include <app/tests/AppTestContext.h>
+#include <app/util/DataModelHandler.h>
+#include <app/util/attribute-storage.h>
+#include <controller/SubscriptionManager.h>
+#include <lib/support/FibonacciUtils.h>
+#include <lib/support/UnitTestContext.h>
+#include <lib/support/UnitTestRegistration.h>
+#include <nlunit-test.h>
+
+using TestContext = chip::Test::AppContext;
+using namespace chip;
+using namespace chip::Controller;
+using namespace chip::System::Clock::Literals;
+
+namespace {
+
+constexpr NodeId kTestNodeId      = 0x1234;
+constexpr NodeId kOtherTestNodeId = 0x5678;
+
+//
+// The generated endpoint_config for the controller app has Endpoint 1
+// already used in the fixed endpoint set of size 1. Consequently, let's use the next
+// number higher than that for our dynamic test endpoint.
+//
+constexpr EndpointId kTestEndpointId   = 2;
+constexpr AttributeId kTestAttributeId = 1;
+
+//clang-format off
+DECLARE_DYNAMIC_ATTRIBUTE_LIST_BEGIN(testClusterAttrs)
+DECLARE_DYNAMIC_ATTRIBUTE(kTestAttributeId, INT8U, 1, 0), DECLARE_DYNAMIC_ATTRIBUTE_LIST_END();
+
+DECLARE_DYNAMIC_CLUSTER_LIST_BEGIN(testEndpointClusters)
+DECLARE_DYNAMIC_CLUSTER(app::Clusters::UnitTesting::Id, testClusterAttrs, nullptr, nullptr), DECLARE_DYNAMIC_CLUSTER_LIST_END;
+
+DECLARE_DYNAMIC_ENDPOINT(testEndpoint, testEndpointClusters);
+//clang-format on
+
+class TestAttrAccess : public app::AttributeAccessInterface
+{
+public:
+    // Register for the Test Cluster cluster on all endpoints.
+    TestAttrAccess() : AttributeAccessInterface(Optional<EndpointId>::Missing(), app::Clusters::UnitTesting::Id)
+    {
+        registerAttributeAccessOverride(this);
+    }
+
+    CHIP_ERROR Read(const app::ConcreteReadAttributePath & aPath, app::AttributeValueEncoder & aEncoder) override
+    {
+        return aEncoder.Encode(static_cast<uint8_t>(aPath.mAttributeId));
+    }
+};
+
+TestAttrAccess gAttrAccess;
+
+// Registers the dynamic endpoint subscribed to by the tests, for as long as it is in scope.
+class ScopedTestEndpoint
+{
+public:
+    ScopedTestEndpoint()
+    {
+        InitDataModelHandler();
+        emberAfSetDynamicEndpoint(0, kTestEndpointId, &testEndpoint, Span<DataVersion>(mDataVersionStorage));
+    }
+    ~ScopedTestEndpoint() { emberAfClearDynamicEndpoint(0); }
+
+private:
+    DataVersion mDataVersionStorage[ArraySize(testEndpointClusters)];
+};
+
+class TestCallback : public app::ReadClient::Callback
+{
+public:
+    void OnSubscriptionEstablished(SubscriptionId aSubscriptionId) override { mEstablishedCount++; }
+    void OnError(CHIP_ERROR aError) override
+    {
+        mErrorCount++;
+        mLastError = aError;
+    }
+    void OnDone(app::ReadClient * apReadClient) override { mDoneCount++; }
+    void OnDeallocatePaths(app::ReadPrepareParams && aReadPrepareParams) override { mDeallocatePathsCount++; }
+
+    int mEstablishedCount     = 0;
+    int mErrorCount           = 0;
+    int mDoneCount            = 0;
+    int mDeallocatePathsCount = 0;
+    CHIP_ERROR mLastError     = CHIP_NO_ERROR;
+};
+
+// Runs the manager over the loopback session from Bob to Alice instead of CASE sessions from a DeviceController. As with
+// OperationalSessionSetup, the connection callbacks are queued until the connection completes, which happens right away unless
+// mConnectImmediately is cleared, and then when the test calls CompleteConnections or FailConnections.
+class LoopbackSubscriptionManager : public SubscriptionManager
+{
+public:
+    LoopbackSubscriptionManager(TestContext & ctx, const SubscriptionManagerConfig & config) :
+        SubscriptionManager(nullptr, &ctx.GetSystemLayer(), config), mCtx(ctx)
+    {}
+
+    void CompleteConnections()
+    {
+        CancelAll(mConnectionFailure);
+        while (mConnectionSuccess.First() != nullptr)
+        {
+            auto * callback = Callback::Callback<OnDeviceConnected>::FromCancelable(mConnectionSuccess.First());
+            callback->Cancel();
+            callback->mCall(callback->mContext, mCtx.GetExchangeManager(), mCtx.GetSessionBobToAlice());
+        }
+    }
+
+    void FailConnections(CHIP_ERROR error)
+    {
+        CancelAll(mConnectionSuccess);
+        while (mConnectionFailure.First() != nullptr)
+        {
+            auto * callback = Callback::Callback<OnDeviceConnectionFailure>::FromCancelable(mConnectionFailure.First());
+            callback->Cancel();
+            callback->mCall(callback->mContext, ScopedNodeId(), error);
+        }
+    }
+
+    bool HasPendingConnections() { return !mConnectionSuccess.IsEmpty() || !mConnectionFailure.IsEmpty(); }
+
+    bool mConnectImmediately = true;
+    int mConnectionCount     = 0;
+    // Whether the session was defunct when the last connection was requested.
+    bool mSessionWasDefunct = false;
+
+protected:
+    Messaging::ExchangeManager * GetExchangeManager() const override { return &mCtx.GetExchangeManager(); }
+
+    CHIP_ERROR GetConnectedDevice(NodeId nodeId, Callback::Callback<OnDeviceConnected> * onConnection,
+                                  Callback::Callback<OnDeviceConnectionFailure> * onFailure) override
+    {
+        mConnectionCount++;
+
+        // A DeviceController would set up a new CASE session in place of a defunct one.
+        Transport::SecureSession * session = mCtx.GetSessionBobToAlice()->AsSecureSession();
+        mSessionWasDefunct                 = session->IsDefunct();
+        session->MarkActiveRx();
+
+        mConnectionSuccess.Enqueue(onConnection->Cancel());
+        mConnectionFailure.Enqueue(onFailure->Cancel());
+        if (mConnectImmediately)
+        {
+            CompleteConnections();
+        }
+        return CHIP_NO_ERROR;
+    }
+
+private:
+    static void CancelAll(Callback::CallbackDeque & deque)
+    {
+        while (deque.First() != nullptr)
+        {
+            deque.First()->Cancel();
+        }
+    }
+
+    TestContext & mCtx;
+    Callback::CallbackDeque mConnectionSuccess;
+    Callback::CallbackDeque mConnectionFailure;
+};
+
+// Paths for a subscription to the test attribute. They outlive the subscriptions, so OnDeallocatePaths has nothing to free.
+app::AttributePathParams gAttributePath(kTestEndpointId, app::Clusters::UnitTesting::Id, kTestAttributeId);
+
+app::ReadPrepareParams MakeReadPrepareParams()
+{
+    app::ReadPrepareParams params;
+    params.mpAttributePathParamsList    = &gAttributePath;
+    params.mAttributePathParamsListSize = 1;
+    params.mMaxIntervalCeilingSeconds   = 1;
+    return params;
+}
+
+SubscriptionManagerConfig MakeTestConfig()
+{
+    SubscriptionManagerConfig config;
+    config.mMaxInitialJitterMs = 0;
+    config.mAttemptsPerSecond  = 0;
+    return config;
+}
+
+// Shuts down the subscriptions the manager left on the publisher, once the manager is gone.
+void ShutdownPublisher(nlTestSuite * inSuite, TestContext & ctx)
+{
+    app::InteractionModelEngine::GetInstance()->ShutdownActiveReads();
+    ctx.DrainAndServiceIO();
+    NL_TEST_ASSERT(inSuite, ctx.GetExchangeManager().GetNumActiveExchanges() == 0);
+}
+
+void TestPacerConcurrencyCap(nlTestSuite * inSuite, void * inContext)
+{
+    SubscriptionManagerConfig config;
+    config.mMaxInFlightNodes  = 2;
+    config.mAttemptsPerSecond = 0;
+
+    SubscriptionAttemptPacer pacer;
+    pacer.Init(config, 1000_ms64);
+
+    NL_TEST_ASSERT(inSuite, pacer.TryStartAttempt(1000_ms64));
+    NL_TEST_ASSERT(inSuite, pacer.TryStartAttempt(1000_ms64));
+    NL_TEST_ASSERT(inSuite, !pacer.HasInFlightSlot());
+    NL_TEST_ASSERT(inSuite, !pacer.TryStartAttempt(5000_ms64));
+    NL_TEST_ASSERT(inSuite, pacer.GetInFlight() == 2);
+
+    pacer.EndAttempt();
+    NL_TEST_ASSERT(inSuite, pacer.TryStartAttempt(5000_ms64));
+    NL_TEST_ASSERT(inSuite, !pacer.TryStartAttempt(5000_ms64));
+}
+
+void TestPacerRateLimit(nlTestSuite * inSuite, void * inContext)
+{
+    SubscriptionManagerConfig config;
+    config.mMaxInFlightNodes  = 100;
+    config.mAttemptsPerSecond = 10;
+    config.mAttemptBurst      = 3;
+
+    SubscriptionAttemptPacer pacer;
+    pacer.Init(config, 1000_ms64);
+
+    // The burst goes through back to back, then attempts are 100ms apart.
+    for (int i = 0; i < 3; i++)
+    {
+        NL_TEST_ASSERT(inSuite, pacer.TryStartAttempt(1000_ms64));
+    }
+    NL_TEST_ASSERT(inSuite, !pacer.TryStartAttempt(1000_ms64));
+    NL_TEST_ASSERT(inSuite, pacer.GetNextTokenTime() == 1100_ms64);
+
+    NL_TEST_ASSERT(inSuite, !pacer.TryStartAttempt(1099_ms64));
+    NL_TEST_ASSERT(inSuite, pacer.TryStartAttempt(1150_ms64));
+    NL_TEST_ASSERT(inSuite, !pacer.TryStartAttempt(1150_ms64));
+    NL_TEST_ASSERT(inSuite, pacer.GetNextTokenTime() == 1200_ms64);
+    NL_TEST_ASSERT(inSuite, pacer.TryStartAttempt(1200_ms64));
+
+    // A long pause refills no more than the burst.
+    for (int i = 0; i < 3; i++)
+    {
+        NL_TEST_ASSERT(inSuite, pacer.TryStartAttempt(60000_ms64));
+    }
+    NL_TEST_ASSERT(inSuite, !pacer.TryStartAttempt(60000_ms64));
+    NL_TEST_ASSERT(inSuite, pacer.GetInFlight() == 8);
+}
+
+void TestBackoff(nlTestSuite * inSuite, void * inContext)
+{
+    // The first retry is immediate, as with ReadClient::ComputeTimeTillNextSubscription.
+    NL_TEST_ASSERT(inSuite, SubscriptionManager::ComputeBackoffMs(0) == 0);
+
+    for (uint32_t retries = 1; retries < CHIP_RESUBSCRIBE_MAX_FIBONACCI_STEP_INDEX + 5; retries++)
+    {
+        uint32_t maxMs = CHIP_RESUBSCRIBE_MAX_RETRY_WAIT_INTERVAL_MS;
+        if (retries <= CHIP_RESUBSCRIBE_MAX_FIBONACCI_STEP_INDEX)
+        {
+            maxMs = GetFibonacciForIndex(retries) * CHIP_RESUBSCRIBE_WAIT_TIME_MULTIPLIER_MS;
+        }
+        uint32_t minMs = CHIP_RESUBSCRIBE_MIN_WAIT_TIME_INTERVAL_PERCENT_PER_STEP * maxMs / 100;
+
+        for (int i = 0; i < 20; i++)
+        {
+            uint32_t backoffMs = SubscriptionManager::ComputeBackoffMs(retries);
+            NL_TEST_ASSERT(inSuite, backoffMs >= minMs && backoffMs < maxMs);
+        }
+    }
+}
+
+void TestSessionSharing(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+    ScopedTestEndpoint endpoint;
+    TestCallback callback;
+
+    {
+        LoopbackSubscriptionManager manager(ctx, MakeTestConfig());
+        SubscriptionManager::Subscription * subscription1 = nullptr;
+        SubscriptionManager::Subscription * subscription2 = nullptr;
+
+        NL_TEST_ASSERT(inSuite, manager.Subscribe(kTestNodeId, MakeReadPrepareParams(), callback, &subscription1) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, manager.Subscribe(kTestNodeId, MakeReadPrepareParams(), callback, &subscription2) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, manager.GetMetrics().mWaiting == 2);
+        NL_TEST_ASSERT(inSuite, manager.GetMetrics().mNodes == 1);
+
+        ctx.DrainAndServiceIO();
+
+        // Both subscriptions went over the one session set up for their node.
+        NL_TEST_ASSERT(inSuite, manager.mConnectionCount == 1);
+        NL_TEST_ASSERT(inSuite, callback.mEstablishedCount == 2);
+        NL_TEST_ASSERT(inSuite, subscription1->IsEstablished() && subscription2->IsEstablished());
+        NL_TEST_ASSERT(inSuite,
+                       app::InteractionModelEngine::GetInstance()->GetNumActiveReadHandlers(
+                           app::ReadHandler::InteractionType::Subscribe) == 2);
+
+        SubscriptionManagerMetrics metrics = manager.GetMetrics();
+        NL_TEST_ASSERT(inSuite, metrics.mEstablished == 2);
+        NL_TEST_ASSERT(inSuite, metrics.mInFlightNodes == 0);
+        NL_TEST_ASSERT(inSuite, metrics.mTotalEstablishments == 2);
+        NL_TEST_ASSERT(inSuite, metrics.mTotalSessionFailures == 0);
+
+        // Unsubscribing one of them leaves the other established on the shared session.
+        manager.Unsubscribe(subscription1);
+        ctx.DrainAndServiceIO();
+        NL_TEST_ASSERT(inSuite, manager.GetMetrics().mNodes == 1);
+        NL_TEST_ASSERT(inSuite, subscription2->IsEstablished());
+        NL_TEST_ASSERT(inSuite, callback.mDeallocatePathsCount == 1);
+    }
+
+    // Started subscriptions hand their paths back through their ReadClient as they are shut down.
+    NL_TEST_ASSERT(inSuite, callback.mErrorCount == 0);
+    NL_TEST_ASSERT(inSuite, callback.mDoneCount == 0);
+    NL_TEST_ASSERT(inSuite, callback.mDeallocatePathsCount == 2);
+    ShutdownPublisher(inSuite, ctx);
+}
+
+void TestUnsubscribeWhileConnecting(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+    ScopedTestEndpoint endpoint;
+    TestCallback callback;
+
+    {
+        SubscriptionManagerConfig config = MakeTestConfig();
+        config.mMaxInFlightNodes         = 1;
+
+        LoopbackSubscriptionManager manager(ctx, config);
+        SubscriptionManager::Subscription * subscription1 = nullptr;
+        SubscriptionManager::Subscription * subscription2 = nullptr;
+        SubscriptionManager::Subscription * subscription3 = nullptr;
+
+        manager.mConnectImmediately = false;
+        NL_TEST_ASSERT(inSuite, manager.Subscribe(kTestNodeId, MakeReadPrepareParams(), callback, &subscription1) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, manager.Subscribe(kTestNodeId, MakeReadPrepareParams(), callback, &subscription2) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite,
+                       manager.Subscribe(kOtherTestNodeId, MakeReadPrepareParams(), callback, &subscription3) == CHIP_NO_ERROR);
+
+        // Subscriptions are attempted in order of being due, so the first node takes the only in-flight slot.
+        ctx.DrainAndServiceIO();
+        NL_TEST_ASSERT(inSuite, manager.mConnectionCount == 1);
+        NL_TEST_ASSERT(inSuite, manager.GetMetrics().mInFlightNodes == 1);
+        NL_TEST_ASSERT(inSuite, manager.GetMetrics().mWaiting == 1);
+
+        // The attempt goes on for the subscription that is left, and a subscription that never started hands its paths back.
+        manager.Unsubscribe(subscription1);
+        NL_TEST_ASSERT(inSuite, callback.mDeallocatePathsCount == 1);
+        ctx.DrainAndServiceIO();
+        NL_TEST_ASSERT(inSuite, manager.GetMetrics().mInFlightNodes == 1);
+        NL_TEST_ASSERT(inSuite, manager.mConnectionCount == 1);
+
+        // Once its subscription is established, the first node frees its slot for the other node.
+        manager.CompleteConnections();
+        ctx.DrainAndServiceIO();
+        NL_TEST_ASSERT(inSuite, subscription2->IsEstablished());
+        NL_TEST_ASSERT(inSuite, callback.mEstablishedCount == 1);
+        NL_TEST_ASSERT(inSuite, manager.mConnectionCount == 2);
+        NL_TEST_ASSERT(inSuite, manager.GetMetrics().mInFlightNodes == 1);
+        NL_TEST_ASSERT(inSuite, manager.GetMetrics().mNodes == 2);
+        NL_TEST_ASSERT(inSuite, manager.HasPendingConnections());
+
+        // Unsubscribing the only subscription of the other node ends its attempt. The node is then removed along with the
+        // connection callbacks it still had registered.
+        manager.Unsubscribe(subscription3);
+        NL_TEST_ASSERT(inSuite, callback.mDeallocatePathsCount == 2);
+        NL_TEST_ASSERT(inSuite, manager.GetMetrics().mInFlightNodes == 0);
+        ctx.DrainAndServiceIO();
+        NL_TEST_ASSERT(inSuite, manager.GetMetrics().mNodes == 1);
+        NL_TEST_ASSERT(inSuite, !manager.HasPendingConnections());
+        NL_TEST_ASSERT(inSuite, manager.GetMetrics().mSubscriptions == 1);
+        NL_TEST_ASSERT(inSuite, manager.GetMetrics().mTotalSessionFailures == 0);
+    }
+
+    NL_TEST_ASSERT(inSuite, callback.mErrorCount == 0);
+    NL_TEST_ASSERT(inSuite, callback.mDoneCount == 0);
+    ShutdownPublisher(inSuite, ctx);
+}
+
+void TestRemoveFinished(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+    ScopedTestEndpoint endpoint;
+    TestCallback callback;
+    TestCallback failingCallback;
+
+    {
+        LoopbackSubscriptionManager manager(ctx, MakeTestConfig());
+        SubscriptionManager::Subscription * subscription = nullptr;
+
+        // A min interval floor above the max interval ceiling fails the subscribe request before anything is sent.
+        app::ReadPrepareParams invalidParams1   = MakeReadPrepareParams();
+        app::ReadPrepareParams invalidParams2   = MakeReadPrepareParams();
+        invalidParams1.mMinIntervalFloorSeconds = 2;
+        invalidParams2.mMinIntervalFloorSeconds = 2;
+
+        manager.mConnectImmediately = false;
+        NL_TEST_ASSERT(inSuite, manager.Subscribe(kTestNodeId, MakeReadPrepareParams(), callback, &subscription) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, manager.Subscribe(kTestNodeId, std::move(invalidParams1), failingCallback) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, manager.Subscribe(kOtherTestNodeId, std::move(invalidParams2), failingCallback) == CHIP_NO_ERROR);
+        ctx.DrainAndServiceIO();
+        NL_TEST_ASSERT(inSuite, manager.mConnectionCount == 2);
+        NL_TEST_ASSERT(inSuite, manager.GetMetrics().mInFlightNodes == 2);
+
+        manager.CompleteConnections();
+        ctx.DrainAndServiceIO();
+        NL_TEST_ASSERT(inSuite, subscription->IsEstablished());
+        NL_TEST_ASSERT(inSuite, failingCallback.mErrorCount == 2);
+        NL_TEST_ASSERT(inSuite, failingCallback.mLastError == CHIP_ERROR_INVALID_ARGUMENT);
+        NL_TEST_ASSERT(inSuite, failingCallback.mDoneCount == 2);
+        NL_TEST_ASSERT(inSuite, failingCallback.mDeallocatePathsCount == 2);
+
+        // The finished subscriptions are dropped. The first node stays for its established subscription, while the other
+        // node has none left and goes.
+        SubscriptionManagerMetrics metrics = manager.GetMetrics();
+        NL_TEST_ASSERT(inSuite, metrics.mSubscriptions == 1);
+        NL_TEST_ASSERT(inSuite, metrics.mEstablished == 1);
+        NL_TEST_ASSERT(inSuite, metrics.mNodes == 1);
+        NL_TEST_ASSERT(inSuite, metrics.mInFlightNodes == 0);
+
+        manager.Unsubscribe(subscription);
+        ctx.DrainAndServiceIO();
+        NL_TEST_ASSERT(inSuite, manager.GetMetrics().mNodes == 0);
+    }
+
+    NL_TEST_ASSERT(inSuite, callback.mErrorCount == 0);
+    NL_TEST_ASSERT(inSuite, callback.mDoneCount == 0);
+    ShutdownPublisher(inSuite, ctx);
+}
+
+void TestResubscription(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+    ScopedTestEndpoint endpoint;
+    TestCallback callback;
+
+    ctx.SetMRPMode(chip::Test::MessagingContext::MRPMode::kResponsive);
+
+    {
+        LoopbackSubscriptionManager manager(ctx, MakeTestConfig());
+        SubscriptionManager::Subscription * subscription = nullptr;
+
+        NL_TEST_ASSERT(inSuite, manager.Subscribe(kTestNodeId, MakeReadPrepareParams(), callback, &subscription) == CHIP_NO_ERROR);
+        ctx.GetIOContext().DriveIOUntil(System::Clock::Milliseconds32(2000), [&]() { return callback.mEstablishedCount >= 1; });
+        NL_TEST_ASSERT(inSuite, subscription->IsEstablished());
+        NL_TEST_ASSERT(inSuite, manager.mConnectionCount == 1);
+
+        //
+        // Disable packet transmission, and drive IO till the subscription times out and the manager takes it over.
+        //
+        ctx.GetLoopback().mNumMessagesToDrop = chip::Test::LoopbackTransport::kUnlimitedMessageCount;
+        ctx.GetIOContext().DriveIOUntil(System::Clock::Seconds16(10), [&]() { return manager.GetMetrics().mTotalDrops > 0; });
+        NL_TEST_ASSERT(inSuite, manager.GetMetrics().mTotalDrops == 1);
+        NL_TEST_ASSERT(inSuite, !subscription->IsEstablished());
+
+        //
+        // The timeout calls for a new session, so the node connects again before the ReadClient resubscribes.
+        //
+        ctx.GetLoopback().mNumMessagesToDrop = 0;
+        ctx.GetIOContext().DriveIOUntil(System::Clock::Milliseconds32(2000), [&]() { return callback.mEstablishedCount >= 2; });
+        NL_TEST_ASSERT(inSuite, callback.mEstablishedCount == 2);
+        NL_TEST_ASSERT(inSuite, subscription->IsEstablished());
+        NL_TEST_ASSERT(inSuite, manager.mConnectionCount == 2);
+        NL_TEST_ASSERT(inSuite, manager.mSessionWasDefunct);
+        NL_TEST_ASSERT(inSuite, manager.GetMetrics().mTotalEstablishments == 2);
+    }
+
+    // The ReadClient never gave up on its own.
+    NL_TEST_ASSERT(inSuite, callback.mErrorCount == 0);
+    NL_TEST_ASSERT(inSuite, callback.mDoneCount == 0);
+
+    ctx.SetMRPMode(chip::Test::MessagingContext::MRPMode::kDefault);
+    ShutdownPublisher(inSuite, ctx);
+}
+
+// clang-format off
+const nlTest sTests[] =
+{
+    NL_TEST_DEF("TestPacerConcurrencyCap", TestPacerConcurrencyCap),
+    NL_TEST_DEF("TestPacerRateLimit", TestPacerRateLimit),
+    NL_TEST_DEF("TestBackoff", TestBackoff),
+    NL_TEST_DEF("TestSessionSharing", TestSessionSharing),
+    NL_TEST_DEF("TestUnsubscribeWhileConnecting", TestUnsubscribeWhileConnecting),
+    NL_TEST_DEF("TestRemoveFinished", TestRemoveFinished),
+    NL_TEST_DEF("TestResubscription", TestResubscription),
+    NL_TEST_SENTINEL()
+};
+
+nlTestSuite sSuite =
+{
+    "SubscriptionManager",
+    &sTests[0],
+    TestContext::Initialize,
+    TestContext::Finalize
+};
+// clang-format on
+
+} // namespace
+
+int TestSubscriptionManager()
+{
+    return chip::ExecuteTestsWithContext<TestContext>(&sSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestSubscriptionManager)
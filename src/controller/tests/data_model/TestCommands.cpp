@@ -192,6 +192,7 @@ public:
     static void TestMultipleFailures(nlTestSuite * apSuite, void * apContext);
     static void TestSuccessNoDataResponseWithClusterStatus(nlTestSuite * apSuite, void * apContext);
     static void TestFailureWithClusterStatus(nlTestSuite * apSuite, void * apContext);
+    static void TestBatchedResponses(nlTestSuite * apSuite, void * apContext);
 
 private:
 };
@@ -540,6 +541,53 @@ void TestCommandInteraction::TestFailureWithClusterStatus(nlTestSuite * apSuite,
     NL_TEST_ASSERT(apSuite, ctx.GetExchangeManager().GetNumActiveExchanges() == 0);
 }
 
+void TestCommandInteraction::TestBatchedResponses(nlTestSuite * apSuite, void * apContext)
+{
+    struct FakeRequest : public Clusters::UnitTesting::Commands::TestSimpleArgumentRequest::Type
+    {
+        using ResponseType = DataModel::NullObjectType;
+    };
+
+    TestContext & ctx = *static_cast<TestContext *>(apContext);
+    Controller::CommandRequest<FakeRequest> requests[2];
+    auto sessionHandle = ctx.GetSessionBobToAlice();
+
+    bool onSuccessWasCalled[2] = {};
+    CHIP_ERROR errors[2]       = { CHIP_NO_ERROR, CHIP_NO_ERROR };
+
+    // The mock only has the cluster on kTestEndpointId, so the second command fails on its own.
+    requests[0].endpointId              = kTestEndpointId;
+    requests[0].requestCommandData.arg1 = true;
+    requests[1].endpointId              = kTestEndpointId + 1;
+    requests[1].requestCommandData.arg1 = true;
+
+    // Passing of stack variables by reference is only safe because of synchronous completion of the interaction. Otherwise, it's
+    // not safe to do so.
+    auto onSuccessCb = [&onSuccessWasCalled](uint16_t commandRef, const app::ConcreteCommandPath & commandPath,
+                                             const app::StatusIB & aStatus, const auto & dataResponse) {
+        onSuccessWasCalled[commandRef] = true;
+    };
+
+    // Passing of stack variables by reference is only safe because of synchronous completion of the interaction. Otherwise, it's
+    // not safe to do so.
+    auto onFailureCb = [&errors](uint16_t commandRef, CHIP_ERROR aError) { errors[commandRef] = aError; };
+
+    responseDirective = kSendSuccessStatusCode;
+
+    NL_TEST_ASSERT(apSuite,
+                   chip::Controller::InvokeCommandRequests(&ctx.GetExchangeManager(), sessionHandle,
+                                                           Span<const Controller::CommandRequest<FakeRequest>>(requests),
+                                                           onSuccessCb, onFailureCb) == CHIP_NO_ERROR);
+
+    ctx.DrainAndServiceIO();
+
+    NL_TEST_ASSERT(apSuite, onSuccessWasCalled[0] && errors[0] == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite,
+                   !onSuccessWasCalled[1] &&
+                       errors[1] == StatusIB(Protocols::InteractionModel::Status::UnsupportedEndpoint).ToChipError());
+    NL_TEST_ASSERT(apSuite, ctx.GetExchangeManager().GetNumActiveExchanges() == 0);
+}
+
 // clang-format off
 const nlTest sTests[] =
 {
@@ -551,6 +599,7 @@ const nlTest sTests[] =
     NL_TEST_DEF("TestMultipleFailures", TestCommandInteraction::TestMultipleFailures),
     NL_TEST_DEF("TestSuccessNoDataResponseWithClusterStatus", TestCommandInteraction::TestSuccessNoDataResponseWithClusterStatus),
     NL_TEST_DEF("TestFailureWithClusterStatus", TestCommandInteraction::TestFailureWithClusterStatus),
+    NL_TEST_DEF("TestBatchedResponses", TestCommandInteraction::TestBatchedResponses),
     NL_TEST_SENTINEL()
 };
 // clang-format on
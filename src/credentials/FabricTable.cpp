@@ -1886,6 +1886,10 @@ CHIP_ERROR FabricTable::CommitPendingFabricData()
         // This scope block is to illustrate the complete commit transaction
         // state. We can see it contains a LARGE number of items...
 
+        // The writes below go to storage as one batch, after the commit marker, so that
+        // a reboot before they are all applied is still cleaned-up on next init.
+        PersistentStorageBatch storageBatch(mStorage);
+
         // Atomically assume data no longer pending, since we are committing it. Do so here
         // so that FindFabricBy* will return real data and never pending.
         mStateFlags.Clear(StateFlags::kIsPendingFabricDataPresent);
@@ -1980,6 +1984,13 @@ CHIP_ERROR FabricTable::CommitPendingFabricData()
             }
         }
         stickyError = (stickyError != CHIP_NO_ERROR) ? stickyError : fabricIndexErr;
+
+        CHIP_ERROR batchErr = storageBatch.Commit();
+        if (batchErr != CHIP_NO_ERROR)
+        {
+            ChipLogError(FabricProvisioning, "Failed to write committed fabric data: %" CHIP_ERROR_FORMAT, batchErr.Format());
+        }
+        stickyError = (stickyError != CHIP_NO_ERROR) ? stickyError : batchErr;
     }
 
     // Commit must have same side-effect as reverting all pending data
@@ -16,6 +16,7 @@
  */
 #include <credentials/GroupDataProviderImpl.h>
 #include <crypto/CHIPCryptoPAL.h>
+#include <lib/core/CHIPPersistentStorageDelegate.h>
 #include <lib/core/TLV.h>
 #include <lib/support/CodeUtils.h>
 #include <lib/support/CommonPersistentData.h>
@@ -24,6 +25,8 @@
 #include <lib/support/Pool.h>
 #include <stdlib.h>
 
+#include <algorithm>
+
 namespace chip {
 namespace Credentials {
 
@@ -831,12 +834,15 @@ void GroupDataProviderImpl::Finish()
     mEndpointIterators.ReleaseAll();
     mKeySetIterators.ReleaseAll();
     mGroupSessionsIterator.ReleaseAll();
+    mCachedGroupSessionIterators.ReleaseAll();
     mGroupKeyContexPool.ReleaseAll();
+    InvalidateGroupSessionCache();
 }
 
 void GroupDataProviderImpl::SetStorageDelegate(PersistentStorageDelegate * storage)
 {
     VerifyOrDie(storage != nullptr);
+    InvalidateGroupSessionCache();
     mStorage = storage;
 }
 
@@ -895,6 +901,7 @@ CHIP_ERROR GroupDataProviderImpl::RemoveGroupInfo(chip::FabricIndex fabric_index
 CHIP_ERROR GroupDataProviderImpl::SetGroupInfoAt(chip::FabricIndex fabric_index, size_t index, const GroupInfo & info)
 {
     VerifyOrReturnError(IsInitialized(), CHIP_ERROR_INTERNAL);
+    PersistentStorageBatch batch(mStorage);
 
     FabricData fabric(fabric_index);
     GroupData group;
@@ -914,7 +921,8 @@ CHIP_ERROR GroupDataProviderImpl::SetGroupInfoAt(chip::FabricIndex fabric_index,
     if (found)
     {
         // Update existing entry
-        return group.Save(mStorage);
+        ReturnErrorOnFailure(group.Save(mStorage));
+        return batch.Commit();
     }
     if (index < fabric.group_count)
     {
@@ -954,6 +962,7 @@ CHIP_ERROR GroupDataProviderImpl::SetGroupInfoAt(chip::FabricIndex fabric_index,
     }
     // Update fabric
     ReturnErrorOnFailure(fabric.Save(mStorage));
+    ReturnErrorOnFailure(batch.Commit());
     GroupAdded(fabric_index, group);
     return CHIP_NO_ERROR;
 }
@@ -977,6 +986,7 @@ CHIP_ERROR GroupDataProviderImpl::GetGroupInfoAt(chip::FabricIndex fabric_index,
 CHIP_ERROR GroupDataProviderImpl::RemoveGroupInfoAt(chip::FabricIndex fabric_index, size_t index)
 {
     VerifyOrReturnError(IsInitialized(), CHIP_ERROR_INTERNAL);
+    PersistentStorageBatch batch(mStorage);
 
     FabricData fabric(fabric_index);
     GroupData group;
@@ -1017,6 +1027,7 @@ CHIP_ERROR GroupDataProviderImpl::RemoveGroupInfoAt(chip::FabricIndex fabric_ind
     }
     // Update fabric info
     ReturnErrorOnFailure(fabric.Save(mStorage));
+    ReturnErrorOnFailure(batch.Commit());
     GroupRemoved(fabric_index, group);
     return CHIP_NO_ERROR;
 }
@@ -1037,6 +1048,7 @@ bool GroupDataProviderImpl::HasEndpoint(chip::FabricIndex fabric_index, chip::Gr
 CHIP_ERROR GroupDataProviderImpl::AddEndpoint(chip::FabricIndex fabric_index, chip::GroupId group_id, chip::EndpointId endpoint_id)
 {
     VerifyOrReturnError(IsInitialized(), CHIP_ERROR_INTERNAL);
+    PersistentStorageBatch batch(mStorage);
 
     FabricData fabric(fabric_index);
     GroupData group;
@@ -1062,6 +1074,7 @@ CHIP_ERROR GroupDataProviderImpl::AddEndpoint(chip::FabricIndex fabric_index, ch
         fabric.first_group = group.group_id;
         fabric.group_count++;
         ReturnErrorOnFailure(fabric.Save(mStorage));
+        ReturnErrorOnFailure(batch.Commit());
         GroupAdded(fabric_index, group);
         return CHIP_NO_ERROR;
     }
@@ -1088,13 +1101,15 @@ CHIP_ERROR GroupDataProviderImpl::AddEndpoint(chip::FabricIndex fabric_index, ch
         ReturnErrorOnFailure(prev.Save(mStorage));
     }
     group.endpoint_count++;
-    return group.Save(mStorage);
+    ReturnErrorOnFailure(group.Save(mStorage));
+    return batch.Commit();
 }
 
 CHIP_ERROR GroupDataProviderImpl::RemoveEndpoint(chip::FabricIndex fabric_index, chip::GroupId group_id,
                                                  chip::EndpointId endpoint_id)
 {
     VerifyOrReturnError(IsInitialized(), CHIP_ERROR_INTERNAL);
+    PersistentStorageBatch batch(mStorage);
 
     FabricData fabric(fabric_index);
     GroupData group;
@@ -1124,11 +1139,13 @@ CHIP_ERROR GroupDataProviderImpl::RemoveEndpoint(chip::FabricIndex fabric_index,
     if (group.endpoint_count > 1)
     {
         group.endpoint_count--;
-        return group.Save(mStorage);
+        ReturnErrorOnFailure(group.Save(mStorage));
+        return batch.Commit();
     }
 
     // No more endpoints, remove the group
-    return RemoveGroupInfoAt(fabric_index, group.index);
+    ReturnErrorOnFailure(RemoveGroupInfoAt(fabric_index, group.index));
+    return batch.Commit();
 }
 
 CHIP_ERROR GroupDataProviderImpl::RemoveEndpoint(chip::FabricIndex fabric_index, chip::EndpointId endpoint_id)
@@ -1319,6 +1336,7 @@ void GroupDataProviderImpl::EndpointIteratorImpl::Release()
 CHIP_ERROR GroupDataProviderImpl::RemoveEndpoints(chip::FabricIndex fabric_index, chip::GroupId group_id)
 {
     VerifyOrReturnError(IsInitialized(), CHIP_ERROR_INTERNAL);
+    PersistentStorageBatch batch(mStorage);
 
     FabricData fabric(fabric_index);
     GroupData group;
@@ -1339,7 +1357,7 @@ CHIP_ERROR GroupDataProviderImpl::RemoveEndpoints(chip::FabricIndex fabric_index
     group.endpoint_count = 0;
     ReturnErrorOnFailure(group.Save(mStorage));
 
-    return CHIP_NO_ERROR;
+    return batch.Commit();
 }
 
 //
@@ -1349,6 +1367,8 @@ CHIP_ERROR GroupDataProviderImpl::RemoveEndpoints(chip::FabricIndex fabric_index
 CHIP_ERROR GroupDataProviderImpl::SetGroupKeyAt(chip::FabricIndex fabric_index, size_t index, const GroupKey & in_map)
 {
     VerifyOrReturnError(IsInitialized(), CHIP_ERROR_INTERNAL);
+    InvalidateGroupSessionCache();
+    PersistentStorageBatch batch(mStorage);
 
     FabricData fabric(fabric_index);
     KeyMapData map(fabric_index);
@@ -1368,7 +1388,8 @@ CHIP_ERROR GroupDataProviderImpl::SetGroupKeyAt(chip::FabricIndex fabric_index,
     if (found)
     {
         // Update existing map
-        return map.Save(mStorage);
+        ReturnErrorOnFailure(map.Save(mStorage));
+        return batch.Commit();
     }
 
     // Insert last
@@ -1393,7 +1414,8 @@ CHIP_ERROR GroupDataProviderImpl::SetGroupKeyAt(chip::FabricIndex fabric_index,
     }
     // Update fabric
     fabric.map_count++;
-    return fabric.Save(mStorage);
+    ReturnErrorOnFailure(fabric.Save(mStorage));
+    return batch.Commit();
 }
 
 CHIP_ERROR GroupDataProviderImpl::GetGroupKeyAt(chip::FabricIndex fabric_index, size_t index, GroupKey & out_map)
@@ -1415,6 +1437,8 @@ CHIP_ERROR GroupDataProviderImpl::GetGroupKeyAt(chip::FabricIndex fabric_index,
 CHIP_ERROR GroupDataProviderImpl::RemoveGroupKeyAt(chip::FabricIndex fabric_index, size_t index)
 {
     VerifyOrReturnError(IsInitialized(), CHIP_ERROR_INTERNAL);
+    InvalidateGroupSessionCache();
+    PersistentStorageBatch batch(mStorage);
 
     FabricData fabric(fabric_index);
     KeyMapData map;
@@ -1441,12 +1465,15 @@ CHIP_ERROR GroupDataProviderImpl::RemoveGroupKeyAt(chip::FabricIndex fabric_inde
         fabric.map_count--;
     }
     // Update fabric
-    return fabric.Save(mStorage);
+    ReturnErrorOnFailure(fabric.Save(mStorage));
+    return batch.Commit();
 }
 
 CHIP_ERROR GroupDataProviderImpl::RemoveGroupKeys(chip::FabricIndex fabric_index)
 {
     VerifyOrReturnError(IsInitialized(), CHIP_ERROR_INTERNAL);
+    InvalidateGroupSessionCache();
+    PersistentStorageBatch batch(mStorage);
 
     FabricData fabric(fabric_index);
     VerifyOrReturnError(CHIP_NO_ERROR == fabric.Load(mStorage), CHIP_ERROR_INVALID_FABRIC_INDEX);
@@ -1466,7 +1493,8 @@ CHIP_ERROR GroupDataProviderImpl::RemoveGroupKeys(chip::FabricIndex fabric_index
     // Update fabric
     fabric.first_map = 0;
     fabric.map_count = 0;
-    return fabric.Save(mStorage);
+    ReturnErrorOnFailure(fabric.Save(mStorage));
+    return batch.Commit();
 }
 
 GroupDataProvider::GroupKeyIterator * GroupDataProviderImpl::IterateGroupKeys(chip::FabricIndex fabric_index)
@@ -1523,6 +1551,8 @@ CHIP_ERROR GroupDataProviderImpl::SetKeySet(chip::FabricIndex fabric_index, cons
                                             const KeySet & in_keyset)
 {
     VerifyOrReturnError(IsInitialized(), CHIP_ERROR_INTERNAL);
+    InvalidateGroupSessionCache();
+    PersistentStorageBatch batch(mStorage);
 
     FabricData fabric(fabric_index);
     KeySetData keyset;
@@ -1553,7 +1583,8 @@ CHIP_ERROR GroupDataProviderImpl::SetKeySet(chip::FabricIndex fabric_index, cons
     if (found)
     {
         // Update existing keyset info, keep next
-        return keyset.Save(mStorage);
+        ReturnErrorOnFailure(keyset.Save(mStorage));
+        return batch.Commit();
     }
 
     // New keyset
@@ -1565,7 +1596,8 @@ CHIP_ERROR GroupDataProviderImpl::SetKeySet(chip::FabricIndex fabric_index, cons
     // Update fabric
     fabric.keyset_count++;
     fabric.first_keyset = in_keyset.keyset_id;
-    return fabric.Save(mStorage);
+    ReturnErrorOnFailure(fabric.Save(mStorage));
+    return batch.Commit();
 }
 
 CHIP_ERROR GroupDataProviderImpl::GetKeySet(chip::FabricIndex fabric_index, uint16_t target_id, KeySet & out_keyset)
@@ -1594,6 +1626,8 @@ CHIP_ERROR GroupDataProviderImpl::GetKeySet(chip::FabricIndex fabric_index, uint
 CHIP_ERROR GroupDataProviderImpl::RemoveKeySet(chip::FabricIndex fabric_index, uint16_t target_id)
 {
     VerifyOrReturnError(IsInitialized(), CHIP_ERROR_INTERNAL);
+    InvalidateGroupSessionCache();
+    PersistentStorageBatch batch(mStorage);
 
     FabricData fabric(fabric_index);
     KeySetData keyset;
@@ -1638,7 +1672,7 @@ CHIP_ERROR GroupDataProviderImpl::RemoveKeySet(chip::FabricIndex fabric_index, u
         // open to suggestsions for the correct behavior.
         RemoveGroupKeyAt(fabric_index, idx);
     }
-    return CHIP_NO_ERROR;
+    return batch.Commit();
 }
 
 GroupDataProvider::KeySetIterator * GroupDataProviderImpl::IterateKeySets(chip::FabricIndex fabric_index)
@@ -1696,6 +1730,8 @@ void GroupDataProviderImpl::KeySetIteratorImpl::Release()
 CHIP_ERROR GroupDataProviderImpl::RemoveFabric(chip::FabricIndex fabric_index)
 {
     FabricData fabric(fabric_index);
+    InvalidateGroupSessionCache();
+    PersistentStorageBatch batch(mStorage);
 
     // Fabric data defaults to zero, so if not entry is found, no mappings, or keys are removed
     // However, states has a separate list, and needs to be removed regardless
@@ -1734,7 +1770,8 @@ CHIP_ERROR GroupDataProviderImpl::RemoveFabric(chip::FabricIndex fabric_index)
     }
 
     // Remove fabric
-    return fabric.Delete(mStorage);
+    ReturnErrorOnFailure(fabric.Delete(mStorage));
+    return batch.Commit();
 }
 
 //
@@ -1811,8 +1848,8 @@ CHIP_ERROR GroupDataProviderImpl::GroupKeyContext::MessageEncrypt(const ByteSpan
                                                                   MutableByteSpan & ciphertext) const
 {
     uint8_t * output = ciphertext.data();
-    return Crypto::AES_CCM_encrypt(plaintext.data(), plaintext.size(), aad.data(), aad.size(), mEncryptionKey, nonce.data(),
-                                   nonce.size(), output, mic.data(), mic.size());
+    return mCipher.Encrypt(plaintext.data(), plaintext.size(), aad.data(), aad.size(), nonce.data(), nonce.size(), output,
+                           mic.data(), mic.size());
 }
 
 CHIP_ERROR GroupDataProviderImpl::GroupKeyContext::MessageDecrypt(const ByteSpan & ciphertext, const ByteSpan & aad,
@@ -1820,8 +1857,8 @@ CHIP_ERROR GroupDataProviderImpl::GroupKeyContext::MessageDecrypt(const ByteSpan
                                                                   MutableByteSpan & plaintext) const
 {
     uint8_t * output = plaintext.data();
-    return Crypto::AES_CCM_decrypt(ciphertext.data(), ciphertext.size(), aad.data(), aad.size(), mic.data(), mic.size(),
-                                   mEncryptionKey, nonce.data(), nonce.size(), output);
+    return mCipher.Decrypt(ciphertext.data(), ciphertext.size(), aad.data(), aad.size(), mic.data(), mic.size(), nonce.data(),
+                           nonce.size(), output);
 }
 
 CHIP_ERROR GroupDataProviderImpl::GroupKeyContext::PrivacyEncrypt(const ByteSpan & input, const ByteSpan & nonce,
@@ -1839,9 +1876,150 @@ CHIP_ERROR GroupDataProviderImpl::GroupKeyContext::PrivacyDecrypt(const ByteSpan
 GroupDataProviderImpl::GroupSessionIterator * GroupDataProviderImpl::IterateGroupSessions(uint16_t session_id)
 {
     VerifyOrReturnError(IsInitialized(), nullptr);
+    if (GroupSessionCacheState::kInvalid == mGroupSessionCacheState)
+    {
+        LoadGroupSessionCache();
+    }
+    if (GroupSessionCacheState::kValid == mGroupSessionCacheState)
+    {
+        return mCachedGroupSessionIterators.CreateObject(*this, session_id);
+    }
     return mGroupSessionsIterator.CreateObject(*this, session_id);
 }
 
+void GroupDataProviderImpl::LoadGroupSessionCache()
+{
+    ClearGroupSessionCache();
+    mGroupSessionCacheState = GroupSessionCacheState::kUnavailable;
+
+    FabricList fabric_list;
+    CHIP_ERROR err = fabric_list.Load(mStorage);
+    if (CHIP_ERROR_NOT_FOUND == err)
+    {
+        // No fabric, no group sessions
+        mGroupSessionCacheState = GroupSessionCacheState::kValid;
+        return;
+    }
+    VerifyOrReturn(CHIP_NO_ERROR == err);
+
+    FabricData fabric(fabric_list.first_entry);
+    for (uint16_t i = 0; i < fabric_list.entry_count; i++, fabric.fabric_index = fabric.next)
+    {
+        VerifyOrReturn(CHIP_NO_ERROR == fabric.Load(mStorage), ClearGroupSessionCache());
+
+        KeyMapData mapping(fabric.fabric_index, fabric.first_map);
+        for (uint16_t j = 0; j < fabric.map_count; ++j, mapping.id = mapping.next)
+        {
+            VerifyOrReturn(CHIP_NO_ERROR == mapping.Load(mStorage), ClearGroupSessionCache());
+
+            KeySetData keyset;
+            if (!keyset.Find(mStorage, fabric, mapping.keyset_id))
+            {
+                // Mapped to a key set that does not exist (yet), no keys to try
+                continue;
+            }
+
+            for (uint8_t k = 0; k < keyset.keys_count; ++k)
+            {
+                VerifyOrReturn(mGroupSessionCacheCount < ArraySize(mGroupSessionCache), ClearGroupSessionCache());
+                Crypto::GroupOperationalCredentials & creds = keyset.operational_keys[k];
+
+                GroupSessionCacheEntry entry;
+                entry.hash            = creds.hash;
+                entry.fabric_index    = fabric.fabric_index;
+                entry.group_id        = mapping.group_id;
+                entry.keyset_id       = keyset.keyset_id;
+                entry.key_index       = k;
+                entry.security_policy = keyset.policy;
+
+                // Groups that share a key set share its key handles
+                for (size_t n = 0; n < mGroupSessionCacheCount && entry.key_context == nullptr; n++)
+                {
+                    const GroupSessionCacheEntry & other = mGroupSessionCache[n];
+                    if (other.fabric_index == entry.fabric_index && other.keyset_id == entry.keyset_id &&
+                        other.key_index == entry.key_index)
+                    {
+                        entry.key_context = other.key_context;
+                    }
+                }
+                if (entry.key_context == nullptr)
+                {
+                    entry.key_context =
+                        mGroupSessionCacheKeys.CreateObject(*this, creds.encryption_key, creds.hash, creds.privacy_key);
+                    VerifyOrReturn(entry.key_context != nullptr, ClearGroupSessionCache());
+                }
+
+                // Insert after the entries with the same hash, so that sessions are tried in storage order
+                size_t pos = mGroupSessionCacheCount;
+                for (; pos > 0 && mGroupSessionCache[pos - 1].hash > entry.hash; pos--)
+                {
+                    mGroupSessionCache[pos] = mGroupSessionCache[pos - 1];
+                }
+                mGroupSessionCache[pos] = entry;
+                mGroupSessionCacheCount++;
+            }
+        }
+    }
+
+    mGroupSessionCacheState = GroupSessionCacheState::kValid;
+}
+
+void GroupDataProviderImpl::ClearGroupSessionCache()
+{
+    mGroupSessionCacheKeys.ForEachActiveObject([](GroupKeyContext * context) {
+        context->ReleaseKeys();
+        return Loop::Continue;
+    });
+    mGroupSessionCacheKeys.ReleaseAll();
+    mGroupSessionCacheCount = 0;
+}
+
+void GroupDataProviderImpl::InvalidateGroupSessionCache()
+{
+    ClearGroupSessionCache();
+    mGroupSessionCacheState = GroupSessionCacheState::kInvalid;
+    mGroupSessionCacheGeneration++;
+}
+
+GroupDataProviderImpl::CachedGroupSessionIteratorImpl::CachedGroupSessionIteratorImpl(GroupDataProviderImpl & provider,
+                                                                                      uint16_t session_id) :
+    mProvider(provider),
+    mGeneration(provider.mGroupSessionCacheGeneration)
+{
+    const GroupSessionCacheEntry * begin = provider.mGroupSessionCache;
+    const GroupSessionCacheEntry * end   = begin + provider.mGroupSessionCacheCount;
+    const GroupSessionCacheEntry * first =
+        std::lower_bound(begin, end, session_id, [](const GroupSessionCacheEntry & entry, uint16_t id) { return entry.hash < id; });
+    const GroupSessionCacheEntry * last =
+        std::upper_bound(first, end, session_id, [](uint16_t id, const GroupSessionCacheEntry & entry) { return id < entry.hash; });
+
+    mFirst = static_cast<size_t>(first - begin);
+    mNext  = mFirst;
+    mEnd   = static_cast<size_t>(last - begin);
+}
+
+size_t GroupDataProviderImpl::CachedGroupSessionIteratorImpl::Count()
+{
+    return mEnd - mFirst;
+}
+
+bool GroupDataProviderImpl::CachedGroupSessionIteratorImpl::Next(GroupSession & output)
+{
+    VerifyOrReturnError(mGeneration == mProvider.mGroupSessionCacheGeneration && mNext < mEnd, false);
+
+    const GroupSessionCacheEntry & entry = mProvider.mGroupSessionCache[mNext++];
+    output.fabric_index                  = entry.fabric_index;
+    output.group_id                      = entry.group_id;
+    output.security_policy               = entry.security_policy;
+    output.keyContext                    = entry.key_context;
+    return true;
+}
+
+void GroupDataProviderImpl::CachedGroupSessionIteratorImpl::Release()
+{
+    mProvider.mCachedGroupSessionIterators.ReleaseObject(this);
+}
+
 GroupDataProviderImpl::GroupSessionIteratorImpl::GroupSessionIteratorImpl(GroupDataProviderImpl & provider, uint16_t session_id) :
     mProvider(provider), mSessionId(session_id), mGroupKeyContext(provider)
 {
@@ -43,7 +43,12 @@ public:
      */
     void SetStorageDelegate(PersistentStorageDelegate * storage);
 
-    void SetSessionKeystore(Crypto::SessionKeystore * keystore) { mSessionKeystore = keystore; }
+    void SetSessionKeystore(Crypto::SessionKeystore * keystore)
+    {
+        // Cached key handles belong to the previous keystore
+        InvalidateGroupSessionCache();
+        mSessionKeystore = keystore;
+    }
     Crypto::SessionKeystore * GetSessionKeystore() const { return mSessionKeystore; }
 
     CHIP_ERROR Init() override;
@@ -178,10 +183,12 @@ protected:
             Crypto::SessionKeystore * keystore = mProvider.GetSessionKeystore();
             keystore->CreateKey(encryptionKey, mEncryptionKey);
             keystore->CreateKey(privacyKey, mPrivacyKey);
+            mCipher.Init(mEncryptionKey);
         }
 
         void ReleaseKeys()
         {
+            mCipher.Release();
             Crypto::SessionKeystore * keystore = mProvider.GetSessionKeystore();
             keystore->DestroyKey(mEncryptionKey);
             keystore->DestroyKey(mPrivacyKey);
@@ -203,6 +210,8 @@ protected:
         uint16_t mKeyHash = 0;
         Crypto::Aes128KeyHandle mEncryptionKey;
         Crypto::Aes128KeyHandle mPrivacyKey;
+        // Cipher for mEncryptionKey, kept for as long as the context is
+        Crypto::Aes128CcmCipher mCipher;
     };
 
     class KeySetIteratorImpl : public KeySetIterator
@@ -243,9 +252,56 @@ protected:
         bool mFirstMap           = true;
         GroupKeyContext mGroupKeyContext;
     };
+
+    /**
+     * Iterates the entries of the group session cache that match a session id.
+     * Stops early if the cache is invalidated while iterating.
+     */
+    class CachedGroupSessionIteratorImpl : public GroupSessionIterator
+    {
+    public:
+        CachedGroupSessionIteratorImpl(GroupDataProviderImpl & provider, uint16_t session_id);
+        size_t Count() override;
+        bool Next(GroupSession & output) override;
+        void Release() override;
+
+    protected:
+        GroupDataProviderImpl & mProvider;
+        uint32_t mGeneration = 0;
+        size_t mFirst        = 0;
+        size_t mNext         = 0;
+        size_t mEnd          = 0;
+    };
+
+    /**
+     * One operational group key of a group-keyset mapping. Entries are sorted by key hash (session id), and entries that use
+     * the same key of the same key set share its key context.
+     */
+    struct GroupSessionCacheEntry
+    {
+        uint16_t hash                  = 0;
+        FabricIndex fabric_index       = kUndefinedFabricIndex;
+        GroupId group_id               = kUndefinedGroupId;
+        KeysetId keyset_id             = 0;
+        uint8_t key_index              = 0;
+        SecurityPolicy security_policy = SecurityPolicy::kCacheAndSync;
+        GroupKeyContext * key_context  = nullptr;
+    };
+
+    enum class GroupSessionCacheState : uint8_t
+    {
+        kInvalid,     // Must be loaded from persistent storage before use
+        kValid,       // Holds every group session
+        kUnavailable, // Does not fit, or could not be loaded: use persistent storage until the next change
+    };
+
     bool IsInitialized() { return (mStorage != nullptr); }
     CHIP_ERROR RemoveEndpoints(FabricIndex fabric_index, GroupId group_id);
 
+    void LoadGroupSessionCache();
+    void ClearGroupSessionCache();
+    void InvalidateGroupSessionCache();
+
     PersistentStorageDelegate * mStorage       = nullptr;
     Crypto::SessionKeystore * mSessionKeystore = nullptr;
     ObjectPool<GroupInfoIteratorImpl, kIteratorsMax> mGroupInfoIterators;
@@ -254,6 +310,15 @@ protected:
     ObjectPool<KeySetIteratorImpl, kIteratorsMax> mKeySetIterators;
     ObjectPool<GroupSessionIteratorImpl, kIteratorsMax> mGroupSessionsIterator;
     ObjectPool<GroupKeyContext, kIteratorsMax> mGroupKeyContexPool;
+
+    // Group session cache, rebuilt from persistent storage on first use after any change to keys or mappings.
+    // Its key contexts are owned by the cache, and are never released through GroupKeyContext::Release().
+    GroupSessionCacheEntry mGroupSessionCache[CHIP_CONFIG_GROUP_SESSION_CACHE_SIZE];
+    size_t mGroupSessionCacheCount                 = 0;
+    uint32_t mGroupSessionCacheGeneration          = 0;
+    GroupSessionCacheState mGroupSessionCacheState = GroupSessionCacheState::kInvalid;
+    ObjectPool<GroupKeyContext, CHIP_CONFIG_GROUP_SESSION_CACHE_SIZE> mGroupSessionCacheKeys;
+    ObjectPool<CachedGroupSessionIteratorImpl, kIteratorsMax> mCachedGroupSessionIterators;
 };
 
 } // namespace Credentials
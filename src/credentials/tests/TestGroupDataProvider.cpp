@@ -19,6 +19,7 @@
 #include <credentials/GroupDataProviderImpl.h>
 #include <crypto/DefaultSessionKeystore.h>
 #include <lib/core/TLV.h>
+#include <lib/core/WriteCoalescingStorageDelegate.h>
 #include <lib/support/CHIPMem.h>
 #include <lib/support/TestPersistentStorageDelegate.h>
 #include <lib/support/UnitTestRegistration.h>
@@ -1196,6 +1197,182 @@ void TestGroupDecryption(nlTestSuite * apSuite, void * apContext)
     }
 }
 
+void TestGroupSessionCache(nlTestSuite * apSuite, void * apContext)
+{
+    GroupDataProvider * provider = GetGroupDataProvider();
+    NL_TEST_ASSERT(apSuite, provider);
+
+    // Reset test
+    ResetProvider(provider);
+
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == provider->SetKeySet(kFabric1, kCompressedFabricId1, kKeySet2));
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == provider->SetKeySet(kFabric2, kCompressedFabricId2, kKeySet1));
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == provider->SetGroupKeyAt(kFabric1, 0, kGroup1Keyset2));
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == provider->SetGroupKeyAt(kFabric1, 1, kGroup3Keyset2));
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == provider->SetGroupKeyAt(kFabric2, 0, kGroup2Keyset1));
+
+    const uint8_t kMessage[10] = { 0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9 };
+    const uint8_t nonce[13]    = { 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x18, 0x1a, 0x1b, 0x1c };
+    const uint8_t aad[4]       = { 0x0a, 0x1a, 0x2a, 0x3a };
+    uint8_t mic[16]            = { 0 };
+    uint8_t ciphertext_buffer[sizeof(kMessage)];
+    uint8_t plaintext_buffer[sizeof(kMessage)];
+    MutableByteSpan ciphertext(ciphertext_buffer, sizeof(ciphertext_buffer));
+    MutableByteSpan plaintext(plaintext_buffer, sizeof(plaintext_buffer));
+    MutableByteSpan tag(mic, sizeof(mic));
+
+    // Encrypt with the current key of group 1, which group 3 shares
+    memcpy(plaintext_buffer, kMessage, sizeof(kMessage));
+    Crypto::SymmetricKeyContext * key_context = provider->GetKeyContext(kFabric1, kGroup1);
+    NL_TEST_ASSERT(apSuite, nullptr != key_context);
+    if (nullptr == key_context)
+    {
+        return;
+    }
+    uint16_t session_id = key_context->GetKeyHash();
+    NL_TEST_ASSERT(
+        apSuite,
+        CHIP_NO_ERROR ==
+            key_context->MessageEncrypt(plaintext, ByteSpan(aad, sizeof(aad)), ByteSpan(nonce, sizeof(nonce)), tag, ciphertext));
+    key_context->Release();
+
+    // Both groups match the session, with the same key
+    const std::set<std::pair<FabricIndex, GroupId>> expected = { { kFabric1, kGroup1 }, { kFabric1, kGroup3 } };
+    Crypto::SymmetricKeyContext * cached_context             = nullptr;
+    GroupSession session;
+
+    auto it = provider->IterateGroupSessions(session_id);
+    NL_TEST_ASSERT(apSuite, it);
+    if (it)
+    {
+        NL_TEST_ASSERT(apSuite, expected.size() == it->Count());
+        size_t count = 0;
+        while (it->Next(session))
+        {
+            NL_TEST_ASSERT(apSuite, expected.count(std::make_pair(session.fabric_index, session.group_id)) > 0);
+            NL_TEST_ASSERT(apSuite, session.security_policy == kKeySet2.policy);
+            NL_TEST_ASSERT(apSuite, session.keyContext != nullptr);
+            NL_TEST_ASSERT(apSuite, cached_context == nullptr || cached_context == session.keyContext);
+            cached_context = session.keyContext;
+            count++;
+        }
+        NL_TEST_ASSERT(apSuite, expected.size() == count);
+        it->Release();
+    }
+    NL_TEST_ASSERT(apSuite, cached_context != nullptr);
+    if (nullptr == cached_context)
+    {
+        return;
+    }
+    NL_TEST_ASSERT(apSuite,
+                   CHIP_NO_ERROR ==
+                       cached_context->MessageDecrypt(ciphertext, ByteSpan(aad, sizeof(aad)), ByteSpan(nonce, sizeof(nonce)), tag,
+                                                      plaintext));
+    NL_TEST_ASSERT(apSuite, 0 == memcmp(plaintext.data(), kMessage, sizeof(kMessage)));
+
+    // Without changes, later messages reuse the cached key
+    it = provider->IterateGroupSessions(session_id);
+    NL_TEST_ASSERT(apSuite, it);
+    if (it)
+    {
+        NL_TEST_ASSERT(apSuite, it->Next(session));
+        NL_TEST_ASSERT(apSuite, session.keyContext == cached_context);
+
+        // A change to the mappings ends iterations in progress
+        NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == provider->RemoveGroupKeyAt(kFabric1, 1));
+        NL_TEST_ASSERT(apSuite, !it->Next(session));
+        it->Release();
+    }
+
+    it = provider->IterateGroupSessions(session_id);
+    NL_TEST_ASSERT(apSuite, it);
+    if (it)
+    {
+        NL_TEST_ASSERT(apSuite, 1 == it->Count());
+        NL_TEST_ASSERT(apSuite, it->Next(session));
+        NL_TEST_ASSERT(apSuite, session.fabric_index == kFabric1 && session.group_id == kGroup1);
+        NL_TEST_ASSERT(apSuite, !it->Next(session));
+        it->Release();
+    }
+
+    // Removed keys no longer match
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == provider->RemoveKeySet(kFabric1, kKeysetId2));
+    it = provider->IterateGroupSessions(session_id);
+    NL_TEST_ASSERT(apSuite, it);
+    if (it)
+    {
+        NL_TEST_ASSERT(apSuite, 0 == it->Count());
+        NL_TEST_ASSERT(apSuite, !it->Next(session));
+        it->Release();
+    }
+}
+
+// Applies the same operations to a provider using plain storage and to one using a WriteCoalescingStorageDelegate
+CHIP_ERROR ApplyStorageBatchOperations(GroupDataProvider * provider)
+{
+    ReturnErrorOnFailure(provider->SetGroupInfoAt(kFabric1, 0, kGroupInfo1_1));
+    ReturnErrorOnFailure(provider->SetGroupInfoAt(kFabric1, 1, kGroupInfo1_2));
+    ReturnErrorOnFailure(provider->AddEndpoint(kFabric1, kGroup1, kEndpointId0));
+    ReturnErrorOnFailure(provider->AddEndpoint(kFabric1, kGroup1, kEndpointId1));
+    ReturnErrorOnFailure(provider->AddEndpoint(kFabric1, kGroup3, kEndpointId2));
+    ReturnErrorOnFailure(provider->RemoveEndpoint(kFabric1, kGroup1, kEndpointId0));
+    ReturnErrorOnFailure(provider->SetKeySet(kFabric1, kCompressedFabricId1, kKeySet1));
+    ReturnErrorOnFailure(provider->SetKeySet(kFabric1, kCompressedFabricId1, kKeySet2));
+    ReturnErrorOnFailure(provider->SetGroupKeyAt(kFabric1, 0, kGroup1Keyset1));
+    ReturnErrorOnFailure(provider->SetGroupKeyAt(kFabric1, 1, kGroup2Keyset2));
+    ReturnErrorOnFailure(provider->RemoveKeySet(kFabric1, kKeysetId1));
+    ReturnErrorOnFailure(provider->SetGroupInfoAt(kFabric2, 0, kGroupInfo2_1));
+    ReturnErrorOnFailure(provider->AddEndpoint(kFabric2, kGroup2, kEndpointId3));
+    return provider->RemoveFabric(kFabric2);
+}
+
+void TestStorageBatches(nlTestSuite * apSuite, void * apContext)
+{
+    chip::TestPersistentStorageDelegate plainStorage;
+    chip::TestPersistentStorageDelegate backingStorage;
+    chip::WriteCoalescingStorageDelegate coalescingStorage;
+    chip::Crypto::DefaultSessionKeystore keystore;
+    GroupDataProviderImpl plainProvider(kMaxGroupsPerFabric, kMaxGroupKeysPerFabric);
+    GroupDataProviderImpl coalescingProvider(kMaxGroupsPerFabric, kMaxGroupKeysPerFabric);
+
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == coalescingStorage.Init(&backingStorage));
+    plainProvider.SetStorageDelegate(&plainStorage);
+    plainProvider.SetSessionKeystore(&keystore);
+    coalescingProvider.SetStorageDelegate(&coalescingStorage);
+    coalescingProvider.SetSessionKeystore(&keystore);
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == plainProvider.Init());
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == coalescingProvider.Init());
+
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == ApplyStorageBatchOperations(&plainProvider));
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == ApplyStorageBatchOperations(&coalescingProvider));
+
+    // Both providers leave the same data in storage
+    const std::set<std::string> keys = plainStorage.GetKeys();
+    NL_TEST_ASSERT(apSuite, keys == backingStorage.GetKeys());
+    for (const auto & key : keys)
+    {
+        uint8_t plainValue[1024];
+        uint8_t backingValue[1024];
+        uint16_t plainSize   = sizeof(plainValue);
+        uint16_t backingSize = sizeof(backingValue);
+        NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == plainStorage.SyncGetKeyValue(key.c_str(), plainValue, plainSize));
+        NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == backingStorage.SyncGetKeyValue(key.c_str(), backingValue, backingSize));
+        NL_TEST_ASSERT(apSuite, plainSize == backingSize && 0 == memcmp(plainValue, backingValue, plainSize));
+    }
+
+    // Each operation reaches the backing storage as a single commit, with fewer writes
+    const auto & counters = coalescingStorage.GetCounters();
+    printf("GroupDataProvider storage: %u requested writes, %u backend writes in %u commits\n",
+           static_cast<unsigned>(counters.requestedWrites), static_cast<unsigned>(counters.backendWrites),
+           static_cast<unsigned>(counters.backendCommits));
+    NL_TEST_ASSERT(apSuite, counters.backendCommits == 14);
+    NL_TEST_ASSERT(apSuite, counters.backendWrites < counters.requestedWrites);
+
+    plainProvider.Finish();
+    coalescingProvider.Finish();
+    coalescingStorage.Shutdown();
+}
+
 } // namespace TestGroups
 } // namespace app
 } // namespace chip
@@ -1275,6 +1452,8 @@ const nlTest sTests[] = { NL_TEST_DEF("TestStorageDelegate", chip::app::TestGrou
                           NL_TEST_DEF("TestIpk", chip::app::TestGroups::TestIpk),
                           NL_TEST_DEF("TestPerFabricData", chip::app::TestGroups::TestPerFabricData),
                           NL_TEST_DEF("TestGroupDecryption", chip::app::TestGroups::TestGroupDecryption),
+                          NL_TEST_DEF("TestGroupSessionCache", chip::app::TestGroups::TestGroupSessionCache),
+                          NL_TEST_DEF("TestStorageBatches", chip::app::TestGroups::TestStorageBatches),
                           NL_TEST_SENTINEL() };
 } // namespace
 
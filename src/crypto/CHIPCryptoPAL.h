@@ -724,6 +724,51 @@ CHIP_ERROR AES_CCM_decrypt(const uint8_t * ciphertext, size_t ciphertext_length,
                            const uint8_t * tag, size_t tag_length, const Aes128KeyHandle & key, const uint8_t * nonce,
                            size_t nonce_length, uint8_t * plaintext);
 
+/**
+ * @brief AES-CCM cipher for many messages under the same key
+ *
+ * Encrypt() and Decrypt() have the semantics of AES_CCM_encrypt() and AES_CCM_decrypt() with the key given to Init().
+ * When CHIP_CONFIG_AES_CCM_KEEP_KEY_SCHEDULE is enabled and the backend supports it, the cipher sets up a backend context
+ * with the expanded key on first use, and reuses it for the following messages instead of setting one up for each of them.
+ * Otherwise, or if the context cannot be allocated, each operation is a plain AES_CCM_encrypt() or AES_CCM_decrypt().
+ *
+ * The key handle must stay valid until Release() or the destruction of the cipher. A cipher must not be used from
+ * several threads at once.
+ */
+class Aes128CcmCipher
+{
+public:
+    Aes128CcmCipher() = default;
+    ~Aes128CcmCipher() { Release(); }
+
+    Aes128CcmCipher(const Aes128CcmCipher &)             = delete;
+    Aes128CcmCipher & operator=(const Aes128CcmCipher &) = delete;
+
+    /** Use the given key for subsequent operations, releasing any previous one. */
+    void Init(const Aes128KeyHandle & key)
+    {
+        Release();
+        mKey = &key;
+    }
+
+    /** Forget the key, and free the backend context along with the expanded key it holds. */
+    void Release();
+
+    bool IsInitialized() const { return mKey != nullptr; }
+
+    CHIP_ERROR Encrypt(const uint8_t * plaintext, size_t plaintext_length, const uint8_t * aad, size_t aad_length,
+                       const uint8_t * nonce, size_t nonce_length, uint8_t * ciphertext, uint8_t * tag, size_t tag_length) const;
+
+    CHIP_ERROR Decrypt(const uint8_t * ciphertext, size_t ciphertext_length, const uint8_t * aad, size_t aad_length,
+                       const uint8_t * tag, size_t tag_length, const uint8_t * nonce, size_t nonce_length,
+                       uint8_t * plaintext) const;
+
+private:
+    const Aes128KeyHandle * mKey = nullptr;
+    // Backend-specific context, created on first use
+    mutable void * mContext = nullptr;
+};
+
 /**
  * @brief A function that implements AES-CTR encryption/decryption
  *
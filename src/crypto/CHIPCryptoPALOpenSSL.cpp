@@ -48,6 +48,7 @@
 #include <lib/support/BufferWriter.h>
 #include <lib/support/BytesToHex.h>
 #include <lib/support/CHIPArgParser.hpp>
+#include <lib/support/CHIPMem.h>
 #include <lib/support/CodeUtils.h>
 #include <lib/support/SafeInt.h>
 #include <lib/support/SafePointerCast.h>
@@ -411,6 +412,239 @@ exit:
     return error;
 }
 
+#if CHIP_CONFIG_AES_CCM_KEEP_KEY_SCHEDULE
+namespace {
+
+#if CHIP_CRYPTO_BORINGSSL
+// The Matter AEAD takes the nonce with each message, so one keyed context serves both directions.
+struct Aes128CcmContext
+{
+    EVP_AEAD_CTX * aead = nullptr;
+};
+#else
+// CCM ciphers keyed once per direction. The nonce and tag come with each message.
+struct Aes128CcmContext
+{
+    EVP_CIPHER_CTX * encrypt = nullptr;
+    EVP_CIPHER_CTX * decrypt = nullptr;
+};
+
+EVP_CIPHER_CTX * NewKeyedCcmCipher(const Aes128KeyHandle & key, bool encrypt)
+{
+    EVP_CIPHER_CTX * cipher = EVP_CIPHER_CTX_new();
+    VerifyOrReturnValue(cipher != nullptr, nullptr);
+
+    auto init = encrypt ? EVP_EncryptInit_ex : EVP_DecryptInit_ex;
+    if (init(cipher, EVP_aes_128_ccm(), nullptr, nullptr, nullptr) != 1 ||
+        EVP_CIPHER_CTX_ctrl(cipher, EVP_CTRL_CCM_SET_IVLEN, CHIP_CRYPTO_AEAD_NONCE_LENGTH_BYTES, nullptr) != 1 ||
+        EVP_CIPHER_CTX_ctrl(cipher, EVP_CTRL_CCM_SET_TAG, CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES, nullptr) != 1 ||
+        init(cipher, nullptr, nullptr, key.As<Aes128KeyByteArray>(), nullptr) != 1)
+    {
+        EVP_CIPHER_CTX_free(cipher);
+        return nullptr;
+    }
+    return cipher;
+}
+#endif // CHIP_CRYPTO_BORINGSSL
+
+void FreeCcmContext(void *& storage)
+{
+    auto * context = static_cast<Aes128CcmContext *>(storage);
+    VerifyOrReturn(context != nullptr);
+#if CHIP_CRYPTO_BORINGSSL
+    EVP_AEAD_CTX_free(context->aead);
+#else
+    EVP_CIPHER_CTX_free(context->encrypt);
+    EVP_CIPHER_CTX_free(context->decrypt);
+#endif // CHIP_CRYPTO_BORINGSSL
+    Platform::Delete(context);
+    storage = nullptr;
+}
+
+/**
+ * Returns the keyed backend context to use for a message, creating it on first use, or nullptr if the message must go
+ * through the one-shot functions: when it is empty (they handle those corner cases), does not use the nonce and MIC
+ * lengths of the message layer, or when the context cannot be set up.
+ */
+#if CHIP_CRYPTO_BORINGSSL
+EVP_AEAD_CTX *
+#else
+EVP_CIPHER_CTX *
+#endif
+GetKeyedCcmContext(void *& storage, const Aes128KeyHandle & key, bool encrypt, const uint8_t * input, size_t input_length,
+                   size_t aad_length, const uint8_t * output, const uint8_t * nonce, size_t nonce_length, const uint8_t * tag,
+                   size_t tag_length)
+{
+    VerifyOrReturnValue(input != nullptr && input_length > 0 && output != nullptr && nonce != nullptr && tag != nullptr, nullptr);
+    VerifyOrReturnValue(CanCastTo<int>(input_length) && CanCastTo<int>(aad_length), nullptr);
+    VerifyOrReturnValue(nonce_length == CHIP_CRYPTO_AEAD_NONCE_LENGTH_BYTES && tag_length == CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES,
+                        nullptr);
+
+    if (storage == nullptr)
+    {
+        storage = Platform::New<Aes128CcmContext>();
+        VerifyOrReturnValue(storage != nullptr, nullptr);
+    }
+    auto * context = static_cast<Aes128CcmContext *>(storage);
+
+#if CHIP_CRYPTO_BORINGSSL
+    if (context->aead == nullptr)
+    {
+        context->aead = EVP_AEAD_CTX_new(EVP_aead_aes_128_ccm_matter(), key.As<Aes128KeyByteArray>(), sizeof(Aes128KeyByteArray),
+                                         CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES);
+    }
+    return context->aead;
+#else
+    EVP_CIPHER_CTX *& cipher = encrypt ? context->encrypt : context->decrypt;
+    if (cipher == nullptr)
+    {
+        cipher = NewKeyedCcmCipher(key, encrypt);
+    }
+    return cipher;
+#endif // CHIP_CRYPTO_BORINGSSL
+}
+
+#if CHIP_CRYPTO_BORINGSSL
+CHIP_ERROR KeyedCcmEncrypt(EVP_AEAD_CTX * aead, const uint8_t * plaintext, size_t plaintext_length, const uint8_t * aad,
+                           size_t aad_length, const uint8_t * nonce, size_t nonce_length, uint8_t * ciphertext, uint8_t * tag,
+                           size_t tag_length)
+{
+    size_t written_tag_len = 0;
+    VerifyOrReturnError(EVP_AEAD_CTX_seal_scatter(aead, ciphertext, tag, &written_tag_len, tag_length, nonce, nonce_length,
+                                                  plaintext, plaintext_length, nullptr, 0, aad, aad_length) == 1,
+                        CHIP_ERROR_INTERNAL);
+    VerifyOrReturnError(written_tag_len == tag_length, CHIP_ERROR_INTERNAL);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR KeyedCcmDecrypt(EVP_AEAD_CTX * aead, const uint8_t * ciphertext, size_t ciphertext_length, const uint8_t * aad,
+                           size_t aad_length, const uint8_t * tag, size_t tag_length, const uint8_t * nonce, size_t nonce_length,
+                           uint8_t * plaintext)
+{
+    VerifyOrReturnError(EVP_AEAD_CTX_open_gather(aead, plaintext, nonce, nonce_length, ciphertext, ciphertext_length, tag,
+                                                 tag_length, aad, aad_length) == 1,
+                        CHIP_ERROR_INTERNAL);
+    return CHIP_NO_ERROR;
+}
+#else
+CHIP_ERROR KeyedCcmEncrypt(EVP_CIPHER_CTX * cipher, const uint8_t * plaintext, size_t plaintext_length, const uint8_t * aad,
+                           size_t aad_length, const uint8_t * nonce, size_t nonce_length, uint8_t * ciphertext, uint8_t * tag,
+                           size_t tag_length)
+{
+    int bytesWritten = 0;
+    int finalBytes   = 0;
+
+    // New nonce and plaintext length; the key stays
+    VerifyOrReturnError(EVP_EncryptInit_ex(cipher, nullptr, nullptr, nullptr, Uint8::to_const_uchar(nonce)) == 1,
+                        CHIP_ERROR_INTERNAL);
+    VerifyOrReturnError(EVP_EncryptUpdate(cipher, nullptr, &bytesWritten, nullptr, static_cast<int>(plaintext_length)) == 1,
+                        CHIP_ERROR_INTERNAL);
+    if (aad_length > 0 && aad != nullptr)
+    {
+        VerifyOrReturnError(
+            EVP_EncryptUpdate(cipher, nullptr, &bytesWritten, Uint8::to_const_uchar(aad), static_cast<int>(aad_length)) == 1,
+            CHIP_ERROR_INTERNAL);
+    }
+    VerifyOrReturnError(EVP_EncryptUpdate(cipher, Uint8::to_uchar(ciphertext), &bytesWritten, Uint8::to_const_uchar(plaintext),
+                                          static_cast<int>(plaintext_length)) == 1,
+                        CHIP_ERROR_INTERNAL);
+    VerifyOrReturnError(bytesWritten >= 0 && static_cast<size_t>(bytesWritten) <= plaintext_length, CHIP_ERROR_INTERNAL);
+    VerifyOrReturnError(EVP_EncryptFinal_ex(cipher, ciphertext + bytesWritten, &finalBytes) == 1, CHIP_ERROR_INTERNAL);
+    VerifyOrReturnError(EVP_CIPHER_CTX_ctrl(cipher, EVP_CTRL_CCM_GET_TAG, static_cast<int>(tag_length), Uint8::to_uchar(tag)) == 1,
+                        CHIP_ERROR_INTERNAL);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR KeyedCcmDecrypt(EVP_CIPHER_CTX * cipher, const uint8_t * ciphertext, size_t ciphertext_length, const uint8_t * aad,
+                           size_t aad_length, const uint8_t * tag, size_t tag_length, const uint8_t * nonce, size_t nonce_length,
+                           uint8_t * plaintext)
+{
+    int bytesOutput = 0;
+
+    // Expected tag, new nonce and ciphertext length; the key stays
+    VerifyOrReturnError(EVP_CIPHER_CTX_ctrl(cipher, EVP_CTRL_CCM_SET_TAG, static_cast<int>(tag_length),
+                                            const_cast<void *>(static_cast<const void *>(tag))) == 1,
+                        CHIP_ERROR_INTERNAL);
+    VerifyOrReturnError(EVP_DecryptInit_ex(cipher, nullptr, nullptr, nullptr, Uint8::to_const_uchar(nonce)) == 1,
+                        CHIP_ERROR_INTERNAL);
+    VerifyOrReturnError(EVP_DecryptUpdate(cipher, nullptr, &bytesOutput, nullptr, static_cast<int>(ciphertext_length)) == 1,
+                        CHIP_ERROR_INTERNAL);
+    if (aad_length > 0 && aad != nullptr)
+    {
+        VerifyOrReturnError(
+            EVP_DecryptUpdate(cipher, nullptr, &bytesOutput, Uint8::to_const_uchar(aad), static_cast<int>(aad_length)) == 1,
+            CHIP_ERROR_INTERNAL);
+    }
+    // We wont get anything if validation fails.
+    VerifyOrReturnError(EVP_DecryptUpdate(cipher, Uint8::to_uchar(plaintext), &bytesOutput, Uint8::to_const_uchar(ciphertext),
+                                          static_cast<int>(ciphertext_length)) == 1,
+                        CHIP_ERROR_INTERNAL);
+    return CHIP_NO_ERROR;
+}
+#endif // CHIP_CRYPTO_BORINGSSL
+
+} // namespace
+#endif // CHIP_CONFIG_AES_CCM_KEEP_KEY_SCHEDULE
+
+void Aes128CcmCipher::Release()
+{
+#if CHIP_CONFIG_AES_CCM_KEEP_KEY_SCHEDULE
+    FreeCcmContext(mContext);
+#endif
+    mKey = nullptr;
+}
+
+CHIP_ERROR Aes128CcmCipher::Encrypt(const uint8_t * plaintext, size_t plaintext_length, const uint8_t * aad, size_t aad_length,
+                                    const uint8_t * nonce, size_t nonce_length, uint8_t * ciphertext, uint8_t * tag,
+                                    size_t tag_length) const
+{
+    VerifyOrReturnError(mKey != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+#if CHIP_CONFIG_AES_CCM_KEEP_KEY_SCHEDULE
+    auto * context = GetKeyedCcmContext(mContext, *mKey, true, plaintext, plaintext_length, aad_length, ciphertext, nonce,
+                                        nonce_length, tag, tag_length);
+    if (context != nullptr)
+    {
+        CHIP_ERROR error = KeyedCcmEncrypt(context, plaintext, plaintext_length, aad, aad_length, nonce, nonce_length, ciphertext,
+                                           tag, tag_length);
+        if (error != CHIP_NO_ERROR)
+        {
+            // Start over with a fresh context rather than trust one left mid-message
+            FreeCcmContext(mContext);
+        }
+        return error;
+    }
+#endif // CHIP_CONFIG_AES_CCM_KEEP_KEY_SCHEDULE
+
+    return AES_CCM_encrypt(plaintext, plaintext_length, aad, aad_length, *mKey, nonce, nonce_length, ciphertext, tag, tag_length);
+}
+
+CHIP_ERROR Aes128CcmCipher::Decrypt(const uint8_t * ciphertext, size_t ciphertext_length, const uint8_t * aad, size_t aad_length,
+                                    const uint8_t * tag, size_t tag_length, const uint8_t * nonce, size_t nonce_length,
+                                    uint8_t * plaintext) const
+{
+    VerifyOrReturnError(mKey != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+#if CHIP_CONFIG_AES_CCM_KEEP_KEY_SCHEDULE
+    auto * context = GetKeyedCcmContext(mContext, *mKey, false, ciphertext, ciphertext_length, aad_length, plaintext, nonce,
+                                        nonce_length, tag, tag_length);
+    if (context != nullptr)
+    {
+        CHIP_ERROR error = KeyedCcmDecrypt(context, ciphertext, ciphertext_length, aad, aad_length, tag, tag_length, nonce,
+                                           nonce_length, plaintext);
+        if (error != CHIP_NO_ERROR)
+        {
+            // Start over with a fresh context rather than trust one left mid-message
+            FreeCcmContext(mContext);
+        }
+        return error;
+    }
+#endif // CHIP_CONFIG_AES_CCM_KEEP_KEY_SCHEDULE
+
+    return AES_CCM_decrypt(ciphertext, ciphertext_length, aad, aad_length, tag, tag_length, *mKey, nonce, nonce_length,
+                           plaintext);
+}
+
 CHIP_ERROR Hash_SHA256(const uint8_t * data, const size_t data_length, uint8_t * out_buffer)
 {
     // zero data length hash is supported.
@@ -45,6 +45,7 @@
 #include <lib/support/BufferWriter.h>
 #include <lib/support/BytesToHex.h>
 #include <lib/support/CHIPArgParser.hpp>
+#include <lib/support/CHIPMem.h>
 #include <lib/support/CodeUtils.h>
 #include <lib/support/SafeInt.h>
 #include <lib/support/SafePointerCast.h>
@@ -148,6 +149,105 @@ exit:
     return error;
 }
 
+#if CHIP_CONFIG_AES_CCM_KEEP_KEY_SCHEDULE
+namespace {
+
+/**
+ * Returns the context with the expanded key to use for a message, creating it on first use, or nullptr if the message
+ * must go through the one-shot functions: when it is empty (they handle those corner cases), has an invalid tag length,
+ * or when the context cannot be set up. The same context serves both directions.
+ */
+mbedtls_ccm_context * GetKeyedCcmContext(void *& storage, const Aes128KeyHandle & key, const uint8_t * input, size_t input_length,
+                                         size_t aad_length, const uint8_t * aad, const uint8_t * output, const uint8_t * nonce,
+                                         size_t nonce_length, const uint8_t * tag, size_t tag_length)
+{
+    VerifyOrReturnValue(input != nullptr && input_length > 0 && output != nullptr && nonce != nullptr && nonce_length > 0,
+                        nullptr);
+    VerifyOrReturnValue(tag != nullptr && _isValidTagLength(tag_length) && (aad != nullptr || aad_length == 0), nullptr);
+
+    if (storage == nullptr)
+    {
+        auto * context = Platform::New<mbedtls_ccm_context>();
+        VerifyOrReturnValue(context != nullptr, nullptr);
+        mbedtls_ccm_init(context);
+
+        // Size of key is expressed in bits, hence the multiplication by 8.
+        int result =
+            mbedtls_ccm_setkey(context, MBEDTLS_CIPHER_ID_AES, key.As<Aes128KeyByteArray>(), sizeof(Aes128KeyByteArray) * 8);
+        if (result != 0)
+        {
+            mbedtls_ccm_free(context);
+            Platform::Delete(context);
+            return nullptr;
+        }
+        storage = context;
+    }
+    return static_cast<mbedtls_ccm_context *>(storage);
+}
+
+} // namespace
+#endif // CHIP_CONFIG_AES_CCM_KEEP_KEY_SCHEDULE
+
+void Aes128CcmCipher::Release()
+{
+#if CHIP_CONFIG_AES_CCM_KEEP_KEY_SCHEDULE
+    auto * context = static_cast<mbedtls_ccm_context *>(mContext);
+    if (context != nullptr)
+    {
+        mbedtls_ccm_free(context);
+        Platform::Delete(context);
+        mContext = nullptr;
+    }
+#endif // CHIP_CONFIG_AES_CCM_KEEP_KEY_SCHEDULE
+    mKey = nullptr;
+}
+
+CHIP_ERROR Aes128CcmCipher::Encrypt(const uint8_t * plaintext, size_t plaintext_length, const uint8_t * aad, size_t aad_length,
+                                    const uint8_t * nonce, size_t nonce_length, uint8_t * ciphertext, uint8_t * tag,
+                                    size_t tag_length) const
+{
+    VerifyOrReturnError(mKey != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+#if CHIP_CONFIG_AES_CCM_KEEP_KEY_SCHEDULE
+    mbedtls_ccm_context * context = GetKeyedCcmContext(mContext, *mKey, plaintext, plaintext_length, aad_length, aad, ciphertext,
+                                                       nonce, nonce_length, tag, tag_length);
+    if (context != nullptr)
+    {
+        // Each call is a complete CCM operation, the context only holds the key.
+        int result = mbedtls_ccm_encrypt_and_tag(context, plaintext_length, Uint8::to_const_uchar(nonce), nonce_length,
+                                                 Uint8::to_const_uchar(aad), aad_length, Uint8::to_const_uchar(plaintext),
+                                                 Uint8::to_uchar(ciphertext), Uint8::to_uchar(tag), tag_length);
+        _log_mbedTLS_error(result);
+        return (result == 0) ? CHIP_NO_ERROR : CHIP_ERROR_INTERNAL;
+    }
+#endif // CHIP_CONFIG_AES_CCM_KEEP_KEY_SCHEDULE
+
+    return AES_CCM_encrypt(plaintext, plaintext_length, aad, aad_length, *mKey, nonce, nonce_length, ciphertext, tag, tag_length);
+}
+
+CHIP_ERROR Aes128CcmCipher::Decrypt(const uint8_t * ciphertext, size_t ciphertext_length, const uint8_t * aad, size_t aad_length,
+                                    const uint8_t * tag, size_t tag_length, const uint8_t * nonce, size_t nonce_length,
+                                    uint8_t * plaintext) const
+{
+    VerifyOrReturnError(mKey != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+#if CHIP_CONFIG_AES_CCM_KEEP_KEY_SCHEDULE
+    mbedtls_ccm_context * context = GetKeyedCcmContext(mContext, *mKey, ciphertext, ciphertext_length, aad_length, aad, plaintext,
+                                                       nonce, nonce_length, tag, tag_length);
+    if (context != nullptr)
+    {
+        int result = mbedtls_ccm_auth_decrypt(context, ciphertext_length, Uint8::to_const_uchar(nonce), nonce_length,
+                                              Uint8::to_const_uchar(aad), aad_length, Uint8::to_const_uchar(ciphertext),
+                                              Uint8::to_uchar(plaintext), Uint8::to_const_uchar(tag), tag_length);
+        _log_mbedTLS_error(result);
+        return (result == 0) ? CHIP_NO_ERROR : CHIP_ERROR_INTERNAL;
+    }
+#endif // CHIP_CONFIG_AES_CCM_KEEP_KEY_SCHEDULE
+
+    return AES_CCM_decrypt(ciphertext, ciphertext_length, aad, aad_length, tag, tag_length, *mKey, nonce, nonce_length,
+                           plaintext);
+}
+
 CHIP_ERROR Hash_SHA256(const uint8_t * data, const size_t data_length, uint8_t * out_buffer)
 {
     // zero data length hash is supported.
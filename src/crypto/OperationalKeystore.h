@@ -206,6 +206,19 @@ public:
      * @brief Release an ephemeral keypair previously provided by `AllocateEphemeralKeypairForCASE()`
      */
     virtual void ReleaseEphemeralKeypair(Crypto::P256Keypair * keypair) = 0;
+
+    /**
+     * @brief Whether ephemeral keypairs may be generated and used in the background.
+     *
+     * If true, `CASESession` may call `Initialize` and `ECDH_derive_secret` on a keypair
+     * provided by `AllocateEphemeralKeypairForCASE` from a background worker, and the
+     * keypair may then be passed to `ReleaseEphemeralKeypair` from that worker as well.
+     * The keypair is only ever used by one thread at a time.
+     *
+     * @retval true if ephemeral keypairs may be used in the background
+     * @retval false if ephemeral keypairs may NOT be used in the background
+     */
+    virtual bool SupportsEphemeralKeypairInBackground() const { return false; }
 };
 
 } // namespace Crypto
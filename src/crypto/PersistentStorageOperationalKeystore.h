@@ -87,6 +87,8 @@ public:
                                  Crypto::P256ECDSASignature & outSignature) const override;
     Crypto::P256Keypair * AllocateEphemeralKeypairForCASE() override;
     void ReleaseEphemeralKeypair(Crypto::P256Keypair * keypair) override;
+    // Ephemeral keypairs are plain heap-allocated software keys, independent of the storage.
+    bool SupportsEphemeralKeypairInBackground() const override { return true; }
 
 protected:
     void ResetPendingKey()
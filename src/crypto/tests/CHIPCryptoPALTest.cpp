@@ -414,6 +414,76 @@ static void TestAES_CCM_128DecryptInvalidNonceLen(nlTestSuite * inSuite, void *
     NL_TEST_ASSERT(inSuite, numOfTestsRan > 0);
 }
 
+static void TestAES_CCM_128CipherTestVectors(nlTestSuite * inSuite, void * inContext)
+{
+    HeapChecker heapChecker(inSuite);
+    int numOfTestVectors = ArraySize(ccm_128_test_vectors);
+    int numOfTestsRan    = 0;
+    for (int vectorIndex = 0; vectorIndex < numOfTestVectors; vectorIndex++)
+    {
+        const ccm_128_test_vector * vector = ccm_128_test_vectors[vectorIndex];
+        if (vector->pt_len > 0 && vector->result == CHIP_NO_ERROR)
+        {
+            numOfTestsRan++;
+            chip::Platform::ScopedMemoryBuffer<uint8_t> out_ct;
+            out_ct.Alloc(vector->ct_len);
+            NL_TEST_ASSERT(inSuite, out_ct);
+            chip::Platform::ScopedMemoryBuffer<uint8_t> out_tag;
+            out_tag.Alloc(vector->tag_len);
+            NL_TEST_ASSERT(inSuite, out_tag);
+            chip::Platform::ScopedMemoryBuffer<uint8_t> out_pt;
+            out_pt.Alloc(vector->pt_len);
+            NL_TEST_ASSERT(inSuite, out_pt);
+            chip::Platform::ScopedMemoryBuffer<uint8_t> bad_tag;
+            bad_tag.Alloc(vector->tag_len);
+            NL_TEST_ASSERT(inSuite, bad_tag);
+
+            TestAesKey key(inSuite, vector->key, vector->key_len);
+            Aes128CcmCipher cipher;
+            NL_TEST_ASSERT(inSuite, !cipher.IsInitialized());
+            CHIP_ERROR err = cipher.Encrypt(vector->pt, vector->pt_len, vector->aad, vector->aad_len, vector->nonce,
+                                            vector->nonce_len, out_ct.Get(), out_tag.Get(), vector->tag_len);
+            NL_TEST_ASSERT(inSuite, err == CHIP_ERROR_INCORRECT_STATE);
+            cipher.Init(key.key);
+            NL_TEST_ASSERT(inSuite, cipher.IsInitialized());
+
+            // Several rounds, so that later ones run on the context set up by the first
+            for (int round = 0; round < 3; round++)
+            {
+                memset(out_ct.Get(), 0, vector->ct_len);
+                memset(out_tag.Get(), 0, vector->tag_len);
+                err = cipher.Encrypt(vector->pt, vector->pt_len, vector->aad, vector->aad_len, vector->nonce, vector->nonce_len,
+                                     out_ct.Get(), out_tag.Get(), vector->tag_len);
+                NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+                NL_TEST_ASSERT(inSuite, memcmp(out_ct.Get(), vector->ct, vector->ct_len) == 0);
+                NL_TEST_ASSERT(inSuite, memcmp(out_tag.Get(), vector->tag, vector->tag_len) == 0);
+
+                memset(out_pt.Get(), 0, vector->pt_len);
+                err = cipher.Decrypt(vector->ct, vector->ct_len, vector->aad, vector->aad_len, vector->tag, vector->tag_len,
+                                     vector->nonce, vector->nonce_len, out_pt.Get());
+                NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+                NL_TEST_ASSERT(inSuite, memcmp(out_pt.Get(), vector->pt, vector->pt_len) == 0);
+            }
+
+            // A tampered tag fails, and does not affect the next message
+            memcpy(bad_tag.Get(), vector->tag, vector->tag_len);
+            bad_tag[0] ^= 0x01;
+            err = cipher.Decrypt(vector->ct, vector->ct_len, vector->aad, vector->aad_len, bad_tag.Get(), vector->tag_len,
+                                 vector->nonce, vector->nonce_len, out_pt.Get());
+            NL_TEST_ASSERT(inSuite, err != CHIP_NO_ERROR);
+
+            err = cipher.Decrypt(vector->ct, vector->ct_len, vector->aad, vector->aad_len, vector->tag, vector->tag_len,
+                                 vector->nonce, vector->nonce_len, out_pt.Get());
+            NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+            NL_TEST_ASSERT(inSuite, memcmp(out_pt.Get(), vector->pt, vector->pt_len) == 0);
+
+            cipher.Release();
+            NL_TEST_ASSERT(inSuite, !cipher.IsInitialized());
+        }
+    }
+    NL_TEST_ASSERT(inSuite, numOfTestsRan > 0);
+}
+
 static void TestSensitiveDataBuffer(nlTestSuite * inSuite, void * inContext)
 {
     HeapChecker heapChecker(inSuite);
@@ -2935,6 +3005,7 @@ static const nlTest sTests[] = {
     NL_TEST_DEF("Test encrypting AES-CCM-128 using invalid nonce", TestAES_CCM_128EncryptInvalidNonceLen),
     NL_TEST_DEF("Test encrypting AES-CCM-128 using invalid tag", TestAES_CCM_128EncryptInvalidTagLen),
     NL_TEST_DEF("Test decrypting AES-CCM-128 invalid nonce", TestAES_CCM_128DecryptInvalidNonceLen),
+    NL_TEST_DEF("Test AES-CCM-128 cipher with test vectors", TestAES_CCM_128CipherTestVectors),
     NL_TEST_DEF("Test encrypt/decrypt AES-CTR-128 test vectors", TestAES_CTR_128CryptTestVectors),
     NL_TEST_DEF("Test ASN.1 signature conversion routines", TestAsn1Conversions),
     NL_TEST_DEF("Test reading a length from ASN.1 DER stream success cases", TestReadDerLengthValidCases),
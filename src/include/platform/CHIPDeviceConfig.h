@@ -136,6 +136,16 @@
 #define CHIP_DEVICE_CONFIG_BG_MAX_EVENT_QUEUE_SIZE 1
 #endif
 
+/**
+ * CHIP_DEVICE_CONFIG_BG_TASK_COUNT
+ *
+ * The number of background tasks sharing the background event queue, on platforms that support more than one.
+ * Zero means one task per online CPU.
+ */
+#ifndef CHIP_DEVICE_CONFIG_BG_TASK_COUNT
+#define CHIP_DEVICE_CONFIG_BG_TASK_COUNT 1
+#endif
+
 /**
  * CHIP_DEVICE_CONFIG_ICD_SLOW_POLL_INTERVAL
  *
@@ -170,6 +170,33 @@ public:
      */
     CHIP_ERROR Delete(const char * key);
 
+    /**
+     * @brief
+     *   Starts a batch of writes, applied to the KVS together by the matching
+     *   CommitBatch() or undone by AbortBatch(). Batches nest.
+     *
+     *   Platforms whose KVS does not support batches apply every write
+     *   immediately, so AbortBatch() does not undo it.
+     */
+    void BeginBatch();
+
+    /**
+     * @brief
+     *   Ends a batch started with BeginBatch(), and applies its writes if it
+     *   is the outermost one.
+     *
+     * @return CHIP_NO_ERROR the writes were applied.
+     *         Any other error means the writes failed, and were undone.
+     */
+    CHIP_ERROR CommitBatch();
+
+    /**
+     * @brief
+     *   Ends a batch started with BeginBatch(), and undoes its writes if it is
+     *   the outermost one.
+     */
+    void AbortBatch();
+
 private:
     using ImplClass = ::chip::DeviceLayer::PersistedStorage::KeyValueStoreManagerImpl;
 
@@ -182,6 +209,11 @@ protected:
     KeyValueStoreManager(const KeyValueStoreManager &)             = delete;
     KeyValueStoreManager(const KeyValueStoreManager &&)            = delete;
     KeyValueStoreManager & operator=(const KeyValueStoreManager &) = delete;
+
+    // Default implementations for platforms without batches.
+    void _BeginBatch() {}
+    CHIP_ERROR _CommitBatch() { return CHIP_NO_ERROR; }
+    void _AbortBatch() {}
 };
 
 /**
@@ -233,6 +265,21 @@ inline CHIP_ERROR KeyValueStoreManager::Delete(const char * key)
     return static_cast<ImplClass *>(this)->_Delete(key);
 }
 
+inline void KeyValueStoreManager::BeginBatch()
+{
+    static_cast<ImplClass *>(this)->_BeginBatch();
+}
+
+inline CHIP_ERROR KeyValueStoreManager::CommitBatch()
+{
+    return static_cast<ImplClass *>(this)->_CommitBatch();
+}
+
+inline void KeyValueStoreManager::AbortBatch()
+{
+    static_cast<ImplClass *>(this)->_AbortBatch();
+}
+
 } // namespace PersistedStorage
 } // namespace DeviceLayer
 } // namespace chip
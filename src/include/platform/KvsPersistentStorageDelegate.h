@@ -103,6 +103,28 @@ public:
         return mKvsManager->Delete(key);
     }
 
+    void BeginBatch() override
+    {
+        if (mKvsManager != nullptr)
+        {
+            mKvsManager->BeginBatch();
+        }
+    }
+
+    CHIP_ERROR CommitBatch() override
+    {
+        VerifyOrReturnError(mKvsManager != nullptr, CHIP_ERROR_INCORRECT_STATE);
+        return mKvsManager->CommitBatch();
+    }
+
+    void AbortBatch() override
+    {
+        if (mKvsManager != nullptr)
+        {
+            mKvsManager->AbortBatch();
+        }
+    }
+
 protected:
     DeviceLayer::PersistedStorage::KeyValueStoreManager * mKvsManager = nullptr;
 };
@@ -35,6 +35,7 @@
 #include <atomic>
 #include <pthread.h>
 #include <queue>
+#include <vector>
 
 namespace chip {
 namespace DeviceLayer {
@@ -51,6 +52,15 @@ namespace Internal {
 template <class ImplClass>
 class GenericPlatformManagerImpl_POSIX : public GenericPlatformManagerImpl<ImplClass>
 {
+public:
+#if CHIP_DEVICE_CONFIG_ENABLE_BG_EVENT_PROCESSING && !CHIP_SYSTEM_CONFIG_USE_LIBEV
+    /**
+     * Set the number of background worker threads created by the next call to StartBackgroundEventLoopTask().
+     * Zero means one worker per online CPU.
+     */
+    void SetBackgroundTaskCount(size_t count) { mBackgroundTaskCount = count; }
+#endif
+
 protected:
     // OS-specific members (pthread)
     pthread_mutex_t mChipStackLock = PTHREAD_MUTEX_INITIALIZER;
@@ -92,6 +102,12 @@ protected:
     CHIP_ERROR _StopEventLoopTask();
     CHIP_ERROR _StartChipTimer(System::Clock::Timeout duration);
     void _Shutdown();
+#if CHIP_DEVICE_CONFIG_ENABLE_BG_EVENT_PROCESSING && !CHIP_SYSTEM_CONFIG_USE_LIBEV
+    CHIP_ERROR _PostBackgroundEvent(const ChipDeviceEvent * event);
+    void _RunBackgroundEventLoop();
+    CHIP_ERROR _StartBackgroundEventLoopTask();
+    CHIP_ERROR _StopBackgroundEventLoopTask();
+#endif
 
 #if CHIP_STACK_LOCK_TRACKING_ENABLED
     bool _IsChipStackLockedByCurrentThread() const;
@@ -111,6 +127,20 @@ private:
     DeviceSafeQueue mChipEventQueue;
     std::atomic<bool> mShouldRunEventLoop{ true };
     static void * EventLoopTaskMain(void * arg);
+
+#if CHIP_DEVICE_CONFIG_ENABLE_BG_EVENT_PROCESSING
+    // Background events are shared by a pool of worker threads, each running ProcessBackgroundEvents(). Work
+    // posted while no loop is running goes to the Matter thread instead, as on platforms without background
+    // processing.
+    pthread_mutex_t mBackgroundLock     = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t mBackgroundEventCond = PTHREAD_COND_INITIALIZER;
+    std::queue<ChipDeviceEvent> mBackgroundEventQueue;
+    std::vector<pthread_t> mBackgroundTasks;
+    size_t mBackgroundTaskCount        = CHIP_DEVICE_CONFIG_BG_TASK_COUNT;
+    bool mShouldRunBackgroundEventLoop = false;
+    static void * BackgroundEventLoopTaskMain(void * arg);
+    void ProcessBackgroundEvents();
+#endif
 #endif
     void ProcessDeviceEvents();
 };
@@ -40,6 +40,7 @@
 #include <fcntl.h>
 #include <poll.h>
 #include <sched.h>
+#include <string.h>
 #include <unistd.h>
 
 namespace chip {
@@ -254,6 +255,160 @@ void * GenericPlatformManagerImpl_POSIX<ImplClass>::EventLoopTaskMain(void * arg
     return nullptr;
 }
 
+#if CHIP_DEVICE_CONFIG_ENABLE_BG_EVENT_PROCESSING
+
+template <class ImplClass>
+CHIP_ERROR GenericPlatformManagerImpl_POSIX<ImplClass>::_PostBackgroundEvent(const ChipDeviceEvent * event)
+{
+    if (!(event->Type == DeviceEventType::kCallWorkFunct || event->Type == DeviceEventType::kNoOp))
+    {
+        return CHIP_ERROR_INVALID_ARGUMENT;
+    }
+
+    pthread_mutex_lock(&mBackgroundLock);
+
+    if (!mShouldRunBackgroundEventLoop)
+    {
+        pthread_mutex_unlock(&mBackgroundLock);
+        // Use foreground event loop for background events
+        return _PostEvent(event);
+    }
+
+    if (mBackgroundEventQueue.size() >= CHIP_DEVICE_CONFIG_BG_MAX_EVENT_QUEUE_SIZE)
+    {
+        pthread_mutex_unlock(&mBackgroundLock);
+        ChipLogError(DeviceLayer, "Failed to post event to CHIP background event queue");
+        return CHIP_ERROR_NO_MEMORY;
+    }
+
+    mBackgroundEventQueue.push(*event);
+    pthread_cond_signal(&mBackgroundEventCond);
+    pthread_mutex_unlock(&mBackgroundLock);
+
+    return CHIP_NO_ERROR;
+}
+
+template <class ImplClass>
+void GenericPlatformManagerImpl_POSIX<ImplClass>::_RunBackgroundEventLoop()
+{
+    // The application runs the loop from its own thread: start background processing if needed.
+    pthread_mutex_lock(&mBackgroundLock);
+    mShouldRunBackgroundEventLoop = true;
+    pthread_mutex_unlock(&mBackgroundLock);
+
+    ProcessBackgroundEvents();
+}
+
+template <class ImplClass>
+void GenericPlatformManagerImpl_POSIX<ImplClass>::ProcessBackgroundEvents()
+{
+    pthread_mutex_lock(&mBackgroundLock);
+
+    //
+    // Events still queued when the loop is stopped are dispatched before the workers exit: they hold references
+    // (e.g. to CASE session work helpers) that would otherwise leak.
+    //
+    while (true)
+    {
+        while (mBackgroundEventQueue.empty() && mShouldRunBackgroundEventLoop)
+        {
+            pthread_cond_wait(&mBackgroundEventCond, &mBackgroundLock);
+        }
+        if (mBackgroundEventQueue.empty())
+        {
+            break;
+        }
+
+        const ChipDeviceEvent event = mBackgroundEventQueue.front();
+        mBackgroundEventQueue.pop();
+
+        pthread_mutex_unlock(&mBackgroundLock);
+        Impl()->DispatchEvent(&event);
+        pthread_mutex_lock(&mBackgroundLock);
+    }
+
+    pthread_mutex_unlock(&mBackgroundLock);
+}
+
+template <class ImplClass>
+void * GenericPlatformManagerImpl_POSIX<ImplClass>::BackgroundEventLoopTaskMain(void * arg)
+{
+    ChipLogDetail(DeviceLayer, "CHIP background task running");
+    // Unlike RunBackgroundEventLoop(), this does not start background processing, so that a worker which only gets
+    // scheduled after StopBackgroundEventLoopTask() exits right away.
+    static_cast<GenericPlatformManagerImpl_POSIX<ImplClass> *>(arg)->ProcessBackgroundEvents();
+    return nullptr;
+}
+
+template <class ImplClass>
+CHIP_ERROR GenericPlatformManagerImpl_POSIX<ImplClass>::_StartBackgroundEventLoopTask()
+{
+    size_t count = mBackgroundTaskCount;
+    if (count == 0)
+    {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        count     = (cpus > 0) ? static_cast<size_t>(cpus) : 1;
+    }
+
+    pthread_mutex_lock(&mBackgroundLock);
+
+    if (!mBackgroundTasks.empty())
+    {
+        pthread_mutex_unlock(&mBackgroundLock);
+        return CHIP_ERROR_INCORRECT_STATE;
+    }
+
+    int err                       = 0;
+    mShouldRunBackgroundEventLoop = true;
+    for (size_t i = 0; i < count && err == 0; i++)
+    {
+        pthread_t task;
+        err = pthread_create(&task, nullptr, BackgroundEventLoopTaskMain, this);
+        if (err == 0)
+        {
+            mBackgroundTasks.push_back(task);
+        }
+    }
+
+    pthread_mutex_unlock(&mBackgroundLock);
+
+    if (err != 0)
+    {
+        ChipLogError(DeviceLayer, "Failed to start CHIP background task: %s", strerror(err));
+        _StopBackgroundEventLoopTask();
+    }
+
+    return CHIP_ERROR_POSIX(err);
+}
+
+template <class ImplClass>
+CHIP_ERROR GenericPlatformManagerImpl_POSIX<ImplClass>::_StopBackgroundEventLoopTask()
+{
+    pthread_mutex_lock(&mBackgroundLock);
+    mShouldRunBackgroundEventLoop = false;
+    pthread_cond_broadcast(&mBackgroundEventCond);
+    std::vector<pthread_t> tasks;
+    tasks.swap(mBackgroundTasks);
+    pthread_mutex_unlock(&mBackgroundLock);
+
+    int err = 0;
+    for (pthread_t task : tasks)
+    {
+        //
+        // A worker that stops the loop from a background work item cannot wait for itself.
+        //
+        int ret = pthread_equal(pthread_self(), task) ? pthread_detach(task) : pthread_join(task, nullptr);
+        if (ret != 0)
+        {
+            err = ret;
+        }
+    }
+
+    return CHIP_ERROR_POSIX(err);
+}
+
+#endif // CHIP_DEVICE_CONFIG_ENABLE_BG_EVENT_PROCESSING
+
 #endif // !CHIP_SYSTEM_CONFIG_USE_LIBEV
 
 template <class ImplClass>
@@ -391,6 +546,9 @@ void GenericPlatformManagerImpl_POSIX<ImplClass>::_Shutdown()
     VerifyOrDie(mState.load(std::memory_order_relaxed) == State::kStopped);
 
 #if !CHIP_SYSTEM_CONFIG_USE_LIBEV
+#if CHIP_DEVICE_CONFIG_ENABLE_BG_EVENT_PROCESSING
+    _StopBackgroundEventLoopTask();
+#endif
     pthread_mutex_destroy(&mStateLock);
     pthread_cond_destroy(&mEventQueueStoppedCond);
 #endif
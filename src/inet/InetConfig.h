@@ -272,6 +272,65 @@
 #endif
 #endif // INET_CONFIG_UDP_SOCKET_PKTINFO
 
+/**
+ *  @def INET_CONFIG_UDP_SOCKET_MMSG
+ *
+ *  @brief
+ *    Use recvmmsg() and sendmmsg() in the sockets implementation of
+ *    UDPEndPoint, so that several datagrams are received per readiness
+ *    event, and UDPEndPoint::SendMsgs() sends several datagrams per
+ *    system call.
+ *
+ *    Defaults to enabled on Linux, where both calls are available.
+ */
+#ifndef INET_CONFIG_UDP_SOCKET_MMSG
+#if defined(__linux__) && CHIP_SYSTEM_CONFIG_USE_POSIX_SOCKETS
+#define INET_CONFIG_UDP_SOCKET_MMSG 1
+#else
+#define INET_CONFIG_UDP_SOCKET_MMSG 0
+#endif
+#endif // INET_CONFIG_UDP_SOCKET_MMSG
+
+/**
+ *  @def INET_CONFIG_UDP_SOCKET_MMSG_BATCH_SIZE
+ *
+ *  @brief
+ *    The maximum number of datagrams received or sent by one recvmmsg()
+ *    or sendmmsg() call, when INET_CONFIG_UDP_SOCKET_MMSG is enabled.
+ *
+ *    A readable endpoint takes up to this many full-size packet buffers
+ *    while it is drained. With a fixed packet buffer pool, the batch is
+ *    smaller so that a burst leaves buffers for the rest of the stack.
+ */
+#ifndef INET_CONFIG_UDP_SOCKET_MMSG_BATCH_SIZE
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE == 0
+#define INET_CONFIG_UDP_SOCKET_MMSG_BATCH_SIZE 8
+#else
+#define INET_CONFIG_UDP_SOCKET_MMSG_BATCH_SIZE 4
+#endif
+#endif // INET_CONFIG_UDP_SOCKET_MMSG_BATCH_SIZE
+
+/**
+ *  @def INET_CONFIG_UDP_SOCKET_MMSG_MAX_SPARE_BUFFERS
+ *
+ *  @brief
+ *    The maximum number of full-size receive buffers that all UDP
+ *    endpoints together keep between recvmmsg() calls, when
+ *    INET_CONFIG_UDP_SOCKET_MMSG is enabled.
+ *
+ *    Buffers that received nothing are kept for the next call, so that a
+ *    batch only allocates buffers for the datagrams handed off by the
+ *    previous one. Beyond this budget they are freed instead. With a fixed
+ *    packet buffer pool, it defaults to a quarter of the pool.
+ */
+#ifndef INET_CONFIG_UDP_SOCKET_MMSG_MAX_SPARE_BUFFERS
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE == 0
+#define INET_CONFIG_UDP_SOCKET_MMSG_MAX_SPARE_BUFFERS (4 * INET_CONFIG_UDP_SOCKET_MMSG_BATCH_SIZE)
+#else
+#define INET_CONFIG_UDP_SOCKET_MMSG_MAX_SPARE_BUFFERS (CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE / 4)
+#endif
+#endif // INET_CONFIG_UDP_SOCKET_MMSG_MAX_SPARE_BUFFERS
+
 /**
  *  @def HAVE_SO_BINDTODEVICE
  *
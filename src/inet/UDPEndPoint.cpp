@@ -121,6 +121,42 @@ CHIP_ERROR UDPEndPoint::SendMsg(const IPPacketInfo * pktInfo, System::PacketBuff
     return CHIP_NO_ERROR;
 }
 
+CHIP_ERROR UDPEndPoint::SendMsgs(const IPPacketInfo * pktInfos, System::PacketBufferHandle * msgs, size_t count, size_t & sentCount)
+{
+    sentCount = 0;
+
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    INET_FAULT_INJECT(FaultInjection::kFault_Send, err = INET_ERROR_UNKNOWN_INTERFACE;);
+    INET_FAULT_INJECT(FaultInjection::kFault_SendNonCritical, err = CHIP_ERROR_NO_MEMORY;);
+
+    if (err == CHIP_NO_ERROR)
+    {
+        err = SendMsgsImpl(pktInfos, msgs, count, sentCount);
+    }
+
+    // Release the messages that were sent, along with the one that failed.
+    for (size_t i = 0; i < count && i <= sentCount; i++)
+    {
+        msgs[i] = nullptr;
+    }
+
+    ReturnErrorOnFailure(err);
+
+    CHIP_SYSTEM_FAULT_INJECT_ASYNC_EVENT();
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR UDPEndPoint::SendMsgsImpl(const IPPacketInfo * pktInfos, System::PacketBufferHandle * msgs, size_t count,
+                                     size_t & sentCount)
+{
+    for (sentCount = 0; sentCount < count; sentCount++)
+    {
+        ReturnErrorOnFailure(SendMsgImpl(&pktInfos[sentCount], std::move(msgs[sentCount])));
+    }
+    return CHIP_NO_ERROR;
+}
+
 void UDPEndPoint::Close()
 {
     if (mState != State::kClosed)
@@ -227,6 +227,24 @@ public:
      */
     CHIP_ERROR SendMsg(const IPPacketInfo * pktInfo, chip::System::PacketBufferHandle && msg);
 
+    /**
+     * Send several UDP messages, each to its own destination.
+     *
+     *  This is equivalent to calling SendMsg() for each message in turn, stopping at the first failure, but
+     *  implementations that support it hand the messages to the network stack in batches (e.g. with sendmmsg()).
+     *
+     * @param[in]     pktInfos    Source and destination information for each message.
+     * @param[in,out] msgs        Packet buffers containing the messages. The buffers of the messages sent, and of the
+     *                            one that failed, are released. Those after it are left untouched, so that the caller
+     *                            may go on sending them.
+     * @param[in]     count       Number of entries in \c pktInfos and \c msgs.
+     * @param[out]    sentCount   Number of messages queued for transmit.
+     *
+     * @retval  CHIP_NO_ERROR   Success: all messages are queued for transmit.
+     * @retval  other           The error that SendMsg() would return for message number \c sentCount.
+     */
+    CHIP_ERROR SendMsgs(const IPPacketInfo * pktInfos, chip::System::PacketBufferHandle * msgs, size_t count, size_t & sentCount);
+
     /**
      * Close the endpoint.
      *
@@ -295,6 +313,8 @@ protected:
     virtual CHIP_ERROR BindInterfaceImpl(IPAddressType addressType, InterfaceId interfaceId)                                  = 0;
     virtual CHIP_ERROR ListenImpl()                                                                                           = 0;
     virtual CHIP_ERROR SendMsgImpl(const IPPacketInfo * pktInfo, chip::System::PacketBufferHandle && msg)                     = 0;
+    virtual CHIP_ERROR SendMsgsImpl(const IPPacketInfo * pktInfos, chip::System::PacketBufferHandle * msgs, size_t count,
+                                    size_t & sentCount);
     virtual void CloseImpl()                                                                                                  = 0;
 };
 
@@ -167,8 +167,88 @@ CHIP_ERROR IPv4Bind(int socket, const IPAddress & address, uint16_t port)
 }
 #endif // INET_CONFIG_ENABLE_IPV4
 
+// Size of the ancillary data buffer for IP_PKTINFO / IPV6_PKTINFO control messages.
+constexpr size_t kControlDataSize = 256;
+
+/*
+ * Fill in the source of a received datagram from its peer address, and its destination
+ * and interface from any IP_PKTINFO / IPV6_PKTINFO control message.
+ */
+CHIP_ERROR ReadPacketInfo(struct msghdr & msgHeader, IPPacketInfo & pktInfo)
+{
+    const SockAddr & peerSockAddr = *static_cast<const SockAddr *>(msgHeader.msg_name);
+
+    if (peerSockAddr.any.sa_family == AF_INET6)
+    {
+        pktInfo.SrcAddress = IPAddress(peerSockAddr.in6.sin6_addr);
+        pktInfo.SrcPort    = ntohs(peerSockAddr.in6.sin6_port);
+    }
+#if INET_CONFIG_ENABLE_IPV4
+    else if (peerSockAddr.any.sa_family == AF_INET)
+    {
+        pktInfo.SrcAddress = IPAddress(peerSockAddr.in.sin_addr);
+        pktInfo.SrcPort    = ntohs(peerSockAddr.in.sin_port);
+    }
+#endif // INET_CONFIG_ENABLE_IPV4
+    else
+    {
+        return CHIP_ERROR_INCORRECT_STATE;
+    }
+
+    for (struct cmsghdr * controlHdr = CMSG_FIRSTHDR(&msgHeader); controlHdr != nullptr;
+         controlHdr                  = CMSG_NXTHDR(&msgHeader, controlHdr))
+    {
+#if INET_CONFIG_ENABLE_IPV4
+#ifdef IP_PKTINFO
+        if (controlHdr->cmsg_level == IPPROTO_IP && controlHdr->cmsg_type == IP_PKTINFO)
+        {
+            auto * inPktInfo = reinterpret_cast<struct in_pktinfo *> CMSG_DATA(controlHdr);
+            if (!CanCastTo<InterfaceId::PlatformType>(inPktInfo->ipi_ifindex))
+            {
+                return CHIP_ERROR_INCORRECT_STATE;
+            }
+            pktInfo.Interface   = InterfaceId(static_cast<InterfaceId::PlatformType>(inPktInfo->ipi_ifindex));
+            pktInfo.DestAddress = IPAddress(inPktInfo->ipi_addr);
+            continue;
+        }
+#endif // defined(IP_PKTINFO)
+#endif // INET_CONFIG_ENABLE_IPV4
+
+#ifdef IPV6_PKTINFO
+        if (controlHdr->cmsg_level == IPPROTO_IPV6 && controlHdr->cmsg_type == IPV6_PKTINFO)
+        {
+            auto * in6PktInfo = reinterpret_cast<struct in6_pktinfo *> CMSG_DATA(controlHdr);
+            if (!CanCastTo<InterfaceId::PlatformType>(in6PktInfo->ipi6_ifindex))
+            {
+                return CHIP_ERROR_INCORRECT_STATE;
+            }
+            pktInfo.Interface   = InterfaceId(static_cast<InterfaceId::PlatformType>(in6PktInfo->ipi6_ifindex));
+            pktInfo.DestAddress = IPAddress(in6PktInfo->ipi6_addr);
+            continue;
+        }
+#endif // defined(IPV6_PKTINFO)
+    }
+
+    return CHIP_NO_ERROR;
+}
+
 } // anonymous namespace
 
+/*
+ * Storage for the arguments to sendmsg() / sendmmsg() describing one outgoing datagram.
+ */
+struct UDPEndPointImplSockets::OutgoingMessage
+{
+    struct msghdr mHeader;
+    struct iovec mIOV;
+    SockAddr mPeerSockAddr;
+    uint8_t mControlData[kControlDataSize];
+};
+
+#if INET_CONFIG_UDP_SOCKET_MMSG
+size_t UDPEndPointImplSockets::sSpareReceiveBuffers = 0;
+#endif // INET_CONFIG_UDP_SOCKET_MMSG
+
 #if CHIP_SYSTEM_CONFIG_USE_PLATFORM_MULTICAST_API
 UDPEndPointImplSockets::MulticastGroupHandler UDPEndPointImplSockets::sJoinMulticastGroupHandler;
 UDPEndPointImplSockets::MulticastGroupHandler UDPEndPointImplSockets::sLeaveMulticastGroupHandler;
@@ -279,6 +359,72 @@ CHIP_ERROR UDPEndPointImplSockets::ListenImpl()
 }
 
 CHIP_ERROR UDPEndPointImplSockets::SendMsgImpl(const IPPacketInfo * aPktInfo, System::PacketBufferHandle && msg)
+{
+    OutgoingMessage message;
+    ReturnErrorOnFailure(PrepareSendMsg(aPktInfo, msg, message));
+
+    // Send IP packet.
+    const ssize_t lenSent = sendmsg(mSocket, &message.mHeader, 0);
+    if (lenSent == -1)
+    {
+        return CHIP_ERROR_POSIX(errno);
+    }
+    if (lenSent != msg->DataLength())
+    {
+        return CHIP_ERROR_OUTBOUND_MESSAGE_TOO_BIG;
+    }
+    return CHIP_NO_ERROR;
+}
+
+#if INET_CONFIG_UDP_SOCKET_MMSG
+CHIP_ERROR UDPEndPointImplSockets::SendMsgsImpl(const IPPacketInfo * pktInfos, System::PacketBufferHandle * msgs, size_t count,
+                                                size_t & sentCount)
+{
+    constexpr size_t kBatchSize = INET_CONFIG_UDP_SOCKET_MMSG_BATCH_SIZE;
+    OutgoingMessage messages[kBatchSize];
+    struct mmsghdr msgHeaders[kBatchSize];
+
+    sentCount = 0;
+    while (sentCount < count)
+    {
+        // Prepare the next batch. If a message cannot be sent, still send the ones before it.
+        CHIP_ERROR err  = CHIP_NO_ERROR;
+        size_t prepared = 0;
+        while (prepared < kBatchSize && sentCount + prepared < count)
+        {
+            err = PrepareSendMsg(&pktInfos[sentCount + prepared], msgs[sentCount + prepared], messages[prepared]);
+            if (err != CHIP_NO_ERROR)
+            {
+                break;
+            }
+            msgHeaders[prepared].msg_hdr = messages[prepared].mHeader;
+            msgHeaders[prepared].msg_len = 0;
+            prepared++;
+        }
+
+        // sendmmsg() stops at the first datagram that fails; retrying from there reports its error.
+        size_t done = 0;
+        while (done < prepared)
+        {
+            const int sent = sendmmsg(mSocket, &msgHeaders[done], static_cast<unsigned int>(prepared - done), 0);
+            if (sent < 0)
+            {
+                return CHIP_ERROR_POSIX(errno);
+            }
+            for (int i = 0; i < sent; i++, done++, sentCount++)
+            {
+                VerifyOrReturnError(msgHeaders[done].msg_len == msgs[sentCount]->DataLength(), CHIP_ERROR_OUTBOUND_MESSAGE_TOO_BIG);
+            }
+        }
+
+        ReturnErrorOnFailure(err);
+    }
+    return CHIP_NO_ERROR;
+}
+#endif // INET_CONFIG_UDP_SOCKET_MMSG
+
+CHIP_ERROR UDPEndPointImplSockets::PrepareSendMsg(const IPPacketInfo * aPktInfo, const System::PacketBufferHandle & msg,
+                                                  OutgoingMessage & message)
 {
     // Ensure packet buffer is not null
     VerifyOrReturnError(!msg.IsNull(), CHIP_ERROR_INVALID_ARGUMENT);
@@ -293,22 +439,22 @@ CHIP_ERROR UDPEndPointImplSockets::SendMsgImpl(const IPPacketInfo * aPktInfo, Sy
     // For now the entire message must fit within a single buffer.
     VerifyOrReturnError(!msg->HasChainedBuffer(), CHIP_ERROR_MESSAGE_TOO_LONG);
 
-    struct iovec msgIOV;
-    msgIOV.iov_base = msg->Start();
-    msgIOV.iov_len  = msg->DataLength();
+    struct iovec & msgIOV = message.mIOV;
+    msgIOV.iov_base       = msg->Start();
+    msgIOV.iov_len        = msg->DataLength();
 
 #if defined(IP_PKTINFO) || defined(IPV6_PKTINFO)
-    uint8_t controlData[256];
-    memset(controlData, 0, sizeof(controlData));
+    uint8_t * const controlData = message.mControlData;
+    memset(controlData, 0, kControlDataSize);
 #endif // defined(IP_PKTINFO) || defined(IPV6_PKTINFO)
 
-    struct msghdr msgHeader;
+    struct msghdr & msgHeader = message.mHeader;
     memset(&msgHeader, 0, sizeof(msgHeader));
     msgHeader.msg_iov    = &msgIOV;
     msgHeader.msg_iovlen = 1;
 
     // Construct a sockaddr_in/sockaddr_in6 structure containing the destination information.
-    SockAddr peerSockAddr;
+    SockAddr & peerSockAddr = message.mPeerSockAddr;
     memset(&peerSockAddr, 0, sizeof(peerSockAddr));
     msgHeader.msg_name = &peerSockAddr;
     if (mAddrType == IPAddressType::kIPv6)
@@ -352,7 +498,7 @@ CHIP_ERROR UDPEndPointImplSockets::SendMsgImpl(const IPPacketInfo * aPktInfo, Sy
     {
 #if defined(IP_PKTINFO) || defined(IPV6_PKTINFO)
         msgHeader.msg_control    = controlData;
-        msgHeader.msg_controllen = sizeof(controlData);
+        msgHeader.msg_controllen = kControlDataSize;
 
         struct cmsghdr * controlHdr      = CMSG_FIRSTHDR(&msgHeader);
         InterfaceId::PlatformType intfId = intf.GetPlatformInterface();
@@ -410,16 +556,6 @@ CHIP_ERROR UDPEndPointImplSockets::SendMsgImpl(const IPPacketInfo * aPktInfo, Sy
     }
 #endif // INET_CONFIG_UDP_SOCKET_PKTINFO
 
-    // Send IP packet.
-    const ssize_t lenSent = sendmsg(mSocket, &msgHeader, 0);
-    if (lenSent == -1)
-    {
-        return CHIP_ERROR_POSIX(errno);
-    }
-    if (lenSent != msg->DataLength())
-    {
-        return CHIP_ERROR_OUTBOUND_MESSAGE_TOO_BIG;
-    }
     return CHIP_NO_ERROR;
 }
 
@@ -431,6 +567,15 @@ void UDPEndPointImplSockets::CloseImpl()
         close(mSocket);
         mSocket = kInvalidSocketFd;
     }
+
+#if INET_CONFIG_UDP_SOCKET_MMSG
+    for (auto & buffer : mReceiveBuffers)
+    {
+        buffer = nullptr;
+    }
+    sSpareReceiveBuffers -= mSpareReceiveBuffers;
+    mSpareReceiveBuffers = 0;
+#endif // INET_CONFIG_UDP_SOCKET_MMSG
 }
 
 void UDPEndPointImplSockets::Free()
@@ -575,6 +720,9 @@ void UDPEndPointImplSockets::HandlePendingIO(System::SocketEvents events)
         return;
     }
 
+#if INET_CONFIG_UDP_SOCKET_MMSG
+    ReceiveBatch();
+#else  // INET_CONFIG_UDP_SOCKET_MMSG
     CHIP_ERROR lStatus = CHIP_NO_ERROR;
     IPPacketInfo lPacketInfo;
     System::PacketBufferHandle lBuffer;
@@ -589,7 +737,7 @@ void UDPEndPointImplSockets::HandlePendingIO(System::SocketEvents events)
     {
         struct iovec msgIOV;
         SockAddr lPeerSockAddr;
-        uint8_t controlData[256];
+        uint8_t controlData[kControlDataSize];
         struct msghdr msgHeader;
 
         msgIOV.iov_base = lBuffer->Start();
@@ -619,62 +767,7 @@ void UDPEndPointImplSockets::HandlePendingIO(System::SocketEvents events)
         else
         {
             lBuffer->SetDataLength(static_cast<uint16_t>(rcvLen));
-
-            if (lPeerSockAddr.any.sa_family == AF_INET6)
-            {
-                lPacketInfo.SrcAddress = IPAddress(lPeerSockAddr.in6.sin6_addr);
-                lPacketInfo.SrcPort    = ntohs(lPeerSockAddr.in6.sin6_port);
-            }
-#if INET_CONFIG_ENABLE_IPV4
-            else if (lPeerSockAddr.any.sa_family == AF_INET)
-            {
-                lPacketInfo.SrcAddress = IPAddress(lPeerSockAddr.in.sin_addr);
-                lPacketInfo.SrcPort    = ntohs(lPeerSockAddr.in.sin_port);
-            }
-#endif // INET_CONFIG_ENABLE_IPV4
-            else
-            {
-                lStatus = CHIP_ERROR_INCORRECT_STATE;
-            }
-        }
-
-        if (lStatus == CHIP_NO_ERROR)
-        {
-            for (struct cmsghdr * controlHdr = CMSG_FIRSTHDR(&msgHeader); controlHdr != nullptr;
-                 controlHdr                  = CMSG_NXTHDR(&msgHeader, controlHdr))
-            {
-#if INET_CONFIG_ENABLE_IPV4
-#ifdef IP_PKTINFO
-                if (controlHdr->cmsg_level == IPPROTO_IP && controlHdr->cmsg_type == IP_PKTINFO)
-                {
-                    auto * inPktInfo = reinterpret_cast<struct in_pktinfo *> CMSG_DATA(controlHdr);
-                    if (!CanCastTo<InterfaceId::PlatformType>(inPktInfo->ipi_ifindex))
-                    {
-                        lStatus = CHIP_ERROR_INCORRECT_STATE;
-                        break;
-                    }
-                    lPacketInfo.Interface   = InterfaceId(static_cast<InterfaceId::PlatformType>(inPktInfo->ipi_ifindex));
-                    lPacketInfo.DestAddress = IPAddress(inPktInfo->ipi_addr);
-                    continue;
-                }
-#endif // defined(IP_PKTINFO)
-#endif // INET_CONFIG_ENABLE_IPV4
-
-#ifdef IPV6_PKTINFO
-                if (controlHdr->cmsg_level == IPPROTO_IPV6 && controlHdr->cmsg_type == IPV6_PKTINFO)
-                {
-                    auto * in6PktInfo = reinterpret_cast<struct in6_pktinfo *> CMSG_DATA(controlHdr);
-                    if (!CanCastTo<InterfaceId::PlatformType>(in6PktInfo->ipi6_ifindex))
-                    {
-                        lStatus = CHIP_ERROR_INCORRECT_STATE;
-                        break;
-                    }
-                    lPacketInfo.Interface   = InterfaceId(static_cast<InterfaceId::PlatformType>(in6PktInfo->ipi6_ifindex));
-                    lPacketInfo.DestAddress = IPAddress(in6PktInfo->ipi6_addr);
-                    continue;
-                }
-#endif // defined(IPV6_PKTINFO)
-            }
+            lStatus = ReadPacketInfo(msgHeader, lPacketInfo);
         }
     }
     else
@@ -694,7 +787,155 @@ void UDPEndPointImplSockets::HandlePendingIO(System::SocketEvents events)
             OnReceiveError(this, lStatus, nullptr);
         }
     }
+#endif // INET_CONFIG_UDP_SOCKET_MMSG
+}
+
+#if INET_CONFIG_UDP_SOCKET_MMSG
+void UDPEndPointImplSockets::ReceiveBatch()
+{
+    constexpr size_t kBatchSize = INET_CONFIG_UDP_SOCKET_MMSG_BATCH_SIZE;
+    struct mmsghdr msgHeaders[kBatchSize];
+    struct iovec msgIOVs[kBatchSize];
+    SockAddr peerSockAddrs[kBatchSize];
+    uint8_t controlData[kBatchSize][kControlDataSize];
+
+    // The spare buffers kept by the previous batch are in use again until this one is done with them.
+    sSpareReceiveBuffers -= mSpareReceiveBuffers;
+    mSpareReceiveBuffers = 0;
+
+    // Receive into the spare buffers, allocating only the slots that were handed off or given back.
+    size_t count = 0;
+    for (; count < kBatchSize; count++)
+    {
+        System::PacketBufferHandle & buffer = mReceiveBuffers[count];
+        if (buffer.IsNull())
+        {
+            buffer = System::PacketBufferHandle::New(System::PacketBuffer::kMaxSizeWithoutReserve, 0);
+            if (buffer.IsNull())
+            {
+                break;
+            }
+        }
+
+        msgIOVs[count].iov_base = buffer->Start();
+        msgIOVs[count].iov_len  = buffer->AvailableDataLength();
+        memset(&peerSockAddrs[count], 0, sizeof(peerSockAddrs[count]));
+        memset(&msgHeaders[count], 0, sizeof(msgHeaders[count]));
+
+        struct msghdr & msgHeader = msgHeaders[count].msg_hdr;
+        msgHeader.msg_name        = &peerSockAddrs[count];
+        msgHeader.msg_namelen     = sizeof(peerSockAddrs[count]);
+        msgHeader.msg_iov         = &msgIOVs[count];
+        msgHeader.msg_iovlen      = 1;
+        msgHeader.msg_control     = controlData[count];
+        msgHeader.msg_controllen  = kControlDataSize;
+    }
+
+    if (count == 0)
+    {
+        if (OnReceiveError != nullptr)
+        {
+            OnReceiveError(this, CHIP_ERROR_NO_MEMORY, nullptr);
+        }
+        return;
+    }
+
+    const int received = recvmmsg(mSocket, msgHeaders, static_cast<unsigned int>(count), MSG_DONTWAIT, nullptr);
+    if (received < 0)
+    {
+        CHIP_ERROR status = CHIP_ERROR_POSIX(errno);
+        KeepSpareReceiveBuffers(0, count);
+        if (OnReceiveError != nullptr && status != CHIP_ERROR_POSIX(EAGAIN))
+        {
+            OnReceiveError(this, status, nullptr);
+        }
+        return;
+    }
+
+    // Settle the buffers that received nothing before handing any message off, so that callbacks can allocate.
+    KeepSpareReceiveBuffers(static_cast<size_t>(received), count);
+
+    // A callback may close or free this endpoint; keep it alive until the batch has been handled, and stop
+    // delivering once it is no longer listening.
+    Retain();
+    for (int i = 0; i < received && mState == State::kListening && OnMessageReceived != nullptr; i++)
+    {
+        struct msghdr & msgHeader = msgHeaders[i].msg_hdr;
+
+        IPPacketInfo packetInfo;
+        packetInfo.Clear();
+        packetInfo.DestPort  = mBoundPort;
+        packetInfo.Interface = mBoundIntfId;
+
+        CHIP_ERROR status = CHIP_NO_ERROR;
+        if ((msgHeader.msg_flags & MSG_TRUNC) != 0)
+        {
+            status = CHIP_ERROR_INBOUND_MESSAGE_TOO_BIG;
+        }
+        else
+        {
+            status = ReadPacketInfo(msgHeader, packetInfo);
+        }
+
+        if (status != CHIP_NO_ERROR)
+        {
+            // The buffer was not handed off, so it may be kept for the next batch.
+            if (OnReceiveError != nullptr)
+            {
+                OnReceiveError(this, status, nullptr);
+            }
+            continue;
+        }
+
+        System::PacketBufferHandle message;
+        const uint16_t length = static_cast<uint16_t>(msgHeaders[i].msg_len);
+#if CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP
+        // Copy small datagrams into a buffer of the right size, so that they do not hold on to a full-size
+        // allocation, and keep the full-size buffer for the next batch.
+        if (length <= System::PacketBuffer::kMaxSizeWithoutReserve / 2)
+        {
+            message = System::PacketBufferHandle::NewWithData(mReceiveBuffers[i]->Start(), length, 0, 0);
+        }
+#endif // CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP
+        if (message.IsNull())
+        {
+            message = std::move(mReceiveBuffers[i]);
+            message->SetDataLength(length);
+        }
+
+        OnMessageReceived(this, std::move(message), &packetInfo);
+    }
+
+    // A callback that closed the endpoint has already freed its buffers.
+    if (mState == State::kListening)
+    {
+        KeepSpareReceiveBuffers(0, static_cast<size_t>(received));
+    }
+    Release();
+}
+
+void UDPEndPointImplSockets::KeepSpareReceiveBuffers(size_t begin, size_t end)
+{
+    for (size_t i = begin; i < end; i++)
+    {
+        System::PacketBufferHandle & buffer = mReceiveBuffers[i];
+        if (buffer.IsNull())
+        {
+            continue;
+        }
+
+        if (sSpareReceiveBuffers < INET_CONFIG_UDP_SOCKET_MMSG_MAX_SPARE_BUFFERS)
+        {
+            sSpareReceiveBuffers++;
+            mSpareReceiveBuffers++;
+        }
+        else
+        {
+            buffer = nullptr;
+        }
+    }
 }
+#endif // INET_CONFIG_UDP_SOCKET_MMSG
 
 #ifdef IPV6_MULTICAST_LOOP
 static CHIP_ERROR SocketsSetMulticastLoopback(int aSocket, bool aLoopback, int aProtocol, int aOption)
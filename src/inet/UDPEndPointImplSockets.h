@@ -52,15 +52,35 @@ private:
     CHIP_ERROR BindInterfaceImpl(IPAddressType addressType, InterfaceId interfaceId) override;
     CHIP_ERROR ListenImpl() override;
     CHIP_ERROR SendMsgImpl(const IPPacketInfo * pktInfo, chip::System::PacketBufferHandle && msg) override;
+#if INET_CONFIG_UDP_SOCKET_MMSG
+    CHIP_ERROR SendMsgsImpl(const IPPacketInfo * pktInfos, chip::System::PacketBufferHandle * msgs, size_t count,
+                            size_t & sentCount) override;
+#endif // INET_CONFIG_UDP_SOCKET_MMSG
     void CloseImpl() override;
 
+    struct OutgoingMessage;
+
     CHIP_ERROR GetSocket(IPAddressType addressType);
+    CHIP_ERROR PrepareSendMsg(const IPPacketInfo * pktInfo, const chip::System::PacketBufferHandle & msg,
+                              OutgoingMessage & message);
     void HandlePendingIO(System::SocketEvents events);
     static void HandlePendingIO(System::SocketEvents events, intptr_t data);
 
     InterfaceId mBoundIntfId;
     uint16_t mBoundPort;
 
+#if INET_CONFIG_UDP_SOCKET_MMSG
+    void ReceiveBatch();
+    // Keeps the buffers of slots [begin, end) that were not handed off as spares, within the shared budget, and frees the rest.
+    void KeepSpareReceiveBuffers(size_t begin, size_t end);
+
+    // Receive buffers for recvmmsg(). Buffers not handed off to OnMessageReceived are kept for the next batch, as long as all
+    // endpoints together keep no more than INET_CONFIG_UDP_SOCKET_MMSG_MAX_SPARE_BUFFERS of them.
+    chip::System::PacketBufferHandle mReceiveBuffers[INET_CONFIG_UDP_SOCKET_MMSG_BATCH_SIZE];
+    size_t mSpareReceiveBuffers = 0;
+    static size_t sSpareReceiveBuffers;
+#endif // INET_CONFIG_UDP_SOCKET_MMSG
+
 #if CHIP_SYSTEM_CONFIG_USE_PLATFORM_MULTICAST_API
 public:
     using MulticastGroupHandler = CHIP_ERROR (*)(InterfaceId, const IPAddress &);
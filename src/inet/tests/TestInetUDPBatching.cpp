@@ -0,0 +1,280 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This is a unit test suite and throughput benchmark for batched UDP send and receive
+ *      (sendmmsg / recvmmsg) in the sockets implementation of <tt>chip::Inet::UDPEndPoint</tt>.
+ *
+ *      Bursts of datagrams of varying size are sent over IPv6 loopback, either one SendMsg() call
+ *      per datagram or through SendMsgs(). The test checks that every datagram arrives intact and
+ *      in order, with its packet information, and reports datagrams per second and per wakeup.
+ */
+
+#include <inet/InetConfig.h>
+
+#include <inet/UDPEndPointImpl.h>
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/UnitTestRegistration.h>
+#include <nlunit-test.h>
+#include <system/SystemLayerImpl.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+using namespace chip;
+using namespace chip::Inet;
+using namespace chip::System;
+
+namespace {
+
+constexpr size_t kBurstSize = 64;
+constexpr size_t kNumBursts = 200;
+
+// Payload size of datagram number n: a mix of small (mDNS, acks) and large messages.
+uint16_t PayloadSize(uint32_t n)
+{
+    return static_cast<uint16_t>((n % 4 == 3) ? 1000 : 16 + (n % 97));
+}
+
+struct BenchContext
+{
+    nlTestSuite * mSuite;
+    uint16_t mPort          = 0;
+    uint32_t mNextExpected  = 0;
+    size_t mReceived        = 0;
+    size_t mReceiveErrors   = 0;
+    size_t mOversizeBuffers = 0;
+};
+
+void HandleMessageReceived(UDPEndPoint * endPoint, PacketBufferHandle && msg, const IPPacketInfo * pktInfo)
+{
+    auto * ctx = static_cast<BenchContext *>(endPoint->mAppState);
+
+    uint32_t n = 0;
+    if (msg->DataLength() >= sizeof(n))
+    {
+        memcpy(&n, msg->Start(), sizeof(n));
+    }
+    NL_TEST_ASSERT(ctx->mSuite, n == ctx->mNextExpected);
+    NL_TEST_ASSERT(ctx->mSuite, msg->DataLength() == PayloadSize(n));
+    NL_TEST_ASSERT(ctx->mSuite, pktInfo->DestPort == ctx->mPort);
+    NL_TEST_ASSERT(ctx->mSuite, pktInfo->SrcAddress == IPAddress::Loopback(IPAddressType::kIPv6));
+
+#if CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP
+    // Small datagrams must not hold on to a full-size receive buffer.
+    if (msg->DataLength() <= PacketBuffer::kMaxSizeWithoutReserve / 2 && msg->AllocSize() >= PacketBuffer::kMaxSizeWithoutReserve)
+    {
+        ctx->mOversizeBuffers++;
+    }
+#endif // CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP
+
+    ctx->mNextExpected = n + 1;
+    ctx->mReceived++;
+}
+
+void HandleReceiveError(UDPEndPoint * endPoint, CHIP_ERROR err, const IPPacketInfo * pktInfo)
+{
+    static_cast<BenchContext *>(endPoint->mAppState)->mReceiveErrors++;
+}
+
+uint64_t NowMicroseconds()
+{
+    return SystemClock().GetMonotonicMicroseconds64().count();
+}
+
+void RunBursts(nlTestSuite * inSuite, LayerImpl & layer, UDPEndPoint * sender, BenchContext & ctx, bool batched)
+{
+    IPPacketInfo pktInfos[kBurstSize];
+    PacketBufferHandle msgs[kBurstSize];
+    size_t wakeups    = 0;
+    uint32_t n        = 0;
+    ctx.mNextExpected = 0;
+    ctx.mReceived     = 0;
+    uint64_t start    = NowMicroseconds();
+
+    for (size_t burst = 0; burst < kNumBursts; burst++)
+    {
+        for (size_t i = 0; i < kBurstSize; i++, n++)
+        {
+            uint8_t payload[1000] = {};
+            memcpy(payload, &n, sizeof(n));
+            msgs[i] = PacketBufferHandle::NewWithData(payload, PayloadSize(n));
+            NL_TEST_ASSERT(inSuite, !msgs[i].IsNull());
+
+            pktInfos[i].Clear();
+            pktInfos[i].DestAddress = IPAddress::Loopback(IPAddressType::kIPv6);
+            pktInfos[i].DestPort    = ctx.mPort;
+        }
+
+        if (batched)
+        {
+            size_t sent = 0;
+            NL_TEST_ASSERT(inSuite, sender->SendMsgs(pktInfos, msgs, kBurstSize, sent) == CHIP_NO_ERROR);
+            NL_TEST_ASSERT(inSuite, sent == kBurstSize);
+        }
+        else
+        {
+            for (size_t i = 0; i < kBurstSize; i++)
+            {
+                NL_TEST_ASSERT(inSuite, sender->SendMsg(&pktInfos[i], std::move(msgs[i])) == CHIP_NO_ERROR);
+            }
+        }
+
+        // Loopback delivery is synchronous, so the whole burst is already queued on the receiving socket.
+        const size_t expected = (burst + 1) * kBurstSize;
+        for (size_t guard = 0; ctx.mReceived < expected && guard < 4 * kBurstSize; guard++)
+        {
+            layer.PrepareEvents();
+            layer.WaitForEvents();
+            layer.HandleEvents();
+            wakeups++;
+        }
+        NL_TEST_ASSERT(inSuite, ctx.mReceived == expected);
+    }
+
+    uint64_t elapsed = NowMicroseconds() - start;
+    printf("  %s: %zu datagrams, %" PRIu64 " datagrams/s, %.1f datagrams/wakeup\n", batched ? "SendMsgs" : "SendMsg ",
+           ctx.mReceived, (elapsed > 0) ? static_cast<uint64_t>(ctx.mReceived) * 1000000 / elapsed : 0,
+           static_cast<double>(ctx.mReceived) / static_cast<double>(wakeups ? wakeups : 1));
+}
+
+// A message that cannot be sent stops SendMsgs() there, leaving the ones after it to the caller.
+void RunPartialFailure(nlTestSuite * inSuite, LayerImpl & layer, UDPEndPoint * sender, BenchContext & ctx)
+{
+    constexpr size_t kCount  = INET_CONFIG_UDP_SOCKET_MMSG_BATCH_SIZE + 3;
+    constexpr size_t kFailed = INET_CONFIG_UDP_SOCKET_MMSG_BATCH_SIZE + 1;
+    IPPacketInfo pktInfos[kCount];
+    PacketBufferHandle msgs[kCount];
+    uint32_t n        = 0;
+    ctx.mNextExpected = 0;
+    ctx.mReceived     = 0;
+
+    for (size_t i = 0; i < kCount; i++)
+    {
+        pktInfos[i].Clear();
+        pktInfos[i].DestAddress = IPAddress::Loopback(IPAddressType::kIPv6);
+        pktInfos[i].DestPort    = ctx.mPort;
+        if (i != kFailed)
+        {
+            uint8_t payload[1000] = {};
+            memcpy(payload, &n, sizeof(n));
+            msgs[i] = PacketBufferHandle::NewWithData(payload, PayloadSize(n++));
+        }
+    }
+
+    size_t sent = 0;
+    NL_TEST_ASSERT(inSuite, sender->SendMsgs(pktInfos, msgs, kCount, sent) == CHIP_ERROR_INVALID_ARGUMENT);
+    NL_TEST_ASSERT(inSuite, sent == kFailed);
+    for (size_t i = 0; i < kCount; i++)
+    {
+        NL_TEST_ASSERT(inSuite, msgs[i].IsNull() == (i <= kFailed));
+    }
+
+    constexpr size_t kRest = kCount - kFailed - 1;
+    NL_TEST_ASSERT(inSuite, sender->SendMsgs(&pktInfos[kFailed + 1], &msgs[kFailed + 1], kRest, sent) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, sent == kRest);
+
+    for (size_t guard = 0; ctx.mReceived < kCount - 1 && guard < 4 * kCount; guard++)
+    {
+        layer.PrepareEvents();
+        layer.WaitForEvents();
+        layer.HandleEvents();
+    }
+    NL_TEST_ASSERT(inSuite, ctx.mReceived == kCount - 1);
+}
+
+void CheckBatchedLoopback(nlTestSuite * inSuite, void * inContext)
+{
+    LayerImpl layer;
+    UDPEndPointManagerImpl udp;
+    NL_TEST_ASSERT(inSuite, layer.Init() == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, udp.Init(layer) == CHIP_NO_ERROR);
+
+    BenchContext ctx;
+    ctx.mSuite = inSuite;
+
+    UDPEndPoint * receiver = nullptr;
+    UDPEndPoint * sender   = nullptr;
+    NL_TEST_ASSERT(inSuite, udp.NewEndPoint(&receiver) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, udp.NewEndPoint(&sender) == CHIP_NO_ERROR);
+    VerifyOrReturn(receiver != nullptr && sender != nullptr);
+
+    CHIP_ERROR err = receiver->Bind(IPAddressType::kIPv6, IPAddress::Loopback(IPAddressType::kIPv6), 0);
+    if (err != CHIP_NO_ERROR)
+    {
+        printf("  skipped, IPv6 loopback is not available (%" CHIP_ERROR_FORMAT ")\n", err.Format());
+    }
+    else
+    {
+        ctx.mPort = receiver->GetBoundPort();
+        NL_TEST_ASSERT(inSuite, receiver->Listen(HandleMessageReceived, HandleReceiveError, &ctx) == CHIP_NO_ERROR);
+
+        RunBursts(inSuite, layer, sender, ctx, false);
+        RunBursts(inSuite, layer, sender, ctx, true);
+        RunPartialFailure(inSuite, layer, sender, ctx);
+
+        NL_TEST_ASSERT(inSuite, ctx.mReceiveErrors == 0);
+        NL_TEST_ASSERT(inSuite, ctx.mOversizeBuffers == 0);
+    }
+
+    sender->Free();
+    receiver->Free();
+    udp.Shutdown();
+    layer.Shutdown();
+}
+
+} // namespace
+
+// clang-format off
+static const nlTest sTests[] =
+{
+    NL_TEST_DEF("UDPBatching::TestLoopback", CheckBatchedLoopback),
+    NL_TEST_SENTINEL()
+};
+// clang-format on
+
+static int TestSetup(void * aContext)
+{
+    return (Platform::MemoryInit() == CHIP_NO_ERROR) ? SUCCESS : FAILURE;
+}
+
+static int TestTeardown(void * aContext)
+{
+    Platform::MemoryShutdown();
+    return SUCCESS;
+}
+
+int TestInetUDPBatching()
+{
+    // clang-format off
+    nlTestSuite theSuite =
+    {
+        "inet-udp-batching",
+        &sTests[0],
+        TestSetup,
+        TestTeardown
+    };
+    // clang-format on
+
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestInetUDPBatching)
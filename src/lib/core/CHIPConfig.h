@@ -218,6 +218,20 @@
 #define CHIP_CONFIG_SHA256_CONTEXT_ALIGN size_t
 #endif // CHIP_CONFIG_SHA256_CONTEXT_ALIGN
 
+/**
+ *  @def CHIP_CONFIG_AES_CCM_KEEP_KEY_SCHEDULE
+ *
+ * @brief
+ *   Whether an Aes128CcmCipher keeps its backend cipher context, with the expanded key, between messages.
+ *
+ *   This saves the allocation and key setup of a cipher context for every message encrypted or decrypted
+ *   with a session or group key, at the cost of one heap-allocated context per key in use (a few hundred
+ *   bytes with mbedTLS). It only applies to the OpenSSL, BoringSSL and mbedTLS backends.
+ */
+#ifndef CHIP_CONFIG_AES_CCM_KEEP_KEY_SCHEDULE
+#define CHIP_CONFIG_AES_CCM_KEEP_KEY_SCHEDULE CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
+#endif // CHIP_CONFIG_AES_CCM_KEEP_KEY_SCHEDULE
+
 /**
  *  @def CHIP_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS
  *
@@ -745,6 +759,57 @@
 #define CHIP_CONFIG_SECURE_SESSION_POOL_SIZE (CHIP_CONFIG_MAX_FABRICS * 3 + 2)
 #endif // CHIP_CONFIG_SECURE_SESSION_POOL_SIZE
 
+/**
+ * @def CHIP_CONFIG_SECURE_SESSION_ID_BITMAP
+ *
+ * @brief If true, the secure session table keeps a bitmap of the local
+ * session IDs in use (8 KiB for the whole 16-bit ID space), so that
+ * allocating a new session ID takes the same time however many sessions
+ * there are.  Otherwise candidate IDs are looked up one at a time in the
+ * table's session ID index, which is as fast unless the IDs following the
+ * last allocated one are still in use.
+ */
+#ifndef CHIP_CONFIG_SECURE_SESSION_ID_BITMAP
+#define CHIP_CONFIG_SECURE_SESSION_ID_BITMAP CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
+#endif // CHIP_CONFIG_SECURE_SESSION_ID_BITMAP
+
+/**
+ * @def CHIP_CONFIG_CASE_SERVER_MAX_CONCURRENT_HANDSHAKES
+ *
+ * @brief Maximum number of CASE handshakes that CASEServer runs as a
+ * responder at the same time.  Further Sigma1 messages are answered with
+ * a busy status report.
+ *
+ * Each handshake in progress holds a CASESession and a SecureSession.
+ * The extra SecureSessions are not reserved in
+ * CHIP_CONFIG_SECURE_SESSION_POOL_SIZE: they are obtained through the
+ * usual session eviction when the pool is full.
+ */
+#ifndef CHIP_CONFIG_CASE_SERVER_MAX_CONCURRENT_HANDSHAKES
+#if CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
+#define CHIP_CONFIG_CASE_SERVER_MAX_CONCURRENT_HANDSHAKES 4
+#else
+#define CHIP_CONFIG_CASE_SERVER_MAX_CONCURRENT_HANDSHAKES 1
+#endif // CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
+#endif // CHIP_CONFIG_CASE_SERVER_MAX_CONCURRENT_HANDSHAKES
+
+/**
+ * @def CHIP_CONFIG_CASE_SERVER_MAX_HANDSHAKES_PER_FABRIC
+ *
+ * @brief Maximum number of the concurrent CASEServer handshakes (see
+ * CHIP_CONFIG_CASE_SERVER_MAX_CONCURRENT_HANDSHAKES) that may be for
+ * the same fabric, so that a burst of handshakes on one fabric cannot
+ * lock out the others.  A Sigma1 over the limit is answered with a busy
+ * status report.
+ */
+#ifndef CHIP_CONFIG_CASE_SERVER_MAX_HANDSHAKES_PER_FABRIC
+#if CHIP_CONFIG_CASE_SERVER_MAX_CONCURRENT_HANDSHAKES > 1
+#define CHIP_CONFIG_CASE_SERVER_MAX_HANDSHAKES_PER_FABRIC (CHIP_CONFIG_CASE_SERVER_MAX_CONCURRENT_HANDSHAKES - 1)
+#else
+#define CHIP_CONFIG_CASE_SERVER_MAX_HANDSHAKES_PER_FABRIC 1
+#endif
+#endif // CHIP_CONFIG_CASE_SERVER_MAX_HANDSHAKES_PER_FABRIC
+
 /**
  *  @def CHIP_CONFIG_MAX_GROUP_DATA_PEERS
  *
@@ -830,6 +895,9 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
  *      * #CHIP_IM_MAX_REPORTS_IN_FLIGHT
  *      * #CHIP_IM_SERVER_MAX_NUM_PATH_GROUPS
  *      * #CHIP_IM_SERVER_MAX_NUM_DIRTY_SET
+ *      * #CHIP_IM_SERVER_DIRTY_SET_INDEX_BUCKETS
+ *      * #CHIP_IM_SERVER_READ_HANDLER_INDEX_BUCKETS
+ *      * #CHIP_IM_SERVER_INTERFACE_REGISTRY_BUCKETS
  *      * #CHIP_IM_MAX_NUM_WRITE_HANDLER
  *      * #CHIP_IM_MAX_NUM_WRITE_CLIENT
  *      * #CHIP_IM_MAX_NUM_TIMED_HANDLER
@@ -901,12 +969,54 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 /**
  * @def CHIP_IM_SERVER_MAX_NUM_DIRTY_SET
  *
- * @brief Defines the maximum number of dirty set, limits the number of attributes being read or subscribed at the same time.
+ * @brief Defines the maximum number of dirty set entries when pools are statically allocated. Limits both the number of clusters
+ * and the number of individual attributes that can be tracked as dirty at the same time; beyond that, dirty paths are merged.
  */
 #ifndef CHIP_IM_SERVER_MAX_NUM_DIRTY_SET
 #define CHIP_IM_SERVER_MAX_NUM_DIRTY_SET 8
 #endif
 
+/**
+ * @def CHIP_IM_SERVER_DIRTY_SET_INDEX_BUCKETS
+ *
+ * @brief Defines the number of hash buckets used to look up dirty set entries by (endpoint, cluster). Must be a power of two.
+ */
+#ifndef CHIP_IM_SERVER_DIRTY_SET_INDEX_BUCKETS
+#if CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
+#define CHIP_IM_SERVER_DIRTY_SET_INDEX_BUCKETS 64
+#else
+#define CHIP_IM_SERVER_DIRTY_SET_INDEX_BUCKETS 8
+#endif
+#endif
+
+/**
+ * @def CHIP_IM_SERVER_READ_HANDLER_INDEX_BUCKETS
+ *
+ * @brief Defines the number of hash buckets used to find the read handlers interested in a dirty (endpoint, cluster). Must be
+ * a power of two.
+ */
+#ifndef CHIP_IM_SERVER_READ_HANDLER_INDEX_BUCKETS
+#if CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
+#define CHIP_IM_SERVER_READ_HANDLER_INDEX_BUCKETS 256
+#else
+#define CHIP_IM_SERVER_READ_HANDLER_INDEX_BUCKETS 16
+#endif
+#endif
+
+/**
+ * @def CHIP_IM_SERVER_INTERFACE_REGISTRY_BUCKETS
+ *
+ * @brief Defines the number of hash buckets used to find the AttributeAccessInterface or CommandHandlerInterface registered
+ * for an (endpoint, cluster). Must be a power of two.
+ */
+#ifndef CHIP_IM_SERVER_INTERFACE_REGISTRY_BUCKETS
+#if CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
+#define CHIP_IM_SERVER_INTERFACE_REGISTRY_BUCKETS 64
+#else
+#define CHIP_IM_SERVER_INTERFACE_REGISTRY_BUCKETS 16
+#endif
+#endif
+
 /**
  * @def CHIP_IM_MAX_NUM_WRITE_HANDLER
  *
@@ -935,6 +1045,16 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_IM_MAX_NUM_TIMED_HANDLER 8
 #endif
 
+/**
+ * @def CHIP_CONFIG_MAX_PATHS_PER_INVOKE
+ *
+ * @brief The maximum number of commands a CommandHandler takes in a single Invoke Request. Commands of a batch are told apart by
+ *        their command reference, and the responses to them may be chunked over several Invoke Response messages.
+ */
+#ifndef CHIP_CONFIG_MAX_PATHS_PER_INVOKE
+#define CHIP_CONFIG_MAX_PATHS_PER_INVOKE 10
+#endif
+
 /**
  * @}
  */
@@ -962,6 +1082,22 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_CONFIG_IM_ENABLE_ENCODING_SENTINEL_ENUM_VALUES 0
 #endif
 
+/**
+ * @def CHIP_CONFIG_ATTRIBUTE_STORAGE_LOOKUP_TABLE_SIZE
+ *
+ * @brief Defines the number of slots in the hash table that attribute storage uses to look up endpoints, server clusters and
+ *        attributes by id. Each slot takes 16 bytes and holds one endpoint, or one cluster or attribute of a distinct endpoint
+ *        type. Must be zero or a power of two; when zero, or when the table is too small for the data model, attribute
+ *        storage falls back to linear scans.
+ */
+#ifndef CHIP_CONFIG_ATTRIBUTE_STORAGE_LOOKUP_TABLE_SIZE
+#if CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
+#define CHIP_CONFIG_ATTRIBUTE_STORAGE_LOOKUP_TABLE_SIZE 1024
+#else
+#define CHIP_CONFIG_ATTRIBUTE_STORAGE_LOOKUP_TABLE_SIZE 0
+#endif
+#endif
+
 /**
  * @def CHIP_CONFIG_LAMBDA_EVENT_SIZE
  *
@@ -1083,6 +1219,27 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_CONFIG_MAX_GROUP_CONCURRENT_ITERATORS 2
 #endif
 
+/**
+ * @def CHIP_CONFIG_GROUP_SESSION_CACHE_SIZE
+ *
+ * @brief Defines the number of group session keys kept in memory for the decryption of incoming group messages
+ *
+ * Each group-keyset mapping contributes one entry per epoch key (up to 3) of its key set. While all of them fit, incoming group
+ * messages are matched against the cache instead of the records in persistent storage. The default covers all fabrics when
+ * the system pools use the heap, and a single fabric otherwise.
+ */
+#ifndef CHIP_CONFIG_GROUP_SESSION_CACHE_SIZE
+#if CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
+#define CHIP_CONFIG_GROUP_SESSION_CACHE_SIZE (CHIP_CONFIG_MAX_FABRICS * CHIP_CONFIG_MAX_GROUPS_PER_FABRIC * 3)
+#else
+#define CHIP_CONFIG_GROUP_SESSION_CACHE_SIZE (CHIP_CONFIG_MAX_GROUPS_PER_FABRIC * 3)
+#endif
+#endif
+
+#if CHIP_CONFIG_GROUP_SESSION_CACHE_SIZE < 1
+#error "Please ensure CHIP_CONFIG_GROUP_SESSION_CACHE_SIZE > 0."
+#endif
+
 /**
  * @def CHIP_CONFIG_MAX_GROUP_NAME_LENGTH
  *
@@ -1192,6 +1349,18 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE (3 * CHIP_CONFIG_MAX_FABRICS)
 #endif
 
+/**
+ * @def CHIP_CONFIG_CASE_SESSION_RESUME_CACHED_STORAGE
+ *
+ * @brief
+ *   Use CachedSessionResumptionStorage as the session resumption storage of the server: all the
+ *   resumption records are kept in RAM, so that resuming a session does not read persistent storage.
+ *   Otherwise SimpleSessionResumptionStorage, which reads the records on each lookup, is used.
+ */
+#ifndef CHIP_CONFIG_CASE_SESSION_RESUME_CACHED_STORAGE
+#define CHIP_CONFIG_CASE_SESSION_RESUME_CACHED_STORAGE 0
+#endif
+
 /**
  * @def CHIP_CONFIG_EVENT_LOGGING_BYTE_THRESHOLD
  *
@@ -1212,6 +1381,21 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_CONFIG_EVENT_LOGGING_BYTE_THRESHOLD 512
 #endif /* CHIP_CONFIG_EVENT_LOGGING_BYTE_THRESHOLD */
 
+/**
+ * @def CHIP_CONFIG_EVENT_LOGGING_CHECKPOINTS
+ *
+ * @brief The number of (event number, position) checkpoints each event
+ *   logging buffer keeps, so that fetching the events since a given event
+ *   number starts reading near that event instead of at the oldest one.
+ *
+ * Checkpoints are spread evenly over the buffer, so a fetch decodes at most
+ * about 1/CHIP_CONFIG_EVENT_LOGGING_CHECKPOINTS of a buffer worth of events it
+ * does not report.  Each checkpoint takes 16 bytes per buffer.
+ */
+#ifndef CHIP_CONFIG_EVENT_LOGGING_CHECKPOINTS
+#define CHIP_CONFIG_EVENT_LOGGING_CHECKPOINTS 16
+#endif
+
 /**
  * @def CHIP_CONFIG_ENABLE_SERVER_IM_EVENT
  *
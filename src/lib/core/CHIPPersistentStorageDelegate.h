@@ -110,6 +110,73 @@ public:
         CHIP_ERROR err = SyncGetKeyValue(key, nullptr, size);
         return (err == CHIP_ERROR_BUFFER_TOO_SMALL) || (err == CHIP_NO_ERROR);
     }
+
+    /**
+     * @brief
+     *   Starts a batch of writes, for the writes of one logical operation that spans several keys.
+     *
+     *   Implementations that support batches may hold the writes made until the matching CommitBatch()
+     *   or AbortBatch(), and apply them to the underlying storage together. Reads made in between see
+     *   the written values. Batches nest: an inner batch is part of the outermost one, whose commit or
+     *   abort applies or discards all of their writes.
+     *
+     *   The default implementation applies every write immediately, so AbortBatch() does not undo it.
+     *   Use PersistentStorageBatch rather than calling these methods directly.
+     */
+    virtual void BeginBatch() {}
+
+    /**
+     * @brief
+     *   Ends a batch started with BeginBatch(), and applies its writes if it is the outermost one.
+     *
+     * @return CHIP_NO_ERROR on success, or the error of the first write that failed to be applied.
+     */
+    virtual CHIP_ERROR CommitBatch() { return CHIP_NO_ERROR; }
+
+    /**
+     * @brief
+     *   Ends a batch started with BeginBatch(), and discards its writes if it is the outermost one.
+     */
+    virtual void AbortBatch() {}
+};
+
+/**
+ * Scoped batch of writes to a PersistentStorageDelegate (see PersistentStorageDelegate::BeginBatch).
+ *
+ * The batch is aborted on destruction unless it was committed, so that the writes of an operation
+ * that returns early on error are discarded by the storage implementations that hold them.
+ */
+class PersistentStorageBatch
+{
+public:
+    explicit PersistentStorageBatch(PersistentStorageDelegate * storage) : mStorage(storage)
+    {
+        if (mStorage != nullptr)
+        {
+            mStorage->BeginBatch();
+        }
+    }
+
+    ~PersistentStorageBatch()
+    {
+        if (mStorage != nullptr)
+        {
+            mStorage->AbortBatch();
+        }
+    }
+
+    PersistentStorageBatch(const PersistentStorageBatch &)             = delete;
+    PersistentStorageBatch & operator=(const PersistentStorageBatch &) = delete;
+
+    CHIP_ERROR Commit()
+    {
+        PersistentStorageDelegate * storage = mStorage;
+        mStorage                            = nullptr;
+        return (storage != nullptr) ? storage->CommitBatch() : CHIP_NO_ERROR;
+    }
+
+private:
+    PersistentStorageDelegate * mStorage;
 };
 
 } // namespace chip
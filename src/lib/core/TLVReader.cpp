@@ -57,6 +57,12 @@ void TLVReader::Init(const uint8_t * data, size_t dataLen)
     ImplicitProfileId = kProfileIdNotSpecified;
 }
 
+void TLVReader::Init(const ByteSpan & data, TLVType containerType)
+{
+    Init(data);
+    mContainerType = containerType;
+}
+
 CHIP_ERROR TLVReader::Init(TLVBackingStore & backingStore, uint32_t maxLen)
 {
     mBackingStore   = &backingStore;
@@ -499,6 +505,26 @@ CHIP_ERROR TLVReader::GetDataPtr(const uint8_t *& data) const
     return CHIP_NO_ERROR;
 }
 
+CHIP_ERROR TLVReader::GetElementEncoding(ByteSpan & element) const
+{
+    TLVElementType elemType = ElementType();
+    VerifyOrReturnError(mBackingStore == nullptr, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(elemType != TLVElementType::NotSpecified && elemType != TLVElementType::EndOfContainer,
+                        CHIP_ERROR_INCORRECT_STATE);
+
+    // The reader is positioned right past the head of the element, and skipping the element takes it to its end.
+    uint8_t elemHeadBytes;
+    ReturnErrorOnFailure(GetElementHeadLength(elemHeadBytes));
+
+    TLVReader endReader;
+    endReader.Init(*this);
+    ReturnErrorOnFailure(endReader.Skip());
+
+    const uint8_t * elemStart = mReadPoint - elemHeadBytes;
+    element                   = ByteSpan(elemStart, static_cast<size_t>(endReader.mReadPoint - elemStart));
+    return CHIP_NO_ERROR;
+}
+
 CHIP_ERROR TLVReader::OpenContainer(TLVReader & containerReader)
 {
     TLVElementType elemType = ElementType();
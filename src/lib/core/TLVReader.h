@@ -102,6 +102,21 @@ public:
      */
     void Init(const ByteSpan & data) { Init(data.data(), data.size()); }
 
+    /**
+     * Initializes a TLVReader object to read from a single input buffer holding
+     * elements taken out of a container of the given type, such as a context-tagged
+     * member of a structure.
+     *
+     * The tags of the elements are then checked as they would be within such a
+     * container, instead of as top-level elements. kTLVType_UnknownContainer admits
+     * elements with any tag.
+     *
+     * @param[in]   data            A byte span to read from
+     * @param[in]   containerType   The type of container the elements were taken out of
+     *
+     */
+    void Init(const ByteSpan & data, TLVType containerType);
+
     /**
      * Initializes a TLVReader object to read from a single input buffer
      * represented as byte array.
@@ -875,6 +890,24 @@ public:
      */
     const uint8_t * GetReadPoint() const { return mReadPoint; }
 
+    /**
+     * Gets the encoding of the current element in the underlying input buffer, from its control byte to its end.
+     *
+     * This allows keeping a reference to an element where it was read, instead of copying it out. The element
+     * keeps the tag it has in its container, so it may need to be read back with Init(data, kTLVType_UnknownContainer).
+     *
+     * This is only supported for readers of a single input buffer, positioned on an element whose value has not
+     * been read out with GetBytes(), GetString() or their Dup variants.
+     *
+     * @param[out] element                  Set to the encoding of the current element.
+     *
+     * @retval #CHIP_NO_ERROR               If the encoding of the element was found.
+     * @retval #CHIP_ERROR_INCORRECT_STATE  If the reader is not positioned on an element, or reads from a
+     *                                      TLVBackingStore.
+     * @retval other                        Other CHIP error codes returned while skipping the element.
+     */
+    CHIP_ERROR GetElementEncoding(ByteSpan & element) const;
+
     /**
      * Advances the TLVReader object to immediately after the current TLV element.
      *
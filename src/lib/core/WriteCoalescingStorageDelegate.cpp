@@ -0,0 +1,337 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <lib/core/WriteCoalescingStorageDelegate.h>
+
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CHIPMemString.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+#include <algorithm>
+#include <string.h>
+#include <utility>
+
+namespace chip {
+
+WriteCoalescingStorageDelegate::PendingWrite * WriteCoalescingStorageDelegate::PendingWriteList::Find(const char * key) const
+{
+    for (PendingWrite * write = mHead; write != nullptr; write = write->mNext)
+    {
+        if (strcmp(write->mKey, key) == 0)
+        {
+            return write;
+        }
+    }
+    return nullptr;
+}
+
+CHIP_ERROR WriteCoalescingStorageDelegate::PendingWriteList::Add(const char * key, const void * value, uint16_t size, bool isDelete)
+{
+    // Copy the value first, so that a failed allocation leaves the list as it was.
+    Platform::ScopedMemoryBuffer<uint8_t> buffer;
+    if (size > 0)
+    {
+        VerifyOrReturnError(buffer.Alloc(size), CHIP_ERROR_NO_MEMORY);
+        memcpy(buffer.Get(), value, size);
+    }
+
+    PendingWrite * write = Find(key);
+    if (write == nullptr)
+    {
+        write = Platform::New<PendingWrite>();
+        VerifyOrReturnError(write != nullptr, CHIP_ERROR_NO_MEMORY);
+        Platform::CopyString(write->mKey, key);
+
+        if (mTail != nullptr)
+        {
+            mTail->mNext = write;
+        }
+        else
+        {
+            mHead = write;
+        }
+        mTail = write;
+    }
+
+    write->mIsDelete = isDelete;
+    write->mValue    = std::move(buffer);
+    write->mSize     = size;
+    return CHIP_NO_ERROR;
+}
+
+void WriteCoalescingStorageDelegate::PendingWriteList::Remove(const char * key)
+{
+    PendingWrite * prev = nullptr;
+    for (PendingWrite * write = mHead; write != nullptr; prev = write, write = write->mNext)
+    {
+        if (strcmp(write->mKey, key) == 0)
+        {
+            (prev != nullptr ? prev->mNext : mHead) = write->mNext;
+            if (mTail == write)
+            {
+                mTail = prev;
+            }
+            Platform::Delete(write);
+            return;
+        }
+    }
+}
+
+void WriteCoalescingStorageDelegate::PendingWriteList::Clear()
+{
+    while (mHead != nullptr)
+    {
+        PendingWrite * next = mHead->mNext;
+        Platform::Delete(mHead);
+        mHead = next;
+    }
+    mTail = nullptr;
+}
+
+WriteCoalescingStorageDelegate::~WriteCoalescingStorageDelegate()
+{
+    if (mDeferred.Head() != nullptr)
+    {
+        ChipLogError(Support, "WriteCoalescingStorageDelegate destroyed with held writes, call Shutdown()");
+    }
+}
+
+CHIP_ERROR WriteCoalescingStorageDelegate::Init(PersistentStorageDelegate * backend)
+{
+    VerifyOrReturnError(backend != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(mBackend == nullptr, CHIP_ERROR_INCORRECT_STATE);
+    mBackend = backend;
+    return CHIP_NO_ERROR;
+}
+
+void WriteCoalescingStorageDelegate::Shutdown()
+{
+    VerifyOrReturn(mBackend != nullptr);
+
+    mBatch.Clear();
+    mBatchDepth = 0;
+
+    CHIP_ERROR err = Flush();
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(Support, "Failed to apply held storage writes: %" CHIP_ERROR_FORMAT, err.Format());
+    }
+    mDeferred.Clear();
+
+    mSystemLayer   = nullptr;
+    mIsNonCritical = nullptr;
+    mBackend       = nullptr;
+}
+
+CHIP_ERROR WriteCoalescingStorageDelegate::SetCoalescingWindow(System::Layer * systemLayer, System::Clock::Timeout window,
+                                                               NonCriticalKeyFilter isNonCritical)
+{
+    VerifyOrReturnError(systemLayer != nullptr && isNonCritical != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    ReturnErrorOnFailure(Flush());
+
+    mSystemLayer   = systemLayer;
+    mWindow        = window;
+    mIsNonCritical = isNonCritical;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR WriteCoalescingStorageDelegate::Flush()
+{
+    if (mFlushScheduled)
+    {
+        mSystemLayer->CancelTimer(OnCoalescingWindowExpired, this);
+        mFlushScheduled = false;
+    }
+    return Apply(mDeferred);
+}
+
+void WriteCoalescingStorageDelegate::OnCoalescingWindowExpired(System::Layer * systemLayer, void * context)
+{
+    auto * self = static_cast<WriteCoalescingStorageDelegate *>(context);
+
+    self->mFlushScheduled = false;
+
+    CHIP_ERROR err = self->Flush();
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(Support, "Failed to apply held storage writes: %" CHIP_ERROR_FORMAT, err.Format());
+    }
+}
+
+WriteCoalescingStorageDelegate::PendingWrite * WriteCoalescingStorageDelegate::FindPendingWrite(const char * key) const
+{
+    // Writes of the open batch are newer than the ones held for the coalescing window.
+    PendingWrite * write = mBatch.Find(key);
+    return (write != nullptr) ? write : mDeferred.Find(key);
+}
+
+CHIP_ERROR WriteCoalescingStorageDelegate::SyncGetKeyValue(const char * key, void * buffer, uint16_t & size)
+{
+    VerifyOrReturnError(mBackend != nullptr, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(key != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(buffer != nullptr || size == 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    PendingWrite * write = FindPendingWrite(key);
+    if (write == nullptr)
+    {
+        mCounters.backendReads++;
+        return mBackend->SyncGetKeyValue(key, buffer, size);
+    }
+    VerifyOrReturnError(!write->mIsDelete, CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+
+    uint16_t copySize = std::min(size, write->mSize);
+    if (copySize > 0)
+    {
+        memcpy(buffer, write->mValue.Get(), copySize);
+    }
+    bool tooSmall = size < write->mSize;
+    size          = copySize;
+    return tooSmall ? CHIP_ERROR_BUFFER_TOO_SMALL : CHIP_NO_ERROR;
+}
+
+CHIP_ERROR WriteCoalescingStorageDelegate::SyncSetKeyValue(const char * key, const void * value, uint16_t size)
+{
+    VerifyOrReturnError(mBackend != nullptr, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(key != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(value != nullptr || size == 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    mCounters.requestedWrites++;
+    return Write(key, value, size, false);
+}
+
+CHIP_ERROR WriteCoalescingStorageDelegate::SyncDeleteKeyValue(const char * key)
+{
+    VerifyOrReturnError(mBackend != nullptr, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(key != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    mCounters.requestedWrites++;
+
+    // Deleting a missing key fails, so a held delete needs to know whether the key exists.
+    PendingWrite * write = FindPendingWrite(key);
+    if (write != nullptr)
+    {
+        VerifyOrReturnError(!write->mIsDelete, CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+    }
+    else if (mBatchDepth > 0 || (mIsNonCritical != nullptr && mIsNonCritical(key)))
+    {
+        mCounters.backendReads++;
+        VerifyOrReturnError(mBackend->SyncDoesKeyExist(key), CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+    }
+    return Write(key, nullptr, 0, true);
+}
+
+CHIP_ERROR WriteCoalescingStorageDelegate::Write(const char * key, const void * value, uint16_t size, bool isDelete)
+{
+    // Keys longer than the maximum every backend must support are not held.
+    if (strlen(key) > kKeyLengthMax)
+    {
+        return WriteThrough(key, value, size, isDelete);
+    }
+
+    if (mBatchDepth > 0)
+    {
+        return mBatch.Add(key, value, size, isDelete);
+    }
+
+    if (mIsNonCritical != nullptr && mIsNonCritical(key))
+    {
+        ReturnErrorOnFailure(mDeferred.Add(key, value, size, isDelete));
+        if (!mFlushScheduled)
+        {
+            ReturnErrorOnFailure(mSystemLayer->StartTimer(mWindow, OnCoalescingWindowExpired, this));
+            mFlushScheduled = true;
+        }
+        return CHIP_NO_ERROR;
+    }
+
+    return WriteThrough(key, value, size, isDelete);
+}
+
+CHIP_ERROR WriteCoalescingStorageDelegate::WriteThrough(const char * key, const void * value, uint16_t size, bool isDelete)
+{
+    mDeferred.Remove(key);
+
+    mCounters.backendWrites++;
+    mCounters.backendCommits++;
+    return isDelete ? mBackend->SyncDeleteKeyValue(key) : mBackend->SyncSetKeyValue(key, value, size);
+}
+
+CHIP_ERROR WriteCoalescingStorageDelegate::Apply(PendingWriteList & writes)
+{
+    VerifyOrReturnError(!writes.IsEmpty(), CHIP_NO_ERROR);
+    VerifyOrReturnError(mBackend != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    // The writes go to the backing store as one batch of its own, so that a backend that supports
+    // batches (e.g. the Linux KVS log) applies them together.
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    mBackend->BeginBatch();
+    for (PendingWrite * write = writes.Head(); write != nullptr && err == CHIP_NO_ERROR; write = write->mNext)
+    {
+        mCounters.backendWrites++;
+        if (write->mIsDelete)
+        {
+            err = mBackend->SyncDeleteKeyValue(write->mKey);
+            // The key may have been written and deleted while held, without ever reaching the backing store.
+            if (err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
+            {
+                err = CHIP_NO_ERROR;
+            }
+        }
+        else
+        {
+            err = mBackend->SyncSetKeyValue(write->mKey, write->mValue.Get(), write->mSize);
+        }
+    }
+    writes.Clear();
+
+    if (err != CHIP_NO_ERROR)
+    {
+        mBackend->AbortBatch();
+        return err;
+    }
+    ReturnErrorOnFailure(mBackend->CommitBatch());
+    mCounters.backendCommits++;
+    return CHIP_NO_ERROR;
+}
+
+void WriteCoalescingStorageDelegate::BeginBatch()
+{
+    mBatchDepth++;
+}
+
+CHIP_ERROR WriteCoalescingStorageDelegate::CommitBatch()
+{
+    VerifyOrReturnError(mBatchDepth > 0, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(--mBatchDepth == 0, CHIP_NO_ERROR);
+
+    // The batch supersedes the older values held for the coalescing window.
+    for (PendingWrite * write = mBatch.Head(); write != nullptr; write = write->mNext)
+    {
+        mDeferred.Remove(write->mKey);
+    }
+    return Apply(mBatch);
+}
+
+void WriteCoalescingStorageDelegate::AbortBatch()
+{
+    VerifyOrReturn(mBatchDepth > 0);
+    VerifyOrReturn(--mBatchDepth == 0);
+    mBatch.Clear();
+}
+
+} // namespace chip
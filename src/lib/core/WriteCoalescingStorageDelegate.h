@@ -0,0 +1,142 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <lib/core/CHIPError.h>
+#include <lib/core/CHIPPersistentStorageDelegate.h>
+#include <lib/support/ScopedBuffer.h>
+#include <system/SystemClock.h>
+#include <system/SystemLayer.h>
+
+#include <stdint.h>
+
+namespace chip {
+
+/**
+ * PersistentStorageDelegate that holds writes in memory and applies them to a backing
+ * PersistentStorageDelegate in groups:
+ *
+ *  - The writes of a batch (see PersistentStorageDelegate::BeginBatch) are applied when the outermost
+ *    batch is committed, and discarded when it is aborted.
+ *  - Optionally, the writes of keys deemed non-critical are held for up to a coalescing window outside
+ *    of batches, and applied together when it expires.
+ *
+ * A key written several times while held is only written once to the backing store, and reads see
+ * the held values. Each group of writes is applied as one batch of the backing store, so it is only
+ * atomic across keys if the backing store supports batches. The backing store must not be used
+ * directly while writes are held.
+ */
+class WriteCoalescingStorageDelegate : public PersistentStorageDelegate
+{
+public:
+    /**
+     * Returns whether writes of the given key may be held for the coalescing window.
+     */
+    using NonCriticalKeyFilter = bool (*)(const char * key);
+
+    struct Counters
+    {
+        uint32_t requestedWrites = 0; ///< SyncSetKeyValue and SyncDeleteKeyValue calls
+        uint32_t backendReads    = 0; ///< Reads of the backing store
+        uint32_t backendWrites   = 0; ///< Sets and deletes applied to the backing store
+        uint32_t backendCommits  = 0; ///< Batches committed to the backing store, a write not held counting as one
+    };
+
+    WriteCoalescingStorageDelegate() = default;
+    ~WriteCoalescingStorageDelegate() override;
+
+    WriteCoalescingStorageDelegate(const WriteCoalescingStorageDelegate &)             = delete;
+    WriteCoalescingStorageDelegate & operator=(const WriteCoalescingStorageDelegate &) = delete;
+
+    CHIP_ERROR Init(PersistentStorageDelegate * backend);
+
+    /**
+     * Applies the held writes, discards any open batch and stops using the backing store.
+     */
+    void Shutdown();
+
+    /**
+     * Holds the writes of non-critical keys made outside of batches for up to `window`.
+     */
+    CHIP_ERROR SetCoalescingWindow(System::Layer * systemLayer, System::Clock::Timeout window, NonCriticalKeyFilter isNonCritical);
+
+    /**
+     * Applies the writes held for the coalescing window now.
+     */
+    CHIP_ERROR Flush();
+
+    const Counters & GetCounters() const { return mCounters; }
+    void ResetCounters() { mCounters = Counters(); }
+
+    // PersistentStorageDelegate
+    CHIP_ERROR SyncGetKeyValue(const char * key, void * buffer, uint16_t & size) override;
+    CHIP_ERROR SyncSetKeyValue(const char * key, const void * value, uint16_t size) override;
+    CHIP_ERROR SyncDeleteKeyValue(const char * key) override;
+    void BeginBatch() override;
+    CHIP_ERROR CommitBatch() override;
+    void AbortBatch() override;
+
+private:
+    struct PendingWrite
+    {
+        PendingWrite * mNext = nullptr;
+        char mKey[kKeyLengthMax + 1];
+        Platform::ScopedMemoryBuffer<uint8_t> mValue;
+        uint16_t mSize = 0;
+        bool mIsDelete = false;
+    };
+
+    // Writes held in memory, in the order in which their keys were first written.
+    class PendingWriteList
+    {
+    public:
+        ~PendingWriteList() { Clear(); }
+
+        PendingWrite * Find(const char * key) const;
+        CHIP_ERROR Add(const char * key, const void * value, uint16_t size, bool isDelete);
+        void Remove(const char * key);
+        void Clear();
+        bool IsEmpty() const { return mHead == nullptr; }
+        PendingWrite * Head() const { return mHead; }
+
+    private:
+        PendingWrite * mHead = nullptr;
+        PendingWrite * mTail = nullptr;
+    };
+
+    static void OnCoalescingWindowExpired(System::Layer * systemLayer, void * context);
+
+    PendingWrite * FindPendingWrite(const char * key) const;
+    CHIP_ERROR Write(const char * key, const void * value, uint16_t size, bool isDelete);
+    CHIP_ERROR WriteThrough(const char * key, const void * value, uint16_t size, bool isDelete);
+    CHIP_ERROR Apply(PendingWriteList & writes);
+
+    PersistentStorageDelegate * mBackend = nullptr;
+    PendingWriteList mBatch;
+    PendingWriteList mDeferred;
+    unsigned mBatchDepth = 0;
+
+    System::Layer * mSystemLayer        = nullptr;
+    System::Clock::Timeout mWindow      = System::Clock::kZero;
+    NonCriticalKeyFilter mIsNonCritical = nullptr;
+    bool mFlushScheduled                = false;
+
+    Counters mCounters;
+};
+
+} // namespace chip
@@ -4601,6 +4601,63 @@ static void CheckGetByteView(nlTestSuite * inSuite, void * inContext)
     }
 }
 
+static void CheckGetElementEncoding(nlTestSuite * inSuite, void * inContext)
+{
+    uint8_t buf[256];
+    const uint8_t testBytes[] = { 1, 2, 3 };
+    TLVType outerType;
+    TLVType innerType;
+
+    TLVWriter writer;
+    writer.Init(buf);
+    NL_TEST_ASSERT(inSuite, writer.StartContainer(AnonymousTag(), kTLVType_Structure, outerType) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, writer.Put(ContextTag(1), static_cast<uint8_t>(5)) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, writer.PutBytes(ContextTag(2), testBytes, sizeof(testBytes)) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, writer.StartContainer(ContextTag(3), kTLVType_Structure, innerType) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, writer.PutBoolean(ContextTag(1), true) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, writer.EndContainer(innerType) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, writer.EndContainer(outerType) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, writer.Finalize() == CHIP_NO_ERROR);
+
+    TLVReader reader;
+    ByteSpan element;
+    reader.Init(buf, writer.GetLengthWritten());
+    NL_TEST_ASSERT(inSuite, reader.GetElementEncoding(element) == CHIP_ERROR_INCORRECT_STATE);
+
+    // The outer structure spans the whole encoding.
+    NL_TEST_ASSERT(inSuite, reader.Next() == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, reader.GetElementEncoding(element) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, element.data() == buf && element.size() == writer.GetLengthWritten());
+    NL_TEST_ASSERT(inSuite, reader.EnterContainer(outerType) == CHIP_NO_ERROR);
+
+    // The members follow each other, and can be read back with their context tags.
+    const uint8_t * expectedStart = buf + 1;
+    for (uint8_t tag = 1; tag <= 3; tag++)
+    {
+        NL_TEST_ASSERT(inSuite, reader.Next() == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, reader.GetElementEncoding(element) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, element.data() == expectedStart);
+        expectedStart = element.data() + element.size();
+
+        TLVReader elementReader;
+        elementReader.Init(element);
+        NL_TEST_ASSERT(inSuite, elementReader.Next() == CHIP_ERROR_INVALID_TLV_TAG);
+
+        elementReader.Init(element, kTLVType_UnknownContainer);
+        NL_TEST_ASSERT(inSuite, elementReader.Next() == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, elementReader.GetTag() == ContextTag(tag));
+        NL_TEST_ASSERT(inSuite, elementReader.GetType() == reader.GetType());
+        NL_TEST_ASSERT(inSuite, elementReader.Skip() == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, elementReader.GetLengthRead() == element.size());
+        NL_TEST_ASSERT(inSuite, elementReader.Next() == CHIP_END_OF_TLV);
+    }
+
+    // Only the end of the outer structure is left.
+    NL_TEST_ASSERT(inSuite, expectedStart == buf + writer.GetLengthWritten() - 1);
+    NL_TEST_ASSERT(inSuite, reader.Next() == CHIP_END_OF_TLV);
+    NL_TEST_ASSERT(inSuite, reader.GetElementEncoding(element) == CHIP_ERROR_INCORRECT_STATE);
+}
+
 static void CheckTLVScopedBuffer(nlTestSuite * inSuite, void * inContext)
 {
     Platform::ScopedMemoryBuffer<uint8_t> buf;
@@ -4683,6 +4740,7 @@ static const nlTest sTests[] =
     NL_TEST_DEF("CHIP TLV Reader Fuzz Test",           TLVReaderFuzzTest),
     NL_TEST_DEF("CHIP TLV GetStringView Test",         CheckGetStringView),
     NL_TEST_DEF("CHIP TLV GetByteView Test",           CheckGetByteView),
+    NL_TEST_DEF("CHIP TLV GetElementEncoding Test",    CheckGetElementEncoding),
     NL_TEST_DEF("Int Min/Max Test",                    TestIntMinMax),
 
     NL_TEST_SENTINEL()
@@ -0,0 +1,417 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <lib/core/WriteCoalescingStorageDelegate.h>
+#include <lib/support/CHIPMem.h>
+#include <lib/support/TestPersistentStorageDelegate.h>
+#include <lib/support/UnitTestRegistration.h>
+#include <system/SystemLayerImpl.h>
+
+#include <nlunit-test.h>
+
+#include <string.h>
+
+using namespace chip;
+
+namespace {
+
+// Backing store that counts the writes and batches that reach it.
+class CountingStorageDelegate : public TestPersistentStorageDelegate
+{
+public:
+    unsigned mSets          = 0;
+    unsigned mDeletes       = 0;
+    unsigned mBatchCommits  = 0;
+    unsigned mBatchAborts   = 0;
+    unsigned mBatchDepth    = 0;
+    unsigned mWritesInBatch = 0;
+
+    void BeginBatch() override { mBatchDepth++; }
+
+    CHIP_ERROR CommitBatch() override
+    {
+        mBatchDepth--;
+        mBatchCommits++;
+        return CHIP_NO_ERROR;
+    }
+
+    void AbortBatch() override
+    {
+        mBatchDepth--;
+        mBatchAborts++;
+    }
+
+protected:
+    CHIP_ERROR SyncSetKeyValueInternal(const char * key, const void * value, uint16_t size) override
+    {
+        mSets++;
+        mWritesInBatch += (mBatchDepth > 0) ? 1 : 0;
+        return TestPersistentStorageDelegate::SyncSetKeyValueInternal(key, value, size);
+    }
+
+    CHIP_ERROR SyncDeleteKeyValueInternal(const char * key) override
+    {
+        mDeletes++;
+        mWritesInBatch += (mBatchDepth > 0) ? 1 : 0;
+        return TestPersistentStorageDelegate::SyncDeleteKeyValueInternal(key);
+    }
+};
+
+// System layer that only records the last timer started, for the test to fire it.
+class ManualTimerLayer : public System::LayerImpl
+{
+public:
+    CHIP_ERROR StartTimer(System::Clock::Timeout aDelay, System::TimerCompleteCallback aComplete, void * aAppState) override
+    {
+        VerifyOrReturnError(mComplete == nullptr, CHIP_ERROR_NO_MEMORY);
+        mDelay    = aDelay;
+        mComplete = aComplete;
+        mAppState = aAppState;
+        return CHIP_NO_ERROR;
+    }
+
+    void CancelTimer(System::TimerCompleteCallback aComplete, void * aAppState) override
+    {
+        if (mComplete == aComplete && mAppState == aAppState)
+        {
+            mComplete = nullptr;
+        }
+    }
+
+    bool IsTimerPending() const { return mComplete != nullptr; }
+    System::Clock::Timeout GetDelay() const { return mDelay; }
+
+    void FireTimer()
+    {
+        System::TimerCompleteCallback complete = mComplete;
+        mComplete                              = nullptr;
+        if (complete != nullptr)
+        {
+            complete(this, mAppState);
+        }
+    }
+
+private:
+    System::Clock::Timeout mDelay           = System::Clock::kZero;
+    System::TimerCompleteCallback mComplete = nullptr;
+    void * mAppState                        = nullptr;
+};
+
+bool IsNonCriticalKey(const char * key)
+{
+    return strncmp(key, "nc/", 3) == 0;
+}
+
+bool HasValue(PersistentStorageDelegate & storage, const char * key, uint32_t expected)
+{
+    uint32_t value = 0;
+    uint16_t size  = sizeof(value);
+    return storage.SyncGetKeyValue(key, &value, size) == CHIP_NO_ERROR && size == sizeof(value) && value == expected;
+}
+
+void TestWriteThroughOutsideBatch(nlTestSuite * inSuite, void * inContext)
+{
+    CountingStorageDelegate backend;
+    WriteCoalescingStorageDelegate storage;
+    NL_TEST_ASSERT(inSuite, storage.Init(&backend) == CHIP_NO_ERROR);
+
+    uint32_t value = 1;
+    NL_TEST_ASSERT(inSuite, storage.SyncSetKeyValue("a", &value, sizeof(value)) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, HasValue(backend, "a", 1));
+    NL_TEST_ASSERT(inSuite, storage.SyncDeleteKeyValue("a") == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, !backend.SyncDoesKeyExist("a"));
+    NL_TEST_ASSERT(inSuite, storage.SyncDeleteKeyValue("a") == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+
+    NL_TEST_ASSERT(inSuite, storage.GetCounters().requestedWrites == 3);
+    NL_TEST_ASSERT(inSuite, storage.GetCounters().backendWrites == 3);
+    NL_TEST_ASSERT(inSuite, storage.GetCounters().backendCommits == 3);
+
+    storage.Shutdown();
+}
+
+void TestBatchReadYourWrites(nlTestSuite * inSuite, void * inContext)
+{
+    CountingStorageDelegate backend;
+    WriteCoalescingStorageDelegate storage;
+    NL_TEST_ASSERT(inSuite, storage.Init(&backend) == CHIP_NO_ERROR);
+
+    uint32_t value = 7;
+    NL_TEST_ASSERT(inSuite, backend.SyncSetKeyValue("old", &value, sizeof(value)) == CHIP_NO_ERROR);
+
+    {
+        PersistentStorageBatch batch(&storage);
+
+        value = 1;
+        NL_TEST_ASSERT(inSuite, storage.SyncSetKeyValue("new", &value, sizeof(value)) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, storage.SyncDeleteKeyValue("old") == CHIP_NO_ERROR);
+
+        // Held writes are visible to reads, but have not reached the backing store.
+        NL_TEST_ASSERT(inSuite, HasValue(storage, "new", 1));
+        NL_TEST_ASSERT(inSuite, !storage.SyncDoesKeyExist("old"));
+        NL_TEST_ASSERT(inSuite, !backend.SyncDoesKeyExist("new"));
+        NL_TEST_ASSERT(inSuite, HasValue(backend, "old", 7));
+
+        // Short reads of held values follow the PersistentStorageDelegate semantics.
+        uint8_t shortBuffer[2];
+        uint16_t size = sizeof(shortBuffer);
+        NL_TEST_ASSERT(inSuite, storage.SyncGetKeyValue("new", shortBuffer, size) == CHIP_ERROR_BUFFER_TOO_SMALL);
+        NL_TEST_ASSERT(inSuite, size == sizeof(shortBuffer));
+        NL_TEST_ASSERT(inSuite, memcmp(shortBuffer, &value, sizeof(shortBuffer)) == 0);
+
+        NL_TEST_ASSERT(inSuite, batch.Commit() == CHIP_NO_ERROR);
+    }
+
+    NL_TEST_ASSERT(inSuite, HasValue(backend, "new", 1));
+    NL_TEST_ASSERT(inSuite, !backend.SyncDoesKeyExist("old"));
+
+    storage.Shutdown();
+}
+
+void TestBatchCoalescesWrites(nlTestSuite * inSuite, void * inContext)
+{
+    CountingStorageDelegate backend;
+    WriteCoalescingStorageDelegate storage;
+    NL_TEST_ASSERT(inSuite, storage.Init(&backend) == CHIP_NO_ERROR);
+
+    PersistentStorageBatch batch(&storage);
+    for (uint32_t i = 0; i < 10; i++)
+    {
+        NL_TEST_ASSERT(inSuite, storage.SyncSetKeyValue("a", &i, sizeof(i)) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, storage.SyncSetKeyValue("b", &i, sizeof(i)) == CHIP_NO_ERROR);
+    }
+    // Written and deleted within the batch: never reaches the backing store as a value.
+    NL_TEST_ASSERT(inSuite, storage.SyncSetKeyValue("c", nullptr, 0) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, storage.SyncDeleteKeyValue("c") == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, storage.SyncDeleteKeyValue("c") == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+    NL_TEST_ASSERT(inSuite, storage.SyncDeleteKeyValue("missing") == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+
+    NL_TEST_ASSERT(inSuite, backend.mSets == 0);
+    NL_TEST_ASSERT(inSuite, batch.Commit() == CHIP_NO_ERROR);
+
+    NL_TEST_ASSERT(inSuite, HasValue(backend, "a", 9));
+    NL_TEST_ASSERT(inSuite, HasValue(backend, "b", 9));
+    NL_TEST_ASSERT(inSuite, !backend.SyncDoesKeyExist("c"));
+    NL_TEST_ASSERT(inSuite, backend.GetNumKeys() == 2);
+    NL_TEST_ASSERT(inSuite, backend.mSets == 2);
+
+    // The writes reached the backing store as one batch of its own.
+    NL_TEST_ASSERT(inSuite, backend.mBatchCommits == 1);
+    NL_TEST_ASSERT(inSuite, backend.mWritesInBatch == backend.mSets + backend.mDeletes);
+    NL_TEST_ASSERT(inSuite, backend.mBatchDepth == 0);
+
+    NL_TEST_ASSERT(inSuite, storage.GetCounters().requestedWrites == 24);
+    NL_TEST_ASSERT(inSuite, storage.GetCounters().backendWrites == 3);
+    NL_TEST_ASSERT(inSuite, storage.GetCounters().backendCommits == 1);
+
+    storage.Shutdown();
+}
+
+void TestBatchAbort(nlTestSuite * inSuite, void * inContext)
+{
+    CountingStorageDelegate backend;
+    WriteCoalescingStorageDelegate storage;
+    NL_TEST_ASSERT(inSuite, storage.Init(&backend) == CHIP_NO_ERROR);
+
+    uint32_t value = 1;
+    {
+        PersistentStorageBatch batch(&storage);
+        NL_TEST_ASSERT(inSuite, storage.SyncSetKeyValue("a", &value, sizeof(value)) == CHIP_NO_ERROR);
+        // Not committed: aborted when going out of scope.
+    }
+
+    NL_TEST_ASSERT(inSuite, !storage.SyncDoesKeyExist("a"));
+    NL_TEST_ASSERT(inSuite, backend.GetNumKeys() == 0);
+    NL_TEST_ASSERT(inSuite, storage.GetCounters().backendCommits == 0);
+
+    // Committing without a batch is an error, and the delegate is usable after the abort.
+    NL_TEST_ASSERT(inSuite, storage.CommitBatch() == CHIP_ERROR_INCORRECT_STATE);
+    NL_TEST_ASSERT(inSuite, storage.SyncSetKeyValue("a", &value, sizeof(value)) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, HasValue(backend, "a", 1));
+
+    storage.Shutdown();
+}
+
+void TestNestedBatches(nlTestSuite * inSuite, void * inContext)
+{
+    CountingStorageDelegate backend;
+    WriteCoalescingStorageDelegate storage;
+    NL_TEST_ASSERT(inSuite, storage.Init(&backend) == CHIP_NO_ERROR);
+
+    uint32_t value = 1;
+    {
+        PersistentStorageBatch outer(&storage);
+        NL_TEST_ASSERT(inSuite, storage.SyncSetKeyValue("a", &value, sizeof(value)) == CHIP_NO_ERROR);
+
+        {
+            PersistentStorageBatch inner(&storage);
+            NL_TEST_ASSERT(inSuite, storage.SyncSetKeyValue("b", &value, sizeof(value)) == CHIP_NO_ERROR);
+            NL_TEST_ASSERT(inSuite, inner.Commit() == CHIP_NO_ERROR);
+        }
+        // The inner commit applies nothing.
+        NL_TEST_ASSERT(inSuite, backend.GetNumKeys() == 0);
+
+        {
+            PersistentStorageBatch inner(&storage);
+            NL_TEST_ASSERT(inSuite, storage.SyncSetKeyValue("c", &value, sizeof(value)) == CHIP_NO_ERROR);
+            // The inner abort leaves the outer batch to decide.
+        }
+        NL_TEST_ASSERT(inSuite, storage.SyncDoesKeyExist("c"));
+
+        NL_TEST_ASSERT(inSuite, outer.Commit() == CHIP_NO_ERROR);
+    }
+
+    NL_TEST_ASSERT(inSuite, HasValue(backend, "a", 1));
+    NL_TEST_ASSERT(inSuite, HasValue(backend, "b", 1));
+    NL_TEST_ASSERT(inSuite, HasValue(backend, "c", 1));
+    NL_TEST_ASSERT(inSuite, storage.GetCounters().backendCommits == 1);
+
+    storage.Shutdown();
+}
+
+void TestBatchApplyFailure(nlTestSuite * inSuite, void * inContext)
+{
+    CountingStorageDelegate backend;
+    WriteCoalescingStorageDelegate storage;
+    NL_TEST_ASSERT(inSuite, storage.Init(&backend) == CHIP_NO_ERROR);
+
+    backend.AddPoisonKey("poison");
+
+    uint32_t value = 1;
+    PersistentStorageBatch batch(&storage);
+    NL_TEST_ASSERT(inSuite, storage.SyncSetKeyValue("poison", &value, sizeof(value)) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, batch.Commit() == CHIP_ERROR_PERSISTED_STORAGE_FAILED);
+    NL_TEST_ASSERT(inSuite, backend.mBatchAborts == 1);
+    NL_TEST_ASSERT(inSuite, backend.mBatchCommits == 0);
+    NL_TEST_ASSERT(inSuite, storage.GetCounters().backendCommits == 0);
+
+    // The failed batch is not retried.
+    backend.ClearPoisonKeys();
+    NL_TEST_ASSERT(inSuite, !storage.SyncDoesKeyExist("poison"));
+
+    storage.Shutdown();
+}
+
+void TestCoalescingWindow(nlTestSuite * inSuite, void * inContext)
+{
+    CountingStorageDelegate backend;
+    ManualTimerLayer systemLayer;
+    WriteCoalescingStorageDelegate storage;
+    NL_TEST_ASSERT(inSuite, storage.Init(&backend) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite,
+                   storage.SetCoalescingWindow(&systemLayer, System::Clock::Milliseconds32(500), IsNonCriticalKey) == CHIP_NO_ERROR);
+
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        NL_TEST_ASSERT(inSuite, storage.SyncSetKeyValue("nc/a", &i, sizeof(i)) == CHIP_NO_ERROR);
+    }
+    NL_TEST_ASSERT(inSuite, systemLayer.IsTimerPending());
+    NL_TEST_ASSERT(inSuite, systemLayer.GetDelay() == System::Clock::Milliseconds32(500));
+    NL_TEST_ASSERT(inSuite, HasValue(storage, "nc/a", 4));
+    NL_TEST_ASSERT(inSuite, backend.GetNumKeys() == 0);
+
+    // Critical keys are written through immediately.
+    uint32_t value = 1;
+    NL_TEST_ASSERT(inSuite, storage.SyncSetKeyValue("a", &value, sizeof(value)) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, HasValue(backend, "a", 1));
+
+    systemLayer.FireTimer();
+    NL_TEST_ASSERT(inSuite, HasValue(backend, "nc/a", 4));
+    NL_TEST_ASSERT(inSuite, backend.mSets == 2);
+    NL_TEST_ASSERT(inSuite, backend.mBatchCommits == 1);
+    NL_TEST_ASSERT(inSuite, backend.mWritesInBatch == 1);
+
+    // A held delete of a key that is missing fails right away.
+    NL_TEST_ASSERT(inSuite, storage.SyncDeleteKeyValue("nc/missing") == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+    NL_TEST_ASSERT(inSuite, storage.SyncDeleteKeyValue("nc/a") == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, !storage.SyncDoesKeyExist("nc/a"));
+    NL_TEST_ASSERT(inSuite, backend.SyncDoesKeyExist("nc/a"));
+
+    // A batch writing a held key supersedes the held value.
+    value = 2;
+    {
+        PersistentStorageBatch batch(&storage);
+        NL_TEST_ASSERT(inSuite, storage.SyncSetKeyValue("nc/a", &value, sizeof(value)) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, batch.Commit() == CHIP_NO_ERROR);
+    }
+    NL_TEST_ASSERT(inSuite, HasValue(backend, "nc/a", 2));
+    NL_TEST_ASSERT(inSuite, storage.Flush() == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, HasValue(backend, "nc/a", 2));
+    NL_TEST_ASSERT(inSuite, !systemLayer.IsTimerPending());
+
+    // Shutdown applies the held writes.
+    value = 3;
+    NL_TEST_ASSERT(inSuite, storage.SyncSetKeyValue("nc/b", &value, sizeof(value)) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, !backend.SyncDoesKeyExist("nc/b"));
+    storage.Shutdown();
+    NL_TEST_ASSERT(inSuite, HasValue(backend, "nc/b", 3));
+    NL_TEST_ASSERT(inSuite, !systemLayer.IsTimerPending());
+}
+
+int Setup(void * inContext)
+{
+    CHIP_ERROR error = chip::Platform::MemoryInit();
+    if (error != CHIP_NO_ERROR)
+        return FAILURE;
+    return SUCCESS;
+}
+
+int Teardown(void * inContext)
+{
+    chip::Platform::MemoryShutdown();
+    return SUCCESS;
+}
+
+} // namespace
+
+/**
+ *   Test Suite. It lists all the test functions.
+ */
+
+// clang-format off
+static const nlTest sTests[] =
+{
+    NL_TEST_DEF("WriteThroughOutsideBatch", TestWriteThroughOutsideBatch),
+    NL_TEST_DEF("BatchReadYourWrites", TestBatchReadYourWrites),
+    NL_TEST_DEF("BatchCoalescesWrites", TestBatchCoalescesWrites),
+    NL_TEST_DEF("BatchAbort", TestBatchAbort),
+    NL_TEST_DEF("NestedBatches", TestNestedBatches),
+    NL_TEST_DEF("BatchApplyFailure", TestBatchApplyFailure),
+    NL_TEST_DEF("CoalescingWindow", TestCoalescingWindow),
+
+    NL_TEST_SENTINEL()
+};
+// clang-format on
+
+int TestWriteCoalescingStorageDelegate()
+{
+    // clang-format off
+    nlTestSuite theSuite =
+    {
+        "WriteCoalescingStorageDelegate",
+        &sTests[0],
+        Setup,
+        Teardown
+    };
+    // clang-format on
+
+    nlTestRunner(&theSuite, nullptr);
+
+    return (nlTestRunnerStats(&theSuite));
+}
+
+CHIP_REGISTER_TEST_SUITE(TestWriteCoalescingStorageDelegate)
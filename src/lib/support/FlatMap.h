@@ -0,0 +1,164 @@
+/*
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace chip {
+
+/**
+ * An ordered set kept in a sorted contiguous vector.
+ *
+ * This offers the subset of the std::set interface needed to be used in its place. Compared to std::set, lookups are
+ * binary searches over contiguous memory and elements need no allocation of their own, at the cost of insertions and
+ * removals moving the elements after them. This makes it a good fit for sets that are mostly looked up, or filled in
+ * about increasing order.
+ *
+ * As with std::vector, inserting or erasing invalidates iterators and references to the elements.
+ */
+template <typename T, typename Compare = std::less<T>>
+class FlatSet
+{
+public:
+    using value_type     = T;
+    using iterator       = typename std::vector<T>::iterator;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    iterator begin() { return mItems.begin(); }
+    iterator end() { return mItems.end(); }
+    const_iterator begin() const { return mItems.begin(); }
+    const_iterator end() const { return mItems.end(); }
+
+    size_t size() const { return mItems.size(); }
+    bool empty() const { return mItems.empty(); }
+    void clear() { mItems.clear(); }
+    void reserve(size_t count) { mItems.reserve(count); }
+    void shrink_to_fit() { mItems.shrink_to_fit(); }
+
+    iterator find(const T & value)
+    {
+        auto iter = LowerBound(value);
+        return (iter != mItems.end() && !mCompare(value, *iter)) ? iter : mItems.end();
+    }
+
+    const_iterator find(const T & value) const { return const_cast<FlatSet *>(this)->find(value); }
+
+    /**
+     * Inserts value unless an equivalent one is present, like std::set::insert.
+     */
+    std::pair<iterator, bool> insert(T && value)
+    {
+        auto iter = LowerBound(value);
+        if (iter != mItems.end() && !mCompare(value, *iter))
+        {
+            return std::make_pair(iter, false);
+        }
+        return std::make_pair(mItems.insert(iter, std::move(value)), true);
+    }
+
+    std::pair<iterator, bool> insert(const T & value) { return insert(T(value)); }
+
+    iterator erase(const_iterator position) { return mItems.erase(position); }
+
+private:
+    iterator LowerBound(const T & value)
+    {
+        // Values mostly come in increasing order, so check for an append first.
+        if (mItems.empty() || mCompare(mItems.back(), value))
+        {
+            return mItems.end();
+        }
+        return std::lower_bound(mItems.begin(), mItems.end(), value, mCompare);
+    }
+
+    std::vector<T> mItems;
+    Compare mCompare;
+};
+
+/**
+ * An ordered map kept in a sorted contiguous vector of key-value pairs.
+ *
+ * This offers the subset of the std::map interface needed to be used in its place, with the trade-offs described for
+ * FlatSet. Iteration yields std::pair<Key, Value> in increasing key order.
+ *
+ * As with std::vector, inserting or erasing invalidates iterators and references to the elements.
+ */
+template <typename Key, typename Value>
+class FlatMap
+{
+    struct KeyCompare
+    {
+        bool operator()(const std::pair<Key, Value> & x, const Key & y) const { return x.first < y; }
+    };
+
+public:
+    using value_type     = std::pair<Key, Value>;
+    using iterator       = typename std::vector<value_type>::iterator;
+    using const_iterator = typename std::vector<value_type>::const_iterator;
+
+    iterator begin() { return mItems.begin(); }
+    iterator end() { return mItems.end(); }
+    const_iterator begin() const { return mItems.begin(); }
+    const_iterator end() const { return mItems.end(); }
+
+    size_t size() const { return mItems.size(); }
+    bool empty() const { return mItems.empty(); }
+    void clear() { mItems.clear(); }
+    void reserve(size_t count) { mItems.reserve(count); }
+    void shrink_to_fit() { mItems.shrink_to_fit(); }
+
+    iterator find(const Key & key)
+    {
+        auto iter = LowerBound(key);
+        return (iter != mItems.end() && !(key < iter->first)) ? iter : mItems.end();
+    }
+
+    const_iterator find(const Key & key) const { return const_cast<FlatMap *>(this)->find(key); }
+
+    /**
+     * Returns the value for key, inserting a default-constructed one if there is none, like std::map::operator[].
+     */
+    Value & operator[](const Key & key)
+    {
+        auto iter = LowerBound(key);
+        if (iter == mItems.end() || key < iter->first)
+        {
+            iter = mItems.emplace(iter, key, Value());
+        }
+        return iter->second;
+    }
+
+    iterator erase(const_iterator position) { return mItems.erase(position); }
+
+private:
+    iterator LowerBound(const Key & key)
+    {
+        // Keys mostly come in increasing order, so check for an append first.
+        if (mItems.empty() || mItems.back().first < key)
+        {
+            return mItems.end();
+        }
+        return std::lower_bound(mItems.begin(), mItems.end(), key, KeyCompare());
+    }
+
+    std::vector<value_type> mItems;
+};
+
+} // namespace chip
@@ -0,0 +1,51 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      Hashing of small identifier pairs (endpoint and cluster, node and fabric) into the buckets of a fixed-size table.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace chip {
+
+/**
+ * Mix two 32-bit identifiers into a hash whose low bits depend on all the bits of both, so that it can be masked
+ * down to a power-of-two number of buckets.
+ */
+inline uint32_t HashIdPair(uint32_t first, uint32_t second)
+{
+    uint32_t hash = (first * 0x9E3779B1u) ^ (second * 0x85EBCA6Bu);
+    hash ^= hash >> 15;
+    return hash;
+}
+
+/**
+ * Bucket of an identifier pair in a table of kBucketCount buckets.
+ */
+template <size_t kBucketCount>
+inline size_t BucketOfIdPair(uint32_t first, uint32_t second)
+{
+    static_assert(kBucketCount > 0 && (kBucketCount & (kBucketCount - 1)) == 0, "kBucketCount must be a power of two");
+    return HashIdPair(first, second) & (kBucketCount - 1);
+}
+
+} // namespace chip
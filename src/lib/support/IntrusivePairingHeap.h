@@ -0,0 +1,209 @@
+/*
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+namespace chip {
+
+template <typename T, typename Compare>
+class IntrusivePairingHeap;
+
+/**
+ * Links of an element held in an IntrusivePairingHeap. Elements derive publicly from this class.
+ */
+class IntrusivePairingHeapNode
+{
+protected:
+    IntrusivePairingHeapNode() = default;
+
+private:
+    template <typename T, typename Compare>
+    friend class IntrusivePairingHeap;
+
+    IntrusivePairingHeapNode * mHeapChild = nullptr; // First child.
+    IntrusivePairingHeapNode * mHeapNext  = nullptr; // Next sibling.
+    IntrusivePairingHeapNode * mHeapPrev  = nullptr; // Previous sibling, or parent for a first child.
+};
+
+/**
+ * Min-heap of elements of type T linked through their IntrusivePairingHeapNode base, for ordering
+ * deadlines (timers, retransmissions) without allocation.
+ *
+ * Compare is a function object such that compare(a, b) is true if a must come out of the heap before b.
+ * Push() and Top() are O(1), Pop() and Remove() are O(log n) amortized. An element is in at most one
+ * heap at a time.
+ */
+template <typename T, typename Compare>
+class IntrusivePairingHeap
+{
+public:
+    explicit IntrusivePairingHeap(Compare compare = Compare()) : mCompare(compare) {}
+
+    /**
+     * Get the first element of the heap, or nullptr if the heap is empty.
+     */
+    T * Top() const { return static_cast<T *>(mRoot); }
+
+    bool Empty() const { return mRoot == nullptr; }
+
+    /**
+     * Test whether the element is in this heap, given that it is in no other heap.
+     */
+    bool Contains(const T * element) const
+    {
+        const Node * node = element;
+        return node == mRoot || node->mHeapPrev != nullptr;
+    }
+
+    /**
+     * Add an element, which must not be in a heap.
+     */
+    void Push(T * element)
+    {
+        Node * node = element;
+
+        node->mHeapChild = node->mHeapNext = node->mHeapPrev = nullptr;
+        mRoot                                                = Meld(mRoot, node);
+    }
+
+    /**
+     * Remove and return the first element of the heap, or nullptr if the heap is empty.
+     */
+    T * Pop()
+    {
+        T * top = Top();
+        if (top != nullptr)
+        {
+            Remove(top);
+        }
+        return top;
+    }
+
+    /**
+     * Remove an element, which must be in this heap.
+     */
+    void Remove(T * element);
+
+    /**
+     * Forget all the elements. Their links are reset when they are pushed again.
+     */
+    void Clear() { mRoot = nullptr; }
+
+private:
+    using Node = IntrusivePairingHeapNode;
+
+    bool IsBefore(const Node * a, const Node * b) const { return mCompare(static_cast<const T *>(a), static_cast<const T *>(b)); }
+    Node * Meld(Node * a, Node * b) const;
+    Node * MergePairs(Node * first) const;
+
+    Node * mRoot = nullptr;
+    Compare mCompare;
+};
+
+template <typename T, typename Compare>
+void IntrusivePairingHeap<T, Compare>::Remove(T * element)
+{
+    Node * node      = element;
+    Node * subtree   = MergePairs(node->mHeapChild);
+    node->mHeapChild = nullptr;
+
+    if (node == mRoot)
+    {
+        mRoot = subtree;
+    }
+    else
+    {
+        if (node->mHeapPrev->mHeapChild == node)
+        {
+            node->mHeapPrev->mHeapChild = node->mHeapNext;
+        }
+        else
+        {
+            node->mHeapPrev->mHeapNext = node->mHeapNext;
+        }
+        if (node->mHeapNext != nullptr)
+        {
+            node->mHeapNext->mHeapPrev = node->mHeapPrev;
+        }
+        mRoot = Meld(mRoot, subtree);
+    }
+
+    node->mHeapNext = node->mHeapPrev = nullptr;
+}
+
+template <typename T, typename Compare>
+IntrusivePairingHeapNode * IntrusivePairingHeap<T, Compare>::Meld(Node * a, Node * b) const
+{
+    // Both arguments are heap roots (no siblings, no parent).
+    if (a == nullptr)
+    {
+        return b;
+    }
+    if (b == nullptr)
+    {
+        return a;
+    }
+    if (IsBefore(b, a))
+    {
+        Node * tmp = a;
+        a          = b;
+        b          = tmp;
+    }
+
+    // Make b the first child of a.
+    b->mHeapPrev = a;
+    b->mHeapNext = a->mHeapChild;
+    if (a->mHeapChild != nullptr)
+    {
+        a->mHeapChild->mHeapPrev = b;
+    }
+    a->mHeapChild = b;
+    return a;
+}
+
+template <typename T, typename Compare>
+IntrusivePairingHeapNode * IntrusivePairingHeap<T, Compare>::MergePairs(Node * first) const
+{
+    // Standard two-pass pairing: meld siblings pairwise from left to right, then meld the results from right to left.
+    Node * pairs = nullptr; // Linked through mHeapNext, in reverse order.
+    while (first != nullptr)
+    {
+        Node * a = first;
+        Node * b = a->mHeapNext;
+        first    = (b != nullptr) ? b->mHeapNext : nullptr;
+
+        a->mHeapNext = a->mHeapPrev = nullptr;
+        if (b != nullptr)
+        {
+            b->mHeapNext = b->mHeapPrev = nullptr;
+            a                           = Meld(a, b);
+        }
+        a->mHeapNext = pairs;
+        pairs        = a;
+    }
+
+    Node * root = nullptr;
+    while (pairs != nullptr)
+    {
+        Node * next      = pairs->mHeapNext;
+        pairs->mHeapNext = nullptr;
+        root             = Meld(root, pairs);
+        pairs            = next;
+    }
+    return root;
+}
+
+} // namespace chip
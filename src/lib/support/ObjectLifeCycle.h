@@ -80,6 +80,9 @@ public:
     bool ResetFromShuttingDown() { return Transition(State::ShuttingDown, State::Uninitialized); }
     bool ResetFromInitialized() { return Transition(State::Initialized, State::Uninitialized); }
 
+    // Back out of an initialization that failed part way.
+    bool ResetFromInitializing() { return Transition(State::Initializing, State::Uninitialized); }
+
     /**
      * Transition from Uninitialized or Shutdown to Destroyed.
      *
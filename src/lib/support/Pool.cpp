@@ -129,6 +129,7 @@ Loop StaticAllocatorBitmap::ForEachActiveObjectInner(void * context, Lambda lamb
 
 #if CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
 
+#if CHIP_CONFIG_MEMORY_DEBUG_CHECKS
 HeapObjectListNode * HeapObjectList::FindNode(void * object) const
 {
     for (HeapObjectListNode * p = mNext; p != this; p = p->mNext)
@@ -140,6 +141,7 @@ HeapObjectListNode * HeapObjectList::FindNode(void * object) const
     }
     return nullptr;
 }
+#endif // CHIP_CONFIG_MEMORY_DEBUG_CHECKS
 
 Loop HeapObjectList::ForEachNode(void * context, Lambda lambda)
 {
@@ -169,7 +171,7 @@ Loop HeapObjectList::ForEachNode(void * context, Lambda lambda)
             if (p->mObject == nullptr)
             {
                 p->Remove();
-                Platform::Delete(p);
+                Platform::MemoryFree(p);
             }
             p = next;
         }
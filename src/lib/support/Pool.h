@@ -29,6 +29,7 @@
 #include <lib/support/Iterators.h>
 
 #include <atomic>
+#include <cstddef>
 #include <limits>
 #include <new>
 #include <stddef.h>
@@ -136,6 +137,12 @@ private:
 
 #if CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
 
+/**
+ * List node for an object allocated by HeapObjectPool.
+ *
+ * The node is the header of the heap block holding the object, so nodes are freed with Platform::MemoryFree(). A node
+ * whose mObject is nullptr belongs to an object released during iteration and is freed once iteration completes.
+ */
 struct HeapObjectListNode
 {
     void Remove()
@@ -161,7 +168,9 @@ struct HeapObjectList : HeapObjectListNode
         mPrev        = node;
     }
 
+#if CHIP_CONFIG_MEMORY_DEBUG_CHECKS
     HeapObjectListNode * FindNode(void * object) const;
+#endif // CHIP_CONFIG_MEMORY_DEBUG_CHECKS
 
     using Lambda = Loop (*)(void *, void *);
     Loop ForEachNode(void * context, Lambda lambda);
@@ -346,19 +355,18 @@ public:
     template <typename... Args>
     T * CreateObject(Args &&... args)
     {
-        T * object = Platform::New<T>(std::forward<Args>(args)...);
-        if (object != nullptr)
+        void * block = Platform::MemoryAlloc(kObjectOffset + sizeof(T));
+        if (block == nullptr)
         {
-            auto node = Platform::New<internal::HeapObjectListNode>();
-            if (node != nullptr)
-            {
-                node->mObject = object;
-                mObjects.Append(node);
-                IncreaseUsage();
-                return object;
-            }
+            return nullptr;
         }
-        return nullptr;
+
+        auto node     = new (block) internal::HeapObjectListNode();
+        T * object    = new (static_cast<uint8_t *>(block) + kObjectOffset) T(std::forward<Args>(args)...);
+        node->mObject = object;
+        mObjects.Append(node);
+        IncreaseUsage();
+        return object;
     }
 
     /*
@@ -377,20 +385,29 @@ public:
     {
         if (object != nullptr)
         {
-            internal::HeapObjectListNode * node = mObjects.FindNode(object);
+            internal::HeapObjectListNode * node = NodeOf(object);
+#if CHIP_CONFIG_MEMORY_DEBUG_CHECKS
             // Releasing an object that is not allocated indicates likely memory
             // corruption; better to safe-crash than proceed at this point.
-            VerifyOrDie(node != nullptr);
+            // The list is searched first, since for such an object the node
+            // in front of it is not ours to read.
+            VerifyOrDie(mObjects.FindNode(object) == node);
+#endif // CHIP_CONFIG_MEMORY_DEBUG_CHECKS
+            // Catches a second release of an object whose node was kept
+            // alive by an ongoing iteration; other invalid releases are only
+            // caught with CHIP_CONFIG_MEMORY_DEBUG_CHECKS.
+            VerifyOrDie(node->mObject == object);
 
             node->mObject = nullptr;
-            Platform::Delete(object);
+            object->~T();
 
             // The node needs to be released immediately if we are not in the middle of iteration.
             // Otherwise cleanup is deferred until all iteration on this pool completes and it's safe to release nodes.
+            // The object's storage is part of the node's block, so it is released at the same time.
             if (mObjects.mIterationDepth == 0)
             {
                 node->Remove();
-                Platform::Delete(node);
+                Platform::MemoryFree(node);
             }
             else
             {
@@ -435,6 +452,16 @@ public:
     }
 
 private:
+    // Each object is allocated in one block with its list node, which comes first, so that ReleaseObject() can find the
+    // node in constant time instead of searching the list.
+    static constexpr size_t kObjectOffset = (sizeof(internal::HeapObjectListNode) + alignof(T) - 1) / alignof(T) * alignof(T);
+    static_assert(alignof(T) <= alignof(std::max_align_t), "HeapObjectPool does not support over-aligned types");
+
+    static internal::HeapObjectListNode * NodeOf(T * object)
+    {
+        return reinterpret_cast<internal::HeapObjectListNode *>(reinterpret_cast<uint8_t *>(object) - kObjectOffset);
+    }
+
     static Loop ReleaseObject(void * context, void * object)
     {
         static_cast<HeapObjectPool *>(context)->ReleaseObject(static_cast<T *>(object));
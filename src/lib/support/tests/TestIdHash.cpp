@@ -0,0 +1,74 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <lib/support/IdHash.h>
+#include <lib/support/UnitTestRegistration.h>
+
+#include <nlunit-test.h>
+
+using namespace chip;
+
+namespace {
+
+void TestBucketMatchesHash(nlTestSuite * inSuite, void * inContext)
+{
+    for (uint32_t first = 0; first < 64; first++)
+    {
+        for (uint32_t second = 0; second < 64; second++)
+        {
+            NL_TEST_ASSERT(inSuite, BucketOfIdPair<32>(first, second) == (HashIdPair(first, second) & 31u));
+        }
+    }
+}
+
+void TestSpread(nlTestSuite * inSuite, void * inContext)
+{
+    // Typical ids: a few endpoints, each with a run of standard clusters. Every bucket of a small table gets some
+    // of them, and none gets much more than its share.
+    constexpr size_t kBuckets = 16;
+    size_t load[kBuckets]     = {};
+    size_t total              = 0;
+    for (uint32_t endpoint = 0; endpoint < 8; endpoint++)
+    {
+        for (uint32_t cluster = 0x0003; cluster < 0x0043; cluster++)
+        {
+            load[BucketOfIdPair<kBuckets>(cluster, endpoint)]++;
+            total++;
+        }
+    }
+
+    for (size_t bucket = 0; bucket < kBuckets; bucket++)
+    {
+        NL_TEST_ASSERT(inSuite, load[bucket] > 0);
+        NL_TEST_ASSERT(inSuite, load[bucket] <= 2 * total / kBuckets);
+    }
+}
+
+const nlTest sTests[] = { NL_TEST_DEF("Test bucket matches hash", TestBucketMatchesHash),
+                          NL_TEST_DEF("Test spread", TestSpread), NL_TEST_SENTINEL() };
+
+} // namespace
+
+int TestIdHash()
+{
+    nlTestSuite theSuite = { "IdHash tests", &sTests[0], nullptr, nullptr };
+
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestIdHash)
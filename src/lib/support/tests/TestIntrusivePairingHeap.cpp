@@ -0,0 +1,302 @@
+/*
+ *    Copyright (c) 2023 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      Unit tests and benchmark for IntrusivePairingHeap.
+ *
+ *      The benchmark keeps hundreds to thousands of outstanding exchanges waiting for an
+ *      ack, as the MRP retransmission queue does, and times handling an ack and selecting
+ *      the next retransmission with the heap and with the linear scan of the retransmission
+ *      table that it replaced. The exchange pools of the platform configurations are too
+ *      small to reach these counts through ReliableMessageMgr itself.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+#include <lib/support/IntrusivePairingHeap.h>
+#include <lib/support/UnitTestRegistration.h>
+
+#include <nlunit-test.h>
+
+namespace {
+
+using namespace chip;
+
+// Shaped like an MRP retransmission table entry: a retransmission time, and the scheduling order for ties.
+struct Entry : public IntrusivePairingHeapNode
+{
+    uint64_t mTime     = 0;
+    uint32_t mSequence = 0;
+    bool mScheduled    = false;
+};
+
+struct IsEarlier
+{
+    bool operator()(const Entry * a, const Entry * b) const
+    {
+        if (a->mTime != b->mTime)
+        {
+            return a->mTime < b->mTime;
+        }
+        return static_cast<int32_t>(a->mSequence - b->mSequence) < 0;
+    }
+};
+
+using Heap = IntrusivePairingHeap<Entry, IsEarlier>;
+
+// Deterministic generator, so that the heap and the scan see the same operations.
+class Random
+{
+public:
+    explicit Random(uint32_t seed) : mState(seed) {}
+    uint32_t Next(uint32_t bound)
+    {
+        mState = mState * 1664525u + 1013904223u;
+        return (mState >> 8) % bound;
+    }
+
+private:
+    uint32_t mState;
+};
+
+void TestOrder(nlTestSuite * inSuite, void * inContext)
+{
+    Heap heap;
+    Entry entries[200];
+    uint32_t sequence = 0;
+
+    NL_TEST_ASSERT(inSuite, heap.Empty());
+    NL_TEST_ASSERT(inSuite, heap.Top() == nullptr);
+    NL_TEST_ASSERT(inSuite, heap.Pop() == nullptr);
+
+    for (auto & entry : entries)
+    {
+        entry.mTime     = static_cast<uint64_t>(std::rand() % 50); // Plenty of ties.
+        entry.mSequence = sequence++;
+        heap.Push(&entry);
+        NL_TEST_ASSERT(inSuite, heap.Contains(&entry));
+    }
+
+    const Entry * previous = nullptr;
+    size_t count           = 0;
+    while (Entry * entry = heap.Pop())
+    {
+        NL_TEST_ASSERT(inSuite, !heap.Contains(entry));
+        NL_TEST_ASSERT(inSuite, previous == nullptr || IsEarlier()(previous, entry));
+        previous = entry;
+        count++;
+    }
+    NL_TEST_ASSERT(inSuite, count == sizeof(entries) / sizeof(entries[0]));
+    NL_TEST_ASSERT(inSuite, heap.Empty());
+}
+
+void TestRemove(nlTestSuite * inSuite, void * inContext)
+{
+    Heap heap;
+    Entry entries[200];
+    uint32_t sequence = 0;
+
+    for (auto & entry : entries)
+    {
+        entry.mTime     = static_cast<uint64_t>(std::rand() % 1000);
+        entry.mSequence = sequence++;
+        heap.Push(&entry);
+    }
+
+    // Remove every third entry, wherever it sits in the heap, then re-add some with new times.
+    for (size_t i = 0; i < 200; i += 3)
+    {
+        heap.Remove(&entries[i]);
+        NL_TEST_ASSERT(inSuite, !heap.Contains(&entries[i]));
+    }
+    for (size_t i = 0; i < 200; i += 6)
+    {
+        entries[i].mTime     = static_cast<uint64_t>(std::rand() % 1000);
+        entries[i].mSequence = sequence++;
+        heap.Push(&entries[i]);
+    }
+
+    const Entry * previous = nullptr;
+    size_t count           = 0;
+    while (Entry * entry = heap.Pop())
+    {
+        NL_TEST_ASSERT(inSuite, previous == nullptr || IsEarlier()(previous, entry));
+        previous = entry;
+        count++;
+    }
+    NL_TEST_ASSERT(inSuite, count == 200 - 67 + 34);
+
+    // Cleared entries are forgotten, and can be added again.
+    heap.Push(&entries[0]);
+    heap.Clear();
+    NL_TEST_ASSERT(inSuite, heap.Empty());
+    heap.Push(&entries[0]);
+    NL_TEST_ASSERT(inSuite, heap.Top() == &entries[0]);
+}
+
+constexpr size_t kBenchExchangeCounts[] = { 256, 1024, 4096 };
+constexpr uint32_t kBenchOperations     = 20000;
+constexpr uint32_t kBenchBackoffMs      = 300;
+
+// Runs the benchmark operations on `count` outstanding exchanges, and returns the time taken and a checksum of the
+// entries selected for retransmission. Even operations handle the ack of a random exchange, which then sends a new
+// message; odd operations select the next retransmission and reschedule it.
+template <typename Queue>
+double RunBench(size_t count, uint64_t & checksum)
+{
+    std::vector<Entry> entries(count);
+    Queue queue(entries);
+    Random random(1);
+    uint32_t sequence = 0;
+
+    for (auto & entry : entries)
+    {
+        entry.mTime     = random.Next(2000);
+        entry.mSequence = sequence++;
+        queue.Schedule(&entry);
+    }
+
+    checksum   = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < kBenchOperations; i++)
+    {
+        if (i % 2 == 0)
+        {
+            Entry * acked = &entries[random.Next(static_cast<uint32_t>(count))];
+            queue.Ack(acked);
+            acked->mTime += random.Next(kBenchBackoffMs);
+            acked->mSequence = sequence++;
+            queue.Schedule(acked);
+        }
+        else
+        {
+            Entry * earliest = queue.PopEarliest();
+            checksum         = checksum * 31 + static_cast<uint64_t>(earliest - entries.data());
+            earliest->mTime += kBenchBackoffMs + random.Next(kBenchBackoffMs);
+            earliest->mSequence = sequence++;
+            queue.Schedule(earliest);
+        }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::micro>(elapsed).count() / kBenchOperations;
+}
+
+class HeapQueue
+{
+public:
+    explicit HeapQueue(std::vector<Entry> &) {}
+    void Schedule(Entry * entry) { mHeap.Push(entry); }
+    void Ack(Entry * entry) { mHeap.Remove(entry); }
+    Entry * PopEarliest() { return mHeap.Pop(); }
+
+private:
+    Heap mHeap;
+};
+
+// The retransmission table before the heap: every lookup scans all the entries.
+class ScanQueue
+{
+public:
+    explicit ScanQueue(std::vector<Entry> & entries) : mEntries(entries) {}
+    void Schedule(Entry * entry) { entry->mScheduled = true; }
+
+    void Ack(Entry * entry)
+    {
+        for (auto & candidate : mEntries)
+        {
+            if (&candidate == entry)
+            {
+                candidate.mScheduled = false;
+            }
+        }
+    }
+
+    Entry * PopEarliest()
+    {
+        Entry * earliest = nullptr;
+        for (auto & candidate : mEntries)
+        {
+            if (candidate.mScheduled && (earliest == nullptr || IsEarlier()(&candidate, earliest)))
+            {
+                earliest = &candidate;
+            }
+        }
+        earliest->mScheduled = false;
+        return earliest;
+    }
+
+private:
+    std::vector<Entry> & mEntries;
+};
+
+void TestBenchmark(nlTestSuite * inSuite, void * inContext)
+{
+    printf("\n  %u acks and retransmission selections\n", kBenchOperations);
+    for (size_t count : kBenchExchangeCounts)
+    {
+        uint64_t heapChecksum, scanChecksum;
+        double heapUs = RunBench<HeapQueue>(count, heapChecksum);
+        double scanUs = RunBench<ScanQueue>(count, scanChecksum);
+
+        // Both select the same retransmissions in the same order.
+        NL_TEST_ASSERT(inSuite, heapChecksum == scanChecksum);
+        printf("  %5zu outstanding exchanges: heap %7.3f us/op, table scan %7.3f us/op\n", count, heapUs, scanUs);
+    }
+}
+
+int Setup(void * inContext)
+{
+    return SUCCESS;
+}
+
+int Teardown(void * inContext)
+{
+    return SUCCESS;
+}
+
+} // namespace
+
+#define NL_TEST_DEF_FN(fn) NL_TEST_DEF("Test " #fn, fn)
+/**
+ *   Test Suite. It lists all the test functions.
+ */
+static const nlTest sTests[] = {
+    NL_TEST_DEF_FN(TestOrder),     //
+    NL_TEST_DEF_FN(TestRemove),    //
+    NL_TEST_DEF_FN(TestBenchmark), //
+    NL_TEST_SENTINEL(),            //
+};
+
+int TestIntrusivePairingHeap()
+{
+    nlTestSuite theSuite = { "CHIP IntrusivePairingHeap tests", &sTests[0], Setup, Teardown };
+
+    unsigned seed = static_cast<unsigned>(std::time(nullptr));
+    printf("Running " __FILE__ " using seed %d", seed);
+    std::srand(seed);
+
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestIntrusivePairingHeap);
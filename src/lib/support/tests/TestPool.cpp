@@ -23,11 +23,14 @@
  *
  */
 
+#include <inttypes.h>
 #include <set>
+#include <stdio.h>
 
 #include <lib/support/Pool.h>
 #include <lib/support/PoolWrapper.h>
 #include <lib/support/UnitTestRegistration.h>
+#include <system/SystemClock.h>
 #include <system/SystemConfig.h>
 
 #include <nlunit-test.h>
@@ -410,6 +413,59 @@ void TestPoolInterfaceDynamic(nlTestSuite * inSuite, void * inContext)
 {
     TestPoolInterface<ObjectPoolMem::kHeap>(inSuite, inContext);
 }
+
+// Create/release churn with a steady number of live objects, as seen by exchange and session pools on a busy node.
+// The cost per operation should not depend on the number of live objects.
+void TestCreateReleaseChurnDynamic(nlTestSuite * inSuite, void * inContext)
+{
+    struct alignas(16) TestObject
+    {
+        TestObject(size_t id) : mId(id) {}
+        size_t mId;
+    };
+
+    constexpr size_t kLiveCounts[]    = { 100, 1000, 10000 };
+    constexpr size_t kChurnOperations = 100000;
+
+    for (size_t liveCount : kLiveCounts)
+    {
+        HeapObjectPool<TestObject> pool;
+        auto ** objects = static_cast<TestObject **>(Platform::MemoryCalloc(liveCount, sizeof(TestObject *)));
+        NL_TEST_ASSERT(inSuite, objects != nullptr);
+        VerifyOrReturn(objects != nullptr);
+
+        for (size_t i = 0; i < liveCount; ++i)
+        {
+            objects[i] = pool.CreateObject(i);
+            NL_TEST_ASSERT(inSuite, objects[i] != nullptr);
+            NL_TEST_ASSERT(inSuite, reinterpret_cast<uintptr_t>(objects[i]) % alignof(TestObject) == 0);
+        }
+
+        uint32_t seed                       = 1;
+        bool ok                             = true;
+        System::Clock::Microseconds64 start = System::SystemClock().GetMonotonicMicroseconds64();
+        for (size_t n = 0; n < kChurnOperations; ++n)
+        {
+            seed     = seed * 1664525u + 1013904223u;
+            size_t i = (seed >> 8) % liveCount;
+            ok       = ok && objects[i]->mId == i;
+            pool.ReleaseObject(objects[i]);
+            objects[i] = pool.CreateObject(i);
+            ok         = ok && objects[i] != nullptr;
+        }
+        System::Clock::Microseconds64 elapsed = System::SystemClock().GetMonotonicMicroseconds64() - start;
+
+        NL_TEST_ASSERT(inSuite, ok);
+        NL_TEST_ASSERT(inSuite, pool.Allocated() == liveCount);
+        NL_TEST_ASSERT(inSuite, GetNumObjectsInUse(pool) == liveCount);
+        printf("  %zu live objects: %" PRIu64 " ns per create/release pair\n", liveCount,
+               static_cast<uint64_t>(elapsed.count()) * 1000 / kChurnOperations);
+
+        pool.ReleaseAll();
+        NL_TEST_ASSERT(inSuite, pool.Allocated() == 0);
+        Platform::MemoryFree(objects);
+    }
+}
 #endif // CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
 
 int Setup(void * inContext)
@@ -442,6 +498,7 @@ static const nlTest sTests[] = {
     NL_TEST_DEF_FN(TestCreateReleaseStructDynamic),
     NL_TEST_DEF_FN(TestForEachActiveObjectDynamic),
     NL_TEST_DEF_FN(TestPoolInterfaceDynamic),
+    NL_TEST_DEF_FN(TestCreateReleaseChurnDynamic),
 #endif // CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
     NL_TEST_SENTINEL()
     // clang-format on
@@ -47,15 +47,17 @@ using namespace chip::System::Clock::Literals;
 namespace chip {
 namespace Messaging {
 
-ReliableMessageMgr::RetransTableEntry::RetransTableEntry(ReliableMessageContext * rc) :
+RetransTableEntry::RetransTableEntry(ReliableMessageContext * rc) :
     ec(*rc->GetExchangeContext()), nextRetransTime(0), sendCount(0)
 {
     ec->SetWaitingForAck(true);
+    ec->mRetransEntry = this;
 }
 
-ReliableMessageMgr::RetransTableEntry::~RetransTableEntry()
+RetransTableEntry::~RetransTableEntry()
 {
     ec->SetWaitingForAck(false);
+    ec->mRetransEntry = nullptr;
 }
 
 ReliableMessageMgr::ReliableMessageMgr(ObjectPool<ExchangeContext, CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS> & contextPool) :
@@ -75,7 +77,7 @@ void ReliableMessageMgr::Shutdown()
 
     // Clear the retransmit table
     mRetransTable.ForEachActiveObject([&](auto * entry) {
-        mRetransTable.ReleaseObject(entry);
+        ReleaseRetransEntry(entry);
         return Loop::Continue;
     });
 
@@ -118,11 +120,13 @@ void ReliableMessageMgr::ExecuteActions()
         }
     });
 
-    // Retransmit / cancel anything in the retrans table whose retrans timeout has expired
-    mRetransTable.ForEachActiveObject([&](auto * entry) {
-        if (entry->nextRetransTime > now)
-            return Loop::Continue;
-
+    // Retransmit / cancel anything in the retrans table whose retrans timeout has expired. Entries come out of the queue
+    // in retransmission time order; the ones rescheduled during this pass are left for the next one.
+    const uint32_t passSequence = mRetransQueue.NextSequence();
+    RetransTableEntry * entry;
+    while ((entry = mRetransQueue.Earliest()) != nullptr && entry->nextRetransTime <= now &&
+           static_cast<int32_t>(entry->mQueueSequence - passSequence) < 0)
+    {
         VerifyOrDie(!entry->retainedBuf.IsNull());
 
         uint8_t sendCount = entry->sendCount;
@@ -157,9 +161,9 @@ void ReliableMessageMgr::ExecuteActions()
             }
 
             // Do not StartTimer, we will schedule the timer at the end of the timer handler.
-            mRetransTable.ReleaseObject(entry);
+            ReleaseRetransEntry(entry);
 
-            return Loop::Continue;
+            continue;
         }
 
         entry->sendCount++;
@@ -170,9 +174,7 @@ void ReliableMessageMgr::ExecuteActions()
 
         CalculateNextRetransTime(*entry);
         SendFromRetransTable(entry);
-
-        return Loop::Continue;
-    });
+    }
 
     TicklessDebugDumpRetransTable("ReliableMessageMgr::ExecuteActions Dumping mRetransTable entries after processing");
 }
@@ -275,24 +277,20 @@ void ReliableMessageMgr::StartRetransmision(RetransTableEntry * entry)
 
 bool ReliableMessageMgr::CheckAndRemRetransTable(ReliableMessageContext * rc, uint32_t ackMessageCounter)
 {
-    bool removed = false;
-    mRetransTable.ForEachActiveObject([&](auto * entry) {
-        if (entry->ec->GetReliableMessageContext() == rc && entry->retainedBuf.GetMessageCounter() == ackMessageCounter)
-        {
-            // Clear the entry from the retransmision table.
-            ClearRetransTable(*entry);
-
-            ChipLogDetail(ExchangeManager,
-                          "Rxd Ack; Removing MessageCounter:" ChipLogFormatMessageCounter
-                          " from Retrans Table on exchange " ChipLogFormatExchange,
-                          ackMessageCounter, ChipLogValueExchange(rc->GetExchangeContext()));
-            removed = true;
-            return Loop::Break;
-        }
-        return Loop::Continue;
-    });
+    RetransTableEntry * entry = rc->mRetransEntry;
+    if (entry == nullptr || entry->retainedBuf.GetMessageCounter() != ackMessageCounter)
+    {
+        return false;
+    }
 
-    return removed;
+    // Clear the entry from the retransmision table.
+    ClearRetransTable(*entry);
+
+    ChipLogDetail(ExchangeManager,
+                  "Rxd Ack; Removing MessageCounter:" ChipLogFormatMessageCounter
+                  " from Retrans Table on exchange " ChipLogFormatExchange,
+                  ackMessageCounter, ChipLogValueExchange(rc->GetExchangeContext()));
+    return true;
 }
 
 CHIP_ERROR ReliableMessageMgr::SendFromRetransTable(RetransTableEntry * entry)
@@ -351,19 +349,15 @@ CHIP_ERROR ReliableMessageMgr::SendFromRetransTable(RetransTableEntry * entry)
 
 void ReliableMessageMgr::ClearRetransTable(ReliableMessageContext * rc)
 {
-    mRetransTable.ForEachActiveObject([&](auto * entry) {
-        if (entry->ec->GetReliableMessageContext() == rc)
-        {
-            ClearRetransTable(*entry);
-            return Loop::Break;
-        }
-        return Loop::Continue;
-    });
+    if (rc->mRetransEntry != nullptr)
+    {
+        ClearRetransTable(*rc->mRetransEntry);
+    }
 }
 
 void ReliableMessageMgr::ClearRetransTable(RetransTableEntry & entry)
 {
-    mRetransTable.ReleaseObject(&entry);
+    ReleaseRetransEntry(&entry);
     // Expire any virtual ticks that have expired so all wakeup sources reflect the current time
     StartTimer();
 }
@@ -381,13 +375,11 @@ void ReliableMessageMgr::StartTimer()
     });
 
     // When do we need to next wake up for ReliableMessageProtocol retransmit?
-    mRetransTable.ForEachActiveObject([&](auto * entry) {
-        if (entry->nextRetransTime < nextWakeTime)
-        {
-            nextWakeTime = entry->nextRetransTime;
-        }
-        return Loop::Continue;
-    });
+    RetransTableEntry * earliest = mRetransQueue.Earliest();
+    if (earliest != nullptr && earliest->nextRetransTime < nextWakeTime)
+    {
+        nextWakeTime = earliest->nextRetransTime;
+    }
 
     StopTimer();
 
@@ -468,7 +460,32 @@ void ReliableMessageMgr::CalculateNextRetransTime(RetransTableEntry & entry)
     }
 
     System::Clock::Timestamp backoff = ReliableMessageMgr::GetBackoff(baseTimeout, entry.sendCount);
-    entry.nextRetransTime            = System::SystemClock().GetMonotonicTimestamp() + backoff;
+
+    // The queue is ordered by nextRetransTime, so the entry has to be rescheduled.
+    if (mRetransQueue.Contains(&entry))
+    {
+        mRetransQueue.Remove(&entry);
+    }
+    entry.nextRetransTime = System::SystemClock().GetMonotonicTimestamp() + backoff;
+    mRetransQueue.Add(&entry);
+}
+
+void ReliableMessageMgr::ReleaseRetransEntry(RetransTableEntry * entry)
+{
+    if (mRetransQueue.Contains(entry))
+    {
+        mRetransQueue.Remove(entry);
+    }
+    mRetransTable.ReleaseObject(entry);
+}
+
+bool ReliableMessageMgr::RetransQueue::IsEarlier::operator()(const RetransTableEntry * a, const RetransTableEntry * b) const
+{
+    if (a->nextRetransTime != b->nextRetransTime)
+    {
+        return a->nextRetransTime < b->nextRetransTime;
+    }
+    return static_cast<int32_t>(a->mQueueSequence - b->mQueueSequence) < 0;
 }
 
 #if CHIP_CONFIG_TEST
@@ -28,6 +28,7 @@
 
 #include <lib/core/CHIPError.h>
 #include <lib/support/BitFlags.h>
+#include <lib/support/IntrusivePairingHeap.h>
 #include <lib/support/Pool.h>
 #include <messaging/ExchangeContext.h>
 #include <messaging/ReliableMessageProtocolConfig.h>
@@ -42,30 +43,41 @@ namespace Messaging {
 enum class SendMessageFlags : uint16_t;
 class ReliableMessageContext;
 
+class ReliableMessageMgr;
+
+/**
+ *  @class RetransTableEntry
+ *
+ *  @brief
+ *    This class is part of the CHIP Reliable Messaging Protocol and is used
+ *    to keep track of CHIP messages that have been sent and are expecting an
+ *    acknowledgment back. If the acknowledgment is not received within a
+ *    specific timeout, the message would be retransmitted from this table.
+ *
+ */
+struct RetransTableEntry : public IntrusivePairingHeapNode
+{
+    RetransTableEntry(ReliableMessageContext * rc);
+    ~RetransTableEntry();
+
+    ExchangeHandle ec;                        /**< The context for the stored CHIP message. */
+    EncryptedPacketBufferHandle retainedBuf;  /**< The packet buffer holding the CHIP message. */
+    System::Clock::Timestamp nextRetransTime; /**< A counter representing the next retransmission time for the message. */
+    uint8_t sendCount;                        /**< The number of times we have tried to send this entry,
+                                                   including both successfully and failure send. */
+
+private:
+    friend class ReliableMessageMgr;
+
+    // Scheduling order in the retransmission queue of ReliableMessageMgr, which links the entry through its
+    // IntrusivePairingHeapNode base, to keep entries with equal retransmission times FIFO.
+    uint32_t mQueueSequence = 0;
+};
+
 class ReliableMessageMgr
 {
 public:
-    /**
-     *  @class RetransTableEntry
-     *
-     *  @brief
-     *    This class is part of the CHIP Reliable Messaging Protocol and is used
-     *    to keep track of CHIP messages that have been sent and are expecting an
-     *    acknowledgment back. If the acknowledgment is not received within a
-     *    specific timeout, the message would be retransmitted from this table.
-     *
-     */
-    struct RetransTableEntry
-    {
-        RetransTableEntry(ReliableMessageContext * rc);
-        ~RetransTableEntry();
-
-        ExchangeHandle ec;                        /**< The context for the stored CHIP message. */
-        EncryptedPacketBufferHandle retainedBuf;  /**< The packet buffer holding the CHIP message. */
-        System::Clock::Timestamp nextRetransTime; /**< A counter representing the next retransmission time for the message. */
-        uint8_t sendCount;                        /**< The number of times we have tried to send this entry,
-                                                       including both successfully and failure send. */
-    };
+    using RetransTableEntry = Messaging::RetransTableEntry;
 
     ReliableMessageMgr(ObjectPool<ExchangeContext, CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS> & contextPool);
     ~ReliableMessageMgr();
@@ -124,8 +136,7 @@ public:
     void StartRetransmision(RetransTableEntry * entry);
 
     /**
-     *  Iterate through active exchange contexts and retrans table entries. Clear the entry matching
-     *  the specified ExchangeContext and the message ID from the retransmision table.
+     *  Clear the entry matching the specified ExchangeContext and the message ID from the retransmision table.
      *
      *  @param[in]    rc                 A pointer to the ExchangeContext object.
      *  @param[in]    ackMessageCounter  The acknowledged message counter of the received packet.
@@ -214,6 +225,40 @@ private:
      */
     void CalculateNextRetransTime(RetransTableEntry & entry);
 
+    /**
+     * Unschedules an entry and releases it, without restarting the timer.
+     */
+    void ReleaseRetransEntry(RetransTableEntry * entry);
+
+    /**
+     * Retransmission table entries ordered by nextRetransTime, so that the next retransmission is found
+     * without going through the whole table. Entries are linked in an IntrusivePairingHeap through their
+     * own fields: scheduling and unscheduling one entry are O(log n) amortized and need no allocation.
+     */
+    class RetransQueue
+    {
+    public:
+        RetransTableEntry * Earliest() const { return mHeap.Top(); }
+        uint32_t NextSequence() const { return mNextSequence; }
+        bool Contains(const RetransTableEntry * entry) const { return mHeap.Contains(entry); }
+
+        void Add(RetransTableEntry * entry)
+        {
+            entry->mQueueSequence = mNextSequence++;
+            mHeap.Push(entry);
+        }
+        void Remove(RetransTableEntry * entry) { mHeap.Remove(entry); }
+
+    private:
+        struct IsEarlier
+        {
+            bool operator()(const RetransTableEntry * a, const RetransTableEntry * b) const;
+        };
+
+        IntrusivePairingHeap<RetransTableEntry, IsEarlier> mHeap;
+        uint32_t mNextSequence = 0;
+    };
+
     ObjectPool<ExchangeContext, CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS> & mContextPool;
     chip::System::Layer * mSystemLayer;
 
@@ -231,6 +276,7 @@ private:
 
     // ReliableMessageProtocol Global tables for timer context
     ObjectPool<RetransTableEntry, CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE> mRetransTable;
+    RetransQueue mRetransQueue;
 
     SessionUpdateDelegate * mSessionUpdateDelegate = nullptr;
 };
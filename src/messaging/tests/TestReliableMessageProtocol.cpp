@@ -322,6 +322,7 @@ public:
     static void CheckGetBackoff(nlTestSuite * inSuite, void * inContext);
     static void CheckApplicationResponseDelayed(nlTestSuite * inSuite, void * inContext);
     static void CheckApplicationResponseNeverComes(nlTestSuite * inSuite, void * inContext);
+    static void CheckManyOutstandingExchanges(nlTestSuite * inSuite, void * inContext);
     static int InitializeTestCase(void * inContext);
 };
 
@@ -2130,6 +2131,80 @@ void TestReliableMessageProtocol::CheckApplicationResponseNeverComes(nlTestSuite
     NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
 }
 
+/**
+ * Tests MRP with several exchanges waiting for an ack at the same time:
+ *
+ * 1) DUT sends one message on each of kNumExchanges exchanges, all dropped
+ * 2) DUT receives an ack for one of them, out of order
+ *      - Confirm only the acked message leaves the retransmit table
+ * 3) DUT retransmits the remaining messages, which get acked
+ *      - Confirm each remaining message is retransmitted once and the retransmit table empties
+ */
+void TestReliableMessageProtocol::CheckManyOutstandingExchanges(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    constexpr size_t kNumExchanges = 4;
+
+    ReliableMessageMgr * rm = ctx.GetExchangeManager().GetReliableMessageMgr();
+    NL_TEST_ASSERT(inSuite, rm != nullptr);
+
+    ctx.GetSessionAliceToBob()->AsSecureSession()->SetRemoteMRPConfig({
+        64_ms32, // CHIP_CONFIG_MRP_LOCAL_IDLE_RETRY_INTERVAL
+        64_ms32, // CHIP_CONFIG_MRP_LOCAL_ACTIVE_RETRY_INTERVAL
+    });
+
+    auto & loopback               = ctx.GetLoopback();
+    loopback.mSentMessageCount    = 0;
+    loopback.mNumMessagesToDrop   = kNumExchanges;
+    loopback.mDroppedMessageCount = 0;
+
+    // Ensure the retransmit table is empty right now
+    NL_TEST_ASSERT(inSuite, rm->TestGetCountRetransTable() == 0);
+
+    MockAppDelegate mockSender(ctx);
+    ExchangeContext * exchanges[kNumExchanges];
+    for (auto & exchange : exchanges)
+    {
+        exchange = ctx.NewExchangeToAlice(&mockSender);
+        NL_TEST_ASSERT(inSuite, exchange != nullptr);
+
+        chip::System::PacketBufferHandle buffer = chip::MessagePacketBuffer::NewWithData(PAYLOAD, sizeof(PAYLOAD));
+        NL_TEST_ASSERT(inSuite, !buffer.IsNull());
+        NL_TEST_ASSERT(inSuite, exchange->SendMessage(Echo::MsgType::EchoRequest, std::move(buffer)) == CHIP_NO_ERROR);
+    }
+    ctx.DrainAndServiceIO();
+
+    // Ensure the messages were dropped, and were added to retransmit table
+    NL_TEST_ASSERT(inSuite, loopback.mDroppedMessageCount == kNumExchanges);
+    NL_TEST_ASSERT(inSuite, rm->TestGetCountRetransTable() == kNumExchanges);
+
+    // Ack the message of one of the exchanges in the middle
+    ReliableMessageContext * rc = exchanges[kNumExchanges / 2]->GetReliableMessageContext();
+    uint32_t messageCounter     = 0;
+    rm->EnumerateRetransTable([&](auto * entry) {
+        if (entry->ec->GetReliableMessageContext() == rc)
+        {
+            messageCounter = entry->retainedBuf.GetMessageCounter();
+            return Loop::Break;
+        }
+        return Loop::Continue;
+    });
+    NL_TEST_ASSERT(inSuite, !rm->CheckAndRemRetransTable(rc, messageCounter + 1));
+    NL_TEST_ASSERT(inSuite, rm->TestGetCountRetransTable() == kNumExchanges);
+    NL_TEST_ASSERT(inSuite, rm->CheckAndRemRetransTable(rc, messageCounter));
+    NL_TEST_ASSERT(inSuite, !rm->CheckAndRemRetransTable(rc, messageCounter));
+    NL_TEST_ASSERT(inSuite, rm->TestGetCountRetransTable() == kNumExchanges - 1);
+
+    // Wait for the other messages to be retransmitted (should take 64ms) and acked
+    ctx.GetIOContext().DriveIOUntil(1000_ms32, [&] { return rm->TestGetCountRetransTable() == 0; });
+    ctx.DrainAndServiceIO();
+
+    NL_TEST_ASSERT(inSuite, loopback.mSentMessageCount >= 2 * kNumExchanges - 1);
+    NL_TEST_ASSERT(inSuite, loopback.mDroppedMessageCount == kNumExchanges);
+    NL_TEST_ASSERT(inSuite, rm->TestGetCountRetransTable() == 0);
+}
+
 int TestReliableMessageProtocol::InitializeTestCase(void * inContext)
 {
     TestContext & ctx = *static_cast<TestContext *>(inContext);
@@ -2192,6 +2267,8 @@ const nlTest sTests[] = {
                 TestReliableMessageProtocol::CheckApplicationResponseDelayed),
     NL_TEST_DEF("Test an application response that never comes, so MRP retransmits run out and then exchange times out",
                 TestReliableMessageProtocol::CheckApplicationResponseNeverComes),
+    NL_TEST_DEF("Test several exchanges waiting for an ack at the same time",
+                TestReliableMessageProtocol::CheckManyOutstandingExchanges),
     NL_TEST_SENTINEL(),
 };
 
@@ -64,6 +64,35 @@
 #define CHIP_DEVICE_CONFIG_THREAD_TASK_STACK_SIZE 8192
 #endif // CHIP_DEVICE_CONFIG_THREAD_TASK_STACK_SIZE
 
+// Offload heavy crypto (e.g. CASE signature checks) to a pool of background workers, one per CPU.
+#ifndef CHIP_DEVICE_CONFIG_ENABLE_BG_EVENT_PROCESSING
+#define CHIP_DEVICE_CONFIG_ENABLE_BG_EVENT_PROCESSING 1
+#endif // CHIP_DEVICE_CONFIG_ENABLE_BG_EVENT_PROCESSING
+
+#ifndef CHIP_DEVICE_CONFIG_BG_TASK_COUNT
+#define CHIP_DEVICE_CONFIG_BG_TASK_COUNT 0
+#endif // CHIP_DEVICE_CONFIG_BG_TASK_COUNT
+
+#ifndef CHIP_DEVICE_CONFIG_BG_MAX_EVENT_QUEUE_SIZE
+#define CHIP_DEVICE_CONFIG_BG_MAX_EVENT_QUEUE_SIZE 100
+#endif // CHIP_DEVICE_CONFIG_BG_MAX_EVENT_QUEUE_SIZE
+
+// Use the log-structured store (CHIPLinuxStorageLog.h) instead of the INI file as the KVS backend.
+#ifndef CHIP_DEVICE_CONFIG_LINUX_KVS_LOG
+#define CHIP_DEVICE_CONFIG_LINUX_KVS_LOG 0
+#endif // CHIP_DEVICE_CONFIG_LINUX_KVS_LOG
+
+// Number of KVS writes after which the log is flushed with fdatasync(). 0 leaves flushing to the kernel,
+// which is what the INI backend does.
+#ifndef CHIP_DEVICE_CONFIG_LINUX_KVS_LOG_SYNC_INTERVAL
+#define CHIP_DEVICE_CONFIG_LINUX_KVS_LOG_SYNC_INTERVAL 0
+#endif // CHIP_DEVICE_CONFIG_LINUX_KVS_LOG_SYNC_INTERVAL
+
+// Size in bytes below which the KVS log is never compacted.
+#ifndef CHIP_DEVICE_CONFIG_LINUX_KVS_LOG_COMPACT_MIN_SIZE
+#define CHIP_DEVICE_CONFIG_LINUX_KVS_LOG_COMPACT_MIN_SIZE (64 * 1024)
+#endif // CHIP_DEVICE_CONFIG_LINUX_KVS_LOG_COMPACT_MIN_SIZE
+
 #ifndef CHIP_DEVICE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
 #define CHIP_DEVICE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS 1
 #endif // CHIP_DEVICE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
@@ -0,0 +1,625 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *         This file implements a log-structured key-value store for the Linux KVS.
+ *
+ *         The log file starts with a magic string, followed by records of the form:
+ *
+ *           | crc32 (4) | type (1) | key length (2) | value length (4) | key | value |
+ *
+ *         Integers are little endian, and the CRC covers everything after itself. The value
+ *         of a batch record, whose key is empty, is the put and delete records of the batch.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <libgen.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include <lib/core/CHIPEncoding.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <platform/Linux/CHIPLinuxStorageLog.h>
+#include <system/SystemError.h>
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+namespace {
+
+constexpr char kLogMagic[]          = { 'C', 'H', 'I', 'P', 'K', 'V', 'L', '1' };
+constexpr size_t kRecordHeaderSize  = 4 + 1 + 2 + 4;
+constexpr size_t kRecordCrcSize     = 4;
+constexpr uint8_t kRecordTypePut    = 1;
+constexpr uint8_t kRecordTypeDelete = 2;
+constexpr uint8_t kRecordTypeBatch  = 3;
+
+struct Record
+{
+    uint8_t type;
+    std::string key;
+    const uint8_t * data;
+    uint32_t dataLen;
+};
+
+uint32_t Crc32(const uint8_t * data, size_t length)
+{
+    // CRC-32 (IEEE 802.3), computed a nibble at a time.
+    static constexpr uint32_t kTable[16] = { 0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4,
+                                             0x4DB26158, 0x5005713C, 0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+                                             0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C };
+
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < length; i++)
+    {
+        crc = kTable[(crc ^ data[i]) & 0x0F] ^ (crc >> 4);
+        crc = kTable[(crc ^ (data[i] >> 4)) & 0x0F] ^ (crc >> 4);
+    }
+    return ~crc;
+}
+
+void EncodeRecord(uint8_t * out, uint8_t type, const std::string & key, const uint8_t * data, size_t dataLen)
+{
+    uint8_t * p = out + kRecordCrcSize;
+    Encoding::Write8(p, type);
+    Encoding::LittleEndian::Write16(p, static_cast<uint16_t>(key.size()));
+    Encoding::LittleEndian::Write32(p, static_cast<uint32_t>(dataLen));
+    memcpy(p, key.data(), key.size());
+    if (dataLen > 0)
+    {
+        memcpy(p + key.size(), data, dataLen);
+    }
+
+    p = out;
+    Encoding::LittleEndian::Write32(p, Crc32(out + kRecordCrcSize, kRecordHeaderSize - kRecordCrcSize + key.size() + dataLen));
+}
+
+// Parses the record at the start of `data`. Returns its size, or 0 if it is torn or corrupted.
+size_t ParseRecord(const uint8_t * data, size_t size, Record & record)
+{
+    VerifyOrReturnValue(size >= kRecordHeaderSize, 0);
+
+    const uint8_t * p = data;
+    uint32_t crc      = Encoding::LittleEndian::Read32(p);
+    record.type       = Encoding::Read8(p);
+    uint16_t keyLen   = Encoding::LittleEndian::Read16(p);
+    record.dataLen    = Encoding::LittleEndian::Read32(p);
+
+    // A record running past the end of the file was torn by a crash.
+    size_t available = size - kRecordHeaderSize;
+    VerifyOrReturnValue(keyLen <= available && record.dataLen <= available - keyLen, 0);
+
+    size_t recordSize = kRecordHeaderSize + keyLen + record.dataLen;
+    VerifyOrReturnValue(Crc32(data + kRecordCrcSize, recordSize - kRecordCrcSize) == crc, 0);
+
+    record.key.assign(reinterpret_cast<const char *>(p), keyLen);
+    record.data = p + keyLen;
+    return recordSize;
+}
+
+CHIP_ERROR WriteAll(int fd, const uint8_t * data, size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t written = write(fd, data, length);
+        if (written < 0)
+        {
+            VerifyOrReturnError(errno == EINTR, CHIP_ERROR_POSIX(errno));
+            continue;
+        }
+        data += written;
+        length -= static_cast<size_t>(written);
+    }
+    return CHIP_NO_ERROR;
+}
+
+// Makes a rename within the directory durable.
+void SyncDirectory(const std::string & path)
+{
+    std::string dir(path);
+    int fd = open(dirname(&dir[0]), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd >= 0)
+    {
+        fsync(fd);
+        close(fd);
+    }
+}
+
+} // namespace
+
+ChipLinuxStorageLog::ChipLinuxStorageLog(size_t syncInterval, size_t compactMinSize) :
+    mSyncInterval(syncInterval), mCompactMinSize(compactMinSize)
+{}
+
+ChipLinuxStorageLog::~ChipLinuxStorageLog()
+{
+    Shutdown();
+}
+
+size_t ChipLinuxStorageLog::RecordSize(size_t keyLen, size_t dataLen)
+{
+    return kRecordHeaderSize + keyLen + dataLen;
+}
+
+CHIP_ERROR ChipLinuxStorageLog::Init(const char * logFile)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+
+    ChipLogDetail(DeviceLayer, "ChipLinuxStorageLog::Init: Using KVS log file: %s", StringOrNullMarker(logFile));
+    if (mFd >= 0)
+    {
+        ChipLogError(DeviceLayer, "ChipLinuxStorageLog::Init: Attempt to re-initialize with KVS log file: %s",
+                     StringOrNullMarker(logFile));
+        return CHIP_NO_ERROR;
+    }
+    VerifyOrReturnError(logFile != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    mFd = open(logFile, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    VerifyOrReturnError(mFd >= 0, CHIP_ERROR_POSIX(errno));
+
+    mLogPath.assign(logFile);
+    mBytesWritten = 0;
+
+    CHIP_ERROR err = Replay();
+    if (err != CHIP_NO_ERROR)
+    {
+        close(mFd);
+        mFd = -1;
+        mValues.clear();
+    }
+    return err;
+}
+
+CHIP_ERROR ChipLinuxStorageLog::Replay()
+{
+    struct stat st;
+    VerifyOrReturnError(fstat(mFd, &st) == 0, CHIP_ERROR_POSIX(errno));
+
+    std::vector<uint8_t> log(static_cast<size_t>(st.st_size));
+    size_t size = 0;
+    while (size < log.size())
+    {
+        ssize_t bytesRead = pread(mFd, log.data() + size, log.size() - size, static_cast<off_t>(size));
+        if (bytesRead < 0)
+        {
+            VerifyOrReturnError(errno == EINTR, CHIP_ERROR_POSIX(errno));
+            continue;
+        }
+        if (bytesRead == 0)
+        {
+            break;
+        }
+        size += static_cast<size_t>(bytesRead);
+    }
+
+    mValues.clear();
+    mLiveBytes       = 0;
+    mUnsyncedRecords = 0;
+
+    // A new file, or one whose header was torn while being created.
+    if (size == 0 || (size < sizeof(kLogMagic) && memcmp(log.data(), kLogMagic, size) == 0))
+    {
+        VerifyOrReturnError(ftruncate(mFd, 0) == 0, CHIP_ERROR_POSIX(errno));
+        ReturnErrorOnFailure(WriteAll(mFd, reinterpret_cast<const uint8_t *>(kLogMagic), sizeof(kLogMagic)));
+        VerifyOrReturnError(fdatasync(mFd) == 0, CHIP_ERROR_POSIX(errno));
+        mLogSize = sizeof(kLogMagic);
+        mBytesWritten += sizeof(kLogMagic);
+        return CHIP_NO_ERROR;
+    }
+
+    if (size < sizeof(kLogMagic) || memcmp(log.data(), kLogMagic, sizeof(kLogMagic)) != 0)
+    {
+        ChipLogError(DeviceLayer, "ChipLinuxStorageLog: %s is not a KVS log file", mLogPath.c_str());
+        return CHIP_ERROR_PERSISTED_STORAGE_FAILED;
+    }
+
+    size_t offset = sizeof(kLogMagic);
+    while (offset < size)
+    {
+        Record record;
+        size_t recordSize = ParseRecord(log.data() + offset, size - offset, record);
+        if (recordSize == 0)
+        {
+            break;
+        }
+
+        if (record.type == kRecordTypePut)
+        {
+            SetValue(record.key, record.data, record.dataLen);
+        }
+        else if (record.type == kRecordTypeDelete)
+        {
+            RemoveValue(record.key);
+        }
+        else if (record.type != kRecordTypeBatch || !ReplayRecords(record.data, record.dataLen))
+        {
+            break;
+        }
+
+        offset += recordSize;
+    }
+
+    if (offset < size)
+    {
+        ChipLogError(DeviceLayer, "ChipLinuxStorageLog: discarding %u bytes of torn or corrupted records from %s",
+                     static_cast<unsigned>(size - offset), mLogPath.c_str());
+        VerifyOrReturnError(ftruncate(mFd, static_cast<off_t>(offset)) == 0, CHIP_ERROR_POSIX(errno));
+        VerifyOrReturnError(fdatasync(mFd) == 0, CHIP_ERROR_POSIX(errno));
+    }
+    mLogSize = offset;
+
+    ChipLogDetail(DeviceLayer, "ChipLinuxStorageLog: loaded %u keys, %u of %u log bytes live",
+                  static_cast<unsigned>(mValues.size()), static_cast<unsigned>(mLiveBytes), static_cast<unsigned>(mLogSize));
+    return CHIP_NO_ERROR;
+}
+
+bool ChipLinuxStorageLog::ReplayRecords(const uint8_t * records, size_t size)
+{
+    // The records of a batch are checked before any of them is applied, so that it is replayed all or nothing.
+    std::vector<Record> batch;
+    for (size_t offset = 0; offset < size;)
+    {
+        Record record;
+        size_t recordSize = ParseRecord(records + offset, size - offset, record);
+        VerifyOrReturnValue(recordSize != 0 && (record.type == kRecordTypePut || record.type == kRecordTypeDelete), false);
+        batch.push_back(std::move(record));
+        offset += recordSize;
+    }
+
+    for (const Record & record : batch)
+    {
+        if (record.type == kRecordTypePut)
+        {
+            SetValue(record.key, record.data, record.dataLen);
+        }
+        else
+        {
+            RemoveValue(record.key);
+        }
+    }
+    return true;
+}
+
+void ChipLinuxStorageLog::SetValue(const std::string & key, const uint8_t * data, size_t dataLen)
+{
+    auto it = mValues.find(key);
+    if (it != mValues.end())
+    {
+        mLiveBytes -= RecordSize(key.size(), it->second.size());
+        it->second.assign(data, data + dataLen);
+    }
+    else
+    {
+        mValues.emplace(key, std::vector<uint8_t>(data, data + dataLen));
+    }
+    mLiveBytes += RecordSize(key.size(), dataLen);
+}
+
+void ChipLinuxStorageLog::RemoveValue(const std::string & key)
+{
+    auto it = mValues.find(key);
+    VerifyOrReturn(it != mValues.end());
+
+    mLiveBytes -= RecordSize(key.size(), it->second.size());
+    mValues.erase(it);
+}
+
+void ChipLinuxStorageLog::Shutdown()
+{
+    std::lock_guard<std::mutex> lock(mLock);
+
+    // An open batch is discarded.
+    mBatchDepth = 0;
+    mBatchRecords.clear();
+    mBatchPreviousValues.clear();
+
+    VerifyOrReturn(mFd >= 0);
+    if (mUnsyncedRecords > 0)
+    {
+        fdatasync(mFd);
+    }
+    close(mFd);
+    mFd = -1;
+    mValues.clear();
+}
+
+CHIP_ERROR ChipLinuxStorageLog::ReadValueBin(const char * key, void * buf, size_t bufSize, size_t * outLen, size_t offset)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+
+    VerifyOrReturnError(mFd >= 0, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(key != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    auto it = mValues.find(key);
+    VerifyOrReturnError(it != mValues.end(), CHIP_ERROR_KEY_NOT_FOUND);
+
+    const std::vector<uint8_t> & value = it->second;
+    VerifyOrReturnError(offset <= value.size(), CHIP_ERROR_INVALID_ARGUMENT);
+
+    size_t remaining = value.size() - offset;
+    size_t copySize  = std::min(bufSize, remaining);
+    if (copySize > 0)
+    {
+        memcpy(buf, value.data() + offset, copySize);
+    }
+    if (outLen != nullptr)
+    {
+        *outLen = copySize;
+    }
+
+    return (bufSize < remaining) ? CHIP_ERROR_BUFFER_TOO_SMALL : CHIP_NO_ERROR;
+}
+
+CHIP_ERROR ChipLinuxStorageLog::WriteValueBin(const char * key, const void * data, size_t dataLen)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+
+    VerifyOrReturnError(mFd >= 0, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(key != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(data != nullptr || dataLen == 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(dataLen <= UINT32_MAX, CHIP_ERROR_INVALID_ARGUMENT);
+
+    std::string keyString(key);
+    VerifyOrReturnError(keyString.size() <= UINT16_MAX, CHIP_ERROR_INVALID_ARGUMENT);
+
+    const uint8_t * bytes = static_cast<const uint8_t *>(data);
+    ReturnErrorOnFailure(Append(kRecordTypePut, keyString, bytes, dataLen));
+
+    RememberPreviousValue(keyString);
+    SetValue(keyString, bytes, dataLen);
+
+    CompactIfNeeded();
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR ChipLinuxStorageLog::ClearValue(const char * key)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+
+    VerifyOrReturnError(mFd >= 0, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(key != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    std::string keyString(key);
+    VerifyOrReturnError(mValues.find(keyString) != mValues.end(), CHIP_ERROR_KEY_NOT_FOUND);
+
+    ReturnErrorOnFailure(Append(kRecordTypeDelete, keyString, nullptr, 0));
+
+    RememberPreviousValue(keyString);
+    RemoveValue(keyString);
+
+    CompactIfNeeded();
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR ChipLinuxStorageLog::Append(uint8_t type, const std::string & key, const uint8_t * data, size_t dataLen)
+{
+    if (mBatchDepth > 0)
+    {
+        size_t offset = mBatchRecords.size();
+        mBatchRecords.resize(offset + RecordSize(key.size(), dataLen));
+        EncodeRecord(mBatchRecords.data() + offset, type, key, data, dataLen);
+        return CHIP_NO_ERROR;
+    }
+
+    std::vector<uint8_t> record(RecordSize(key.size(), dataLen));
+    EncodeRecord(record.data(), type, key, data, dataLen);
+
+    CHIP_ERROR err = WriteAll(mFd, record.data(), record.size());
+    if (err != CHIP_NO_ERROR)
+    {
+        // Drop a partially written record, so that the records appended after it stay reachable by Replay().
+        if (ftruncate(mFd, static_cast<off_t>(mLogSize)) != 0)
+        {
+            ChipLogError(DeviceLayer, "ChipLinuxStorageLog: failed to roll back a partial write to %s", mLogPath.c_str());
+            close(mFd);
+            mFd = -1;
+        }
+        return err;
+    }
+
+    mLogSize += record.size();
+    mBytesWritten += record.size();
+
+    mUnsyncedRecords++;
+    if (mSyncInterval > 0 && mUnsyncedRecords >= mSyncInterval)
+    {
+        VerifyOrReturnError(fdatasync(mFd) == 0, CHIP_ERROR_POSIX(errno));
+        mUnsyncedRecords = 0;
+    }
+    return CHIP_NO_ERROR;
+}
+
+void ChipLinuxStorageLog::RememberPreviousValue(const std::string & key)
+{
+    VerifyOrReturn(mBatchDepth > 0 && mBatchPreviousValues.find(key) == mBatchPreviousValues.end());
+
+    auto it = mValues.find(key);
+    if (it != mValues.end())
+    {
+        mBatchPreviousValues.emplace(key, PreviousValue{ true, it->second });
+    }
+    else
+    {
+        mBatchPreviousValues.emplace(key, PreviousValue{ false, {} });
+    }
+}
+
+void ChipLinuxStorageLog::RestorePreviousValues()
+{
+    for (const auto & entry : mBatchPreviousValues)
+    {
+        RemoveValue(entry.first);
+        if (entry.second.mExists)
+        {
+            SetValue(entry.first, entry.second.mValue.data(), entry.second.mValue.size());
+        }
+    }
+    mBatchPreviousValues.clear();
+}
+
+void ChipLinuxStorageLog::BeginBatch()
+{
+    std::lock_guard<std::mutex> lock(mLock);
+
+    mBatchDepth++;
+}
+
+CHIP_ERROR ChipLinuxStorageLog::CommitBatch()
+{
+    std::lock_guard<std::mutex> lock(mLock);
+
+    VerifyOrReturnError(mBatchDepth > 0, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(--mBatchDepth == 0, CHIP_NO_ERROR);
+
+    std::vector<uint8_t> records;
+    records.swap(mBatchRecords);
+    if (records.empty())
+    {
+        mBatchPreviousValues.clear();
+        return CHIP_NO_ERROR;
+    }
+
+    CHIP_ERROR err = CHIP_ERROR_INCORRECT_STATE;
+    size_t logSize = mLogSize;
+    if (mFd >= 0 && records.size() <= UINT32_MAX)
+    {
+        err = Append(kRecordTypeBatch, std::string(), records.data(), records.size());
+    }
+    if (mLogSize == logSize)
+    {
+        // The batch never made it into the log, so its values are undone.
+        RestorePreviousValues();
+        return err;
+    }
+    mBatchPreviousValues.clear();
+    ReturnErrorOnFailure(err);
+
+    if (mUnsyncedRecords > 0)
+    {
+        VerifyOrReturnError(fdatasync(mFd) == 0, CHIP_ERROR_POSIX(errno));
+        mUnsyncedRecords = 0;
+    }
+
+    CompactIfNeeded();
+    return CHIP_NO_ERROR;
+}
+
+void ChipLinuxStorageLog::AbortBatch()
+{
+    std::lock_guard<std::mutex> lock(mLock);
+
+    VerifyOrReturn(mBatchDepth > 0);
+    VerifyOrReturn(--mBatchDepth == 0);
+
+    mBatchRecords.clear();
+    RestorePreviousValues();
+}
+
+CHIP_ERROR ChipLinuxStorageLog::Sync()
+{
+    std::lock_guard<std::mutex> lock(mLock);
+
+    VerifyOrReturnError(mFd >= 0, CHIP_ERROR_INCORRECT_STATE);
+    if (mUnsyncedRecords > 0)
+    {
+        VerifyOrReturnError(fdatasync(mFd) == 0, CHIP_ERROR_POSIX(errno));
+        mUnsyncedRecords = 0;
+    }
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR ChipLinuxStorageLog::Compact()
+{
+    std::lock_guard<std::mutex> lock(mLock);
+
+    VerifyOrReturnError(mFd >= 0 && mBatchDepth == 0, CHIP_ERROR_INCORRECT_STATE);
+    return CompactLocked();
+}
+
+void ChipLinuxStorageLog::CompactIfNeeded()
+{
+    // Compact once the records of overwritten and deleted values take more room than the live ones. The
+    // values written by an open batch are not in the log yet, so it waits for the batch to be committed.
+    VerifyOrReturn(mBatchDepth == 0);
+    VerifyOrReturn(mLogSize >= mCompactMinSize && mLogSize - sizeof(kLogMagic) > 2 * mLiveBytes);
+
+    CHIP_ERROR err = CompactLocked();
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(DeviceLayer, "ChipLinuxStorageLog: compaction of %s failed: %" CHIP_ERROR_FORMAT, mLogPath.c_str(),
+                     err.Format());
+    }
+}
+
+CHIP_ERROR ChipLinuxStorageLog::CompactLocked()
+{
+    std::vector<uint8_t> log(sizeof(kLogMagic) + mLiveBytes);
+    memcpy(log.data(), kLogMagic, sizeof(kLogMagic));
+
+    size_t offset = sizeof(kLogMagic);
+    for (const auto & entry : mValues)
+    {
+        EncodeRecord(log.data() + offset, kRecordTypePut, entry.first, entry.second.data(), entry.second.size());
+        offset += RecordSize(entry.first.size(), entry.second.size());
+    }
+
+    // Same as ChipLinuxStorageIni::CommitConfig: write a temporary file, then rename it over the log.
+    std::string tmpPath = mLogPath + "-XXXXXX";
+    int fd              = mkostemp(&tmpPath[0], O_APPEND | O_CLOEXEC);
+    VerifyOrReturnError(fd >= 0, CHIP_ERROR_POSIX(errno));
+
+    CHIP_ERROR err = WriteAll(fd, log.data(), log.size());
+    if (err == CHIP_NO_ERROR && fdatasync(fd) != 0)
+    {
+        err = CHIP_ERROR_POSIX(errno);
+    }
+    if (err == CHIP_NO_ERROR && rename(tmpPath.c_str(), mLogPath.c_str()) != 0)
+    {
+        err = CHIP_ERROR_POSIX(errno);
+    }
+    if (err != CHIP_NO_ERROR)
+    {
+        close(fd);
+        unlink(tmpPath.c_str());
+        return err;
+    }
+    SyncDirectory(mLogPath);
+
+    ChipLogDetail(DeviceLayer, "ChipLinuxStorageLog: compacted %s from %u to %u bytes", mLogPath.c_str(),
+                  static_cast<unsigned>(mLogSize), static_cast<unsigned>(log.size()));
+
+    close(mFd);
+    mFd              = fd;
+    mLogSize         = log.size();
+    mUnsyncedRecords = 0;
+    mBytesWritten += log.size();
+    return CHIP_NO_ERROR;
+}
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
@@ -0,0 +1,152 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *         This file defines a log-structured key-value store for the Linux KVS.
+ *
+ *         Every Put or Delete appends one CRC-protected record to the end of a log
+ *         file, instead of rewriting the whole store as ChipLinuxStorage does. All live
+ *         values are kept in an in-memory index, which is rebuilt by replaying the log on
+ *         Init. A torn or corrupted record at the tail (e.g. after a power loss during a
+ *         write) ends the replay, and the log is truncated back to the last good record.
+ *
+ *         The writes of a batch (BeginBatch/CommitBatch) are appended together as a single
+ *         record, with one write and one fdatasync(), and are replayed all or nothing.
+ *
+ *         Once the records of overwritten and deleted values outweigh the live ones, the
+ *         log is compacted by writing the live values to a new file and renaming it over
+ *         the old one.
+ *
+ *         The file format is not compatible with the INI file of ChipLinuxStorage.
+ */
+
+#pragma once
+
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <lib/core/CHIPError.h>
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+class ChipLinuxStorageLog
+{
+public:
+    /**
+     * @param syncInterval     Number of appended records after which the log is flushed to disk with
+     *                         fdatasync(). 0 leaves flushing to the kernel.
+     * @param compactMinSize   Size in bytes below which the log is never compacted.
+     */
+    ChipLinuxStorageLog(size_t syncInterval, size_t compactMinSize);
+    ~ChipLinuxStorageLog();
+
+    CHIP_ERROR Init(const char * logFile);
+    void Shutdown();
+
+    /**
+     * Reads the value of the given key, starting at the given offset. Follows the semantics of
+     * KeyValueStoreManager::Get: CHIP_ERROR_BUFFER_TOO_SMALL is returned when the value does not
+     * fit, after filling the buffer.
+     */
+    CHIP_ERROR ReadValueBin(const char * key, void * buf, size_t bufSize, size_t * outLen, size_t offset = 0);
+    CHIP_ERROR WriteValueBin(const char * key, const void * data, size_t dataLen);
+    CHIP_ERROR ClearValue(const char * key);
+
+    /**
+     * Starts a batch of writes. Until the matching CommitBatch() or AbortBatch(), writes are visible
+     * to reads but are not appended to the log. Batches nest: the outermost one decides.
+     */
+    void BeginBatch();
+
+    /**
+     * Ends a batch, and if it is the outermost one appends its writes to the log as one record and
+     * flushes it to disk, regardless of the sync interval.  The writes are undone if the append fails.
+     */
+    CHIP_ERROR CommitBatch();
+
+    /**
+     * Ends a batch, and if it is the outermost one undoes its writes.
+     */
+    void AbortBatch();
+
+    /**
+     * Flushes all appended records to disk.
+     */
+    CHIP_ERROR Sync();
+
+    /**
+     * Rewrites the log with only the live values. Fails while a batch is open.
+     */
+    CHIP_ERROR Compact();
+
+    /**
+     * Size of the log file and total number of bytes written to it since Init, compactions included.
+     */
+    size_t GetLogSize() const { return mLogSize; }
+    uint64_t GetBytesWritten() const { return mBytesWritten; }
+
+private:
+    struct PreviousValue
+    {
+        bool mExists;
+        std::vector<uint8_t> mValue;
+    };
+
+    CHIP_ERROR Replay();
+    bool ReplayRecords(const uint8_t * records, size_t size);
+    void SetValue(const std::string & key, const uint8_t * data, size_t dataLen);
+    void RemoveValue(const std::string & key);
+    void RememberPreviousValue(const std::string & key);
+    void RestorePreviousValues();
+    CHIP_ERROR Append(uint8_t type, const std::string & key, const uint8_t * data, size_t dataLen);
+    CHIP_ERROR CompactLocked();
+    void CompactIfNeeded();
+
+    static size_t RecordSize(size_t keyLen, size_t dataLen);
+
+    std::mutex mLock;
+    std::string mLogPath;
+    std::unordered_map<std::string, std::vector<uint8_t>> mValues;
+    int mFd = -1;
+
+    const size_t mSyncInterval;
+    const size_t mCompactMinSize;
+    size_t mUnsyncedRecords = 0;
+
+    // Records of the open batch, appended to the log as one record when it is committed, and the
+    // values its writes replaced, restored when it is aborted.
+    unsigned mBatchDepth = 0;
+    std::vector<uint8_t> mBatchRecords;
+    std::unordered_map<std::string, PreviousValue> mBatchPreviousValues;
+
+    // Size of the log file, and the part of it taken by the records of live values.
+    size_t mLogSize        = 0;
+    size_t mLiveBytes      = 0;
+    uint64_t mBytesWritten = 0;
+};
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
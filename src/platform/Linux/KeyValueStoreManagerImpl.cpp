@@ -36,6 +36,31 @@ namespace PersistedStorage {
 
 KeyValueStoreManagerImpl KeyValueStoreManagerImpl::sInstance;
 
+#if CHIP_DEVICE_CONFIG_LINUX_KVS_LOG
+
+CHIP_ERROR KeyValueStoreManagerImpl::_Get(const char * key, void * value, size_t value_size, size_t * read_bytes_size,
+                                          size_t offset_bytes)
+{
+    VerifyOrReturnError(value != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    // The log keeps all values in memory, so partial and offset reads need no extra copy.
+    CHIP_ERROR err = mStorage.ReadValueBin(key, value, value_size, read_bytes_size, offset_bytes);
+    return (err == CHIP_ERROR_KEY_NOT_FOUND) ? CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND : err;
+}
+
+CHIP_ERROR KeyValueStoreManagerImpl::_Put(const char * key, const void * value, size_t value_size)
+{
+    return mStorage.WriteValueBin(key, value, value_size);
+}
+
+CHIP_ERROR KeyValueStoreManagerImpl::_Delete(const char * key)
+{
+    CHIP_ERROR err = mStorage.ClearValue(key);
+    return (err == CHIP_ERROR_KEY_NOT_FOUND) ? CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND : err;
+}
+
+#else
+
 CHIP_ERROR KeyValueStoreManagerImpl::_Get(const char * key, void * value, size_t value_size, size_t * read_bytes_size,
                                           size_t offset_bytes)
 {
@@ -110,6 +135,8 @@ exit:
     return err;
 }
 
+#endif // CHIP_DEVICE_CONFIG_LINUX_KVS_LOG
+
 } // namespace PersistedStorage
 } // namespace DeviceLayer
 } // namespace chip
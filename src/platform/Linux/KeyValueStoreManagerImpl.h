@@ -23,7 +23,9 @@
 
 #pragma once
 
+#include <platform/CHIPDeviceConfig.h>
 #include <platform/Linux/CHIPLinuxStorage.h>
+#include <platform/Linux/CHIPLinuxStorageLog.h>
 
 namespace chip {
 namespace DeviceLayer {
@@ -42,8 +44,19 @@ public:
     CHIP_ERROR _Delete(const char * key);
     CHIP_ERROR _Put(const char * key, const void * value, size_t value_size);
 
+#if CHIP_DEVICE_CONFIG_LINUX_KVS_LOG
+    void _BeginBatch() { mStorage.BeginBatch(); }
+    CHIP_ERROR _CommitBatch() { return mStorage.CommitBatch(); }
+    void _AbortBatch() { mStorage.AbortBatch(); }
+#endif
+
 private:
+#if CHIP_DEVICE_CONFIG_LINUX_KVS_LOG
+    DeviceLayer::Internal::ChipLinuxStorageLog mStorage{ CHIP_DEVICE_CONFIG_LINUX_KVS_LOG_SYNC_INTERVAL,
+                                                         CHIP_DEVICE_CONFIG_LINUX_KVS_LOG_COMPACT_MIN_SIZE };
+#else
     DeviceLayer::Internal::ChipLinuxStorage mStorage;
+#endif
 
     // ===== Members for internal use by the following friends.
     friend KeyValueStoreManager & KeyValueStoreMgr();
@@ -0,0 +1,195 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This is a unit test suite for background work on the pool of worker threads of the POSIX
+ *      platform manager.
+ *
+ *      Each work item posts its completion back to the Matter thread with ScheduleWork(). The tests
+ *      check where work and completions run, with and without workers, and that stopping the
+ *      workers still runs the work queued before.  Handshake throughput against the number of
+ *      workers is measured by the CASE session tests.
+ */
+
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/UnitTestRegistration.h>
+#include <lib/support/UnitTestUtils.h>
+#include <nlunit-test.h>
+#include <platform/CHIPDeviceLayer.h>
+
+#include <pthread.h>
+
+#include <atomic>
+
+using namespace chip;
+using namespace chip::DeviceLayer;
+
+namespace {
+
+// Kept below CHIP_DEVICE_CONFIG_BG_MAX_EVENT_QUEUE_SIZE, so that all work can be queued at once.
+constexpr size_t kWorkCount   = 64;
+constexpr uint32_t kTimeoutMs = 10000;
+
+struct WorkContext
+{
+    pthread_t mMatterThread;
+
+    std::atomic<size_t> mCompleted{ 0 };
+    std::atomic<size_t> mRanOnMatterThread{ 0 };
+    std::atomic<size_t> mCompletedOffMatterThread{ 0 };
+};
+
+WorkContext * gContext;
+
+void CompleteWork(intptr_t)
+{
+    if (!pthread_equal(pthread_self(), gContext->mMatterThread))
+    {
+        gContext->mCompletedOffMatterThread++;
+    }
+    gContext->mCompleted++;
+}
+
+void RunWork(intptr_t)
+{
+    if (pthread_equal(pthread_self(), gContext->mMatterThread))
+    {
+        gContext->mRanOnMatterThread++;
+    }
+    PlatformMgr().ScheduleWork(CompleteWork);
+}
+
+void RecordMatterThread(intptr_t)
+{
+    gContext->mMatterThread = pthread_self();
+    gContext->mCompleted++;
+}
+
+bool WaitForCompletions(size_t count)
+{
+    for (uint32_t t = 0; gContext->mCompleted < count && t < kTimeoutMs; t++)
+    {
+        chip::test_utils::SleepMillis(1);
+    }
+    return gContext->mCompleted == count;
+}
+
+// Runs kWorkCount work items through ScheduleBackgroundWork() and waits for their completions.
+void RunAllWork(nlTestSuite * inSuite)
+{
+    gContext->mCompleted                = 0;
+    gContext->mRanOnMatterThread        = 0;
+    gContext->mCompletedOffMatterThread = 0;
+
+    for (size_t i = 0; i < kWorkCount; i++)
+    {
+        NL_TEST_ASSERT(inSuite, PlatformMgr().ScheduleBackgroundWork(RunWork) == CHIP_NO_ERROR);
+    }
+    NL_TEST_ASSERT(inSuite, WaitForCompletions(kWorkCount));
+    NL_TEST_ASSERT(inSuite, gContext->mCompletedOffMatterThread == 0);
+}
+
+void TestMatterThreadOnly(nlTestSuite * inSuite, void * inContext)
+{
+    // Without background workers, background work runs on the Matter thread.
+    RunAllWork(inSuite);
+    NL_TEST_ASSERT(inSuite, gContext->mRanOnMatterThread == kWorkCount);
+}
+
+void TestWorkerPool(nlTestSuite * inSuite, void * inContext)
+{
+#if CHIP_DEVICE_CONFIG_ENABLE_BG_EVENT_PROCESSING && !CHIP_SYSTEM_CONFIG_USE_LIBEV
+    for (size_t workers = 1; workers <= 4; workers *= 2)
+    {
+        PlatformMgrImpl().SetBackgroundTaskCount(workers);
+        NL_TEST_ASSERT(inSuite, PlatformMgr().StartBackgroundEventLoopTask() == CHIP_NO_ERROR);
+
+        RunAllWork(inSuite);
+        NL_TEST_ASSERT(inSuite, gContext->mRanOnMatterThread == 0);
+
+        NL_TEST_ASSERT(inSuite, PlatformMgr().StopBackgroundEventLoopTask() == CHIP_NO_ERROR);
+    }
+
+    PlatformMgrImpl().SetBackgroundTaskCount(CHIP_DEVICE_CONFIG_BG_TASK_COUNT);
+#endif
+}
+
+void TestStopDrainsQueue(nlTestSuite * inSuite, void * inContext)
+{
+#if CHIP_DEVICE_CONFIG_ENABLE_BG_EVENT_PROCESSING && !CHIP_SYSTEM_CONFIG_USE_LIBEV
+    gContext->mCompleted = 0;
+
+    // Work queued before the workers are stopped still runs, so that nothing it holds leaks.
+    PlatformMgrImpl().SetBackgroundTaskCount(1);
+    NL_TEST_ASSERT(inSuite, PlatformMgr().StartBackgroundEventLoopTask() == CHIP_NO_ERROR);
+    for (size_t i = 0; i < 8; i++)
+    {
+        NL_TEST_ASSERT(inSuite, PlatformMgr().ScheduleBackgroundWork(RunWork) == CHIP_NO_ERROR);
+    }
+    NL_TEST_ASSERT(inSuite, PlatformMgr().StopBackgroundEventLoopTask() == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, WaitForCompletions(8));
+
+    PlatformMgrImpl().SetBackgroundTaskCount(CHIP_DEVICE_CONFIG_BG_TASK_COUNT);
+#endif
+}
+
+const nlTest sTests[] = {
+    NL_TEST_DEF("Work on the Matter thread", TestMatterThreadOnly),
+    NL_TEST_DEF("Work on background workers", TestWorkerPool),
+    NL_TEST_DEF("Stop drains the background queue", TestStopDrainsQueue),
+    NL_TEST_SENTINEL(),
+};
+
+int TestSetup(void * inContext)
+{
+    VerifyOrReturnError(chip::Platform::MemoryInit() == CHIP_NO_ERROR, FAILURE);
+    VerifyOrReturnError(PlatformMgr().InitChipStack() == CHIP_NO_ERROR, FAILURE);
+
+    gContext = new WorkContext;
+
+    VerifyOrReturnError(PlatformMgr().StartEventLoopTask() == CHIP_NO_ERROR, FAILURE);
+    VerifyOrReturnError(PlatformMgr().ScheduleWork(RecordMatterThread) == CHIP_NO_ERROR, FAILURE);
+    VerifyOrReturnError(WaitForCompletions(1), FAILURE);
+
+    return SUCCESS;
+}
+
+int TestTeardown(void * inContext)
+{
+    PlatformMgr().StopEventLoopTask();
+    PlatformMgr().Shutdown();
+
+    delete gContext;
+    gContext = nullptr;
+
+    chip::Platform::MemoryShutdown();
+    return SUCCESS;
+}
+
+} // namespace
+
+int TestBackgroundWork()
+{
+    nlTestSuite theSuite = { "Background work", &sTests[0], TestSetup, TestTeardown };
+
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestBackgroundWork)
@@ -0,0 +1,496 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This is a unit test suite and benchmark for the log-structured KVS backend of the
+ *      Linux platform.
+ *
+ *      The tests cover reads, writes and deletes across restarts, recovery from torn and
+ *      corrupted records at the end of the log, batches, and compaction. The benchmark writes
+ *      the same sequence of values through the log, alone and in batches, and through the INI
+ *      backend, and reports the latency of a write and the bytes written to the file per byte
+ *      of value.
+ */
+
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/UnitTestRegistration.h>
+#include <nlunit-test.h>
+#include <platform/CHIPDeviceConfig.h>
+#include <platform/Linux/CHIPLinuxStorage.h>
+#include <platform/Linux/CHIPLinuxStorageLog.h>
+#include <system/SystemClock.h>
+
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace chip;
+using namespace chip::DeviceLayer::Internal;
+
+namespace {
+
+constexpr size_t kNoSync        = 0;
+constexpr size_t kNoCompaction  = SIZE_MAX;
+constexpr size_t kBenchKeyCount = 32;
+constexpr size_t kBenchWrites   = 1000;
+constexpr size_t kBenchValueLen = 64;
+
+std::string TestPath(const char * name)
+{
+    return std::string("/tmp/chip_test_kvs_log_") + std::to_string(getpid()) + "_" + name;
+}
+
+size_t FileSize(const std::string & path)
+{
+    struct stat st;
+    return (stat(path.c_str(), &st) == 0) ? static_cast<size_t>(st.st_size) : 0;
+}
+
+std::vector<uint8_t> ReadFile(const std::string & path)
+{
+    std::vector<uint8_t> contents(FileSize(path));
+    int fd = open(path.c_str(), O_RDONLY);
+    VerifyOrDie(fd >= 0);
+    VerifyOrDie(read(fd, contents.data(), contents.size()) == static_cast<ssize_t>(contents.size()));
+    close(fd);
+    return contents;
+}
+
+void WriteFile(const std::string & path, const uint8_t * data, size_t size)
+{
+    int fd = open(path.c_str(), O_WRONLY | O_TRUNC);
+    VerifyOrDie(fd >= 0);
+    VerifyOrDie(write(fd, data, size) == static_cast<ssize_t>(size));
+    close(fd);
+}
+
+void FlipByte(const std::string & path, size_t offset)
+{
+    int fd = open(path.c_str(), O_RDWR);
+    VerifyOrDie(fd >= 0);
+    uint8_t byte;
+    VerifyOrDie(pread(fd, &byte, 1, static_cast<off_t>(offset)) == 1);
+    byte ^= 0x01;
+    VerifyOrDie(pwrite(fd, &byte, 1, static_cast<off_t>(offset)) == 1);
+    close(fd);
+}
+
+bool HasValue(ChipLinuxStorageLog & storage, const char * key, const char * expected)
+{
+    char buf[64];
+    size_t len = 0;
+    VerifyOrReturnValue(storage.ReadValueBin(key, buf, sizeof(buf), &len) == CHIP_NO_ERROR, false);
+    return len == strlen(expected) && memcmp(buf, expected, len) == 0;
+}
+
+bool IsMissing(ChipLinuxStorageLog & storage, const char * key)
+{
+    char buf[64];
+    return storage.ReadValueBin(key, buf, sizeof(buf), nullptr) == CHIP_ERROR_KEY_NOT_FOUND;
+}
+
+CHIP_ERROR Write(ChipLinuxStorageLog & storage, const char * key, const char * value)
+{
+    return storage.WriteValueBin(key, value, strlen(value));
+}
+
+void TestReadWriteDelete(nlTestSuite * inSuite, void * inContext)
+{
+    std::string path = TestPath("rwd");
+    unlink(path.c_str());
+
+    {
+        ChipLinuxStorageLog storage(kNoSync, kNoCompaction);
+        NL_TEST_ASSERT(inSuite, storage.Init(path.c_str()) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, IsMissing(storage, "a"));
+
+        NL_TEST_ASSERT(inSuite, Write(storage, "a", "alpha") == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, Write(storage, "b", "beta") == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, Write(storage, "c", "gamma") == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, Write(storage, "a", "aleph") == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, storage.WriteValueBin("empty", nullptr, 0) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, storage.ClearValue("b") == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, storage.ClearValue("b") == CHIP_ERROR_KEY_NOT_FOUND);
+
+        NL_TEST_ASSERT(inSuite, HasValue(storage, "a", "aleph"));
+        NL_TEST_ASSERT(inSuite, IsMissing(storage, "b"));
+        NL_TEST_ASSERT(inSuite, HasValue(storage, "c", "gamma"));
+        NL_TEST_ASSERT(inSuite, HasValue(storage, "empty", ""));
+
+        // Partial and offset reads.
+        char buf[3];
+        size_t len = 0;
+        NL_TEST_ASSERT(inSuite, storage.ReadValueBin("c", buf, sizeof(buf), &len) == CHIP_ERROR_BUFFER_TOO_SMALL);
+        NL_TEST_ASSERT(inSuite, len == 3 && memcmp(buf, "gam", 3) == 0);
+        NL_TEST_ASSERT(inSuite, storage.ReadValueBin("c", buf, sizeof(buf), &len, 2) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, len == 3 && memcmp(buf, "mma", 3) == 0);
+        NL_TEST_ASSERT(inSuite, storage.ReadValueBin("c", buf, sizeof(buf), &len, 6) == CHIP_ERROR_INVALID_ARGUMENT);
+    }
+
+    // The values survive a restart.
+    ChipLinuxStorageLog storage(kNoSync, kNoCompaction);
+    NL_TEST_ASSERT(inSuite, storage.Init(path.c_str()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, HasValue(storage, "a", "aleph"));
+    NL_TEST_ASSERT(inSuite, IsMissing(storage, "b"));
+    NL_TEST_ASSERT(inSuite, HasValue(storage, "c", "gamma"));
+    NL_TEST_ASSERT(inSuite, HasValue(storage, "empty", ""));
+
+    storage.Shutdown();
+    unlink(path.c_str());
+}
+
+void TestTornWriteRecovery(nlTestSuite * inSuite, void * inContext)
+{
+    std::string path = TestPath("torn");
+    unlink(path.c_str());
+
+    size_t sizeBeforeLastWrite;
+    {
+        ChipLinuxStorageLog storage(kNoSync, kNoCompaction);
+        NL_TEST_ASSERT(inSuite, storage.Init(path.c_str()) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, Write(storage, "a", "alpha") == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, Write(storage, "b", "beta") == CHIP_NO_ERROR);
+        sizeBeforeLastWrite = storage.GetLogSize();
+        NL_TEST_ASSERT(inSuite, Write(storage, "a", "aleph") == CHIP_NO_ERROR);
+    }
+
+    // Cut the last record at every possible length, as a crash in the middle of the write would.
+    std::vector<uint8_t> log = ReadFile(path);
+    for (size_t size = log.size() - 1; size > sizeBeforeLastWrite; size--)
+    {
+        WriteFile(path, log.data(), size);
+
+        ChipLinuxStorageLog storage(kNoSync, kNoCompaction);
+        NL_TEST_ASSERT(inSuite, storage.Init(path.c_str()) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, HasValue(storage, "a", "alpha"));
+        NL_TEST_ASSERT(inSuite, HasValue(storage, "b", "beta"));
+        NL_TEST_ASSERT(inSuite, storage.GetLogSize() == sizeBeforeLastWrite);
+    }
+    NL_TEST_ASSERT(inSuite, FileSize(path) == sizeBeforeLastWrite);
+
+    // The torn record was dropped, so that the records written after recovery are found.
+    {
+        ChipLinuxStorageLog storage(kNoSync, kNoCompaction);
+        NL_TEST_ASSERT(inSuite, storage.Init(path.c_str()) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, Write(storage, "c", "gamma") == CHIP_NO_ERROR);
+    }
+    ChipLinuxStorageLog storage(kNoSync, kNoCompaction);
+    NL_TEST_ASSERT(inSuite, storage.Init(path.c_str()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, HasValue(storage, "a", "alpha"));
+    NL_TEST_ASSERT(inSuite, HasValue(storage, "c", "gamma"));
+
+    storage.Shutdown();
+    unlink(path.c_str());
+}
+
+void TestCorruptedRecord(nlTestSuite * inSuite, void * inContext)
+{
+    std::string path = TestPath("corrupt");
+    unlink(path.c_str());
+
+    size_t sizeBeforeLastWrite;
+    {
+        ChipLinuxStorageLog storage(kNoSync, kNoCompaction);
+        NL_TEST_ASSERT(inSuite, storage.Init(path.c_str()) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, Write(storage, "a", "alpha") == CHIP_NO_ERROR);
+        sizeBeforeLastWrite = storage.GetLogSize();
+        NL_TEST_ASSERT(inSuite, Write(storage, "a", "aleph") == CHIP_NO_ERROR);
+    }
+
+    // A bit flip in the value of the last record fails its CRC.
+    FlipByte(path, FileSize(path) - 1);
+
+    ChipLinuxStorageLog storage(kNoSync, kNoCompaction);
+    NL_TEST_ASSERT(inSuite, storage.Init(path.c_str()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, HasValue(storage, "a", "alpha"));
+    NL_TEST_ASSERT(inSuite, FileSize(path) == sizeBeforeLastWrite);
+
+    storage.Shutdown();
+    unlink(path.c_str());
+}
+
+void TestBatches(nlTestSuite * inSuite, void * inContext)
+{
+    std::string path = TestPath("batch");
+    unlink(path.c_str());
+
+    size_t sizeBeforeBatch;
+    {
+        ChipLinuxStorageLog storage(kNoSync, kNoCompaction);
+        NL_TEST_ASSERT(inSuite, storage.Init(path.c_str()) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, Write(storage, "a", "alpha") == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, Write(storage, "b", "beta") == CHIP_NO_ERROR);
+
+        // An aborted batch is undone, and leaves the log as it was.
+        size_t sizeBeforeAbort = storage.GetLogSize();
+        storage.BeginBatch();
+        NL_TEST_ASSERT(inSuite, Write(storage, "a", "aleph") == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, storage.ClearValue("b") == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, Write(storage, "c", "gamma") == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, HasValue(storage, "a", "aleph"));
+        NL_TEST_ASSERT(inSuite, IsMissing(storage, "b"));
+        storage.AbortBatch();
+        NL_TEST_ASSERT(inSuite, HasValue(storage, "a", "alpha"));
+        NL_TEST_ASSERT(inSuite, HasValue(storage, "b", "beta"));
+        NL_TEST_ASSERT(inSuite, IsMissing(storage, "c"));
+        NL_TEST_ASSERT(inSuite, storage.GetLogSize() == sizeBeforeAbort);
+
+        // The writes of a batch are visible right away, and reach the file as one append when it is committed.
+        sizeBeforeBatch           = storage.GetLogSize();
+        uint64_t bytesBeforeBatch = storage.GetBytesWritten();
+        storage.BeginBatch();
+        NL_TEST_ASSERT(inSuite, Write(storage, "a", "aleph") == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, storage.ClearValue("b") == CHIP_NO_ERROR);
+        storage.BeginBatch();
+        NL_TEST_ASSERT(inSuite, Write(storage, "c", "gamma") == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, storage.CommitBatch() == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, HasValue(storage, "c", "gamma"));
+        NL_TEST_ASSERT(inSuite, FileSize(path) == sizeBeforeBatch);
+        NL_TEST_ASSERT(inSuite, storage.Compact() == CHIP_ERROR_INCORRECT_STATE);
+        NL_TEST_ASSERT(inSuite, storage.CommitBatch() == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, storage.CommitBatch() == CHIP_ERROR_INCORRECT_STATE);
+
+        NL_TEST_ASSERT(inSuite, FileSize(path) == storage.GetLogSize());
+        NL_TEST_ASSERT(inSuite, storage.GetBytesWritten() - bytesBeforeBatch == storage.GetLogSize() - sizeBeforeBatch);
+    }
+
+    // The batch survives a restart.
+    {
+        ChipLinuxStorageLog storage(kNoSync, kNoCompaction);
+        NL_TEST_ASSERT(inSuite, storage.Init(path.c_str()) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, HasValue(storage, "a", "aleph"));
+        NL_TEST_ASSERT(inSuite, IsMissing(storage, "b"));
+        NL_TEST_ASSERT(inSuite, HasValue(storage, "c", "gamma"));
+    }
+
+    // A batch cut anywhere, or with any of its records corrupted, is dropped as a whole.
+    std::vector<uint8_t> log = ReadFile(path);
+    for (size_t size = log.size() - 1; size > sizeBeforeBatch; size--)
+    {
+        WriteFile(path, log.data(), size);
+
+        ChipLinuxStorageLog storage(kNoSync, kNoCompaction);
+        NL_TEST_ASSERT(inSuite, storage.Init(path.c_str()) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, HasValue(storage, "a", "alpha"));
+        NL_TEST_ASSERT(inSuite, HasValue(storage, "b", "beta"));
+        NL_TEST_ASSERT(inSuite, IsMissing(storage, "c"));
+        NL_TEST_ASSERT(inSuite, storage.GetLogSize() == sizeBeforeBatch);
+    }
+    WriteFile(path, log.data(), log.size());
+    FlipByte(path, log.size() - 1);
+
+    ChipLinuxStorageLog storage(kNoSync, kNoCompaction);
+    NL_TEST_ASSERT(inSuite, storage.Init(path.c_str()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, HasValue(storage, "a", "alpha"));
+    NL_TEST_ASSERT(inSuite, HasValue(storage, "b", "beta"));
+    NL_TEST_ASSERT(inSuite, IsMissing(storage, "c"));
+
+    storage.Shutdown();
+    unlink(path.c_str());
+}
+
+void TestRejectsOtherFiles(nlTestSuite * inSuite, void * inContext)
+{
+    std::string path = TestPath("ini");
+    unlink(path.c_str());
+
+    // An INI file of the other backend is left alone.
+    ChipLinuxStorage ini;
+    NL_TEST_ASSERT(inSuite, ini.Init(path.c_str()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ini.WriteValueStr("key", "value") == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ini.Commit() == CHIP_NO_ERROR);
+    size_t iniSize = FileSize(path);
+
+    ChipLinuxStorageLog storage(kNoSync, kNoCompaction);
+    NL_TEST_ASSERT(inSuite, storage.Init(path.c_str()) == CHIP_ERROR_PERSISTED_STORAGE_FAILED);
+    NL_TEST_ASSERT(inSuite, storage.WriteValueBin("key", "x", 1) == CHIP_ERROR_INCORRECT_STATE);
+    NL_TEST_ASSERT(inSuite, FileSize(path) == iniSize);
+
+    unlink(path.c_str());
+}
+
+void TestCompaction(nlTestSuite * inSuite, void * inContext)
+{
+    std::string path = TestPath("compact");
+    unlink(path.c_str());
+
+    constexpr size_t kCompactMinSize = 4096;
+    char value[32];
+
+    {
+        ChipLinuxStorageLog storage(kNoSync, kCompactMinSize);
+        NL_TEST_ASSERT(inSuite, storage.Init(path.c_str()) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, Write(storage, "deleted", "soon gone") == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, storage.ClearValue("deleted") == CHIP_NO_ERROR);
+
+        size_t maxLogSize = 0;
+        for (int i = 0; i < 1000; i++)
+        {
+            snprintf(value, sizeof(value), "value %d", i);
+            NL_TEST_ASSERT(inSuite, Write(storage, (i % 2) ? "odd" : "even", value) == CHIP_NO_ERROR);
+            maxLogSize = std::max(maxLogSize, storage.GetLogSize());
+        }
+
+        // Overwritten values do not make the log grow past the compaction threshold.
+        NL_TEST_ASSERT(inSuite, maxLogSize <= kCompactMinSize + 64);
+        NL_TEST_ASSERT(inSuite, FileSize(path) == storage.GetLogSize());
+
+        NL_TEST_ASSERT(inSuite, storage.Compact() == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, HasValue(storage, "even", "value 998"));
+        NL_TEST_ASSERT(inSuite, HasValue(storage, "odd", "value 999"));
+
+        // Writes after a compaction go to the new file.
+        NL_TEST_ASSERT(inSuite, Write(storage, "after", "compaction") == CHIP_NO_ERROR);
+    }
+
+    ChipLinuxStorageLog storage(kNoSync, kCompactMinSize);
+    NL_TEST_ASSERT(inSuite, storage.Init(path.c_str()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, HasValue(storage, "even", "value 998"));
+    NL_TEST_ASSERT(inSuite, HasValue(storage, "odd", "value 999"));
+    NL_TEST_ASSERT(inSuite, HasValue(storage, "after", "compaction"));
+    NL_TEST_ASSERT(inSuite, IsMissing(storage, "deleted"));
+
+    storage.Shutdown();
+    unlink(path.c_str());
+}
+
+void BenchKey(char (&key)[16], size_t i)
+{
+    snprintf(key, sizeof(key), "key%zu", i % kBenchKeyCount);
+}
+
+void PrintResult(const char * name, uint64_t elapsedUs, uint64_t bytesWritten)
+{
+    printf("  %-28s %8.2f us/write, %7.1fx write amplification\n", name,
+           static_cast<double>(elapsedUs) / static_cast<double>(kBenchWrites),
+           static_cast<double>(bytesWritten) / static_cast<double>(kBenchWrites * kBenchValueLen));
+}
+
+// Writes the benchmark values through the log, in batches of batchSize writes if it is not 0.
+void BenchLog(nlTestSuite * inSuite, const char * name, size_t syncInterval, size_t batchSize = 0)
+{
+    std::string path = TestPath("bench");
+    unlink(path.c_str());
+
+    ChipLinuxStorageLog storage(syncInterval, CHIP_DEVICE_CONFIG_LINUX_KVS_LOG_COMPACT_MIN_SIZE);
+    NL_TEST_ASSERT(inSuite, storage.Init(path.c_str()) == CHIP_NO_ERROR);
+    uint64_t initialBytes = storage.GetBytesWritten();
+
+    uint8_t value[kBenchValueLen];
+    char key[16];
+
+    uint64_t start = System::SystemClock().GetMonotonicMicroseconds64().count();
+    for (size_t i = 0; i < kBenchWrites; i++)
+    {
+        if (batchSize > 0 && i % batchSize == 0)
+        {
+            storage.BeginBatch();
+        }
+        BenchKey(key, i);
+        memset(value, static_cast<int>(i), sizeof(value));
+        NL_TEST_ASSERT(inSuite, storage.WriteValueBin(key, value, sizeof(value)) == CHIP_NO_ERROR);
+        if (batchSize > 0 && (i % batchSize == batchSize - 1 || i == kBenchWrites - 1))
+        {
+            NL_TEST_ASSERT(inSuite, storage.CommitBatch() == CHIP_NO_ERROR);
+        }
+    }
+    uint64_t elapsed = System::SystemClock().GetMonotonicMicroseconds64().count() - start;
+
+    PrintResult(name, elapsed, storage.GetBytesWritten() - initialBytes);
+
+    storage.Shutdown();
+    unlink(path.c_str());
+}
+
+void TestBenchmark(nlTestSuite * inSuite, void * inContext)
+{
+    std::string path = TestPath("bench.ini");
+    unlink(path.c_str());
+
+    uint8_t value[kBenchValueLen];
+    char key[16];
+
+    // The INI backend rewrites the whole file on every commit, as KeyValueStoreManagerImpl::_Put does.
+    ChipLinuxStorage ini;
+    NL_TEST_ASSERT(inSuite, ini.Init(path.c_str()) == CHIP_NO_ERROR);
+
+    uint64_t bytesWritten = 0;
+    uint64_t start        = System::SystemClock().GetMonotonicMicroseconds64().count();
+    for (size_t i = 0; i < kBenchWrites; i++)
+    {
+        BenchKey(key, i);
+        memset(value, static_cast<int>(i), sizeof(value));
+        NL_TEST_ASSERT(inSuite, ini.WriteValueBin(key, value, sizeof(value)) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, ini.Commit() == CHIP_NO_ERROR);
+        bytesWritten += FileSize(path);
+    }
+    uint64_t elapsed = System::SystemClock().GetMonotonicMicroseconds64().count() - start;
+
+    printf("  %zu writes of %zu byte values over %zu keys\n", kBenchWrites, kBenchValueLen, kBenchKeyCount);
+    PrintResult("INI", elapsed, bytesWritten);
+    unlink(path.c_str());
+
+    BenchLog(inSuite, "log, no fdatasync", kNoSync);
+    BenchLog(inSuite, "log, fdatasync every 16", 16);
+    BenchLog(inSuite, "log, fdatasync every write", 1);
+    // A committed batch is flushed with one append and one fdatasync, whatever the sync interval.
+    BenchLog(inSuite, "log, batches of 16 writes", kNoSync, 16);
+}
+
+const nlTest sTests[] = {
+    NL_TEST_DEF("Read, write and delete", TestReadWriteDelete),
+    NL_TEST_DEF("Recovery from torn writes", TestTornWriteRecovery),
+    NL_TEST_DEF("Recovery from corrupted records", TestCorruptedRecord),
+    NL_TEST_DEF("Batches", TestBatches),
+    NL_TEST_DEF("Rejects files of other backends", TestRejectsOtherFiles),
+    NL_TEST_DEF("Compaction", TestCompaction),
+    NL_TEST_DEF("Benchmark against the INI backend", TestBenchmark),
+    NL_TEST_SENTINEL(),
+};
+
+int TestSetup(void * inContext)
+{
+    VerifyOrReturnError(chip::Platform::MemoryInit() == CHIP_NO_ERROR, FAILURE);
+    return SUCCESS;
+}
+
+int TestTeardown(void * inContext)
+{
+    chip::Platform::MemoryShutdown();
+    return SUCCESS;
+}
+
+} // namespace
+
+int TestLinuxStorageLog()
+{
+    nlTestSuite theSuite = { "Linux KVS log", &sTests[0], TestSetup, TestTeardown };
+
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestLinuxStorageLog)
@@ -17,12 +17,15 @@
 
 #include <protocols/secure_channel/CASEServer.h>
 
+#include <crypto/RandUtils.h>
 #include <lib/core/CHIPError.h>
 #include <lib/support/CodeUtils.h>
 #include <lib/support/SafeInt.h>
 #include <lib/support/logging/CHIPLogging.h>
 #include <transport/SessionManager.h>
 
+#include <algorithm>
+
 using namespace ::chip::Inet;
 using namespace ::chip::Transport;
 using namespace ::chip::Credentials;
@@ -45,25 +48,30 @@ CHIP_ERROR CASEServer::ListenForSessionEstablishment(Messaging::ExchangeManager
     mExchangeManager           = exchangeManager;
     mGroupDataProvider         = responderGroupDataProvider;
 
-    // Set up the group state provider that persists across all handshakes.
-    GetSession().SetGroupDataProvider(mGroupDataProvider);
+    for (Responder & responder : mResponders)
+    {
+        responder.Init(*this);
+        // Set up the group state provider that persists across all handshakes.
+        responder.GetSession().SetGroupDataProvider(mGroupDataProvider);
+        // A responder armed by an earlier call must be armed again with the arguments of this one.
+        if (responder.GetState() == Responder::State::kArmed)
+        {
+            responder.Release();
+        }
+    }
 
     ChipLogProgress(Inet, "CASE Server enabling CASE session setups");
     mExchangeManager->RegisterUnsolicitedMessageHandlerForType(Protocols::SecureChannel::MsgType::CASE_Sigma1, this);
 
-    PrepareForSessionEstablishment();
+    ArmNextResponder();
 
     return CHIP_NO_ERROR;
 }
 
-CHIP_ERROR CASEServer::InitCASEHandshake(Messaging::ExchangeContext * ec)
+void CASEServer::SetMaxConcurrentHandshakes(size_t maxHandshakes, size_t maxHandshakesPerFabric)
 {
-    ReturnErrorCodeIf(ec == nullptr, CHIP_ERROR_INVALID_ARGUMENT);
-
-    // Hand over the exchange context to the CASE session.
-    ec->SetDelegate(&GetSession());
-
-    return CHIP_NO_ERROR;
+    mMaxHandshakes          = std::min(std::max(maxHandshakes, static_cast<size_t>(1)), ArraySize(mResponders));
+    mMaxHandshakesPerFabric = std::min(std::max(maxHandshakesPerFabric, static_cast<size_t>(1)), mMaxHandshakes);
 }
 
 CHIP_ERROR CASEServer::OnUnsolicitedMessageReceived(const PayloadHeader & payloadHeader, ExchangeDelegate *& newDelegate)
@@ -76,20 +84,30 @@ CHIP_ERROR CASEServer::OnUnsolicitedMessageReceived(const PayloadHeader & payloa
 CHIP_ERROR CASEServer::OnMessageReceived(Messaging::ExchangeContext * ec, const PayloadHeader & payloadHeader,
                                          System::PacketBufferHandle && payload)
 {
-    if (GetSession().GetState() != CASESession::State::kInitialized)
+    Responder * responder = FindResponder(Responder::State::kArmed);
+    if (responder == nullptr)
     {
-        // We are in the middle of CASE handshake
+        // All the handshakes we allow are in progress
 
         // Invoke watchdog to fix any stuck handshakes
-        bool watchdogFired = GetSession().InvokeBackgroundWorkWatchdog();
-        if (!watchdogFired)
+        bool watchdogFired = false;
+        for (Responder & active : mResponders)
         {
-            // Handshake wasn't stuck, send the busy status report and let the existing handshake continue.
+            if (active.GetState() == Responder::State::kActive && active.GetSession().InvokeBackgroundWorkWatchdog())
+            {
+                watchdogFired = true;
+            }
+        }
+        if (watchdogFired)
+        {
+            ArmNextResponder();
+            responder = FindResponder(Responder::State::kArmed);
+        }
 
-            // A successful CASE handshake can take several seconds and some may time out (30 seconds or more).
-            // TODO: Come up with better estimate: https://github.com/project-chip/connectedhomeip/issues/28288
-            // For now, setting minimum wait time to 5000 milliseconds.
-            CHIP_ERROR err = SendBusyStatusReport(ec, System::Clock::Milliseconds16(5000));
+        if (responder == nullptr)
+        {
+            // No handshake was stuck, send the busy status report and let the existing handshakes continue.
+            CHIP_ERROR err = SendBusyStatusReport(ec, BusyWaitTime());
             if (err != CHIP_NO_ERROR)
             {
                 ChipLogError(Inet, "Failed to send the busy status report, err:%" CHIP_ERROR_FORMAT, err.Format());
@@ -106,24 +124,83 @@ CHIP_ERROR CASEServer::OnMessageReceived(Messaging::ExchangeContext * ec, const
 
     ChipLogProgress(Inet, "CASE Server received Sigma1 message %s EC %p", ". Starting handshake.", ec);
 
-    CHIP_ERROR err = InitCASEHandshake(ec);
-    SuccessOrExit(err);
-
-    // TODO - Enable multiple concurrent CASE session establishment
-    // https://github.com/project-chip/connectedhomeip/issues/8342
-
-    err = GetSession().OnMessageReceived(ec, payloadHeader, std::move(payload));
-    SuccessOrExit(err);
+    // Hand over the exchange context to the CASE session.
+    ec->SetDelegate(&responder->GetSession());
+    responder->SetActive();
 
-exit:
     // CASESession::OnMessageReceived guarantees that it will call
     // OnSessionEstablishmentError if it returns error, so nothing else to do here.
+    CHIP_ERROR err = responder->GetSession().OnMessageReceived(ec, payloadHeader, std::move(payload));
+
+    // Get ready for the next Sigma1 while this handshake goes on.
+    ArmNextResponder();
+
     return err;
 }
 
-void CASEServer::PrepareForSessionEstablishment(const ScopedNodeId & previouslyEstablishedPeer)
+CASEServer::Responder * CASEServer::FindResponder(Responder::State state)
 {
-    GetSession().Clear();
+    for (Responder & responder : mResponders)
+    {
+        if (responder.GetState() == state)
+        {
+            return &responder;
+        }
+    }
+    return nullptr;
+}
+
+size_t CASEServer::CountActiveHandshakes(FabricIndex fabricIndex) const
+{
+    size_t count = 0;
+    for (const Responder & responder : mResponders)
+    {
+        if (responder.GetState() == Responder::State::kActive &&
+            (fabricIndex == kUndefinedFabricIndex || responder.GetFabricIndex() == fabricIndex))
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+void CASEServer::ArmNextResponder()
+{
+    VerifyOrReturn(mExchangeManager != nullptr);
+    VerifyOrReturn(FindResponder(Responder::State::kArmed) == nullptr);
+    VerifyOrReturn(CountActiveHandshakes() < mMaxHandshakes);
+
+    Responder * responder = FindResponder(Responder::State::kIdle);
+    VerifyOrReturn(responder != nullptr);
+    responder->Arm();
+}
+
+void CASEServer::OnHandshakeDone(Responder & responder, const ScopedNodeId & previouslyEstablishedPeer)
+{
+    Responder * armed = FindResponder(Responder::State::kArmed);
+    if (armed == nullptr || armed == &responder)
+    {
+        responder.Arm(previouslyEstablishedPeer);
+    }
+    else
+    {
+        responder.Release();
+    }
+}
+
+System::Clock::Milliseconds16 CASEServer::BusyWaitTime() const
+{
+    // A successful CASE handshake can take several seconds and some may time out (30 seconds or more).
+    // TODO: Come up with better estimate: https://github.com/project-chip/connectedhomeip/issues/28288
+    // For now, setting minimum wait time to 5000 milliseconds, plus up to 5000 milliseconds of jitter.
+    constexpr uint16_t kBaseWaitTimeMs = 5000;
+    constexpr uint16_t kJitterMs       = 5000;
+    return System::Clock::Milliseconds16(static_cast<uint16_t>(kBaseWaitTimeMs + Crypto::GetRandU16() % kJitterMs));
+}
+
+void CASEServer::Responder::Arm(const ScopedNodeId & previouslyEstablishedPeer)
+{
+    mPairingSession.Clear();
 
     //
     // This releases our reference to a previously pinned session. If that was a successfully established session and is now
@@ -152,9 +229,10 @@ void CASEServer::PrepareForSessionEstablishment(const ScopedNodeId & previouslyE
     // TODO(#17568): Once session eviction is actually in place, this call should NEVER fail and if so, is a logic bug.
     // Dying here on failure is even more appropriate then.
     //
-    VerifyOrDie(GetSession().PrepareForSessionEstablishment(*mSessionManager, mFabrics, mSessionResumptionStorage,
-                                                            mCertificateValidityPolicy, this, previouslyEstablishedPeer,
-                                                            GetLocalMRPConfig()) == CHIP_NO_ERROR);
+    VerifyOrDie(mPairingSession.PrepareForSessionEstablishment(*mServer->mSessionManager, mServer->mFabrics,
+                                                               mServer->mSessionResumptionStorage,
+                                                               mServer->mCertificateValidityPolicy, this, previouslyEstablishedPeer,
+                                                               GetLocalMRPConfig()) == CHIP_NO_ERROR);
 
     //
     // PairingSession::mSecureSessionHolder is a weak-reference. If MarkForEviction is called on this session, the session is
@@ -166,32 +244,53 @@ void CASEServer::PrepareForSessionEstablishment(const ScopedNodeId & previouslyE
     //
     // Let's create a SessionHandle strong-reference to it to keep it resident.
     //
-    mPinnedSecureSession = GetSession().CopySecureSession();
+    mPinnedSecureSession = mPairingSession.CopySecureSession();
 
     //
     // If we've gotten this far, it means we have successfully allocated a SecureSession to back our next attempt. If we haven't,
     // there is a bug somewhere and we should raise attention to it by dying.
     //
     VerifyOrDie(mPinnedSecureSession.HasValue());
+
+    mState = State::kArmed;
+}
+
+void CASEServer::Responder::Release()
+{
+    mPairingSession.Clear();
+    mPinnedSecureSession.ClearValue();
+    mState = State::kIdle;
 }
 
-void CASEServer::OnSessionEstablishmentError(CHIP_ERROR err)
+void CASEServer::Responder::OnSessionEstablishmentError(CHIP_ERROR err)
 {
     ChipLogError(Inet, "CASE Session establishment failed: %" CHIP_ERROR_FORMAT, err.Format());
 
-    PrepareForSessionEstablishment();
+    mServer->OnHandshakeDone(*this);
 }
 
-void CASEServer::OnSessionEstablished(const SessionHandle & session)
+void CASEServer::Responder::OnSessionEstablished(const SessionHandle & session)
 {
     ChipLogProgress(Inet, "CASE Session established to peer: " ChipLogFormatScopedNodeId,
                     ChipLogValueScopedNodeId(session->GetPeer()));
-    PrepareForSessionEstablishment(session->GetPeer());
+    mServer->OnHandshakeDone(*this, session->GetPeer());
+}
+
+bool CASEServer::Responder::ShouldAcceptSessionEstablishment(FabricIndex fabricIndex, System::Clock::Milliseconds16 & busyWaitTime)
+{
+    // This handshake is already counted as active.
+    if (mServer->CountActiveHandshakes(fabricIndex) <= mServer->mMaxHandshakesPerFabric)
+    {
+        return true;
+    }
+
+    busyWaitTime = mServer->BusyWaitTime();
+    return false;
 }
 
 CHIP_ERROR CASEServer::SendBusyStatusReport(Messaging::ExchangeContext * ec, System::Clock::Milliseconds16 minimumWaitTime)
 {
-    ChipLogProgress(Inet, "Already in the middle of CASE handshake, sending busy status report");
+    ChipLogProgress(Inet, "Too many CASE handshakes in progress, sending busy status report");
 
     System::PacketBufferHandle handle = Protocols::SecureChannel::StatusReport::MakeBusyStatusReportMessage(minimumWaitTime);
     VerifyOrReturnError(!handle.IsNull(), CHIP_ERROR_NO_MEMORY);
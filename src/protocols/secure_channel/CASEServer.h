@@ -26,18 +26,16 @@
 
 namespace chip {
 
-class CASEServer : public SessionEstablishmentDelegate,
-                   public Messaging::UnsolicitedMessageHandler,
-                   public Messaging::ExchangeDelegate
+class CASEServer : public Messaging::UnsolicitedMessageHandler, public Messaging::ExchangeDelegate
 {
 public:
     CASEServer() {}
     ~CASEServer() override { Shutdown(); }
 
     /*
-     * This method will shutdown this object, releasing the strong reference to the pinned SecureSession object.
-     * It will also unregister the unsolicited handler and clear out the session object (which will release the weak
-     * reference through the underlying SessionHolder).
+     * This method will shutdown this object, releasing the strong references to the pinned SecureSession objects.
+     * It will also unregister the unsolicited handler and clear out the session objects (which will release the weak
+     * references through the underlying SessionHolders).
      *
      */
     void Shutdown()
@@ -48,8 +46,10 @@ public:
             mExchangeManager = nullptr;
         }
 
-        GetSession().Clear();
-        mPinnedSecureSession.ClearValue();
+        for (Responder & responder : mResponders)
+        {
+            responder.Release();
+        }
     }
 
     CHIP_ERROR ListenForSessionEstablishment(Messaging::ExchangeManager * exchangeManager, SessionManager * sessionManager,
@@ -57,9 +57,13 @@ public:
                                              Credentials::CertificateValidityPolicy * policy,
                                              Credentials::GroupDataProvider * responderGroupDataProvider);
 
-    //////////// SessionEstablishmentDelegate Implementation ///////////////
-    void OnSessionEstablishmentError(CHIP_ERROR error) override;
-    void OnSessionEstablished(const SessionHandle & session) override;
+    /*
+     * Limit the number of handshakes handled at the same time to maxHandshakes, which is clamped to
+     * [1, CHIP_CONFIG_CASE_SERVER_MAX_CONCURRENT_HANDSHAKES], and the number of them that may be for the same fabric to
+     * maxHandshakesPerFabric, clamped to [1, maxHandshakes]. Handshakes already in progress are not affected.
+     */
+    void SetMaxConcurrentHandshakes(size_t maxHandshakes,
+                                    size_t maxHandshakesPerFabric = CHIP_CONFIG_CASE_SERVER_MAX_HANDSHAKES_PER_FABRIC);
 
     //// UnsolicitedMessageHandler Implementation ////
     CHIP_ERROR OnUnsolicitedMessageReceived(const PayloadHeader & payloadHeader, ExchangeDelegate *& newDelegate) override;
@@ -68,48 +72,100 @@ public:
     CHIP_ERROR OnMessageReceived(Messaging::ExchangeContext * ec, const PayloadHeader & payloadHeader,
                                  System::PacketBufferHandle && payload) override;
     void OnResponseTimeout(Messaging::ExchangeContext * ec) override {}
-    Messaging::ExchangeMessageDispatch & GetMessageDispatch() override { return GetSession().GetMessageDispatch(); }
-
-    CASESession & GetSession() { return mPairingSession; }
+    Messaging::ExchangeMessageDispatch & GetMessageDispatch() override { return SessionEstablishmentExchangeDispatch::Instance(); }
 
 private:
+    //
+    // One responder side of a CASE handshake. At most one responder is armed, i.e. ready for the next Sigma1 with a
+    // SecureSession already allocated; the others are either running a handshake (active) or idle.
+    //
+    class Responder : public SessionEstablishmentDelegate
+    {
+    public:
+        enum class State : uint8_t
+        {
+            kIdle,
+            kArmed,
+            kActive,
+        };
+
+        void Init(CASEServer & server) { mServer = &server; }
+
+        CASESession & GetSession() { return mPairingSession; }
+        FabricIndex GetFabricIndex() const { return mPairingSession.GetFabricIndex(); }
+        State GetState() const { return mState; }
+        void SetActive() { mState = State::kActive; }
+
+        /*
+         * This will clean up any state from a previous session establishment
+         * attempt (if any) and setup the machinery to listen for and handle
+         * the next session handshake.
+         *
+         * If a session had previously been established successfully, previouslyEstablishedPeer
+         * should be set to the scoped node-id of the peer associated with that session.
+         *
+         */
+        void Arm(const ScopedNodeId & previouslyEstablishedPeer = ScopedNodeId());
+
+        /*
+         * Clean up any state from a previous session establishment attempt and go idle.
+         */
+        void Release();
+
+        //////////// SessionEstablishmentDelegate Implementation ///////////////
+        void OnSessionEstablishmentError(CHIP_ERROR error) override;
+        void OnSessionEstablished(const SessionHandle & session) override;
+        bool ShouldAcceptSessionEstablishment(FabricIndex fabricIndex, System::Clock::Milliseconds16 & busyWaitTime) override;
+
+    private:
+        CASEServer * mServer = nullptr;
+        State mState         = State::kIdle;
+
+        //
+        // When we're in the process of establishing a session, this is used
+        // to maintain an additional, strong reference to the underlying SecureSession.
+        // This is because the existing reference in PairingSession is a weak one
+        // (i.e a SessionHolder) and can lose its reference if the session is evicted
+        // for any reason.
+        //
+        // This initially points to a session that is not yet active. Upon activation, it
+        // transfers ownership of the session to the SecureSessionManager and this reference
+        // is released before simultaneously acquiring ownership of a new SecureSession.
+        //
+        Optional<SessionHandle> mPinnedSecureSession;
+
+        CASESession mPairingSession;
+    };
+
     Messaging::ExchangeManager * mExchangeManager                       = nullptr;
     SessionResumptionStorage * mSessionResumptionStorage                = nullptr;
     Credentials::CertificateValidityPolicy * mCertificateValidityPolicy = nullptr;
 
-    //
-    // When we're in the process of establishing a session, this is used
-    // to maintain an additional, strong reference to the underlying SecureSession.
-    // This is because the existing reference in PairingSession is a weak one
-    // (i.e a SessionHolder) and can lose its reference if the session is evicted
-    // for any reason.
-    //
-    // This initially points to a session that is not yet active. Upon activation, it
-    // transfers ownership of the session to the SecureSessionManager and this reference
-    // is released before simultaneously acquiring ownership of a new SecureSession.
-    //
-    Optional<SessionHandle> mPinnedSecureSession;
+    Responder mResponders[CHIP_CONFIG_CASE_SERVER_MAX_CONCURRENT_HANDSHAKES];
+    size_t mMaxHandshakes          = CHIP_CONFIG_CASE_SERVER_MAX_CONCURRENT_HANDSHAKES;
+    size_t mMaxHandshakesPerFabric = CHIP_CONFIG_CASE_SERVER_MAX_HANDSHAKES_PER_FABRIC;
 
-    CASESession mPairingSession;
     SessionManager * mSessionManager = nullptr;
 
     FabricTable * mFabrics                              = nullptr;
     Credentials::GroupDataProvider * mGroupDataProvider = nullptr;
 
-    CHIP_ERROR InitCASEHandshake(Messaging::ExchangeContext * ec);
+    Responder * FindResponder(Responder::State state);
 
-    /*
-     * This will clean up any state from a previous session establishment
-     * attempt (if any) and setup the machinery to listen for and handle
-     * any session handshakes there-after.
-     *
-     * If a session had previously been established successfully, previouslyEstablishedPeer
-     * should be set to the scoped node-id of the peer associated with that session.
-     *
-     */
-    void PrepareForSessionEstablishment(const ScopedNodeId & previouslyEstablishedPeer = ScopedNodeId());
+    // Count the handshakes in progress, either all of them or only those on fabricIndex.
+    size_t CountActiveHandshakes(FabricIndex fabricIndex = kUndefinedFabricIndex) const;
+
+    // Arm an idle responder for the next handshake, unless one is armed already or the handshake limit is reached.
+    void ArmNextResponder();
+
+    // Called by a responder when its handshake is over: it stays armed for the next one unless another responder is.
+    void OnHandshakeDone(Responder & responder, const ScopedNodeId & previouslyEstablishedPeer = ScopedNodeId());
+
+    // Wait time reported to initiators that are turned away. It is randomized so that initiators rejected at the
+    // same time do not all retry at the same time.
+    System::Clock::Milliseconds16 BusyWaitTime() const;
 
-    // If we are in the middle of handshake and receive a Sigma1 then respond with Busy status code.
+    // If all the handshake slots are in use and we receive a Sigma1 then respond with Busy status code.
     // @param[in] ec              Exchange Context
     // @param[in] minimumWaitTime Minimum wait time reported to client before it can attempt to resend sigma1
     //
@@ -41,6 +41,7 @@
 #include <protocols/Protocols.h>
 #include <protocols/secure_channel/CASEDestinationId.h>
 #include <protocols/secure_channel/PairingSession.h>
+#include <protocols/secure_channel/PairingSessionWorkHelper.h>
 #include <protocols/secure_channel/SessionResumptionStorage.h>
 #include <protocols/secure_channel/StatusReport.h>
 #include <system/SystemClock.h>
@@ -129,203 +130,118 @@ static constexpr ExchangeContext::Timeout kExpectedLowProcessingTime    = System
 static constexpr ExchangeContext::Timeout kExpectedSigma1ProcessingTime = kExpectedLowProcessingTime;
 static constexpr ExchangeContext::Timeout kExpectedHighProcessingTime   = System::Clock::Seconds16(30);
 
-// Helper for managing a session's outstanding work.
-// Holds work data which is provided to a scheduled work callback (standalone),
-// then (if not canceled) to a scheduled after work callback (on the session).
-template <class DATA>
-class CASESession::WorkHelper
+namespace {
+
+// Holds a session's ephemeral keypair while background work uses it.
+// The session's own pointer is cleared for the duration, so that clearing the session cannot release
+// the keypair out from under the worker. If the work is canceled, the keypair is released along with
+// the work data, possibly from the worker.
+class EphemeralKeypairLoan
 {
 public:
-    // Work callback, processed in the background via `PlatformManager::ScheduleBackgroundWork`.
-    // This is a non-member function which does not use the associated session.
-    // The return value is passed to the after work callback (called afterward).
-    // Set `cancel` to true if calling the after work callback is not necessary.
-    typedef CHIP_ERROR (*WorkCallback)(DATA & data, bool & cancel);
-
-    // After work callback, processed in the main Matter task via `PlatformManager::ScheduleWork`.
-    // This is a member function to be called on the associated session after the work callback.
-    // The `status` value is the result of the work callback (called beforehand), or the status of
-    // queueing the after work callback back to the Matter thread, if the work callback succeeds
-    // but queueing fails.
-    //
-    // When this callback is called asynchronously (i.e. via ScheduleWork), the helper guarantees
-    // that it will keep itself (and hence `data`) alive until the callback completes.
-    typedef CHIP_ERROR (CASESession::*AfterWorkCallback)(DATA & data, CHIP_ERROR status);
+    ~EphemeralKeypairLoan() { Release(); }
 
-public:
-    // Create a work helper using the specified session, work callback, after work callback, and data (template arg).
-    // Lifetime is managed by sharing between the caller (typically the session) and the helper itself (while work is scheduled).
-    static Platform::SharedPtr<WorkHelper> Create(CASESession & session, WorkCallback workCallback,
-                                                  AfterWorkCallback afterWorkCallback)
+    void Lend(FabricTable & fabricTable, P256Keypair *& keypair)
     {
-        struct EnableShared : public WorkHelper
-        {
-            EnableShared(CASESession & session, WorkCallback workCallback, AfterWorkCallback afterWorkCallback) :
-                WorkHelper(session, workCallback, afterWorkCallback)
-            {}
-        };
-        auto ptr = Platform::MakeShared<EnableShared>(session, workCallback, afterWorkCallback);
-        if (ptr)
-        {
-            ptr->mWeakPtr = ptr; // used by `ScheduleWork`
-        }
-        return ptr;
+        Release();
+        mFabricTable = &fabricTable;
+        mKeypair     = keypair;
+        keypair      = nullptr;
     }
 
-    // Do the work immediately.
-    // No scheduling, no outstanding work, no shared lifetime management.
-    //
-    // The caller must guarantee that it keeps the helper alive across this call, most likely by
-    // holding a reference to it on the stack.
-    CHIP_ERROR DoWork()
+    P256Keypair * Return()
     {
-        // Ensure that this function is being called from main Matter thread
-        assertChipStackLockedByCurrentThread();
-
-        VerifyOrReturnError(mSession && mWorkCallback && mAfterWorkCallback, CHIP_ERROR_INCORRECT_STATE);
-        auto * helper   = this;
-        bool cancel     = false;
-        helper->mStatus = helper->mWorkCallback(helper->mData, cancel);
-        if (!cancel)
-        {
-            helper->mStatus = (helper->mSession->*(helper->mAfterWorkCallback))(helper->mData, helper->mStatus);
-        }
-        return helper->mStatus;
+        P256Keypair * keypair = mKeypair;
+        mKeypair              = nullptr;
+        mFabricTable          = nullptr;
+        return keypair;
     }
 
-    // Schedule the work for later execution.
-    // If lifetime is managed, the helper shares management while work is outstanding.
-    CHIP_ERROR ScheduleWork()
+    P256Keypair * Get() const { return mKeypair; }
+
+private:
+    void Release()
     {
-        VerifyOrReturnError(mSession && mWorkCallback && mAfterWorkCallback, CHIP_ERROR_INCORRECT_STATE);
-        // Hold strong ptr while work is outstanding
-        mStrongPtr  = mWeakPtr.lock(); // set in `Create`
-        auto status = DeviceLayer::PlatformMgr().ScheduleBackgroundWork(WorkHandler, reinterpret_cast<intptr_t>(this));
-        if (status != CHIP_NO_ERROR)
+        if (mKeypair != nullptr)
         {
-            // Release strong ptr since scheduling failed.
-            mStrongPtr.reset();
+            mFabricTable->ReleaseEphemeralKeypair(mKeypair);
         }
-        return status;
+        mKeypair     = nullptr;
+        mFabricTable = nullptr;
     }
 
-    // Cancel the work, by clearing the associated session.
-    void CancelWork() { mSession.store(nullptr); }
+    FabricTable * mFabricTable = nullptr;
+    P256Keypair * mKeypair     = nullptr;
+};
 
-    bool IsCancelled() const { return mSession.load() == nullptr; }
+} // namespace
 
-    // This API returns true when background thread fails to schedule the AfterWorkCallback
-    bool UnableToScheduleAfterWorkCallback() { return mScheduleAfterWorkFailed.load(); }
+struct CASESession::SendSigma2Data
+{
+    FabricIndex fabricIndex;
 
-    // Do after work immediately.
-    // No scheduling, no outstanding work, no shared lifetime management.
-    void DoAfterWork()
-    {
-        VerifyOrDie(UnableToScheduleAfterWorkCallback());
-        AfterWorkHandler(reinterpret_cast<intptr_t>(this));
-    }
+    // Use one or the other
+    const FabricTable * fabricTable;
+    const Crypto::OperationalKeystore * keystore;
 
-private:
-    // Create a work helper using the specified session, work callback, after work callback, and data (template arg).
-    // Lifetime is not managed, see `Create` for that option.
-    WorkHelper(CASESession & session, WorkCallback workCallback, AfterWorkCallback afterWorkCallback) :
-        mSession(&session), mWorkCallback(workCallback), mAfterWorkCallback(afterWorkCallback)
-    {}
-
-    // Handler for the work callback.
-    static void WorkHandler(intptr_t arg)
-    {
-        auto * helper = reinterpret_cast<WorkHelper *>(arg);
-        // Hold strong ptr while work is handled
-        auto strongPtr(std::move(helper->mStrongPtr));
-        VerifyOrReturn(!helper->IsCancelled());
-        bool cancel = false;
-        // Execute callback in background thread; data must be OK with this
-        helper->mStatus = helper->mWorkCallback(helper->mData, cancel);
-        VerifyOrReturn(!cancel && !helper->IsCancelled());
-        // Hold strong ptr to ourselves while work is outstanding
-        helper->mStrongPtr.swap(strongPtr);
-        auto status = DeviceLayer::PlatformMgr().ScheduleWork(AfterWorkHandler, reinterpret_cast<intptr_t>(helper));
-        if (status != CHIP_NO_ERROR)
-        {
-            ChipLogError(SecureChannel, "Failed to Schedule the AfterWorkCallback on foreground thread: %" CHIP_ERROR_FORMAT,
-                         status.Format());
-
-            // We failed to schedule after work callback, so setting mScheduleAfterWorkFailed flag to true
-            // This can be checked from foreground thread and after work callback can be retried
-            helper->mStatus = status;
-
-            // Release strong ptr to self since scheduling failed, because nothing guarantees
-            // that AfterWorkHandler will get called at this point to release the reference,
-            // and we don't want to leak.  That said, we want to ensure that "helper" stays
-            // alive through the end of this function (so we can set mScheduleAfterWorkFailed
-            // on it), but also want to avoid racing on the single SharedPtr instance in
-            // helper->mStrongPtr.  That means we need to not touch helper->mStrongPtr after
-            // writing to mScheduleAfterWorkFailed.
-            //
-            // The simplest way to do this is to move the reference in helper->mStrongPtr to
-            // our stack, where it outlives all our accesses to "helper".
-            strongPtr.swap(helper->mStrongPtr);
-
-            // helper and any of its state should not be touched after storing mScheduleAfterWorkFailed.
-            helper->mScheduleAfterWorkFailed.store(true);
-        }
-    }
+    // Set when the ephemeral keypair is generated in the background, along with the ECDH.
+    EphemeralKeypairLoan ephemeralKey;
+    P256PublicKey remotePubKey;
+    P256ECDHDerivedSecret sharedSecret;
 
-    // Handler for the after work callback.
-    static void AfterWorkHandler(intptr_t arg)
-    {
-        // Ensure that this function is being called from main Matter thread
-        assertChipStackLockedByCurrentThread();
+    // Whether the work was scheduled, rather than done immediately.
+    bool background;
 
-        auto * helper = reinterpret_cast<WorkHelper *>(arg);
-        // Hold strong ptr while work is handled, and ensure that helper->mStrongPtr does not keep
-        // holding a reference.
-        auto strongPtr(std::move(helper->mStrongPtr));
-        if (!strongPtr)
-        {
-            // This can happen if scheduling AfterWorkHandler failed.  Just grab a strong ref
-            // to handler directly, to fulfill our API contract of holding a strong reference
-            // across the after-work callback.  At this point, we are guaranteed that the
-            // background thread is not touching the helper anymore.
-            strongPtr = helper->mWeakPtr.lock();
-        }
-        if (auto * session = helper->mSession.load())
-        {
-            // Execute callback in Matter thread; session should be OK with this
-            (session->*(helper->mAfterWorkCallback))(helper->mData, helper->mStatus);
-        }
-    }
+    uint8_t msg_rand[kSigmaParamRandomNumberSize];
+    SessionResumptionStorage::ResumptionIdStorage resumptionId;
 
-private:
-    // Lifetime management: `ScheduleWork` sets `mStrongPtr` from `mWeakPtr`.
-    Platform::WeakPtr<WorkHelper> mWeakPtr;
+    chip::Platform::ScopedMemoryBuffer<uint8_t> msg_R2_Signed;
+    size_t msg_r2_signed_len;
+
+    chip::Platform::ScopedMemoryBuffer<uint8_t> msg_R2_Encrypted;
+    size_t msg_r2_encrypted_len;
+
+    chip::Platform::ScopedMemoryBuffer<uint8_t> icacBuf;
+    MutableByteSpan icaCert;
 
-    // Lifetime management: `ScheduleWork` sets `mStrongPtr` from `mWeakPtr`.
-    Platform::SharedPtr<WorkHelper> mStrongPtr;
+    chip::Platform::ScopedMemoryBuffer<uint8_t> nocBuf;
+    MutableByteSpan nocCert;
 
-    // Associated session, cleared by `CancelWork`.
-    std::atomic<CASESession *> mSession;
+    P256ECDSASignature tbsData2Signature;
+};
 
-    // Work callback, called by `WorkHandler`.
-    WorkCallback mWorkCallback;
+struct CASESession::HandleSigma2Data
+{
+    // Set when the ECDH is done in the background.
+    EphemeralKeypairLoan ephemeralKey;
+    P256PublicKey remotePubKey;
+    P256ECDHDerivedSecret sharedSecret;
 
-    // After work callback, called by `AfterWorkHandler`.
-    AfterWorkCallback mAfterWorkCallback;
+    // Whether the ECDH work was scheduled, rather than done immediately.
+    bool background;
 
-    // Return value of `mWorkCallback`, passed to `mAfterWorkCallback`.
-    CHIP_ERROR mStatus;
+    uint8_t msg_salt[kIPKSize + kSigmaParamRandomNumberSize + kP256_PublicKey_Length + kSHA256_Hash_Length];
+    size_t msg_salt_len;
 
-    // If background thread fails to schedule AfterWorkCallback then this flag is set to true
-    // and CASEServer then can check this one and run the AfterWorkCallback for us.
-    //
-    // When this happens, the write to this boolean _must_ be the last code that touches this
-    // object on the background thread.  After that, the Matter thread owns the object.
-    std::atomic<bool> mScheduleAfterWorkFailed{ false };
+    chip::Platform::ScopedMemoryBuffer<uint8_t> msg_R2_Encrypted;
+    size_t msg_r2_encrypted_len;
 
-public:
-    // Data passed to `mWorkCallback` and `mAfterWorkCallback`.
-    DATA mData;
+    chip::Platform::ScopedMemoryBuffer<uint8_t> msg_R2_Signed;
+    size_t msg_r2_signed_len;
+
+    ByteSpan responderNOC;
+    ByteSpan responderICAC;
+
+    uint8_t rootCertBuf[kMaxCHIPCertLength];
+    ByteSpan fabricRCAC;
+
+    P256ECDSASignature tbsData2Signature;
+    SessionResumptionStorage::ResumptionIdStorage resumptionId;
+
+    FabricId fabricId;
+    NodeId peerNodeId;
+
+    ValidationContext validContext;
 };
 
 struct CASESession::SendSigma3Data
@@ -386,6 +302,16 @@ void CASESession::OnSessionReleased()
 void CASESession::Clear()
 {
     // Cancel any outstanding work.
+    if (mSendSigma2Helper)
+    {
+        mSendSigma2Helper->CancelWork();
+        mSendSigma2Helper.reset();
+    }
+    if (mHandleSigma2Helper)
+    {
+        mHandleSigma2Helper->CancelWork();
+        mHandleSigma2Helper.reset();
+    }
     if (mSendSigma3Helper)
     {
         mSendSigma3Helper->CancelWork();
@@ -864,6 +790,8 @@ CHIP_ERROR CASESession::HandleSigma1(System::PacketBufferHandle && msg)
         std::copy(initiatorRandom.begin(), initiatorRandom.end(), mInitiatorRandom);
         std::copy(resumptionId.begin(), resumptionId.end(), mResumeResumptionId.begin());
 
+        SuccessOrExit(err = CheckResponderCanAccept());
+
         // Send Sigma2Resume message to the initiator
         SuccessOrExit(err = SendSigma2Resume());
 
@@ -894,7 +822,9 @@ CHIP_ERROR CASESession::HandleSigma1(System::PacketBufferHandle && msg)
     // mRemotePubKey.Length() == initiatorPubKey.size() == kP256_PublicKey_Length.
     memcpy(mRemotePubKey.Bytes(), initiatorPubKey.data(), mRemotePubKey.Length());
 
-    SuccessOrExit(err = SendSigma2());
+    SuccessOrExit(err = CheckResponderCanAccept());
+
+    SuccessOrExit(err = SendSigma2a());
 
     mDelegate->OnSessionEstablishmentStarted();
 
@@ -905,6 +835,11 @@ exit:
         SendStatusReport(mExchangeCtxt, kProtocolCodeNoSharedRoot);
         mState = State::kInitialized;
     }
+    else if (err == CHIP_ERROR_BUSY)
+    {
+        // CheckResponderCanAccept already sent the busy status report.
+        mState = State::kInitialized;
+    }
     else if (err != CHIP_NO_ERROR)
     {
         SendStatusReport(mExchangeCtxt, kProtocolCodeInvalidParam);
@@ -913,6 +848,27 @@ exit:
     return err;
 }
 
+CHIP_ERROR CASESession::CheckResponderCanAccept()
+{
+    System::Clock::Milliseconds16 busyWaitTime(0);
+    if (mDelegate->ShouldAcceptSessionEstablishment(mFabricIndex, busyWaitTime))
+    {
+        return CHIP_NO_ERROR;
+    }
+
+    ChipLogProgress(SecureChannel, "Too many CASE handshakes in progress for fabric %u, sending busy status report",
+                    static_cast<unsigned>(mFabricIndex));
+
+    System::PacketBufferHandle msg = Protocols::SecureChannel::StatusReport::MakeBusyStatusReportMessage(busyWaitTime);
+    VerifyOrReturnError(!msg.IsNull(), CHIP_ERROR_NO_MEMORY);
+    CHIP_ERROR err = mExchangeCtxt->SendMessage(Protocols::SecureChannel::MsgType::StatusReport, std::move(msg));
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(SecureChannel, "Failed to send busy status report: %" CHIP_ERROR_FORMAT, err.Format());
+    }
+    return CHIP_ERROR_BUSY;
+}
+
 CHIP_ERROR CASESession::SendSigma2Resume()
 {
     MATTER_TRACE_SCOPE("SendSigma2Resume", "CASESession");
@@ -968,143 +924,276 @@ CHIP_ERROR CASESession::SendSigma2Resume()
     return CHIP_NO_ERROR;
 }
 
-CHIP_ERROR CASESession::SendSigma2()
+CHIP_ERROR CASESession::SendSigma2a()
 {
     MATTER_TRACE_SCOPE("SendSigma2", "CASESession");
 
     VerifyOrReturnError(GetLocalSessionId().HasValue(), CHIP_ERROR_INCORRECT_STATE);
     VerifyOrReturnError(mFabricsTable != nullptr, CHIP_ERROR_INCORRECT_STATE);
 
-    chip::Platform::ScopedMemoryBuffer<uint8_t> icacBuf;
-    VerifyOrReturnError(icacBuf.Alloc(kMaxCHIPCertLength), CHIP_ERROR_NO_MEMORY);
+    auto helper = WorkHelper<SendSigma2Data>::Create(*this, &SendSigma2b, &CASESession::SendSigma2c);
+    VerifyOrReturnError(helper, CHIP_ERROR_NO_MEMORY);
+    auto & data = helper->mData;
 
-    chip::Platform::ScopedMemoryBuffer<uint8_t> nocBuf;
-    VerifyOrReturnError(nocBuf.Alloc(kMaxCHIPCertLength), CHIP_ERROR_NO_MEMORY);
+    data.fabricIndex = mFabricIndex;
+    data.fabricTable = nullptr;
+    data.keystore    = nullptr;
+    data.background  = false;
+
+    {
+        const FabricInfo * fabricInfo = mFabricsTable->FindFabricWithIndex(mFabricIndex);
+        VerifyOrReturnError(fabricInfo != nullptr, CHIP_ERROR_KEY_NOT_FOUND);
+        auto * keystore = mFabricsTable->GetOperationalKeystore();
+        if (!fabricInfo->HasOperationalKey() && keystore != nullptr && keystore->SupportsSignWithOpKeypairInBackground())
+        {
+            // NOTE: used to sign in background.
+            data.keystore = keystore;
+        }
+        else
+        {
+            // NOTE: used to sign in foreground.
+            data.fabricTable = mFabricsTable;
+        }
+    }
+
+    VerifyOrReturnError(data.icacBuf.Alloc(kMaxCHIPCertLength), CHIP_ERROR_NO_MEMORY);
+    data.icaCert = MutableByteSpan{ data.icacBuf.Get(), kMaxCHIPCertLength };
 
-    MutableByteSpan icaCert{ icacBuf.Get(), kMaxCHIPCertLength };
-    ReturnErrorOnFailure(mFabricsTable->FetchICACert(mFabricIndex, icaCert));
+    VerifyOrReturnError(data.nocBuf.Alloc(kMaxCHIPCertLength), CHIP_ERROR_NO_MEMORY);
+    data.nocCert = MutableByteSpan{ data.nocBuf.Get(), kMaxCHIPCertLength };
 
-    MutableByteSpan nocCert{ nocBuf.Get(), kMaxCHIPCertLength };
-    ReturnErrorOnFailure(mFabricsTable->FetchNOCCert(mFabricIndex, nocCert));
+    ReturnErrorOnFailure(mFabricsTable->FetchICACert(mFabricIndex, data.icaCert));
+    ReturnErrorOnFailure(mFabricsTable->FetchNOCCert(mFabricIndex, data.nocCert));
 
     // Fill in the random value
-    uint8_t msg_rand[kSigmaParamRandomNumberSize];
-    ReturnErrorOnFailure(DRBG_get_bytes(&msg_rand[0], sizeof(msg_rand)));
+    ReturnErrorOnFailure(DRBG_get_bytes(&data.msg_rand[0], sizeof(data.msg_rand)));
+
+    // Generate a new resumption ID
+    ReturnErrorOnFailure(DRBG_get_bytes(mNewResumptionId.data(), mNewResumptionId.size()));
+    data.resumptionId = mNewResumptionId;
+
+    data.msg_r2_signed_len =
+        TLV::EstimateStructOverhead(kMaxCHIPCertLength, kMaxCHIPCertLength, kP256_PublicKey_Length, kP256_PublicKey_Length);
+
+    VerifyOrReturnError(data.msg_R2_Signed.Alloc(data.msg_r2_signed_len), CHIP_ERROR_NO_MEMORY);
 
-    // Generate an ephemeral keypair
     mEphemeralKey = mFabricsTable->AllocateEphemeralKeypairForCASE();
     VerifyOrReturnError(mEphemeralKey != nullptr, CHIP_ERROR_NO_MEMORY);
-    ReturnErrorOnFailure(mEphemeralKey->Initialize(ECPKeyTarget::ECDH));
-
-    // Generate a Shared Secret
-    ReturnErrorOnFailure(mEphemeralKey->ECDH_derive_secret(mRemotePubKey, mSharedSecret));
 
-    uint8_t msg_salt[kIPKSize + kSigmaParamRandomNumberSize + kP256_PublicKey_Length + kSHA256_Hash_Length];
+    if (CanUseEphemeralKeypairInBackground())
+    {
+        // NOTE: keypair generation, ECDH and TBS data construction happen in background.
+        data.ephemeralKey.Lend(*mFabricsTable, mEphemeralKey);
+        data.remotePubKey = mRemotePubKey;
+    }
+    else
+    {
+        // Generate an ephemeral keypair
+        ReturnErrorOnFailure(mEphemeralKey->Initialize(ECPKeyTarget::ECDH));
 
-    MutableByteSpan saltSpan(msg_salt);
-    ReturnErrorOnFailure(ConstructSaltSigma2(ByteSpan(msg_rand), mEphemeralKey->Pubkey(), ByteSpan(mIPK), saltSpan));
+        // Generate a Shared Secret
+        ReturnErrorOnFailure(mEphemeralKey->ECDH_derive_secret(mRemotePubKey, mSharedSecret));
 
-    AutoReleaseSessionKey sr2k(*mSessionManager->GetSessionKeystore());
-    ReturnErrorOnFailure(DeriveSigmaKey(saltSpan, ByteSpan(kKDFSR2Info), sr2k));
+        // Construct Sigma2 TBS Data
+        ReturnErrorOnFailure(ConstructTBSData(data.nocCert, data.icaCert,
+                                              ByteSpan(mEphemeralKey->Pubkey(), mEphemeralKey->Pubkey().Length()),
+                                              ByteSpan(mRemotePubKey, mRemotePubKey.Length()), data.msg_R2_Signed.Get(),
+                                              data.msg_r2_signed_len));
+    }
 
-    // Construct Sigma2 TBS Data
-    size_t msg_r2_signed_len =
-        TLV::EstimateStructOverhead(kMaxCHIPCertLength, kMaxCHIPCertLength, kP256_PublicKey_Length, kP256_PublicKey_Length);
+    if (data.ephemeralKey.Get() != nullptr || data.keystore != nullptr)
+    {
+        data.background = true;
+        ReturnErrorOnFailure(helper->ScheduleWork());
+        mSendSigma2Helper = helper;
+        mExchangeCtxt->WillSendMessage();
+        mState = State::kSendSigma2Pending;
+        return CHIP_NO_ERROR;
+    }
 
-    chip::Platform::ScopedMemoryBuffer<uint8_t> msg_R2_Signed;
-    VerifyOrReturnError(msg_R2_Signed.Alloc(msg_r2_signed_len), CHIP_ERROR_NO_MEMORY);
+    return helper->DoWork();
+}
 
-    ReturnErrorOnFailure(ConstructTBSData(nocCert, icaCert, ByteSpan(mEphemeralKey->Pubkey(), mEphemeralKey->Pubkey().Length()),
-                                          ByteSpan(mRemotePubKey, mRemotePubKey.Length()), msg_R2_Signed.Get(), msg_r2_signed_len));
+CHIP_ERROR CASESession::SendSigma2b(SendSigma2Data & data, bool & cancel)
+{
+    P256Keypair * ephemeralKey = data.ephemeralKey.Get();
+    if (ephemeralKey != nullptr)
+    {
+        // Generate an ephemeral keypair
+        ReturnErrorOnFailure(ephemeralKey->Initialize(ECPKeyTarget::ECDH));
 
-    // Generate a Signature
-    P256ECDSASignature tbsData2Signature;
-    ReturnErrorOnFailure(
-        mFabricsTable->SignWithOpKeypair(mFabricIndex, ByteSpan{ msg_R2_Signed.Get(), msg_r2_signed_len }, tbsData2Signature));
-    msg_R2_Signed.Free();
+        // Generate a Shared Secret
+        ReturnErrorOnFailure(ephemeralKey->ECDH_derive_secret(data.remotePubKey, data.sharedSecret));
 
-    // Construct Sigma2 TBE Data
-    size_t msg_r2_signed_enc_len = TLV::EstimateStructOverhead(nocCert.size(), icaCert.size(), tbsData2Signature.Length(),
-                                                               SessionResumptionStorage::kResumptionIdSize);
+        // Construct Sigma2 TBS Data
+        ReturnErrorOnFailure(ConstructTBSData(data.nocCert, data.icaCert,
+                                              ByteSpan(ephemeralKey->Pubkey(), ephemeralKey->Pubkey().Length()),
+                                              ByteSpan(data.remotePubKey, data.remotePubKey.Length()), data.msg_R2_Signed.Get(),
+                                              data.msg_r2_signed_len));
+    }
 
-    chip::Platform::ScopedMemoryBuffer<uint8_t> msg_R2_Encrypted;
-    VerifyOrReturnError(msg_R2_Encrypted.Alloc(msg_r2_signed_enc_len + CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES), CHIP_ERROR_NO_MEMORY);
+    // Without a keystore that can sign in background, the signature is generated in SendSigma2c.
+    if (data.keystore == nullptr)
+    {
+        return CHIP_NO_ERROR;
+    }
 
-    TLV::TLVWriter tlvWriter;
-    TLV::TLVType outerContainerType = TLV::kTLVType_NotSpecified;
+    return SignSigma2(data);
+}
 
-    tlvWriter.Init(msg_R2_Encrypted.Get(), msg_r2_signed_enc_len);
-    ReturnErrorOnFailure(tlvWriter.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outerContainerType));
-    ReturnErrorOnFailure(tlvWriter.Put(TLV::ContextTag(kTag_TBEData_SenderNOC), nocCert));
-    if (!icaCert.empty())
+CHIP_ERROR CASESession::SignSigma2(SendSigma2Data & data)
+{
+    // Generate a signature
+    if (data.keystore != nullptr)
+    {
+        // Recommended case: delegate to operational keystore
+        ReturnErrorOnFailure(data.keystore->SignWithOpKeypair(
+            data.fabricIndex, ByteSpan{ data.msg_R2_Signed.Get(), data.msg_r2_signed_len }, data.tbsData2Signature));
+    }
+    else
     {
-        ReturnErrorOnFailure(tlvWriter.Put(TLV::ContextTag(kTag_TBEData_SenderICAC), icaCert));
+        // Legacy case: delegate to fabric table fabric info
+        ReturnErrorOnFailure(data.fabricTable->SignWithOpKeypair(
+            data.fabricIndex, ByteSpan{ data.msg_R2_Signed.Get(), data.msg_r2_signed_len }, data.tbsData2Signature));
     }
+    data.msg_R2_Signed.Free();
+
+    // Construct Sigma2 TBE Data
+    data.msg_r2_encrypted_len = TLV::EstimateStructOverhead(data.nocCert.size(), data.icaCert.size(),
+                                                            data.tbsData2Signature.Length(), data.resumptionId.size());
+
+    VerifyOrReturnError(data.msg_R2_Encrypted.Alloc(data.msg_r2_encrypted_len + CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES),
+                        CHIP_ERROR_NO_MEMORY);
 
-    // We are now done with ICAC and NOC certs so we can release the memory.
     {
-        icacBuf.Free();
-        icaCert = MutableByteSpan{};
+        TLV::TLVWriter tlvWriter;
+        TLV::TLVType outerContainerType = TLV::kTLVType_NotSpecified;
+
+        tlvWriter.Init(data.msg_R2_Encrypted.Get(), data.msg_r2_encrypted_len);
+        ReturnErrorOnFailure(tlvWriter.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outerContainerType));
+        ReturnErrorOnFailure(tlvWriter.Put(TLV::ContextTag(kTag_TBEData_SenderNOC), data.nocCert));
+        if (!data.icaCert.empty())
+        {
+            ReturnErrorOnFailure(tlvWriter.Put(TLV::ContextTag(kTag_TBEData_SenderICAC), data.icaCert));
+        }
+
+        // We are now done with ICAC and NOC certs so we can release the memory.
+        {
+            data.icacBuf.Free();
+            data.icaCert = MutableByteSpan{};
+
+            data.nocBuf.Free();
+            data.nocCert = MutableByteSpan{};
+        }
+
+        ReturnErrorOnFailure(tlvWriter.PutBytes(TLV::ContextTag(kTag_TBEData_Signature), data.tbsData2Signature.ConstBytes(),
+                                                static_cast<uint32_t>(data.tbsData2Signature.Length())));
+        ReturnErrorOnFailure(tlvWriter.Put(TLV::ContextTag(kTag_TBEData_ResumptionID), data.resumptionId));
+        ReturnErrorOnFailure(tlvWriter.EndContainer(outerContainerType));
+        ReturnErrorOnFailure(tlvWriter.Finalize());
+        data.msg_r2_encrypted_len = static_cast<size_t>(tlvWriter.GetLengthWritten());
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR CASESession::SendSigma2c(SendSigma2Data & data, CHIP_ERROR status)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+
+    System::PacketBufferHandle msg_R2;
+    size_t data_len;
+
+    uint8_t msg_salt[kIPKSize + kSigmaParamRandomNumberSize + kP256_PublicKey_Length + kSHA256_Hash_Length];
+
+    AutoReleaseSessionKey sr2k(*mSessionManager->GetSessionKeystore());
+
+    VerifyOrDieWithMsg(!data.background || mState == State::kSendSigma2Pending, SecureChannel, "Bad internal state.");
 
-        nocBuf.Free();
-        nocCert = MutableByteSpan{};
+    // Take back the ephemeral keypair and shared secret if they were produced in the background.
+    if (data.ephemeralKey.Get() != nullptr)
+    {
+        mEphemeralKey = data.ephemeralKey.Return();
+        mSharedSecret = data.sharedSecret;
     }
 
-    ReturnErrorOnFailure(tlvWriter.PutBytes(TLV::ContextTag(kTag_TBEData_Signature), tbsData2Signature.ConstBytes(),
-                                            static_cast<uint32_t>(tbsData2Signature.Length())));
+    SuccessOrExit(err = status);
 
-    // Generate a new resumption ID
-    ReturnErrorOnFailure(DRBG_get_bytes(mNewResumptionId.data(), mNewResumptionId.size()));
-    ReturnErrorOnFailure(tlvWriter.Put(TLV::ContextTag(kTag_TBEData_ResumptionID), mNewResumptionId));
+    if (data.keystore == nullptr)
+    {
+        SuccessOrExit(err = SignSigma2(data));
+    }
 
-    ReturnErrorOnFailure(tlvWriter.EndContainer(outerContainerType));
-    ReturnErrorOnFailure(tlvWriter.Finalize());
-    msg_r2_signed_enc_len = static_cast<size_t>(tlvWriter.GetLengthWritten());
+    // Generate S2K key
+    {
+        MutableByteSpan saltSpan(msg_salt);
+        SuccessOrExit(err = ConstructSaltSigma2(ByteSpan(data.msg_rand), mEphemeralKey->Pubkey(), ByteSpan(mIPK), saltSpan));
+        SuccessOrExit(err = DeriveSigmaKey(saltSpan, ByteSpan(kKDFSR2Info), sr2k));
+    }
 
     // Generate the encrypted data blob
-    ReturnErrorOnFailure(AES_CCM_encrypt(msg_R2_Encrypted.Get(), msg_r2_signed_enc_len, nullptr, 0, sr2k.KeyHandle(),
-                                         kTBEData2_Nonce, kTBEDataNonceLength, msg_R2_Encrypted.Get(),
-                                         msg_R2_Encrypted.Get() + msg_r2_signed_enc_len, CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES));
+    SuccessOrExit(err =
+                      AES_CCM_encrypt(data.msg_R2_Encrypted.Get(), data.msg_r2_encrypted_len, nullptr, 0, sr2k.KeyHandle(),
+                                      kTBEData2_Nonce, kTBEDataNonceLength, data.msg_R2_Encrypted.Get(),
+                                      data.msg_R2_Encrypted.Get() + data.msg_r2_encrypted_len, CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES));
 
     // Construct Sigma2 Msg
-    const size_t mrpParamsSize =
-        mLocalMRPConfig.HasValue() ? TLV::EstimateStructOverhead(sizeof(uint16_t), sizeof(uint16_t), sizeof(uint16_t)) : 0;
-    size_t data_len = TLV::EstimateStructOverhead(kSigmaParamRandomNumberSize, sizeof(uint16_t), kP256_PublicKey_Length,
-                                                  msg_r2_signed_enc_len, CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES, mrpParamsSize);
-
-    System::PacketBufferHandle msg_R2 = System::PacketBufferHandle::New(data_len);
-    VerifyOrReturnError(!msg_R2.IsNull(), CHIP_ERROR_NO_MEMORY);
-
-    System::PacketBufferTLVWriter tlvWriterMsg2;
-    outerContainerType = TLV::kTLVType_NotSpecified;
-
-    tlvWriterMsg2.Init(std::move(msg_R2));
-    ReturnErrorOnFailure(tlvWriterMsg2.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outerContainerType));
-    ReturnErrorOnFailure(tlvWriterMsg2.PutBytes(TLV::ContextTag(1), &msg_rand[0], sizeof(msg_rand)));
-    ReturnErrorOnFailure(tlvWriterMsg2.Put(TLV::ContextTag(2), GetLocalSessionId().Value()));
-    ReturnErrorOnFailure(tlvWriterMsg2.PutBytes(TLV::ContextTag(3), mEphemeralKey->Pubkey(),
-                                                static_cast<uint32_t>(mEphemeralKey->Pubkey().Length())));
-    ReturnErrorOnFailure(tlvWriterMsg2.PutBytes(TLV::ContextTag(4), msg_R2_Encrypted.Get(),
-                                                static_cast<uint32_t>(msg_r2_signed_enc_len + CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES)));
-    if (mLocalMRPConfig.HasValue())
     {
-        ChipLogDetail(SecureChannel, "Including MRP parameters");
-        ReturnErrorOnFailure(EncodeMRPParameters(TLV::ContextTag(5), mLocalMRPConfig.Value(), tlvWriterMsg2));
+        const size_t mrpParamsSize =
+            mLocalMRPConfig.HasValue() ? TLV::EstimateStructOverhead(sizeof(uint16_t), sizeof(uint16_t), sizeof(uint16_t)) : 0;
+        data_len = TLV::EstimateStructOverhead(kSigmaParamRandomNumberSize, sizeof(uint16_t), kP256_PublicKey_Length,
+                                               data.msg_r2_encrypted_len, CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES, mrpParamsSize);
     }
-    ReturnErrorOnFailure(tlvWriterMsg2.EndContainer(outerContainerType));
-    ReturnErrorOnFailure(tlvWriterMsg2.Finalize(&msg_R2));
 
-    ReturnErrorOnFailure(mCommissioningHash.AddData(ByteSpan{ msg_R2->Start(), msg_R2->DataLength() }));
+    msg_R2 = System::PacketBufferHandle::New(data_len);
+    VerifyOrExit(!msg_R2.IsNull(), err = CHIP_ERROR_NO_MEMORY);
+
+    {
+        System::PacketBufferTLVWriter tlvWriterMsg2;
+        TLV::TLVType outerContainerType = TLV::kTLVType_NotSpecified;
+
+        tlvWriterMsg2.Init(std::move(msg_R2));
+        SuccessOrExit(err = tlvWriterMsg2.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outerContainerType));
+        SuccessOrExit(err = tlvWriterMsg2.PutBytes(TLV::ContextTag(1), &data.msg_rand[0], sizeof(data.msg_rand)));
+        SuccessOrExit(err = tlvWriterMsg2.Put(TLV::ContextTag(2), GetLocalSessionId().Value()));
+        SuccessOrExit(err = tlvWriterMsg2.PutBytes(TLV::ContextTag(3), mEphemeralKey->Pubkey(),
+                                                   static_cast<uint32_t>(mEphemeralKey->Pubkey().Length())));
+        SuccessOrExit(err = tlvWriterMsg2.PutBytes(
+                          TLV::ContextTag(4), data.msg_R2_Encrypted.Get(),
+                          static_cast<uint32_t>(data.msg_r2_encrypted_len + CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES)));
+        if (mLocalMRPConfig.HasValue())
+        {
+            ChipLogDetail(SecureChannel, "Including MRP parameters");
+            SuccessOrExit(err = EncodeMRPParameters(TLV::ContextTag(5), mLocalMRPConfig.Value(), tlvWriterMsg2));
+        }
+        SuccessOrExit(err = tlvWriterMsg2.EndContainer(outerContainerType));
+        SuccessOrExit(err = tlvWriterMsg2.Finalize(&msg_R2));
+    }
+
+    SuccessOrExit(err = mCommissioningHash.AddData(ByteSpan{ msg_R2->Start(), msg_R2->DataLength() }));
 
     // Call delegate to send the msg to peer
-    ReturnErrorOnFailure(mExchangeCtxt->SendMessage(Protocols::SecureChannel::MsgType::CASE_Sigma2, std::move(msg_R2),
-                                                    SendFlags(SendMessageFlags::kExpectResponse)));
+    SuccessOrExit(err = mExchangeCtxt->SendMessage(Protocols::SecureChannel::MsgType::CASE_Sigma2, std::move(msg_R2),
+                                                   SendFlags(SendMessageFlags::kExpectResponse)));
 
     mState = State::kSentSigma2;
 
     ChipLogProgress(SecureChannel, "Sent Sigma2 msg");
 
-    return CHIP_NO_ERROR;
+exit:
+    mSendSigma2Helper.reset();
+
+    // If processing occurred in the background and an error occurred, need to send status report
+    // (normally occurs in HandleSigma1), and discard exchange and abort pending establish (normally
+    // occurs in OnMessageReceived).
+    if (data.background && err != CHIP_NO_ERROR)
+    {
+        SendStatusReport(mExchangeCtxt, kProtocolCodeInvalidParam);
+        DiscardExchange();
+        AbortPendingEstablish(err);
+    }
+
+    return err;
 }
 
 CHIP_ERROR CASESession::HandleSigma2Resume(System::PacketBufferHandle && msg)
@@ -1176,178 +1265,318 @@ exit:
 CHIP_ERROR CASESession::HandleSigma2_and_SendSigma3(System::PacketBufferHandle && msg)
 {
     MATTER_TRACE_SCOPE("HandleSigma2_and_SendSigma3", "CASESession");
-    ReturnErrorOnFailure(HandleSigma2(std::move(msg)));
-    ReturnErrorOnFailure(SendSigma3a());
-
-    return CHIP_NO_ERROR;
+    // Sigma3 is sent by HandleSigma2e, once the Sigma2 processing (partly in the background) completes.
+    return HandleSigma2a(std::move(msg));
 }
 
-CHIP_ERROR CASESession::HandleSigma2(System::PacketBufferHandle && msg)
+CHIP_ERROR CASESession::HandleSigma2a(System::PacketBufferHandle && msg)
 {
     MATTER_TRACE_SCOPE("HandleSigma2", "CASESession");
     CHIP_ERROR err = CHIP_NO_ERROR;
     System::PacketBufferTLVReader tlvReader;
-    TLV::TLVReader decryptedDataTlvReader;
     TLV::TLVType containerType = TLV::kTLVType_Structure;
 
     const uint8_t * buf = msg->Start();
     size_t buflen       = msg->DataLength();
 
-    uint8_t msg_salt[kIPKSize + kSigmaParamRandomNumberSize + kP256_PublicKey_Length + kSHA256_Hash_Length];
-
-    chip::Platform::ScopedMemoryBuffer<uint8_t> msg_R2_Encrypted;
-    size_t msg_r2_encrypted_len          = 0;
     size_t msg_r2_encrypted_len_with_tag = 0;
-
-    chip::Platform::ScopedMemoryBuffer<uint8_t> msg_R2_Signed;
-    size_t msg_r2_signed_len;
     size_t max_msg_r2_signed_enc_len;
     constexpr size_t kCaseOverheadForFutureTbeData = 128;
 
-    AutoReleaseSessionKey sr2k(*mSessionManager->GetSessionKeystore());
-
-    P256ECDSASignature tbsData2Signature;
-
-    NodeId responderNodeId;
-    P256PublicKey responderPublicKey;
-
     uint8_t responderRandom[kSigmaParamRandomNumberSize];
-    ByteSpan responderNOC;
-    ByteSpan responderICAC;
 
     uint16_t responderSessionId;
 
     ChipLogProgress(SecureChannel, "Received Sigma2 msg");
 
-    FabricId fabricId = kUndefinedFabricId;
+    auto helper = WorkHelper<HandleSigma2Data>::Create(*this, &HandleSigma2b, &CASESession::HandleSigma2c);
+    VerifyOrExit(helper, err = CHIP_ERROR_NO_MEMORY);
     {
-        VerifyOrExit(mFabricsTable != nullptr, err = CHIP_ERROR_INCORRECT_STATE);
-        const auto * fabricInfo = mFabricsTable->FindFabricWithIndex(mFabricIndex);
-        VerifyOrExit(fabricInfo != nullptr, err = CHIP_ERROR_INCORRECT_STATE);
-        fabricId = fabricInfo->GetFabricId();
-    }
+        auto & data = helper->mData;
 
-    VerifyOrExit(mEphemeralKey != nullptr, err = CHIP_ERROR_INTERNAL);
-    VerifyOrExit(buf != nullptr, err = CHIP_ERROR_MESSAGE_INCOMPLETE);
+        data.background = false;
 
-    tlvReader.Init(std::move(msg));
-    SuccessOrExit(err = tlvReader.Next(containerType, TLV::AnonymousTag()));
-    SuccessOrExit(err = tlvReader.EnterContainer(containerType));
+        {
+            VerifyOrExit(mFabricsTable != nullptr, err = CHIP_ERROR_INCORRECT_STATE);
+            const auto * fabricInfo = mFabricsTable->FindFabricWithIndex(mFabricIndex);
+            VerifyOrExit(fabricInfo != nullptr, err = CHIP_ERROR_INCORRECT_STATE);
+            data.fabricId = fabricInfo->GetFabricId();
+        }
 
-    // Retrieve Responder's Random value
-    SuccessOrExit(err = tlvReader.Next(TLV::kTLVType_ByteString, TLV::ContextTag(kTag_Sigma2_ResponderRandom)));
-    SuccessOrExit(err = tlvReader.GetBytes(responderRandom, sizeof(responderRandom)));
+        VerifyOrExit(mEphemeralKey != nullptr, err = CHIP_ERROR_INTERNAL);
+        VerifyOrExit(buf != nullptr, err = CHIP_ERROR_MESSAGE_INCOMPLETE);
 
-    // Assign Session ID
-    SuccessOrExit(err = tlvReader.Next(TLV::kTLVType_UnsignedInteger, TLV::ContextTag(kTag_Sigma2_ResponderSessionId)));
-    SuccessOrExit(err = tlvReader.Get(responderSessionId));
+        tlvReader.Init(std::move(msg));
+        SuccessOrExit(err = tlvReader.Next(containerType, TLV::AnonymousTag()));
+        SuccessOrExit(err = tlvReader.EnterContainer(containerType));
 
-    ChipLogDetail(SecureChannel, "Peer assigned session session ID %d", responderSessionId);
-    SetPeerSessionId(responderSessionId);
+        // Retrieve Responder's Random value
+        SuccessOrExit(err = tlvReader.Next(TLV::kTLVType_ByteString, TLV::ContextTag(kTag_Sigma2_ResponderRandom)));
+        SuccessOrExit(err = tlvReader.GetBytes(responderRandom, sizeof(responderRandom)));
 
-    // Retrieve Responder's Ephemeral Pubkey
-    SuccessOrExit(err = tlvReader.Next(TLV::kTLVType_ByteString, TLV::ContextTag(kTag_Sigma2_ResponderEphPubKey)));
-    SuccessOrExit(err = tlvReader.GetBytes(mRemotePubKey, static_cast<uint32_t>(mRemotePubKey.Length())));
+        // Assign Session ID
+        SuccessOrExit(err = tlvReader.Next(TLV::kTLVType_UnsignedInteger, TLV::ContextTag(kTag_Sigma2_ResponderSessionId)));
+        SuccessOrExit(err = tlvReader.Get(responderSessionId));
 
-    // Generate a Shared Secret
-    SuccessOrExit(err = mEphemeralKey->ECDH_derive_secret(mRemotePubKey, mSharedSecret));
+        ChipLogDetail(SecureChannel, "Peer assigned session session ID %d", responderSessionId);
+        SetPeerSessionId(responderSessionId);
 
-    // Generate the S2K key
+        // Retrieve Responder's Ephemeral Pubkey
+        SuccessOrExit(err = tlvReader.Next(TLV::kTLVType_ByteString, TLV::ContextTag(kTag_Sigma2_ResponderEphPubKey)));
+        SuccessOrExit(err = tlvReader.GetBytes(mRemotePubKey, static_cast<uint32_t>(mRemotePubKey.Length())));
+
+        // Construct the S2K salt, which covers the transcript up to Sigma1; the key is derived
+        // in HandleSigma2c, once the shared secret is known.
+        {
+            MutableByteSpan saltSpan(data.msg_salt);
+            SuccessOrExit(err = ConstructSaltSigma2(ByteSpan(responderRandom), mRemotePubKey, ByteSpan(mIPK), saltSpan));
+            data.msg_salt_len = saltSpan.size();
+        }
+
+        SuccessOrExit(err = mCommissioningHash.AddData(ByteSpan{ buf, buflen }));
+
+        // Fetch encrypted data
+        SuccessOrExit(err = tlvReader.Next(TLV::kTLVType_ByteString, TLV::ContextTag(kTag_Sigma2_Encrypted2)));
+
+        max_msg_r2_signed_enc_len =
+            TLV::EstimateStructOverhead(Credentials::kMaxCHIPCertLength, Credentials::kMaxCHIPCertLength,
+                                        data.tbsData2Signature.Length(), SessionResumptionStorage::kResumptionIdSize,
+                                        kCaseOverheadForFutureTbeData);
+        msg_r2_encrypted_len_with_tag = tlvReader.GetLength();
+
+        // Validate we did not receive a buffer larger than legal
+        VerifyOrExit(msg_r2_encrypted_len_with_tag <= max_msg_r2_signed_enc_len, err = CHIP_ERROR_INVALID_TLV_ELEMENT);
+        VerifyOrExit(msg_r2_encrypted_len_with_tag > CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES, err = CHIP_ERROR_INVALID_TLV_ELEMENT);
+        VerifyOrExit(data.msg_R2_Encrypted.Alloc(msg_r2_encrypted_len_with_tag), err = CHIP_ERROR_NO_MEMORY);
+
+        SuccessOrExit(err = tlvReader.GetBytes(data.msg_R2_Encrypted.Get(), static_cast<uint32_t>(msg_r2_encrypted_len_with_tag)));
+        data.msg_r2_encrypted_len = msg_r2_encrypted_len_with_tag - CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES;
+
+        // Retrieve responderMRPParams if present
+        if (tlvReader.Next() != CHIP_END_OF_TLV)
+        {
+            SuccessOrExit(err = DecodeMRPParametersIfPresent(TLV::ContextTag(kTag_Sigma2_ResponderMRPParams), tlvReader));
+            mExchangeCtxt->GetSessionHandle()->AsUnauthenticatedSession()->SetRemoteMRPConfig(mRemoteMRPConfig);
+        }
+
+        mHandleSigma2Helper = helper;
+
+        if (CanUseEphemeralKeypairInBackground())
+        {
+            // NOTE: ECDH happens in background.
+            data.ephemeralKey.Lend(*mFabricsTable, mEphemeralKey);
+            data.remotePubKey = mRemotePubKey;
+            data.background   = true;
+
+            SuccessOrExit(err = helper->ScheduleWork());
+            mExchangeCtxt->WillSendMessage();
+            mState = State::kHandleSigma2Pending;
+        }
+        else
+        {
+            // Generate a Shared Secret
+            SuccessOrExit(err = mEphemeralKey->ECDH_derive_secret(mRemotePubKey, mSharedSecret));
+            SuccessOrExit(err = helper->DoWork());
+        }
+    }
+
+exit:
+    if (err != CHIP_NO_ERROR)
     {
-        MutableByteSpan saltSpan(msg_salt);
-        SuccessOrExit(err = ConstructSaltSigma2(ByteSpan(responderRandom), mRemotePubKey, ByteSpan(mIPK), saltSpan));
-        SuccessOrExit(err = DeriveSigmaKey(saltSpan, ByteSpan(kKDFSR2Info), sr2k));
+        mHandleSigma2Helper.reset();
+        SendStatusReport(mExchangeCtxt, kProtocolCodeInvalidParam);
     }
+    return err;
+}
 
-    SuccessOrExit(err = mCommissioningHash.AddData(ByteSpan{ buf, buflen }));
+CHIP_ERROR CASESession::HandleSigma2b(HandleSigma2Data & data, bool & cancel)
+{
+    // Generate a Shared Secret
+    if (data.ephemeralKey.Get() != nullptr)
+    {
+        ReturnErrorOnFailure(data.ephemeralKey.Get()->ECDH_derive_secret(data.remotePubKey, data.sharedSecret));
+    }
 
-    // Generate decrypted data
-    SuccessOrExit(err = tlvReader.Next(TLV::kTLVType_ByteString, TLV::ContextTag(kTag_Sigma2_Encrypted2)));
+    return CHIP_NO_ERROR;
+}
 
-    max_msg_r2_signed_enc_len =
-        TLV::EstimateStructOverhead(Credentials::kMaxCHIPCertLength, Credentials::kMaxCHIPCertLength, tbsData2Signature.Length(),
-                                    SessionResumptionStorage::kResumptionIdSize, kCaseOverheadForFutureTbeData);
-    msg_r2_encrypted_len_with_tag = tlvReader.GetLength();
+CHIP_ERROR CASESession::HandleSigma2c(HandleSigma2Data & data, CHIP_ERROR status)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    TLV::TLVReader decryptedDataTlvReader;
+    TLV::TLVType containerType = TLV::kTLVType_Structure;
 
-    // Validate we did not receive a buffer larger than legal
-    VerifyOrExit(msg_r2_encrypted_len_with_tag <= max_msg_r2_signed_enc_len, err = CHIP_ERROR_INVALID_TLV_ELEMENT);
-    VerifyOrExit(msg_r2_encrypted_len_with_tag > CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES, err = CHIP_ERROR_INVALID_TLV_ELEMENT);
-    VerifyOrExit(msg_R2_Encrypted.Alloc(msg_r2_encrypted_len_with_tag), err = CHIP_ERROR_NO_MEMORY);
+    AutoReleaseSessionKey sr2k(*mSessionManager->GetSessionKeystore());
+
+    // Read before any reset of the helper below, which may release `data`.
+    const bool background = data.background;
+
+    VerifyOrDieWithMsg(!background || mState == State::kHandleSigma2Pending, SecureChannel, "Bad internal state.");
+
+    // Take back the ephemeral keypair and shared secret if the ECDH happened in the background.
+    if (data.ephemeralKey.Get() != nullptr)
+    {
+        mEphemeralKey = data.ephemeralKey.Return();
+        mSharedSecret = data.sharedSecret;
+    }
 
-    SuccessOrExit(err = tlvReader.GetBytes(msg_R2_Encrypted.Get(), static_cast<uint32_t>(msg_r2_encrypted_len_with_tag)));
-    msg_r2_encrypted_len = msg_r2_encrypted_len_with_tag - CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES;
+    SuccessOrExit(err = status);
+    VerifyOrExit(mHandleSigma2Helper, err = CHIP_ERROR_INCORRECT_STATE);
+
+    // Generate the S2K key
+    SuccessOrExit(err = DeriveSigmaKey(ByteSpan(data.msg_salt, data.msg_salt_len), ByteSpan(kKDFSR2Info), sr2k));
 
-    SuccessOrExit(err = AES_CCM_decrypt(msg_R2_Encrypted.Get(), msg_r2_encrypted_len, nullptr, 0,
-                                        msg_R2_Encrypted.Get() + msg_r2_encrypted_len, CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES,
-                                        sr2k.KeyHandle(), kTBEData2_Nonce, kTBEDataNonceLength, msg_R2_Encrypted.Get()));
+    // Generate decrypted data
+    SuccessOrExit(err = AES_CCM_decrypt(data.msg_R2_Encrypted.Get(), data.msg_r2_encrypted_len, nullptr, 0,
+                                        data.msg_R2_Encrypted.Get() + data.msg_r2_encrypted_len, CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES,
+                                        sr2k.KeyHandle(), kTBEData2_Nonce, kTBEDataNonceLength, data.msg_R2_Encrypted.Get()));
 
-    decryptedDataTlvReader.Init(msg_R2_Encrypted.Get(), msg_r2_encrypted_len);
-    containerType = TLV::kTLVType_Structure;
+    decryptedDataTlvReader.Init(data.msg_R2_Encrypted.Get(), data.msg_r2_encrypted_len);
     SuccessOrExit(err = decryptedDataTlvReader.Next(containerType, TLV::AnonymousTag()));
     SuccessOrExit(err = decryptedDataTlvReader.EnterContainer(containerType));
 
     SuccessOrExit(err = decryptedDataTlvReader.Next(TLV::kTLVType_ByteString, TLV::ContextTag(kTag_TBEData_SenderNOC)));
-    SuccessOrExit(err = decryptedDataTlvReader.Get(responderNOC));
+    SuccessOrExit(err = decryptedDataTlvReader.Get(data.responderNOC));
 
     SuccessOrExit(err = decryptedDataTlvReader.Next());
     if (TLV::TagNumFromTag(decryptedDataTlvReader.GetTag()) == kTag_TBEData_SenderICAC)
     {
         VerifyOrExit(decryptedDataTlvReader.GetType() == TLV::kTLVType_ByteString, err = CHIP_ERROR_WRONG_TLV_TYPE);
-        SuccessOrExit(err = decryptedDataTlvReader.Get(responderICAC));
+        SuccessOrExit(err = decryptedDataTlvReader.Get(data.responderICAC));
         SuccessOrExit(err = decryptedDataTlvReader.Next(TLV::kTLVType_ByteString, TLV::ContextTag(kTag_TBEData_Signature)));
     }
 
-    // Validate responder identity located in msg_r2_encrypted
-    // Constructing responder identity
+    // Construct msg_R2_Signed, to validate the signature in msg_r2_encrypted
+    data.msg_r2_signed_len = TLV::EstimateStructOverhead(sizeof(uint16_t), data.responderNOC.size(), data.responderICAC.size(),
+                                                         kP256_PublicKey_Length, kP256_PublicKey_Length);
+
+    VerifyOrExit(data.msg_R2_Signed.Alloc(data.msg_r2_signed_len), err = CHIP_ERROR_NO_MEMORY);
+
+    SuccessOrExit(err = ConstructTBSData(data.responderNOC, data.responderICAC, ByteSpan(mRemotePubKey, mRemotePubKey.Length()),
+                                         ByteSpan(mEphemeralKey->Pubkey(), mEphemeralKey->Pubkey().Length()),
+                                         data.msg_R2_Signed.Get(), data.msg_r2_signed_len));
+
+    VerifyOrExit(TLV::TagNumFromTag(decryptedDataTlvReader.GetTag()) == kTag_TBEData_Signature, err = CHIP_ERROR_INVALID_TLV_TAG);
+    VerifyOrExit(data.tbsData2Signature.Capacity() >= decryptedDataTlvReader.GetLength(), err = CHIP_ERROR_INVALID_TLV_ELEMENT);
+    data.tbsData2Signature.SetLength(decryptedDataTlvReader.GetLength());
+    SuccessOrExit(err = decryptedDataTlvReader.GetBytes(data.tbsData2Signature.Bytes(), data.tbsData2Signature.Length()));
+
+    // Retrieve session resumption ID
+    SuccessOrExit(err = decryptedDataTlvReader.Next(TLV::kTLVType_ByteString, TLV::ContextTag(kTag_TBEData_ResumptionID)));
+    SuccessOrExit(err = decryptedDataTlvReader.GetBytes(data.resumptionId.data(), data.resumptionId.size()));
+
+    // Prepare for validating responder identity in the background
     {
-        CompressedFabricId unused;
-        FabricId responderFabricId;
+        MutableByteSpan fabricRCAC{ data.rootCertBuf };
+        SuccessOrExit(err = mFabricsTable->FetchRootCert(mFabricIndex, fabricRCAC));
+        data.fabricRCAC = fabricRCAC;
         SuccessOrExit(err = SetEffectiveTime());
-        SuccessOrExit(err = mFabricsTable->VerifyCredentials(mFabricIndex, responderNOC, responderICAC, mValidContext, unused,
-                                                             responderFabricId, responderNodeId, responderPublicKey));
-        VerifyOrExit(fabricId == responderFabricId, err = CHIP_ERROR_INVALID_CASE_PARAMETER);
-        // Verify that responderNodeId (from responderNOC) matches one that was included
-        // in the computation of the Destination Identifier when generating Sigma1.
-        VerifyOrExit(mPeerNodeId == responderNodeId, err = CHIP_ERROR_INVALID_CASE_PARAMETER);
     }
 
-    // Construct msg_R2_Signed and validate the signature in msg_r2_encrypted
-    msg_r2_signed_len = TLV::EstimateStructOverhead(sizeof(uint16_t), responderNOC.size(), responderICAC.size(),
-                                                    kP256_PublicKey_Length, kP256_PublicKey_Length);
+    // Copy remaining needed data into work structure
+    {
+        data.validContext = mValidContext;
+        data.peerNodeId   = mPeerNodeId;
 
-    VerifyOrExit(msg_R2_Signed.Alloc(msg_r2_signed_len), err = CHIP_ERROR_NO_MEMORY);
+        // responderNOC and responderICAC are spans into msg_R2_Encrypted
+        // which is going away, so to save memory, redirect them to their
+        // copies in msg_R2_signed, which is staying around
+        TLV::TLVReader signedDataTlvReader;
+        signedDataTlvReader.Init(data.msg_R2_Signed.Get(), data.msg_r2_signed_len);
+        SuccessOrExit(err = signedDataTlvReader.Next(TLV::kTLVType_Structure, TLV::AnonymousTag()));
+        SuccessOrExit(err = signedDataTlvReader.EnterContainer(containerType));
 
-    SuccessOrExit(err = ConstructTBSData(responderNOC, responderICAC, ByteSpan(mRemotePubKey, mRemotePubKey.Length()),
-                                         ByteSpan(mEphemeralKey->Pubkey(), mEphemeralKey->Pubkey().Length()), msg_R2_Signed.Get(),
-                                         msg_r2_signed_len));
+        SuccessOrExit(err = signedDataTlvReader.Next(TLV::kTLVType_ByteString, TLV::ContextTag(kTag_TBSData_SenderNOC)));
+        SuccessOrExit(err = signedDataTlvReader.Get(data.responderNOC));
 
-    VerifyOrExit(TLV::TagNumFromTag(decryptedDataTlvReader.GetTag()) == kTag_TBEData_Signature, err = CHIP_ERROR_INVALID_TLV_TAG);
-    VerifyOrExit(tbsData2Signature.Capacity() >= decryptedDataTlvReader.GetLength(), err = CHIP_ERROR_INVALID_TLV_ELEMENT);
-    tbsData2Signature.SetLength(decryptedDataTlvReader.GetLength());
-    SuccessOrExit(err = decryptedDataTlvReader.GetBytes(tbsData2Signature.Bytes(), tbsData2Signature.Length()));
+        if (!data.responderICAC.empty())
+        {
+            SuccessOrExit(err = signedDataTlvReader.Next(TLV::kTLVType_ByteString, TLV::ContextTag(kTag_TBSData_SenderICAC)));
+            SuccessOrExit(err = signedDataTlvReader.Get(data.responderICAC));
+        }
+
+        data.msg_R2_Encrypted.Free();
+    }
+
+    SuccessOrExit(err = mHandleSigma2Helper->ScheduleWork(&HandleSigma2d, &CASESession::HandleSigma2e));
+    mExchangeCtxt->WillSendMessage();
+    mState = State::kHandleSigma2Pending;
+
+exit:
+    if (err != CHIP_NO_ERROR)
+    {
+        mHandleSigma2Helper.reset();
+
+        // If processing occurred in the background, need to send status report (normally occurs in
+        // HandleSigma2a), and discard exchange and abort pending establish (normally occurs in
+        // OnMessageReceived).
+        if (background)
+        {
+            SendStatusReport(mExchangeCtxt, kProtocolCodeInvalidParam);
+            DiscardExchange();
+            AbortPendingEstablish(err);
+        }
+    }
+
+    return err;
+}
+
+CHIP_ERROR CASESession::HandleSigma2d(HandleSigma2Data & data, bool & cancel)
+{
+    // Validate responder identity located in msg_r2_encrypted
+    // Constructing responder identity
+    CompressedFabricId unused;
+    FabricId responderFabricId;
+    NodeId responderNodeId;
+    P256PublicKey responderPublicKey;
+    ReturnErrorOnFailure(FabricTable::VerifyCredentials(data.responderNOC, data.responderICAC, data.fabricRCAC, data.validContext,
+                                                        unused, responderFabricId, responderNodeId, responderPublicKey));
+    VerifyOrReturnError(data.fabricId == responderFabricId, CHIP_ERROR_INVALID_CASE_PARAMETER);
+    // Verify that responderNodeId (from responderNOC) matches one that was included
+    // in the computation of the Destination Identifier when generating Sigma1.
+    VerifyOrReturnError(data.peerNodeId == responderNodeId, CHIP_ERROR_INVALID_CASE_PARAMETER);
 
     // Validate signature
-    SuccessOrExit(err = responderPublicKey.ECDSA_validate_msg_signature(msg_R2_Signed.Get(), msg_r2_signed_len, tbsData2Signature));
+    ReturnErrorOnFailure(
+        responderPublicKey.ECDSA_validate_msg_signature(data.msg_R2_Signed.Get(), data.msg_r2_signed_len, data.tbsData2Signature));
 
-    // Retrieve session resumption ID
-    SuccessOrExit(err = decryptedDataTlvReader.Next(TLV::kTLVType_ByteString, TLV::ContextTag(kTag_TBEData_ResumptionID)));
-    SuccessOrExit(err = decryptedDataTlvReader.GetBytes(mNewResumptionId.data(), mNewResumptionId.size()));
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR CASESession::HandleSigma2e(HandleSigma2Data & data, CHIP_ERROR status)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+
+    VerifyOrExit(mState == State::kHandleSigma2Pending, err = CHIP_ERROR_INCORRECT_STATE);
+
+    SuccessOrExit(err = status);
+
+    mNewResumptionId = data.resumptionId;
 
     // Retrieve peer CASE Authenticated Tags (CATs) from peer's NOC.
-    SuccessOrExit(err = ExtractCATsFromOpCert(responderNOC, mPeerCATs));
+    SuccessOrExit(err = ExtractCATsFromOpCert(data.responderNOC, mPeerCATs));
 
-    // Retrieve responderMRPParams if present
-    if (tlvReader.Next() != CHIP_END_OF_TLV)
+exit:
+    mHandleSigma2Helper.reset();
+
+    if (err != CHIP_NO_ERROR)
     {
-        SuccessOrExit(err = DecodeMRPParametersIfPresent(TLV::ContextTag(kTag_Sigma2_ResponderMRPParams), tlvReader));
-        mExchangeCtxt->GetSessionHandle()->AsUnauthenticatedSession()->SetRemoteMRPConfig(mRemoteMRPConfig);
+        SendStatusReport(mExchangeCtxt, kProtocolCodeInvalidParam);
+    }
+    else
+    {
+        // SendSigma3a sends its own status report on failure.
+        err = SendSigma3a();
     }
 
-exit:
     if (err != CHIP_NO_ERROR)
     {
-        SendStatusReport(mExchangeCtxt, kProtocolCodeInvalidParam);
+        // Abort the pending establish, which is normally done by CASESession::OnMessageReceived,
+        // but in the background processing case must be done here.
+        DiscardExchange();
+        AbortPendingEstablish(err);
     }
+
     return err;
 }
 
@@ -1937,6 +2166,13 @@ CHIP_ERROR CASESession::SetEffectiveTime()
     return CHIP_NO_ERROR;
 }
 
+bool CASESession::CanUseEphemeralKeypairInBackground() const
+{
+    const auto * keystore = mFabricsTable->GetOperationalKeystore();
+    // Without an operational keystore, the fabric table allocates plain heap keypairs.
+    return keystore == nullptr || keystore->SupportsEphemeralKeypairInBackground();
+}
+
 void CASESession::OnSuccessStatusReport()
 {
     ChipLogProgress(SecureChannel, "Success status report received. Session was established");
@@ -2250,6 +2486,20 @@ bool CASESession::InvokeBackgroundWorkWatchdog()
 {
     bool watchdogFired = false;
 
+    if (mSendSigma2Helper && mSendSigma2Helper->UnableToScheduleAfterWorkCallback())
+    {
+        ChipLogError(SecureChannel, "SendSigma2Helper was unable to schedule the AfterWorkCallback");
+        mSendSigma2Helper->DoAfterWork();
+        watchdogFired = true;
+    }
+
+    if (mHandleSigma2Helper && mHandleSigma2Helper->UnableToScheduleAfterWorkCallback())
+    {
+        ChipLogError(SecureChannel, "HandleSigma2Helper was unable to schedule the AfterWorkCallback");
+        mHandleSigma2Helper->DoAfterWork();
+        watchdogFired = true;
+    }
+
     if (mSendSigma3Helper && mSendSigma3Helper->UnableToScheduleAfterWorkCallback())
     {
         ChipLogError(SecureChannel, "SendSigma3Helper was unable to schedule the AfterWorkCallback");
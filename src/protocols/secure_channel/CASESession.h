@@ -50,6 +50,9 @@
 
 namespace chip {
 
+template <class SESSION, class DATA>
+class PairingSessionWorkHelper;
+
 // TODO: temporary derive from Messaging::UnsolicitedMessageHandler, actually the CASEServer should be the umh, it will be fixed
 // when implementing concurrent CASE session.
 class DLL_EXPORT CASESession : public Messaging::UnsolicitedMessageHandler,
@@ -203,6 +206,8 @@ public:
         kFinishedViaResume   = 7,
         kSendSigma3Pending   = 8,
         kHandleSigma3Pending = 9,
+        kSendSigma2Pending   = 10,
+        kHandleSigma2Pending = 11,
     };
 
     State GetState() { return mState; }
@@ -237,9 +242,24 @@ private:
     CHIP_ERROR HandleSigma1(System::PacketBufferHandle && msg);
     CHIP_ERROR TryResumeSession(SessionResumptionStorage::ConstResumptionIdView resumptionId, ByteSpan resume1MIC,
                                 ByteSpan initiatorRandom);
-    CHIP_ERROR SendSigma2();
+    // Asks the delegate whether to go on with a handshake on mFabricIndex. If not, sends a busy status report
+    // and returns CHIP_ERROR_BUSY.
+    CHIP_ERROR CheckResponderCanAccept();
+
+    struct SendSigma2Data;
+    CHIP_ERROR SendSigma2a();
+    static CHIP_ERROR SendSigma2b(SendSigma2Data & data, bool & cancel);
+    CHIP_ERROR SendSigma2c(SendSigma2Data & data, CHIP_ERROR status);
+    static CHIP_ERROR SignSigma2(SendSigma2Data & data);
+
     CHIP_ERROR HandleSigma2_and_SendSigma3(System::PacketBufferHandle && msg);
-    CHIP_ERROR HandleSigma2(System::PacketBufferHandle && msg);
+
+    struct HandleSigma2Data;
+    CHIP_ERROR HandleSigma2a(System::PacketBufferHandle && msg);
+    static CHIP_ERROR HandleSigma2b(HandleSigma2Data & data, bool & cancel);
+    CHIP_ERROR HandleSigma2c(HandleSigma2Data & data, CHIP_ERROR status);
+    static CHIP_ERROR HandleSigma2d(HandleSigma2Data & data, bool & cancel);
+    CHIP_ERROR HandleSigma2e(HandleSigma2Data & data, CHIP_ERROR status);
     CHIP_ERROR HandleSigma2Resume(System::PacketBufferHandle && msg);
 
     struct SendSigma3Data;
@@ -257,8 +277,8 @@ private:
     CHIP_ERROR DeriveSigmaKey(const ByteSpan & salt, const ByteSpan & info, Crypto::AutoReleaseSessionKey & key) const;
     CHIP_ERROR ConstructSaltSigma2(const ByteSpan & rand, const Crypto::P256PublicKey & pubkey, const ByteSpan & ipk,
                                    MutableByteSpan & salt);
-    CHIP_ERROR ConstructTBSData(const ByteSpan & senderNOC, const ByteSpan & senderICAC, const ByteSpan & senderPubKey,
-                                const ByteSpan & receiverPubKey, uint8_t * tbsData, size_t & tbsDataLen);
+    static CHIP_ERROR ConstructTBSData(const ByteSpan & senderNOC, const ByteSpan & senderICAC, const ByteSpan & senderPubKey,
+                                       const ByteSpan & receiverPubKey, uint8_t * tbsData, size_t & tbsDataLen);
     CHIP_ERROR ConstructSaltSigma3(const ByteSpan & ipk, MutableByteSpan & salt);
 
     CHIP_ERROR ConstructSigmaResumeKey(const ByteSpan & initiatorRandom, const ByteSpan & resumptionID, const ByteSpan & skInfo,
@@ -278,6 +298,9 @@ private:
 
     CHIP_ERROR SetEffectiveTime();
 
+    // Returns true if the ephemeral keypair may be generated and used for ECDH on a background worker.
+    bool CanUseEphemeralKeypairInBackground() const;
+
     CHIP_ERROR ValidateReceivedMessage(Messaging::ExchangeContext * ec, const PayloadHeader & payloadHeader,
                                        const System::PacketBufferHandle & msg);
 
@@ -311,7 +334,9 @@ private:
     uint8_t mInitiatorRandom[kSigmaParamRandomNumberSize];
 
     template <class DATA>
-    class WorkHelper;
+    using WorkHelper = PairingSessionWorkHelper<CASESession, DATA>;
+    Platform::SharedPtr<WorkHelper<SendSigma2Data>> mSendSigma2Helper;
+    Platform::SharedPtr<WorkHelper<HandleSigma2Data>> mHandleSigma2Helper;
     Platform::SharedPtr<WorkHelper<SendSigma3Data>> mSendSigma3Helper;
     Platform::SharedPtr<WorkHelper<HandleSigma3Data>> mHandleSigma3Helper;
 
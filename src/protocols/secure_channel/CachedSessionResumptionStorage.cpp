@@ -0,0 +1,323 @@
+/*
+ *    Copyright (c) 2023 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <protocols/secure_channel/CachedSessionResumptionStorage.h>
+
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+#include <algorithm>
+
+namespace chip {
+
+CHIP_ERROR CachedSessionResumptionStorage::Init(PersistentStorageDelegate * storage, size_t capacity)
+{
+    VerifyOrReturnError(storage != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(capacity > 0 && capacity <= kMaxCapacity, CHIP_ERROR_INVALID_ARGUMENT);
+    ReturnErrorOnFailure(mRecords.Init(storage));
+    mStorage  = storage;
+    mCapacity = capacity;
+    Clear();
+
+    DefaultSessionResumptionStorage::SessionIndex index;
+    ReturnErrorOnFailure(mRecords.LoadIndex(index));
+
+    PersistentStorageBatch batch(mStorage);
+    bool indexChanged = false;
+
+    // The index lists the least recently used records first.
+    for (size_t i = 0; i < index.mSize; ++i)
+    {
+        Entry & entry  = mEntries[mCount];
+        entry.mNode    = index.mNodes[i];
+        CHIP_ERROR err = mRecords.LoadState(entry.mNode, entry.mResumptionId, entry.mSharedSecret, entry.mPeerCATs);
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(SecureChannel,
+                         "Dropping unreadable session resumption state for node " ChipLogFormatX64 ": %" CHIP_ERROR_FORMAT,
+                         ChipLogValueX64(entry.mNode.GetNodeId()), err.Format());
+            mRecords.DeleteState(entry.mNode);
+            entry.mSharedSecret = Crypto::P256ECDHDerivedSecret();
+            indexChanged        = true;
+            continue;
+        }
+        Touch(entry);
+        mCount++;
+    }
+
+    while (mCount > mCapacity)
+    {
+        Entry * entry = FindLeastRecentlyUsed();
+        DeleteRecords(*entry);
+        RemoveEntry(*entry);
+        indexChanged = true;
+    }
+
+    // Cleaning up is best effort: the remaining records are usable either way.
+    CHIP_ERROR err = indexChanged ? SaveIndex() : CHIP_NO_ERROR;
+    if (err == CHIP_NO_ERROR)
+    {
+        err = batch.Commit();
+    }
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(SecureChannel, "Unable to save session resumption index: %" CHIP_ERROR_FORMAT, err.Format());
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR CachedSessionResumptionStorage::FindByScopedNodeId(const ScopedNodeId & node, ResumptionIdStorage & resumptionId,
+                                                              Crypto::P256ECDHDerivedSecret & sharedSecret, CATValues & peerCATs)
+{
+    Entry * entry = FindEntry(node);
+    VerifyOrReturnError(entry != nullptr, CHIP_ERROR_KEY_NOT_FOUND);
+
+    resumptionId = entry->mResumptionId;
+    sharedSecret = entry->mSharedSecret;
+    peerCATs     = entry->mPeerCATs;
+    Touch(*entry);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR CachedSessionResumptionStorage::FindByResumptionId(ConstResumptionIdView resumptionId, ScopedNodeId & node,
+                                                              Crypto::P256ECDHDerivedSecret & sharedSecret, CATValues & peerCATs)
+{
+    Entry * entry = FindEntry(resumptionId);
+    VerifyOrReturnError(entry != nullptr, CHIP_ERROR_KEY_NOT_FOUND);
+
+    node         = entry->mNode;
+    sharedSecret = entry->mSharedSecret;
+    peerCATs     = entry->mPeerCATs;
+    Touch(*entry);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR CachedSessionResumptionStorage::Save(const ScopedNodeId & node, ConstResumptionIdView resumptionId,
+                                                const Crypto::P256ECDHDerivedSecret & sharedSecret, const CATValues & peerCATs)
+{
+    VerifyOrReturnError(mStorage != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    PersistentStorageBatch batch(mStorage);
+    Entry * entry = FindEntry(node);
+    if (entry != nullptr)
+    {
+        // Known peer: replace its records in place, the index is unchanged.
+        if (!std::equal(entry->mResumptionId.begin(), entry->mResumptionId.end(), resumptionId.begin(), resumptionId.end()))
+        {
+            CHIP_ERROR err = mRecords.DeleteLink(entry->mResumptionId);
+            if (err != CHIP_NO_ERROR && err != CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
+            {
+                ChipLogError(SecureChannel,
+                             "Unable to delete session resumption link for node " ChipLogFormatX64 ": %" CHIP_ERROR_FORMAT,
+                             ChipLogValueX64(node.GetNodeId()), err.Format());
+            }
+        }
+        ReturnErrorOnFailure(mRecords.SaveState(node, resumptionId, sharedSecret, peerCATs));
+        ReturnErrorOnFailure(mRecords.SaveLink(resumptionId, node));
+        ReturnErrorOnFailure(batch.Commit());
+    }
+    else
+    {
+        Entry * evicted = (mCount == mCapacity) ? FindLeastRecentlyUsed() : nullptr;
+        if (evicted != nullptr)
+        {
+            DeleteRecords(*evicted);
+        }
+        ReturnErrorOnFailure(mRecords.SaveState(node, resumptionId, sharedSecret, peerCATs));
+        ReturnErrorOnFailure(mRecords.SaveLink(resumptionId, node));
+        ReturnErrorOnFailure(SaveIndex(evicted, &node));
+        ReturnErrorOnFailure(batch.Commit());
+
+        if (evicted != nullptr)
+        {
+            RemoveEntry(*evicted);
+        }
+        entry        = &mEntries[mCount++];
+        entry->mNode = node;
+    }
+
+    std::copy(resumptionId.begin(), resumptionId.end(), entry->mResumptionId.begin());
+    entry->mSharedSecret = sharedSecret;
+    entry->mPeerCATs     = peerCATs;
+    Touch(*entry);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR CachedSessionResumptionStorage::Delete(const ScopedNodeId & node)
+{
+    Entry * entry = FindEntry(node);
+    VerifyOrReturnError(entry != nullptr, CHIP_NO_ERROR);
+
+    PersistentStorageBatch batch(mStorage);
+    CHIP_ERROR err      = DeleteRecords(*entry);
+    CHIP_ERROR indexErr = SaveIndex(entry);
+    RemoveEntry(*entry);
+
+    CHIP_ERROR commitErr = batch.Commit();
+    if (err == CHIP_NO_ERROR)
+    {
+        err = (indexErr != CHIP_NO_ERROR) ? indexErr : commitErr;
+    }
+    return err;
+}
+
+CHIP_ERROR CachedSessionResumptionStorage::DeleteAll(FabricIndex fabricIndex)
+{
+    PersistentStorageBatch batch(mStorage);
+    CHIP_ERROR stickyErr = CHIP_NO_ERROR;
+    bool found           = false;
+
+    for (size_t i = 0; i < mCount;)
+    {
+        Entry & entry = mEntries[i];
+        if (entry.mNode.GetFabricIndex() != fabricIndex)
+        {
+            ++i;
+            continue;
+        }
+
+        // The records of the fabric are no longer usable, even if they could not be deleted.
+        CHIP_ERROR err = DeleteRecords(entry);
+        stickyErr      = stickyErr == CHIP_NO_ERROR ? err : stickyErr;
+        RemoveEntry(entry);
+        found = true;
+    }
+
+    if (found)
+    {
+        CHIP_ERROR err = SaveIndex();
+        stickyErr      = stickyErr == CHIP_NO_ERROR ? err : stickyErr;
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(SecureChannel,
+                         "Unable to save session resumption index during deletion of fabric index %u: %" CHIP_ERROR_FORMAT,
+                         fabricIndex, err.Format());
+        }
+    }
+
+    CHIP_ERROR err = batch.Commit();
+    return stickyErr == CHIP_NO_ERROR ? err : stickyErr;
+}
+
+CachedSessionResumptionStorage::Entry * CachedSessionResumptionStorage::FindEntry(const ScopedNodeId & node)
+{
+    for (size_t i = 0; i < mCount; ++i)
+    {
+        if (mEntries[i].mNode == node)
+        {
+            return &mEntries[i];
+        }
+    }
+    return nullptr;
+}
+
+CachedSessionResumptionStorage::Entry * CachedSessionResumptionStorage::FindEntry(ConstResumptionIdView resumptionId)
+{
+    for (size_t i = 0; i < mCount; ++i)
+    {
+        const ResumptionIdStorage & entryId = mEntries[i].mResumptionId;
+        if (std::equal(entryId.begin(), entryId.end(), resumptionId.begin(), resumptionId.end()))
+        {
+            return &mEntries[i];
+        }
+    }
+    return nullptr;
+}
+
+CachedSessionResumptionStorage::Entry * CachedSessionResumptionStorage::FindLeastRecentlyUsed()
+{
+    VerifyOrReturnValue(mCount > 0, nullptr);
+    return std::min_element(&mEntries[0], &mEntries[mCount],
+                            [](const Entry & a, const Entry & b) { return a.mLastUse < b.mLastUse; });
+}
+
+void CachedSessionResumptionStorage::RemoveEntry(Entry & entry)
+{
+    Entry & last = mEntries[mCount - 1];
+    if (&entry != &last)
+    {
+        entry = last;
+    }
+    last.mSharedSecret = Crypto::P256ECDHDerivedSecret();
+    mCount--;
+}
+
+void CachedSessionResumptionStorage::Clear()
+{
+    for (auto & entry : mEntries)
+    {
+        entry.mSharedSecret = Crypto::P256ECDHDerivedSecret();
+    }
+    mCount = 0;
+}
+
+CHIP_ERROR CachedSessionResumptionStorage::DeleteRecords(const Entry & entry)
+{
+    CHIP_ERROR linkErr = mRecords.DeleteLink(entry.mResumptionId);
+    if (linkErr == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
+    {
+        linkErr = CHIP_NO_ERROR;
+    }
+    if (linkErr != CHIP_NO_ERROR)
+    {
+        ChipLogError(SecureChannel, "Unable to delete session resumption link for node " ChipLogFormatX64 ": %" CHIP_ERROR_FORMAT,
+                     ChipLogValueX64(entry.mNode.GetNodeId()), linkErr.Format());
+    }
+
+    CHIP_ERROR stateErr = mRecords.DeleteState(entry.mNode);
+    if (stateErr == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
+    {
+        stateErr = CHIP_NO_ERROR;
+    }
+    if (stateErr != CHIP_NO_ERROR)
+    {
+        ChipLogError(SecureChannel, "Unable to delete session resumption state for node " ChipLogFormatX64 ": %" CHIP_ERROR_FORMAT,
+                     ChipLogValueX64(entry.mNode.GetNodeId()), stateErr.Format());
+    }
+
+    return (linkErr != CHIP_NO_ERROR) ? linkErr : stateErr;
+}
+
+CHIP_ERROR CachedSessionResumptionStorage::SaveIndex(const Entry * exclude, const ScopedNodeId * include)
+{
+    const Entry * entries[kMaxCapacity];
+    size_t count = 0;
+    for (size_t i = 0; i < mCount; ++i)
+    {
+        if (&mEntries[i] != exclude)
+        {
+            entries[count++] = &mEntries[i];
+        }
+    }
+    std::sort(&entries[0], &entries[count], [](const Entry * a, const Entry * b) { return a->mLastUse < b->mLastUse; });
+
+    DefaultSessionResumptionStorage::SessionIndex index;
+    index.mSize = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        index.mNodes[index.mSize++] = entries[i]->mNode;
+    }
+    if (include != nullptr)
+    {
+        VerifyOrReturnError(index.mSize < ArraySize(index.mNodes), CHIP_ERROR_NO_MEMORY);
+        index.mNodes[index.mSize++] = *include;
+    }
+    return mRecords.SaveIndex(index);
+}
+
+} // namespace chip
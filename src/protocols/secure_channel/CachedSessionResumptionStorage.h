@@ -0,0 +1,101 @@
+/*
+ *    Copyright (c) 2023 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <lib/core/CHIPPersistentStorageDelegate.h>
+#include <protocols/secure_channel/SimpleSessionResumptionStorage.h>
+
+namespace chip {
+
+/**
+ * @brief SessionResumptionStorage that keeps all the resumption records in memory.
+ *
+ *   The records are loaded from storage once, on Init, and are then looked up by either ScopedNodeId or
+ *   ResumptionId without any storage access. Changes are written through to storage as they are made, in
+ *   the format of SimpleSessionResumptionStorage, so that both implementations can be swapped over the
+ *   same persisted data.
+ *
+ *   When full, saving the record of a new peer evicts the least recently used record, a record being
+ *   used when saved or found. The persisted index is kept in least recently used order, so that it is
+ *   mostly preserved across reboots.
+ */
+class CachedSessionResumptionStorage : public SessionResumptionStorage
+{
+public:
+    static constexpr size_t kMaxCapacity = CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE;
+
+    CachedSessionResumptionStorage() = default;
+    ~CachedSessionResumptionStorage() override { Clear(); }
+
+    CachedSessionResumptionStorage(const CachedSessionResumptionStorage &)             = delete;
+    CachedSessionResumptionStorage & operator=(const CachedSessionResumptionStorage &) = delete;
+
+    /**
+     * Loads the persisted resumption records.
+     *
+     * @param storage   Storage of the resumption records.
+     * @param capacity  Maximum number of records kept, at most kMaxCapacity. Persisted records in excess
+     *                  are deleted, least recently used first.
+     */
+    CHIP_ERROR Init(PersistentStorageDelegate * storage, size_t capacity = kMaxCapacity);
+
+    CHIP_ERROR FindByScopedNodeId(const ScopedNodeId & node, ResumptionIdStorage & resumptionId,
+                                  Crypto::P256ECDHDerivedSecret & sharedSecret, CATValues & peerCATs) override;
+    CHIP_ERROR FindByResumptionId(ConstResumptionIdView resumptionId, ScopedNodeId & node,
+                                  Crypto::P256ECDHDerivedSecret & sharedSecret, CATValues & peerCATs) override;
+    CHIP_ERROR Save(const ScopedNodeId & node, ConstResumptionIdView resumptionId,
+                    const Crypto::P256ECDHDerivedSecret & sharedSecret, const CATValues & peerCATs) override;
+    CHIP_ERROR Delete(const ScopedNodeId & node);
+    CHIP_ERROR DeleteAll(FabricIndex fabricIndex) override;
+
+    size_t GetCount() const { return mCount; }
+    size_t GetCapacity() const { return mCapacity; }
+
+private:
+    struct Entry
+    {
+        ScopedNodeId mNode;
+        ResumptionIdStorage mResumptionId;
+        Crypto::P256ECDHDerivedSecret mSharedSecret;
+        CATValues mPeerCATs;
+        uint32_t mLastUse = 0;
+    };
+
+    Entry * FindEntry(const ScopedNodeId & node);
+    Entry * FindEntry(ConstResumptionIdView resumptionId);
+    Entry * FindLeastRecentlyUsed();
+    void Touch(Entry & entry) { entry.mLastUse = ++mUseCounter; }
+    void RemoveEntry(Entry & entry);
+    void Clear();
+
+    // Deletes the persisted records of an entry, logging failures.
+    CHIP_ERROR DeleteRecords(const Entry & entry);
+
+    // Persists the index of the current entries, minus `exclude` and plus `include` when given.
+    CHIP_ERROR SaveIndex(const Entry * exclude = nullptr, const ScopedNodeId * include = nullptr);
+
+    SimpleSessionResumptionStorage mRecords;
+    PersistentStorageDelegate * mStorage = nullptr;
+
+    Entry mEntries[kMaxCapacity];
+    size_t mCount        = 0;
+    size_t mCapacity     = 0;
+    uint32_t mUseCounter = 0;
+};
+
+} // namespace chip
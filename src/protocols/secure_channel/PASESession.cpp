@@ -41,6 +41,7 @@
 #include <lib/support/TypeTraits.h>
 #include <protocols/Protocols.h>
 #include <protocols/secure_channel/Constants.h>
+#include <protocols/secure_channel/PairingSessionWorkHelper.h>
 #include <protocols/secure_channel/StatusReport.h>
 #include <setup_payload/SetupPayload.h>
 #include <system/TLVPacketBufferBackingStore.h>
@@ -67,6 +68,47 @@ const char * kSpake2pR2ISessionInfo = "Commissioning R2I Key";
 static constexpr ExchangeContext::Timeout kExpectedLowProcessingTime  = System::Clock::Seconds16(2);
 static constexpr ExchangeContext::Timeout kExpectedHighProcessingTime = System::Clock::Seconds16(30);
 
+struct PASESession::SendMsg1Data
+{
+    Platform::UniquePtr<Spake2p_P256_SHA256_HKDF_HMAC> spake2p;
+
+    uint32_t iterationCount;
+    uint8_t salt[kSpake2p_Max_PBKDF_Salt_Length];
+    size_t saltLength;
+    uint32_t setupPINCode;
+
+    uint8_t X[kMAX_Point_Length];
+    size_t X_len;
+};
+
+struct PASESession::HandleMsg1Data
+{
+    Platform::UniquePtr<Spake2p_P256_SHA256_HKDF_HMAC> spake2p;
+
+    uint8_t X[kMAX_Point_Length];
+    size_t X_len;
+
+    uint8_t Y[kMAX_Point_Length];
+    size_t Y_len;
+
+    uint8_t verifier[kMAX_Hash_Length];
+    size_t verifier_len;
+};
+
+struct PASESession::HandleMsg2Data
+{
+    Platform::UniquePtr<Spake2p_P256_SHA256_HKDF_HMAC> spake2p;
+
+    uint8_t Y[kMAX_Point_Length];
+    size_t Y_len;
+
+    uint8_t peer_verifier[kMAX_Hash_Length];
+    size_t peer_verifier_len;
+
+    uint8_t verifier[kMAX_Hash_Length];
+    size_t verifier_len;
+};
+
 PASESession::~PASESession()
 {
     // Let's clear out any security state stored in the object, before destroying it.
@@ -88,13 +130,30 @@ void PASESession::Finish()
 
 void PASESession::Clear()
 {
+    // Cancel any outstanding work.
+    if (mSendMsg1Helper)
+    {
+        mSendMsg1Helper->CancelWork();
+        mSendMsg1Helper.reset();
+    }
+    if (mHandleMsg1Helper)
+    {
+        mHandleMsg1Helper->CancelWork();
+        mHandleMsg1Helper.reset();
+    }
+    if (mHandleMsg2Helper)
+    {
+        mHandleMsg2Helper->CancelWork();
+        mHandleMsg2Helper.reset();
+    }
+
     // This function zeroes out and resets the memory used by the object.
     // It's done so that no security related information will be leaked.
     memset(&mPASEVerifier, 0, sizeof(mPASEVerifier));
     memset(&mKe[0], 0, sizeof(mKe));
     mNextExpectedMsg.ClearValue();
 
-    mSpake2p.Clear();
+    mSpake2p.reset();
     mCommissioningHash.Clear();
 
     mIterationCount = 0;
@@ -154,7 +213,10 @@ CHIP_ERROR PASESession::SetupSpake2p()
     MutableByteSpan contextSpan{ context };
 
     ReturnErrorOnFailure(mCommissioningHash.Finish(contextSpan));
-    ReturnErrorOnFailure(mSpake2p.Init(contextSpan.data(), contextSpan.size()));
+
+    mSpake2p = Platform::MakeUnique<Spake2p_P256_SHA256_HKDF_HMAC>();
+    VerifyOrReturnError(mSpake2p, CHIP_ERROR_NO_MEMORY);
+    ReturnErrorOnFailure(mSpake2p->Init(contextSpan.data(), contextSpan.size()));
 
     return CHIP_NO_ERROR;
 }
@@ -448,7 +510,6 @@ CHIP_ERROR PASESession::HandlePBKDFParamResponse(System::PacketBufferHandle && m
 
     uint32_t decodeTagIdSeq = 0;
     ByteSpan salt;
-    uint8_t serializedWS[kSpake2p_WS_Length * 2] = { 0 };
 
     ChipLogDetail(SecureChannel, "Received PBKDF param response");
 
@@ -513,14 +574,7 @@ CHIP_ERROR PASESession::HandlePBKDFParamResponse(System::PacketBufferHandle && m
     err = SetupSpake2p();
     SuccessOrExit(err);
 
-    err = Spake2pVerifier::ComputeWS(mIterationCount, salt, mSetupPINCode, serializedWS, sizeof(serializedWS));
-    SuccessOrExit(err);
-
-    err = mSpake2p.BeginProver(nullptr, 0, nullptr, 0, &serializedWS[0], kSpake2p_WS_Length, &serializedWS[kSpake2p_WS_Length],
-                               kSpake2p_WS_Length);
-    SuccessOrExit(err);
-
-    err = SendMsg1();
+    err = SendMsg1a(salt);
     SuccessOrExit(err);
 
 exit:
@@ -531,50 +585,98 @@ exit:
     return err;
 }
 
-CHIP_ERROR PASESession::SendMsg1()
+CHIP_ERROR PASESession::SendMsg1a(const ByteSpan & salt)
 {
     MATTER_TRACE_SCOPE("SendMsg1", "PASESession");
+
+    VerifyOrReturnError(mSpake2p, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(salt.size() <= kSpake2p_Max_PBKDF_Salt_Length, CHIP_ERROR_INVALID_ARGUMENT);
+
+    auto helper = WorkHelper<SendMsg1Data>::Create(*this, &SendMsg1b, &PASESession::SendMsg1c);
+    VerifyOrReturnError(helper, CHIP_ERROR_NO_MEMORY);
+    auto & data = helper->mData;
+
+    // NOTE: the PBKDF2 derivation of w0/w1 and the prover's round one happen in background.
+    data.iterationCount = mIterationCount;
+    memcpy(data.salt, salt.data(), salt.size());
+    data.saltLength   = salt.size();
+    data.setupPINCode = mSetupPINCode;
+    data.spake2p      = std::move(mSpake2p);
+
+    ReturnErrorOnFailure(helper->ScheduleWork());
+    mSendMsg1Helper = helper;
+    mNextExpectedMsg.ClearValue();
+    mExchangeCtxt->WillSendMessage();
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR PASESession::SendMsg1b(SendMsg1Data & data, bool & cancel)
+{
+    uint8_t serializedWS[kSpake2p_WS_Length * 2] = { 0 };
+
+    ReturnErrorOnFailure(Spake2pVerifier::ComputeWS(data.iterationCount, ByteSpan(data.salt, data.saltLength), data.setupPINCode,
+                                                    serializedWS, sizeof(serializedWS)));
+
+    ReturnErrorOnFailure(data.spake2p->BeginProver(nullptr, 0, nullptr, 0, &serializedWS[0], kSpake2p_WS_Length,
+                                                   &serializedWS[kSpake2p_WS_Length], kSpake2p_WS_Length));
+
+    data.X_len = sizeof(data.X);
+    ReturnErrorOnFailure(data.spake2p->ComputeRoundOne(nullptr, 0, data.X, &data.X_len));
+    VerifyOrReturnError(data.X_len == sizeof(data.X), CHIP_ERROR_INTERNAL);
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR PASESession::SendMsg1c(SendMsg1Data & data, CHIP_ERROR status)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+
     const size_t max_msg_len       = TLV::EstimateStructOverhead(kMAX_Point_Length);
     System::PacketBufferHandle msg = System::PacketBufferHandle::New(max_msg_len);
-    VerifyOrReturnError(!msg.IsNull(), CHIP_ERROR_NO_MEMORY);
 
     System::PacketBufferTLVWriter tlvWriter;
-    tlvWriter.Init(std::move(msg));
-
     TLV::TLVType outerContainerType = TLV::kTLVType_NotSpecified;
-    ReturnErrorOnFailure(tlvWriter.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outerContainerType));
-
-    uint8_t X[kMAX_Point_Length];
-    size_t X_len = sizeof(X);
 
     constexpr uint8_t kPake1_pA = 1;
 
-    ReturnErrorOnFailure(mSpake2p.ComputeRoundOne(nullptr, 0, X, &X_len));
-    VerifyOrReturnError(X_len == sizeof(X), CHIP_ERROR_INTERNAL);
-    ReturnErrorOnFailure(tlvWriter.Put(TLV::ContextTag(kPake1_pA), ByteSpan(X)));
-    ReturnErrorOnFailure(tlvWriter.EndContainer(outerContainerType));
-    ReturnErrorOnFailure(tlvWriter.Finalize(&msg));
+    mSpake2p = std::move(data.spake2p);
 
-    ReturnErrorOnFailure(
-        mExchangeCtxt->SendMessage(MsgType::PASE_Pake1, std::move(msg), SendFlags(SendMessageFlags::kExpectResponse)));
+    SuccessOrExit(err = status);
+    VerifyOrExit(!msg.IsNull(), err = CHIP_ERROR_NO_MEMORY);
+
+    tlvWriter.Init(std::move(msg));
+    SuccessOrExit(err = tlvWriter.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outerContainerType));
+    SuccessOrExit(err = tlvWriter.Put(TLV::ContextTag(kPake1_pA), ByteSpan(data.X, data.X_len)));
+    SuccessOrExit(err = tlvWriter.EndContainer(outerContainerType));
+    SuccessOrExit(err = tlvWriter.Finalize(&msg));
+
+    SuccessOrExit(err = mExchangeCtxt->SendMessage(MsgType::PASE_Pake1, std::move(msg),
+                                                   SendFlags(SendMessageFlags::kExpectResponse)));
     ChipLogDetail(SecureChannel, "Sent spake2p msg1");
 
     mNextExpectedMsg.SetValue(MsgType::PASE_Pake2);
 
-    return CHIP_NO_ERROR;
+exit:
+    mSendMsg1Helper.reset();
+
+    // Processing occurred in the background, so on error need to send the status report (normally
+    // occurs in HandlePBKDFParamResponse), and discard the exchange and abort pending establish
+    // (normally occurs in OnMessageReceived).
+    if (err != CHIP_NO_ERROR)
+    {
+        SendStatusReport(mExchangeCtxt, kProtocolCodeInvalidParam);
+        DiscardExchange();
+        AbortPendingEstablish(err);
+    }
+
+    return err;
 }
 
-CHIP_ERROR PASESession::HandleMsg1_and_SendMsg2(System::PacketBufferHandle && msg1)
+CHIP_ERROR PASESession::HandleMsg1_and_SendMsg2a(System::PacketBufferHandle && msg1)
 {
     MATTER_TRACE_SCOPE("HandleMsg1_and_SendMsg2", "PASESession");
     CHIP_ERROR err = CHIP_NO_ERROR;
 
-    uint8_t Y[kMAX_Point_Length];
-    size_t Y_len = sizeof(Y);
-
-    uint8_t verifier[kMAX_Hash_Length];
-    size_t verifier_len = kMAX_Hash_Length;
-
     ChipLogDetail(SecureChannel, "Received spake2p msg1");
 
     System::PacketBufferTLVReader tlvReader;
@@ -583,6 +685,10 @@ CHIP_ERROR PASESession::HandleMsg1_and_SendMsg2(System::PacketBufferHandle && ms
     const uint8_t * X;
     size_t X_len = 0;
 
+    auto helper = WorkHelper<HandleMsg1Data>::Create(*this, &HandleMsg1_and_SendMsg2b, &PASESession::HandleMsg1_and_SendMsg2c);
+    VerifyOrExit(helper, err = CHIP_ERROR_NO_MEMORY);
+    VerifyOrExit(mSpake2p, err = CHIP_ERROR_INCORRECT_STATE);
+
     tlvReader.Init(std::move(msg1));
     SuccessOrExit(err = tlvReader.Next(containerType, TLV::AnonymousTag()));
     SuccessOrExit(err = tlvReader.EnterContainer(containerType));
@@ -590,17 +696,56 @@ CHIP_ERROR PASESession::HandleMsg1_and_SendMsg2(System::PacketBufferHandle && ms
     SuccessOrExit(err = tlvReader.Next());
     VerifyOrExit(TLV::TagNumFromTag(tlvReader.GetTag()) == 1, err = CHIP_ERROR_INVALID_TLV_TAG);
     X_len = tlvReader.GetLength();
+    VerifyOrExit(X_len <= sizeof(helper->mData.X), err = CHIP_ERROR_INVALID_MESSAGE_LENGTH);
     SuccessOrExit(err = tlvReader.GetDataPtr(X));
-    SuccessOrExit(err = mSpake2p.BeginVerifier(nullptr, 0, nullptr, 0, mPASEVerifier.mW0, kP256_FE_Length, mPASEVerifier.mL,
-                                               kP256_Point_Length));
+    SuccessOrExit(err = mSpake2p->BeginVerifier(nullptr, 0, nullptr, 0, mPASEVerifier.mW0, kP256_FE_Length, mPASEVerifier.mL,
+                                                kP256_Point_Length));
 
-    SuccessOrExit(err = mSpake2p.ComputeRoundOne(X, X_len, Y, &Y_len));
-    VerifyOrReturnError(Y_len == sizeof(Y), CHIP_ERROR_INTERNAL);
-    SuccessOrExit(err = mSpake2p.ComputeRoundTwo(X, X_len, verifier, &verifier_len));
+    {
+        // NOTE: the verifier's rounds one and two happen in background.
+        auto & data = helper->mData;
+        memcpy(data.X, X, X_len);
+        data.X_len   = X_len;
+        data.spake2p = std::move(mSpake2p);
+    }
     msg1 = nullptr;
 
+    SuccessOrExit(err = helper->ScheduleWork());
+    mHandleMsg1Helper = helper;
+    mNextExpectedMsg.ClearValue();
+    mExchangeCtxt->WillSendMessage();
+
+exit:
+
+    if (err != CHIP_NO_ERROR)
     {
-        const size_t max_msg_len    = TLV::EstimateStructOverhead(Y_len, verifier_len);
+        SendStatusReport(mExchangeCtxt, kProtocolCodeInvalidParam);
+    }
+    return err;
+}
+
+CHIP_ERROR PASESession::HandleMsg1_and_SendMsg2b(HandleMsg1Data & data, bool & cancel)
+{
+    data.Y_len = sizeof(data.Y);
+    ReturnErrorOnFailure(data.spake2p->ComputeRoundOne(data.X, data.X_len, data.Y, &data.Y_len));
+    VerifyOrReturnError(data.Y_len == sizeof(data.Y), CHIP_ERROR_INTERNAL);
+
+    data.verifier_len = sizeof(data.verifier);
+    ReturnErrorOnFailure(data.spake2p->ComputeRoundTwo(data.X, data.X_len, data.verifier, &data.verifier_len));
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR PASESession::HandleMsg1_and_SendMsg2c(HandleMsg1Data & data, CHIP_ERROR status)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+
+    mSpake2p = std::move(data.spake2p);
+
+    SuccessOrExit(err = status);
+
+    {
+        const size_t max_msg_len    = TLV::EstimateStructOverhead(data.Y_len, data.verifier_len);
         constexpr uint8_t kPake2_pB = 1;
         constexpr uint8_t kPake2_cB = 2;
 
@@ -612,8 +757,8 @@ CHIP_ERROR PASESession::HandleMsg1_and_SendMsg2(System::PacketBufferHandle && ms
 
         TLV::TLVType outerContainerType = TLV::kTLVType_NotSpecified;
         SuccessOrExit(err = tlvWriter.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outerContainerType));
-        SuccessOrExit(err = tlvWriter.Put(TLV::ContextTag(kPake2_pB), ByteSpan(Y)));
-        SuccessOrExit(err = tlvWriter.Put(TLV::ContextTag(kPake2_cB), ByteSpan(verifier, verifier_len)));
+        SuccessOrExit(err = tlvWriter.Put(TLV::ContextTag(kPake2_pB), ByteSpan(data.Y, data.Y_len)));
+        SuccessOrExit(err = tlvWriter.Put(TLV::ContextTag(kPake2_cB), ByteSpan(data.verifier, data.verifier_len)));
         SuccessOrExit(err = tlvWriter.EndContainer(outerContainerType));
         SuccessOrExit(err = tlvWriter.Finalize(&msg2));
 
@@ -626,24 +771,22 @@ CHIP_ERROR PASESession::HandleMsg1_and_SendMsg2(System::PacketBufferHandle && ms
     ChipLogDetail(SecureChannel, "Sent spake2p msg2");
 
 exit:
+    mHandleMsg1Helper.reset();
 
     if (err != CHIP_NO_ERROR)
     {
         SendStatusReport(mExchangeCtxt, kProtocolCodeInvalidParam);
+        DiscardExchange();
+        AbortPendingEstablish(err);
     }
     return err;
 }
 
-CHIP_ERROR PASESession::HandleMsg2_and_SendMsg3(System::PacketBufferHandle && msg2)
+CHIP_ERROR PASESession::HandleMsg2_and_SendMsg3a(System::PacketBufferHandle && msg2)
 {
     MATTER_TRACE_SCOPE("HandleMsg2_and_SendMsg3", "PASESession");
     CHIP_ERROR err = CHIP_NO_ERROR;
 
-    uint8_t verifier[kMAX_Hash_Length];
-    size_t verifier_len = kMAX_Hash_Length;
-
-    System::PacketBufferHandle resp;
-
     ChipLogDetail(SecureChannel, "Received spake2p msg2");
 
     System::PacketBufferTLVReader tlvReader;
@@ -657,6 +800,10 @@ CHIP_ERROR PASESession::HandleMsg2_and_SendMsg3(System::PacketBufferHandle && ms
 
     uint32_t decodeTagIdSeq = 0;
 
+    auto helper = WorkHelper<HandleMsg2Data>::Create(*this, &HandleMsg2_and_SendMsg3b, &PASESession::HandleMsg2_and_SendMsg3c);
+    VerifyOrExit(helper, err = CHIP_ERROR_NO_MEMORY);
+    VerifyOrExit(mSpake2p, err = CHIP_ERROR_INCORRECT_STATE);
+
     tlvReader.Init(std::move(msg2));
     SuccessOrExit(err = tlvReader.Next(containerType, TLV::AnonymousTag()));
     SuccessOrExit(err = tlvReader.EnterContainer(containerType));
@@ -664,21 +811,60 @@ CHIP_ERROR PASESession::HandleMsg2_and_SendMsg3(System::PacketBufferHandle && ms
     SuccessOrExit(err = tlvReader.Next());
     VerifyOrExit(TLV::TagNumFromTag(tlvReader.GetTag()) == ++decodeTagIdSeq, err = CHIP_ERROR_INVALID_TLV_TAG);
     Y_len = tlvReader.GetLength();
+    VerifyOrExit(Y_len <= sizeof(helper->mData.Y), err = CHIP_ERROR_INVALID_MESSAGE_LENGTH);
     SuccessOrExit(err = tlvReader.GetDataPtr(Y));
 
     SuccessOrExit(err = tlvReader.Next());
     VerifyOrExit(TLV::TagNumFromTag(tlvReader.GetTag()) == ++decodeTagIdSeq, err = CHIP_ERROR_INVALID_TLV_TAG);
     peer_verifier_len = tlvReader.GetLength();
+    VerifyOrExit(peer_verifier_len <= sizeof(helper->mData.peer_verifier), err = CHIP_ERROR_INVALID_MESSAGE_LENGTH);
     SuccessOrExit(err = tlvReader.GetDataPtr(peer_verifier));
 
-    SuccessOrExit(err = mSpake2p.ComputeRoundTwo(Y, Y_len, verifier, &verifier_len));
-
-    SuccessOrExit(err = mSpake2p.KeyConfirm(peer_verifier, peer_verifier_len));
-    SuccessOrExit(err = mSpake2p.GetKeys(mKe, &mKeLen));
+    {
+        // NOTE: the prover's round two and key confirmation happen in background.
+        auto & data = helper->mData;
+        memcpy(data.Y, Y, Y_len);
+        data.Y_len = Y_len;
+        memcpy(data.peer_verifier, peer_verifier, peer_verifier_len);
+        data.peer_verifier_len = peer_verifier_len;
+        data.spake2p           = std::move(mSpake2p);
+    }
     msg2 = nullptr;
 
+    SuccessOrExit(err = helper->ScheduleWork());
+    mHandleMsg2Helper = helper;
+    mNextExpectedMsg.ClearValue();
+    mExchangeCtxt->WillSendMessage();
+
+exit:
+
+    if (err != CHIP_NO_ERROR)
+    {
+        SendStatusReport(mExchangeCtxt, kProtocolCodeInvalidParam);
+    }
+    return err;
+}
+
+CHIP_ERROR PASESession::HandleMsg2_and_SendMsg3b(HandleMsg2Data & data, bool & cancel)
+{
+    data.verifier_len = sizeof(data.verifier);
+    ReturnErrorOnFailure(data.spake2p->ComputeRoundTwo(data.Y, data.Y_len, data.verifier, &data.verifier_len));
+    ReturnErrorOnFailure(data.spake2p->KeyConfirm(data.peer_verifier, data.peer_verifier_len));
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR PASESession::HandleMsg2_and_SendMsg3c(HandleMsg2Data & data, CHIP_ERROR status)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+
+    mSpake2p = std::move(data.spake2p);
+
+    SuccessOrExit(err = status);
+    SuccessOrExit(err = mSpake2p->GetKeys(mKe, &mKeLen));
+
     {
-        const size_t max_msg_len    = TLV::EstimateStructOverhead(verifier_len);
+        const size_t max_msg_len    = TLV::EstimateStructOverhead(data.verifier_len);
         constexpr uint8_t kPake3_cB = 1;
 
         System::PacketBufferHandle msg3 = System::PacketBufferHandle::New(max_msg_len);
@@ -689,7 +875,7 @@ CHIP_ERROR PASESession::HandleMsg2_and_SendMsg3(System::PacketBufferHandle && ms
 
         TLV::TLVType outerContainerType = TLV::kTLVType_NotSpecified;
         SuccessOrExit(err = tlvWriter.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outerContainerType));
-        SuccessOrExit(err = tlvWriter.Put(TLV::ContextTag(kPake3_cB), ByteSpan(verifier, verifier_len)));
+        SuccessOrExit(err = tlvWriter.Put(TLV::ContextTag(kPake3_cB), ByteSpan(data.verifier, data.verifier_len)));
         SuccessOrExit(err = tlvWriter.EndContainer(outerContainerType));
         SuccessOrExit(err = tlvWriter.Finalize(&msg3));
 
@@ -702,10 +888,13 @@ CHIP_ERROR PASESession::HandleMsg2_and_SendMsg3(System::PacketBufferHandle && ms
     ChipLogDetail(SecureChannel, "Sent spake2p msg3");
 
 exit:
+    mHandleMsg2Helper.reset();
 
     if (err != CHIP_NO_ERROR)
     {
         SendStatusReport(mExchangeCtxt, kProtocolCodeInvalidParam);
+        DiscardExchange();
+        AbortPendingEstablish(err);
     }
     return err;
 }
@@ -736,8 +925,9 @@ CHIP_ERROR PASESession::HandleMsg3(System::PacketBufferHandle && msg)
 
     VerifyOrExit(peer_verifier_len == kMAX_Hash_Length, err = CHIP_ERROR_INVALID_MESSAGE_LENGTH);
 
-    SuccessOrExit(err = mSpake2p.KeyConfirm(peer_verifier, peer_verifier_len));
-    SuccessOrExit(err = mSpake2p.GetKeys(mKe, &mKeLen));
+    VerifyOrExit(mSpake2p, err = CHIP_ERROR_INCORRECT_STATE);
+    SuccessOrExit(err = mSpake2p->KeyConfirm(peer_verifier, peer_verifier_len));
+    SuccessOrExit(err = mSpake2p->GetKeys(mKe, &mKeLen));
 
     // Send confirmation to peer that we succeeded so they can start using the session.
     SendStatusReport(mExchangeCtxt, kProtocolCodeSuccess);
@@ -844,11 +1034,11 @@ CHIP_ERROR PASESession::OnMessageReceived(ExchangeContext * exchange, const Payl
         break;
 
     case MsgType::PASE_Pake1:
-        err = HandleMsg1_and_SendMsg2(std::move(msg));
+        err = HandleMsg1_and_SendMsg2a(std::move(msg));
         break;
 
     case MsgType::PASE_Pake2:
-        err = HandleMsg2_and_SendMsg3(std::move(msg));
+        err = HandleMsg2_and_SendMsg3a(std::move(msg));
         break;
 
     case MsgType::PASE_Pake3:
@@ -873,12 +1063,17 @@ exit:
         // Discard the exchange so that Clear() doesn't try closing it.  The
         // exchange will handle that.
         DiscardExchange();
-        Clear();
-        ChipLogError(SecureChannel, "Failed during PASE session setup: %" CHIP_ERROR_FORMAT, err.Format());
-        // Do this last in case the delegate frees us.
-        NotifySessionEstablishmentError(err);
+        AbortPendingEstablish(err);
     }
     return err;
 }
 
+void PASESession::AbortPendingEstablish(CHIP_ERROR err)
+{
+    Clear();
+    ChipLogError(SecureChannel, "Failed during PASE session setup: %" CHIP_ERROR_FORMAT, err.Format());
+    // Do this last in case the delegate frees us.
+    NotifySessionEstablishmentError(err);
+}
+
 } // namespace chip
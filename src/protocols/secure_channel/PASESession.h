@@ -28,6 +28,7 @@
 
 #include <crypto/CHIPCryptoPAL.h>
 #include <lib/support/Base64.h>
+#include <lib/support/CHIPMem.h>
 #include <messaging/ExchangeContext.h>
 #include <messaging/ExchangeDelegate.h>
 #include <messaging/ExchangeMessageDispatch.h>
@@ -50,6 +51,9 @@ using namespace Crypto;
 
 struct PASESessionSerialized;
 
+template <class SESSION, class DATA>
+class PairingSessionWorkHelper;
+
 struct PASESessionSerializable
 {
     uint16_t mKeLen;
@@ -196,10 +200,21 @@ private:
     CHIP_ERROR SendPBKDFParamResponse(ByteSpan initiatorRandom, bool initiatorHasPBKDFParams);
     CHIP_ERROR HandlePBKDFParamResponse(System::PacketBufferHandle && msg);
 
-    CHIP_ERROR SendMsg1();
+    struct SendMsg1Data;
+    CHIP_ERROR SendMsg1a(const ByteSpan & salt);
+    static CHIP_ERROR SendMsg1b(SendMsg1Data & data, bool & cancel);
+    CHIP_ERROR SendMsg1c(SendMsg1Data & data, CHIP_ERROR status);
+
+    struct HandleMsg1Data;
+    CHIP_ERROR HandleMsg1_and_SendMsg2a(System::PacketBufferHandle && msg);
+    static CHIP_ERROR HandleMsg1_and_SendMsg2b(HandleMsg1Data & data, bool & cancel);
+    CHIP_ERROR HandleMsg1_and_SendMsg2c(HandleMsg1Data & data, CHIP_ERROR status);
+
+    struct HandleMsg2Data;
+    CHIP_ERROR HandleMsg2_and_SendMsg3a(System::PacketBufferHandle && msg);
+    static CHIP_ERROR HandleMsg2_and_SendMsg3b(HandleMsg2Data & data, bool & cancel);
+    CHIP_ERROR HandleMsg2_and_SendMsg3c(HandleMsg2Data & data, CHIP_ERROR status);
 
-    CHIP_ERROR HandleMsg1_and_SendMsg2(System::PacketBufferHandle && msg);
-    CHIP_ERROR HandleMsg2_and_SendMsg3(System::PacketBufferHandle && msg);
     CHIP_ERROR HandleMsg3(System::PacketBufferHandle && msg);
 
     void OnSuccessStatusReport() override;
@@ -207,10 +222,19 @@ private:
 
     void Finish();
 
+    void AbortPendingEstablish(CHIP_ERROR err);
+
     // mNextExpectedMsg is set when we are expecting a message.
     Optional<Protocols::SecureChannel::MsgType> mNextExpectedMsg;
 
-    Spake2p_P256_SHA256_HKDF_HMAC mSpake2p;
+    // Allocated by SetupSpake2p, and handed to the outstanding work while the SPAKE2+ computations run in the background.
+    Platform::UniquePtr<Spake2p_P256_SHA256_HKDF_HMAC> mSpake2p;
+
+    template <class DATA>
+    using WorkHelper = PairingSessionWorkHelper<PASESession, DATA>;
+    Platform::SharedPtr<WorkHelper<SendMsg1Data>> mSendMsg1Helper;
+    Platform::SharedPtr<WorkHelper<HandleMsg1Data>> mHandleMsg1Helper;
+    Platform::SharedPtr<WorkHelper<HandleMsg2Data>> mHandleMsg2Helper;
 
     Spake2pVerifier mPASEVerifier;
 
@@ -25,6 +25,8 @@
 
 #pragma once
 
+#include <lib/core/DataModelTypes.h>
+#include <system/SystemClock.h>
 #include <system/SystemPacketBuffer.h>
 #include <transport/Session.h>
 #include <transport/raw/MessageHeader.h>
@@ -47,6 +49,17 @@ public:
      */
     virtual void OnSessionEstablishmentStarted() {}
 
+    /**
+     *   Called by a responder once it knows which fabric the session is being
+     *   established on, before it does the expensive part of the handshake.
+     *   Returning false rejects the request with a busy status report that asks
+     *   the initiator to wait at least busyWaitTime before trying again.
+     */
+    virtual bool ShouldAcceptSessionEstablishment(FabricIndex fabricIndex, System::Clock::Milliseconds16 & busyWaitTime)
+    {
+        return true;
+    }
+
     /**
      *   Called when the new secure session has been established.  This is
      *   mututally exclusive with OnSessionEstablishmentError for a give session
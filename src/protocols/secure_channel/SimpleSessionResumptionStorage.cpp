@@ -48,6 +48,24 @@ StorageKeyName SimpleSessionResumptionStorage::GetStorageKey(ConstResumptionIdVi
     return DefaultStorageKeyAllocator::SessionResumption(resumptionIdBase64);
 }
 
+CHIP_ERROR SimpleSessionResumptionStorage::Save(const ScopedNodeId & node, ConstResumptionIdView resumptionId,
+                                                const Crypto::P256ECDHDerivedSecret & sharedSecret, const CATValues & peerCATs)
+{
+    PersistentStorageBatch batch(mStorage);
+    ReturnErrorOnFailure(DefaultSessionResumptionStorage::Save(node, resumptionId, sharedSecret, peerCATs));
+    return batch.Commit();
+}
+
+CHIP_ERROR SimpleSessionResumptionStorage::DeleteAll(FabricIndex fabricIndex)
+{
+    PersistentStorageBatch batch(mStorage);
+    CHIP_ERROR err = DefaultSessionResumptionStorage::DeleteAll(fabricIndex);
+
+    // Deletion is best effort: what could be deleted stays deleted on error.
+    CHIP_ERROR commitErr = batch.Commit();
+    return (err != CHIP_NO_ERROR) ? err : commitErr;
+}
+
 CHIP_ERROR SimpleSessionResumptionStorage::SaveIndex(const SessionIndex & index)
 {
     std::array<uint8_t, MaxIndexSize()> buf;
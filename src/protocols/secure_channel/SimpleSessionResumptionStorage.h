@@ -43,6 +43,11 @@ public:
         return CHIP_NO_ERROR;
     }
 
+    // Write the index, link and state records of an operation as one storage batch.
+    CHIP_ERROR Save(const ScopedNodeId & node, ConstResumptionIdView resumptionId,
+                    const Crypto::P256ECDHDerivedSecret & sharedSecret, const CATValues & peerCATs) override;
+    CHIP_ERROR DeleteAll(FabricIndex fabricIndex) override;
+
     CHIP_ERROR SaveIndex(const SessionIndex & index) override;
     CHIP_ERROR LoadIndex(SessionIndex & index) override;
 
@@ -21,11 +21,13 @@
  *      This file implements unit tests for the CASESession implementation.
  */
 
+#include <algorithm>
 #include <credentials/CHIPCert.h>
 #include <credentials/GroupDataProviderImpl.h>
 #include <credentials/PersistentStorageOpCertStore.h>
 #include <crypto/DefaultSessionKeystore.h>
 #include <errno.h>
+#include <inttypes.h>
 #include <lib/core/CHIPCore.h>
 #include <lib/core/CHIPSafeCasts.h>
 #include <lib/core/DataModelTypes.h>
@@ -38,9 +40,12 @@
 #include <lib/support/UnitTestRegistration.h>
 #include <messaging/tests/MessagingContext.h>
 #include <nlunit-test.h>
+#include <platform/CHIPDeviceLayer.h>
 #include <protocols/secure_channel/CASEServer.h>
 #include <protocols/secure_channel/CASESession.h>
 #include <stdarg.h>
+#include <stdio.h>
+#include <unistd.h>
 
 #include "credentials/tests/CHIPCert_test_vectors.h"
 
@@ -61,8 +66,9 @@ namespace {
 void ServiceEvents(TestContext & ctx)
 {
     // Takes a few rounds of this because handling IO messages may schedule work,
-    // and scheduled work may queue messages for sending...
-    for (int i = 0; i < 3; ++i)
+    // and scheduled work may queue messages for sending...  Handling Sigma2 on the
+    // initiator takes two rounds of background work before Sigma3 is queued.
+    for (int i = 0; i < 6; ++i)
     {
         ctx.DrainAndServiceIO();
 
@@ -182,6 +188,12 @@ public:
         return mKeypair->ECDSA_sign_msg(message.data(), message.size(), outSignature);
     }
 
+    bool SupportsSignWithOpKeypairInBackground() const override { return mSignInBackground; }
+    void SetSignInBackground(bool signInBackground) { mSignInBackground = signInBackground; }
+
+    bool SupportsEphemeralKeypairInBackground() const override { return mEphemeralKeypairInBackground; }
+    void SetEphemeralKeypairInBackground(bool inBackground) { mEphemeralKeypairInBackground = inBackground; }
+
     Crypto::P256Keypair * AllocateEphemeralKeypairForCASE() override { return Platform::New<Crypto::P256Keypair>(); }
 
     void ReleaseEphemeralKeypair(Crypto::P256Keypair * keypair) override { Platform::Delete<Crypto::P256Keypair>(keypair); }
@@ -189,6 +201,8 @@ public:
 protected:
     Platform::UniquePtr<P256Keypair> mKeypair;
     FabricIndex mSingleFabricIndex = kUndefinedFabricIndex;
+    bool mSignInBackground             = false;
+    bool mEphemeralKeypairInBackground = false;
 };
 
 #if CHIP_CONFIG_SLOW_CRYPTO
@@ -324,7 +338,11 @@ public:
     static void SecurePairingStartTest(nlTestSuite * inSuite, void * inContext);
     static void SecurePairingHandshakeTest(nlTestSuite * inSuite, void * inContext);
     static void SecurePairingHandshakeServerTest(nlTestSuite * inSuite, void * inContext);
+    static void SecurePairingHandshakeBackgroundSigningTest(nlTestSuite * inSuite, void * inContext);
+    static void SecurePairingHandshakeBackgroundKeyAgreementTest(nlTestSuite * inSuite, void * inContext);
     static void ClientReceivesBusyTest(nlTestSuite * inSuite, void * inContext);
+    static void ConcurrentHandshakesTest(nlTestSuite * inSuite, void * inContext);
+    static void HandshakeThroughputTest(nlTestSuite * inSuite, void * inContext);
     static void Sigma1ParsingTest(nlTestSuite * inSuite, void * inContext);
     static void DestinationIdTest(nlTestSuite * inSuite, void * inContext);
     static void SessionResumptionStorage(nlTestSuite * inSuite, void * inContext);
@@ -492,6 +510,39 @@ void TestCASESession::SecurePairingHandshakeTest(nlTestSuite * inSuite, void * i
     SecurePairingHandshakeTestCommon(inSuite, inContext, sessionManager, pairingCommissioner, delegateCommissioner);
 }
 
+void TestCASESession::SecurePairingHandshakeBackgroundSigningTest(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+    TemporarySessionManager sessionManager(inSuite, ctx);
+
+    // The accessory now signs Sigma2 as background work, as it already did for Sigma3 on the initiator side.
+    gDeviceOperationalKeystore.SetSignInBackground(true);
+
+    TestCASESecurePairingDelegate delegateCommissioner;
+    CASESession pairingCommissioner;
+    pairingCommissioner.SetGroupDataProvider(&gCommissionerGroupDataProvider);
+    SecurePairingHandshakeTestCommon(inSuite, inContext, sessionManager, pairingCommissioner, delegateCommissioner);
+
+    gDeviceOperationalKeystore.SetSignInBackground(false);
+}
+
+void TestCASESession::SecurePairingHandshakeBackgroundKeyAgreementTest(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+    TemporarySessionManager sessionManager(inSuite, ctx);
+
+    // The accessory generates its ephemeral key and does ECDH for Sigma2 as background work. The commissioner,
+    // whose fabric table has no operational keystore, always does the Sigma2 ECDH and chain validation that way.
+    gDeviceOperationalKeystore.SetEphemeralKeypairInBackground(true);
+
+    TestCASESecurePairingDelegate delegateCommissioner;
+    CASESession pairingCommissioner;
+    pairingCommissioner.SetGroupDataProvider(&gCommissionerGroupDataProvider);
+    SecurePairingHandshakeTestCommon(inSuite, inContext, sessionManager, pairingCommissioner, delegateCommissioner);
+
+    gDeviceOperationalKeystore.SetEphemeralKeypairInBackground(false);
+}
+
 CASEServer gPairingServer;
 
 void TestCASESession::SecurePairingHandshakeServerTest(nlTestSuite * inSuite, void * inContext)
@@ -565,6 +616,8 @@ void TestCASESession::ClientReceivesBusyTest(nlTestSuite * inSuite, void * inCon
     auto & loopback            = ctx.GetLoopback();
     loopback.mSentMessageCount = 0;
 
+    // Only allow one handshake at a time, so that the second one gets a busy response.
+    gPairingServer.SetMaxConcurrentHandshakes(1);
     NL_TEST_ASSERT(inSuite,
                    gPairingServer.ListenForSessionEstablishment(&ctx.GetExchangeManager(), &ctx.GetSecureSessionManager(),
                                                                 &gDeviceFabrics, nullptr, nullptr,
@@ -584,10 +637,7 @@ void TestCASESession::ClientReceivesBusyTest(nlTestSuite * inSuite, void * inCon
 
     ServiceEvents(ctx);
 
-    // We should have one full handshake and one Sigma1 + Busy + ack.  If that
-    // ever changes (e.g. because our server starts supporting multiple parallel
-    // handshakes), this test needs to be fixed so that the server is still
-    // responding BUSY to the client.
+    // We should have one full handshake and one Sigma1 + Busy + ack.
     NL_TEST_ASSERT(inSuite, loopback.mSentMessageCount == sTestCaseMessageCount + 3);
     NL_TEST_ASSERT(inSuite, delegateCommissioner1.mNumPairingComplete == 1);
     NL_TEST_ASSERT(inSuite, delegateCommissioner2.mNumPairingComplete == 0);
@@ -599,6 +649,239 @@ void TestCASESession::ClientReceivesBusyTest(nlTestSuite * inSuite, void * inCon
     NL_TEST_ASSERT(inSuite, delegateCommissioner2.mNumBusyResponses == 1);
 
     gPairingServer.Shutdown();
+    gPairingServer.SetMaxConcurrentHandshakes(CHIP_CONFIG_CASE_SERVER_MAX_CONCURRENT_HANDSHAKES);
+}
+
+namespace {
+
+// Number of initiators that re-establish their sessions at once, as after a power outage.  The default is several times
+// the responder pool, so that the concurrency and per-fabric limits turn initiators away in every round.
+#ifndef CHIP_TEST_CASE_CONCURRENT_HANDSHAKE_COUNT
+#define CHIP_TEST_CASE_CONCURRENT_HANDSHAKE_COUNT 32
+#endif
+
+// Each side keeps a secure session for every session established and every handshake in progress.
+constexpr size_t kMaxConcurrentHandshakeCount =
+    CHIP_CONFIG_SECURE_SESSION_POOL_SIZE - CHIP_CONFIG_CASE_SERVER_MAX_CONCURRENT_HANDSHAKES;
+
+#if CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
+constexpr size_t kConcurrentHandshakeCount =
+    std::min<size_t>(CHIP_TEST_CASE_CONCURRENT_HANDSHAKE_COUNT, kMaxConcurrentHandshakeCount);
+#else
+// Every handshake also holds an initiator and a responder exchange, which must fit in the fixed exchange pool.
+constexpr size_t kConcurrentHandshakeCount = std::min<size_t>(
+    { CHIP_TEST_CASE_CONCURRENT_HANDSHAKE_COUNT, kMaxConcurrentHandshakeCount, CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS / 2 });
+#endif // CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
+
+// Busy responses expected when the responder takes maxHandshakes of the remaining initiators in each round.
+constexpr uint32_t ExpectedBusyResponses(size_t maxHandshakes)
+{
+    uint32_t busyResponses = 0;
+    for (size_t remaining = kConcurrentHandshakeCount; remaining > maxHandshakes; remaining -= maxHandshakes)
+    {
+        busyResponses += static_cast<uint32_t>(remaining - maxHandshakes);
+    }
+    return busyResponses;
+}
+
+// Start kConcurrentHandshakeCount handshakes with gPairingServer at once, and keep restarting the ones turned away as
+// busy until all of them succeed.  Returns the number of busy responses.
+uint32_t EstablishSessionsConcurrently(nlTestSuite * inSuite, TestContext & ctx, SessionManager & sessionManager,
+                                       size_t maxHandshakes, size_t maxHandshakesPerFabric)
+{
+    TestCASESecurePairingDelegate delegates[kConcurrentHandshakeCount];
+    CASESession * initiators[kConcurrentHandshakeCount] = {};
+
+    gPairingServer.SetMaxConcurrentHandshakes(maxHandshakes, maxHandshakesPerFabric);
+    NL_TEST_ASSERT(inSuite,
+                   gPairingServer.ListenForSessionEstablishment(&ctx.GetExchangeManager(), &ctx.GetSecureSessionManager(),
+                                                                &gDeviceFabrics, nullptr, nullptr,
+                                                                &gDeviceGroupDataProvider) == CHIP_NO_ERROR);
+
+    const System::Clock::Microseconds64 start = System::SystemClock().GetMonotonicMicroseconds64();
+
+    // At least one handshake succeeds in each round.
+    for (size_t round = 0; round < kConcurrentHandshakeCount; round++)
+    {
+        for (size_t i = 0; i < kConcurrentHandshakeCount; i++)
+        {
+            if (delegates[i].mNumPairingComplete != 0)
+            {
+                continue;
+            }
+
+            chip::Platform::Delete(initiators[i]);
+            initiators[i] = chip::Platform::New<CASESession>();
+            initiators[i]->SetGroupDataProvider(&gCommissionerGroupDataProvider);
+            ExchangeContext * exchange = ctx.NewUnauthenticatedExchangeToBob(initiators[i]);
+            NL_TEST_ASSERT(inSuite,
+                           initiators[i]->EstablishSession(sessionManager, &gCommissionerFabrics,
+                                                           ScopedNodeId{ Node01_01, gCommissionerFabricIndex }, exchange, nullptr,
+                                                           nullptr, &delegates[i], NullOptional) == CHIP_NO_ERROR);
+        }
+        ServiceEvents(ctx);
+    }
+
+    const System::Clock::Microseconds64 elapsed = System::SystemClock().GetMonotonicMicroseconds64() - start;
+
+    uint32_t busyResponses = 0;
+    for (size_t i = 0; i < kConcurrentHandshakeCount; i++)
+    {
+        NL_TEST_ASSERT(inSuite, delegates[i].mNumPairingComplete == 1);
+        NL_TEST_ASSERT(inSuite, delegates[i].mNumPairingErrors == delegates[i].mNumBusyResponses);
+        busyResponses += delegates[i].mNumBusyResponses;
+        chip::Platform::Delete(initiators[i]);
+    }
+
+    gPairingServer.Shutdown();
+    gPairingServer.SetMaxConcurrentHandshakes(CHIP_CONFIG_CASE_SERVER_MAX_CONCURRENT_HANDSHAKES);
+
+    // Make room in both session tables for the next run.
+    sessionManager.ExpireAllSessionsForFabric(gCommissionerFabricIndex);
+    ctx.GetSecureSessionManager().ExpireAllSessionsForFabric(gDeviceFabricIndex);
+
+    printf("  %u sessions (%u at once, %u per fabric) re-established in %" PRIu64 " us, %u busy responses\n",
+           static_cast<unsigned>(kConcurrentHandshakeCount), static_cast<unsigned>(maxHandshakes),
+           static_cast<unsigned>(maxHandshakesPerFabric), elapsed.count(), static_cast<unsigned>(busyResponses));
+    return busyResponses;
+}
+
+} // namespace
+
+void TestCASESession::ConcurrentHandshakesTest(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+    TemporarySessionManager sessionManager(inSuite, ctx);
+
+    constexpr size_t kMaxHandshakes = CHIP_CONFIG_CASE_SERVER_MAX_CONCURRENT_HANDSHAKES;
+
+    // One handshake at a time: each round, all but one initiator are turned away.
+    NL_TEST_ASSERT(inSuite, EstablishSessionsConcurrently(inSuite, ctx, sessionManager, 1, 1) == ExpectedBusyResponses(1));
+
+    // All the initiators are on the same fabric, so the per-fabric limit applies even when more handshakes are allowed.
+    NL_TEST_ASSERT(inSuite,
+                   EstablishSessionsConcurrently(inSuite, ctx, sessionManager, kMaxHandshakes, 1) == ExpectedBusyResponses(1));
+
+    // The whole responder pool: each round, as many initiators as there are responders get through.
+    NL_TEST_ASSERT(inSuite,
+                   EstablishSessionsConcurrently(inSuite, ctx, sessionManager, kMaxHandshakes, kMaxHandshakes) ==
+                       ExpectedBusyResponses(kMaxHandshakes));
+}
+
+#if CHIP_DEVICE_LAYER_TARGET_LINUX && CHIP_DEVICE_CONFIG_ENABLE_BG_EVENT_PROCESSING && !CHIP_SYSTEM_CONFIG_USE_LIBEV
+namespace {
+
+// Establish kConcurrentHandshakeCount sessions with gPairingServer, keeping as many handshakes in flight as the
+// responder allows, and servicing events until all of them complete.  Returns the handshakes per second.
+uint64_t MeasureHandshakeThroughput(nlTestSuite * inSuite, TestContext & ctx, SessionManager & sessionManager)
+{
+    constexpr System::Clock::Seconds32 kTimeout(120);
+
+    TestCASESecurePairingDelegate delegates[kConcurrentHandshakeCount];
+    CASESession * initiators[kConcurrentHandshakeCount] = {};
+    uint32_t attempts[kConcurrentHandshakeCount]        = {};
+    size_t completed                                    = 0;
+
+    NL_TEST_ASSERT(inSuite,
+                   gPairingServer.ListenForSessionEstablishment(&ctx.GetExchangeManager(), &ctx.GetSecureSessionManager(),
+                                                                &gDeviceFabrics, nullptr, nullptr,
+                                                                &gDeviceGroupDataProvider) == CHIP_NO_ERROR);
+
+    const System::Clock::Microseconds64 start = System::SystemClock().GetMonotonicMicroseconds64();
+    System::Clock::Microseconds64 elapsed(0);
+
+    while (completed < kConcurrentHandshakeCount && elapsed < kTimeout)
+    {
+        completed = 0;
+        for (size_t i = 0; i < kConcurrentHandshakeCount; i++)
+        {
+            if (delegates[i].mNumPairingComplete != 0)
+            {
+                completed++;
+                continue;
+            }
+            if (delegates[i].mNumPairingErrors != attempts[i])
+            {
+                // Still in flight.
+                continue;
+            }
+
+            // Not started yet, or turned away as busy: (re)start it.
+            chip::Platform::Delete(initiators[i]);
+            initiators[i] = chip::Platform::New<CASESession>();
+            initiators[i]->SetGroupDataProvider(&gCommissionerGroupDataProvider);
+            ExchangeContext * exchange = ctx.NewUnauthenticatedExchangeToBob(initiators[i]);
+            NL_TEST_ASSERT(inSuite,
+                           initiators[i]->EstablishSession(sessionManager, &gCommissionerFabrics,
+                                                           ScopedNodeId{ Node01_01, gCommissionerFabricIndex }, exchange, nullptr,
+                                                           nullptr, &delegates[i], NullOptional) == CHIP_NO_ERROR);
+            attempts[i]++;
+        }
+        // Background work completes asynchronously, so keep servicing until every handshake is done.
+        ServiceEvents(ctx);
+        elapsed = System::SystemClock().GetMonotonicMicroseconds64() - start;
+    }
+
+    for (size_t i = 0; i < kConcurrentHandshakeCount; i++)
+    {
+        NL_TEST_ASSERT(inSuite, delegates[i].mNumPairingComplete == 1);
+        NL_TEST_ASSERT(inSuite, delegates[i].mNumPairingErrors == delegates[i].mNumBusyResponses);
+        chip::Platform::Delete(initiators[i]);
+    }
+
+    gPairingServer.Shutdown();
+
+    // Make room in both session tables for the next run.
+    sessionManager.ExpireAllSessionsForFabric(gCommissionerFabricIndex);
+    ctx.GetSecureSessionManager().ExpireAllSessionsForFabric(gDeviceFabricIndex);
+
+    return elapsed.count() > 0 ? kConcurrentHandshakeCount * 1000000u / elapsed.count() : 0;
+}
+
+} // namespace
+#endif // CHIP_DEVICE_LAYER_TARGET_LINUX && CHIP_DEVICE_CONFIG_ENABLE_BG_EVENT_PROCESSING && !CHIP_SYSTEM_CONFIG_USE_LIBEV
+
+// Complete handshakes per second, with the handshake's background work on the Matter thread alone and then on
+// 1, 2, 4, ... worker threads up to one per CPU.  Both sides offload their key agreement, chain validation and
+// Sigma2 signature.
+void TestCASESession::HandshakeThroughputTest(nlTestSuite * inSuite, void * inContext)
+{
+#if CHIP_DEVICE_LAYER_TARGET_LINUX && CHIP_DEVICE_CONFIG_ENABLE_BG_EVENT_PROCESSING && !CHIP_SYSTEM_CONFIG_USE_LIBEV
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+    TemporarySessionManager sessionManager(inSuite, ctx);
+
+    gDeviceOperationalKeystore.SetSignInBackground(true);
+    gDeviceOperationalKeystore.SetEphemeralKeypairInBackground(true);
+
+    const long cpus         = sysconf(_SC_NPROCESSORS_ONLN);
+    const size_t maxWorkers = (cpus > 0) ? static_cast<size_t>(cpus) : 1;
+
+    // Without workers, background work falls back to the Matter thread.
+    const uint64_t baseRate = MeasureHandshakeThroughput(inSuite, ctx, sessionManager);
+    printf("  Matter thread only: %" PRIu64 " handshakes/s\n", baseRate);
+
+    for (size_t workers = 1;; workers = std::min(2 * workers, maxWorkers))
+    {
+        DeviceLayer::PlatformMgrImpl().SetBackgroundTaskCount(workers);
+        NL_TEST_ASSERT(inSuite, DeviceLayer::PlatformMgr().StartBackgroundEventLoopTask() == CHIP_NO_ERROR);
+
+        const uint64_t rate = MeasureHandshakeThroughput(inSuite, ctx, sessionManager);
+
+        NL_TEST_ASSERT(inSuite, DeviceLayer::PlatformMgr().StopBackgroundEventLoopTask() == CHIP_NO_ERROR);
+
+        printf("  %2zu worker(s): %" PRIu64 " handshakes/s, %.2fx the Matter thread only\n", workers, rate,
+               baseRate > 0 ? static_cast<double>(rate) / static_cast<double>(baseRate) : 0.0);
+
+        if (workers == maxWorkers)
+        {
+            break;
+        }
+    }
+
+    DeviceLayer::PlatformMgrImpl().SetBackgroundTaskCount(CHIP_DEVICE_CONFIG_BG_TASK_COUNT);
+    gDeviceOperationalKeystore.SetEphemeralKeypairInBackground(false);
+    gDeviceOperationalKeystore.SetSignInBackground(false);
+#endif // CHIP_DEVICE_LAYER_TARGET_LINUX && CHIP_DEVICE_CONFIG_ENABLE_BG_EVENT_PROCESSING && !CHIP_SYSTEM_CONFIG_USE_LIBEV
 }
 
 struct Sigma1Params
@@ -1178,7 +1461,11 @@ static const nlTest sTests[] =
     NL_TEST_DEF("Start",       chip::TestCASESession::SecurePairingStartTest),
     NL_TEST_DEF("Handshake",   chip::TestCASESession::SecurePairingHandshakeTest),
     NL_TEST_DEF("ServerHandshake", chip::TestCASESession::SecurePairingHandshakeServerTest),
+    NL_TEST_DEF("BackgroundSigning", chip::TestCASESession::SecurePairingHandshakeBackgroundSigningTest),
+    NL_TEST_DEF("BackgroundKeyAgreement", chip::TestCASESession::SecurePairingHandshakeBackgroundKeyAgreementTest),
     NL_TEST_DEF("ClientReceivesBusy", chip::TestCASESession::ClientReceivesBusyTest),
+    NL_TEST_DEF("ConcurrentHandshakes", chip::TestCASESession::ConcurrentHandshakesTest),
+    NL_TEST_DEF("HandshakeThroughput", chip::TestCASESession::HandshakeThroughputTest),
     NL_TEST_DEF("Sigma1Parsing", chip::TestCASESession::Sigma1ParsingTest),
     NL_TEST_DEF("DestinationId", chip::TestCASESession::DestinationIdTest),
     NL_TEST_DEF("SessionResumptionStorage", chip::TestCASESession::SessionResumptionStorage),
@@ -0,0 +1,366 @@
+/*
+ *    Copyright (c) 2023 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <lib/support/CodeUtils.h>
+#include <lib/support/TestPersistentStorageDelegate.h>
+#include <lib/support/UnitTestRegistration.h>
+#include <nlunit-test.h>
+
+#include <protocols/secure_channel/CachedSessionResumptionStorage.h>
+#include <protocols/secure_channel/SimpleSessionResumptionStorage.h>
+
+namespace {
+
+// Counts the reads that reach persistent storage.
+class CountingStorageDelegate : public chip::TestPersistentStorageDelegate
+{
+public:
+    size_t mReads = 0;
+
+protected:
+    CHIP_ERROR SyncGetKeyValueInternal(const char * key, void * buffer, uint16_t & size) override
+    {
+        mReads++;
+        return chip::TestPersistentStorageDelegate::SyncGetKeyValueInternal(key, buffer, size);
+    }
+};
+
+struct TestVector
+{
+    chip::SessionResumptionStorage::ResumptionIdStorage resumptionId;
+    chip::Crypto::P256ECDHDerivedSecret sharedSecret;
+    chip::ScopedNodeId node;
+    chip::CATValues cats;
+};
+
+void PopulateVectors(nlTestSuite * inSuite, TestVector * vectors, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        NL_TEST_ASSERT(
+            inSuite, CHIP_NO_ERROR == chip::Crypto::DRBG_get_bytes(vectors[i].resumptionId.data(), vectors[i].resumptionId.size()));
+        // set first byte to our index to ensure uniqueness for the FindByResumptionId call
+        *vectors[i].resumptionId.data() = static_cast<uint8_t>(i);
+        vectors[i].sharedSecret.SetLength(vectors[i].sharedSecret.Capacity());
+        NL_TEST_ASSERT(inSuite,
+                       CHIP_NO_ERROR ==
+                           chip::Crypto::DRBG_get_bytes(vectors[i].sharedSecret.Bytes(), vectors[i].sharedSecret.Length()));
+        vectors[i].node           = chip::ScopedNodeId(static_cast<chip::NodeId>(i + 1), static_cast<chip::FabricIndex>(i % 3 + 1));
+        vectors[i].cats.values[0] = static_cast<chip::CASEAuthTag>(rand());
+        vectors[i].cats.values[1] = static_cast<chip::CASEAuthTag>(rand());
+        vectors[i].cats.values[2] = static_cast<chip::CASEAuthTag>(rand());
+    }
+}
+
+bool IsFound(chip::SessionResumptionStorage & sessionStorage, const TestVector & vector)
+{
+    chip::ScopedNodeId outNode;
+    chip::SessionResumptionStorage::ResumptionIdStorage outResumptionId;
+    chip::Crypto::P256ECDHDerivedSecret outSharedSecret;
+    chip::CATValues outCats;
+
+    if (sessionStorage.FindByScopedNodeId(vector.node, outResumptionId, outSharedSecret, outCats) != CHIP_NO_ERROR ||
+        outResumptionId != vector.resumptionId || !(outCats == vector.cats) ||
+        outSharedSecret.Length() != vector.sharedSecret.Length() ||
+        memcmp(outSharedSecret.ConstBytes(), vector.sharedSecret.ConstBytes(), vector.sharedSecret.Length()) != 0)
+    {
+        return false;
+    }
+
+    return sessionStorage.FindByResumptionId(vector.resumptionId, outNode, outSharedSecret, outCats) == CHIP_NO_ERROR &&
+        outNode == vector.node;
+}
+
+bool HasRecords(chip::TestPersistentStorageDelegate & storage, const TestVector & vector)
+{
+    return storage.SyncDoesKeyExist(chip::SimpleSessionResumptionStorage::GetStorageKey(vector.node).KeyName()) &&
+        storage.SyncDoesKeyExist(chip::SimpleSessionResumptionStorage::GetStorageKey(vector.resumptionId).KeyName());
+}
+
+bool HasNoRecords(chip::TestPersistentStorageDelegate & storage, const TestVector & vector)
+{
+    return !storage.SyncDoesKeyExist(chip::SimpleSessionResumptionStorage::GetStorageKey(vector.node).KeyName()) &&
+        !storage.SyncDoesKeyExist(chip::SimpleSessionResumptionStorage::GetStorageKey(vector.resumptionId).KeyName());
+}
+
+void TestSaveAndFind(nlTestSuite * inSuite, void * inContext)
+{
+    chip::CachedSessionResumptionStorage sessionStorage;
+    CountingStorageDelegate storage;
+    NL_TEST_ASSERT(inSuite, sessionStorage.Init(&storage) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, sessionStorage.GetCapacity() == CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE);
+
+    TestVector vectors[CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE];
+    PopulateVectors(inSuite, vectors, ArraySize(vectors));
+
+    for (auto & vector : vectors)
+    {
+        NL_TEST_ASSERT(inSuite,
+                       sessionStorage.Save(vector.node, vector.resumptionId, vector.sharedSecret, vector.cats) == CHIP_NO_ERROR);
+    }
+    NL_TEST_ASSERT(inSuite, sessionStorage.GetCount() == ArraySize(vectors));
+
+    // Lookups are served from memory.
+    storage.mReads = 0;
+    for (auto & vector : vectors)
+    {
+        NL_TEST_ASSERT(inSuite, IsFound(sessionStorage, vector));
+    }
+    NL_TEST_ASSERT(inSuite, storage.mReads == 0);
+
+    chip::SessionResumptionStorage::ResumptionIdStorage unknownResumptionId = vectors[0].resumptionId;
+    unknownResumptionId[0] ^= 0xff;
+    chip::ScopedNodeId outNode;
+    chip::Crypto::P256ECDHDerivedSecret outSharedSecret;
+    chip::CATValues outCats;
+    NL_TEST_ASSERT(inSuite,
+                   sessionStorage.FindByResumptionId(unknownResumptionId, outNode, outSharedSecret, outCats) ==
+                       CHIP_ERROR_KEY_NOT_FOUND);
+
+    // Records are written through, in the format of SimpleSessionResumptionStorage.
+    chip::SimpleSessionResumptionStorage simpleStorage;
+    NL_TEST_ASSERT(inSuite, simpleStorage.Init(&storage) == CHIP_NO_ERROR);
+    for (auto & vector : vectors)
+    {
+        NL_TEST_ASSERT(inSuite, IsFound(simpleStorage, vector));
+    }
+}
+
+void TestLruEviction(nlTestSuite * inSuite, void * inContext)
+{
+    chip::CachedSessionResumptionStorage sessionStorage;
+    chip::TestPersistentStorageDelegate storage;
+    NL_TEST_ASSERT(inSuite, sessionStorage.Init(&storage, 0) == CHIP_ERROR_INVALID_ARGUMENT);
+    NL_TEST_ASSERT(inSuite,
+                   sessionStorage.Init(&storage, CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE + 1) == CHIP_ERROR_INVALID_ARGUMENT);
+    NL_TEST_ASSERT(inSuite, sessionStorage.Init(&storage, 3) == CHIP_NO_ERROR);
+
+    TestVector vectors[5];
+    PopulateVectors(inSuite, vectors, ArraySize(vectors));
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+        NL_TEST_ASSERT(inSuite,
+                       sessionStorage.Save(vectors[i].node, vectors[i].resumptionId, vectors[i].sharedSecret, vectors[i].cats) ==
+                           CHIP_NO_ERROR);
+    }
+
+    // Using the oldest record makes the second one the least recently used.
+    NL_TEST_ASSERT(inSuite, IsFound(sessionStorage, vectors[0]));
+    NL_TEST_ASSERT(inSuite,
+                   sessionStorage.Save(vectors[3].node, vectors[3].resumptionId, vectors[3].sharedSecret, vectors[3].cats) ==
+                       CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, sessionStorage.GetCount() == 3);
+    NL_TEST_ASSERT(inSuite, IsFound(sessionStorage, vectors[0]));
+    NL_TEST_ASSERT(inSuite, !IsFound(sessionStorage, vectors[1]));
+    NL_TEST_ASSERT(inSuite, IsFound(sessionStorage, vectors[2]));
+    NL_TEST_ASSERT(inSuite, IsFound(sessionStorage, vectors[3]));
+    NL_TEST_ASSERT(inSuite, HasNoRecords(storage, vectors[1]));
+
+    // Saving a known peer again does not evict anything.
+    NL_TEST_ASSERT(inSuite,
+                   sessionStorage.Save(vectors[0].node, vectors[0].resumptionId, vectors[0].sharedSecret, vectors[0].cats) ==
+                       CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, sessionStorage.GetCount() == 3);
+
+    // Order of use is now 2, 3, 0 (the finds above used them in order 0, 2, 3, then 0 was saved).
+    NL_TEST_ASSERT(inSuite,
+                   sessionStorage.Save(vectors[4].node, vectors[4].resumptionId, vectors[4].sharedSecret, vectors[4].cats) ==
+                       CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, IsFound(sessionStorage, vectors[0]));
+    NL_TEST_ASSERT(inSuite, !IsFound(sessionStorage, vectors[2]));
+    NL_TEST_ASSERT(inSuite, IsFound(sessionStorage, vectors[3]));
+    NL_TEST_ASSERT(inSuite, IsFound(sessionStorage, vectors[4]));
+    NL_TEST_ASSERT(inSuite, HasNoRecords(storage, vectors[2]));
+}
+
+void TestReload(nlTestSuite * inSuite, void * inContext)
+{
+    chip::TestPersistentStorageDelegate storage;
+    TestVector vectors[4];
+    PopulateVectors(inSuite, vectors, ArraySize(vectors));
+
+    {
+        chip::CachedSessionResumptionStorage sessionStorage;
+        NL_TEST_ASSERT(inSuite, sessionStorage.Init(&storage) == CHIP_NO_ERROR);
+        for (auto & vector : vectors)
+        {
+            NL_TEST_ASSERT(inSuite,
+                           sessionStorage.Save(vector.node, vector.resumptionId, vector.sharedSecret, vector.cats) ==
+                               CHIP_NO_ERROR);
+        }
+    }
+
+    // All the records are loaded on Init.
+    {
+        chip::CachedSessionResumptionStorage sessionStorage;
+        NL_TEST_ASSERT(inSuite, sessionStorage.Init(&storage) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, sessionStorage.GetCount() == ArraySize(vectors));
+        for (auto & vector : vectors)
+        {
+            NL_TEST_ASSERT(inSuite, IsFound(sessionStorage, vector));
+        }
+    }
+
+    // A record whose state cannot be read is dropped from the index.
+    NL_TEST_ASSERT(inSuite,
+                   storage.SyncDeleteKeyValue(chip::SimpleSessionResumptionStorage::GetStorageKey(vectors[3].node).KeyName()) ==
+                       CHIP_NO_ERROR);
+    {
+        chip::CachedSessionResumptionStorage sessionStorage;
+        NL_TEST_ASSERT(inSuite, sessionStorage.Init(&storage) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, sessionStorage.GetCount() == 3);
+        NL_TEST_ASSERT(inSuite, !IsFound(sessionStorage, vectors[3]));
+    }
+
+    // Records in excess of a smaller capacity are deleted, oldest first.
+    {
+        chip::CachedSessionResumptionStorage sessionStorage;
+        NL_TEST_ASSERT(inSuite, sessionStorage.Init(&storage, 2) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, sessionStorage.GetCount() == 2);
+        NL_TEST_ASSERT(inSuite, !IsFound(sessionStorage, vectors[0]));
+        NL_TEST_ASSERT(inSuite, IsFound(sessionStorage, vectors[1]));
+        NL_TEST_ASSERT(inSuite, IsFound(sessionStorage, vectors[2]));
+        NL_TEST_ASSERT(inSuite, HasNoRecords(storage, vectors[0]));
+    }
+    {
+        chip::SimpleSessionResumptionStorage simpleStorage;
+        NL_TEST_ASSERT(inSuite, simpleStorage.Init(&storage) == CHIP_NO_ERROR);
+        chip::DefaultSessionResumptionStorage::SessionIndex index;
+        NL_TEST_ASSERT(inSuite, simpleStorage.LoadIndex(index) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, index.mSize == 2);
+    }
+}
+
+void TestInPlaceSave(nlTestSuite * inSuite, void * inContext)
+{
+    chip::CachedSessionResumptionStorage sessionStorage;
+    chip::TestPersistentStorageDelegate storage;
+    NL_TEST_ASSERT(inSuite, sessionStorage.Init(&storage) == CHIP_NO_ERROR);
+
+    TestVector vectors[2];
+    PopulateVectors(inSuite, vectors, ArraySize(vectors));
+    vectors[1].node = vectors[0].node;
+
+    for (auto & vector : vectors)
+    {
+        NL_TEST_ASSERT(inSuite,
+                       sessionStorage.Save(vector.node, vector.resumptionId, vector.sharedSecret, vector.cats) == CHIP_NO_ERROR);
+    }
+
+    NL_TEST_ASSERT(inSuite, sessionStorage.GetCount() == 1);
+    NL_TEST_ASSERT(inSuite, IsFound(sessionStorage, vectors[1]));
+    NL_TEST_ASSERT(inSuite, HasRecords(storage, vectors[1]));
+    NL_TEST_ASSERT(inSuite,
+                   !storage.SyncDoesKeyExist(chip::SimpleSessionResumptionStorage::GetStorageKey(vectors[0].resumptionId).KeyName()));
+
+    chip::ScopedNodeId outNode;
+    chip::Crypto::P256ECDHDerivedSecret outSharedSecret;
+    chip::CATValues outCats;
+    NL_TEST_ASSERT(inSuite,
+                   sessionStorage.FindByResumptionId(vectors[0].resumptionId, outNode, outSharedSecret, outCats) ==
+                       CHIP_ERROR_KEY_NOT_FOUND);
+}
+
+void TestDelete(nlTestSuite * inSuite, void * inContext)
+{
+    chip::CachedSessionResumptionStorage sessionStorage;
+    chip::TestPersistentStorageDelegate storage;
+    NL_TEST_ASSERT(inSuite, sessionStorage.Init(&storage) == CHIP_NO_ERROR);
+
+    TestVector vectors[CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE];
+    PopulateVectors(inSuite, vectors, ArraySize(vectors));
+
+    for (auto & vector : vectors)
+    {
+        NL_TEST_ASSERT(inSuite,
+                       sessionStorage.Save(vector.node, vector.resumptionId, vector.sharedSecret, vector.cats) == CHIP_NO_ERROR);
+    }
+
+    // Delete a single node.
+    NL_TEST_ASSERT(inSuite, sessionStorage.Delete(vectors[0].node) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, !IsFound(sessionStorage, vectors[0]));
+    NL_TEST_ASSERT(inSuite, HasNoRecords(storage, vectors[0]));
+    NL_TEST_ASSERT(inSuite, sessionStorage.Delete(vectors[0].node) == CHIP_NO_ERROR);
+
+    // Delete the other nodes by fabric.
+    for (chip::FabricIndex fabricIndex = 1; fabricIndex <= 3; ++fabricIndex)
+    {
+        NL_TEST_ASSERT(inSuite, sessionStorage.DeleteAll(fabricIndex) == CHIP_NO_ERROR);
+        for (auto & vector : vectors)
+        {
+            if (vector.node.GetFabricIndex() <= fabricIndex)
+            {
+                NL_TEST_ASSERT(inSuite, !IsFound(sessionStorage, vector));
+                NL_TEST_ASSERT(inSuite, HasNoRecords(storage, vector));
+            }
+            else
+            {
+                NL_TEST_ASSERT(inSuite, IsFound(sessionStorage, vector));
+            }
+        }
+    }
+    NL_TEST_ASSERT(inSuite, sessionStorage.GetCount() == 0);
+
+    // Nothing is left after a reload either.
+    chip::CachedSessionResumptionStorage reloadedStorage;
+    NL_TEST_ASSERT(inSuite, reloadedStorage.Init(&storage) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, reloadedStorage.GetCount() == 0);
+}
+
+} // namespace
+
+// Test Suite
+
+/**
+ *  Test Suite that lists all the test functions.
+ */
+// clang-format off
+static const nlTest sTests[] =
+{
+    NL_TEST_DEF("TestSaveAndFind", TestSaveAndFind),
+    NL_TEST_DEF("TestLruEviction", TestLruEviction),
+    NL_TEST_DEF("TestReload", TestReload),
+    NL_TEST_DEF("TestInPlaceSave", TestInPlaceSave),
+    NL_TEST_DEF("TestDelete", TestDelete),
+
+    NL_TEST_SENTINEL()
+};
+// clang-format on
+
+// clang-format off
+static nlTestSuite sSuite =
+{
+    "Test-CHIP-CachedSessionResumptionStorage",
+    &sTests[0],
+    nullptr,
+    nullptr,
+};
+// clang-format on
+
+/**
+ *  Main
+ */
+int TestCachedSessionResumptionStorage()
+{
+    // Run test suit against one context
+    nlTestRunner(&sSuite, nullptr);
+
+    return (nlTestRunnerStats(&sSuite));
+}
+
+CHIP_REGISTER_TEST_SUITE(TestCachedSessionResumptionStorage)
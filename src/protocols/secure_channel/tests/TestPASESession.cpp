@@ -32,6 +32,7 @@
 #include <lib/support/UnitTestRegistration.h>
 #include <lib/support/UnitTestUtils.h>
 #include <messaging/tests/MessagingContext.h>
+#include <platform/CHIPDeviceLayer.h>
 #include <protocols/secure_channel/PASESession.h>
 #include <stdarg.h>
 
@@ -88,6 +89,21 @@ public:
 
 using TestContext = chip::Test::LoopbackMessagingContext;
 
+void ServiceEvents(TestContext & ctx)
+{
+    // Takes a few rounds of this because handling IO messages may schedule work,
+    // and scheduled work may queue messages for sending...  Each SPAKE2+ message
+    // is computed in background work before it is sent.
+    for (int i = 0; i < 4; ++i)
+    {
+        ctx.DrainAndServiceIO();
+
+        chip::DeviceLayer::PlatformMgr().ScheduleWork(
+            [](intptr_t) -> void { chip::DeviceLayer::PlatformMgr().StopEventLoopTask(); }, (intptr_t) nullptr);
+        chip::DeviceLayer::PlatformMgr().RunEventLoop();
+    }
+}
+
 class TestSecurePairingDelegate : public SessionEstablishmentDelegate
 {
 public:
@@ -284,7 +300,7 @@ void SecurePairingHandshakeTestCommon(nlTestSuite * inSuite, void * inContext, S
     NL_TEST_ASSERT(inSuite,
                    pairingCommissioner.Pair(sessionManager, sTestSpake2p01_PinCode, mrpCommissionerConfig, contextCommissioner,
                                             &delegateCommissioner) == CHIP_NO_ERROR);
-    ctx.DrainAndServiceIO();
+    ServiceEvents(ctx);
 
     while (delegate.mMessageDropped)
     {
@@ -299,7 +315,7 @@ void SecurePairingHandshakeTestCommon(nlTestSuite * inSuite, void * inContext, S
         chip::test_utils::SleepMillis(waitTimeout.count());
         delegate.mMessageDropped = false;
         ReliableMessageMgr::Timeout(&ctx.GetSystemLayer(), ctx.GetExchangeManager().GetReliableMessageMgr());
-        ctx.DrainAndServiceIO();
+        ServiceEvents(ctx);
     };
 
     // Standalone acks also increment the mSentMessageCount. But some messages could be acked
@@ -473,7 +489,7 @@ void SecurePairingFailedHandshake(nlTestSuite * inSuite, void * inContext)
     NL_TEST_ASSERT(inSuite,
                    pairingCommissioner.Pair(sessionManager, 4321, Optional<ReliableMessageProtocolConfig>::Missing(),
                                             contextCommissioner, &delegateCommissioner) == CHIP_NO_ERROR);
-    ctx.DrainAndServiceIO();
+    ServiceEvents(ctx);
 
     NL_TEST_ASSERT(inSuite, delegateAccessory.mNumPairingComplete == 0);
     NL_TEST_ASSERT(inSuite, delegateAccessory.mNumPairingErrors == 1);
@@ -545,9 +561,12 @@ int TestSecurePairing_Setup(void * inContext)
     auto & ctx = *static_cast<TestContext *>(inContext);
 
     // Initialize System memory and resources
+    VerifyOrReturnError(chip::DeviceLayer::PlatformMgr().InitChipStack() == CHIP_NO_ERROR, FAILURE);
     ctx.ConfigInitializeNodes(false);
     VerifyOrReturnError(TestContext::Initialize(inContext) == SUCCESS, FAILURE);
 
+    chip::DeviceLayer::SetSystemLayerForTesting(&ctx.GetSystemLayer());
+
     return SUCCESS;
 }
 
@@ -556,7 +575,10 @@ int TestSecurePairing_Setup(void * inContext)
  */
 int TestSecurePairing_Teardown(void * inContext)
 {
-    return TestContext::Finalize(inContext);
+    chip::DeviceLayer::SetSystemLayerForTesting(nullptr);
+    int result = TestContext::Finalize(inContext);
+    chip::DeviceLayer::PlatformMgr().Shutdown();
+    return result;
 }
 
 } // anonymous namespace
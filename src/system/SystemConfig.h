@@ -350,14 +350,63 @@
  *  @def CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE
  *
  *  @brief
- *      This is the total number of packet buffers for the BSD sockets configuration.
+ *      This is the number of full-size packet buffers for the BSD sockets configuration.
  *
  *      This may be set to zero (0) to enable unbounded dynamic allocation using malloc.
+ *
+ *      Smaller packet buffers may be added to the pool with CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_SIZE and
+ *      CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_SIZE.
  */
 #ifndef CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE
 #define CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE 15
 #endif /* CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE */
 
+/**
+ *  @def CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_SIZE
+ *
+ *  @brief
+ *      This is the number of small packet buffers, of CHIP_SYSTEM_CONFIG_PACKETBUFFER_SMALL_CAPACITY bytes each, in the
+ *      packet buffer pool. Allocations that fit are taken from the smallest size class that has a free buffer.
+ *
+ *      Only used when CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE is nonzero.
+ */
+#ifndef CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_SIZE
+#define CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_SIZE 0
+#endif /* CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_SIZE */
+
+/**
+ *  @def CHIP_SYSTEM_CONFIG_PACKETBUFFER_SMALL_CAPACITY
+ *
+ *  @brief
+ *      The allocation size (reserve plus data, as returned by \c PacketBuffer::AllocSize()) of a small pool packet buffer.
+ */
+#ifndef CHIP_SYSTEM_CONFIG_PACKETBUFFER_SMALL_CAPACITY
+#define CHIP_SYSTEM_CONFIG_PACKETBUFFER_SMALL_CAPACITY 128
+#endif /* CHIP_SYSTEM_CONFIG_PACKETBUFFER_SMALL_CAPACITY */
+
+/**
+ *  @def CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_SIZE
+ *
+ *  @brief
+ *      This is the number of medium packet buffers, of CHIP_SYSTEM_CONFIG_PACKETBUFFER_MEDIUM_CAPACITY bytes each, in the
+ *      packet buffer pool.
+ *
+ *      Only used when CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE is nonzero.
+ */
+#ifndef CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_SIZE
+#define CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_SIZE 0
+#endif /* CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_SIZE */
+
+/**
+ *  @def CHIP_SYSTEM_CONFIG_PACKETBUFFER_MEDIUM_CAPACITY
+ *
+ *  @brief
+ *      The allocation size (reserve plus data, as returned by \c PacketBuffer::AllocSize()) of a medium pool packet buffer.
+ */
+#ifndef CHIP_SYSTEM_CONFIG_PACKETBUFFER_MEDIUM_CAPACITY
+#define CHIP_SYSTEM_CONFIG_PACKETBUFFER_MEDIUM_CAPACITY 512
+#endif /* CHIP_SYSTEM_CONFIG_PACKETBUFFER_MEDIUM_CAPACITY */
+
 /**
  *  @def CHIP_SYSTEM_CONFIG_PACKETBUFFER_LWIP_PBUF_RAM
  *
@@ -495,6 +544,22 @@ struct LwIPEvent;
 #define CHIP_SYSTEM_CONFIG_NUM_TIMERS 32
 #endif /* CHIP_SYSTEM_CONFIG_NUM_TIMERS */
 
+/**
+ *  @def CHIP_SYSTEM_CONFIG_TIMER_QUEUE_BUCKETS
+ *
+ *  @brief
+ *      This is the number of hash buckets used by a TimerQueue to look up timers by callback and application state.
+ *      It must be a power of two. Configurations that allocate timers from the heap may hold thousands of timers,
+ *      so they default to a larger table.
+ */
+#ifndef CHIP_SYSTEM_CONFIG_TIMER_QUEUE_BUCKETS
+#if CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
+#define CHIP_SYSTEM_CONFIG_TIMER_QUEUE_BUCKETS 1024
+#else
+#define CHIP_SYSTEM_CONFIG_TIMER_QUEUE_BUCKETS 16
+#endif /* CHIP_SYSTEM_CONFIG_POOL_USE_HEAP */
+#endif /* CHIP_SYSTEM_CONFIG_TIMER_QUEUE_BUCKETS */
+
 /**
  *  @def CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
  *
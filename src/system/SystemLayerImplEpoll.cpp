@@ -0,0 +1,552 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements Layer using epoll(7) and timerfd(2).
+ */
+
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <platform/LockTracker.h>
+#include <system/SystemFaultInjection.h>
+#include <system/SystemLayer.h>
+#include <system/SystemLayerImplEpoll.h>
+
+#include <algorithm>
+#include <errno.h>
+#include <stdint.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+// Choose an approximation of PTHREAD_NULL if pthread.h doesn't define one.
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING && !defined(PTHREAD_NULL)
+#define PTHREAD_NULL 0
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING && !defined(PTHREAD_NULL)
+
+namespace chip {
+namespace System {
+
+constexpr Clock::Seconds64 kDefaultMinSleepPeriod = Clock::Seconds64(60 * 60 * 24 * 30); // Month [sec]
+
+// Initial number of entries of the fd-indexed watch table; it doubles as needed.
+constexpr size_t kInitialWatchTableSize = 64;
+
+CHIP_ERROR LayerImplEpoll::Init()
+{
+    VerifyOrReturnError(mLayerState.SetInitializing(), CHIP_ERROR_INCORRECT_STATE);
+
+    RegisterPOSIXErrorFormatter();
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+    mHandleSelectThread = PTHREAD_NULL;
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
+    CHIP_ERROR err = OpenDescriptors();
+    if (err != CHIP_NO_ERROR)
+    {
+        // Leave nothing behind, so that Init() may be tried again.
+        ReleaseAllWatches();
+        CloseDescriptors();
+        mLayerState.ResetFromInitializing();
+        return err;
+    }
+
+    VerifyOrReturnError(mLayerState.SetInitialized(), CHIP_ERROR_INCORRECT_STATE);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR LayerImplEpoll::OpenDescriptors()
+{
+    mEpollFd = epoll_create1(EPOLL_CLOEXEC);
+    VerifyOrReturnError(mEpollFd >= 0, CHIP_ERROR_POSIX(errno));
+
+    mTimerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    VerifyOrReturnError(mTimerFd >= 0, CHIP_ERROR_POSIX(errno));
+
+    struct epoll_event event = {};
+    event.events             = EPOLLIN;
+    event.data.fd            = mTimerFd;
+    VerifyOrReturnError(epoll_ctl(mEpollFd, EPOLL_CTL_ADD, mTimerFd, &event) == 0, CHIP_ERROR_POSIX(errno));
+    mEpollTimeout = -1;
+
+    // Create an event to allow an arbitrary thread to wake the thread in the epoll loop.
+    return mWakeEvent.Open(*this);
+}
+
+void LayerImplEpoll::CloseDescriptors()
+{
+    if (mTimerFd >= 0)
+    {
+        close(mTimerFd);
+        mTimerFd = kInvalidFd;
+    }
+    if (mEpollFd >= 0)
+    {
+        close(mEpollFd);
+        mEpollFd = kInvalidFd;
+    }
+}
+
+void LayerImplEpoll::Shutdown()
+{
+    VerifyOrReturn(mLayerState.SetShuttingDown());
+
+    mTimerList.Clear();
+    mTimerPool.ReleaseAll();
+
+    mWakeEvent.Close(*this);
+
+    ReleaseAllWatches();
+    CloseDescriptors();
+
+    mLayerState.ResetFromShuttingDown(); // Return to uninitialized state to permit re-initialization.
+}
+
+void LayerImplEpoll::Signal()
+{
+    /*
+     * Wake up the I/O thread by writing to the wake event.
+     *
+     * If this is being called from within an I/O event callback, then writing to the wake event can be skipped,
+     * since the I/O thread is already awake.
+     */
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+    if (pthread_equal(mHandleSelectThread, pthread_self()))
+    {
+        return;
+    }
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
+    // Send notification to wake up the epoll_wait call.
+    CHIP_ERROR status = mWakeEvent.Notify();
+    if (status != CHIP_NO_ERROR)
+    {
+
+        ChipLogError(chipSystemLayer, "System wake event notify failed: %" CHIP_ERROR_FORMAT, status.Format());
+    }
+}
+
+CHIP_ERROR LayerImplEpoll::StartTimer(Clock::Timeout delay, TimerCompleteCallback onComplete, void * appState)
+{
+    assertChipStackLockedByCurrentThread();
+
+    VerifyOrReturnError(mLayerState.IsInitialized(), CHIP_ERROR_INCORRECT_STATE);
+
+    CHIP_SYSTEM_FAULT_INJECT(FaultInjection::kFault_TimeoutImmediate, delay = System::Clock::kZero);
+
+    CancelTimer(onComplete, appState);
+
+    TimerList::Node * timer = mTimerPool.Create(*this, SystemClock().GetMonotonicTimestamp() + delay, onComplete, appState);
+    VerifyOrReturnError(timer != nullptr, CHIP_ERROR_NO_MEMORY);
+
+    if (mTimerList.Add(timer) == timer)
+    {
+        // The new timer is the earliest, so the time until the next event has probably changed.
+        Signal();
+    }
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR LayerImplEpoll::ExtendTimerTo(Clock::Timeout delay, TimerCompleteCallback onComplete, void * appState)
+{
+    VerifyOrReturnError(delay.count() > 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    assertChipStackLockedByCurrentThread();
+
+    Clock::Timeout remainingTime = mTimerList.GetRemainingTime(onComplete, appState);
+    if (remainingTime.count() < delay.count())
+    {
+        if (remainingTime == Clock::kZero)
+        {
+            // If remaining time is Clock::kZero, it might possible that our timer is in
+            // the mExpiredTimers list and about to be fired. Remove it from that list, since we are extending it.
+            mExpiredTimers.Remove(onComplete, appState);
+        }
+        return StartTimer(delay, onComplete, appState);
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+bool LayerImplEpoll::IsTimerActive(TimerCompleteCallback onComplete, void * appState)
+{
+    bool timerIsActive = (mTimerList.GetRemainingTime(onComplete, appState) > Clock::kZero);
+
+    if (!timerIsActive)
+    {
+        // check if the timer is in the mExpiredTimers list about to be fired.
+        for (TimerList::Node * timer = mExpiredTimers.Earliest(); timer != nullptr; timer = timer->mNextTimer)
+        {
+            if (timer->GetCallback().GetOnComplete() == onComplete && timer->GetCallback().GetAppState() == appState)
+            {
+                return true;
+            }
+        }
+    }
+
+    return timerIsActive;
+}
+
+void LayerImplEpoll::CancelTimer(TimerCompleteCallback onComplete, void * appState)
+{
+    assertChipStackLockedByCurrentThread();
+
+    VerifyOrReturn(mLayerState.IsInitialized());
+
+    TimerList::Node * timer = mTimerList.Remove(onComplete, appState);
+    if (timer == nullptr)
+    {
+        // The timer was not in our "will fire in the future" list, but it might
+        // be in the "we're about to fire these" chunk we already grabbed from
+        // that list.  Check for it there too, and if found there we still want
+        // to cancel it.
+        timer = mExpiredTimers.Remove(onComplete, appState);
+    }
+    VerifyOrReturn(timer != nullptr);
+
+    mTimerPool.Release(timer);
+    Signal();
+}
+
+CHIP_ERROR LayerImplEpoll::ScheduleWork(TimerCompleteCallback onComplete, void * appState)
+{
+    assertChipStackLockedByCurrentThread();
+
+    VerifyOrReturnError(mLayerState.IsInitialized(), CHIP_ERROR_INCORRECT_STATE);
+
+    // Schedule as a timer with no delay, but do NOT cancel previous timers with the same onComplete/appState.
+    // See LayerImplSelect::ScheduleWork() for why a timer is used here.
+    TimerList::Node * timer = mTimerPool.Create(*this, SystemClock().GetMonotonicTimestamp(), onComplete, appState);
+    VerifyOrReturnError(timer != nullptr, CHIP_ERROR_NO_MEMORY);
+
+    if (mTimerList.Add(timer) == timer)
+    {
+        // The new timer is the earliest, so the time until the next event has probably changed.
+        Signal();
+    }
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR LayerImplEpoll::StartWatchingSocket(int fd, SocketWatchToken * tokenOut)
+{
+    VerifyOrReturnError(fd >= 0, CHIP_ERROR_INVALID_ARGUMENT);
+    // Duplicate registration is an error.
+    VerifyOrReturnError(FindWatch(fd) == nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    ReturnErrorOnFailure(GrowWatchTable(fd));
+
+    SocketWatch * watch = Platform::New<SocketWatch>();
+    VerifyOrReturnError(watch != nullptr, CHIP_ERROR_NO_MEMORY);
+    watch->Clear();
+    watch->mFD       = fd;
+    mWatchTable[fd] = watch;
+
+    *tokenOut = reinterpret_cast<SocketWatchToken>(watch);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR LayerImplEpoll::SetCallback(SocketWatchToken token, SocketWatchCallback callback, intptr_t data)
+{
+    SocketWatch * watch = reinterpret_cast<SocketWatch *>(token);
+    VerifyOrReturnError(watch != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    watch->mCallback     = callback;
+    watch->mCallbackData = data;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR LayerImplEpoll::RequestCallbackOnPendingRead(SocketWatchToken token)
+{
+    SocketWatch * watch = reinterpret_cast<SocketWatch *>(token);
+    VerifyOrReturnError(watch != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    watch->mPendingIO.Set(SocketEventFlags::kRead);
+    return UpdateInterest(*watch);
+}
+
+CHIP_ERROR LayerImplEpoll::RequestCallbackOnPendingWrite(SocketWatchToken token)
+{
+    SocketWatch * watch = reinterpret_cast<SocketWatch *>(token);
+    VerifyOrReturnError(watch != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    watch->mPendingIO.Set(SocketEventFlags::kWrite);
+    return UpdateInterest(*watch);
+}
+
+CHIP_ERROR LayerImplEpoll::ClearCallbackOnPendingRead(SocketWatchToken token)
+{
+    SocketWatch * watch = reinterpret_cast<SocketWatch *>(token);
+    VerifyOrReturnError(watch != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    watch->mPendingIO.Clear(SocketEventFlags::kRead);
+    return UpdateInterest(*watch);
+}
+
+CHIP_ERROR LayerImplEpoll::ClearCallbackOnPendingWrite(SocketWatchToken token)
+{
+    SocketWatch * watch = reinterpret_cast<SocketWatch *>(token);
+    VerifyOrReturnError(watch != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    watch->mPendingIO.Clear(SocketEventFlags::kWrite);
+    return UpdateInterest(*watch);
+}
+
+CHIP_ERROR LayerImplEpoll::StopWatchingSocket(SocketWatchToken * tokenInOut)
+{
+    SocketWatch * watch = reinterpret_cast<SocketWatch *>(*tokenInOut);
+    *tokenInOut         = InvalidSocketWatchToken();
+
+    VerifyOrReturnError(watch != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(watch->mFD >= 0, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(FindWatch(watch->mFD) == watch, CHIP_ERROR_INCORRECT_STATE);
+
+    watch->mPendingIO.ClearAll();
+    // The descriptor may already have been closed, in which case the kernel has dropped it from the epoll set.
+    (void) UpdateInterest(*watch);
+
+    // Events for this descriptor that were already retrieved by epoll_wait() are looked up through the table
+    // in HandleEvents(), so removing the entry here guarantees they are dropped.
+    mWatchTable[watch->mFD] = nullptr;
+    Platform::Delete(watch);
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR LayerImplEpoll::GrowWatchTable(int fd)
+{
+    const size_t required = static_cast<size_t>(fd) + 1;
+    VerifyOrReturnError(required > mWatchTableSize, CHIP_NO_ERROR);
+
+    size_t newSize = (mWatchTableSize == 0) ? kInitialWatchTableSize : mWatchTableSize;
+    while (newSize < required)
+    {
+        newSize *= 2;
+    }
+
+    auto * newTable = static_cast<SocketWatch **>(Platform::MemoryRealloc(mWatchTable, newSize * sizeof(SocketWatch *)));
+    VerifyOrReturnError(newTable != nullptr, CHIP_ERROR_NO_MEMORY);
+    for (size_t i = mWatchTableSize; i < newSize; i++)
+    {
+        newTable[i] = nullptr;
+    }
+
+    mWatchTable     = newTable;
+    mWatchTableSize = newSize;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR LayerImplEpoll::UpdateInterest(SocketWatch & watch)
+{
+    uint32_t events = 0;
+    if (watch.mPendingIO.Has(SocketEventFlags::kRead))
+    {
+        events |= EPOLLIN;
+    }
+    if (watch.mPendingIO.Has(SocketEventFlags::kWrite))
+    {
+        events |= EPOLLOUT;
+    }
+    VerifyOrReturnError(events != watch.mRegisteredEvents, CHIP_NO_ERROR);
+
+    // Descriptors without any requested events are removed from the epoll set altogether; otherwise a hung-up
+    // socket would keep reporting EPOLLHUP (which cannot be masked) to a level-triggered wait.
+    int op;
+    if (events == 0)
+    {
+        op = EPOLL_CTL_DEL;
+    }
+    else if (watch.mRegisteredEvents == 0)
+    {
+        op = EPOLL_CTL_ADD;
+    }
+    else
+    {
+        op = EPOLL_CTL_MOD;
+    }
+
+    struct epoll_event event = {};
+    event.events             = events;
+    event.data.fd            = watch.mFD;
+
+    // A failed removal means the descriptor was already closed, which drops it from the epoll set anyway.
+    VerifyOrReturnError(epoll_ctl(mEpollFd, op, watch.mFD, &event) == 0 || op == EPOLL_CTL_DEL, CHIP_ERROR_POSIX(errno));
+    watch.mRegisteredEvents = events;
+    return CHIP_NO_ERROR;
+}
+
+void LayerImplEpoll::ReleaseAllWatches()
+{
+    for (size_t i = 0; i < mWatchTableSize; i++)
+    {
+        if (mWatchTable[i] != nullptr)
+        {
+            Platform::Delete(mWatchTable[i]);
+        }
+    }
+    Platform::MemoryFree(mWatchTable);
+    mWatchTable     = nullptr;
+    mWatchTableSize = 0;
+}
+
+SocketEvents LayerImplEpoll::SocketEventsFromEpoll(uint32_t events)
+{
+    SocketEvents res;
+
+    if (events & EPOLLIN)
+        res.Set(SocketEventFlags::kRead);
+    if (events & EPOLLOUT)
+        res.Set(SocketEventFlags::kWrite);
+    if (events & EPOLLPRI)
+        res.Set(SocketEventFlags::kExcept);
+    if (events & (EPOLLERR | EPOLLHUP))
+        res.Set(SocketEventFlags::kError);
+
+    return res;
+}
+
+void LayerImplEpoll::ArmTimerFd(Clock::Milliseconds64 sleepTime)
+{
+    if (sleepTime == Clock::kZero)
+    {
+        // A timer is already due; poll the sockets without blocking.
+        mEpollTimeout = 0;
+        return;
+    }
+
+    struct itimerspec spec = {};
+    spec.it_value.tv_sec   = static_cast<time_t>(sleepTime.count() / 1000);
+    spec.it_value.tv_nsec  = static_cast<long>((sleepTime.count() % 1000) * 1000000);
+
+    if (timerfd_settime(mTimerFd, 0, &spec, nullptr) == 0)
+    {
+        mEpollTimeout = -1;
+    }
+    else
+    {
+        // Fall back to the (millisecond-granular) epoll_wait() timeout.
+        ChipLogError(chipSystemLayer, "timerfd_settime failed: %" CHIP_ERROR_FORMAT, CHIP_ERROR_POSIX(errno).Format());
+        mEpollTimeout = static_cast<int>(std::min<uint64_t>(sleepTime.count(), INT32_MAX));
+    }
+}
+
+void LayerImplEpoll::PrepareEvents()
+{
+    assertChipStackLockedByCurrentThread();
+
+    const Clock::Timestamp currentTime = SystemClock().GetMonotonicTimestamp();
+    Clock::Timestamp awakenTime        = currentTime + kDefaultMinSleepPeriod;
+
+    TimerList::Node * timer = mTimerList.Earliest();
+    if (timer && timer->AwakenTime() < awakenTime)
+    {
+        awakenTime = timer->AwakenTime();
+    }
+
+    const Clock::Timestamp sleepTime = (awakenTime > currentTime) ? (awakenTime - currentTime) : Clock::kZero;
+    ArmTimerFd(sleepTime);
+
+    // Unlike select(), there is nothing to rebuild here: the interest set lives in the kernel and is only
+    // touched when a socket's requested events change.
+}
+
+void LayerImplEpoll::WaitForEvents()
+{
+    mEpollResult = epoll_wait(mEpollFd, mEvents, CHIP_SYSTEM_CONFIG_EPOLL_MAX_EVENTS, mEpollTimeout);
+}
+
+void LayerImplEpoll::HandleEvents()
+{
+    assertChipStackLockedByCurrentThread();
+
+    if (!IsSelectResultValid())
+    {
+        if (errno != EINTR)
+        {
+            ChipLogError(DeviceLayer, "epoll_wait failed: %" CHIP_ERROR_FORMAT, CHIP_ERROR_POSIX(errno).Format());
+        }
+        return;
+    }
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+    mHandleSelectThread = pthread_self();
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
+    // Obtain the list of currently expired timers. Any new timers added by timer callback are NOT handled on this pass,
+    // since that could result in infinite handling of new timers blocking any other progress.
+    VerifyOrDieWithMsg(mExpiredTimers.Empty(), DeviceLayer, "Re-entry into HandleEvents from a timer callback?");
+    mExpiredTimers          = mTimerList.ExtractEarlier(Clock::Timeout(1) + SystemClock().GetMonotonicTimestamp());
+    TimerList::Node * timer = nullptr;
+    while ((timer = mExpiredTimers.PopEarliest()) != nullptr)
+    {
+        mTimerPool.Invoke(timer);
+    }
+
+    for (int i = 0; i < mEpollResult; i++)
+    {
+        const int fd = mEvents[i].data.fd;
+        if (fd == mTimerFd)
+        {
+            // Acknowledge the expiration; the timers themselves were handled above.
+            uint64_t expirations;
+            (void) read(mTimerFd, &expirations, sizeof(expirations));
+            continue;
+        }
+
+        // Callbacks may stop watching other sockets, so look the watch up again for every event.
+        SocketWatch * watch = FindWatch(fd);
+        if (watch == nullptr || watch->mCallback == nullptr)
+        {
+            continue;
+        }
+
+        SocketEvents events = SocketEventsFromEpoll(mEvents[i].events);
+        if (events.Has(SocketEventFlags::kError))
+        {
+            // Match select(), which reports a failed or hung-up socket as ready for whatever was requested.
+            if (watch->mPendingIO.Has(SocketEventFlags::kRead))
+            {
+                events.Set(SocketEventFlags::kRead);
+            }
+            if (watch->mPendingIO.Has(SocketEventFlags::kWrite))
+            {
+                events.Set(SocketEventFlags::kWrite);
+            }
+        }
+        if (events.HasAny())
+        {
+            watch->mCallback(events, watch->mCallbackData);
+        }
+    }
+
+    mEpollResult = 0;
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+    mHandleSelectThread = PTHREAD_NULL;
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+}
+
+void LayerImplEpoll::SocketWatch::Clear()
+{
+    mFD = kInvalidFd;
+    mPendingIO.ClearAll();
+    mRegisteredEvents = 0;
+    mCallback         = nullptr;
+    mCallbackData     = 0;
+}
+
+} // namespace System
+} // namespace chip
@@ -0,0 +1,158 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file declares an implementation of System::Layer using Linux epoll(7) and timerfd(2).
+ *
+ *      Unlike LayerImplSelect, the set of watched sockets is kept by the kernel, so the cost of a wakeup is
+ *      proportional to the number of ready sockets rather than to the highest watched file descriptor, and
+ *      the number of watched sockets is not bounded by FD_SETSIZE.
+ */
+
+#pragma once
+
+#include "system/SystemConfig.h"
+
+#if !CHIP_SYSTEM_CONFIG_USE_SOCKETS
+#error "LayerImplEpoll requires CHIP_SYSTEM_CONFIG_USE_SOCKETS"
+#endif
+
+#if CHIP_SYSTEM_CONFIG_USE_DISPATCH || CHIP_SYSTEM_CONFIG_USE_LIBEV
+#error "LayerImplEpoll cannot be combined with CHIP_SYSTEM_CONFIG_USE_DISPATCH or CHIP_SYSTEM_CONFIG_USE_LIBEV"
+#endif
+
+#include <sys/epoll.h>
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+#include <atomic>
+#include <pthread.h>
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
+#include <lib/support/ObjectLifeCycle.h>
+#include <system/SystemLayer.h>
+#include <system/SystemTimer.h>
+#include <system/WakeEvent.h>
+
+/**
+ *  @def CHIP_SYSTEM_CONFIG_EPOLL_MAX_EVENTS
+ *
+ *  @brief
+ *      Maximum number of ready file descriptors retrieved by a single epoll_wait() call. Descriptors that are
+ *      still ready after a full batch are reported on the next pass through the event loop.
+ */
+#ifndef CHIP_SYSTEM_CONFIG_EPOLL_MAX_EVENTS
+#define CHIP_SYSTEM_CONFIG_EPOLL_MAX_EVENTS 64
+#endif // CHIP_SYSTEM_CONFIG_EPOLL_MAX_EVENTS
+
+namespace chip {
+namespace System {
+
+class LayerImplEpoll : public LayerSocketsLoop
+{
+public:
+    LayerImplEpoll() = default;
+    ~LayerImplEpoll() override { VerifyOrDie(mLayerState.Destroy()); }
+
+    // Layer overrides.
+    CHIP_ERROR Init() override;
+    void Shutdown() override;
+    bool IsInitialized() const override { return mLayerState.IsInitialized(); }
+    CHIP_ERROR StartTimer(Clock::Timeout delay, TimerCompleteCallback onComplete, void * appState) override;
+    CHIP_ERROR ExtendTimerTo(Clock::Timeout delay, TimerCompleteCallback onComplete, void * appState) override;
+    bool IsTimerActive(TimerCompleteCallback onComplete, void * appState) override;
+    void CancelTimer(TimerCompleteCallback onComplete, void * appState) override;
+    CHIP_ERROR ScheduleWork(TimerCompleteCallback onComplete, void * appState) override;
+
+    // LayerSocket overrides.
+    CHIP_ERROR StartWatchingSocket(int fd, SocketWatchToken * tokenOut) override;
+    CHIP_ERROR SetCallback(SocketWatchToken token, SocketWatchCallback callback, intptr_t data) override;
+    CHIP_ERROR RequestCallbackOnPendingRead(SocketWatchToken token) override;
+    CHIP_ERROR RequestCallbackOnPendingWrite(SocketWatchToken token) override;
+    CHIP_ERROR ClearCallbackOnPendingRead(SocketWatchToken token) override;
+    CHIP_ERROR ClearCallbackOnPendingWrite(SocketWatchToken token) override;
+    CHIP_ERROR StopWatchingSocket(SocketWatchToken * tokenInOut) override;
+    SocketWatchToken InvalidSocketWatchToken() override { return reinterpret_cast<SocketWatchToken>(nullptr); }
+
+    // LayerSocketLoop overrides.
+    void Signal() override;
+    void EventLoopBegins() override {}
+    void PrepareEvents() override;
+    void WaitForEvents() override;
+    void HandleEvents() override;
+    void EventLoopEnds() override {}
+
+    // Expose the result of WaitForEvents() for non-blocking socket implementations.
+    bool IsSelectResultValid() const { return mEpollResult >= 0; }
+
+protected:
+    struct SocketWatch
+    {
+        void Clear();
+        int mFD;
+        SocketEvents mPendingIO;
+        // The events currently registered with the kernel; zero if the descriptor is not in the epoll set.
+        uint32_t mRegisteredEvents;
+        SocketWatchCallback mCallback;
+        intptr_t mCallbackData;
+    };
+
+    static SocketEvents SocketEventsFromEpoll(uint32_t events);
+
+    SocketWatch * FindWatch(int fd) const
+    {
+        return (fd >= 0 && static_cast<size_t>(fd) < mWatchTableSize) ? mWatchTable[fd] : nullptr;
+    }
+    CHIP_ERROR OpenDescriptors();
+    void CloseDescriptors();
+    CHIP_ERROR GrowWatchTable(int fd);
+    CHIP_ERROR UpdateInterest(SocketWatch & watch);
+    void ArmTimerFd(Clock::Milliseconds64 sleepTime);
+    void ReleaseAllWatches();
+
+    // Watched sockets, indexed by file descriptor. Grown on demand by StartWatchingSocket().
+    SocketWatch ** mWatchTable = nullptr;
+    size_t mWatchTableSize     = 0;
+
+    TimerPool<TimerList::Node> mTimerPool;
+    TimerQueue mTimerList;
+    // List of expired timers being processed right now.  Stored in a member so
+    // we can cancel them.
+    TimerList mExpiredTimers;
+
+    int mEpollFd = kInvalidFd;
+    int mTimerFd = kInvalidFd;
+    // Relative timeout passed to epoll_wait(): 0 when a timer has already expired, -1 to rely on the timerfd.
+    int mEpollTimeout = -1;
+
+    struct epoll_event mEvents[CHIP_SYSTEM_CONFIG_EPOLL_MAX_EVENTS];
+
+    // Return value from epoll_wait(), carried between WaitForEvents() and HandleEvents().
+    int mEpollResult = 0;
+
+    ObjectLifeCycle mLayerState;
+    WakeEvent mWakeEvent;
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+    std::atomic<pthread_t> mHandleSelectThread;
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+};
+
+using LayerImpl = LayerImplEpoll;
+
+} // namespace System
+} // namespace chip
@@ -36,11 +36,11 @@
 #include <lib/support/SafeInt.h>
 #include <lib/support/logging/CHIPLogging.h>
 #include <system/SystemFaultInjection.h>
-#include <system/SystemMutex.h>
 #include <system/SystemStats.h>
 
 #include <stdint.h>
 
+#include <atomic>
 #include <limits.h>
 #include <limits>
 #include <stddef.h>
@@ -69,43 +69,180 @@ namespace System {
 //
 // Pool allocation for PacketBuffer objects.
 //
+// The pool is divided into size classes, from smallest to largest. Each class is a static array of equal-size elements with
+// its own lock-free free list, so threads allocating and freeing packet buffers at the same time never block each other.
+//
+
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_SIZE > 0
+static_assert(CHIP_SYSTEM_CONFIG_PACKETBUFFER_SMALL_CAPACITY < CHIP_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX,
+              "Small packet buffers must be smaller than full-size packet buffers");
+#endif
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_SIZE > 0
+static_assert(CHIP_SYSTEM_CONFIG_PACKETBUFFER_MEDIUM_CAPACITY < CHIP_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX,
+              "Medium packet buffers must be smaller than full-size packet buffers");
+#endif
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_SIZE > 0 && CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_SIZE > 0
+static_assert(CHIP_SYSTEM_CONFIG_PACKETBUFFER_SMALL_CAPACITY < CHIP_SYSTEM_CONFIG_PACKETBUFFER_MEDIUM_CAPACITY,
+              "Small packet buffers must be smaller than medium packet buffers");
+#endif
 
-PacketBuffer::BufferPoolElement PacketBuffer::sBufferPool[CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE];
+namespace {
 
-PacketBuffer * PacketBuffer::sFreeList = PacketBuffer::BuildFreeList();
+template <uint16_t kCapacity, uint16_t kCount>
+struct PoolStorage
+{
+    static_assert(kCount < UINT16_MAX, "Too many packet buffers in one size class");
 
-#if !CHIP_SYSTEM_CONFIG_NO_LOCKING
-static Mutex sBufferPoolMutex;
+    union Element
+    {
+        pbuf Header;
+        uint8_t Block[sizeof(PacketBuffer) + kCapacity];
+    };
 
-#define LOCK_BUF_POOL()                                                                                                            \
-    do                                                                                                                             \
-    {                                                                                                                              \
-        sBufferPoolMutex.Lock();                                                                                                   \
-    } while (0)
-#define UNLOCK_BUF_POOL()                                                                                                          \
-    do                                                                                                                             \
-    {                                                                                                                              \
-        sBufferPoolMutex.Unlock();                                                                                                 \
-    } while (0)
-#endif // !CHIP_SYSTEM_CONFIG_NO_LOCKING
+    Element mElements[kCount];
+    // Free list links: for a free element, the index plus one of the next free element, or zero at the end of the list.
+    std::atomic<uint16_t> mLinks[kCount];
+};
 
-PacketBuffer * PacketBuffer::BuildFreeList()
+/**
+ * One size class of the packet buffer pool.
+ *
+ * The free list is a lock-free stack of element indices. The head word holds the index of the top element, plus one so that
+ * zero means empty, in its lower half, and a generation count that changes on every push in its upper half; a pop that raced
+ * with a pop and a push of the same element therefore fails its compare-exchange instead of installing a stale successor.
+ * Elements that have never been used are handed out in order from mUnused, so the pool needs no run-time initialization.
+ */
+class PoolSizeClass
 {
-    pbuf * lHead = nullptr;
+public:
+    static constexpr int kNoStatsEntry = -1;
+
+    template <uint16_t kCapacity, uint16_t kCount>
+    constexpr PoolSizeClass(PoolStorage<kCapacity, kCount> & storage, int statsEntry) :
+        mElements(storage.mElements), mLinks(storage.mLinks), mElementSize(sizeof(storage.mElements[0])), mCapacity(kCapacity),
+        mCount(kCount), mStatsEntry(statsEntry)
+    {}
+
+    uint16_t Capacity() const { return mCapacity; }
+    int StatsEntry() const { return mStatsEntry; }
+
+    uint8_t * Allocate()
+    {
+        uint32_t head = mHead.load(std::memory_order_acquire);
+        while ((head & kIndexMask) != 0)
+        {
+            const uint16_t index   = static_cast<uint16_t>((head & kIndexMask) - 1);
+            const uint32_t newHead = (head & ~kIndexMask) | mLinks[index].load(std::memory_order_relaxed);
+            if (mHead.compare_exchange_weak(head, newHead, std::memory_order_acquire, std::memory_order_acquire))
+            {
+                return Element(index);
+            }
+        }
+
+        uint16_t unused = mUnused.load(std::memory_order_relaxed);
+        while (unused < mCount)
+        {
+            if (mUnused.compare_exchange_weak(unused, static_cast<uint16_t>(unused + 1), std::memory_order_relaxed))
+            {
+                return Element(unused);
+            }
+        }
+        return nullptr;
+    }
 
-    for (int i = 0; i < CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE; i++)
+    void Release(uint8_t * element)
     {
-        pbuf * lCursor = &sBufferPool[i].Header;
-        lCursor->next  = lHead;
-        lCursor->ref   = 0;
-        lHead          = lCursor;
+        const uintptr_t offset = reinterpret_cast<uintptr_t>(element) - reinterpret_cast<uintptr_t>(mElements);
+        const uintptr_t index  = offset / mElementSize;
+        VerifyOrDieWithMsg(index < mUnused.load(std::memory_order_relaxed) && offset % mElementSize == 0, chipSystemLayer,
+                           "invalid pool packet buffer %p", element);
+
+        uint32_t head = mHead.load(std::memory_order_relaxed);
+        uint32_t newHead;
+        do
+        {
+            mLinks[index].store(static_cast<uint16_t>(head & kIndexMask), std::memory_order_relaxed);
+            newHead = ((head + kGenerationIncrement) & ~kIndexMask) | static_cast<uint32_t>(index + 1);
+        } while (!mHead.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+private:
+    static constexpr uint32_t kIndexMask           = 0xFFFF;
+    static constexpr uint32_t kGenerationIncrement = 0x10000;
+
+    uint8_t * Element(uint16_t index) const
+    {
+        return static_cast<uint8_t *>(mElements) + static_cast<size_t>(index) * mElementSize;
     }
 
-#if !CHIP_SYSTEM_CONFIG_NO_LOCKING
-    Mutex::Init(sBufferPoolMutex);
-#endif // !CHIP_SYSTEM_CONFIG_NO_LOCKING
+    void * const mElements;
+    std::atomic<uint16_t> * const mLinks;
+    const size_t mElementSize;
+    const uint16_t mCapacity;
+    const uint16_t mCount;
+    const int mStatsEntry;
+    std::atomic<uint32_t> mHead{ 0 };
+    std::atomic<uint16_t> mUnused{ 0 };
+};
+
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_SIZE > 0
+PoolStorage<CHIP_SYSTEM_CONFIG_PACKETBUFFER_SMALL_CAPACITY, CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_SIZE> sSmallPoolStorage;
+#endif
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_SIZE > 0
+PoolStorage<CHIP_SYSTEM_CONFIG_PACKETBUFFER_MEDIUM_CAPACITY, CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_SIZE> sMediumPoolStorage;
+#endif
+PoolStorage<PacketBuffer::kMaxSizeWithoutReserve, CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE> sFullSizePoolStorage;
 
-    return static_cast<PacketBuffer *>(lHead);
+PoolSizeClass sPoolSizeClasses[] = {
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_SIZE > 0
+    { sSmallPoolStorage, chip::System::Stats::kSystemLayer_NumSmallPacketBufs },
+#endif
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_SIZE > 0
+    { sMediumPoolStorage, chip::System::Stats::kSystemLayer_NumMediumPacketBufs },
+#endif
+    { sFullSizePoolStorage, PoolSizeClass::kNoStatsEntry },
+};
+
+} // namespace
+
+PacketBuffer * PacketBuffer::AllocateFromPool(size_t aAllocSize)
+{
+    for (PoolSizeClass & sizeClass : sPoolSizeClasses)
+    {
+        if (sizeClass.Capacity() < aAllocSize)
+        {
+            continue;
+        }
+
+        PacketBuffer * lPacket = reinterpret_cast<PacketBuffer *>(sizeClass.Allocate());
+        if (lPacket != nullptr)
+        {
+            lPacket->alloc_size = sizeClass.Capacity();
+            if (sizeClass.StatsEntry() != PoolSizeClass::kNoStatsEntry)
+            {
+                SYSTEM_STATS_INCREMENT(sizeClass.StatsEntry());
+            }
+            return lPacket;
+        }
+    }
+    return nullptr;
+}
+
+void PacketBuffer::ReleaseToPool(PacketBuffer * aPacket)
+{
+    for (PoolSizeClass & sizeClass : sPoolSizeClasses)
+    {
+        if (sizeClass.Capacity() == aPacket->alloc_size)
+        {
+            if (sizeClass.StatsEntry() != PoolSizeClass::kNoStatsEntry)
+            {
+                SYSTEM_STATS_DECREMENT(sizeClass.StatsEntry());
+            }
+            sizeClass.Release(reinterpret_cast<uint8_t *>(aPacket));
+            return;
+        }
+    }
+    VerifyOrDieWithMsg(false, chipSystemLayer, "invalid pool packet buffer %p", aPacket);
 }
 
 #elif CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP
@@ -182,20 +319,6 @@ void PacketBufferHandle::InternalRightSize()
 
 #endif
 
-#ifndef LOCK_BUF_POOL
-#define LOCK_BUF_POOL()                                                                                                            \
-    do                                                                                                                             \
-    {                                                                                                                              \
-    } while (0)
-#endif // !defined(LOCK_BUF_POOL)
-
-#ifndef UNLOCK_BUF_POOL
-#define UNLOCK_BUF_POOL()                                                                                                          \
-    do                                                                                                                             \
-    {                                                                                                                              \
-    } while (0)
-#endif // !defined(UNLOCK_BUF_POOL)
-
 void PacketBuffer::SetStart(uint8_t * aNewStart)
 {
     uint8_t * const kStart = ReserveStart();
@@ -466,11 +589,10 @@ void PacketBuffer::AddRef()
 #if CHIP_SYSTEM_CONFIG_USE_LWIP
     pbuf_ref(this);
 #else  // !CHIP_SYSTEM_CONFIG_USE_LWIP
-    LOCK_BUF_POOL();
-    VerifyOrDieWithMsg(this->ref < std::numeric_limits<decltype(this->ref)>::max(), chipSystemLayer,
+    // Reference counts are updated atomically since buffers are shared between threads without a pool lock.
+    const uint16_t lOldRef = __sync_fetch_and_add(&this->ref, 1);
+    VerifyOrDieWithMsg(lOldRef < std::numeric_limits<decltype(this->ref)>::max(), chipSystemLayer,
                        "packet buffer refcount overflow");
-    ++this->ref;
-    UNLOCK_BUF_POOL();
 #endif // !CHIP_SYSTEM_CONFIG_USE_LWIP
 }
 
@@ -508,23 +630,12 @@ PacketBufferHandle PacketBufferHandle::New(size_t aAvailableSize, uint16_t aRese
 #elif CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_POOL
 
     static_cast<void>(lBlockSize);
-#if !CHIP_SYSTEM_CONFIG_NO_LOCKING && CHIP_SYSTEM_CONFIG_FREERTOS_LOCKING
-    if (!sBufferPoolMutex.isInitialized())
-    {
-        Mutex::Init(sBufferPoolMutex);
-    }
-#endif
-    LOCK_BUF_POOL();
-
-    lPacket = PacketBuffer::sFreeList;
+    lPacket = PacketBuffer::AllocateFromPool(lAllocSize);
     if (lPacket != nullptr)
     {
-        PacketBuffer::sFreeList = lPacket->ChainedBuffer();
         SYSTEM_STATS_INCREMENT(chip::System::Stats::kSystemLayer_NumPacketBufs);
     }
 
-    UNLOCK_BUF_POOL();
-
 #elif CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP
 
     lPacket = reinterpret_cast<PacketBuffer *>(chip::Platform::MemoryAlloc(lBlockSize));
@@ -592,16 +703,14 @@ void PacketBuffer::Free(PacketBuffer * aPacket)
 
 #elif CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP || CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_POOL
 
-    LOCK_BUF_POOL();
-
     while (aPacket != nullptr)
     {
         PacketBuffer * lNextPacket = aPacket->ChainedBuffer();
 
-        VerifyOrDieWithMsg(aPacket->ref > 0, chipSystemLayer, "SystemPacketBuffer::Free: aPacket->ref = 0");
+        const uint16_t lNewRef = __sync_sub_and_fetch(&aPacket->ref, 1);
+        VerifyOrDieWithMsg(lNewRef != UINT16_MAX, chipSystemLayer, "SystemPacketBuffer::Free: aPacket->ref = 0");
 
-        aPacket->ref--;
-        if (aPacket->ref == 0)
+        if (lNewRef == 0)
         {
             SYSTEM_STATS_DECREMENT(chip::System::Stats::kSystemLayer_NumPacketBufs);
 #if CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP
@@ -609,12 +718,11 @@ void PacketBuffer::Free(PacketBuffer * aPacket)
 #endif
             aPacket->Clear();
 #if CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_POOL
-            aPacket->next = sFreeList;
-            sFreeList     = aPacket;
+            ReleaseToPool(aPacket);
 #elif CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP
             chip::Platform::MemoryFree(aPacket);
 #endif
-            aPacket       = lNextPacket;
+            aPacket = lNextPacket;
         }
         else
         {
@@ -622,8 +730,6 @@ void PacketBuffer::Free(PacketBuffer * aPacket)
         }
     }
 
-    UNLOCK_BUF_POOL();
-
 #else
 #error "Unimplemented PacketBuffer storage case"
 #endif
@@ -59,7 +59,7 @@ struct pbuf
     uint16_t tot_len;
     uint16_t len;
     uint16_t ref;
-#if CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP
+#if CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP || CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_POOL
     uint16_t alloc_size;
 #endif
 };
@@ -85,7 +85,8 @@ struct pbuf
  *
  *      New objects of PacketBuffer class are initialized at the beginning of an allocation of memory obtained from the underlying
  *      environment, e.g. from LwIP pbuf target pools, from the standard C library heap, from an internal buffer pool. In the
- *      simple pool case, the size of the data buffer is PacketBuffer::kBlockSize.
+ *      internal pool case, the buffer comes from the smallest configured size class that can hold the requested size and has a
+ *      free buffer; a full-size pool element is PacketBuffer::kBlockSize bytes.
  *
  *      PacketBuffer objects may be chained to accommodate larger payloads.  Chaining, however, is not transparent, and users of the
  *      class must explicitly decide to support chaining.  Examples of classes written with chaining support are as follows:
@@ -150,9 +151,9 @@ public:
      */
     uint16_t AllocSize() const
     {
-#if CHIP_SYSTEM_PACKETBUFFER_FROM_LWIP_STANDARD_POOL || CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_POOL
+#if CHIP_SYSTEM_PACKETBUFFER_FROM_LWIP_STANDARD_POOL
         return kMaxSizeWithoutReserve;
-#elif CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP
+#elif CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_HEAP || CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_POOL
         return this->alloc_size;
 #elif CHIP_SYSTEM_PACKETBUFFER_FROM_LWIP_CUSTOM_POOL
         // Temporary workaround for custom pbufs by assuming size to be PBUF_POOL_BUFSIZE
@@ -359,14 +360,8 @@ private:
 
     // Note: this condition includes DOXYGEN to work around a Doxygen error. DOXYGEN is never defined in any actual build.
 #if CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_POOL || defined(DOXYGEN)
-    typedef union
-    {
-        pbuf Header;
-        uint8_t Block[PacketBuffer::kBlockSize];
-    } BufferPoolElement;
-    static BufferPoolElement sBufferPool[CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE];
-    static PacketBuffer * sFreeList;
-    static PacketBuffer * BuildFreeList();
+    static PacketBuffer * AllocateFromPool(size_t aAllocSize);
+    static void ReleaseToPool(PacketBuffer * aPacket);
 #endif // CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_POOL || defined(DOXYGEN)
 
 #if CHIP_SYSTEM_PACKETBUFFER_HAS_CHECK
@@ -44,6 +44,14 @@ static const Label sStatsStrings[chip::System::Stats::kNumEntries] = {
 #undef LWIP_PBUF_MEMPOOL
 #else
     "Packet Buffers",
+#if !CHIP_SYSTEM_CONFIG_USE_LWIP && CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE > 0
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_SIZE > 0
+    "Small Packet Buffers",
+#endif
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_SIZE > 0
+    "Medium Packet Buffers",
+#endif
+#endif // !CHIP_SYSTEM_CONFIG_USE_LWIP && CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE > 0
 #endif
     "Timers",
 #if INET_CONFIG_NUM_TCP_ENDPOINTS
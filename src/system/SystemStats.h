@@ -58,6 +58,14 @@ enum
 #undef LWIP_PBUF_MEMPOOL
 #else
     kSystemLayer_NumPacketBufs,
+#if !CHIP_SYSTEM_CONFIG_USE_LWIP && CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE > 0
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_SIZE > 0
+    kSystemLayer_NumSmallPacketBufs,
+#endif
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_SIZE > 0
+    kSystemLayer_NumMediumPacketBufs,
+#endif
+#endif // !CHIP_SYSTEM_CONFIG_USE_LWIP && CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE > 0
 #endif
     kSystemLayer_NumTimers,
 #if INET_CONFIG_NUM_TCP_ENDPOINTS
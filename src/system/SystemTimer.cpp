@@ -178,5 +178,156 @@ Clock::Timeout TimerList::GetRemainingTime(TimerCompleteCallback aOnComplete, vo
     return Clock::kZero;
 }
 
+TimerQueue::Node * TimerQueue::Add(Node * add)
+{
+    VerifyOrDie(add != nullptr && add != mHeap.Top());
+
+    add->mSequence = mNextSequence++;
+
+    size_t bucket      = BucketIndex(add->GetCallback().GetOnComplete(), add->GetCallback().GetAppState());
+    add->mNextInBucket = mBuckets[bucket];
+    mBuckets[bucket]   = add;
+
+    mHeap.Push(add);
+    return mHeap.Top();
+}
+
+TimerQueue::Node * TimerQueue::Remove(Node * remove)
+{
+    if (remove != nullptr && Unindex(remove))
+    {
+        mHeap.Remove(remove);
+    }
+    return mHeap.Top();
+}
+
+TimerQueue::Node * TimerQueue::Remove(TimerCompleteCallback aOnComplete, void * aAppState)
+{
+    Node * timer = Find(aOnComplete, aAppState);
+    if (timer != nullptr)
+    {
+        Unindex(timer);
+        mHeap.Remove(timer);
+    }
+    return timer;
+}
+
+TimerQueue::Node * TimerQueue::PopEarliest()
+{
+    Node * earliest = mHeap.Pop();
+    if (earliest != nullptr)
+    {
+        Unindex(earliest);
+    }
+    return earliest;
+}
+
+TimerQueue::Node * TimerQueue::PopIfEarlier(Clock::Timestamp t)
+{
+    if (mHeap.Empty() || !(mHeap.Top()->AwakenTime() < t))
+    {
+        return nullptr;
+    }
+    return PopEarliest();
+}
+
+TimerList TimerQueue::ExtractEarlier(Clock::Timestamp t)
+{
+    TimerList out;
+    Node * last = nullptr;
+
+    // Timers come out of the heap in order, so append them to the list directly instead of using TimerList::Add().
+    Node * timer;
+    while ((timer = PopIfEarlier(t)) != nullptr)
+    {
+        timer->mNextTimer = nullptr;
+        if (last == nullptr)
+        {
+            out.mEarliestTimer = timer;
+        }
+        else
+        {
+            last->mNextTimer = timer;
+        }
+        last = timer;
+    }
+
+    return out;
+}
+
+void TimerQueue::Clear()
+{
+    mHeap.Clear();
+    mNextSequence = 0;
+    for (auto & bucket : mBuckets)
+    {
+        bucket = nullptr;
+    }
+}
+
+TimerQueue::Node * TimerQueue::Find(TimerCompleteCallback aOnComplete, void * aAppState) const
+{
+    // Several timers may share a callback and state (see Layer::ScheduleWork()); like TimerList, return the earliest.
+    Node * found = nullptr;
+    for (Node * timer = mBuckets[BucketIndex(aOnComplete, aAppState)]; timer != nullptr; timer = timer->mNextInBucket)
+    {
+        if (timer->GetCallback().GetOnComplete() == aOnComplete && timer->GetCallback().GetAppState() == aAppState &&
+            (found == nullptr || IsEarlier()(timer, found)))
+        {
+            found = timer;
+        }
+    }
+    return found;
+}
+
+Clock::Timeout TimerQueue::GetRemainingTime(TimerCompleteCallback aOnComplete, void * aAppState) const
+{
+    Node * timer = Find(aOnComplete, aAppState);
+    if (timer != nullptr)
+    {
+        Clock::Timestamp currentTime = SystemClock().GetMonotonicTimestamp();
+
+        if (currentTime < timer->AwakenTime())
+        {
+            return Clock::Timeout(timer->AwakenTime() - currentTime);
+        }
+    }
+    return Clock::kZero;
+}
+
+size_t TimerQueue::BucketIndex(TimerCompleteCallback aOnComplete, void * aAppState)
+{
+    // Fibonacci hashing of the two pointers; the low bits of pointers carry little information because of alignment.
+    uint64_t key = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(aOnComplete)) ^
+        (static_cast<uint64_t>(reinterpret_cast<uintptr_t>(aAppState)) * UINT64_C(0x9E3779B97F4A7C15));
+    key *= UINT64_C(0x9E3779B97F4A7C15);
+    return static_cast<size_t>(key >> 32) & (kNumBuckets - 1);
+}
+
+bool TimerQueue::IsEarlier::operator()(const Node * a, const Node * b) const
+{
+    if (a->AwakenTime() != b->AwakenTime())
+    {
+        return a->AwakenTime() < b->AwakenTime();
+    }
+    // Timers with the same awaken time expire in the order they were added, as with TimerList.
+    return static_cast<int32_t>(a->mSequence - b->mSequence) < 0;
+}
+
+bool TimerQueue::Unindex(Node * node)
+{
+    Node ** link = &mBuckets[BucketIndex(node->GetCallback().GetOnComplete(), node->GetCallback().GetAppState())];
+    for (; *link != nullptr; link = &(*link)->mNextInBucket)
+    {
+        if (*link == node)
+        {
+            *link               = node->mNextInBucket;
+            node->mNextInBucket = nullptr;
+            return true;
+        }
+    }
+    return false;
+}
+
 } // namespace System
 } // namespace chip
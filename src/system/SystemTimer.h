@@ -29,6 +29,7 @@
 
 // Include dependent headers
 #include <lib/support/DLLUtil.h>
+#include <lib/support/IntrusivePairingHeap.h>
 #include <lib/support/Pool.h>
 
 #include <system/SystemClock.h>
@@ -110,13 +111,20 @@ private:
 class TimerList
 {
 public:
-    class Node : public TimerData
+    class Node : public TimerData, public IntrusivePairingHeapNode
     {
     public:
         Node(Layer & systemLayer, System::Clock::Timestamp awakenTime, TimerCompleteCallback onComplete, void * appState) :
             TimerData(systemLayer, awakenTime, onComplete, appState), mNextTimer(nullptr)
         {}
         Node * mNextTimer;
+
+    private:
+        friend class TimerQueue;
+
+        // Used while the node is held by a TimerQueue, which also links it through its IntrusivePairingHeapNode base.
+        Node * mNextInBucket = nullptr; // Next node in the same (callback, appState) hash bucket.
+        uint32_t mSequence   = 0;       // Insertion order, to keep timers with equal awaken times FIFO.
     };
 
     TimerList() : mEarliestTimer(nullptr) {}
@@ -187,9 +195,117 @@ public:
     Clock::Timeout GetRemainingTime(TimerCompleteCallback aOnComplete, void * aAppState);
 
 private:
+    friend class TimerQueue;
+
     Node * mEarliestTimer;
 };
 
+/**
+ * Queue of `Timer`s ordered by expiration time, for layers holding many concurrent timers.
+ *
+ * This provides the same operations as TimerList, but keeps the timers in an IntrusivePairingHeap, so that
+ * Add() is O(1), PopEarliest() and Remove() are O(log n) amortized and Earliest() is O(1). Timers are also
+ * indexed by (callback, appState), so that lookups by those properties do not walk the queue.
+ */
+class TimerQueue
+{
+public:
+    using Node = TimerList::Node;
+
+    TimerQueue() { Clear(); }
+
+    /**
+     * Add a timer to the queue
+     *
+     * @return  The new earliest timer in the queue. If this is the newly added timer, that implies it is earlier
+     *          than any existing timer.
+     */
+    Node * Add(Node * timer);
+
+    /**
+     * Remove the given timer from the queue, if present. It is not an error for the timer not to be present.
+     *
+     * @return  The new earliest timer in the queue, or nullptr if the queue is empty.
+     */
+    Node * Remove(Node * remove);
+
+    /**
+     * Remove the earliest timer with the given properties, if present. It is not an error for no such timer to be present.
+     *
+     * @return  The removed timer, or nullptr if the queue contains no matching timer.
+     */
+    Node * Remove(TimerCompleteCallback onComplete, void * appState);
+
+    /**
+     * Remove and return the earliest timer in the queue.
+     *
+     * @return  The earliest timer, or nullptr if the queue is empty.
+     */
+    Node * PopEarliest();
+
+    /**
+     * Remove and return the earliest timer in the queue, provided it expires earlier than the given time @a t.
+     *
+     * @return  The earliest timer expiring before @a t, or nullptr if there is no such timer.
+     */
+    Node * PopIfEarlier(Clock::Timestamp t);
+
+    /**
+     * Get the earliest timer in the queue.
+     *
+     * @return  The earliest timer, or nullptr if there are no timers.
+     */
+    Node * Earliest() const { return mHeap.Top(); }
+
+    /**
+     * Test whether there are any timers.
+     */
+    bool Empty() const { return mHeap.Empty(); }
+
+    /**
+     * Remove and return all timers that expire before the given time @a t, in expiration order.
+     */
+    TimerList ExtractEarlier(Clock::Timestamp t);
+
+    /**
+     * Remove all timers.
+     */
+    void Clear();
+
+    /**
+     * Find the earliest timer with the given properties, if present.
+     */
+    Node * Find(TimerCompleteCallback onComplete, void * appState) const;
+
+    /**
+     * Find the timer with the given properties, if present, and return its remaining time
+     *
+     * @return The remaining time on this particular timer or 0 if not found.
+     */
+    Clock::Timeout GetRemainingTime(TimerCompleteCallback onComplete, void * appState) const;
+
+private:
+    static constexpr size_t kNumBuckets = CHIP_SYSTEM_CONFIG_TIMER_QUEUE_BUCKETS;
+    static_assert(kNumBuckets > 0 && (kNumBuckets & (kNumBuckets - 1)) == 0,
+                  "CHIP_SYSTEM_CONFIG_TIMER_QUEUE_BUCKETS must be a power of two");
+
+    struct IsEarlier
+    {
+        bool operator()(const Node * a, const Node * b) const;
+    };
+
+    static size_t BucketIndex(TimerCompleteCallback onComplete, void * appState);
+    bool Unindex(Node * node);
+
+    IntrusivePairingHeap<Node, IsEarlier> mHeap;
+    uint32_t mNextSequence;
+    Node * mBuckets[kNumBuckets];
+
+    // Not defined
+    TimerQueue(const TimerQueue &)             = delete;
+    TimerQueue & operator=(const TimerQueue &) = delete;
+};
+
 /**
  * ObjectPool wrapper that keeps System Timer statistics.
  */
@@ -29,6 +29,7 @@
 
 #include <errno.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <utility>
@@ -48,6 +49,10 @@
 
 #include <nlunit-test.h>
 
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+#include <pthread.h>
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
 #if CHIP_SYSTEM_CONFIG_USE_LWIP
 #if (LWIP_VERSION_MAJOR == 2) && (LWIP_VERSION_MINOR == 0)
 #define PBUF_TYPE(pbuf) (pbuf)->type
@@ -133,6 +138,8 @@ public:
     static void CheckHandleRightSize(nlTestSuite * inSuite, void * inContext);
     static void CheckHandleCloneData(nlTestSuite * inSuite, void * inContext);
     static void CheckPacketBufferWriter(nlTestSuite * inSuite, void * inContext);
+    static void CheckSizeClasses(nlTestSuite * inSuite, void * inContext);
+    static void CheckConcurrentNewFree(nlTestSuite * inSuite, void * inContext);
     static void CheckBuildFreeList(nlTestSuite * inSuite, void * inContext);
 
     static void PrintHandle(const char * tag, const PacketBuffer * buffer)
@@ -1963,6 +1970,136 @@ void PacketBufferTest::CheckPacketBufferWriter(nlTestSuite * inSuite, void * inC
     NL_TEST_ASSERT(inSuite, memcmp(yayBuffer->Start(), kPayload, sizeof kPayload) == 0);
 }
 
+/**
+ *  Test that PacketBufferHandle::New() takes buffers from the smallest size class that fits and has a free buffer.
+ */
+void PacketBufferTest::CheckSizeClasses(nlTestSuite * inSuite, void * inContext)
+{
+    struct TestContext * const theContext = static_cast<struct TestContext *>(inContext);
+    PacketBufferTest * const test         = theContext->test;
+    NL_TEST_ASSERT(inSuite, test->mContext == theContext);
+
+    const uint16_t kSizes[] = { 0, 16, 100, 128, 200, 512, 1000, PacketBuffer::kMaxSizeWithoutReserve };
+    for (uint16_t size : kSizes)
+    {
+        PacketBufferHandle buffer = PacketBufferHandle::New(size, 0);
+        NL_TEST_ASSERT(inSuite, !buffer.IsNull());
+        if (!buffer.IsNull())
+        {
+            NL_TEST_ASSERT(inSuite, buffer->AllocSize() >= size);
+            NL_TEST_ASSERT(inSuite, buffer->MaxDataLength() >= size);
+        }
+    }
+
+#if CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_POOL
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_SIZE > 0
+    constexpr uint16_t kSmallestCapacity = CHIP_SYSTEM_CONFIG_PACKETBUFFER_SMALL_CAPACITY;
+#elif CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_MEDIUM_SIZE > 0
+    constexpr uint16_t kSmallestCapacity = CHIP_SYSTEM_CONFIG_PACKETBUFFER_MEDIUM_CAPACITY;
+#else
+    constexpr uint16_t kSmallestCapacity = PacketBuffer::kMaxSizeWithoutReserve;
+#endif
+
+    // Exhaust the smallest size class; further small allocations must fall back to a larger class.
+    std::vector<PacketBufferHandle> smallest;
+    for (;;)
+    {
+        PacketBufferHandle buffer = PacketBufferHandle::New(kSmallestCapacity / 2, 0);
+        if (buffer.IsNull() || buffer->AllocSize() != kSmallestCapacity)
+        {
+            NL_TEST_ASSERT(inSuite, buffer.IsNull() || buffer->AllocSize() > kSmallestCapacity);
+            break;
+        }
+        smallest.push_back(std::move(buffer));
+    }
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_SIZE > 0
+    NL_TEST_ASSERT(inSuite, smallest.size() == CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SMALL_SIZE);
+#endif
+
+    // Returned buffers are reused by the class they came from.
+    smallest.clear();
+    PacketBufferHandle buffer = PacketBufferHandle::New(kSmallestCapacity / 2, 0);
+    NL_TEST_ASSERT(inSuite, !buffer.IsNull() && buffer->AllocSize() == kSmallestCapacity);
+#endif // CHIP_SYSTEM_PACKETBUFFER_FROM_CHIP_POOL
+}
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+namespace {
+
+constexpr int kConcurrentThreads    = 4;
+constexpr int kConcurrentIterations = 20000;
+
+struct ConcurrentContext
+{
+    int mSeed;
+    int mFailures;
+};
+
+void * AllocateAndFreeBuffers(void * aContext)
+{
+    ConcurrentContext * const context = static_cast<ConcurrentContext *>(aContext);
+    for (int i = 0; i < kConcurrentIterations; i++)
+    {
+        const uint16_t size = static_cast<uint16_t>((i * 37 + context->mSeed * 101) % 600);
+        const uint8_t fill  = static_cast<uint8_t>(context->mSeed + i);
+
+        PacketBufferHandle buffer = PacketBufferHandle::New(size, 0);
+        if (buffer.IsNull())
+        {
+            // The pool may be momentarily exhausted by the other threads.
+            continue;
+        }
+        memset(buffer->Start(), fill, size);
+
+        // Share the buffer briefly, so that reference counting is exercised as well.
+        PacketBufferHandle retained = buffer.Retain();
+        buffer                      = nullptr;
+
+        for (uint16_t j = 0; j < size; j++)
+        {
+            if (retained->Start()[j] != fill)
+            {
+                context->mFailures++;
+                break;
+            }
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
+/**
+ *  Test that packet buffers can be allocated and freed concurrently from several threads without corruption.
+ */
+void PacketBufferTest::CheckConcurrentNewFree(nlTestSuite * inSuite, void * inContext)
+{
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+    pthread_t threads[kConcurrentThreads];
+    ConcurrentContext contexts[kConcurrentThreads];
+
+    for (int i = 0; i < kConcurrentThreads; i++)
+    {
+        contexts[i] = { i, 0 };
+        NL_TEST_ASSERT(inSuite, pthread_create(&threads[i], nullptr, AllocateAndFreeBuffers, &contexts[i]) == 0);
+    }
+    for (int i = 0; i < kConcurrentThreads; i++)
+    {
+        NL_TEST_ASSERT(inSuite, pthread_join(threads[i], nullptr) == 0);
+        NL_TEST_ASSERT(inSuite, contexts[i].mFailures == 0);
+    }
+
+    // Every buffer must have been returned: a full pool can be allocated again.
+    std::vector<PacketBufferHandle> buffers;
+    for (int i = 0; i < kConcurrentThreads; i++)
+    {
+        buffers.push_back(PacketBufferHandle::New(PacketBuffer::kMaxSizeWithoutReserve, 0));
+        NL_TEST_ASSERT(inSuite, !buffers.back().IsNull());
+    }
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+}
+
 /**
  *   Test Suite. It lists all the test functions.
  */
@@ -2003,6 +2140,8 @@ const nlTest sTests[] =
     NL_TEST_DEF("PacketBuffer::HandleRightSize",        PacketBufferTest::CheckHandleRightSize),
     NL_TEST_DEF("PacketBuffer::HandleCloneData",        PacketBufferTest::CheckHandleCloneData),
     NL_TEST_DEF("PacketBuffer::PacketBufferWriter",     PacketBufferTest::CheckPacketBufferWriter),
+    NL_TEST_DEF("PacketBuffer::SizeClasses",            PacketBufferTest::CheckSizeClasses),
+    NL_TEST_DEF("PacketBuffer::ConcurrentNewFree",      PacketBufferTest::CheckConcurrentNewFree),
 
     NL_TEST_SENTINEL()
 };
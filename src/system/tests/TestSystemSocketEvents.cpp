@@ -0,0 +1,284 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This is a unit test suite and benchmark for socket event dispatch in the configured
+ *      <tt>chip::System::LayerImpl</tt> (select or epoll).
+ *
+ *      For 16, 256 and 2048 watched sockets it checks that each datagram produces exactly one
+ *      callback, and reports the wakeup latency and the CPU time spent per event. Building with
+ *      chip_system_config_event_loop = "Select" and = "Epoll" gives the two sets of numbers to compare.
+ *      Sizes that exceed the backend's capacity (or the process file descriptor limit) are skipped.
+ */
+
+#include <system/SystemConfig.h>
+
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/UnitTestContext.h>
+#include <lib/support/UnitTestRegistration.h>
+#include <nlunit-test.h>
+#include <system/SystemLayerImpl.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace chip;
+using namespace chip::System;
+
+namespace {
+
+constexpr size_t kSocketCounts[] = { 16, 256, 2048 };
+constexpr size_t kEventsPerRun   = 2000;
+
+uint64_t NowNs(clockid_t clock)
+{
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000u + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+struct WatchedSocket
+{
+    int mFds[2]                  = { kInvalidFd, kInvalidFd };
+    SocketWatchToken mToken      = 0;
+    size_t mCallbacks            = 0;
+    struct BenchContext * mOwner = nullptr;
+};
+
+struct BenchContext
+{
+    LayerImpl mLayer;
+    WatchedSocket * mSockets = nullptr;
+    size_t mCount            = 0;
+    size_t mTotalCallbacks   = 0;
+    uint64_t mLastCallbackNs = 0;
+};
+
+void HandleReadable(SocketEvents events, intptr_t data)
+{
+    auto * socket = reinterpret_cast<WatchedSocket *>(data);
+    if (!events.Has(SocketEventFlags::kRead))
+    {
+        return;
+    }
+
+    uint8_t byte;
+    while (read(socket->mFds[0], &byte, sizeof(byte)) > 0)
+    {
+    }
+    socket->mCallbacks++;
+    socket->mOwner->mTotalCallbacks++;
+    socket->mOwner->mLastCallbackNs = NowNs(CLOCK_MONOTONIC);
+}
+
+void RaiseFileDescriptorLimit()
+{
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max)
+    {
+        limit.rlim_cur = limit.rlim_max;
+        (void) setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+void CloseSockets(BenchContext & ctx)
+{
+    for (size_t i = 0; i < ctx.mCount; i++)
+    {
+        WatchedSocket & s = ctx.mSockets[i];
+        if (s.mToken != ctx.mLayer.InvalidSocketWatchToken())
+        {
+            ctx.mLayer.StopWatchingSocket(&s.mToken);
+        }
+        for (int fd : s.mFds)
+        {
+            if (fd != kInvalidFd)
+            {
+                close(fd);
+            }
+        }
+    }
+    Platform::MemoryFree(ctx.mSockets);
+    ctx.mSockets = nullptr;
+    ctx.mCount   = 0;
+}
+
+// Returns false (and logs why) if this many sockets cannot be watched in this configuration.
+bool OpenSockets(BenchContext & ctx, size_t count)
+{
+    ctx.mSockets = static_cast<WatchedSocket *>(Platform::MemoryCalloc(count, sizeof(WatchedSocket)));
+    VerifyOrReturnValue(ctx.mSockets != nullptr, false);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        WatchedSocket & s = ctx.mSockets[i];
+        new (&s) WatchedSocket();
+        s.mToken = ctx.mLayer.InvalidSocketWatchToken();
+        s.mOwner = &ctx;
+        ctx.mCount++;
+
+        if (socketpair(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, s.mFds) != 0)
+        {
+            s.mFds[0] = s.mFds[1] = kInvalidFd;
+            printf("  %zu sockets: skipped, socketpair failed after %zu (errno %d)\n", count, i, errno);
+            return false;
+        }
+
+        CHIP_ERROR err = ctx.mLayer.StartWatchingSocket(s.mFds[0], &s.mToken);
+        if (err != CHIP_NO_ERROR)
+        {
+            s.mToken = ctx.mLayer.InvalidSocketWatchToken();
+            printf("  %zu sockets: skipped, backend accepted only %zu watches (%" CHIP_ERROR_FORMAT ")\n", count, i, err.Format());
+            return false;
+        }
+        ctx.mLayer.SetCallback(s.mToken, HandleReadable, reinterpret_cast<intptr_t>(&s));
+        ctx.mLayer.RequestCallbackOnPendingRead(s.mToken);
+    }
+    return true;
+}
+
+void ServiceEvents(LayerSocketsLoop & layer)
+{
+    layer.PrepareEvents();
+    layer.WaitForEvents();
+    layer.HandleEvents();
+}
+
+void CheckSocketEventScaling(nlTestSuite * inSuite, void * inContext)
+{
+    RaiseFileDescriptorLimit();
+
+    for (size_t count : kSocketCounts)
+    {
+        BenchContext * ctx = Platform::New<BenchContext>();
+        NL_TEST_ASSERT(inSuite, ctx != nullptr);
+        VerifyOrReturn(ctx != nullptr);
+        NL_TEST_ASSERT(inSuite, ctx->mLayer.Init() == CHIP_NO_ERROR);
+
+        if (OpenSockets(*ctx, count))
+        {
+            uint64_t latencyNs = 0;
+            uint64_t cpuStart  = NowNs(CLOCK_PROCESS_CPUTIME_ID);
+
+            for (size_t n = 0; n < kEventsPerRun; n++)
+            {
+                // Spread the ready socket over the whole table so that neither backend benefits from locality.
+                WatchedSocket & s    = ctx->mSockets[(n * 7919) % count];
+                const size_t before  = ctx->mTotalCallbacks;
+                const uint8_t byte   = 0;
+                const uint64_t start = NowNs(CLOCK_MONOTONIC);
+                NL_TEST_ASSERT(inSuite, write(s.mFds[1], &byte, sizeof(byte)) == 1);
+
+                ServiceEvents(ctx->mLayer);
+
+                NL_TEST_ASSERT(inSuite, ctx->mTotalCallbacks == before + 1);
+                latencyNs += ctx->mLastCallbackNs - start;
+            }
+
+            uint64_t cpuNs = NowNs(CLOCK_PROCESS_CPUTIME_ID) - cpuStart;
+            printf("  %zu sockets: wakeup latency %" PRIu64 " ns/event, cpu %" PRIu64 " ns/event\n", count,
+                   latencyNs / kEventsPerRun, cpuNs / kEventsPerRun);
+        }
+
+        CloseSockets(*ctx);
+        ctx->mLayer.Shutdown();
+        Platform::Delete(ctx);
+    }
+}
+
+// Only the epoll backend opens descriptors of its own in Init().
+#ifdef CHIP_SYSTEM_CONFIG_EPOLL_MAX_EVENTS
+void CheckInitRetry(nlTestSuite * inSuite, void * inContext)
+{
+    struct rlimit limit;
+    NL_TEST_ASSERT(inSuite, getrlimit(RLIMIT_NOFILE, &limit) == 0);
+
+    // Find the lowest free descriptor, then allow just one more, so that Init() runs out of descriptors part way.
+    int firstFreeFd = dup(STDIN_FILENO);
+    NL_TEST_ASSERT(inSuite, firstFreeFd >= 0);
+    VerifyOrReturn(firstFreeFd >= 0);
+    close(firstFreeFd);
+
+    struct rlimit reduced = limit;
+    reduced.rlim_cur      = static_cast<rlim_t>(firstFreeFd + 1);
+    NL_TEST_ASSERT(inSuite, setrlimit(RLIMIT_NOFILE, &reduced) == 0);
+
+    LayerImpl * layer = Platform::New<LayerImpl>();
+    NL_TEST_ASSERT(inSuite, layer != nullptr);
+    VerifyOrReturn(layer != nullptr);
+    NL_TEST_ASSERT(inSuite, layer->Init() != CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, setrlimit(RLIMIT_NOFILE, &limit) == 0);
+
+    // The failed Init() closed what it had opened, and left the layer ready to be initialized again.
+    int fd = dup(STDIN_FILENO);
+    NL_TEST_ASSERT(inSuite, fd == firstFreeFd);
+    close(fd);
+    NL_TEST_ASSERT(inSuite, layer->Init() == CHIP_NO_ERROR);
+    layer->Shutdown();
+    Platform::Delete(layer);
+}
+#endif // CHIP_SYSTEM_CONFIG_EPOLL_MAX_EVENTS
+
+} // namespace
+
+// clang-format off
+static const nlTest sTests[] =
+{
+    NL_TEST_DEF("SocketEvents::TestScaling", CheckSocketEventScaling),
+#ifdef CHIP_SYSTEM_CONFIG_EPOLL_MAX_EVENTS
+    NL_TEST_DEF("SocketEvents::TestInitRetry", CheckInitRetry),
+#endif // CHIP_SYSTEM_CONFIG_EPOLL_MAX_EVENTS
+    NL_TEST_SENTINEL()
+};
+// clang-format on
+
+static int TestSetup(void * aContext)
+{
+    return (Platform::MemoryInit() == CHIP_NO_ERROR) ? SUCCESS : FAILURE;
+}
+
+static int TestTeardown(void * aContext)
+{
+    Platform::MemoryShutdown();
+    return SUCCESS;
+}
+
+int TestSystemSocketEvents()
+{
+    // clang-format off
+    nlTestSuite theSuite =
+    {
+        "chip-system-socket-events",
+        &sTests[0],
+        TestSetup,
+        TestTeardown
+    };
+    // clang-format on
+
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestSystemSocketEvents)
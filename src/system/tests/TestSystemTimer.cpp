@@ -30,6 +30,7 @@
 #include <system/SystemConfig.h>
 
 #include <lib/core/ErrorStr.h>
+#include <lib/support/CHIPMem.h>
 #include <lib/support/CodeUtils.h>
 #include <lib/support/UnitTestContext.h>
 #include <lib/support/UnitTestRegistration.h>
@@ -44,7 +45,9 @@
 #endif // CHIP_SYSTEM_CONFIG_USE_LWIP
 
 #include <errno.h>
+#include <inttypes.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <string.h>
 
 using chip::ErrorStr;
@@ -439,6 +442,8 @@ class TestTimer
 {
 public:
     static void CheckTimerPool(nlTestSuite * inSuite, void * aContext);
+    static void CheckTimerQueue(nlTestSuite * inSuite, void * aContext);
+    static void CheckTimerQueueChurn(nlTestSuite * inSuite, void * aContext);
 };
 } // namespace System
 } // namespace chip
@@ -580,6 +585,211 @@ void chip::System::TestTimer::CheckTimerPool(nlTestSuite * inSuite, void * aCont
     NL_TEST_ASSERT(suite, SYSTEM_STATS_TEST_HIGH_WATER_MARK(Stats::kSystemLayer_NumTimers, 4));
 }
 
+void chip::System::TestTimer::CheckTimerQueue(nlTestSuite * inSuite, void * aContext)
+{
+    TestContext & testContext = *static_cast<TestContext *>(aContext);
+    Layer & systemLayer       = *testContext.mLayer;
+    nlTestSuite * const suite = testContext.mTestSuite;
+
+    using Timer = TimerList::Node;
+    struct TestState
+    {
+        static void Increment(Layer * layer, void * state) {}
+        static void Reset(Layer * layer, void * state) {}
+    };
+    TestState testState;
+
+    using namespace Clock::Literals;
+    struct
+    {
+        Clock::Timestamp awakenTime;
+        TimerCompleteCallback onComplete;
+        Timer * timer;
+    } testTimer[] = {
+        { 111_ms, TestState::Increment }, // 0
+        { 100_ms, TestState::Increment }, // 1
+        { 202_ms, TestState::Reset },     // 2
+        { 303_ms, TestState::Increment }, // 3
+        { 111_ms, TestState::Increment }, // 4
+    };
+
+    TimerPool<Timer> pool;
+    for (auto & timer : testTimer)
+    {
+        timer.timer = pool.Create(systemLayer, timer.awakenTime, timer.onComplete, &testState);
+        NL_TEST_ASSERT(suite, timer.timer != nullptr);
+    }
+
+    // Test TimerQueue operations, mirroring the TimerList ones.
+
+    TimerQueue queue;
+    NL_TEST_ASSERT(suite, queue.Remove(nullptr) == nullptr);
+    NL_TEST_ASSERT(suite, queue.Remove(nullptr, nullptr) == nullptr);
+    NL_TEST_ASSERT(suite, queue.PopEarliest() == nullptr);
+    NL_TEST_ASSERT(suite, queue.PopIfEarlier(500_ms) == nullptr);
+    NL_TEST_ASSERT(suite, queue.Earliest() == nullptr);
+    NL_TEST_ASSERT(suite, queue.Empty());
+
+    Timer * earliest = queue.Add(testTimer[0].timer); // queue: () → (0) returns: 0
+    NL_TEST_ASSERT(suite, earliest == testTimer[0].timer);
+    NL_TEST_ASSERT(suite, queue.PopIfEarlier(10_ms) == nullptr);
+    NL_TEST_ASSERT(suite, queue.Earliest() == testTimer[0].timer);
+    NL_TEST_ASSERT(suite, !queue.Empty());
+
+    earliest = queue.Add(testTimer[1].timer); // queue: (0) → (1 0) returns: 1
+    NL_TEST_ASSERT(suite, earliest == testTimer[1].timer);
+
+    earliest = queue.Add(testTimer[2].timer); // queue: (1 0) → (1 0 2) returns: 1
+    NL_TEST_ASSERT(suite, earliest == testTimer[1].timer);
+
+    earliest = queue.Add(testTimer[3].timer); // queue: (1 0 2) → (1 0 2 3) returns: 1
+    NL_TEST_ASSERT(suite, earliest == testTimer[1].timer);
+
+    // Removing a timer that is not in the queue has no effect.
+    earliest = queue.Remove(testTimer[4].timer);
+    NL_TEST_ASSERT(suite, earliest == testTimer[1].timer);
+
+    earliest = queue.Remove(earliest); // queue: (1 0 2 3) → (0 2 3) returns: 0
+    NL_TEST_ASSERT(suite, earliest == testTimer[0].timer);
+    NL_TEST_ASSERT(suite, queue.Earliest() == testTimer[0].timer);
+
+    earliest = queue.Remove(TestState::Reset, &testState); // queue: (0 2 3) → (0 3) returns: 2
+    NL_TEST_ASSERT(suite, earliest == testTimer[2].timer);
+    NL_TEST_ASSERT(suite, queue.Earliest() == testTimer[0].timer);
+    NL_TEST_ASSERT(suite, queue.Find(TestState::Reset, &testState) == nullptr);
+
+    // Lookup by callback and state finds the earliest of several matching timers.
+    NL_TEST_ASSERT(suite, queue.Find(TestState::Increment, &testState) == testTimer[0].timer);
+
+    earliest = queue.PopEarliest(); // queue: (0 3) → (3) returns: 0
+    NL_TEST_ASSERT(suite, earliest == testTimer[0].timer);
+    NL_TEST_ASSERT(suite, queue.Earliest() == testTimer[3].timer);
+
+    earliest = queue.PopIfEarlier(10_ms); // queue: (3) → (3) returns: nullptr
+    NL_TEST_ASSERT(suite, earliest == nullptr);
+
+    earliest = queue.PopIfEarlier(500_ms); // queue: (3) → () returns: 3
+    NL_TEST_ASSERT(suite, earliest == testTimer[3].timer);
+    NL_TEST_ASSERT(suite, queue.Empty());
+
+    earliest = queue.Add(testTimer[3].timer); // queue: () → (3) returns: 3
+    queue.Clear();                            // queue: (3) → ()
+    NL_TEST_ASSERT(suite, earliest == testTimer[3].timer);
+    NL_TEST_ASSERT(suite, queue.Empty());
+    NL_TEST_ASSERT(suite, queue.Find(TestState::Increment, &testState) == nullptr);
+
+    // Timers with equal awaken times expire in the order they were added.
+    for (auto & timer : testTimer)
+    {
+        queue.Add(timer.timer);
+    }
+    TimerList early = queue.ExtractEarlier(200_ms); // queue: (1 0 4 2 3) → (2 3) returns: (1 0 4)
+    NL_TEST_ASSERT(suite, queue.PopEarliest() == testTimer[2].timer);
+    NL_TEST_ASSERT(suite, queue.PopEarliest() == testTimer[3].timer);
+    NL_TEST_ASSERT(suite, queue.PopEarliest() == nullptr);
+    NL_TEST_ASSERT(suite, early.PopEarliest() == testTimer[1].timer);
+    NL_TEST_ASSERT(suite, early.PopEarliest() == testTimer[0].timer);
+    NL_TEST_ASSERT(suite, early.PopEarliest() == testTimer[4].timer);
+    NL_TEST_ASSERT(suite, early.PopEarliest() == nullptr);
+
+    pool.ReleaseAll();
+}
+
+namespace {
+
+/**
+ * Churn workload for the timer containers: fill with kChurnTimers timers, then repeatedly cancel a timer by
+ * (callback, appState) and restart it with a new deadline, as a busy layer does, and finally drain in order.
+ */
+constexpr size_t kChurnTimers     = 10000;
+constexpr size_t kChurnOperations = 10000;
+
+void ChurnCallback(Layer * layer, void * state) {}
+
+uint32_t ChurnRandom(uint32_t & seed)
+{
+    seed = seed * 1664525u + 1013904223u;
+    return seed >> 8;
+}
+
+template <typename Container>
+bool RunTimerChurn(Layer & systemLayer, Container & container, TimerList::Node ** timers, uint32_t * states,
+                   Clock::Microseconds64 & elapsed)
+{
+    using Timer   = TimerList::Node;
+    uint32_t seed = 1;
+
+    Clock::Microseconds64 start = SystemClock().GetMonotonicMicroseconds64();
+
+    for (size_t i = 0; i < kChurnTimers; i++)
+    {
+        Clock::Timestamp awakenTime(ChurnRandom(seed) % 100000);
+        timers[i] = chip::Platform::New<Timer>(systemLayer, awakenTime, ChurnCallback, &states[i]);
+        VerifyOrReturnValue(timers[i] != nullptr, false);
+        container.Add(timers[i]);
+    }
+
+    for (size_t n = 0; n < kChurnOperations; n++)
+    {
+        size_t i     = ChurnRandom(seed) % kChurnTimers;
+        Timer * prev = container.Remove(ChurnCallback, &states[i]);
+        VerifyOrReturnValue(prev == timers[i], false);
+        chip::Platform::Delete(prev);
+        Clock::Timestamp awakenTime(ChurnRandom(seed) % 100000);
+        timers[i] = chip::Platform::New<Timer>(systemLayer, awakenTime, ChurnCallback, &states[i]);
+        VerifyOrReturnValue(timers[i] != nullptr, false);
+        container.Add(timers[i]);
+    }
+
+    bool ordered          = true;
+    Clock::Timestamp last = Clock::kZero;
+    size_t count          = 0;
+    Timer * expired;
+    while ((expired = container.PopEarliest()) != nullptr)
+    {
+        ordered = ordered && !(expired->AwakenTime() < last);
+        last    = expired->AwakenTime();
+        chip::Platform::Delete(expired);
+        count++;
+    }
+
+    elapsed = SystemClock().GetMonotonicMicroseconds64() - start;
+    return ordered && count == kChurnTimers;
+}
+
+} // namespace
+
+void chip::System::TestTimer::CheckTimerQueueChurn(nlTestSuite * inSuite, void * aContext)
+{
+    // The workload needs thousands of heap-allocated timers.
+    if (!CHIP_SYSTEM_CONFIG_POOL_USE_HEAP)
+        return;
+
+    TestContext & testContext = *static_cast<TestContext *>(aContext);
+    Layer & systemLayer       = *testContext.mLayer;
+    nlTestSuite * const suite = testContext.mTestSuite;
+
+    auto ** timers = static_cast<TimerList::Node **>(chip::Platform::MemoryCalloc(kChurnTimers, sizeof(TimerList::Node *)));
+    auto * states  = static_cast<uint32_t *>(chip::Platform::MemoryCalloc(kChurnTimers, sizeof(uint32_t)));
+    auto * queue   = chip::Platform::New<TimerQueue>();
+    NL_TEST_ASSERT(suite, timers != nullptr && states != nullptr && queue != nullptr);
+    VerifyOrReturn(timers != nullptr && states != nullptr && queue != nullptr);
+
+    Clock::Microseconds64 listTime;
+    Clock::Microseconds64 queueTime;
+    TimerList list;
+    NL_TEST_ASSERT(suite, RunTimerChurn(systemLayer, list, timers, states, listTime));
+    NL_TEST_ASSERT(suite, RunTimerChurn(systemLayer, *queue, timers, states, queueTime));
+
+    printf("  %u timers, %u restarts: TimerList %" PRIu64 " us, TimerQueue %" PRIu64 " us\n", static_cast<unsigned>(kChurnTimers),
+           static_cast<unsigned>(kChurnOperations), static_cast<uint64_t>(listTime.count()),
+           static_cast<uint64_t>(queueTime.count()));
+
+    chip::Platform::Delete(queue);
+    chip::Platform::MemoryFree(states);
+    chip::Platform::MemoryFree(timers);
+}
+
 static void ExtendTimerToTest(nlTestSuite * inSuite, void * aContext)
 {
     if (!LayerEvents<LayerImpl>::HasServiceEvents())
@@ -723,6 +933,8 @@ static const nlTest sTests[] =
     NL_TEST_DEF("Timer::TestTimerOrder",           CheckOrder),
     NL_TEST_DEF("Timer::TestTimerCancellation",    CheckCancellation),
     NL_TEST_DEF("Timer::TestTimerPool",            chip::System::TestTimer::CheckTimerPool),
+    NL_TEST_DEF("Timer::TestTimerQueue",           chip::System::TestTimer::CheckTimerQueue),
+    NL_TEST_DEF("Timer::TestTimerQueueChurn",      chip::System::TestTimer::CheckTimerQueueChurn),
     NL_TEST_DEF("Timer::TestCancelTimer",          CancelTimerTest::Test),
     NL_TEST_DEF("Timer::ExtendTimerTo",            ExtendTimerToTest),
     NL_TEST_DEF("Timer::TestIsTimerActive",        IsTimerActiveTest),
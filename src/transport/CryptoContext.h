@@ -162,6 +162,9 @@ private:
     bool mKeyAvailable;
     Crypto::Aes128KeyHandle mEncryptionKey;
     Crypto::Aes128KeyHandle mDecryptionKey;
+    // Ciphers for the keys above, set up once per session rather than once per message
+    Crypto::Aes128CcmCipher mEncryptionCipher;
+    Crypto::Aes128CcmCipher mDecryptionCipher;
     Crypto::AttestationChallenge mAttestationChallenge;
     Crypto::SessionKeystore * mKeystore       = nullptr;
     Crypto::SymmetricKeyContext * mKeyContext = nullptr;
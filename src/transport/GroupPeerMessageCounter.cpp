@@ -21,6 +21,7 @@
  */
 
 #include <lib/support/DefaultStorageKeyAllocator.h>
+#include <lib/support/logging/CHIPLogging.h>
 #include <transport/GroupPeerMessageCounter.h>
 
 #include <crypto/RandUtils.h>
@@ -262,7 +263,7 @@ GroupOutgoingCounters::GroupOutgoingCounters(chip::PersistentStorageDelegate * s
     Init(storage_delegate);
 }
 
-CHIP_ERROR GroupOutgoingCounters::Init(chip::PersistentStorageDelegate * storage_delegate)
+CHIP_ERROR GroupOutgoingCounters::Init(chip::PersistentStorageDelegate * storage_delegate, System::Layer * systemLayer)
 {
 
     if (storage_delegate == nullptr)
@@ -270,8 +271,11 @@ CHIP_ERROR GroupOutgoingCounters::Init(chip::PersistentStorageDelegate * storage
         return CHIP_ERROR_INVALID_ARGUMENT;
     }
 
+    Shutdown();
+
     // Spec 4.5.1.3
     mStorage      = storage_delegate;
+    mSystemLayer  = systemLayer;
     uint16_t size = static_cast<uint16_t>(sizeof(uint32_t));
     uint32_t temp;
     CHIP_ERROR err;
@@ -305,13 +309,21 @@ CHIP_ERROR GroupOutgoingCounters::Init(chip::PersistentStorageDelegate * storage
         mGroupDataCounter = temp;
     }
 
-    temp = mGroupControlCounter + GROUP_MSG_COUNTER_MIN_INCREMENT;
-    size = static_cast<uint16_t>(sizeof(temp));
-    ReturnErrorOnFailure(mStorage->SyncSetKeyValue(DefaultStorageKeyAllocator::GroupControlCounter().KeyName(), &temp, size));
+    mGroupControlReservedUntil = mGroupControlCounter;
+    mGroupDataReservedUntil    = mGroupDataCounter;
 
-    temp = mGroupDataCounter + GROUP_MSG_COUNTER_MIN_INCREMENT;
+    ReturnErrorOnFailure(ReserveNextBlock(true));
+    return ReserveNextBlock(false);
+}
 
-    return mStorage->SyncSetKeyValue(DefaultStorageKeyAllocator::GroupDataCounter().KeyName(), &temp, size);
+void GroupOutgoingCounters::Shutdown()
+{
+    if (mReservationScheduled)
+    {
+        mSystemLayer->CancelTimer(ReserveAhead, this);
+        mReservationScheduled = false;
+    }
+    mSystemLayer = nullptr;
 }
 
 uint32_t GroupOutgoingCounters::GetCounter(bool isControl)
@@ -321,36 +333,73 @@ uint32_t GroupOutgoingCounters::GetCounter(bool isControl)
 
 CHIP_ERROR GroupOutgoingCounters::IncrementCounter(bool isControl)
 {
-    uint32_t temp  = 0;
-    uint16_t size  = static_cast<uint16_t>(sizeof(uint32_t));
-    uint32_t value = 0;
-
-    StorageKeyName key = StorageKeyName::Uninitialized();
+    uint32_t & counter        = isControl ? mGroupControlCounter : mGroupDataCounter;
+    const uint32_t & reserved = isControl ? mGroupControlReservedUntil : mGroupDataReservedUntil;
 
-    if (isControl)
+    if (mStorage == nullptr)
     {
-        mGroupControlCounter++;
-        key   = DefaultStorageKeyAllocator::GroupControlCounter();
-        value = mGroupControlCounter;
+        return CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND;
     }
-    else
+
+    // Both wrap around together, so the difference is what is left of the reserved block. The value being handed out must
+    // be below the persisted restart point: if it is not, it cannot go out until the next block is reserved, which is
+    // retried on every message until it succeeds.
+    if (static_cast<int32_t>(reserved - counter) <= 0)
     {
-        mGroupDataCounter++;
-        key   = DefaultStorageKeyAllocator::GroupDataCounter();
-        value = mGroupDataCounter;
+        ReturnErrorOnFailure(ReserveNextBlock(isControl));
     }
 
-    if (mStorage == nullptr)
+    counter++;
+
+    if (static_cast<int32_t>(reserved - counter) <= 0)
     {
-        return CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND;
+        // Reserve now rather than in the way of the next message; that retries it if this fails.
+        CHIP_ERROR err = ReserveNextBlock(isControl);
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(Inet, "Failed to reserve group message counters: %" CHIP_ERROR_FORMAT, err.Format());
+        }
     }
+    else if (static_cast<int32_t>(reserved - counter) <= GROUP_MSG_COUNTER_MIN_INCREMENT / 2 && mSystemLayer != nullptr &&
+             !mReservationScheduled)
+    {
+        // A timer rather than ScheduleWork(), so that Shutdown() can cancel it.
+        CHIP_ERROR err        = mSystemLayer->StartTimer(System::Clock::kZero, ReserveAhead, this);
+        mReservationScheduled = (err == CHIP_NO_ERROR);
+    }
+    return CHIP_NO_ERROR;
+}
 
-    ReturnErrorOnFailure(mStorage->SyncGetKeyValue(key.KeyName(), &temp, size));
-    if (temp == value)
+void GroupOutgoingCounters::ReserveAhead(System::Layer * systemLayer, void * appState)
+{
+    auto * counters                 = static_cast<GroupOutgoingCounters *>(appState);
+    counters->mReservationScheduled = false;
+
+    for (bool isControl : { true, false })
     {
-        temp = value + GROUP_MSG_COUNTER_MIN_INCREMENT;
-        return mStorage->SyncSetKeyValue(key.KeyName(), &temp, sizeof(uint32_t));
+        uint32_t counter  = isControl ? counters->mGroupControlCounter : counters->mGroupDataCounter;
+        uint32_t reserved = isControl ? counters->mGroupControlReservedUntil : counters->mGroupDataReservedUntil;
+        if (static_cast<int32_t>(reserved - counter) <= GROUP_MSG_COUNTER_MIN_INCREMENT / 2)
+        {
+            CHIP_ERROR err = counters->ReserveNextBlock(isControl);
+            if (err != CHIP_NO_ERROR)
+            {
+                // Retried once more of the block is used, and by IncrementCounter() before the block runs out.
+                ChipLogError(Inet, "Failed to reserve group message counters: %" CHIP_ERROR_FORMAT, err.Format());
+            }
+        }
     }
+}
+
+CHIP_ERROR GroupOutgoingCounters::ReserveNextBlock(bool isControl)
+{
+    StorageKeyName key =
+        isControl ? DefaultStorageKeyAllocator::GroupControlCounter() : DefaultStorageKeyAllocator::GroupDataCounter();
+    uint32_t & reserved = isControl ? mGroupControlReservedUntil : mGroupDataReservedUntil;
+
+    uint32_t next = reserved + GROUP_MSG_COUNTER_MIN_INCREMENT;
+    ReturnErrorOnFailure(mStorage->SyncSetKeyValue(key.KeyName(), &next, static_cast<uint16_t>(sizeof(next))));
+    reserved = next;
     return CHIP_NO_ERROR;
 }
 
@@ -29,6 +29,7 @@
 #include <lib/core/NodeId.h>
 #include <lib/core/PeerId.h>
 #include <lib/support/Span.h>
+#include <system/SystemLayer.h>
 #include <transport/PeerMessageCounter.h>
 
 #define GROUP_MSG_COUNTER_MIN_INCREMENT 1000
@@ -81,8 +82,29 @@ public:
 
     GroupOutgoingCounters(){};
     GroupOutgoingCounters(chip::PersistentStorageDelegate * storage_delegate);
-    CHIP_ERROR Init(chip::PersistentStorageDelegate * storage_delegate);
+
+    /**
+     * Load the counters and persist, for each of them, the value it restarts from after a reboot: the end of the block of
+     * GROUP_MSG_COUNTER_MIN_INCREMENT values reserved for the messages sent until then.
+     *
+     * With a system layer, the next block is reserved by deferred work once half of the current one has been used, so
+     * that IncrementCounter() does not wait for storage. Without one, or if that work has not run by the time the block
+     * is used up, IncrementCounter() reserves the next block itself.
+     */
+    CHIP_ERROR Init(chip::PersistentStorageDelegate * storage_delegate, System::Layer * systemLayer = nullptr);
+
+    /**
+     * Cancel any pending reservation. Counters never run past their persisted reservation, so the values sent so far
+     * are covered without it.
+     */
+    void Shutdown();
+
     uint32_t GetCounter(bool isControl);
+
+    /**
+     * Move past the value returned by GetCounter(), which may only be sent if this succeeds. It fails, leaving the counter
+     * as it is, when that value is the persisted restart point and the next block cannot be reserved.
+     */
     CHIP_ERROR IncrementCounter(bool isControl);
 
     // Protected for Unit Tests inheritance
@@ -90,7 +112,16 @@ protected:
     // TODO Initialize those to random value
     uint32_t mGroupDataCounter                 = 0;
     uint32_t mGroupControlCounter              = 0;
+    // Persisted restart points: counter values below them may have been sent
+    uint32_t mGroupDataReservedUntil           = 0;
+    uint32_t mGroupControlReservedUntil        = 0;
     chip::PersistentStorageDelegate * mStorage = nullptr;
+    System::Layer * mSystemLayer               = nullptr;
+    bool mReservationScheduled                 = false;
+
+private:
+    static void ReserveAhead(System::Layer * systemLayer, void * appState);
+    CHIP_ERROR ReserveNextBlock(bool isControl);
 };
 
 } // namespace Transport
@@ -40,12 +40,14 @@ void SecureSession::Activate(const ScopedNodeId & localNode, const ScopedNodeId
     VerifyOrDie(!((mSecureSessionType == Type::kCASE) &&
                   (!IsOperationalNodeId(peerNode.GetNodeId()) || !IsOperationalNodeId(localNode.GetNodeId()))));
 
+    mTable.RemoveFromPeerIndex(*this);
     mPeerNodeId      = peerNode.GetNodeId();
     mLocalNodeId     = localNode.GetNodeId();
     mPeerCATs        = peerCATs;
     mPeerSessionId   = peerSessionId;
     mRemoteMRPConfig = config;
     SetFabricIndex(peerNode.GetFabricIndex());
+    mTable.AddToPeerIndex(*this);
     MarkActiveRx(); // Initialize SessionTimestamp and ActiveTimestamp per spec.
 
     Retain(); // This ref is released inside MarkForEviction
@@ -57,6 +59,19 @@ void SecureSession::Activate(const ScopedNodeId & localNode, const ScopedNodeId
     ChipLogDetail(Inet, "SecureSession[%p]: Activated - Type:%d LSID:%d", this, to_underlying(mSecureSessionType), mLocalSessionId);
 }
 
+CHIP_ERROR SecureSession::AdoptFabricIndex(FabricIndex fabricIndex)
+{
+    // It's not legal to augment session type for non-PASE
+    if (mSecureSessionType != Type::kPASE)
+    {
+        return CHIP_ERROR_INVALID_ARGUMENT;
+    }
+    mTable.RemoveFromPeerIndex(*this);
+    SetFabricIndex(fabricIndex);
+    mTable.AddToPeerIndex(*this);
+    return CHIP_NO_ERROR;
+}
+
 const char * SecureSession::StateToString(State state) const
 {
     switch (state)
@@ -195,16 +195,7 @@ public:
 
     // Called when AddNOC has gone through sufficient success that we need to switch the
     // session to reflect a new fabric if it was a PASE session
-    CHIP_ERROR AdoptFabricIndex(FabricIndex fabricIndex)
-    {
-        // It's not legal to augment session type for non-PASE
-        if (mSecureSessionType != Type::kPASE)
-        {
-            return CHIP_ERROR_INVALID_ARGUMENT;
-        }
-        SetFabricIndex(fabricIndex);
-        return CHIP_NO_ERROR;
-    }
+    CHIP_ERROR AdoptFabricIndex(FabricIndex fabricIndex);
 
     System::Clock::Timestamp GetLastActivityTime() const { return mLastActivityTime; }
     System::Clock::Timestamp GetLastPeerActivityTime() const { return mLastPeerActivityTime; }
@@ -293,9 +284,13 @@ private:
     void MoveToState(State targetState);
 
     friend class SecureSessionDeleter;
+    friend class SecureSessionTable;
     friend class TestSecureSessionTable;
 
     SecureSessionTable & mTable;
+    // Links to the other sessions in the same bucket of the table's peer index.
+    SecureSession * mPeerIndexNext = nullptr;
+    SecureSession * mPeerIndexPrev = nullptr;
     State mState;
     const Type mSecureSessionType;
     NodeId mLocalNodeId = kUndefinedNodeId;
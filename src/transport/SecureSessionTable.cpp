@@ -25,6 +25,13 @@
 namespace chip {
 namespace Transport {
 
+SecureSessionTable::SecureSessionTable()
+{
+#if CHIP_CONFIG_SECURE_SESSION_ID_BITMAP
+    SetSessionIdInUse(kUnsecuredSessionId, true); // kUnsecuredSessionId is never available
+#endif
+}
+
 Optional<SessionHandle> SecureSessionTable::CreateNewSecureSessionForTest(SecureSession::Type secureSessionType,
                                                                           uint16_t localSessionId, NodeId localNodeId,
                                                                           NodeId peerNodeId, CATValues peerCATs,
@@ -54,7 +61,15 @@ Optional<SessionHandle> SecureSessionTable::CreateNewSecureSessionForTest(Secure
 
     SecureSession * result = mEntries.CreateObject(*this, secureSessionType, localSessionId, localNodeId, peerNodeId, peerCATs,
                                                    peerSessionId, fabricIndex, config);
-    return result != nullptr ? MakeOptional<SessionHandle>(*result) : Optional<SessionHandle>::Missing();
+    VerifyOrReturnValue(result != nullptr, Optional<SessionHandle>::Missing());
+
+    if (!AddToIndexes(*result))
+    {
+        mEntries.ReleaseObject(result);
+        return Optional<SessionHandle>::Missing();
+    }
+
+    return MakeOptional<SessionHandle>(*result);
 }
 
 Optional<SessionHandle> SecureSessionTable::CreateNewSecureSession(SecureSession::Type secureSessionType,
@@ -82,6 +97,12 @@ Optional<SessionHandle> SecureSessionTable::CreateNewSecureSession(SecureSession
 
     VerifyOrReturnValue(allocated != nullptr, Optional<SessionHandle>::Missing());
 
+    if (!AddToIndexes(*allocated))
+    {
+        mEntries.ReleaseObject(allocated);
+        return Optional<SessionHandle>::Missing();
+    }
+
     rv             = MakeOptional<SessionHandle>(*allocated);
     mNextSessionId = sessionId.Value() == kMaxSessionID ? static_cast<uint16_t>(kUnsecuredSessionId + 1)
                                                         : static_cast<uint16_t>(sessionId.Value() + 1);
@@ -312,68 +333,188 @@ void SecureSessionTable::DefaultEvictionPolicy(EvictionPolicyContext & evictionC
 
 Optional<SessionHandle> SecureSessionTable::FindSecureSessionByLocalKey(uint16_t localSessionId)
 {
-    SecureSession * result = nullptr;
-    mEntries.ForEachActiveObject([&](auto session) {
-        if (session->GetLocalSessionId() == localSessionId)
+    SecureSession * result = FindByLocalSessionId(localSessionId);
+    return result != nullptr ? MakeOptional<SessionHandle>(*result) : Optional<SessionHandle>::Missing();
+}
+
+void SecureSessionTable::ReleaseSession(SecureSession * session)
+{
+    RemoveFromIndexes(*session);
+    mEntries.ReleaseObject(session);
+}
+
+SecureSession * SecureSessionTable::FindByLocalSessionId(uint16_t localSessionId) const
+{
+    for (size_t slot = LocalSessionIdSlotOf(localSessionId); mLocalSessionIdIndex[slot] != nullptr;
+         slot = (slot + 1) & (kLocalSessionIdIndexSize - 1))
+    {
+        if (mLocalSessionIdIndex[slot]->GetLocalSessionId() == localSessionId)
         {
-            result = session;
-            return Loop::Break;
+            return mLocalSessionIdIndex[slot];
         }
-        return Loop::Continue;
-    });
-    return result != nullptr ? MakeOptional<SessionHandle>(*result) : Optional<SessionHandle>::Missing();
+    }
+    return nullptr;
+}
+
+bool SecureSessionTable::AddToIndexes(SecureSession & session)
+{
+    // Always leave a free slot, so that probe sequences end.
+    VerifyOrReturnValue(mLocalSessionIdIndexCount + 1 < kLocalSessionIdIndexSize, false);
+
+    size_t slot = LocalSessionIdSlotOf(session.GetLocalSessionId());
+    while (mLocalSessionIdIndex[slot] != nullptr)
+    {
+        slot = (slot + 1) & (kLocalSessionIdIndexSize - 1);
+    }
+    mLocalSessionIdIndex[slot] = &session;
+    mLocalSessionIdIndexCount++;
+
+#if CHIP_CONFIG_SECURE_SESSION_ID_BITMAP
+    SetSessionIdInUse(session.GetLocalSessionId(), true);
+#endif
+
+    AddToPeerIndex(session);
+    return true;
 }
 
+void SecureSessionTable::RemoveFromIndexes(SecureSession & session)
+{
+    RemoveFromPeerIndex(session);
+
+    constexpr size_t kMask = kLocalSessionIdIndexSize - 1;
+
+    size_t hole = LocalSessionIdSlotOf(session.GetLocalSessionId());
+    while (mLocalSessionIdIndex[hole] != &session)
+    {
+        VerifyOrDie(mLocalSessionIdIndex[hole] != nullptr);
+        hole = (hole + 1) & kMask;
+    }
+
+    // Shift back the entries that follow in the probe sequence, so that none of them is cut off from its home slot.
+    for (size_t slot = (hole + 1) & kMask; mLocalSessionIdIndex[slot] != nullptr; slot = (slot + 1) & kMask)
+    {
+        size_t home = LocalSessionIdSlotOf(mLocalSessionIdIndex[slot]->GetLocalSessionId());
+        if (((slot - home) & kMask) >= ((slot - hole) & kMask))
+        {
+            mLocalSessionIdIndex[hole] = mLocalSessionIdIndex[slot];
+            hole                       = slot;
+        }
+    }
+    mLocalSessionIdIndex[hole] = nullptr;
+    mLocalSessionIdIndexCount--;
+
+#if CHIP_CONFIG_SECURE_SESSION_ID_BITMAP
+    // Sessions injected for tests may share a session ID.
+    if (FindByLocalSessionId(session.GetLocalSessionId()) == nullptr)
+    {
+        SetSessionIdInUse(session.GetLocalSessionId(), false);
+    }
+#endif
+}
+
+void SecureSessionTable::AddToPeerIndex(SecureSession & session)
+{
+    SecureSession *& head  = mPeerIndex[PeerBucketOf(session.GetPeer())];
+    session.mPeerIndexPrev = nullptr;
+    session.mPeerIndexNext = head;
+    if (head != nullptr)
+    {
+        head->mPeerIndexPrev = &session;
+    }
+    head = &session;
+}
+
+void SecureSessionTable::RemoveFromPeerIndex(SecureSession & session)
+{
+    if (session.mPeerIndexPrev != nullptr)
+    {
+        session.mPeerIndexPrev->mPeerIndexNext = session.mPeerIndexNext;
+    }
+    else
+    {
+        mPeerIndex[PeerBucketOf(session.GetPeer())] = session.mPeerIndexNext;
+    }
+    if (session.mPeerIndexNext != nullptr)
+    {
+        session.mPeerIndexNext->mPeerIndexPrev = session.mPeerIndexPrev;
+    }
+    session.mPeerIndexPrev = nullptr;
+    session.mPeerIndexNext = nullptr;
+}
+
+#if CHIP_CONFIG_SECURE_SESSION_ID_BITMAP
+void SecureSessionTable::SetSessionIdInUse(uint16_t localSessionId, bool inUse)
+{
+    const size_t word      = localSessionId / 64;
+    const uint64_t bit     = 1ULL << (localSessionId % 64);
+    mSessionIdsInUse[word] = inUse ? (mSessionIdsInUse[word] | bit) : (mSessionIdsInUse[word] & ~bit);
+
+    const uint64_t wordBit = 1ULL << (word % 64);
+    if (mSessionIdsInUse[word] == UINT64_MAX)
+    {
+        mFullSessionIdWords[word / 64] |= wordBit;
+    }
+    else
+    {
+        mFullSessionIdWords[word / 64] &= ~wordBit;
+    }
+}
+#endif
+
 Optional<uint16_t> SecureSessionTable::FindUnusedSessionId()
 {
-    uint16_t candidate_base = 0;
-    uint64_t candidate_mask = 0;
-    for (uint32_t i = 0; i <= kMaxSessionID; i += 64)
+#if CHIP_CONFIG_SECURE_SESSION_ID_BITMAP
+    constexpr size_t kGroups = kSessionIdWords / 64;
+
+    // Look for a free ID after the clue in its own word first, then for the next word that is not full, 64 words at a time.
+    // The last group looked at is the clue's own again, so that the IDs just below the clue are found too.
+    const size_t clueWord = mNextSessionId / 64;
+    size_t word           = clueWord;
+    uint64_t available    = ~mSessionIdsInUse[clueWord] & (UINT64_MAX << (mNextSessionId % 64));
+    for (size_t i = 0; available == 0 && i <= kGroups; i++)
     {
-        // candidate_base is the base session ID we are searching from.
-        // We have a 64-bit mask anchored at this ID and iterate over the
-        // whole session table, setting bits in the mask for in-use IDs.
-        // If we can iterate through the entire session table and have
-        // any bits clear in the mask, we have available session IDs.
-        candidate_base = static_cast<uint16_t>(i + mNextSessionId);
-        candidate_mask = 0;
+        const size_t group = (clueWord / 64 + i) % kGroups;
+        uint64_t notFull   = ~mFullSessionIdWords[group];
+        if (i == 0)
         {
-            uint16_t shift = static_cast<uint16_t>(kUnsecuredSessionId - candidate_base);
-            if (shift <= 63)
-            {
-                candidate_mask |= (1ULL << shift); // kUnsecuredSessionId is never available
-            }
+            notFull &= (clueWord % 64 == 63) ? 0 : (UINT64_MAX << (clueWord % 64 + 1));
         }
-        mEntries.ForEachActiveObject([&](auto session) {
-            uint16_t shift = static_cast<uint16_t>(session->GetLocalSessionId() - candidate_base);
-            if (shift <= 63)
-            {
-                candidate_mask |= (1ULL << shift);
-            }
-            if (candidate_mask == UINT64_MAX)
-            {
-                return Loop::Break; // No bits clear means this bucket is full.
-            }
-            return Loop::Continue;
-        });
-        if (candidate_mask != UINT64_MAX)
+        if (notFull == 0)
         {
-            break; // Any bit clear means we have an available ID in this bucket.
+            continue;
         }
+
+        word = group * 64;
+        while ((notFull & 1) == 0)
+        {
+            notFull >>= 1;
+            ++word;
+        }
+        available = ~mSessionIdsInUse[word];
     }
-    if (candidate_mask != UINT64_MAX)
+    VerifyOrReturnValue(available != 0, NullOptional);
+
+    uint16_t offset = 0;
+    while ((available & 1) == 0)
     {
-        uint16_t offset = 0;
-        while (candidate_mask & 1)
+        available >>= 1;
+        ++offset;
+    }
+    return MakeOptional(static_cast<uint16_t>(word * 64 + offset));
+#else
+    // There are far fewer sessions than session IDs: unless the IDs around the clue are still in use, the first candidate is
+    // free.
+    uint16_t candidate = mNextSessionId;
+    for (uint32_t i = 0; i <= kMaxSessionID; i++, candidate++)
+    {
+        if (candidate != kUnsecuredSessionId && FindByLocalSessionId(candidate) == nullptr)
         {
-            candidate_mask >>= 1;
-            ++offset;
+            return MakeOptional(candidate);
         }
-        uint16_t available = static_cast<uint16_t>(candidate_base + offset);
-        return MakeOptional<uint16_t>(available);
     }
 
     return NullOptional;
+#endif
 }
 
 } // namespace Transport
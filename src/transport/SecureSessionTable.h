@@ -18,6 +18,7 @@
 
 #include <lib/core/CHIPError.h>
 #include <lib/support/CodeUtils.h>
+#include <lib/support/IdHash.h>
 #include <lib/support/Pool.h>
 #include <lib/support/SortUtils.h>
 #include <system/TimeSource.h>
@@ -29,6 +30,17 @@ namespace Transport {
 inline constexpr uint16_t kMaxSessionID       = UINT16_MAX;
 inline constexpr uint16_t kUnsecuredSessionId = 0;
 
+// Smallest power of two that is at least count, for sizing the session table indexes.
+constexpr size_t SessionIndexSizeFor(size_t count)
+{
+    size_t size = 1;
+    while (size < count)
+    {
+        size <<= 1;
+    }
+    return size;
+}
+
 /**
  * Handles a set of sessions.
  *
@@ -39,6 +51,7 @@ inline constexpr uint16_t kUnsecuredSessionId = 0;
 class SecureSessionTable
 {
 public:
+    SecureSessionTable();
     ~SecureSessionTable() { mEntries.ReleaseAll(); }
 
     void Init() { mNextSessionId = chip::Crypto::GetRandU16(); }
@@ -76,7 +89,7 @@ public:
     CHECK_RETURN_VALUE
     Optional<SessionHandle> CreateNewSecureSession(SecureSession::Type secureSessionType, ScopedNodeId sessionEvictionHint);
 
-    void ReleaseSession(SecureSession * session) { mEntries.ReleaseObject(session); }
+    void ReleaseSession(SecureSession * session);
 
     template <typename Function>
     Loop ForEachSession(Function && function)
@@ -84,6 +97,35 @@ public:
         return mEntries.ForEachActiveObject(std::forward<Function>(function));
     }
 
+    /**
+     * Call the provided function on each session whose peer is the given ScopedNodeId, without visiting the other sessions.
+     *
+     * The function may release any session, including the one it is called on.  Sessions created while iterating may or may
+     * not be visited.
+     */
+    template <typename Function>
+    Loop ForEachSessionWithPeer(const ScopedNodeId & peer, Function && function)
+    {
+        SecureSession * session = mPeerIndex[PeerBucketOf(peer)];
+        while (session != nullptr)
+        {
+            if (session->GetPeer() != peer)
+            {
+                session = session->mPeerIndexNext;
+                continue;
+            }
+
+            // Keep the session in the table, and so in its chain, until we know where the chain goes next.
+            SessionHandle ref(*session);
+            if (function(session) == Loop::Break)
+            {
+                return Loop::Break;
+            }
+            session = session->mPeerIndexNext;
+        }
+        return Loop::Finish;
+    }
+
     /**
      * Get a secure session given its session ID.
      *
@@ -100,7 +142,7 @@ public:
     void NewerSessionAvailable(SecureSession * session)
     {
         VerifyOrDie(session->GetSecureSessionType() == SecureSession::Type::kCASE);
-        mEntries.ForEachActiveObject([&](SecureSession * oldSession) {
+        ForEachSessionWithPeer(session->GetPeer(), [&](SecureSession * oldSession) {
             if (session == oldSession)
                 return Loop::Continue;
 
@@ -110,7 +152,7 @@ public:
             //
             // See documentation for SessionDelegate::GetNewSessionHandlingPolicy about how session auto-shifting works, and how
             // to disable it for a specific SessionHolder in a specific scenario.
-            if (oldSession->GetSecureSessionType() == SecureSession::Type::kCASE && oldSession->GetPeer() == session->GetPeer() &&
+            if (oldSession->GetSecureSessionType() == SecureSession::Type::kCASE &&
                 oldSession->GetPeerCATs() == session->GetPeerCATs())
             {
                 oldSession->NewerSessionAvailable(SessionHandle(*session));
@@ -121,8 +163,43 @@ public:
     }
 
 private:
+    friend class SecureSession;
     friend class TestSecureSessionTable;
 
+    // The local session ID index is open-addressed and kept at most half full when the table is at its maximum size.  The
+    // peer index chains the sessions of a bucket through the sessions themselves.
+    static constexpr size_t kLocalSessionIdIndexSize = SessionIndexSizeFor(2 * CHIP_CONFIG_SECURE_SESSION_POOL_SIZE);
+    static constexpr size_t kPeerIndexSize           = SessionIndexSizeFor(CHIP_CONFIG_SECURE_SESSION_POOL_SIZE);
+
+    static size_t LocalSessionIdSlotOf(uint16_t localSessionId)
+    {
+        // Session IDs are handed out sequentially, so they spread over the slots without being hashed.
+        return localSessionId & (kLocalSessionIdIndexSize - 1);
+    }
+
+    static size_t PeerBucketOf(const ScopedNodeId & peer)
+    {
+        uint64_t nodeId = peer.GetNodeId();
+        return BucketOfIdPair<kPeerIndexSize>(static_cast<uint32_t>(nodeId ^ (nodeId >> 32)), peer.GetFabricIndex());
+    }
+
+    /**
+     * Add a session that was just created out of mEntries to the indexes.  Returns false, leaving the indexes unchanged, if the
+     * local session ID index has no room for it.
+     */
+    bool AddToIndexes(SecureSession & session);
+    void RemoveFromIndexes(SecureSession & session);
+
+    // Called by SecureSession around any change of its peer node ID or fabric index.
+    void AddToPeerIndex(SecureSession & session);
+    void RemoveFromPeerIndex(SecureSession & session);
+
+    SecureSession * FindByLocalSessionId(uint16_t localSessionId) const;
+
+#if CHIP_CONFIG_SECURE_SESSION_ID_BITMAP
+    void SetSessionIdInUse(uint16_t localSessionId, bool inUse);
+#endif
+
     /**
      * This provides a sortable wrapper for a SecureSession object. A SecureSession
      * isn't directly sortable since it is not swappable (i.e meet criteria for ValueSwappable).
@@ -241,15 +318,11 @@ private:
                                      const ScopedNodeId & sessionEvictionHint);
 
     /**
-     * Find an available session ID that is unused in the secure session table.
-     *
-     * The search algorithm iterates over the session ID space in the outer loop
-     * and the session table in the inner loop to locate an available session ID
-     * from the starting mNextSessionId clue.
+     * Find an available session ID that is unused in the secure session table, starting from the mNextSessionId clue.
      *
-     * The outer-loop considers 64 session IDs in each iteration to give a
-     * runtime complexity of O(CHIP_CONFIG_PEER_CONNECTION_POOL_SIZE^2/64).  Speed up could be
-     * achieved with a sorted session table or additional storage.
+     * With CHIP_CONFIG_SECURE_SESSION_ID_BITMAP, this looks up the bitmap of session IDs in use, skipping 4096 IDs at a time
+     * over full stretches of the ID space.  Otherwise it looks up each candidate in the local session ID index until one is
+     * free, which takes a single lookup unless IDs around the clue are still in use.
      *
      * @return an unused session ID if any is found, else NullOptional
      */
@@ -274,6 +347,18 @@ private:
 #endif
 
     uint16_t mNextSessionId = 0;
+
+    SecureSession * mLocalSessionIdIndex[kLocalSessionIdIndexSize] = {};
+    size_t mLocalSessionIdIndexCount                               = 0;
+    SecureSession * mPeerIndex[kPeerIndexSize]                     = {};
+
+#if CHIP_CONFIG_SECURE_SESSION_ID_BITMAP
+    static constexpr size_t kSessionIdWords = (static_cast<size_t>(kMaxSessionID) + 1) / 64;
+
+    // One bit per session ID in use, and one bit per word of mSessionIdsInUse that has no ID left.
+    uint64_t mSessionIdsInUse[kSessionIdWords]         = {};
+    uint64_t mFullSessionIdWords[kSessionIdWords / 64] = {};
+#endif
 };
 
 } // namespace Transport
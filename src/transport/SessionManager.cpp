@@ -57,6 +57,37 @@ using Transport::SecureSession;
 
 namespace {
 Global<GroupPeerTable> gGroupPeerTable;
+
+#if CHIP_SYSTEM_CONFIG_MULTICAST_HOMING
+/// Number of interfaces whose copies of a group message are handed to the transport together.
+constexpr size_t kMulticastHomingBatchSize = INET_CONFIG_UDP_SOCKET_MMSG_BATCH_SIZE;
+
+/**
+ * Send one copy of a group message per interface. A failure on one interface does not keep the copies for the
+ * interfaces after it from being sent.
+ */
+void SendMulticastHomingCopies(TransportMgrBase * transportMgr, const PeerAddress * destinations, PacketBufferHandle * msgBufs,
+                               const char (*names)[Inet::InterfaceId::kMaxIfNameLength], size_t count)
+{
+    size_t offset = 0;
+    while (offset < count)
+    {
+        size_t sentCount = 0;
+        CHIP_ERROR err   = transportMgr->SendMessages(&destinations[offset], &msgBufs[offset], count - offset, sentCount);
+        for (size_t i = offset; i < offset + sentCount; i++)
+        {
+            ChipLogDetail(Inet, "Successfully send Multicast message on interface %s", names[i]);
+        }
+        offset += sentCount;
+        if (err == CHIP_NO_ERROR)
+        {
+            break;
+        }
+        ChipLogError(Inet, "Failed to send Multicast message on interface %s", names[offset]);
+        offset++;
+    }
+}
+#endif // CHIP_SYSTEM_CONFIG_MULTICAST_HOMING
 } // namespace
 
 uint32_t EncryptedPacketBufferHandle::GetMessageCounter() const
@@ -104,7 +135,7 @@ CHIP_ERROR SessionManager::Init(System::Layer * systemLayer, TransportMgrBase *
 
     mGlobalUnencryptedMessageCounter.Init();
 
-    ReturnErrorOnFailure(mGroupClientCounter.Init(storageDelegate));
+    ReturnErrorOnFailure(mGroupClientCounter.Init(storageDelegate, systemLayer));
 
     mTransportMgr->SetSessionManager(this);
 
@@ -129,6 +160,8 @@ void SessionManager::Shutdown()
 
     mMessageCounterManager = nullptr;
 
+    mGroupClientCounter.Shutdown();
+
     mSystemLayer  = nullptr;
     mTransportMgr = nullptr;
     mCB           = nullptr;
@@ -176,7 +209,7 @@ CHIP_ERROR SessionManager::PrepareMessage(const SessionHandle & sessionHandle, P
 
         packetHeader.SetDestinationGroupId(groupSession->GetGroupId());
         packetHeader.SetMessageCounter(mGroupClientCounter.GetCounter(isControlMsg));
-        mGroupClientCounter.IncrementCounter(isControlMsg);
+        ReturnErrorOnFailure(mGroupClientCounter.IncrementCounter(isControlMsg));
         packetHeader.SetSessionType(Header::SessionType::kGroupSession);
         NodeId sourceNodeId = fabric->GetNodeId();
         packetHeader.SetSourceNodeId(sourceNodeId);
@@ -385,9 +418,14 @@ CHIP_ERROR SessionManager::SendPreparedMessage(const SessionHandle & sessionHand
         chip::Inet::IPAddress addr;
         bool interfaceFound = false;
 
+        PeerAddress destinations[kMulticastHomingBatchSize];
+        PacketBufferHandle copies[kMulticastHomingBatchSize];
+        char names[kMulticastHomingBatchSize][chip::Inet::InterfaceId::kMaxIfNameLength];
+        size_t count = 0;
+
         while (interfaceIt.Next())
         {
-            char name[chip::Inet::InterfaceId::kMaxIfNameLength];
+            char * name = names[count];
             interfaceIt.GetInterfaceName(name, chip::Inet::InterfaceId::kMaxIfNameLength);
             if (interfaceIt.SupportsMulticast() && interfaceIt.IsUp())
             {
@@ -401,22 +439,26 @@ CHIP_ERROR SessionManager::SendPreparedMessage(const SessionHandle & sessionHand
                     VerifyOrReturnError(!tempBuf.IsNull(), CHIP_ERROR_INVALID_ARGUMENT);
                     VerifyOrReturnError(!tempBuf->HasChainedBuffer(), CHIP_ERROR_INVALID_MESSAGE_LENGTH);
 
-                    destination = &(multicastAddress.SetInterface(interfaceId));
                     if (mTransportMgr != nullptr)
                     {
-                        if (CHIP_NO_ERROR != mTransportMgr->SendMessage(*destination, std::move(tempBuf)))
-                        {
-                            ChipLogError(Inet, "Failed to send Multicast message on interface %s", name);
-                        }
-                        else
+                        destinations[count] = multicastAddress;
+                        destinations[count].SetInterface(interfaceId);
+                        copies[count] = std::move(tempBuf);
+                        if (++count == kMulticastHomingBatchSize)
                         {
-                            ChipLogDetail(Inet, "Successfully send Multicast message on interface %s", name);
+                            SendMulticastHomingCopies(mTransportMgr, destinations, copies, names, count);
+                            count = 0;
                         }
                     }
                 }
             }
         }
 
+        if (count > 0)
+        {
+            SendMulticastHomingCopies(mTransportMgr, destinations, copies, names, count);
+        }
+
         if (!interfaceFound)
         {
             ChipLogError(Inet, "No valid Interface found.. Sending to the default one.. ");
@@ -482,9 +524,8 @@ void SessionManager::ExpireAllPASESessions()
 
 void SessionManager::MarkSessionsAsDefunct(const ScopedNodeId & node, const Optional<Transport::SecureSession::Type> & type)
 {
-    mSecureSessions.ForEachSession([&node, &type](auto session) {
-        if (session->IsActiveSession() && session->GetPeer() == node &&
-            (!type.HasValue() || type.Value() == session->GetSecureSessionType()))
+    mSecureSessions.ForEachSessionWithPeer(node, [&type](auto session) {
+        if (session->IsActiveSession() && (!type.HasValue() || type.Value() == session->GetSecureSessionType()))
         {
             session->MarkAsDefunct();
         }
@@ -494,10 +535,10 @@ void SessionManager::MarkSessionsAsDefunct(const ScopedNodeId & node, const Opti
 
 void SessionManager::UpdateAllSessionsPeerAddress(const ScopedNodeId & node, const Transport::PeerAddress & addr)
 {
-    mSecureSessions.ForEachSession([&node, &addr](auto session) {
+    mSecureSessions.ForEachSessionWithPeer(node, [&addr](auto session) {
         // Arguably we should only be updating active and defunct sessions, but there is no harm
         // in updating evicted sessions.
-        if (session->GetPeer() == node && Transport::SecureSession::Type::kCASE == session->GetSecureSessionType())
+        if (Transport::SecureSession::Type::kCASE == session->GetSecureSessionType())
         {
             session->SetPeerAddress(addr);
         }
@@ -886,10 +927,27 @@ void SessionManager::SecureGroupMessageDispatch(const PacketHeader & partialPack
     ReturnOnFailure(mac.Decode(partialPacketHeader, &data[len - footerLen], footerLen, &taglen));
     VerifyOrReturn(taglen == footerLen);
 
+    // Without privacy, the destination group is readable before decryption: skip the keys of other groups without copying
+    // the message.
+    Optional<GroupId> destinationGroupId;
+    if (!partialPacketHeader.HasPrivacyFlag())
+    {
+        PacketHeader clearHeader;
+        uint16_t headerSize = 0;
+        if (clearHeader.Decode(msg->Start(), msg->DataLength(), &headerSize) == CHIP_NO_ERROR)
+        {
+            destinationGroupId = clearHeader.GetDestinationGroupId();
+        }
+    }
+
     bool decrypted = false;
     while (!decrypted && iter->Next(groupContext))
     {
-        CryptoContext context(groupContext.keyContext);
+        if (destinationGroupId.HasValue() && destinationGroupId.Value() != groupContext.group_id)
+        {
+            continue;
+        }
+
         msgCopy = msg.CloneData();
         if (msgCopy.IsNull())
         {
@@ -1010,9 +1068,8 @@ Optional<SessionHandle> SessionManager::FindSecureSessionForNode(ScopedNodeId pe
 {
     SecureSession * found = nullptr;
 
-    mSecureSessions.ForEachSession([&peerNodeId, &type, &found](auto session) {
-        if (session->IsActiveSession() && session->GetPeer() == peerNodeId &&
-            (!type.HasValue() || type.Value() == session->GetSecureSessionType()))
+    mSecureSessions.ForEachSessionWithPeer(peerNodeId, [&type, &found](auto session) {
+        if (session->IsActiveSession() && (!type.HasValue() || type.Value() == session->GetSecureSessionType()))
         {
             //
             // Select the active session with the most recent activity to return back to the caller.
@@ -37,6 +37,9 @@ public:
 
     CHIP_ERROR SendMessage(const Transport::PeerAddress & address, System::PacketBufferHandle && msgBuf);
 
+    CHIP_ERROR SendMessages(const Transport::PeerAddress * addresses, System::PacketBufferHandle * msgBufs, size_t count,
+                            size_t & sentCount);
+
     void Close();
 
     void Disconnect(const Transport::PeerAddress & address);
@@ -26,6 +26,7 @@
 #include <inet/IPAddress.h>
 #include <inet/UDPEndPoint.h>
 #include <lib/core/CHIPError.h>
+#include <lib/support/CodeUtils.h>
 #include <system/SystemPacketBuffer.h>
 #include <transport/raw/MessageHeader.h>
 #include <transport/raw/PeerAddress.h>
@@ -65,6 +66,26 @@ public:
      */
     virtual CHIP_ERROR SendMessage(const PeerAddress & address, System::PacketBufferHandle && msgBuf) = 0;
 
+    /**
+     * @brief Send several messages, each to its own target, stopping at the first failure.
+     *
+     * The buffers of the messages sent, and of the one that failed, are released. Those after it are left untouched.
+     * Transports that can hand the messages to the network stack together override this.
+     *
+     * @param[out] sentCount  Number of messages sent.
+     */
+    virtual CHIP_ERROR SendMessages(const PeerAddress * addresses, System::PacketBufferHandle * msgBufs, size_t count,
+                                    size_t & sentCount)
+    {
+        for (sentCount = 0; sentCount < count; sentCount++)
+        {
+            CHIP_ERROR err     = SendMessage(addresses[sentCount], std::move(msgBufs[sentCount]));
+            msgBufs[sentCount] = nullptr;
+            ReturnErrorOnFailure(err);
+        }
+        return CHIP_NO_ERROR;
+    }
+
     /**
      * Determine if this transport can SendMessage to the specified peer address.
      *
@@ -91,6 +91,12 @@ public:
         return MulticastGroupJoinLeaveImpl<0>(address, join);
     }
 
+    CHIP_ERROR SendMessages(const PeerAddress * addresses, System::PacketBufferHandle * msgBufs, size_t count,
+                            size_t & sentCount) override
+    {
+        return SendMessagesImpl<0>(addresses, msgBufs, count, sentCount);
+    }
+
     bool CanSendToPeer(const PeerAddress & address) override { return CanSendToPeerImpl<0>(address); }
 
     void Disconnect(const PeerAddress & address) override { return DisconnectImpl<0>(address); }
@@ -208,6 +214,41 @@ private:
         return CHIP_ERROR_NO_MESSAGE_HANDLER;
     }
 
+    /**
+     * Recursive sendmessages implementation iterating through transport members.
+     *
+     * Messages are sent together through the first transport from index N or above which can send to all of the
+     * targets. If there is none, they are sent one at a time, each through its own transport.
+     *
+     * @tparam N the index of the underlying transport to run SendMessages through.
+     */
+    template <size_t N, typename std::enable_if<(N < sizeof...(TransportTypes))>::type * = nullptr>
+    CHIP_ERROR SendMessagesImpl(const PeerAddress * addresses, System::PacketBufferHandle * msgBufs, size_t count,
+                                size_t & sentCount)
+    {
+        Base * base = &std::get<N>(mTransports);
+        size_t i    = 0;
+        while (i < count && base->CanSendToPeer(addresses[i]))
+        {
+            i++;
+        }
+        if (i == count)
+        {
+            return base->SendMessages(addresses, msgBufs, count, sentCount);
+        }
+        return SendMessagesImpl<N + 1>(addresses, msgBufs, count, sentCount);
+    }
+
+    /**
+     * SendMessagesImpl when N is out of range. Falls back to sending the messages one at a time.
+     */
+    template <size_t N, typename std::enable_if<(N >= sizeof...(TransportTypes))>::type * = nullptr>
+    CHIP_ERROR SendMessagesImpl(const PeerAddress * addresses, System::PacketBufferHandle * msgBufs, size_t count,
+                                size_t & sentCount)
+    {
+        return Base::SendMessages(addresses, msgBufs, count, sentCount);
+    }
+
     /**
      * Recursive GroupJoinLeave implementation iterating through transport members.
      *
@@ -117,6 +117,54 @@ CHIP_ERROR UDP::SendMessage(const Transport::PeerAddress & address, System::Pack
     return mUDPEndPoint->SendMsg(&addrInfo, std::move(msgBuf));
 }
 
+CHIP_ERROR UDP::SendMessages(const Transport::PeerAddress * addresses, System::PacketBufferHandle * msgBufs, size_t count,
+                             size_t & sentCount)
+{
+    sentCount = 0;
+    VerifyOrReturnError(mState == State::kInitialized, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(mUDPEndPoint != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    // Drop the messages and return. Free the buffer of the first one, as SendMessage would.
+    CHIP_FAULT_INJECT(FaultInjection::kFault_DropOutgoingUDPMsg, if (count > 0) msgBufs[0] = nullptr;
+                      return count > 0 ? CHIP_ERROR_CONNECTION_ABORTED : CHIP_NO_ERROR;);
+
+    Inet::IPPacketInfo addrInfos[INET_CONFIG_UDP_SOCKET_MMSG_BATCH_SIZE];
+    while (sentCount < count)
+    {
+        size_t batch = 0;
+        for (; batch < ArraySize(addrInfos) && sentCount + batch < count; batch++)
+        {
+            const Transport::PeerAddress & address = addresses[sentCount + batch];
+            if (address.GetTransportType() != Type::kUdp)
+            {
+                break;
+            }
+
+            addrInfos[batch].Clear();
+            addrInfos[batch].DestAddress = address.GetIPAddress();
+            addrInfos[batch].DestPort    = address.GetPort();
+            addrInfos[batch].Interface   = address.GetInterface();
+        }
+
+        size_t sent    = 0;
+        CHIP_ERROR err = CHIP_NO_ERROR;
+        if (batch > 0)
+        {
+            err = mUDPEndPoint->SendMsgs(addrInfos, &msgBufs[sentCount], batch, sent);
+        }
+        sentCount += sent;
+        ReturnErrorOnFailure(err);
+
+        if (sentCount < count && addresses[sentCount].GetTransportType() != Type::kUdp)
+        {
+            msgBufs[sentCount] = nullptr;
+            return CHIP_ERROR_INVALID_ARGUMENT;
+        }
+    }
+
+    return CHIP_NO_ERROR;
+}
+
 void UDP::OnUdpReceive(Inet::UDPEndPoint * endPoint, System::PacketBufferHandle && buffer, const Inet::IPPacketInfo * pktInfo)
 {
     CHIP_ERROR err          = CHIP_NO_ERROR;
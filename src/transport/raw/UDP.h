@@ -131,6 +131,9 @@ public:
 
     CHIP_ERROR SendMessage(const Transport::PeerAddress & address, System::PacketBufferHandle && msgBuf) override;
 
+    CHIP_ERROR SendMessages(const Transport::PeerAddress * addresses, System::PacketBufferHandle * msgBufs, size_t count,
+                            size_t & sentCount) override;
+
     CHIP_ERROR MulticastGroupJoinLeave(const Transport::PeerAddress & address, bool join) override;
 
     bool CanListenMulticast() override
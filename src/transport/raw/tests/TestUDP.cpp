@@ -161,6 +161,58 @@ void CheckMessageTest6(nlTestSuite * inSuite, void * inContext)
     CheckMessageTest(inSuite, inContext, addr);
 }
 
+/////////////////////////// Batched messaging test
+
+void CheckMessagesTest(nlTestSuite * inSuite, void * inContext, const IPAddress & addr)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    // More messages than one sendmmsg() batch holds.
+    constexpr size_t kMessageCount = INET_CONFIG_UDP_SOCKET_MMSG_BATCH_SIZE + 2;
+
+    Transport::UDP udp;
+
+    CHIP_ERROR err =
+        udp.Init(Transport::UdpListenParameters(ctx.GetUDPEndPointManager()).SetAddressType(addr.Type()).SetListenPort(0));
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    MockTransportMgrDelegate gMockTransportMgrDelegate(inSuite);
+    TransportMgrBase gTransportMgrBase;
+    gTransportMgrBase.SetSessionManager(&gMockTransportMgrDelegate);
+    gTransportMgrBase.Init(&udp);
+
+    ReceiveHandlerCallCount = 0;
+
+    PacketHeader header;
+    header.SetSourceNodeId(kSourceNodeId).SetDestinationNodeId(kDestinationNodeId).SetMessageCounter(kMessageCounter);
+
+    Transport::PeerAddress addresses[kMessageCount];
+    chip::System::PacketBufferHandle buffers[kMessageCount];
+    for (size_t i = 0; i < kMessageCount; i++)
+    {
+        addresses[i] = Transport::PeerAddress::UDP(addr, udp.GetBoundPort());
+        buffers[i]   = chip::System::PacketBufferHandle::NewWithData(PAYLOAD, sizeof(PAYLOAD));
+        NL_TEST_ASSERT(inSuite, !buffers[i].IsNull());
+        NL_TEST_ASSERT(inSuite, header.EncodeBeforeData(buffers[i]) == CHIP_NO_ERROR);
+    }
+
+    size_t sentCount = 0;
+    err              = gTransportMgrBase.SendMessages(addresses, buffers, kMessageCount, sentCount);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, sentCount == kMessageCount);
+
+    ctx.DriveIOUntil(chip::System::Clock::Seconds16(1), []() { return ReceiveHandlerCallCount == kMessageCount; });
+
+    NL_TEST_ASSERT(inSuite, ReceiveHandlerCallCount == kMessageCount);
+}
+
+void CheckMessagesTest6(nlTestSuite * inSuite, void * inContext)
+{
+    IPAddress addr;
+    IPAddress::FromString("::1", addr);
+    CheckMessagesTest(inSuite, inContext, addr);
+}
+
 // Test Suite
 
 /**
@@ -176,6 +228,7 @@ static const nlTest sTests[] =
 
     NL_TEST_DEF("Simple Init Test IPV6",   CheckSimpleInitTest6),
     NL_TEST_DEF("Message Self Test IPV6",  CheckMessageTest6),
+    NL_TEST_DEF("Messages Self Test IPV6", CheckMessagesTest6),
 
     NL_TEST_SENTINEL()
 };
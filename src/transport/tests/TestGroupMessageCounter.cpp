@@ -24,6 +24,7 @@
 #include <lib/support/DefaultStorageKeyAllocator.h>
 #include <lib/support/TestPersistentStorageDelegate.h>
 #include <lib/support/UnitTestRegistration.h>
+#include <system/SystemLayerImpl.h>
 #include <transport/GroupPeerMessageCounter.h>
 #include <transport/PeerMessageCounter.h>
 
@@ -31,6 +32,7 @@
 #include <nlunit-test.h>
 
 #include <errno.h>
+#include <stdint.h>
 
 namespace {
 
@@ -47,15 +49,20 @@ public:
 
         StorageKeyName key = StorageKeyName::Uninitialized();
 
+        // Always Update storage for Test purposes
+        temp = value + GROUP_MSG_COUNTER_MIN_INCREMENT;
+
         if (isControl)
         {
-            mGroupControlCounter = value;
-            key                  = DefaultStorageKeyAllocator::GroupControlCounter();
+            mGroupControlCounter       = value;
+            mGroupControlReservedUntil = temp;
+            key                        = DefaultStorageKeyAllocator::GroupControlCounter();
         }
         else
         {
-            mGroupDataCounter = value;
-            key               = DefaultStorageKeyAllocator::GroupDataCounter();
+            mGroupDataCounter       = value;
+            mGroupDataReservedUntil = temp;
+            key                     = DefaultStorageKeyAllocator::GroupDataCounter();
         }
 
         if (mStorage == nullptr)
@@ -63,12 +70,64 @@ public:
             return;
         }
 
-        // Always Update storage for Test purposes
-        temp = value + GROUP_MSG_COUNTER_MIN_INCREMENT;
         mStorage->SyncSetKeyValue(key.KeyName(), &temp, sizeof(uint32_t));
     }
 };
 
+// Storage that drops every write from a given one on, as if the device lost power while making it.
+class CrashingStorage : public chip::TestPersistentStorageDelegate
+{
+public:
+    CHIP_ERROR SyncSetKeyValueInternal(const char * key, const void * value, uint16_t size) override
+    {
+        if (mWrites++ >= mCrashAtWrite)
+        {
+            mCrashed = true;
+            return CHIP_NO_ERROR;
+        }
+        return TestPersistentStorageDelegate::SyncSetKeyValueInternal(key, value, size);
+    }
+
+    size_t mCrashAtWrite = SIZE_MAX;
+    size_t mWrites       = 0;
+    bool mCrashed        = false;
+};
+
+// System layer that holds on to the deferred work of the counters until the test runs it.
+class DeferredWorkLayer : public chip::System::LayerImpl
+{
+public:
+    CHIP_ERROR StartTimer(System::Clock::Timeout aDelay, System::TimerCompleteCallback aComplete, void * aAppState) override
+    {
+        VerifyOrReturnError(mComplete == nullptr, CHIP_ERROR_NO_MEMORY);
+        mComplete = aComplete;
+        mAppState = aAppState;
+        return CHIP_NO_ERROR;
+    }
+
+    void CancelTimer(System::TimerCompleteCallback aComplete, void * aAppState) override
+    {
+        if (mComplete == aComplete && mAppState == aAppState)
+        {
+            mComplete = nullptr;
+        }
+    }
+
+    void RunPendingWork()
+    {
+        System::TimerCompleteCallback complete = mComplete;
+        mComplete                              = nullptr;
+        if (complete != nullptr)
+        {
+            complete(this, mAppState);
+        }
+    }
+
+private:
+    System::TimerCompleteCallback mComplete = nullptr;
+    void * mAppState                        = nullptr;
+};
+
 class TestGroupPeerTable : public chip::Transport::GroupPeerTable
 {
 public:
@@ -456,6 +515,138 @@ void GroupMessageCounterTest(nlTestSuite * inSuite, void * inContext)
     NL_TEST_ASSERT(inSuite, groupCientCounter5.GetCounter(false) == (UINT32_MAX + GROUP_MSG_COUNTER_MIN_INCREMENT));
 }
 
+struct GroupSendRun
+{
+    uint32_t mFirstControl     = 0;
+    uint32_t mFirstData        = 0;
+    uint32_t mNextControl      = 0; // one past the last control counter sent
+    uint32_t mNextData         = 0; // one past the last data counter sent
+    size_t mWritesWhileSending = 0;
+};
+
+// Sends group messages until the storage crashes or kGroupSendCount have gone out, running the deferred work of the
+// counters every workInterval messages (never if 0, in which case the counters have no system layer).
+constexpr uint32_t kGroupSendCount = 4500;
+
+void RunGroupSends(CrashingStorage & storage, uint32_t workInterval, GroupSendRun & run)
+{
+    DeferredWorkLayer systemLayer;
+    chip::Transport::GroupOutgoingCounters counters;
+
+    counters.Init(&storage, (workInterval > 0) ? &systemLayer : nullptr);
+    run.mFirstControl = counters.GetCounter(true);
+    run.mFirstData    = counters.GetCounter(false);
+    run.mNextControl  = run.mFirstControl;
+    run.mNextData     = run.mFirstData;
+    VerifyOrReturn(!storage.mCrashed);
+
+    for (uint32_t i = 0; i < kGroupSendCount; i++)
+    {
+        bool isControl = (i % 3 == 0);
+        uint32_t value = counters.GetCounter(isControl);
+
+        // The value only goes out once the counter has moved past it, which may have reserved the next block.
+        size_t writes = storage.mWrites;
+        counters.IncrementCounter(isControl);
+        run.mWritesWhileSending += storage.mWrites - writes;
+        VerifyOrReturn(!storage.mCrashed);
+        (isControl ? run.mNextControl : run.mNextData) = value + 1;
+
+        if (workInterval > 0 && (i + 1) % workInterval == 0)
+        {
+            systemLayer.RunPendingWork();
+            VerifyOrReturn(!storage.mCrashed);
+        }
+    }
+    counters.Shutdown();
+}
+
+void GroupMessageCounterCrashTest(nlTestSuite * inSuite, void * inContext)
+{
+    // Synchronous reservations only, deferred work that runs in time, and deferred work that is sometimes too late
+    for (uint32_t workInterval : { 0u, 100u, 1200u })
+    {
+        CrashingStorage cleanStorage;
+        GroupSendRun cleanRun;
+        RunGroupSends(cleanStorage, workInterval, cleanRun);
+        NL_TEST_ASSERT(inSuite, !cleanStorage.mCrashed);
+        NL_TEST_ASSERT(inSuite, cleanRun.mNextControl - cleanRun.mFirstControl == kGroupSendCount / 3);
+        NL_TEST_ASSERT(inSuite, cleanRun.mNextData - cleanRun.mFirstData == kGroupSendCount - kGroupSendCount / 3);
+        if (workInterval == 100)
+        {
+            // Sending never waited for storage
+            NL_TEST_ASSERT(inSuite, cleanRun.mWritesWhileSending == 0);
+        }
+        else
+        {
+            NL_TEST_ASSERT(inSuite, cleanRun.mWritesWhileSending > 0);
+        }
+
+        // Crash at every write, then check that the rebooted node skips past every counter value it has sent.
+        for (size_t crashAt = 0; crashAt < cleanStorage.mWrites; crashAt++)
+        {
+            CrashingStorage storage;
+            GroupSendRun run;
+            storage.mCrashAtWrite = crashAt;
+            RunGroupSends(storage, workInterval, run);
+            NL_TEST_ASSERT(inSuite, storage.mCrashed);
+
+            storage.mCrashAtWrite = SIZE_MAX;
+            chip::Transport::GroupOutgoingCounters rebooted;
+            NL_TEST_ASSERT(inSuite, rebooted.Init(&storage) == CHIP_NO_ERROR);
+            if (crashAt >= 2)
+            {
+                // Both counters were persisted by the first boot
+                NL_TEST_ASSERT(inSuite, rebooted.GetCounter(true) >= run.mNextControl);
+                NL_TEST_ASSERT(inSuite, rebooted.GetCounter(false) >= run.mNextData);
+            }
+        }
+    }
+}
+
+void GroupMessageCounterStorageFailureTest(nlTestSuite * inSuite, void * inContext)
+{
+    // Synchronous reservations only, and deferred work that fails as well
+    for (bool withSystemLayer : { false, true })
+    {
+        chip::TestPersistentStorageDelegate storage;
+        DeferredWorkLayer systemLayer;
+        chip::Transport::GroupOutgoingCounters counters;
+        NL_TEST_ASSERT(inSuite, counters.Init(&storage, withSystemLayer ? &systemLayer : nullptr) == CHIP_NO_ERROR);
+
+        std::string key = DefaultStorageKeyAllocator::GroupDataCounter().KeyName();
+        storage.AddPoisonKey(key);
+
+        // The reserved block goes out as usual.
+        uint32_t first = counters.GetCounter(false);
+        for (uint32_t i = 0; i < GROUP_MSG_COUNTER_MIN_INCREMENT; i++)
+        {
+            NL_TEST_ASSERT(inSuite, counters.IncrementCounter(false) == CHIP_NO_ERROR);
+            systemLayer.RunPendingWork();
+        }
+
+        // The next value is the persisted restart point, which must not be sent for as long as storage fails.
+        uint32_t restartPoint = counters.GetCounter(false);
+        NL_TEST_ASSERT(inSuite, restartPoint - first == GROUP_MSG_COUNTER_MIN_INCREMENT);
+        for (int i = 0; i < 3; i++)
+        {
+            NL_TEST_ASSERT(inSuite, counters.IncrementCounter(false) != CHIP_NO_ERROR);
+            NL_TEST_ASSERT(inSuite, counters.GetCounter(false) == restartPoint);
+            systemLayer.RunPendingWork();
+        }
+
+        // Once storage is back, the restart point goes out and a rebooted node skips past it.
+        storage.ClearPoisonKeys();
+        NL_TEST_ASSERT(inSuite, counters.IncrementCounter(false) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, counters.GetCounter(false) == restartPoint + 1);
+        counters.Shutdown();
+
+        chip::Transport::GroupOutgoingCounters rebooted;
+        NL_TEST_ASSERT(inSuite, rebooted.Init(&storage) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, static_cast<int32_t>(rebooted.GetCounter(false) - restartPoint) > 0);
+    }
+}
+
 } // namespace
 
 /**
@@ -472,6 +663,8 @@ const nlTest sTests[] =
     NL_TEST_DEF("Reorder Peer removal",   ReorderPeerRemovalTest),
     NL_TEST_DEF("Reorder Fabric Removal", ReorderFabricRemovalTest),
     NL_TEST_DEF("Group Message Counter",  GroupMessageCounterTest),
+    NL_TEST_DEF("Group Counter Crash",    GroupMessageCounterCrashTest),
+    NL_TEST_DEF("Group Counter Storage",  GroupMessageCounterStorageFailureTest),
     NL_TEST_SENTINEL()
 };
 // clang-format on
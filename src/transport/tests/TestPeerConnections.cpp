@@ -132,6 +132,83 @@ void TestFindByKeyId(nlTestSuite * inSuite, void * inContext)
     System::Clock::Internal::SetSystemClockForTesting(realClock);
 }
 
+void TestIndexesAfterRelease(nlTestSuite * inSuite, void * inContext)
+{
+    SecureSessionTable connections;
+    connections.Init();
+
+    // Local session IDs that are multiples of 4096 share their probe sequence in the session ID index.
+    constexpr size_t kCount = (CHIP_CONFIG_SECURE_SESSION_POOL_SIZE < 8) ? CHIP_CONFIG_SECURE_SESSION_POOL_SIZE : 8;
+    Optional<SessionHandle> sessions[kCount];
+    for (size_t i = 0; i < kCount; i++)
+    {
+        sessions[i] = connections.CreateNewSecureSessionForTest(
+            SecureSession::Type::kCASE, static_cast<uint16_t>((i + 1) * 4096), kLocalNodeId,
+            (i % 2 == 0) ? kCasePeer1NodeId : kCasePeer2NodeId, kPeer1CATs, 1, kFabricIndex, GetDefaultMRPConfig());
+        NL_TEST_ASSERT(inSuite, sessions[i].HasValue());
+    }
+
+    // Release the sessions of the first peer, which start the probe sequence.
+    for (size_t i = 0; i < kCount; i += 2)
+    {
+        sessions[i].Value()->AsSecureSession()->MarkForEviction();
+        sessions[i].ClearValue();
+    }
+
+    for (size_t i = 0; i < kCount; i++)
+    {
+        auto found = connections.FindSecureSessionByLocalKey(static_cast<uint16_t>((i + 1) * 4096));
+        NL_TEST_ASSERT(inSuite, found.HasValue() == (i % 2 == 1));
+        NL_TEST_ASSERT(inSuite, !found.HasValue() || found.Value() == sessions[i].Value());
+    }
+
+    size_t peer1Count = 0;
+    size_t peer2Count = 0;
+    connections.ForEachSessionWithPeer(ScopedNodeId(kCasePeer1NodeId, kFabricIndex), [&](auto * session) {
+        peer1Count++;
+        return Loop::Continue;
+    });
+    connections.ForEachSessionWithPeer(ScopedNodeId(kCasePeer2NodeId, kFabricIndex), [&](auto * session) {
+        NL_TEST_ASSERT(inSuite, session->GetPeerNodeId() == kCasePeer2NodeId);
+        peer2Count++;
+        return Loop::Continue;
+    });
+    NL_TEST_ASSERT(inSuite, peer1Count == 0);
+    NL_TEST_ASSERT(inSuite, peer2Count == kCount / 2);
+
+    // New sessions get IDs that no other session uses, and are found under their peer once activated.
+    auto pending = connections.CreateNewSecureSession(SecureSession::Type::kPASE, ScopedNodeId());
+    NL_TEST_ASSERT(inSuite, pending.HasValue());
+    uint16_t localSessionId = pending.Value()->AsSecureSession()->GetLocalSessionId();
+    NL_TEST_ASSERT(inSuite, localSessionId != kUnsecuredSessionId);
+    NL_TEST_ASSERT(inSuite, connections.FindSecureSessionByLocalKey(localSessionId).Value() == pending.Value());
+
+    const ScopedNodeId pasePeer(NodeIdFromPAKEKeyId(kDefaultCommissioningPasscodeId), kUndefinedFabricIndex);
+    pending.Value()->AsSecureSession()->Activate(ScopedNodeId(), pasePeer, CATValues(), 1, GetDefaultMRPConfig());
+    NL_TEST_ASSERT(inSuite, pending.Value()->AsSecureSession()->AdoptFabricIndex(kFabricIndex) == CHIP_NO_ERROR);
+
+    size_t pasePeerCount = 0;
+    connections.ForEachSessionWithPeer(pasePeer, [&](auto * session) {
+        pasePeerCount++;
+        return Loop::Continue;
+    });
+    connections.ForEachSessionWithPeer(ScopedNodeId(pasePeer.GetNodeId(), kFabricIndex), [&](auto * session) {
+        NL_TEST_ASSERT(inSuite, session == pending.Value()->AsSecureSession());
+        pasePeerCount += 2;
+        return Loop::Continue;
+    });
+    NL_TEST_ASSERT(inSuite, pasePeerCount == 2);
+
+    for (size_t i = 0; i < kCount; i += 2)
+    {
+        sessions[i] = connections.CreateNewSecureSession(SecureSession::Type::kCASE, ScopedNodeId());
+        NL_TEST_ASSERT(inSuite, sessions[i].HasValue());
+        uint16_t id = sessions[i].Value()->AsSecureSession()->GetLocalSessionId();
+        NL_TEST_ASSERT(inSuite, id != kUnsecuredSessionId);
+        NL_TEST_ASSERT(inSuite, connections.FindSecureSessionByLocalKey(id).Value() == sessions[i].Value());
+    }
+}
+
 struct ExpiredCallInfo
 {
     int callCount                   = 0;
@@ -158,6 +235,7 @@ static const nlTest sTests[] =
 {
     NL_TEST_DEF("BasicFunctionality", TestBasicFunctionality),
     NL_TEST_DEF("FindByKeyId", TestFindByKeyId),
+    NL_TEST_DEF("IndexesAfterRelease", TestIndexesAfterRelease),
     NL_TEST_SENTINEL()
 };
 // clang-format on